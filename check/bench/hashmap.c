@@ -0,0 +1,176 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ofc/hashmap.h"
+#include "ofc/global_opts.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* Adds identifiers to the hashmap and to the fixed 256 bucket chained
+   map it replaced, which is kept here as it was, then finds a sample of
+   them in each. The old map's chains are so long that finding all of
+   them would take minutes. */
+
+#define BENCH_COUNT_DEFAULT  1000000
+#define BENCH_SAMPLE_DEFAULT   10000
+
+typedef struct old_hashmap__entry_s old_hashmap__entry_t;
+
+struct old_hashmap__entry_s
+{
+	void                 *item;
+	old_hashmap__entry_t *next;
+};
+
+typedef struct
+{
+	old_hashmap__entry_t* base[256];
+} old_hashmap_t;
+
+static uint8_t old_hashmap__hash(const char* key)
+{
+	uint8_t h = 0;
+	unsigned i;
+	for (i = 0; key[i] != '\0'; i++)
+		h += key[i];
+	return h;
+}
+
+static bool old_hashmap_add(old_hashmap_t* map, void* item)
+{
+	uint8_t hash = old_hashmap__hash((const char*)item);
+
+	old_hashmap__entry_t* entry
+		= (old_hashmap__entry_t*)malloc(
+			sizeof(old_hashmap__entry_t));
+	if (!entry) return false;
+
+	entry->item = item;
+	entry->next = map->base[hash];
+	map->base[hash] = entry;
+	return true;
+}
+
+static void* old_hashmap_find(old_hashmap_t* map, const char* key)
+{
+	uint8_t hash = old_hashmap__hash(key);
+
+	old_hashmap__entry_t* entry;
+	for (entry = map->base[hash]; entry; entry = entry->next)
+	{
+		if ((key == entry->item)
+			|| (strcmp(key, (const char*)entry->item) == 0))
+			return entry->item;
+	}
+	return NULL;
+}
+
+static void old_hashmap_delete(old_hashmap_t* map)
+{
+	unsigned i;
+	for (i = 0; i < 256; i++)
+	{
+		old_hashmap__entry_t* entry = map->base[i];
+		while (entry)
+		{
+			old_hashmap__entry_t* next = entry->next;
+			free(entry);
+			entry = next;
+		}
+	}
+	free(map);
+}
+
+
+static double bench__now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec + (ts.tv_nsec / 1e9));
+}
+
+static void bench__report(
+	const char* name, unsigned count, double add,
+	unsigned sample, double find)
+{
+	printf("hashmap: %s: add %u identifiers %.3fs, find %.1fns each\n",
+		name, count, add, ((find * 1e9) / sample));
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned count = BENCH_COUNT_DEFAULT;
+	if (argc > 1)
+		count = strtoul(argv[1], NULL, 0);
+	if (count == 0) return 1;
+
+	unsigned sample = BENCH_SAMPLE_DEFAULT;
+	if (sample > count)
+		sample = count;
+	unsigned stride = (count / sample);
+
+	/* Six character upper case identifiers, as in fixed form source. */
+	char (*key)[8] = malloc(count * sizeof(*key));
+	if (!key) return 1;
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		unsigned n = i, j;
+		for (j = 0; j < 6; j++, n /= 26)
+			key[i][j] = 'A' + (n % 26);
+		key[i][6] = '\0';
+	}
+
+	bool passed = true;
+
+	ofc_hashmap_t* map = ofc_hashmap_create(
+		NULL, NULL, NULL, NULL);
+	if (!map) return 1;
+
+	double start = bench__now();
+	for (i = 0; i < count; i++)
+		passed = (ofc_hashmap_add(map, key[i]) && passed);
+	double add = bench__now();
+	for (i = 0; i < (sample * stride); i += stride)
+		passed = ((ofc_hashmap_find(map, key[i]) == key[i]) && passed);
+	double find = bench__now();
+	ofc_hashmap_delete(map);
+
+	bench__report("new", count, (add - start), sample, (find - add));
+
+	old_hashmap_t* old = calloc(1, sizeof(old_hashmap_t));
+	if (!old) return 1;
+
+	start = bench__now();
+	for (i = 0; i < count; i++)
+		passed = (old_hashmap_add(old, key[i]) && passed);
+	add = bench__now();
+	for (i = 0; i < (sample * stride); i += stride)
+		passed = ((old_hashmap_find(old, key[i]) == key[i]) && passed);
+	find = bench__now();
+	old_hashmap_delete(old);
+
+	bench__report("old", count, (add - start), sample, (find - add));
+
+	free(key);
+	return (passed ? 0 : 1);
+}
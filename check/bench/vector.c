@@ -0,0 +1,159 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+
+#include "../unit/unit.h"
+#include "ofc/vector.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* Counts realloc calls made by the frontend, which is linked into this
+   binary, while lists are appended to and a large routine is analysed. */
+
+#define BENCH_STMT_COUNT 100000
+
+extern void* __libc_realloc(void* ptr, size_t size);
+
+static unsigned long bench__realloc_count = 0;
+
+void* realloc(void* ptr, size_t size)
+{
+	bench__realloc_count++;
+	return __libc_realloc(ptr, size);
+}
+
+
+static double bench__now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec + (ts.tv_nsec / 1e9));
+}
+
+static void bench__report(
+	const char* name, unsigned long reallocs, double time)
+{
+	printf("vector: %s: %lu realloc calls, %.3fs\n",
+		name, reallocs, time);
+}
+
+
+OFC_VECTOR_DEFINE(bench__vector, void*)
+
+/* Appends as the lists did before they shared the vector helper. */
+static bool bench__append_by_one(unsigned count)
+{
+	void**   elem = NULL;
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		void** nelem = (void**)realloc(elem,
+			(sizeof(void*) * (i + 1)));
+		if (!nelem)
+		{
+			free(elem);
+			return false;
+		}
+		elem = nelem;
+		elem[i] = &elem;
+	}
+
+	free(elem);
+	return true;
+}
+
+static bool bench__append_vector(unsigned count)
+{
+	void**   elem = NULL;
+	unsigned size = 0;
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		if (!bench__vector_reserve(&elem, i, &size, 1))
+		{
+			free(elem);
+			return false;
+		}
+		elem[i] = &elem;
+	}
+
+	free(elem);
+	return true;
+}
+
+static bool bench__append(
+	const char* name, bool (*append)(unsigned count))
+{
+	unsigned long reallocs = bench__realloc_count;
+	double start = bench__now();
+	if (!append(BENCH_STMT_COUNT))
+		return false;
+	bench__report(name, (bench__realloc_count - reallocs),
+		(bench__now() - start));
+	return true;
+}
+
+/* A single routine of BENCH_STMT_COUNT assignments. */
+static char* bench__routine(void)
+{
+	static const char* head = "      SUBROUTINE S\n      INTEGER I\n";
+	static const char* stmt = "      I = I + 1\n";
+	static const char* tail = "      END\n";
+
+	size_t hlen = strlen(head);
+	size_t slen = strlen(stmt);
+	size_t tlen = strlen(tail);
+
+	char* source = (char*)malloc(
+		hlen + (slen * BENCH_STMT_COUNT) + tlen + 1);
+	if (!source) return NULL;
+
+	char* s = source;
+	memcpy(s, head, hlen);
+	s += hlen;
+
+	unsigned i;
+	for (i = 0; i < BENCH_STMT_COUNT; i++, s += slen)
+		memcpy(s, stmt, slen);
+
+	memcpy(s, tail, (tlen + 1));
+	return source;
+}
+
+int main(void)
+{
+	if (!bench__append("append by one", bench__append_by_one)
+		|| !bench__append("append vector", bench__append_vector))
+		return 1;
+
+	char* source = bench__routine();
+	if (!source) return 1;
+
+	unsigned long reallocs = bench__realloc_count;
+	double start = bench__now();
+	unit_sema_t* unit = unit_sema(source, OFC_LANG_OPTS_F77);
+	double end = bench__now();
+	free(source);
+	if (!unit) return 1;
+
+	char name[64];
+	snprintf(name, sizeof(name), "analyse %u statements", BENCH_STMT_COUNT);
+	bench__report(name, (bench__realloc_count - reallocs), (end - start));
+
+	unit_sema_delete(unit);
+	return 0;
+}
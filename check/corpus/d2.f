@@ -0,0 +1,7 @@
+      PROGRAM D2
+      REAL X(200,200), Y(20000)
+      INTEGER I, J
+      DATA ((X(I,J), I=1,200), J=1,200) /40000*1.0/
+      DATA (Y(I), I=1,20000) /20000*2.0/
+      PRINT *, X(1,1)
+      END
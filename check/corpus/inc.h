@@ -0,0 +1,3 @@
+      INTEGER NMAX
+      PARAMETER (NMAX = 100)
+      COMMON /SHARED/ WORK(NMAX)
@@ -0,0 +1,55 @@
+      PROGRAM MAIN
+      IMPLICIT NONE
+      INTEGER I, J, K, N
+      PARAMETER (N = 10)
+      REAL A(N), B(N, 3), X, Y, FUNC1
+      EXTERNAL FUNC1
+      DOUBLE PRECISION D
+      CHARACTER*10 NAME
+      CHARACTER*(*) CNST
+      PARAMETER (CNST = 'HELLO')
+      LOGICAL FLAG
+      COMMON /BLK1/ A, X
+      COMMON /BLK2/ I, J
+      DATA B /30*0.0/
+      DATA NAME /'ABCDEFGHIJ'/
+      DATA D, FLAG /1.5D0, .TRUE./
+      DO 10 I = 1, N
+        A(I) = I * 2.0
+        IF (A(I) .GT. 5.0) THEN
+          X = A(I) + 1
+        ELSE IF (A(I) .LT. 2.0) THEN
+          X = 0
+        ELSE
+          X = -1
+        END IF
+   10 CONTINUE
+      K = 0
+   20 K = K + 1
+      IF (K .LT. 5) GOTO 20
+      WRITE (6, 100) X, NAME
+  100 FORMAT (1X, F10.3, 2X, A10)
+      PRINT *, 'DONE', K
+      CALL SUB1(A, N)
+      Y = FUNC1(X)
+      WRITE (*, 200) Y
+  200 FORMAT (E12.4)
+      STOP
+      END
+
+      SUBROUTINE SUB1(ARR, M)
+      INTEGER M
+      REAL ARR(M)
+      INTEGER L
+      COMMON /BLK2/ L, LL
+      DO L = 1, M
+        ARR(L) = ARR(L) ** 2
+      END DO
+      RETURN
+      END
+
+      REAL FUNCTION FUNC1(Z)
+      REAL Z
+      FUNC1 = SQRT(ABS(Z)) + SIN(Z) * COS(Z)
+      RETURN
+      END
@@ -0,0 +1,25 @@
+      PROGRAM IOTEST
+      INTEGER IU, IOS
+      CHARACTER*20 FNAME, ACC
+      LOGICAL EX
+      REAL V(5)
+      DATA V /1.0, 2.0, 3*4.5/
+      DATA IU /10/
+      FNAME = 'data.txt'
+      OPEN (UNIT=IU, FILE=FNAME, STATUS='UNKNOWN', ACCESS='SEQUENTIAL',
+     1      FORM='FORMATTED', IOSTAT=IOS, ERR=900)
+      INQUIRE (UNIT=IU, EXIST=EX, ACCESS=ACC, IOSTAT=IOS)
+      INQUIRE (FILE=FNAME, EXIST=EX)
+      WRITE (IU, 10) (V(I), I = 1, 5)
+   10 FORMAT (5F8.2)
+      REWIND IU
+      READ (IU, 10, END=800) V
+      BACKSPACE (IU)
+      ENDFILE (UNIT=IU)
+      CLOSE (UNIT=IU, STATUS='KEEP', IOSTAT=IOS)
+  800 CONTINUE
+  900 CONTINUE
+      WRITE (6, 20)
+   20 FORMAT ('HELLO', /, 'WORLD')
+      WRITE (6, '(A, I5)') 'VALUE', IOS
+      END
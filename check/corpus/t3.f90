@@ -0,0 +1,34 @@
+program selcase
+  implicit none
+  integer :: i, op, res
+  character(len=8) :: s
+  real, dimension(3,4) :: mat
+  integer, parameter :: m = 3
+  data mat /12*1.5/
+  do i = 1, 20
+    op = mod(i, 7)
+    select case (op)
+    case (0)
+      res = 1
+    case (1:2)
+      res = 2
+    case (3, 5)
+      res = 3
+    case (6:)
+      res = 4
+    case default
+      res = 0
+    end select
+  end do
+  do while (i > 0)
+    i = i - 1
+    if (i == 5) cycle
+    if (i == 2) exit
+  end do
+  print *, res, mat(1,1)
+contains
+  integer function twice(x)
+    integer :: x
+    twice = 2 * x
+  end function twice
+end program selcase
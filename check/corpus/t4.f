@@ -0,0 +1,35 @@
+      PROGRAM STRUC
+      STRUCTURE /POINT/
+        REAL X, Y
+        INTEGER ID
+      END STRUCTURE
+      STRUCTURE /SHAPE/
+        RECORD /POINT/ P(3)
+        UNION
+          MAP
+            INTEGER IA
+          END MAP
+          MAP
+            REAL RA
+          END MAP
+        END UNION
+        CHARACTER*4 TAG
+      END STRUCTURE
+      RECORD /SHAPE/ S, SS(2)
+      RECORD /POINT/ PT
+      INTEGER IARR(4)
+      REAL R1, R2
+      EQUIVALENCE (IARR(1), R1)
+      S.P(1).X = 1.0
+      S.TAG = 'ABCD'
+      PT.ID = 3
+      SS(2).P(2).Y = PT.X
+      R2 = S.P(1).X
+      IF (R2) 10, 20, 30
+   10 CONTINUE
+   20 CONTINUE
+   30 CONTINUE
+      GO TO (10, 20, 30) PT.ID
+      ASSIGN 10 TO IL
+      GO TO IL
+      END
@@ -0,0 +1,22 @@
+      SUBROUTINE A1
+      INCLUDE 'inc.h'
+      WORK(1) = 1.0
+      END
+      SUBROUTINE A2
+      INCLUDE 'inc.h'
+      WORK(2) = 2.0
+      CALL A1
+      CALL A3(1, 2.0)
+      END
+      SUBROUTINE A3(I, R)
+      INCLUDE 'inc.h'
+      INTEGER I
+      REAL R
+      WORK(I) = R
+      CALL A3(1.0, 2)
+      END
+      SUBROUTINE A4
+      COMMON /SHARED/ W1, W2
+      INTEGER W1
+      W1 = 0
+      END
@@ -0,0 +1,19 @@
+      PROGRAM DATAT
+      INTEGER I, J
+      REAL T(10, 10), U(100)
+      INTEGER IV(6)
+      CHARACTER*3 C(4)
+      DATA ((T(I,J), I=1,10), J=1,10) /100*0.5/
+      DATA U /50*1.0, 50*2.0/
+      DATA IV /1, 2, 3, 3*7/
+      DATA C /'AAA', 'BBB', 2*'CCC'/
+      COMPLEX Z
+      DATA Z /(1.0, 2.0)/
+      PRINT *, T(1,1), U(1), IV(6), C(4), Z
+      END
+      BLOCK DATA BD
+      COMMON /CB/ X, Y, K
+      REAL X, Y
+      INTEGER K
+      DATA X, Y, K /1.0, 2.0, 3/
+      END
@@ -0,0 +1,28 @@
+C     A COMMENT LINE
+      PROGRAM MISC
+      IMPLICIT REAL*8 (A-H, O-Z)
+      INTEGER*2 IS
+      LOGICAL*1 LB
+      BYTE BB
+      CHARACTER STR*12, S2*5
+      DIMENSION ARR(0:4)
+      EXTERNAL EXTF
+      INTRINSIC SIN
+      SAVE ARR
+      STR = 'A' // 'B' // "C"
+      S2 = STR(1:5)
+      IS = 3
+      ARR(0) = DBLE(IS) ** 0.5D0
+      IF (IS .EQ. 3 .AND. .NOT. LB) ARR(1) = MAX(1.0D0, ARR(0), 2.0D0)
+      IF (.TRUE.) PAUSE
+      K = LEN(STR) + INDEX(STR, 'B') + ICHAR('A')
+      J = MIN0(K, 5) + INT(ARR(1)) + NINT(2.5) + IABS(-3)
+      BB = 1
+      CALL EXTF(SIN)
+      X = 1.0E10
+      Y = .5
+      Z = 1.D-3
+      WRITE (*, 99) X, Y, Z, J, K
+   99 FORMAT (3(1X, G12.5), 2I6, 5HHELLO, :, T10, TR2, SP, BN)
+      STOP 'END'
+      END
@@ -0,0 +1,15 @@
+      PROGRAM CSEL
+      CHARACTER*3 S
+      INTEGER R
+      S = 'ABC'
+      R = 1
+      SELECT CASE (R)
+      CASE (1:3, 5)
+        R = 0
+      CASE (4)
+        R = 1
+      CASE (:0)
+        R = 2
+      END SELECT
+      PRINT *, R
+      END
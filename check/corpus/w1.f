@@ -0,0 +1,5 @@
+      PROGRAM W1
+      INTEGER J
+      J = 2.5
+      PRINT *, J
+      END
@@ -0,0 +1,21 @@
+      PROGRAM D
+      STRUCTURE /S1/
+        INTEGER A
+        CHARACTER*4 C
+        REAL R(2)
+        UNION
+          MAP
+            INTEGER B(3)
+          END MAP
+          MAP
+            REAL E
+          END MAP
+        END UNION
+      END STRUCTURE
+      RECORD /S1/ X, Y(2), Z
+      DATA X.R /2*2.0/, X.C /'ABCD'/
+      DATA Y(2).A /5/, Y(1).B(2) /6/
+      DATA Z /1, 'WXYZ', 2.0, 3.0, 4, 5, 6/
+      DATA X.R(3) /1.0/
+      PRINT *, X.R(1), Y(1).A, Z.E
+      END
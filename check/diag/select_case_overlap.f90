@@ -0,0 +1,13 @@
+program p
+  integer :: i, j
+  i = 1
+  select case (i)
+  case (1:3)
+    j = 2.5
+  case (5, 7)
+    j = 3.5
+  case (6:8)
+    j = 4.5
+  end select
+  print *, j
+end program p
@@ -0,0 +1,135 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+
+#include "ofc/arena.h"
+#include "ofc/thread_pool.h"
+#include "ofc/global_opts.h"
+
+ofc_global_opts_t global_opts;
+
+
+#define ARENA_NODES   64
+#define ARENA_THREADS 4
+
+static void* arena__node[ARENA_NODES];
+
+typedef struct
+{
+	unsigned first, count;
+} arena_job_t;
+
+static void arena__free_job(arena_job_t* job)
+{
+	unsigned i;
+	for (i = job->first; i < (job->first + job->count); i++)
+		ofc_arena_node_free(arena__node[i]);
+}
+
+static size_t arena__live(ofc_arena_t* arena)
+{
+	ofc_arena_stats_t stats;
+	return (ofc_arena_stats(arena, &stats) ? stats.live : (size_t)-1);
+}
+
+static bool arena__recycled(void* node)
+{
+	unsigned i;
+	for (i = 0; i < ARENA_NODES; i++)
+	{
+		if (arena__node[i] == node)
+			return true;
+	}
+	return false;
+}
+
+
+int main(void)
+{
+	ofc_arena_t* arena = ofc_arena_create();
+	if (!arena)
+	{
+		fprintf(stderr, "arena: failed to create\n");
+		return 1;
+	}
+
+	bool passed = true;
+
+	ofc_arena_t* prev = ofc_arena_current_set(arena);
+
+	unsigned i;
+	for (i = 0; i < ARENA_NODES; i++)
+		arena__node[i] = ofc_arena_node_alloc(24);
+	size_t live = arena__live(arena);
+
+	/* A node freed on the arena's own thread is reused at once. */
+	void* node = arena__node[0];
+	ofc_arena_node_free(node);
+	if (ofc_arena_node_alloc(24) != node)
+	{
+		fprintf(stderr, "arena: local free wasn't recycled\n");
+		passed = false;
+	}
+
+	/* Nodes freed on other threads are deferred, but counted as
+	   freed straight away. */
+	arena_job_t job[ARENA_THREADS];
+	unsigned share = (ARENA_NODES / ARENA_THREADS);
+	ofc_thread_pool_t* pool = ofc_thread_pool_create(ARENA_THREADS);
+	for (i = 0; i < ARENA_THREADS; i++)
+	{
+		job[i].first = (i * share);
+		job[i].count = share;
+
+		if (!pool || !ofc_thread_pool_add(pool,
+			(ofc_thread_pool_job_f)arena__free_job, &job[i]))
+		{
+			fprintf(stderr, "arena: failed to start free job\n");
+			passed = false;
+			ofc_arena_current_set(NULL);
+			arena__free_job(&job[i]);
+			ofc_arena_current_set(arena);
+		}
+	}
+	ofc_thread_pool_delete(pool);
+
+	if (arena__live(arena) != 0)
+	{
+		fprintf(stderr, "arena: deferred frees weren't counted\n");
+		passed = false;
+	}
+
+	/* Then the next allocations take them rather than bumping. */
+	for (i = 0; i < ARENA_NODES; i++)
+	{
+		if (!arena__recycled(ofc_arena_node_alloc(24)))
+		{
+			fprintf(stderr, "arena: deferred node %u wasn't recycled\n", i);
+			passed = false;
+			break;
+		}
+	}
+
+	if (arena__live(arena) != live)
+	{
+		fprintf(stderr, "arena: live size is wrong after recycling\n");
+		passed = false;
+	}
+
+	ofc_arena_current_set(prev);
+	ofc_arena_delete(arena);
+	return (passed ? 0 : 1);
+}
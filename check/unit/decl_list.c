@@ -0,0 +1,116 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ofc/sema.h"
+#include "ofc/global_opts.h"
+
+ofc_global_opts_t global_opts;
+
+
+static ofc_symbol_table_t* symbols;
+
+static ofc_sema_decl_t* decl_list__add(
+	ofc_sema_decl_list_t* list, const char* name)
+{
+	ofc_sema_decl_t* decl = ofc_sema_decl_create(symbols, NULL,
+		ofc_sparse_ref(NULL, name, strlen(name)));
+	if (!decl) return NULL;
+
+	if (!ofc_sema_decl_list_add(list, decl))
+	{
+		ofc_sema_decl_delete(decl);
+		return NULL;
+	}
+	return decl;
+}
+
+static unsigned decl_list__slot(
+	const ofc_sema_decl_list_t* list, const ofc_sema_decl_t* decl)
+{
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (list->decl[i] == decl)
+			return i;
+	}
+	return list->count;
+}
+
+int main(void)
+{
+	static const char* name[] = { "a", "b", "c", "d", "e", "f" };
+	static const char* add[]  = { "g", "h", "i", "j" };
+
+	/* Removed out of order, so that a stack would reuse them out of order. */
+	static const unsigned remove[] = { 0, 4, 2, 1 };
+
+	/* Holes are reused lowest first, then the list grows. */
+	static const unsigned expect[] = { 0, 1, 2, 4 };
+
+	symbols = ofc_symbol_table_create();
+	if (!symbols) return 1;
+
+	ofc_sema_decl_list_t* list
+		= ofc_sema_decl_list_create(symbols, false);
+	if (!list)
+	{
+		ofc_symbol_table_delete(symbols);
+		return 1;
+	}
+
+	ofc_sema_decl_t* decl[6];
+	unsigned i;
+	for (i = 0; i < 6; i++)
+	{
+		decl[i] = decl_list__add(list, name[i]);
+		if (!decl[i])
+		{
+			fprintf(stderr, "decl_list: failed to add '%s'\n", name[i]);
+			ofc_sema_decl_list_delete(list);
+			ofc_symbol_table_delete(symbols);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < 4; i++)
+		ofc_sema_decl_list_remove(list, decl[remove[i]]);
+
+	bool failed = false;
+	for (i = 0; i < 4; i++)
+	{
+		ofc_sema_decl_t* d = decl_list__add(list, add[i]);
+		unsigned slot = (d ? decl_list__slot(list, d) : list->count);
+		if (slot != expect[i])
+		{
+			fprintf(stderr, "decl_list: '%s' added at slot %u, expected %u\n",
+				add[i], slot, expect[i]);
+			failed = true;
+		}
+	}
+
+	ofc_sema_decl_t* d = decl_list__add(list, "k");
+	if (!d || (decl_list__slot(list, d) != 6) || (list->count != 7))
+	{
+		fprintf(stderr, "decl_list: 'k' wasn't added after the last slot\n");
+		failed = true;
+	}
+
+	ofc_sema_decl_list_delete(list);
+	ofc_symbol_table_delete(symbols);
+	return (failed ? 1 : 0);
+}
@@ -0,0 +1,174 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ofc/hashmap.h"
+#include "ofc/global_opts.h"
+
+ofc_global_opts_t global_opts;
+
+
+#define HASHMAP_COUNT 5000
+
+typedef struct
+{
+	char key[16];
+} hashmap_item_t;
+
+static hashmap_item_t item[HASHMAP_COUNT];
+
+
+/* Every key collides, so removals must shift a single long run. */
+static uint32_t hashmap__hash_collide(const char* key)
+{
+	(void)key;
+	return 7;
+}
+
+static bool hashmap__count_item(void* item, void* param)
+{
+	(void)item;
+	(*(unsigned*)param)++;
+	return true;
+}
+
+static bool hashmap__check(
+	const char* name, ofc_hashmap_t* map, unsigned count,
+	bool (*present)(unsigned i))
+{
+	bool passed = true;
+
+	if (ofc_hashmap_count(map) != count)
+	{
+		fprintf(stderr, "hashmap: %s has %u items, expected %u\n",
+			name, ofc_hashmap_count(map), count);
+		passed = false;
+	}
+
+	unsigned visited = 0;
+	if (!ofc_hashmap_foreach(map, &visited, hashmap__count_item)
+		|| (visited != count))
+	{
+		fprintf(stderr, "hashmap: %s foreach visited %u items, expected %u\n",
+			name, visited, count);
+		passed = false;
+	}
+
+	unsigned i;
+	for (i = 0; i < HASHMAP_COUNT; i++)
+	{
+		const void* found = ofc_hashmap_find(map, item[i].key);
+		if (found != (present(i) ? &item[i] : NULL))
+		{
+			fprintf(stderr, "hashmap: %s find of '%s' is wrong\n",
+				name, item[i].key);
+			passed = false;
+			break;
+		}
+	}
+
+	return passed;
+}
+
+static bool hashmap__all(unsigned i)
+{
+	(void)i;
+	return true;
+}
+
+static bool hashmap__not_third(unsigned i)
+{
+	return ((i % 3) != 0);
+}
+
+/* Adds every item, growing the table from empty, then removes every
+   third item and checks the rest can still be found. */
+static bool hashmap__add_remove(
+	const char* name, ofc_hashmap_hash_f hash)
+{
+	ofc_hashmap_t* map = ofc_hashmap_create(
+		hash, NULL, NULL, NULL);
+	if (!map) return false;
+
+	bool passed = true;
+	unsigned i;
+	for (i = 0; passed && (i < HASHMAP_COUNT); i++)
+		passed = ofc_hashmap_add(map, &item[i]);
+
+	if (!passed)
+	{
+		fprintf(stderr, "hashmap: %s failed to add\n", name);
+		ofc_hashmap_delete(map);
+		return false;
+	}
+
+	passed = hashmap__check(name, map,
+		HASHMAP_COUNT, hashmap__all);
+
+	unsigned removed = 0;
+	for (i = 0; i < HASHMAP_COUNT; i += 3, removed++)
+		ofc_hashmap_remove(map, &item[i]);
+
+	passed = hashmap__check(name, map,
+		(HASHMAP_COUNT - removed), hashmap__not_third) && passed;
+
+	ofc_hashmap_delete(map);
+	return passed;
+}
+
+/* The most recently added item with a key is found first, and the
+   older one again once it's removed. */
+static bool hashmap__shadow(void)
+{
+	ofc_hashmap_t* map = ofc_hashmap_create(
+		NULL, NULL, NULL, NULL);
+	if (!map) return false;
+
+	static hashmap_item_t older = { "SHADOW" };
+	static hashmap_item_t newer = { "SHADOW" };
+
+	bool passed = (ofc_hashmap_add(map, &older)
+		&& ofc_hashmap_add(map, &newer)
+		&& (ofc_hashmap_find(map, "SHADOW") == &newer));
+
+	ofc_hashmap_remove(map, &newer);
+	passed = (passed && (ofc_hashmap_find(map, "SHADOW") == &older));
+
+	ofc_hashmap_remove(map, &older);
+	passed = (passed && !ofc_hashmap_find(map, "SHADOW")
+		&& (ofc_hashmap_count(map) == 0));
+
+	if (!passed)
+		fprintf(stderr, "hashmap: equal keys aren't shadowed\n");
+
+	ofc_hashmap_delete(map);
+	return passed;
+}
+
+int main(void)
+{
+	unsigned i;
+	for (i = 0; i < HASHMAP_COUNT; i++)
+		snprintf(item[i].key, sizeof(item[i].key), "V%u", i);
+
+	bool passed = hashmap__add_remove("default", NULL);
+	passed = hashmap__add_remove("collide",
+		(ofc_hashmap_hash_f)hashmap__hash_collide) && passed;
+	passed = hashmap__shadow() && passed;
+
+	return (passed ? 0 : 1);
+}
@@ -0,0 +1,158 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unit.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* The FORMAT's label is unreferenced so the label pass drops it and
+   the FORMAT goes, the first CONTINUE is unlabelled and goes, and the
+   one at 10 stays. Y is never used so its declaration goes. */
+static const char* source =
+	"      PROGRAM P\n"
+	"      INTEGER X, Y\n"
+	"      X = 1\n"
+	"      CONTINUE\n"
+	" 10   CONTINUE\n"
+	" 20   FORMAT(I3)\n"
+	"      IF (X .EQ. 1) GOTO 10\n"
+	"      PRINT *, X\n"
+	"      END\n";
+
+static const ofc_sema_stmt_e expect_stmt[] =
+{
+	OFC_SEMA_STMT_ASSIGNMENT,
+	OFC_SEMA_STMT_CONTINUE,
+	OFC_SEMA_STMT_IF_STATEMENT,
+	OFC_SEMA_STMT_IO_PRINT,
+};
+
+#define EXPECT_STMT_COUNT (sizeof(expect_stmt) / sizeof(expect_stmt[0]))
+
+
+static unsigned pass__stmt_count(ofc_sema_scope_t* scope)
+{
+	unsigned count = 0;
+	unsigned i;
+	for (i = 0; i < scope->stmt->count; i++)
+	{
+		if (scope->stmt->stmt[i])
+			count++;
+	}
+	return count;
+}
+
+static unsigned pass__decl_count(ofc_sema_scope_t* scope)
+{
+	unsigned count = 0;
+	unsigned i;
+	for (i = 0; i < scope->decl->count; i++)
+	{
+		if (scope->decl->decl[i])
+			count++;
+	}
+	return count;
+}
+
+static bool pass__check_nodes(
+	const ofc_sema_pass_stats_t* stats,
+	ofc_sema_pass_e pass, unsigned nodes)
+{
+	if (!stats->pass[pass].run)
+	{
+		fprintf(stderr, "pass: %s wasn't run\n",
+			stats->pass[pass].desc);
+		return false;
+	}
+
+	if (stats->pass[pass].nodes != nodes)
+	{
+		fprintf(stderr, "pass: %s visited %u nodes, expected %u\n",
+			stats->pass[pass].desc, stats->pass[pass].nodes, nodes);
+		return false;
+	}
+
+	return true;
+}
+
+
+int main(void)
+{
+	unit_sema_t* unit = unit_sema(source, OFC_LANG_OPTS_F77);
+	ofc_sema_scope_t* scope = unit_sema_scope(unit, "P");
+	if (!scope || !scope->stmt || !scope->decl)
+	{
+		fprintf(stderr, "pass: failed to analyse source\n");
+		unit_sema_delete(unit);
+		return 1;
+	}
+
+	unsigned stmt_count = pass__stmt_count(scope);
+	unsigned decl_count = pass__decl_count(scope);
+
+	ofc_sema_pass_opts_t opts = OFC_SEMA_PASS_OPTS_DEFAULT;
+	opts.unused_decl = true;
+
+	ofc_sema_pass_stats_t stats;
+	if (!ofc_sema_run_passes(unit->file, &opts, unit->global, &stats))
+	{
+		fprintf(stderr, "pass: passes failed\n");
+		unit_sema_delete(unit);
+		return 1;
+	}
+
+	bool passed = true;
+
+	/* Both statement passes share a walk, so the continue pass
+	   doesn't visit the FORMAT the format pass removed. */
+	passed = (pass__check_nodes(&stats,
+		OFC_SEMA_PASS_UNLABELLED_FORMAT, stmt_count) && passed);
+	passed = (pass__check_nodes(&stats,
+		OFC_SEMA_PASS_UNLABELLED_CONTINUE, (stmt_count - 1)) && passed);
+	passed = (pass__check_nodes(&stats,
+		OFC_SEMA_PASS_UNUSED_DECL, decl_count) && passed);
+
+	unsigned i, j;
+	for (i = 0, j = 0; i < scope->stmt->count; i++)
+	{
+		const ofc_sema_stmt_t* stmt = scope->stmt->stmt[i];
+		if (!stmt) continue;
+
+		if ((j >= EXPECT_STMT_COUNT)
+			|| (stmt->type != expect_stmt[j]))
+		{
+			fprintf(stderr, "pass: unexpected statement %u left\n", j);
+			passed = false;
+		}
+		j++;
+	}
+	if (j != EXPECT_STMT_COUNT)
+	{
+		fprintf(stderr, "pass: %u statements left, expected %u\n",
+			j, (unsigned)EXPECT_STMT_COUNT);
+		passed = false;
+	}
+
+	if (!ofc_sema_scope_decl_find(scope, ofc_str_ref_from_strz("X"), true)
+		|| ofc_sema_scope_decl_find(scope, ofc_str_ref_from_strz("Y"), true))
+	{
+		fprintf(stderr, "pass: only the unused declaration should go\n");
+		passed = false;
+	}
+
+	unit_sema_delete(unit);
+	return (passed ? 0 : 1);
+}
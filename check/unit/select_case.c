@@ -0,0 +1,231 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+
+#include "unit.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* Analyses random SELECT CASE statements over integer ranges and checks
+   that the CASE reported as overlapping a previous one, if any, is the
+   one a pairwise check of every CASE against those before it finds. */
+
+#define SELECT_CASE_RUNS   400
+#define SELECT_CASE_MAX      8
+#define SELECT_CASE_RANGES   3
+#define SELECT_CASE_SPREAD  24
+
+/* Each CASE takes two lines after the four line header. */
+#define SELECT_CASE_ROW(i) (5 + ((i) * 2))
+
+typedef struct
+{
+	bool    open_first, open_last;
+	int64_t first, last;
+} select_case_range_t;
+
+typedef struct
+{
+	unsigned            count;
+	select_case_range_t range[SELECT_CASE_RANGES];
+} select_case_t;
+
+
+static uint32_t select_case__seed = 12345;
+
+static unsigned select_case__rand(unsigned n)
+{
+	select_case__seed = (select_case__seed * 1103515245) + 12345;
+	return ((select_case__seed >> 16) % n);
+}
+
+static int select_case__value(void)
+{
+	return (int)select_case__rand(SELECT_CASE_SPREAD)
+		- (SELECT_CASE_SPREAD / 2);
+}
+
+static void select_case__range(select_case_range_t* range)
+{
+	range->open_first = false;
+	range->open_last  = false;
+	range->first = select_case__value();
+	range->last  = range->first;
+
+	switch (select_case__rand(8))
+	{
+		case 0:
+			range->open_first = true;
+			range->first = INT64_MIN;
+			break;
+		case 1:
+			range->open_last = true;
+			range->last = INT64_MAX;
+			break;
+		case 2:
+		case 3:
+		case 4:
+			range->last += select_case__rand(4);
+			break;
+		default:
+			break;
+	}
+}
+
+static bool select_case__intersects(
+	const select_case_t* a, const select_case_t* b)
+{
+	unsigned i, j;
+	for (i = 0; i < a->count; i++)
+	{
+		for (j = 0; j < b->count; j++)
+		{
+			if ((a->range[i].first <= b->range[j].last)
+				&& (b->range[j].first <= a->range[i].last))
+				return true;
+		}
+	}
+	return false;
+}
+
+/* The first CASE to overlap any before it, or count if none do. */
+static unsigned select_case__overlap(
+	const select_case_t* select, unsigned count)
+{
+	unsigned i, l;
+	for (i = 1; i < count; i++)
+	{
+		for (l = 0; l < i; l++)
+		{
+			if (select_case__intersects(&select[i], &select[l]))
+				return i;
+		}
+	}
+	return count;
+}
+
+static int select_case__print_range(
+	char* s, const select_case_range_t* range)
+{
+	if (range->open_first)
+		return sprintf(s, ":%" PRId64, range->last);
+	if (range->open_last)
+		return sprintf(s, "%" PRId64 ":", range->first);
+	if (range->first == range->last)
+		return sprintf(s, "%" PRId64, range->first);
+	return sprintf(s, "%" PRId64 ":%" PRId64, range->first, range->last);
+}
+
+static char* select_case__source(
+	const select_case_t* select, unsigned count)
+{
+	char* source = (char*)malloc(256 + (count * 128));
+	if (!source) return NULL;
+
+	char* s = source;
+	s += sprintf(s, "program p\n  integer :: i\n  i = 0\n  select case (i)\n");
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		s += sprintf(s, "  case (");
+
+		unsigned j;
+		for (j = 0; j < select[i].count; j++)
+		{
+			if (j > 0) s += sprintf(s, ", ");
+			s += select_case__print_range(s, &select[i].range[j]);
+		}
+
+		s += sprintf(s, ")\n    i = %u\n", i);
+	}
+
+	sprintf(s, "  end select\nend program p\n");
+	return source;
+}
+
+static bool select_case__run(unsigned run)
+{
+	select_case_t select[SELECT_CASE_MAX];
+	unsigned count = 2 + select_case__rand(SELECT_CASE_MAX - 1);
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		select[i].count = 1 + select_case__rand(SELECT_CASE_RANGES);
+
+		unsigned j;
+		for (j = 0; j < select[i].count; j++)
+			select_case__range(&select[i].range[j]);
+	}
+
+	char* source = select_case__source(select, count);
+	if (!source) return false;
+
+	char*  diag      = NULL;
+	size_t diag_size = 0;
+	FILE*  stream    = open_memstream(&diag, &diag_size);
+	if (!stream)
+	{
+		free(source);
+		return false;
+	}
+
+	ofc_file_diag_capture(stream);
+	unit_sema_t* unit = unit_sema(source, OFC_LANG_OPTS_F90);
+	ofc_file_diag_capture(NULL);
+	fclose(stream);
+
+	unsigned overlap = select_case__overlap(select, count);
+
+	bool passed;
+	if (overlap >= count)
+	{
+		passed = (unit && (diag_size == 0));
+	}
+	else
+	{
+		char expect[128];
+		sprintf(expect, ":%u,7:\n   CASE range overlaps previous range\n",
+			SELECT_CASE_ROW(overlap));
+		passed = (!unit && strstr(diag, expect));
+	}
+
+	if (!passed)
+	{
+		if (overlap < count)
+			fprintf(stderr, "select_case: run %u, expected CASE %u to overlap\n",
+				run, overlap);
+		else
+			fprintf(stderr, "select_case: run %u, expected no overlap\n", run);
+		fprintf(stderr, "%s%s", source, (diag ? diag : ""));
+	}
+
+	unit_sema_delete(unit);
+	free(diag);
+	free(source);
+	return passed;
+}
+
+int main(void)
+{
+	bool passed = true;
+	unsigned run;
+	for (run = 0; passed && (run < SELECT_CASE_RUNS); run++)
+		passed = select_case__run(run);
+	return (passed ? 0 : 1);
+}
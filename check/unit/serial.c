@@ -0,0 +1,337 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+
+#include "unit.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* Writes the semantic tree of each corpus file, maps it back and checks
+   that it holds a node for each decl and statement, that every type and
+   string reference resolves to a table entry stored only once, and that
+   buffers of another version or byte order are rejected. */
+
+static const char* serial__corpus[] =
+{
+	"corpus/t1.f", "corpus/t2.f", "corpus/t3.f90", "corpus/t4.f",
+	"corpus/t5.f", "corpus/t6.f", "corpus/t7.f", "corpus/t9.f",
+	"corpus/w1.f", "corpus/d2.f", NULL
+};
+
+typedef struct
+{
+	const ofc_sema_serial_t* serial;
+
+	/* Node offsets already visited, indexed by word. */
+	uint8_t* seen;
+	unsigned count[OFC_SEMA_SERIAL_COUNT];
+
+	/* Structure members are DECL nodes too, so those
+	   listed by scopes are counted on their own. */
+	unsigned scope_decl_count;
+
+	uint8_t* type_used;
+	bool     failed;
+} serial__walk_t;
+
+static bool serial__fail(const char* path, const char* what)
+{
+	fprintf(stderr, "serial: %s: %s\n", path, what);
+	return false;
+}
+
+static void serial__node(serial__walk_t* walk, uint32_t offset)
+{
+	if ((offset == 0) || walk->failed
+		|| walk->seen[offset / sizeof(uint32_t)])
+		return;
+	walk->seen[offset / sizeof(uint32_t)] = 1;
+
+	ofc_sema_serial_node_t node;
+	if (!ofc_sema_serial_node(walk->serial, offset, &node)
+		|| (node.tag >= OFC_SEMA_SERIAL_COUNT))
+	{
+		walk->failed = true;
+		return;
+	}
+	walk->count[node.tag]++;
+
+	unsigned i;
+	ofc_sema_serial_node_t list;
+	if ((node.tag == OFC_SEMA_SERIAL_SCOPE)
+		&& (node.child_count > 3) && (node.child[3] != 0)
+		&& ofc_sema_serial_node(walk->serial, node.child[3], &list))
+	{
+		for (i = 0; i < list.child_count; i++)
+		{
+			if (list.child[i] != 0)
+				walk->scope_decl_count++;
+		}
+	}
+	for (i = 0; i < node.attr_count; i++)
+	{
+		uint32_t key   = node.attr[(i * 2) + 0];
+		uint32_t value = node.attr[(i * 2) + 1];
+		switch (key)
+		{
+			case OFC_SEMA_SERIAL_ATTR_NAME:
+			case OFC_SEMA_SERIAL_ATTR_STRING:
+			case OFC_SEMA_SERIAL_ATTR_IMAGINARY:
+			case OFC_SEMA_SERIAL_ATTR_MASK:
+			case OFC_SEMA_SERIAL_ATTR_INTRINSIC:
+				if ((value != OFC_SEMA_SERIAL_NONE)
+					&& !ofc_sema_serial_string(walk->serial, value, NULL))
+					walk->failed = true;
+				break;
+
+			case OFC_SEMA_SERIAL_ATTR_TYPE:
+				if (value == OFC_SEMA_SERIAL_NONE)
+					break;
+				if (value >= ofc_sema_serial_type_count(walk->serial))
+					walk->failed = true;
+				else
+					walk->type_used[value] = 1;
+				break;
+
+			case OFC_SEMA_SERIAL_ATTR_DECL:
+			case OFC_SEMA_SERIAL_ATTR_SCOPE:
+			case OFC_SEMA_SERIAL_ATTR_STMT:
+			case OFC_SEMA_SERIAL_ATTR_STRUCTURE:
+				serial__node(walk, value);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	for (i = 0; i < node.child_count; i++)
+		serial__node(walk, node.child[i]);
+}
+
+static bool serial__count_decl(ofc_sema_decl_t* decl, unsigned* count)
+{
+	(void)decl;
+	(*count)++;
+	return true;
+}
+
+static bool serial__count_stmt(ofc_sema_stmt_t* stmt, unsigned* count)
+{
+	(*count)++;
+
+	/* The statement of a logical IF isn't visited on its own. */
+	if ((stmt->type == OFC_SEMA_STMT_IF_STATEMENT)
+		&& stmt->if_stmt.stmt)
+		(*count)++;
+	return true;
+}
+
+static bool serial__scope_decl(ofc_sema_scope_t* scope, unsigned* count)
+{
+	return ofc_sema_scope_foreach_decl(
+		scope, count, (void*)serial__count_decl);
+}
+
+static bool serial__scope_stmt(ofc_sema_scope_t* scope, unsigned* count)
+{
+	return ofc_sema_scope_foreach_stmt(
+		scope, count, (void*)serial__count_stmt);
+}
+
+static bool serial__check(
+	const char* path, ofc_sema_scope_t* global,
+	const ofc_sema_serial_t* serial, size_t size)
+{
+	serial__walk_t walk;
+	memset(&walk, 0, sizeof(walk));
+	walk.serial    = serial;
+	walk.seen      = calloc(size / sizeof(uint32_t), 1);
+	walk.type_used = calloc(ofc_sema_serial_type_count(serial) + 1, 1);
+	if (!walk.seen || !walk.type_used)
+	{
+		free(walk.seen);
+		free(walk.type_used);
+		return serial__fail(path, "out of memory");
+	}
+
+	ofc_sema_serial_node_t root;
+	bool success = true;
+	if (!ofc_sema_serial_node(serial, ofc_sema_serial_root(serial), &root)
+		|| (root.tag != OFC_SEMA_SERIAL_SCOPE)
+		|| (root.kind != OFC_SEMA_SCOPE_SUPER))
+		success = serial__fail(path, "root isn't the super scope");
+
+	unsigned i;
+	for (i = 0; success && (i < ofc_sema_serial_type_count(serial)); i++)
+	{
+		ofc_sema_serial_node_t type;
+		if (!ofc_sema_serial_node(serial, ofc_sema_serial_type(serial, i), &type)
+			|| (type.tag != OFC_SEMA_SERIAL_TYPE))
+			success = serial__fail(path, "type table entry isn't a TYPE node");
+		serial__node(&walk, ofc_sema_serial_type(serial, i));
+	}
+
+	walk.failed = !success;
+	serial__node(&walk, ofc_sema_serial_root(serial));
+	if (success && walk.failed)
+		success = serial__fail(path, "a node or reference doesn't resolve");
+
+	for (i = 0; success && (i < ofc_sema_serial_type_count(serial)); i++)
+	{
+		if (!walk.type_used[i])
+			success = serial__fail(path, "a type id is never referenced");
+	}
+
+	/* Strings are stored once, so no two ids have the same text. */
+	unsigned string_count = ofc_sema_serial_string_count(serial);
+	for (i = 0; success && (i < string_count); i++)
+	{
+		unsigned ilen;
+		const char* istr = ofc_sema_serial_string(serial, i, &ilen);
+		if (!istr)
+		{
+			success = serial__fail(path, "a string doesn't resolve");
+			break;
+		}
+
+		unsigned j;
+		for (j = (i + 1); success && (j < string_count); j++)
+		{
+			unsigned jlen;
+			const char* jstr = ofc_sema_serial_string(serial, j, &jlen);
+			if (jstr && (ilen == jlen) && (memcmp(istr, jstr, ilen) == 0))
+				success = serial__fail(path, "a string is stored twice");
+		}
+	}
+
+	unsigned decl_count = 0, stmt_count = 0;
+	if (success
+		&& (!ofc_sema_scope_foreach_scope(global,
+				&decl_count, (void*)serial__scope_decl)
+			|| !ofc_sema_scope_foreach_scope(global,
+				&stmt_count, (void*)serial__scope_stmt)))
+		success = serial__fail(path, "failed to walk the semantic tree");
+
+	if (success && (walk.scope_decl_count != decl_count))
+	{
+		fprintf(stderr, "serial: %s: %u DECL nodes, expected %u\n",
+			path, walk.scope_decl_count, decl_count);
+		success = false;
+	}
+	if (success && (walk.count[OFC_SEMA_SERIAL_STMT] != stmt_count))
+	{
+		fprintf(stderr, "serial: %s: %u STMT nodes, expected %u\n",
+			path, walk.count[OFC_SEMA_SERIAL_STMT], stmt_count);
+		success = false;
+	}
+	if (success && (walk.count[OFC_SEMA_SERIAL_TYPE]
+		!= ofc_sema_serial_type_count(serial)))
+		success = serial__fail(path, "a TYPE node isn't in the type table");
+
+	free(walk.seen);
+	free(walk.type_used);
+	return success;
+}
+
+static bool serial__reject(
+	const char* path, const uint32_t* data, size_t size)
+{
+	uint32_t* copy = malloc(size);
+	if (!copy) return serial__fail(path, "out of memory");
+
+	bool success = true;
+
+	/* The header's second word is the version. */
+	memcpy(copy, data, size);
+	copy[1]++;
+	ofc_sema_serial_t* serial = ofc_sema_serial_create(copy, size);
+	if (serial)
+		success = serial__fail(path, "a newer version was accepted");
+	ofc_sema_serial_delete(serial);
+
+	unsigned i;
+	for (i = 0; i < (size / sizeof(uint32_t)); i++)
+		copy[i] = __builtin_bswap32(data[i]);
+	serial = ofc_sema_serial_create(copy, size);
+	if (serial)
+		success = serial__fail(path, "the other byte order was accepted");
+	ofc_sema_serial_delete(serial);
+
+	memcpy(copy, data, size);
+	serial = ofc_sema_serial_create(copy, (size - sizeof(uint32_t)));
+	if (serial)
+		success = serial__fail(path, "a truncated buffer was accepted");
+	ofc_sema_serial_delete(serial);
+
+	serial = ofc_sema_serial_create(copy, size);
+	if (!serial)
+		success = serial__fail(path, "an unmodified copy was rejected");
+	ofc_sema_serial_delete(serial);
+
+	free(copy);
+	return success;
+}
+
+static bool serial__file(const char* path)
+{
+	size_t len = strlen(path);
+	bool f90 = ((len > 4) && (strcmp(&path[len - 4], ".f90") == 0));
+
+	unit_sema_t* unit = unit_sema_file(path,
+		(f90 ? OFC_LANG_OPTS_F90 : OFC_LANG_OPTS_F77));
+	if (!unit) return serial__fail(path, "failed to analyse");
+
+	char out[] = "/tmp/ofc-serial-XXXXXX";
+	int fd = mkstemp(out);
+	if (fd < 0)
+	{
+		unit_sema_delete(unit);
+		return serial__fail(path, "failed to create output file");
+	}
+	close(fd);
+
+	bool success = true;
+	size_t size = 0;
+	uint32_t* data = ofc_sema_serial_write(unit->super, &size);
+	ofc_sema_serial_t* serial = NULL;
+	if (!data || !ofc_sema_serial_write_file(unit->super, out))
+		success = serial__fail(path, "failed to write");
+	else if (!(serial = ofc_sema_serial_map(out)))
+		success = serial__fail(path, "failed to map");
+	else if (!serial__check(path, unit->global, serial, size)
+		|| !serial__reject(path, data, size))
+		success = false;
+
+	ofc_sema_serial_delete(serial);
+	free(data);
+	unlink(out);
+	unit_sema_delete(unit);
+	return success;
+}
+
+int main(void)
+{
+	bool success = true;
+	unsigned i;
+	for (i = 0; serial__corpus[i]; i++)
+	{
+		if (!serial__file(serial__corpus[i]))
+			success = false;
+	}
+	return (success ? 0 : 1);
+}
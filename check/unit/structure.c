@@ -0,0 +1,219 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unit.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* S1 starts with an anonymous UNION, which member_get_decl_offset
+   must step into rather than looking in S1 again, S2 nests a UNION
+   within a MAP and S3 has array members. */
+static const char* source =
+	"      PROGRAM P\n"
+	"      STRUCTURE /S1/\n"
+	"        UNION\n"
+	"          MAP\n"
+	"            INTEGER A\n"
+	"            REAL B\n"
+	"          END MAP\n"
+	"          MAP\n"
+	"            REAL C\n"
+	"          END MAP\n"
+	"        END UNION\n"
+	"        INTEGER D\n"
+	"      END STRUCTURE\n"
+	"      STRUCTURE /S2/\n"
+	"        INTEGER E\n"
+	"        UNION\n"
+	"          MAP\n"
+	"            UNION\n"
+	"              MAP\n"
+	"                REAL F\n"
+	"              END MAP\n"
+	"            END UNION\n"
+	"            INTEGER G\n"
+	"          END MAP\n"
+	"          MAP\n"
+	"            INTEGER H\n"
+	"          END MAP\n"
+	"        END UNION\n"
+	"      END STRUCTURE\n"
+	"      STRUCTURE /S3/\n"
+	"        INTEGER A\n"
+	"        REAL R(2)\n"
+	"        UNION\n"
+	"          MAP\n"
+	"            INTEGER B(3)\n"
+	"          END MAP\n"
+	"          MAP\n"
+	"            REAL C\n"
+	"          END MAP\n"
+	"        END UNION\n"
+	"        INTEGER D\n"
+	"      END STRUCTURE\n"
+	"      END\n";
+
+typedef struct
+{
+	const char* structure;
+
+	/* Members flattened through anonymous structures, and the
+	   element offset each starts at. */
+	unsigned    member_count;
+	const char* member[8];
+	unsigned    member_elem[8];
+
+	/* The member decl for each element offset. */
+	unsigned    elem_count;
+	const char* elem[8];
+} structure_expect_t;
+
+static const structure_expect_t expect[] =
+{
+	{
+		"S1",
+		4, { "A", "B", "C", "D" }, { 0, 1, 0, 2 },
+		3, { "A", "B", "D" },
+	},
+	{
+		"S2",
+		4, { "E", "F", "G", "H" }, { 0, 1, 2, 1 },
+		3, { "E", "F", "G" },
+	},
+	{
+		"S3",
+		5, { "A", "R", "B", "C", "D" }, { 0, 1, 3, 3, 6 },
+		7, { "A", "R", "R", "B", "B", "B", "D" },
+	},
+};
+
+
+static bool structure__name_is(
+	const ofc_sema_decl_t* decl, const char* name)
+{
+	return (decl && ofc_str_ref_equal_strz(decl->name.string, name));
+}
+
+static bool structure__check(
+	ofc_sema_scope_t* scope, const structure_expect_t* e)
+{
+	ofc_sema_structure_t* structure
+		= ofc_sema_scope_structure_find(scope,
+			ofc_str_ref(e->structure, strlen(e->structure)));
+	if (!structure)
+	{
+		fprintf(stderr, "structure: %s not found\n", e->structure);
+		return false;
+	}
+
+	bool passed = true;
+
+	unsigned count;
+	if (!ofc_sema_structure_member_count(structure, &count)
+		|| (count != e->member_count))
+	{
+		fprintf(stderr, "structure: %s has %u members, expected %u\n",
+			e->structure, count, e->member_count);
+		passed = false;
+	}
+
+	unsigned i;
+	for (i = 0; i < e->member_count; i++)
+	{
+		ofc_sema_decl_t* decl
+			= ofc_sema_structure_member_get_decl_offset(structure, i);
+		if (!structure__name_is(decl, e->member[i]))
+		{
+			fprintf(stderr, "structure: %s member %u isn't %s\n",
+				e->structure, i, e->member[i]);
+			passed = false;
+			continue;
+		}
+
+		unsigned offset;
+		if (!ofc_sema_structure_member_offset(
+			structure, decl, &offset) || (offset != i))
+		{
+			fprintf(stderr, "structure: %s member %s offset isn't %u\n",
+				e->structure, e->member[i], i);
+			passed = false;
+		}
+
+		if (!ofc_sema_structure_member_elem_offset(
+			structure, decl, &offset) || (offset != e->member_elem[i]))
+		{
+			fprintf(stderr, "structure: %s member %s element offset isn't %u\n",
+				e->structure, e->member[i], e->member_elem[i]);
+			passed = false;
+		}
+	}
+
+	if (ofc_sema_structure_member_get_decl_offset(
+		structure, e->member_count))
+	{
+		fprintf(stderr, "structure: %s has a member past the last\n",
+			e->structure);
+		passed = false;
+	}
+
+	if (!ofc_sema_structure_elem_count(structure, &count)
+		|| (count != e->elem_count))
+	{
+		fprintf(stderr, "structure: %s has %u elements, expected %u\n",
+			e->structure, count, e->elem_count);
+		passed = false;
+	}
+
+	for (i = 0; i < e->elem_count; i++)
+	{
+		if (!structure__name_is(ofc_sema_structure_elem_get(
+			structure, i), e->elem[i]))
+		{
+			fprintf(stderr, "structure: %s element %u isn't %s\n",
+				e->structure, i, e->elem[i]);
+			passed = false;
+		}
+	}
+
+	if (ofc_sema_structure_elem_get(structure, e->elem_count))
+	{
+		fprintf(stderr, "structure: %s has an element past the last\n",
+			e->structure);
+		passed = false;
+	}
+
+	return passed;
+}
+
+int main(void)
+{
+	unit_sema_t* unit = unit_sema(source, OFC_LANG_OPTS_F77);
+	ofc_sema_scope_t* scope = unit_sema_scope(unit, "P");
+	if (!scope)
+	{
+		fprintf(stderr, "structure: failed to analyse source\n");
+		unit_sema_delete(unit);
+		return 1;
+	}
+
+	bool passed = true;
+	unsigned i;
+	for (i = 0; i < (sizeof(expect) / sizeof(expect[0])); i++)
+		passed = (structure__check(scope, &expect[i]) && passed);
+
+	unit_sema_delete(unit);
+	return (passed ? 0 : 1);
+}
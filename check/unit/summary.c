@@ -0,0 +1,161 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unit.h"
+#include "ofc/global.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* One of everything a summary holds: a COMMON block, a CALL with
+   an alternate return, a function reference and two procedures. */
+static const char* source =
+	"      SUBROUTINE S(A, *)\n"
+	"      REAL A\n"
+	"      COMMON /BLK/ I, X\n"
+	"      A = 1.0\n"
+	"      RETURN 1\n"
+	"      END\n"
+	"      INTEGER FUNCTION F(N)\n"
+	"      F = N\n"
+	"      END\n"
+	"      PROGRAM P\n"
+	"      REAL Y\n"
+	"      INTEGER J\n"
+	"      COMMON /BLK/ I, X\n"
+	"      CALL S(Y, *10)\n"
+	"   10 J = F(2)\n"
+	"      PRINT *, J\n"
+	"      END\n";
+
+
+static bool summary__check(
+	const ofc_global_summary_t* summary, const char* what)
+{
+	bool passed = true;
+	if ((summary->common_count != 2)
+		|| (summary->call_count != 1)
+		|| (summary->func_count != 1)
+		|| (summary->proc_count != 2))
+	{
+		fprintf(stderr, "summary: %s has the wrong counts\n", what);
+		return false;
+	}
+
+	const ofc_global_common_t* common = &summary->common[0];
+	if (!ofc_str_ref_equal_strz_ci(common->name, "BLK")
+		|| (common->count != 2)
+		|| !ofc_sema_type_compatible(common->member[1].type,
+			ofc_sema_type_real_default()))
+	{
+		fprintf(stderr, "summary: %s COMMON block is wrong\n", what);
+		passed = false;
+	}
+
+	const ofc_global_call_t* call = &summary->call[0];
+	if (!ofc_str_ref_equal_strz_ci(call->name, "S")
+		|| !call->args || (call->count != 2)
+		|| call->arg[0].alt_return || !call->arg[1].alt_return
+		|| call->function)
+	{
+		fprintf(stderr, "summary: %s CALL is wrong\n", what);
+		passed = false;
+	}
+
+	const ofc_global_call_t* func = &summary->func[0];
+	if (!ofc_str_ref_equal_strz_ci(func->name, "F")
+		|| !func->function || (func->count != 1)
+		|| !func->arg[0].constant)
+	{
+		fprintf(stderr, "summary: %s function reference is wrong\n", what);
+		passed = false;
+	}
+
+	const ofc_global_proc_t* proc = &summary->proc[0];
+	if ((proc->type != OFC_SEMA_SCOPE_SUBROUTINE)
+		|| (proc->count != 2)
+		|| !proc->arg[0].written
+		|| !proc->arg[1].alt_return)
+	{
+		fprintf(stderr, "summary: %s SUBROUTINE is wrong\n", what);
+		passed = false;
+	}
+
+	return passed;
+}
+
+
+int main(void)
+{
+	unit_sema_t* unit = unit_sema(source, OFC_LANG_OPTS_F77);
+	ofc_global_summary_t* summary
+		= (unit ? ofc_global_summary_create(unit->global) : NULL);
+	if (!summary)
+	{
+		fprintf(stderr, "summary: failed to summarise source\n");
+		unit_sema_delete(unit);
+		return 1;
+	}
+
+	bool passed = summary__check(summary, "built summary");
+
+	size_t size;
+	void* buff = ofc_global_summary_write(summary, &size);
+	ofc_global_summary_delete(summary);
+	unit_sema_delete(unit);
+	if (!buff)
+	{
+		fprintf(stderr, "summary: failed to write\n");
+		return 1;
+	}
+
+	/* A summary which was read doesn't need its file any more. */
+	ofc_global_summary_t* read
+		= ofc_global_summary_read(buff, size);
+	if (!read)
+	{
+		fprintf(stderr, "summary: failed to read\n");
+		passed = false;
+	}
+	else
+	{
+		passed = (summary__check(read, "read summary") && passed);
+
+		/* Its locations are already rendered, so it's written the same. */
+		size_t rsize;
+		void* rbuff = ofc_global_summary_write(read, &rsize);
+		if (!rbuff || (rsize != size)
+			|| (memcmp(rbuff, buff, size) != 0))
+		{
+			fprintf(stderr, "summary: read summary wasn't written the same\n");
+			passed = false;
+		}
+		free(rbuff);
+		ofc_global_summary_delete(read);
+	}
+
+	/* A truncated entry is refused rather than read past its end. */
+	ofc_global_summary_t* trunc
+		= ofc_global_summary_read(buff, (size - 1));
+	if (trunc)
+	{
+		fprintf(stderr, "summary: truncated summary was read\n");
+		ofc_global_summary_delete(trunc);
+		passed = false;
+	}
+
+	free(buff);
+	return (passed ? 0 : 1);
+}
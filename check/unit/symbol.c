@@ -0,0 +1,166 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unit.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* Checks that spellings which differ only in case are folded together,
+   that lookups only ignore case when asked to, and that a decl is found
+   by any spelling of its name unless --case-sen is given. */
+
+#define SYMBOL_MANY 5000
+
+static bool symbol__fail(const char* what)
+{
+	fprintf(stderr, "symbol: %s\n", what);
+	return false;
+}
+
+static bool symbol__table(void)
+{
+	ofc_symbol_table_t* table = ofc_symbol_table_create();
+	ofc_symbol_table_t* other = ofc_symbol_table_create();
+	if (!table || !other)
+	{
+		ofc_symbol_table_delete(table);
+		ofc_symbol_table_delete(other);
+		return symbol__fail("failed to create tables");
+	}
+
+	bool success = true;
+
+	ofc_symbol_t a = ofc_symbol(table, ofc_str_ref_from_strz("Foo"));
+	ofc_symbol_t b = ofc_symbol(table, ofc_str_ref_from_strz("FOO"));
+	ofc_symbol_t c = ofc_symbol(table, ofc_str_ref_from_strz("bar"));
+	if (!a || !b || !c || (a == b))
+		success = symbol__fail("'Foo' and 'FOO' aren't distinct symbols");
+	else if ((ofc_symbol_fold(a) != a) || (ofc_symbol_fold(b) != a)
+		|| (ofc_symbol_fold(c) != c))
+		success = symbol__fail("'FOO' isn't folded onto 'Foo'");
+	else if ((ofc_symbol(table, ofc_str_ref_from_strz("Foo")) != a)
+		|| (ofc_symbol_table_count(table) != 3))
+		success = symbol__fail("'Foo' was interned twice");
+	else if ((ofc_symbol_hash(a) != ofc_str_ref_hash(ofc_str_ref_from_strz("Foo")))
+		|| (ofc_symbol_hash_ci(b) != ofc_str_ref_hash_ci(ofc_str_ref_from_strz("foo"))))
+		success = symbol__fail("symbol hashes don't match their names");
+
+	if (success)
+	{
+		if (ofc_symbol_find(table, ofc_str_ref_from_strz("foo"), false) != a)
+			success = symbol__fail("'foo' doesn't find 'Foo' ignoring case");
+		if (ofc_symbol_find(table, ofc_str_ref_from_strz("foo"), true))
+			success = symbol__fail("'foo' matches a symbol with case");
+		if (ofc_symbol_find(table, ofc_str_ref_from_strz("FOO"), true) != b)
+			success = symbol__fail("'FOO' doesn't find itself with case");
+		if (ofc_symbol_find(table, ofc_str_ref_from_strz("baz"), false))
+			success = symbol__fail("'baz' matches without being interned");
+	}
+
+	if (success)
+	{
+		/* Imported the other way round, so 'FOO' is seen first. */
+		ofc_symbol_t ib = ofc_symbol_import(other, b);
+		ofc_symbol_t ia = ofc_symbol_import(other, a);
+		if (!ia || !ib || (ia == a)
+			|| !ofc_str_ref_equal(ofc_symbol_name(ia), ofc_symbol_name(a))
+			|| (ofc_symbol_hash(ia) != ofc_symbol_hash(a)))
+			success = symbol__fail("'Foo' wasn't imported");
+		else if ((ofc_symbol_fold(ia) != ib) || (ofc_symbol_fold(ib) != ib))
+			success = symbol__fail("imported 'Foo' isn't folded onto 'FOO'");
+		else if (ofc_symbol_find(table, ofc_str_ref_from_strz("FOO"), true) != b)
+			success = symbol__fail("importing changed the source table");
+	}
+
+	/* Enough names that the index grows several times. */
+	char name[SYMBOL_MANY][8];
+	ofc_symbol_t symbol[SYMBOL_MANY];
+	unsigned i;
+	for (i = 0; success && (i < SYMBOL_MANY); i++)
+	{
+		snprintf(name[i], sizeof(name[i]), "V%u", i);
+		symbol[i] = ofc_symbol(table, ofc_str_ref_from_strz(name[i]));
+		if (!symbol[i])
+			success = symbol__fail("failed to intern many names");
+	}
+	for (i = 0; success && (i < SYMBOL_MANY); i++)
+	{
+		name[i][0] = 'v';
+		if (ofc_symbol_find(table, ofc_str_ref_from_strz(name[i]), false)
+			!= symbol[i])
+			success = symbol__fail("a name was lost as the index grew");
+	}
+
+	ofc_symbol_table_delete(table);
+	ofc_symbol_table_delete(other);
+	return success;
+}
+
+static bool symbol__scope(bool case_sensitive)
+{
+	static const char* source =
+		"      PROGRAM P\n"
+		"      INTEGER Foo\n"
+		"      Foo = 1\n"
+		"      PRINT *, Foo\n"
+		"      END\n";
+
+	global_opts.case_sensitive = case_sensitive;
+	unit_sema_t* unit = unit_sema(source, OFC_LANG_OPTS_F77);
+	unit_sema_t* copy = unit_sema(source, OFC_LANG_OPTS_F77);
+	ofc_sema_scope_t* scope = unit_sema_scope(unit, "P");
+	global_opts.case_sensitive = false;
+	if (!scope || !copy)
+	{
+		unit_sema_delete(unit);
+		unit_sema_delete(copy);
+		return symbol__fail("failed to analyse source");
+	}
+
+	bool success = true;
+	if (!scope->symbols || (scope->symbols != unit->global->symbols))
+		success = symbol__fail("a program doesn't share its file's table");
+	if (unit->global->symbols == copy->global->symbols)
+		success = symbol__fail("two files share a table");
+
+	global_opts.case_sensitive = case_sensitive;
+	const ofc_sema_decl_t* exact = ofc_sema_scope_decl_find(
+		scope, ofc_str_ref_from_strz("Foo"), true);
+	const ofc_sema_decl_t* upper = ofc_sema_scope_decl_find(
+		scope, ofc_str_ref_from_strz("FOO"), true);
+	global_opts.case_sensitive = false;
+
+	if (!exact)
+		success = symbol__fail("'Foo' isn't declared");
+	else if (case_sensitive && upper)
+		success = symbol__fail("'FOO' matches 'Foo' with --case-sen");
+	else if (!case_sensitive && (upper != exact))
+		success = symbol__fail("'FOO' doesn't match 'Foo'");
+
+	unit_sema_delete(unit);
+	unit_sema_delete(copy);
+	return success;
+}
+
+int main(void)
+{
+	bool success = symbol__table();
+	if (!symbol__scope(false))
+		success = false;
+	if (!symbol__scope(true))
+		success = false;
+	return (success ? 0 : 1);
+}
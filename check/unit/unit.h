@@ -0,0 +1,144 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __check_unit_h__
+#define __check_unit_h__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ofc/file.h"
+#include "ofc/prep.h"
+#include "ofc/parse.h"
+#include "ofc/sema.h"
+#include "ofc/global_opts.h"
+
+typedef struct
+{
+	char              path[32];
+	ofc_file_t*       file;
+	ofc_sema_scope_t* super;
+	ofc_sema_scope_t* global;
+} unit_sema_t;
+
+static inline void unit_sema_delete(unit_sema_t* unit)
+{
+	if (!unit)
+		return;
+
+	ofc_sema_scope_delete(unit->super);
+	ofc_file_delete(unit->file);
+	if (unit->path[0] != '\0')
+		unlink(unit->path);
+	free(unit);
+}
+
+static inline bool unit_sema__analyse(
+	unit_sema_t* unit, const char* path, ofc_lang_opts_t opts)
+{
+	unit->file = ofc_file_create(path, opts);
+	if (!unit->file)
+		return false;
+
+	ofc_sparse_t* condense = ofc_prep(unit->file);
+	if (!condense)
+		return false;
+
+	ofc_parse_file_t* program = ofc_parse_file(condense);
+	if (!program)
+	{
+		ofc_sparse_delete(condense);
+		return false;
+	}
+
+	unit->super = ofc_sema_scope_super();
+	if (unit->super)
+		unit->global = ofc_sema_scope_global(unit->super, program);
+	if (!unit->global)
+	{
+		ofc_parse_file_delete(program);
+		return false;
+	}
+
+	return true;
+}
+
+/* Analyses source as a file of its own, as the frontend would. */
+static inline unit_sema_t* unit_sema(
+	const char* source, ofc_lang_opts_t opts)
+{
+	unit_sema_t* unit
+		= (unit_sema_t*)calloc(1, sizeof(unit_sema_t));
+	if (!unit) return NULL;
+
+	strcpy(unit->path, "/tmp/ofc-unit-XXXXXX");
+	int fd = mkstemp(unit->path);
+	if (fd < 0)
+	{
+		unit->path[0] = '\0';
+		unit_sema_delete(unit);
+		return NULL;
+	}
+
+	size_t len = strlen(source);
+	bool written = (write(fd, source, len) == (ssize_t)len);
+	close(fd);
+	if (!written || !unit_sema__analyse(unit, unit->path, opts))
+	{
+		unit_sema_delete(unit);
+		return NULL;
+	}
+
+	return unit;
+}
+
+/* Analyses an existing file, which is left in place. */
+static inline unit_sema_t* unit_sema_file(
+	const char* path, ofc_lang_opts_t opts)
+{
+	unit_sema_t* unit
+		= (unit_sema_t*)calloc(1, sizeof(unit_sema_t));
+	if (!unit) return NULL;
+
+	if (!unit_sema__analyse(unit, path, opts))
+	{
+		unit_sema_delete(unit);
+		return NULL;
+	}
+
+	return unit;
+}
+
+/* Finds a program unit by name within the analysed file. */
+static inline ofc_sema_scope_t* unit_sema_scope(
+	unit_sema_t* unit, const char* name)
+{
+	if (!unit || !unit->global->child)
+		return NULL;
+
+	unsigned i;
+	for (i = 0; i < unit->global->child->count; i++)
+	{
+		ofc_sema_scope_t* scope
+			= unit->global->child->scope[i];
+		if (ofc_str_ref_equal_strz_ci(scope->name, name))
+			return scope;
+	}
+	return NULL;
+}
+
+#endif
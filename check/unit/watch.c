@@ -0,0 +1,191 @@
+/* Copyright 2016 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unit.h"
+
+ofc_global_opts_t global_opts;
+
+
+/* Only the body of P changes. */
+static const char* source[] =
+{
+	"      SUBROUTINE S(A)\n"
+	"      REAL A\n"
+	"      A = 1.0\n"
+	"      END\n"
+	"      PROGRAM P\n"
+	"      REAL Y\n"
+	"      CALL S(Y)\n"
+	"      END\n",
+
+	"      SUBROUTINE S(A)\n"
+	"      REAL A\n"
+	"      A = 1.0\n"
+	"      END\n"
+	"      PROGRAM P\n"
+	"      REAL Y\n"
+	"      CALL S(Y)\n"
+	"      PRINT *, Y\n"
+	"      END\n",
+
+	/* S moves down a line, so it can't be shared. */
+	"C     COMMENT\n"
+	"      SUBROUTINE S(A)\n"
+	"      REAL A\n"
+	"      A = 1.0\n"
+	"      END\n"
+	"      PROGRAM P\n"
+	"      REAL Y\n"
+	"      CALL S(Y)\n"
+	"      PRINT *, Y\n"
+	"      END\n",
+};
+
+#define SOURCE_COUNT (sizeof(source) / sizeof(source[0]))
+
+static const unsigned expect_shared[SOURCE_COUNT] = { 0, 1, 0 };
+
+
+static ofc_parse_file_t* watch__parse(
+	const char* path, const char* text)
+{
+	FILE* fp = fopen(path, "w");
+	if (!fp) return NULL;
+	bool written = (fputs(text, fp) >= 0);
+	fclose(fp);
+	if (!written) return NULL;
+
+	ofc_file_t* file = ofc_file_create(path, OFC_LANG_OPTS_F77);
+	if (!file) return NULL;
+
+	ofc_sparse_t* condense = ofc_prep(file);
+	ofc_file_delete(file);
+	if (!condense) return NULL;
+
+	ofc_parse_file_t* program = ofc_parse_file(condense);
+	if (!program) ofc_sparse_delete(condense);
+	return program;
+}
+
+static ofc_sema_scope_t* watch__subroutine(
+	ofc_sema_scope_t* global)
+{
+	const ofc_sema_decl_t* decl = ofc_sema_scope_decl_find(
+		global, ofc_str_ref_from_strz("S"), true);
+	return (decl ? decl->func : NULL);
+}
+
+
+int main(void)
+{
+	/* Units are only analysed apart, and so shareable, by --watch. */
+	global_opts.watch = true;
+
+	char path[] = "/tmp/ofc-unit-XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) return 1;
+	close(fd);
+
+	ofc_sema_scope_t* super = ofc_sema_scope_super();
+	ofc_sema_scope_t* global = NULL;
+	ofc_sema_scope_t* retired[SOURCE_COUNT];
+	unsigned retired_count = 0;
+
+	bool passed = (super != NULL);
+	unsigned i;
+	for (i = 0; passed && (i < SOURCE_COUNT); i++)
+	{
+		ofc_parse_file_t* program
+			= watch__parse(path, source[i]);
+		if (!program)
+		{
+			fprintf(stderr, "watch: failed to parse version %u\n", i);
+			passed = false;
+			break;
+		}
+
+		if (!global)
+		{
+			global = ofc_sema_scope_global(super, program);
+			if (!global)
+			{
+				ofc_parse_file_delete(program);
+				passed = false;
+			}
+			continue;
+		}
+
+		ofc_sema_scope_t* prev_sub = watch__subroutine(global);
+
+		unsigned shared = 0;
+		ofc_sema_scope_t* scope = ofc_sema_scope_global_update(
+			super, program, global, &shared);
+		if (!scope || !ofc_sema_scope_global_replace(
+			super, global, scope, program))
+		{
+			fprintf(stderr, "watch: failed to analyse version %u\n", i);
+			ofc_sema_scope_delete(scope);
+			ofc_parse_file_delete(program);
+			passed = false;
+			break;
+		}
+
+		if (shared != expect_shared[i])
+		{
+			fprintf(stderr, "watch: version %u shared %u units, expected %u\n",
+				i, shared, expect_shared[i]);
+			passed = false;
+		}
+
+		ofc_sema_scope_t* sub = watch__subroutine(scope);
+		if (!sub || ((sub == prev_sub) != (shared > 0)))
+		{
+			fprintf(stderr, "watch: version %u has the wrong SUBROUTINE scope\n", i);
+			passed = false;
+		}
+		else if ((sub->parent != scope)
+			|| (sub->symbols != scope->symbols)
+			|| (scope->symbols != global->symbols))
+		{
+			fprintf(stderr, "watch: version %u SUBROUTINE wasn't moved\n", i);
+			passed = false;
+		}
+
+		/* The old scope no longer holds the units it shared. */
+		if (watch__subroutine(global) == sub)
+		{
+			fprintf(stderr, "watch: version %u SUBROUTINE still in the old scope\n", i);
+			passed = false;
+		}
+
+		retired[retired_count++] = global;
+		global = scope;
+
+		/* A shared unit outlives the scope it was analysed in. */
+		ofc_sema_scope_delete(retired[--retired_count]);
+		if (sub && !ofc_sema_scope_decl_find(
+			sub, ofc_str_ref_from_strz("A"), true))
+		{
+			fprintf(stderr, "watch: version %u SUBROUTINE lost its decls\n", i);
+			passed = false;
+		}
+	}
+
+	while (retired_count > 0)
+		ofc_sema_scope_delete(retired[--retired_count]);
+	ofc_sema_scope_delete(super);
+	unlink(path);
+	return (passed ? 0 : 1);
+}
@@ -0,0 +1,58 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_arena_h__
+#define __ofc_arena_h__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct ofc_arena_s ofc_arena_t;
+
+typedef struct
+{
+	size_t   reserved;
+	size_t   used;
+	size_t   live;
+	unsigned nodes;
+	unsigned chunks;
+} ofc_arena_stats_t;
+
+/* Arenas are reference counted, the memory is released in bulk
+   when the last reference is deleted. An arena must only be
+   allocated from by one thread at a time. */
+ofc_arena_t* ofc_arena_create(void);
+bool ofc_arena_reference(ofc_arena_t* arena);
+void ofc_arena_delete(ofc_arena_t* arena);
+
+/* Stats must not be taken while the arena is being allocated from. */
+bool ofc_arena_stats(
+	ofc_arena_t* arena,
+	ofc_arena_stats_t* stats);
+
+/* The current arena is per-thread, setting it returns the previous one. */
+ofc_arena_t* ofc_arena_current(void);
+ofc_arena_t* ofc_arena_current_set(ofc_arena_t* arena);
+
+/* Nodes come from the current arena, or from malloc when there is none.
+   Freeing a node recycles it within its arena, nodes which aren't
+   freed are released along with the arena. A node may be freed on any
+   thread, even while its arena is being allocated from, nodes freed
+   on a thread which doesn't have their arena as its current one are
+   only recycled when the arena next runs out of nodes of that size. */
+void* ofc_arena_node_alloc(size_t size);
+void  ofc_arena_node_free(void* node);
+
+#endif
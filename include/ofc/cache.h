@@ -0,0 +1,66 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __ofc_cache_h__
+#define __ofc_cache_h__
+
+#include <stdbool.h>
+
+#include "ofc/file.h"
+#include "ofc/parse/file.h"
+#include "ofc/global.h"
+
+/* Each source file has a cache entry holding the diagnostics raised
+   while it was analysed and a summary of it for the global passes,
+   it's keyed on the ofc binary, the working directory, the options,
+   the file's path and the file's contents, and is only used while
+   the contents of the include files it read are unchanged. A file
+   which USEs modules also depends on the files before it, and one
+   which defines modules is analysed whenever a file after it is,
+   since that file may USE them. */
+typedef struct ofc_cache_s ofc_cache_t;
+
+/* Looks up the entry of each source file. */
+ofc_cache_t* ofc_cache_create(
+	const char* dir, int argc, const char* argv[],
+	const ofc_file_list_t* file_list);
+void ofc_cache_delete(ofc_cache_t* cache);
+
+/* Whether the source file at index can be replayed
+   rather than analysed. */
+bool ofc_cache_file_hit(
+	const ofc_cache_t* cache, unsigned index);
+
+/* Diagnostics are captured from when capture is called until
+   they're written to stderr and stored by ofc_cache_store. */
+bool ofc_cache_capture(ofc_cache_t* cache);
+
+/* Writes the stored diagnostics of the next source file in file
+   order to stderr, and takes its summary, which is NULL if the
+   file wasn't analysed semantically. */
+bool ofc_cache_file_replay(
+	ofc_cache_t* cache, ofc_global_summary_t** summary);
+
+/* Ends the diagnostics of the next source file in file order,
+   recording the include files its program read and its summary. */
+void ofc_cache_file_done(
+	ofc_cache_t* cache, const ofc_parse_file_t* program,
+	const ofc_global_summary_t* summary);
+
+/* Stores the entries of the files which were analysed. */
+void ofc_cache_store(ofc_cache_t* cache, bool success);
+
+#endif
@@ -52,6 +52,7 @@ typedef enum
 	OFC_CLIARG_PRINT_AUTOMATIC,
 	OFC_CLIARG_INIT_LOCAL_ZERO,
 	OFC_CLIARG_LOWERCASE_KEYWORD,
+	OFC_CLIARG_PRINT_SELECT_DENSITY,
 	OFC_CLIARG_DEBUG,
 	OFC_CLIARG_COLUMNS,
 	OFC_CLIARG_CASE_SEN,
@@ -65,6 +66,13 @@ typedef enum
 	OFC_CLIARG_SEMA_UNUSED_DECL,
 	OFC_CLIARG_NO_ESCAPE,
 	OFC_CLIARG_COMMON_USAGE,
+	OFC_CLIARG_JOBS,
+	OFC_CLIARG_STATS,
+	OFC_CLIARG_PARSE_MEMO,
+	OFC_CLIARG_WATCH,
+	OFC_CLIARG_CACHE_DIR,
+	OFC_CLIARG_SEMA_SERIAL,
+	OFC_CLIARG_UNIT_JOBS,
 
 	OFC_CLIARG_INVALID
 } ofc_cliarg_e;
@@ -72,6 +80,8 @@ typedef enum
 typedef enum
 {
 	OFC_CLIARG_PARAM_GLOB_NONE = 0,
+	OFC_CLIARG_PARAM_GLOB_INT,
+	OFC_CLIARG_PARAM_GLOB_STR,
 	OFC_CLIARG_PARAM_PRIN_NONE,
 	OFC_CLIARG_PARAM_PRIN_INT,
 	OFC_CLIARG_PARAM_LANG_NONE,
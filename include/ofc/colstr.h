@@ -24,6 +24,16 @@ typedef struct ofc_colstr_s ofc_colstr_t;
 ofc_colstr_t* ofc_colstr_create(
 	const ofc_print_opts_t print_opts,
 	unsigned cols, unsigned ext);
+/* A streaming colstr passes completed lines on to an fd or callback
+   as it goes, rather than holding the whole output until it's printed. */
+ofc_colstr_t* ofc_colstr_create_fd(
+	const ofc_print_opts_t print_opts,
+	unsigned cols, unsigned ext, int fd);
+ofc_colstr_t* ofc_colstr_create_stream(
+	const ofc_print_opts_t print_opts,
+	unsigned cols, unsigned ext,
+	bool (*func)(const char* base, unsigned size, void* param),
+	void* param);
 void ofc_colstr_delete(ofc_colstr_t* cstr);
 
 bool ofc_colstr_newline(
@@ -68,6 +78,9 @@ bool ofc_colstr_keyword_atomic_writef(
 
 bool ofc_colstr_fdprint(ofc_colstr_t* cstr, int fd);
 
+/* Ends the output of a streaming colstr, writing what remains. */
+bool ofc_colstr_flush(ofc_colstr_t* cstr);
+
 
 const ofc_print_opts_t* ofc_colstr_print_opts_get(const ofc_colstr_t* cstr);
 
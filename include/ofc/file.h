@@ -27,6 +27,15 @@ typedef struct
 
 typedef struct ofc_file_s ofc_file_t;
 
+/* A diagnostic location rendered while its file is loaded, so that
+   a warning can still be raised there once the file is gone. */
+typedef struct
+{
+	char*    head;
+	char*    tail;
+	unsigned indent;
+} ofc_file_loc_t;
+
 typedef struct
 {
 	unsigned     count;
@@ -40,12 +49,17 @@ ofc_file_t* ofc_file_create(const char* path, ofc_lang_opts_t opts);
 ofc_file_t* ofc_file_create_include(
 	const char* path, ofc_lang_opts_t opts,
 	const ofc_file_t* parent_file, ofc_sparse_ref_t include_stmt);
+/* Creates another inclusion of an include file, sharing its text. */
+ofc_file_t* ofc_file_create_include_shared(
+	const ofc_file_t* source,
+	const ofc_file_t* parent_file, ofc_sparse_ref_t include_stmt);
 bool ofc_file_reference(ofc_file_t* file);
 void ofc_file_delete(ofc_file_t* file);
 
 const char* ofc_file_get_path(const ofc_file_t* file);
 const char* ofc_file_get_include(const ofc_file_t* file);
 const char* ofc_file_get_strz(const ofc_file_t* file);
+unsigned    ofc_file_get_size(const ofc_file_t* file);
 
 const ofc_lang_opts_t* ofc_file_get_lang_opts(const ofc_file_t* file);
 ofc_lang_opts_t* ofc_file_modify_lang_opts(ofc_file_t* file);
@@ -53,6 +67,16 @@ ofc_lang_opts_t* ofc_file_modify_lang_opts(ofc_file_t* file);
 char* ofc_file_include_path(
 	const ofc_file_t* file, const char* path);
 
+/* Returns the path ofc_file_create_include would open, to be freed. */
+char* ofc_file_include_resolve(
+	const char* path, const ofc_file_t* parent_file);
+
+/* True if the file on disk no longer matches the text that was read. */
+bool ofc_file_changed(const ofc_file_t* file);
+/* Reads the file again into a new file with the same options
+   and include paths. */
+ofc_file_t* ofc_file_reload(const ofc_file_t* file);
+
 bool ofc_file_get_position(
 	const ofc_file_t* file, const char* ptr,
 	unsigned* row, unsigned* col);
@@ -70,8 +94,37 @@ void ofc_file_include_list_delete(
 	ofc_file_include_list_t* list);
 
 #include <stdarg.h>
+#include <stdio.h>
+
+/* Redirects diagnostics raised by the calling thread to stream,
+   and resets its error count, passing NULL restores stderr. */
+void ofc_file_diag_capture(FILE* stream);
+
+typedef struct
+{
+	FILE*    stream;
+	char*    buff;
+	size_t   size;
+	unsigned errors;
+	unsigned warnings;
+
+	FILE*    prev;
+	unsigned prev_errors;
+	unsigned prev_warnings;
+} ofc_file_diag_t;
+
+/* Holds back the diagnostics raised by the calling thread until
+   they're released, they can then be replayed on any thread in
+   whatever order they would have been raised by a serial run.
+   Replaying adds their counts to the replaying thread. */
+void ofc_file_diag_hold(ofc_file_diag_t* diag);
+void ofc_file_diag_release(ofc_file_diag_t* diag);
+void ofc_file_diag_replay(ofc_file_diag_t* diag);
+void ofc_file_diag_discard(ofc_file_diag_t* diag);
 
 bool ofc_file_no_errors(void);
+unsigned ofc_file_error_count(void);
+unsigned ofc_file_warning_count(void);
 
 void ofc_file_error(
 	const ofc_file_t* file, const char* ptr,
@@ -91,4 +144,18 @@ void ofc_file_warning_va(
 	const char* sol, const char* ptr,
 	const char* format, va_list args);
 
+bool ofc_file_loc(
+	const ofc_file_t* file,
+	const char* sol, const char* ptr,
+	ofc_file_loc_t* loc);
+void ofc_file_loc_cleanup(ofc_file_loc_t* loc);
+
+void ofc_file_loc_warning(
+	const ofc_file_loc_t* loc,
+	const char* format, ...)
+	__attribute__ ((format (printf, 2, 3)));
+void ofc_file_loc_warning_va(
+	const ofc_file_loc_t* loc,
+	const char* format, va_list args);
+
 #endif
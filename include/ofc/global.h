@@ -18,10 +18,141 @@
 
 #include <ofc/sema.h>
 
+/* The global passes check a summary of each file rather than its
+   semantic tree, so that the summary of a file which hasn't changed
+   can be read from the cache instead of analysing the file again.
+   Warnings are raised at a reference into a live source file, or at
+   a location rendered when the summary was written. */
+typedef struct
+{
+	ofc_sparse_ref_t ref;
+	ofc_file_loc_t   loc;
+} ofc_global_loc_t;
+
+void ofc_global_loc_warning(
+	const ofc_global_loc_t* loc,
+	const char* format, ...)
+	__attribute__ ((format (printf, 2, 3)));
+
+typedef struct
+{
+	const ofc_sema_type_t* type;
+	bool                   sized;
+} ofc_global_member_t;
+
+typedef struct
+{
+	ofc_str_ref_t        name;
+	unsigned             count;
+	ofc_global_member_t* member;
+} ofc_global_common_t;
+
+/* An actual argument's type and whether it's constant are only
+   kept when it's neither an alternate return nor EXTERNAL. */
+typedef struct
+{
+	bool alt_return;
+	bool external;
+	bool constant;
+
+	const ofc_sema_type_t* type;
+	ofc_global_loc_t       src;
+} ofc_global_actual_t;
+
+/* A CALL statement or function reference, args is false when it
+   has no argument list and the return type is only kept for
+   function references. */
+typedef struct
+{
+	ofc_str_ref_t          name;
+	const ofc_sema_type_t* type;
+	ofc_global_loc_t       src;
+
+	bool                 args;
+	unsigned             count;
+	ofc_global_actual_t* arg;
+
+	bool                   function;
+	const ofc_sema_type_t* ret_type;
+	ofc_global_loc_t       ret_src;
+} ofc_global_call_t;
+
+typedef struct
+{
+	bool alt_return;
+	bool declared;
+	bool written;
+
+	const ofc_sema_type_t* type;
+} ofc_global_dummy_t;
+
+/* A SUBROUTINE or FUNCTION, args is false when it has no
+   argument list. */
+typedef struct
+{
+	ofc_sema_scope_e       type;
+	ofc_str_ref_t          name;
+	const ofc_sema_type_t* ret_type;
+
+	bool                args;
+	unsigned            count;
+	ofc_global_dummy_t* arg;
+} ofc_global_proc_t;
+
+/* Calls are kept in the order the passes would find them, those
+   from CALL statements before function references. */
+typedef struct
+{
+	unsigned             common_count, common_size;
+	ofc_global_common_t* common;
+
+	unsigned           call_count, call_size;
+	ofc_global_call_t* call;
+
+	unsigned           func_count, func_size;
+	ofc_global_call_t* func;
+
+	unsigned           proc_count, proc_size;
+	ofc_global_proc_t* proc;
+
+	/* Strings and locations of a summary which was read. */
+	char* buff;
+} ofc_global_summary_t;
+
+typedef struct
+{
+	unsigned               count, size;
+	ofc_global_summary_t** summary;
+} ofc_global_summary_list_t;
+
+/* A summary of a scope refers into its tree, which must outlive it. */
+ofc_global_summary_t* ofc_global_summary_create(
+	ofc_sema_scope_t* scope);
+void ofc_global_summary_delete(
+	ofc_global_summary_t* summary);
+
+/* Writes a malloc'd buffer with the locations rendered,
+   returns NULL on failure. */
+void* ofc_global_summary_write(
+	const ofc_global_summary_t* summary, size_t* size);
+ofc_global_summary_t* ofc_global_summary_read(
+	const void* buff, size_t size);
+
+ofc_global_summary_list_t* ofc_global_summary_list_create(void);
+bool ofc_global_summary_list_add(
+	ofc_global_summary_list_t* list,
+	ofc_global_summary_t* summary);
+void ofc_global_summary_list_delete(
+	ofc_global_summary_list_t* list);
+
 bool ofc_global_pass_common(
 	ofc_sema_scope_t* scope);
+bool ofc_global_pass_common_summary(
+	const ofc_global_summary_list_t* list);
 
 bool ofc_global_pass_args(
 	ofc_sema_scope_t* scope);
+bool ofc_global_pass_args_summary(
+	const ofc_global_summary_list_t* list);
 
 #endif
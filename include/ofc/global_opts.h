@@ -36,6 +36,15 @@ typedef struct
 	bool sema_print;
 	bool no_escape;
 	bool common_usage_print;
+	bool stats_print;
+	bool parse_memo;
+	bool watch;
+
+	unsigned jobs;
+	unsigned unit_jobs;
+
+	const char* cache_dir;
+	const char* sema_serial;
 } ofc_global_opts_t;
 
 static const ofc_global_opts_t
@@ -56,9 +65,20 @@ static const ofc_global_opts_t
 	.parse_print           = false,
 	.sema_print            = false,
 	.common_usage_print    = false,
+	.stats_print           = false,
+	.parse_memo            = false,
+	.watch                 = false,
 	.no_escape             = false,
+
+	.jobs                  = 1,
+	.unit_jobs             = 1,
+
+	.cache_dir             = NULL,
+	.sema_serial           = NULL,
 };
 
+/* Set while parsing the command line and read-only after that,
+   which is what allows it to be shared between worker threads. */
 extern ofc_global_opts_t global_opts;
 
 #endif
@@ -19,13 +19,18 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-typedef uint8_t     (*ofc_hashmap_hash_f       )(const void* key);
+typedef uint32_t    (*ofc_hashmap_hash_f       )(const void* key);
 typedef bool        (*ofc_hashmap_key_compare_f)(const void* a, const void* b);
 typedef const void* (*ofc_hashmap_item_key_f   )(const void* item);
 typedef void        (*ofc_hashmap_item_delete_f)(void* item);
 
 typedef struct ofc_hashmap_s ofc_hashmap_t;
 
+uint32_t ofc_hashmap_hash_bytes(const void* data, unsigned size);
+uint32_t ofc_hashmap_hash_bytes_ci(const void* data, unsigned size);
+uint32_t ofc_hashmap_hash_uint(uintmax_t value);
+uint32_t ofc_hashmap_hash_ptr(const void* ptr);
+
 ofc_hashmap_t* ofc_hashmap_create(
 	ofc_hashmap_hash_f        hash,
 	ofc_hashmap_key_compare_f key_compare,
@@ -37,6 +42,7 @@ bool ofc_hashmap_add(ofc_hashmap_t* map, void* item);
 void ofc_hashmap_remove(ofc_hashmap_t* map, const void* item);
 
 const void* ofc_hashmap_find(const ofc_hashmap_t* map, const void* key);
+unsigned    ofc_hashmap_count(const ofc_hashmap_t* map);
 
 /* Don't modify the key in this function. */
 void* ofc_hashmap_find_modify(ofc_hashmap_t* map, const void* key);
@@ -28,4 +28,14 @@ bool ofc_label_table_add(
 bool ofc_label_table_find(
 	const ofc_label_table_t* table, unsigned offset, unsigned* number);
 
+/* Labels are indexed in offset order, lower_bound returns the index
+   of the first label at or after offset. */
+unsigned ofc_label_table_count(
+	const ofc_label_table_t* table);
+bool ofc_label_table_get(
+	const ofc_label_table_t* table, unsigned index,
+	unsigned* offset, unsigned* number);
+unsigned ofc_label_table_lower_bound(
+	const ofc_label_table_t* table, unsigned offset);
+
 #endif
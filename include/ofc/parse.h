@@ -19,6 +19,7 @@
 #include <ofc/sparse.h>
 #include <ofc/str_ref.h>
 #include <ofc/fctype.h>
+#include <ofc/arena.h>
 
 #include <stdio.h>
 
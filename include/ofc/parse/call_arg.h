@@ -51,6 +51,8 @@ ofc_parse_call_arg_t* ofc_parse_call_arg(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len);
+ofc_parse_call_arg_t* ofc_parse_call_arg_copy(
+	const ofc_parse_call_arg_t* call_arg);
 void ofc_parse_call_arg_delete(
 	ofc_parse_call_arg_t* call_arg);
 bool ofc_parse_call_arg_print(
@@ -70,6 +72,8 @@ ofc_parse_call_arg_list_t* ofc_parse_call_arg_list(
 	unsigned* len);
 ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_wrap(
 	ofc_parse_call_arg_t* arg);
+ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_copy(
+	const ofc_parse_call_arg_list_t* list);
 void ofc_parse_call_arg_list_delete(
 	ofc_parse_call_arg_list_t* call_arg);
 bool ofc_parse_call_arg_list_print(
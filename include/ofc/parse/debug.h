@@ -16,6 +16,7 @@
 #ifndef __ofc_parse_debug_h__
 #define __ofc_parse_debug_h__
 
+#include <stdbool.h>
 #include <ofc/sparse.h>
 
 typedef struct ofc_parse_debug_s ofc_parse_debug_t;
@@ -26,6 +27,40 @@ void ofc_parse_debug_delete(ofc_parse_debug_t* stack);
 unsigned ofc_parse_debug_position(const ofc_parse_debug_t* stack);
 void ofc_parse_debug_rewind(ofc_parse_debug_t* stack, unsigned position);
 
+/* Counts statement parser attempts and rewinds, for --stats. */
+void ofc_parse_debug_attempt(ofc_parse_debug_t* stack);
+void ofc_parse_debug_counters(
+	const ofc_parse_debug_t* stack,
+	unsigned* attempts, unsigned* rewinds);
+
+typedef enum
+{
+	OFC_PARSE_MEMO_EXPR = 0,
+	OFC_PARSE_MEMO_EXPR_NO_SLASH,
+	OFC_PARSE_MEMO_LHS,
+	OFC_PARSE_MEMO_LHS_VARIABLE,
+	OFC_PARSE_MEMO_LHS_STAR_LEN,
+	OFC_PARSE_MEMO_TYPE,
+	OFC_PARSE_MEMO_CALL_ARG_LIST,
+	OFC_PARSE_MEMO_CALL_ARG_LIST_NAMED,
+	OFC_PARSE_MEMO_CALL_ARG_LIST_FORCE_NAMED,
+
+	OFC_PARSE_MEMO_COUNT
+} ofc_parse_memo_e;
+
+/* Packrat memo of sub-parser results keyed on (rule, ptr), it's only
+   valid within a statement so it's reset at the start of each one.
+   The memo is disabled unless enabled, calls are counted either way. */
+void ofc_parse_debug_memo_enable(ofc_parse_debug_t* stack);
+void ofc_parse_debug_memo_reset(ofc_parse_debug_t* stack);
+void* ofc_parse_debug_memo(
+	ofc_parse_debug_t* stack, ofc_parse_memo_e rule,
+	const ofc_sparse_t* src, const char* ptr, unsigned* len,
+	void* parse, void* copy, void* delete);
+void ofc_parse_debug_memo_counters(
+	const ofc_parse_debug_t* stack,
+	unsigned* calls, unsigned* hits);
+
 void ofc_parse_debug_print(const ofc_parse_debug_t* stack);
 
 #include <stdarg.h>
@@ -22,6 +22,18 @@ typedef struct
 {
 	ofc_sparse_t*          source;
 	ofc_parse_stmt_list_t* stmt;
+	ofc_arena_t*           arena;
+
+	/* Statement parser attempts and rewinds, reported by --stats. */
+	unsigned attempts;
+	unsigned rewinds;
+
+	/* Calls to memoizable sub-parsers and how many the memo answered. */
+	unsigned memo_calls;
+	unsigned memo_hits;
+
+	/* Program units kept by --watch reference the tree they came from. */
+	unsigned refcnt;
 } ofc_parse_file_t;
 
 bool ofc_parse_file_include(
@@ -30,6 +42,7 @@ bool ofc_parse_file_include(
 	ofc_parse_debug_t*     debug);
 
 ofc_parse_file_t* ofc_parse_file(ofc_sparse_t* src);
+bool ofc_parse_file_reference(ofc_parse_file_t* file);
 void ofc_parse_file_delete(ofc_parse_file_t* file);
 
 bool ofc_parse_file_print(
@@ -78,7 +78,7 @@ struct ofc_parse_format_desc_s
 
 struct ofc_parse_format_desc_list_s
 {
-	unsigned                  count;
+	unsigned                  count, size;
 	ofc_parse_format_desc_t** desc;
 };
 
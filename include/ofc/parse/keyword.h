@@ -119,6 +119,12 @@ typedef enum
 } ofc_parse_keyword_e;
 
 
+/* Finds every keyword that condensed source begins with,
+   shortest first, returning the number found. */
+unsigned ofc_parse_keyword_prefix(
+	const char* ptr,
+	ofc_parse_keyword_e* keyword, unsigned max);
+
 bool ofc_sparse_ref_begins_with_keyword(
 	ofc_sparse_ref_t ref, bool* space, bool* is);
 
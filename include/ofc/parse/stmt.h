@@ -359,7 +359,27 @@ bool ofc_parse_stmt_list_print(
 	ofc_colstr_t* cs, unsigned indent,
 	const ofc_parse_stmt_list_t* list);
 
+bool ofc_parse_stmt_list_contains_use(
+	const ofc_parse_stmt_list_t* list);
 bool ofc_parse_stmt_list_contains_error(
 	const ofc_parse_stmt_list_t* list);
 
+/* Calls func with the file of each INCLUDE statement within stmt,
+   in source order. */
+bool ofc_parse_stmt_include_foreach(
+	const ofc_parse_stmt_t* stmt, void* param,
+	bool (*func)(ofc_file_t* file, void* param));
+
+/* Compares the file text two statements span and the text of any
+   files included within them, statements with equal text will have
+   the same parse. */
+bool ofc_parse_stmt_text_equal(
+	const ofc_parse_stmt_t* a,
+	const ofc_parse_stmt_t* b);
+/* True when two statements start at the same row and column of their
+   files, so statements with equal text also report the same positions. */
+bool ofc_parse_stmt_position_equal(
+	const ofc_parse_stmt_t* a,
+	const ofc_parse_stmt_t* b);
+
 #endif
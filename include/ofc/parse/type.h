@@ -54,6 +54,8 @@ ofc_parse_type_t* ofc_parse_type(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len);
+ofc_parse_type_t* ofc_parse_type_copy(
+	const ofc_parse_type_t* type);
 void ofc_parse_type_delete(ofc_parse_type_t* type);
 
 bool ofc_parse_type_print(
@@ -21,6 +21,17 @@
 
 ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file);
 ofc_sparse_t* ofc_prep_condense(ofc_sparse_t* unformat);
+/* Unformats and condenses in a single pass over the file,
+   returning the same sparse as ofc_prep_condense would. */
+ofc_sparse_t* ofc_prep_unformat_condense(ofc_file_t* file);
 ofc_sparse_t* ofc_prep(ofc_file_t* file);
 
+/* Opens and preprocesses an include file, returning false if it can't be
+   opened. Include files are cached for the process, keyed on their
+   resolved path and modification time, and shared between inclusions. */
+bool ofc_prep_include(
+	const char* path, ofc_lang_opts_t opts,
+	const ofc_file_t* parent_file, ofc_sparse_ref_t include_stmt,
+	ofc_file_t** file, ofc_sparse_t** src);
+
 #endif
@@ -27,6 +27,7 @@ typedef struct
 	bool     automatic;
 	bool     init_zero;
 	bool     lowercase_keyword;
+	bool     select_density;
 } ofc_print_opts_t;
 
 static const ofc_print_opts_t
@@ -38,6 +39,7 @@ static const ofc_print_opts_t
 	.automatic         = false,
 	.init_zero         = false,
 	.lowercase_keyword = false,
+	.select_density    = false,
 };
 
 #endif
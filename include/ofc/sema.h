@@ -18,6 +18,7 @@
 
 #include <ofc/parse.h>
 #include <ofc/hashmap.h>
+#include <ofc/symbol.h>
 #include <ofc/global_opts.h>
 
 typedef struct ofc_sema_stmt_s       ofc_sema_stmt_t;
@@ -38,6 +39,9 @@ typedef struct ofc_sema_lhs_list_s          ofc_sema_lhs_list_t;
 typedef struct ofc_sema_module_list_s       ofc_sema_module_list_t;
 typedef struct ofc_sema_format_label_list_s ofc_sema_format_label_list_t;
 
+typedef struct ofc_sema_expr_cursor_s ofc_sema_expr_cursor_t;
+typedef struct ofc_sema_lhs_cursor_s  ofc_sema_lhs_cursor_t;
+
 #include <ofc/sema/kind.h>
 #include <ofc/sema/array.h>
 #include <ofc/sema/structure.h>
@@ -65,5 +69,6 @@ typedef struct ofc_sema_format_label_list_s ofc_sema_format_label_list_t;
 #include <ofc/sema/module.h>
 
 #include <ofc/sema/pass.h>
+#include <ofc/sema/serial.h>
 
 #endif
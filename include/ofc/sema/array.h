@@ -56,6 +56,10 @@ bool ofc_sema_array_compare(
 bool ofc_sema_array_total(
 	const ofc_sema_array_t* array,
 	unsigned* total);
+/* Resolves the first index and extent of each dimension. */
+bool ofc_sema_array_bounds(
+	const ofc_sema_array_t* array,
+	int* first, unsigned* count);
 
 bool ofc_sema_array_print(
 	ofc_colstr_t* cs,
@@ -95,10 +99,13 @@ ofc_sema_array_index_t* ofc_sema_array_index_copy(
 void ofc_sema_array_index_delete(
 	ofc_sema_array_index_t* index);
 
+ofc_sema_array_index_t* ofc_sema_array_index_create(
+	unsigned dimensions, const int* idx);
 ofc_sema_array_index_t* ofc_sema_array_index_from_offset(
 	const ofc_sema_decl_t* decl, unsigned offset);
 
 bool ofc_sema_array_index_offset(
+	ofc_sparse_ref_t              src,
 	const ofc_sema_decl_t*        decl,
 	const ofc_sema_array_index_t* index,
 	unsigned* offset);
@@ -135,6 +142,12 @@ ofc_sema_array_slice_t* ofc_sema_array_slice_copy(
 void ofc_sema_array_slice_delete(
 	ofc_sema_array_slice_t* slice);
 
+/* As ofc_sema_array_bounds, but dimensions which the slice
+   only indexes have an extent of zero. */
+bool ofc_sema_array_slice_bounds(
+	const ofc_sema_array_slice_t* slice,
+	int* first, unsigned* count);
+
 bool ofc_sema_array_slice_compare(
 	const ofc_sema_array_slice_t* a,
 	const ofc_sema_array_slice_t* b);
@@ -20,7 +20,7 @@ typedef struct
 {
 	ofc_str_ref_t           name;
 
-	unsigned                count;
+	unsigned                count, size;
 	const ofc_sema_decl_t** decl;
 
 	bool save;
@@ -30,7 +30,7 @@ typedef struct
 {
 	ofc_hashmap_t* map;
 
-	unsigned            count;
+	unsigned            count, size;
 	ofc_sema_common_t** common;
 } ofc_sema_common_map_t;
 
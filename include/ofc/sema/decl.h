@@ -35,9 +35,48 @@ typedef struct
 	};
 } ofc_sema_decl_init_t;
 
+/* A run of consecutive elements sharing one constant initializer. */
+typedef struct
+{
+	unsigned         first;
+	unsigned         count;
+	ofc_sema_expr_t* expr;
+} ofc_sema_decl_init_run_t;
+
+typedef struct
+{
+	unsigned offset;
+	char*    string;
+	bool*    mask;
+} ofc_sema_decl_init_substring_t;
+
+/* Composite initializers are stored as sorted, non-overlapping runs
+   with partial (substring) element initializers kept separately.
+   Runs from run_sorted on were set out of order, they're sorted into
+   place by ofc_sema_decl_init_finalize or before they're read. */
+typedef struct
+{
+	unsigned                  run_count;
+	unsigned                  run_size;
+	unsigned                  run_sorted;
+	ofc_sema_decl_init_run_t* run;
+
+	/* Whether adjacent runs may be joined when sorting. */
+	bool merge;
+
+	/* Bitmap of elements held by the unsorted runs. */
+	unsigned       set_size;
+	unsigned char* set;
+
+	unsigned                        substring_count;
+	unsigned                        substring_size;
+	ofc_sema_decl_init_substring_t* substring;
+} ofc_sema_decl_init_array_t;
+
 struct ofc_sema_decl_s
 {
 	ofc_sparse_ref_t name;
+	ofc_symbol_t     symbol;
 
 	bool type_final;
 	bool type_implicit;
@@ -55,7 +94,7 @@ struct ofc_sema_decl_s
 	__attribute__((__packed__))
 	{
 		ofc_sema_decl_init_t  init;
-		ofc_sema_decl_init_t* init_array;
+		ofc_sema_decl_init_array_t* init_array;
 	};
 
 	bool is_static;
@@ -75,16 +114,25 @@ struct ofc_sema_decl_s
 	bool was_written;
 	bool is_stmt_func_arg;
 
+	/* The arena our members were allocated from, we hold a reference
+	   so that a referenced decl can outlive its scope. */
+	ofc_arena_t* arena;
+
 	unsigned refcnt;
 };
 
 struct ofc_sema_decl_list_s
 {
+	/* The table the symbols of its decls were interned in. */
+	const ofc_symbol_table_t* symbols;
+
 	bool case_sensitive;
 	bool is_ref;
 
-	unsigned size;
+	/* Count is the number of slots used, including those emptied
+	   by a removal, size is how many there's room for. */
 	unsigned count;
+	unsigned size;
 
 	union
 	__attribute__((__packed__))
@@ -93,6 +141,10 @@ struct ofc_sema_decl_list_s
 		const ofc_sema_decl_t** decl_ref;
 	};
 
+	/* Slots emptied by a removal, kept as a min-heap. */
+	unsigned  hole_count, hole_size;
+	unsigned* hole;
+
 	ofc_hashmap_t* map;
 };
 
@@ -104,7 +156,7 @@ struct ofc_sema_decl_alias_s
 
 struct ofc_sema_decl_alias_map_s
 {
-	unsigned count;
+	unsigned count, size;
 
 	ofc_sema_decl_alias_t** list;
 	ofc_hashmap_t*          map;
@@ -124,7 +176,10 @@ bool ofc_sema_decl_alias_map_add(
 void ofc_sema_decl_alias_map_delete(
 	ofc_sema_decl_alias_map_t* map);
 
+/* The name is interned in symbols, a decl created without
+   a table has no symbol so can't be found in a decl list. */
 ofc_sema_decl_t* ofc_sema_decl_create(
+	ofc_symbol_table_t* symbols,
 	const ofc_sema_implicit_t* implicit,
 	ofc_sparse_ref_t name);
 ofc_sema_decl_t* ofc_sema_decl_copy(
@@ -197,6 +252,9 @@ bool ofc_sema_decl_init_func(
 	ofc_sema_decl_t* decl,
 	ofc_sema_scope_t* func);
 
+bool ofc_sema_decl_init_finalize(
+	ofc_sema_decl_t* decl);
+
 bool ofc_sema_decl_size(
 	const ofc_sema_decl_t* decl,
 	unsigned* size);
@@ -252,8 +310,10 @@ bool ofc_sema_decl_foreach_scope(
 	bool (*func)(ofc_sema_scope_t* scope, void* param));
 
 
-ofc_sema_decl_list_t* ofc_sema_decl_list_create(bool case_sensitive);
-ofc_sema_decl_list_t* ofc_sema_decl_list_create_ref(bool case_sensitive);
+ofc_sema_decl_list_t* ofc_sema_decl_list_create(
+	const ofc_symbol_table_t* symbols, bool case_sensitive);
+ofc_sema_decl_list_t* ofc_sema_decl_list_create_ref(
+	const ofc_symbol_table_t* symbols, bool case_sensitive);
 void ofc_sema_decl_list_delete(ofc_sema_decl_list_t* list);
 
 bool ofc_sema_decl_list_add(
@@ -272,6 +332,13 @@ const ofc_sema_decl_t* ofc_sema_decl_list_find(
 ofc_sema_decl_t* ofc_sema_decl_list_find_modify(
 	ofc_sema_decl_list_t* list,
 	ofc_str_ref_t name);
+/* Any spelling of the symbol matches unless the list is case sensitive. */
+const ofc_sema_decl_t* ofc_sema_decl_list_find_symbol(
+	const ofc_sema_decl_list_t* list,
+	ofc_symbol_t symbol);
+ofc_sema_decl_t* ofc_sema_decl_list_find_symbol_modify(
+	ofc_sema_decl_list_t* list,
+	ofc_symbol_t symbol);
 
 const ofc_hashmap_t* ofc_sema_decl_list_map(
 	const ofc_sema_decl_list_t* list);
@@ -40,7 +40,7 @@ typedef struct
 
 typedef struct
 {
-	unsigned               count;
+	unsigned               count, size;
 	ofc_sema_dummy_arg_t** dummy_arg;
 } ofc_sema_dummy_arg_list_t;
 
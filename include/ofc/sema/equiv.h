@@ -18,7 +18,7 @@
 
 typedef struct
 {
-	unsigned         count;
+	unsigned         count, size;
 	ofc_sema_lhs_t** lhs;
 } ofc_sema_equiv_t;
 
@@ -35,7 +35,7 @@ bool ofc_sema_equiv_print(
 
 typedef struct
 {
-	unsigned           count;
+	unsigned           count, size;
 	ofc_sema_equiv_t** equiv;
 } ofc_sema_equiv_list_t;
 
@@ -117,7 +117,7 @@ struct ofc_sema_expr_s
 
 struct ofc_sema_expr_list_s
 {
-	unsigned          count;
+	unsigned          count, size;
 	ofc_sema_expr_t** expr;
 };
 
@@ -170,6 +170,13 @@ ofc_sema_structure_t* ofc_sema_expr_structure(
 bool ofc_sema_expr_elem_count(
 	const ofc_sema_expr_t* expr,
 	unsigned* count);
+/* Returns the value of the iteration variable of an implicit DO loop
+   with a constant init and step at iteration offset. */
+ofc_sema_expr_t* ofc_sema_expr_implicit_do_iter(
+	const ofc_sema_decl_t* iter,
+	const ofc_sema_expr_t* init,
+	const ofc_sema_expr_t* step,
+	unsigned offset);
 ofc_sema_expr_t* ofc_sema_expr_elem_get(
 	const ofc_sema_expr_t* expr, unsigned offset);
 
@@ -190,7 +197,7 @@ ofc_sema_expr_t* ofc_sema_expr_div(
 	const ofc_sema_expr_t* a,
 	const ofc_sema_expr_t* b);
 
-uint8_t ofc_sema_expr_hash(
+uint32_t ofc_sema_expr_hash(
 	const ofc_sema_expr_t* expr);
 
 const ofc_sema_type_t* ofc_sema_expr_type(
@@ -249,6 +256,12 @@ bool ofc_sema_expr_list_elem_count(
 	const ofc_sema_expr_list_t* list, unsigned* count);
 ofc_sema_expr_t* ofc_sema_expr_list_elem_get(
 	const ofc_sema_expr_list_t* list, unsigned offset);
+ofc_sema_expr_cursor_t* ofc_sema_expr_cursor_create(
+	const ofc_sema_expr_list_t* list);
+void ofc_sema_expr_cursor_delete(
+	ofc_sema_expr_cursor_t* cursor);
+const ofc_sema_expr_t* ofc_sema_expr_cursor_next(
+	ofc_sema_expr_cursor_t* cursor);
 bool ofc_sema_expr_list_compare(
 	const ofc_sema_expr_list_t* a,
 	const ofc_sema_expr_list_t* b);
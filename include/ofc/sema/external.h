@@ -25,7 +25,7 @@ typedef struct
 typedef struct
 {
 	bool case_sensitive;
-	unsigned count;
+	unsigned count, size;
 	ofc_sema_external_t** external;
 	ofc_hashmap_t* map;
 } ofc_sema_external_list_t;
@@ -45,6 +45,16 @@ bool ofc_sema_implicit_external(
 	const ofc_sema_implicit_t* implicit,
 	ofc_sparse_ref_t name);
 
+/* Looks up the rule for a letter, rather than the first letter of a name. */
+bool ofc_sema_implicit_rule(
+	const ofc_sema_implicit_t* implicit,
+	char letter,
+	const ofc_sema_type_t** type,
+	bool* is_static,
+	bool* is_automatic,
+	bool* is_volatile,
+	bool* is_intrinsic,
+	bool* is_external);
 bool ofc_sema_implicit_attr(
 	const ofc_sema_implicit_t* implicit,
 	ofc_sparse_ref_t name,
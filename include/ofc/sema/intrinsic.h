@@ -18,6 +18,10 @@
 
 typedef struct ofc_sema_intrinsic_s ofc_sema_intrinsic_t;
 
+/* Builds the intrinsic tables, this happens on first use
+   but should be done up front before starting any threads. */
+bool ofc_sema_intrinsic_init(void);
+
 bool ofc_sema_intrinsic_name_reserved(const char* name);
 
 const ofc_sema_intrinsic_t* ofc_sema_intrinsic(
@@ -42,6 +46,9 @@ const ofc_sema_intrinsic_t* ofc_sema_intrinsic_cast_func(
 bool ofc_sema_intrinsic_is_specific(
 	const ofc_sema_intrinsic_t* func);
 
+ofc_str_ref_t ofc_sema_intrinsic_name(
+	const ofc_sema_intrinsic_t* intrinsic);
+
 bool ofc_sema_intrinsic_print(
 	ofc_colstr_t* cs,
 	const ofc_sema_intrinsic_t* intrinsic);
@@ -45,6 +45,17 @@ typedef enum
 	OFC_SEMA_CALL_ARG_COUNT
 } ofc_sema_call_arg_e;
 
+/* Resolves the parameters of an I/O statement against a table of
+   specifier names, which must be sorted, storing each in arg at the
+   index of its name. Un-named parameters take the slots listed in
+   positional, in order, any further ones are an error. */
+bool ofc_sema_io_spec_resolve(
+	const ofc_parse_call_arg_list_t* params,
+	const char* stmt_name,
+	const char* const* spec, unsigned count,
+	const unsigned* positional, unsigned positional_count,
+	ofc_parse_call_arg_t** arg);
+
 bool ofc_sema_io_compare_types(
 	const ofc_sema_stmt_t* stmt,
 	const ofc_sema_lhs_t* lhs,
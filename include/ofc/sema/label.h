@@ -45,8 +45,10 @@ ofc_sparse_ref_t ofc_sema_label_src(
 
 typedef struct
 {
-	unsigned size;
-	unsigned count;
+	/* Count is the number of slots used, including the hole_count
+	   emptied by a removal, size is how many there's room for. */
+	unsigned count, size;
+	unsigned hole_count;
 
 	ofc_sema_label_t** label;
 
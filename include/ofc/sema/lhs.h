@@ -78,7 +78,7 @@ struct ofc_sema_lhs_s
 
 struct ofc_sema_lhs_list_s
 {
-	unsigned         count;
+	unsigned         count, size;
 	ofc_sema_lhs_t** lhs;
 };
 
@@ -190,6 +190,13 @@ bool ofc_sema_lhs_list_elem_count(
 ofc_sema_lhs_t* ofc_sema_lhs_list_elem_get(
 	const ofc_sema_lhs_list_t* list, unsigned offset);
 
+ofc_sema_lhs_cursor_t* ofc_sema_lhs_cursor_create(
+	const ofc_sema_lhs_list_t* list);
+void ofc_sema_lhs_cursor_delete(
+	ofc_sema_lhs_cursor_t* cursor);
+ofc_sema_lhs_t* ofc_sema_lhs_cursor_next(
+	ofc_sema_lhs_cursor_t* cursor);
+
 bool ofc_sema_lhs_list_init(
 	ofc_sema_lhs_list_t* lhs,
 	const ofc_sema_expr_list_t* init);
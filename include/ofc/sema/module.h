@@ -26,7 +26,7 @@ struct ofc_sema_module_s
 
 struct ofc_sema_module_list_s
 {
-	unsigned 			count;
+	unsigned 			count, size;
 	ofc_sema_module_t** module;
 };
 
@@ -18,26 +18,61 @@
 
 #include"ofc/sema_pass_opts.h"
 
-bool ofc_sema_pass_struct_type(
-	ofc_sema_scope_t* scope);
-bool ofc_sema_pass_unref_label(
-	ofc_sema_scope_t* scope);
-bool ofc_sema_pass_unlabelled_format(
-	ofc_sema_scope_t* scope);
-bool ofc_sema_pass_unlabelled_continue(
-	ofc_sema_scope_t* scope);
-bool ofc_sema_pass_char_transfer(
-	ofc_sema_scope_t* scope);
-bool ofc_sema_pass_unused_common(
-	ofc_sema_scope_t* scope);
-bool ofc_sema_pass_unused_decl(
-	ofc_sema_scope_t* scope);
-bool ofc_sema_pass_integer_logical(
-	ofc_sema_scope_t* scope);
+typedef enum
+{
+	OFC_SEMA_PASS_STRUCT_TYPE = 0,
+	OFC_SEMA_PASS_CHAR_TRANSFER,
+	OFC_SEMA_PASS_UNREF_LABEL,
+	OFC_SEMA_PASS_UNLABELLED_FORMAT,
+	OFC_SEMA_PASS_UNLABELLED_CONTINUE,
+	OFC_SEMA_PASS_UNUSED_COMMON,
+	OFC_SEMA_PASS_UNUSED_DECL,
+	OFC_SEMA_PASS_INTEGER_LOGICAL,
 
+	OFC_SEMA_PASS_COUNT
+} ofc_sema_pass_e;
+
+/* Passes visit each scope, or each statement, declaration or
+   expression of a scope. Statement and declaration visitors may
+   remove the node they're given from the scope's list. */
+bool ofc_sema_pass_struct_type_scope(
+	ofc_sema_scope_t* scope, void* param);
+bool ofc_sema_pass_unref_label_scope(
+	ofc_sema_scope_t* scope, void* param);
+bool ofc_sema_pass_unlabelled_format_stmt(
+	ofc_sema_scope_t* scope, ofc_sema_stmt_t* stmt, void* param);
+bool ofc_sema_pass_unlabelled_continue_stmt(
+	ofc_sema_scope_t* scope, ofc_sema_stmt_t* stmt, void* param);
+bool ofc_sema_pass_char_transfer_expr(
+	ofc_sema_expr_t* expr, void* param);
+bool ofc_sema_pass_unused_common_scope(
+	ofc_sema_scope_t* scope, void* param);
+bool ofc_sema_pass_unused_decl_decl(
+	ofc_sema_scope_t* scope, ofc_sema_decl_t* decl, void* param);
+bool ofc_sema_pass_integer_logical_expr(
+	ofc_sema_expr_t* expr, void* param);
+
+/* Nodes are the scopes, statements, declarations or expressions
+   each pass visited. */
+typedef struct
+{
+	struct
+	{
+		const char* desc;
+		bool        run;
+		unsigned    nodes;
+		double      time;
+	} pass[OFC_SEMA_PASS_COUNT];
+} ofc_sema_pass_stats_t;
+
+/* The enabled passes are fused into a single walk over the scopes,
+   with the statement, declaration and expression passes each sharing
+   a walk over those of a scope where their dependencies allow.
+   The stats may be NULL. */
 bool ofc_sema_run_passes(
 	ofc_file_t* file,
 	ofc_sema_pass_opts_t* sema_pass_opts,
-	ofc_sema_scope_t* scope);
+	ofc_sema_scope_t* scope,
+	ofc_sema_pass_stats_t* stats);
 
 #endif
@@ -29,10 +29,18 @@ typedef struct
 {
 	ofc_sparse_ref_t src;
 
-	unsigned           count;
+	unsigned           count, size;
 	ofc_sema_range_t** range;
 } ofc_sema_range_list_t;
 
+/* A constant integer range, open ends are INT64_MIN and INT64_MAX,
+   index is free for the caller to record where it came from. */
+typedef struct
+{
+	int64_t  first, last;
+	unsigned index;
+} ofc_sema_range_interval_t;
+
 ofc_sema_range_t* ofc_sema_range(
 	ofc_sema_scope_t* scope,
 	ofc_parse_array_range_t* range);
@@ -46,6 +54,9 @@ bool ofc_sema_range_list_add(
 
 bool ofc_sema_range_is_constant(
 	ofc_sema_range_t* range);
+bool ofc_sema_range_interval(
+	const ofc_sema_range_t* range,
+	int64_t* first, int64_t* last);
 bool ofc_sema_range_intersects(
 	ofc_sema_range_t* a,
 	ofc_sema_range_t* b);
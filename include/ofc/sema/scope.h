@@ -34,15 +34,22 @@ typedef enum
 
 typedef struct
 {
-	unsigned           count;
+	unsigned           count, size;
 	ofc_sema_scope_t** scope;
 } ofc_sema_scope_list_t;
 
 
 struct ofc_sema_scope_s
 {
+	/* Set for a global scope, and for a program unit which --watch
+	   moved from the analysis of the parse tree it came from. */
 	ofc_parse_file_t* file;
 	ofc_sparse_ref_t src;
+	ofc_arena_t*     arena;
+
+	/* Owned by a global scope and shared by the scopes within it,
+	   and with the next analysis of the file by --watch. */
+	ofc_symbol_table_t* symbols;
 
 	ofc_sema_scope_t*      parent;
 	ofc_sema_scope_list_t* child;
@@ -83,9 +90,49 @@ bool ofc_sema_scope__check_namespace_collision(
 	const char* name_space, ofc_sparse_ref_t ref);
 
 ofc_sema_scope_t* ofc_sema_scope_super(void);
+/* A detached global scope keeps super as its parent but isn't
+   listed as a child until attached, which also takes ownership
+   of the parse tree. This allows files to be analysed on worker
+   threads and then attached in order. */
+ofc_sema_scope_t* ofc_sema_scope_global_detached(
+	ofc_sema_scope_t* super,
+	ofc_parse_file_t* file);
+bool ofc_sema_scope_global_attach(
+	ofc_sema_scope_t* super,
+	ofc_sema_scope_t* scope,
+	ofc_parse_file_t* file);
 ofc_sema_scope_t* ofc_sema_scope_global(
 	ofc_sema_scope_t* super,
 	ofc_parse_file_t* list);
+/* Analyses a file again as a detached global scope to replace prev,
+   the global scope of its last analysis by --watch. Program units of
+   a file which could be analysed with --unit-jobs are shared with prev
+   rather than analysed again when their text and position haven't
+   changed, shared is set to how many were. */
+ofc_sema_scope_t* ofc_sema_scope_global_update(
+	ofc_sema_scope_t* super,
+	ofc_parse_file_t* file,
+	ofc_sema_scope_t* prev,
+	unsigned* shared);
+/* Attaches a detached global scope in place of an attached one,
+   keeping its position in super. The old scope is detached but not
+   deleted since other files may still USE its modules, program units
+   it shared with the new scope move to the new one. */
+bool ofc_sema_scope_global_replace(
+	ofc_sema_scope_t* super,
+	ofc_sema_scope_t* old,
+	ofc_sema_scope_t* scope,
+	ofc_parse_file_t* file);
+/* True if anything within scope USEs a module from within other. */
+bool ofc_sema_scope_uses_module_of(
+	const ofc_sema_scope_t* scope,
+	const ofc_sema_scope_t* other);
+/* Lists the program units of a global scope in the order that
+   ofc_sema_scope_foreach_scope visits them, but only when they were
+   analysed with --unit-jobs and so may be walked on separate threads.
+   The list must be freed by the caller. */
+ofc_sema_scope_t** ofc_sema_scope_units(
+	ofc_sema_scope_t* scope, unsigned* count);
 
 ofc_sema_scope_t* ofc_sema_scope_program(
 	ofc_sema_scope_t* scope,
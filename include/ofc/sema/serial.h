@@ -0,0 +1,202 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __ofc_sema_serial_h__
+#define __ofc_sema_serial_h__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* A serialized semantic tree is a single buffer of 32-bit words in host
+   byte order, which can be read in place (e.g. from mmap).
+
+   Header:
+     magic "OFCS", version, size in bytes, root node,
+     type count, type table, extern count, extern table,
+     string count, string table.
+
+   Offsets are in bytes from the start of the buffer, node offsets
+   are never zero so zero marks an absent child or reference.
+   The type table holds the node offset of each type id, the extern table
+   holds declarations and structures referenced from the tree but not
+   owned by it (e.g. from a module in a file which wasn't serialized),
+   and the string table holds an offset and length for each string id,
+   the string data is also NUL terminated.
+
+   Node:
+     tag | (kind << 16), attribute count, child count,
+     source file string id, source offset, source length,
+     attributes as (key, value) pairs, children as node offsets.
+
+   The kind is the type enum of the object (e.g. ofc_sema_stmt_e), the
+   source offset is into the text of the file, the file is NONE when
+   there's no source. Children are in the order of the struct fields
+   for the node's kind, with these exceptions:
+     SCOPE: args, implicit, common, decl, equiv, module, label,
+            external, structure, derived_type, stmt, expr, child.
+     SELECT_CASE: case_expr, then a range list and block per case.
+     COMMON: the members' DECL nodes.
+     IMPLICIT: a RULE per letter, with TYPE and FLAGS.
+     STRUCTURE: implicit, then the STRUCTURE or DECL node per member.
+     DECL: array, init, the scope of a SUBROUTINE or FUNCTION.
+     ARRAY: first and last per dimension.
+     ARRAY_SLICE: first, last and stride per dimension.
+     LIST: its elements, the kind is the tag of the elements,
+           a list may contain zero offsets for empty slots.
+     FORMAT: a node per edit descriptor of a FORMAT statement's list,
+             with any defaults set, the kind is its
+             ofc_parse_format_desc_e, a repeat group has the FORMAT
+             node of each descriptor it repeats.
+
+   FLAGS bits are the struct's bools in field order, for a DECL these
+   start at type_final. A FORMAT descriptor's REPEAT is its count,
+   its STRING the text of a string or hollerith descriptor. */
+
+#define OFC_SEMA_SERIAL_VERSION 3
+#define OFC_SEMA_SERIAL_NONE    0xFFFFFFFFU
+
+typedef enum
+{
+	OFC_SEMA_SERIAL_SCOPE = 0,
+	OFC_SEMA_SERIAL_DECL,
+	OFC_SEMA_SERIAL_TYPE,
+	OFC_SEMA_SERIAL_EXPR,
+	OFC_SEMA_SERIAL_LHS,
+	OFC_SEMA_SERIAL_STMT,
+	OFC_SEMA_SERIAL_LABEL,
+	OFC_SEMA_SERIAL_LIST,
+	OFC_SEMA_SERIAL_ARG,
+	OFC_SEMA_SERIAL_DUMMY_ARG,
+	OFC_SEMA_SERIAL_RANGE,
+	OFC_SEMA_SERIAL_ARRAY,
+	OFC_SEMA_SERIAL_ARRAY_INDEX,
+	OFC_SEMA_SERIAL_ARRAY_SLICE,
+	OFC_SEMA_SERIAL_INIT,
+	OFC_SEMA_SERIAL_COMMON,
+	OFC_SEMA_SERIAL_EQUIV,
+	OFC_SEMA_SERIAL_STRUCTURE,
+	OFC_SEMA_SERIAL_IMPLICIT,
+	OFC_SEMA_SERIAL_RULE,
+	OFC_SEMA_SERIAL_MODULE,
+	OFC_SEMA_SERIAL_ALIAS,
+	OFC_SEMA_SERIAL_EXTERNAL,
+	OFC_SEMA_SERIAL_FORMAT,
+
+	OFC_SEMA_SERIAL_COUNT
+} ofc_sema_serial_e;
+
+typedef enum
+{
+	OFC_SEMA_SERIAL_INIT_SCALAR = 0,
+	OFC_SEMA_SERIAL_INIT_SUBSTRING,
+	OFC_SEMA_SERIAL_INIT_ARRAY,
+	OFC_SEMA_SERIAL_INIT_RUN,
+} ofc_sema_serial_init_e;
+
+typedef enum
+{
+	/* String ids. */
+	OFC_SEMA_SERIAL_ATTR_NAME = 0,
+	OFC_SEMA_SERIAL_ATTR_STRING,
+	OFC_SEMA_SERIAL_ATTR_IMAGINARY,
+	OFC_SEMA_SERIAL_ATTR_MASK,
+	OFC_SEMA_SERIAL_ATTR_INTRINSIC,
+
+	/* Type id. */
+	OFC_SEMA_SERIAL_ATTR_TYPE,
+
+	/* Node offsets. */
+	OFC_SEMA_SERIAL_ATTR_DECL,
+	OFC_SEMA_SERIAL_ATTR_SCOPE,
+	OFC_SEMA_SERIAL_ATTR_STMT,
+	OFC_SEMA_SERIAL_ATTR_STRUCTURE,
+
+	/* Values, integers are split into low and high words and
+	   reals are written as hexadecimal floating point strings. */
+	OFC_SEMA_SERIAL_ATTR_FLAGS,
+	OFC_SEMA_SERIAL_ATTR_ACCESS,
+	OFC_SEMA_SERIAL_ATTR_KIND,
+	OFC_SEMA_SERIAL_ATTR_LEN,
+	OFC_SEMA_SERIAL_ATTR_NUMBER,
+	OFC_SEMA_SERIAL_ATTR_LABEL,
+	OFC_SEMA_SERIAL_ATTR_REPEAT,
+	OFC_SEMA_SERIAL_ATTR_ITERATIONS,
+	OFC_SEMA_SERIAL_ATTR_VALUE,
+	OFC_SEMA_SERIAL_ATTR_VALUE_HIGH,
+	OFC_SEMA_SERIAL_ATTR_WIDTH,
+	OFC_SEMA_SERIAL_ATTR_DIGITS,
+	OFC_SEMA_SERIAL_ATTR_EXPONENT,
+
+	OFC_SEMA_SERIAL_ATTR_COUNT
+} ofc_sema_serial_attr_e;
+
+
+/* Returns a malloc'd buffer, NULL on failure. */
+void* ofc_sema_serial_write(
+	const ofc_sema_scope_t* scope, size_t* size);
+bool ofc_sema_serial_write_file(
+	const ofc_sema_scope_t* scope, const char* path);
+
+
+typedef struct ofc_sema_serial_s ofc_sema_serial_t;
+
+typedef struct
+{
+	ofc_sema_serial_e tag;
+	unsigned          kind;
+
+	uint32_t file;
+	uint32_t offset;
+	uint32_t length;
+
+	unsigned        attr_count;
+	const uint32_t* attr;
+
+	unsigned        child_count;
+	const uint32_t* child;
+} ofc_sema_serial_node_t;
+
+/* The buffer must stay valid and 4-byte aligned while in use.
+   All accessors are bounds checked, so untrusted data can be read. */
+ofc_sema_serial_t* ofc_sema_serial_create(
+	const void* data, size_t size);
+/* Maps the file read-only. */
+ofc_sema_serial_t* ofc_sema_serial_map(const char* path);
+void ofc_sema_serial_delete(ofc_sema_serial_t* serial);
+
+uint32_t ofc_sema_serial_root(
+	const ofc_sema_serial_t* serial);
+unsigned ofc_sema_serial_type_count(
+	const ofc_sema_serial_t* serial);
+uint32_t ofc_sema_serial_type(
+	const ofc_sema_serial_t* serial, uint32_t id);
+unsigned ofc_sema_serial_extern_count(
+	const ofc_sema_serial_t* serial);
+uint32_t ofc_sema_serial_extern(
+	const ofc_sema_serial_t* serial, unsigned index);
+unsigned ofc_sema_serial_string_count(
+	const ofc_sema_serial_t* serial);
+const char* ofc_sema_serial_string(
+	const ofc_sema_serial_t* serial, uint32_t id, unsigned* len);
+
+bool ofc_sema_serial_node(
+	const ofc_sema_serial_t* serial, uint32_t offset,
+	ofc_sema_serial_node_t* node);
+bool ofc_sema_serial_node_attr(
+	const ofc_sema_serial_node_t* node,
+	ofc_sema_serial_attr_e key, uint32_t* value);
+
+#endif
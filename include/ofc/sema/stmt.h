@@ -114,6 +114,11 @@ struct ofc_sema_stmt_s
 			unsigned                count;
 			ofc_sema_range_list_t** case_value;
 			ofc_sema_stmt_list_t**  case_block;
+
+			/* Constant integer CASE values sorted by first, index
+			   is that of their CASE, empty when any aren't known. */
+			unsigned                   interval_count;
+			ofc_sema_range_interval_t* interval;
 		} select_case;
 
 		struct
@@ -378,6 +383,11 @@ ofc_sema_stmt_t* ofc_sema_stmt_if(
 ofc_sema_stmt_t* ofc_sema_stmt_select_case(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt);
+/* Counts the distinct CASE values and the span they cover,
+   fails when they're unknown or unbounded. */
+bool ofc_sema_stmt_select_case_density(
+	const ofc_sema_stmt_t* stmt,
+	uint64_t* values, uint64_t* span);
 ofc_sema_stmt_t* ofc_sema_stmt_stop_pause(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt);
@@ -406,7 +416,7 @@ bool ofc_sema_stmt_is_stmt_func(
 
 struct ofc_sema_stmt_list_s
 {
-	unsigned          count;
+	unsigned          count, size;
 	ofc_sema_stmt_t** stmt;
 };
 
@@ -26,6 +26,7 @@ typedef enum
 } ofc_sema_structure_e;
 
 typedef struct ofc_sema_structure_s ofc_sema_structure_t;
+typedef struct ofc_sema_structure_table_s ofc_sema_structure_table_t;
 
 typedef struct
 {
@@ -45,11 +46,15 @@ struct ofc_sema_structure_s
 
 	ofc_sema_implicit_t* implicit;
 
-	unsigned count;
+	unsigned count, size;
 	ofc_sema_structure_member_t** member;
 
 	ofc_hashmap_t* map;
 
+	/* Flattened element and member offsets, built once the
+	   structure is finalized so it can be shared read-only. */
+	ofc_sema_structure_table_t* table;
+
 	unsigned refcnt;
 };
 
@@ -100,6 +105,17 @@ bool ofc_sema_structure_elem_count(
 ofc_sema_decl_t* ofc_sema_structure_elem_get(
 	ofc_sema_structure_t* structure,
 	unsigned offset);
+/* Finds the member decl holding the element at offset, through
+   anonymous nested structures, and makes offset relative to it. */
+ofc_sema_decl_t* ofc_sema_structure_elem_member(
+	ofc_sema_structure_t* structure,
+	unsigned* offset);
+/* The element offset at which member starts, every element of an
+   array member is counted and the maps of a union overlap. */
+bool ofc_sema_structure_member_elem_offset(
+	const ofc_sema_structure_t* structure,
+	const ofc_sema_decl_t*      member,
+	unsigned*                   offset);
 bool ofc_sema_structure_elem_print(
 	ofc_colstr_t* cs,
 	const ofc_sema_structure_t* structure,
@@ -120,7 +136,10 @@ bool ofc_sema_structure_foreach_expr(
 
 typedef struct
 {
+	/* Count is the number of slots used, including the hole_count
+	   emptied by a removal, size is how many there's room for. */
 	unsigned count, size;
+	unsigned hole_count;
 	ofc_sema_structure_t** structure;
 	ofc_hashmap_t* map;
 } ofc_sema_structure_list_t;
@@ -37,6 +37,10 @@ typedef struct
 
 ofc_sparse_t* ofc_sparse_create_file(ofc_file_t* file);
 ofc_sparse_t* ofc_sparse_create_child(ofc_sparse_t* parent);
+/* Shares a locked sparse, attributing it to another file which
+   must have the same text, e.g. another inclusion of the same file. */
+ofc_sparse_t* ofc_sparse_create_alias(
+	ofc_sparse_t* source, ofc_file_t* file);
 bool      ofc_sparse_reference(ofc_sparse_t* sparse);
 void      ofc_sparse_delete(ofc_sparse_t* sparse);
 
@@ -130,6 +134,10 @@ void ofc_sparse_warning_ptr(
 	const char* format, ...)
 	__attribute__ ((format (printf, 3, 4)));
 
+/* Renders where a warning at ref would be reported. */
+bool ofc_sparse_ref_loc(
+	ofc_sparse_ref_t ref, ofc_file_loc_t* loc);
+
 void ofc_sparse_ref_error(
 	ofc_sparse_ref_t ref,
 	const char* format, ...)
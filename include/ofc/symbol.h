@@ -0,0 +1,95 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __ofc_symbol_h__
+#define __ofc_symbol_h__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ofc/str_ref.h>
+
+/* Identifiers are interned into a symbol table, each distinct spelling
+   gets one symbol which stays valid for the life of the table. Spellings
+   which only differ in case are folded onto the first one seen, so a case
+   insensitive comparison of two symbols is a comparison of their folded
+   symbols. Symbols carry the hashes of their name so they can be used as
+   map keys without hashing the name again.
+
+   A table belongs to the global scope of a file, so symbols from different
+   files can't be compared directly, use ofc_symbol_import for that. Lookups
+   don't lock and may run alongside an insert on another thread. Tables are
+   reference counted, so that --watch can share one between the analyses
+   of a file. */
+typedef struct ofc_symbol_table_s ofc_symbol_table_t;
+
+typedef struct ofc_symbol_s ofc_symbol_s;
+typedef const ofc_symbol_s* ofc_symbol_t;
+
+struct ofc_symbol_s
+{
+	ofc_str_ref_t name;
+	uint32_t      hash;
+	uint32_t      hash_ci;
+
+	/* The first spelling seen ignoring case, and the next
+	   spelling which folds onto it. */
+	ofc_symbol_t fold;
+	ofc_symbol_t next;
+};
+
+#define OFC_SYMBOL_NONE NULL
+
+ofc_symbol_table_t* ofc_symbol_table_create(void);
+bool ofc_symbol_table_reference(ofc_symbol_table_t* table);
+void ofc_symbol_table_delete(ofc_symbol_table_t* table);
+unsigned ofc_symbol_table_count(const ofc_symbol_table_t* table);
+
+/* Returns OFC_SYMBOL_NONE for a name without a base or on failure. */
+ofc_symbol_t ofc_symbol(
+	ofc_symbol_table_t* table, ofc_str_ref_t name);
+
+/* Finds a name without interning it, ignoring case unless case_sensitive.
+   A name that was never interned can't match any symbol. */
+ofc_symbol_t ofc_symbol_find(
+	const ofc_symbol_table_t* table,
+	ofc_str_ref_t name, bool case_sensitive);
+
+/* Interns the name of a symbol from another table using its hashes. */
+ofc_symbol_t ofc_symbol_import(
+	ofc_symbol_table_t* table, ofc_symbol_t symbol);
+
+static inline ofc_str_ref_t ofc_symbol_name(ofc_symbol_t symbol)
+	{ return (symbol ? symbol->name : OFC_STR_REF_EMPTY); }
+static inline ofc_symbol_t ofc_symbol_fold(ofc_symbol_t symbol)
+	{ return (symbol ? symbol->fold : OFC_SYMBOL_NONE); }
+
+/* These match ofc_str_ref_hash and ofc_str_ref_hash_ci of the name,
+   so a map keyed by symbol lays its items out as one keyed by name. */
+static inline uint32_t ofc_symbol_hash(ofc_symbol_t symbol)
+	{ return (symbol ? symbol->hash : 0); }
+static inline uint32_t ofc_symbol_hash_ci(ofc_symbol_t symbol)
+	{ return (symbol ? symbol->hash_ci : 0); }
+
+static inline uint32_t ofc_symbol_ptr_hash(const ofc_symbol_t* symbol)
+	{ return (symbol ? ofc_symbol_hash(*symbol) : 0); }
+static inline uint32_t ofc_symbol_ptr_hash_ci(const ofc_symbol_t* symbol)
+	{ return (symbol ? ofc_symbol_hash_ci(*symbol) : 0); }
+static inline bool ofc_symbol_ptr_equal(const ofc_symbol_t* a, const ofc_symbol_t* b)
+	{ if (!a || !b) return false; return (*a == *b); }
+static inline bool ofc_symbol_ptr_equal_ci(const ofc_symbol_t* a, const ofc_symbol_t* b)
+	{ if (!a || !b) return false; return (ofc_symbol_fold(*a) == ofc_symbol_fold(*b)); }
+
+#endif
@@ -0,0 +1,38 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_thread_pool_h__
+#define __ofc_thread_pool_h__
+
+#include <stdbool.h>
+
+typedef void (*ofc_thread_pool_job_f)(void* param);
+
+typedef struct ofc_thread_pool_s ofc_thread_pool_t;
+
+/* Jobs are started in the order they're added. */
+ofc_thread_pool_t* ofc_thread_pool_create(unsigned threads);
+void ofc_thread_pool_delete(ofc_thread_pool_t* pool);
+
+bool ofc_thread_pool_add(
+	ofc_thread_pool_t* pool,
+	ofc_thread_pool_job_f func, void* param);
+
+/* Blocks until every job added so far has completed. */
+void ofc_thread_pool_wait(ofc_thread_pool_t* pool);
+
+unsigned ofc_thread_pool_threads(const ofc_thread_pool_t* pool);
+
+#endif
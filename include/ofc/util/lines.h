@@ -0,0 +1,36 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_lines_h__
+#define __ofc_lines_h__
+
+#include <stdbool.h>
+
+/* Index of line start offsets, a line starts after every '\n' or '\r',
+   or when crlf is set "\r\n" only starts one line. */
+typedef struct ofc_lines_s ofc_lines_t;
+
+/* Returns the index cached in *lines, building it on first use.
+   Concurrent callers may race to build it, only one is kept. */
+const ofc_lines_t* ofc_lines_get(
+	ofc_lines_t** lines,
+	const char* strz, unsigned size, bool crlf);
+void ofc_lines_delete(ofc_lines_t* lines);
+
+/* Returns the line containing offset and sets start to its offset. */
+unsigned ofc_lines_find(
+	const ofc_lines_t* lines, unsigned offset, unsigned* start);
+
+#endif
@@ -0,0 +1,30 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ofc_scan_h__
+#define __ofc_scan_h__
+
+/* Each of these returns the length of the leading run of src,
+   looking at no more than len characters. Where SSE2 is available
+   sixteen characters are compared at a time. */
+
+/* Run of horizontal space, as ofc_is_hspace. */
+unsigned ofc_scan_hspace(const char* src, unsigned len);
+/* Run of anything but horizontal space. */
+unsigned ofc_scan_non_hspace(const char* src, unsigned len);
+/* Run up to the next vertical space or null character. */
+unsigned ofc_scan_line(const char* src, unsigned len);
+
+#endif
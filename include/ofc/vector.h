@@ -0,0 +1,60 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __ofc_vector_h__
+#define __ofc_vector_h__
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* Growable arrays are kept as a pointer to their elements along with
+   a count and a size, the size being how many elements there's room
+   for. OFC_VECTOR_DEFINE generates a reserve function for one element
+   type, which makes room for n more elements by doubling the size so
+   that appending is amortized constant time.
+
+   The size only ever understates the room there is, so an array
+   allocated elsewhere may be adopted with a size of zero. */
+
+#define OFC_VECTOR_SIZE_MIN 4
+
+static inline unsigned ofc_vector_size(
+	unsigned size, unsigned need)
+{
+	unsigned nsize = (size < OFC_VECTOR_SIZE_MIN
+		? OFC_VECTOR_SIZE_MIN : (size << 1));
+	while ((nsize < need) && (nsize != 0))
+		nsize <<= 1;
+	return (nsize < need ? need : nsize);
+}
+
+#define OFC_VECTOR_DEFINE(name, type) \
+static inline bool name##_reserve( \
+	type** elem, unsigned count, unsigned* size, unsigned n) \
+{ \
+	if ((count + n) < count) \
+		return false; \
+	if ((count + n) <= *size) \
+		return true; \
+	unsigned nsize = ofc_vector_size(*size, (count + n)); \
+	type* nelem = (type*)realloc(*elem, (sizeof(type) * nsize)); \
+	if (!nelem) return false; \
+	*elem = nelem; \
+	*size = nsize; \
+	return true; \
+}
+
+#endif
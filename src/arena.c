@@ -0,0 +1,307 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+
+#include "ofc/arena.h"
+
+
+#define OFC_ARENA__ALIGN      16
+#define OFC_ARENA__CHUNK_SIZE 65536
+#define OFC_ARENA__BIN_COUNT  32
+
+#define OFC_ARENA__ROUND(x) \
+	(((x) + (OFC_ARENA__ALIGN - 1)) & ~(size_t)(OFC_ARENA__ALIGN - 1))
+
+typedef struct ofc_arena__chunk_s ofc_arena__chunk_t;
+
+struct ofc_arena__chunk_s
+{
+	ofc_arena__chunk_t* next;
+	size_t              size;
+	size_t              used;
+};
+
+/* Every node is preceded by a header, so that it can be freed
+   without knowing where it came from. */
+typedef struct
+{
+	ofc_arena_t* arena;
+	size_t       size;
+} ofc_arena__node_t;
+
+typedef struct ofc_arena__free_s ofc_arena__free_t;
+
+struct ofc_arena__free_s
+{
+	ofc_arena__free_t* next;
+};
+
+struct ofc_arena_s
+{
+	ofc_arena__chunk_t* chunk;
+
+	/* Freed nodes, binned by rounded size. Only the thread which has
+	   the arena as its current one touches the chunks, bins and counts. */
+	ofc_arena__free_t* bin[OFC_ARENA__BIN_COUNT];
+
+	/* Nodes freed on other threads are pushed here without a lock,
+	   and moved to the bins when an allocation finds its bin empty. */
+	ofc_arena__free_t* deferred;
+
+	size_t   reserved;
+	size_t   used;
+	size_t   live;
+	unsigned nodes;
+	unsigned chunks;
+
+	unsigned refcnt;
+};
+
+#define OFC_ARENA__CHUNK_HEADER OFC_ARENA__ROUND(sizeof(ofc_arena__chunk_t))
+#define OFC_ARENA__NODE_HEADER  OFC_ARENA__ROUND(sizeof(ofc_arena__node_t))
+
+
+static __thread ofc_arena_t* ofc_arena__current = NULL;
+
+
+ofc_arena_t* ofc_arena_create(void)
+{
+	ofc_arena_t* arena
+		= (ofc_arena_t*)malloc(
+			sizeof(ofc_arena_t));
+	if (!arena) return NULL;
+
+	arena->chunk = NULL;
+
+	unsigned i;
+	for (i = 0; i < OFC_ARENA__BIN_COUNT; i++)
+		arena->bin[i] = NULL;
+	arena->deferred = NULL;
+
+	arena->reserved = 0;
+	arena->used     = 0;
+	arena->live     = 0;
+	arena->nodes    = 0;
+	arena->chunks   = 0;
+
+	arena->refcnt = 0;
+	return arena;
+}
+
+bool ofc_arena_reference(ofc_arena_t* arena)
+{
+	if (!arena)
+		return false;
+
+	/* Objects holding a reference may be released on another thread. */
+	__atomic_add_fetch(&arena->refcnt, 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+void ofc_arena_delete(ofc_arena_t* arena)
+{
+	if (!arena)
+		return;
+
+	if (__atomic_fetch_sub(&arena->refcnt, 1, __ATOMIC_ACQ_REL) > 0)
+		return;
+
+	if (ofc_arena__current == arena)
+		ofc_arena__current = NULL;
+
+	ofc_arena__chunk_t* chunk = arena->chunk;
+	while (chunk)
+	{
+		ofc_arena__chunk_t* next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+
+	free(arena);
+}
+
+bool ofc_arena_stats(
+	ofc_arena_t* arena,
+	ofc_arena_stats_t* stats)
+{
+	if (!arena || !stats)
+		return false;
+
+	stats->reserved = arena->reserved;
+	stats->used     = arena->used;
+	stats->live     = arena->live;
+	stats->nodes    = arena->nodes;
+	stats->chunks   = arena->chunks;
+
+	/* Deferred nodes are only moved to the bins by an allocation. */
+	const ofc_arena__free_t* f
+		= __atomic_load_n(&arena->deferred, __ATOMIC_ACQUIRE);
+	for (; f; f = f->next)
+		stats->live -= ((const ofc_arena__node_t*)f)->size;
+	return true;
+}
+
+
+ofc_arena_t* ofc_arena_current(void)
+{
+	return ofc_arena__current;
+}
+
+ofc_arena_t* ofc_arena_current_set(ofc_arena_t* arena)
+{
+	ofc_arena_t* prev = ofc_arena__current;
+	ofc_arena__current = arena;
+	return prev;
+}
+
+
+static void* ofc_arena__bump(
+	ofc_arena_t* arena, size_t size)
+{
+	ofc_arena__chunk_t* chunk = arena->chunk;
+	if (!chunk || ((chunk->size - chunk->used) < size))
+	{
+		size_t csize = OFC_ARENA__CHUNK_SIZE;
+		if ((size + OFC_ARENA__CHUNK_HEADER) > csize)
+			csize = size + OFC_ARENA__CHUNK_HEADER;
+
+		chunk = (ofc_arena__chunk_t*)malloc(csize);
+		if (!chunk) return NULL;
+
+		chunk->size = csize;
+		chunk->used = OFC_ARENA__CHUNK_HEADER;
+
+		/* Keep the partially used chunk at the head for an oversized node. */
+		if (arena->chunk && (csize > OFC_ARENA__CHUNK_SIZE))
+		{
+			chunk->next = arena->chunk->next;
+			arena->chunk->next = chunk;
+		}
+		else
+		{
+			chunk->next = arena->chunk;
+			arena->chunk = chunk;
+		}
+
+		arena->reserved += csize;
+		arena->chunks++;
+	}
+
+	void* ptr = (void*)((char*)chunk + chunk->used);
+	chunk->used += size;
+	arena->used += size;
+	return ptr;
+}
+
+static void ofc_arena__bin(
+	ofc_arena_t* arena, ofc_arena__node_t* node)
+{
+	arena->live -= node->size;
+
+	/* Oversized nodes are left for the bulk release. */
+	unsigned b = (node->size / OFC_ARENA__ALIGN) - 1;
+	if (b < OFC_ARENA__BIN_COUNT)
+	{
+		ofc_arena__free_t* f = (ofc_arena__free_t*)node;
+		f->next = arena->bin[b];
+		arena->bin[b] = f;
+	}
+}
+
+static void ofc_arena__drain(ofc_arena_t* arena)
+{
+	ofc_arena__free_t* f = __atomic_exchange_n(
+		&arena->deferred, NULL, __ATOMIC_ACQUIRE);
+	while (f)
+	{
+		ofc_arena__free_t* next = f->next;
+		ofc_arena__bin(arena, (ofc_arena__node_t*)f);
+		f = next;
+	}
+}
+
+void* ofc_arena_node_alloc(size_t size)
+{
+	size_t rsize = OFC_ARENA__NODE_HEADER
+		+ OFC_ARENA__ROUND(size);
+
+	ofc_arena_t* arena = ofc_arena__current;
+
+	ofc_arena__node_t* node;
+	if (!arena)
+	{
+		node = (ofc_arena__node_t*)malloc(rsize);
+		if (!node) return NULL;
+	}
+	else
+	{
+		unsigned b = (rsize / OFC_ARENA__ALIGN) - 1;
+		if ((b < OFC_ARENA__BIN_COUNT) && !arena->bin[b]
+			&& __atomic_load_n(&arena->deferred, __ATOMIC_RELAXED))
+			ofc_arena__drain(arena);
+
+		if ((b < OFC_ARENA__BIN_COUNT) && arena->bin[b])
+		{
+			node = (ofc_arena__node_t*)arena->bin[b];
+			arena->bin[b] = arena->bin[b]->next;
+		}
+		else
+		{
+			node = (ofc_arena__node_t*)ofc_arena__bump(arena, rsize);
+		}
+
+		if (node)
+		{
+			arena->live += rsize;
+			arena->nodes++;
+		}
+
+		if (!node) return NULL;
+	}
+
+	node->arena = arena;
+	node->size  = rsize;
+	return (void*)((char*)node + OFC_ARENA__NODE_HEADER);
+}
+
+void ofc_arena_node_free(void* ptr)
+{
+	if (!ptr)
+		return;
+
+	ofc_arena__node_t* node
+		= (ofc_arena__node_t*)((char*)ptr - OFC_ARENA__NODE_HEADER);
+
+	ofc_arena_t* arena = node->arena;
+	if (!arena)
+	{
+		free(node);
+		return;
+	}
+
+	if (arena == ofc_arena__current)
+	{
+		ofc_arena__bin(arena, node);
+		return;
+	}
+
+	/* Another thread may be allocating from the arena. */
+	ofc_arena__free_t* f = (ofc_arena__free_t*)node;
+	f->next = __atomic_load_n(&arena->deferred, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(
+		&arena->deferred, &f->next, f, true,
+		__ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
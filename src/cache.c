@@ -0,0 +1,655 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ofc/cache.h"
+#include "ofc/vector.h"
+
+
+/* Bump when the entry layout changes. */
+#define OFC_CACHE__MAGIC   "OFCC"
+#define OFC_CACHE__VERSION 3
+
+#define OFC_CACHE__USES_MODULES    (1U << 0)
+#define OFC_CACHE__DEFINES_MODULES (1U << 1)
+#define OFC_CACHE__HAS_SUMMARY     (1U << 2)
+
+typedef struct
+{
+	char*    path;
+	uint64_t hash;
+} ofc_cache__include_t;
+
+OFC_VECTOR_DEFINE(ofc_cache__include_vector, ofc_cache__include_t)
+
+typedef struct
+{
+	uint64_t key;
+	/* Keyed on the key of each file before this one. */
+	uint64_t deps;
+
+	/* A file which hit has its entry read, the diagnostics
+	   start at diag in buff. */
+	bool                  hit;
+	char*                 buff;
+	size_t                diag, diag_size;
+	ofc_global_summary_t* summary;
+
+	/* Where the file's diagnostics end in the capture. */
+	off_t diag_end;
+
+	/* What an analysed file's entry is stored with. */
+	bool                  done;
+	uint32_t              flags;
+	ofc_cache__include_t* include;
+	unsigned              include_count;
+	unsigned              include_size;
+	void*                 summary_buff;
+	size_t                summary_size;
+} ofc_cache__file_t;
+
+struct ofc_cache_s
+{
+	char* dir;
+
+	ofc_cache__file_t* file;
+	unsigned           file_count;
+	unsigned           file_done;
+	bool               file_failed;
+
+	FILE* diag;
+	int   stderr_fd;
+};
+
+
+static uint64_t ofc_cache__hash(
+	uint64_t h, const void* data, size_t size)
+{
+	const uint8_t* b = (const uint8_t*)data;
+
+	/* FNV-1a */
+	size_t i;
+	for (i = 0; i < size; i++)
+	{
+		h ^= b[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+#define OFC_CACHE__HASH_INIT 14695981039346656037ULL
+
+static char* ofc_cache__read(
+	const char* path, size_t* size)
+{
+	FILE* fp = fopen(path, "rb");
+	if (!fp) return NULL;
+
+	char* buff = NULL;
+	size_t len = 0;
+	if ((fseek(fp, 0, SEEK_END) == 0)
+		&& (ftell(fp) >= 0))
+	{
+		len = ftell(fp);
+		buff = (char*)malloc(len + 1);
+	}
+
+	if (!buff || (fseek(fp, 0, SEEK_SET) != 0)
+		|| (fread(buff, 1, len, fp) != len))
+	{
+		free(buff);
+		fclose(fp);
+		return NULL;
+	}
+
+	fclose(fp);
+	*size = len;
+	return buff;
+}
+
+static bool ofc_cache__hash_file(
+	const char* path, uint64_t* hash)
+{
+	size_t size;
+	char* buff = ofc_cache__read(path, &size);
+	if (!buff) return false;
+
+	*hash = ofc_cache__hash(
+		OFC_CACHE__HASH_INIT, buff, size);
+	free(buff);
+	return true;
+}
+
+static char* ofc_cache__path(
+	const ofc_cache_t* cache, uint64_t key)
+{
+	char* path = (char*)malloc(strlen(cache->dir) + 18);
+	if (!path) return NULL;
+
+	sprintf(path, "%s/%016llx",
+		cache->dir, (unsigned long long)key);
+	return path;
+}
+
+static bool ofc_cache__is_source(
+	const char* arg, const ofc_file_list_t* file_list)
+{
+	unsigned f;
+	for (f = 0; f < file_list->count; f++)
+	{
+		const char* path = ofc_file_get_path(file_list->file[f]);
+		if (path && (strcmp(arg, path) == 0))
+			return true;
+	}
+	return false;
+}
+
+
+static bool ofc_cache__get(
+	const char* buff, size_t size, size_t* pos,
+	void* data, size_t len)
+{
+	if ((size - *pos) < len)
+		return false;
+
+	memcpy(data, &buff[*pos], len);
+	*pos += len;
+	return true;
+}
+
+/* Reads an entry, checking that the include files it read are
+   unchanged and that the files it depends on are the same. */
+static bool ofc_cache__load(
+	const ofc_cache_t* cache, ofc_cache__file_t* file)
+{
+	char* path = ofc_cache__path(cache, file->key);
+	if (!path) return false;
+
+	size_t size;
+	char* buff = ofc_cache__read(path, &size);
+	free(path);
+	if (!buff) return false;
+
+	size_t pos = 0;
+	char magic[4];
+	uint32_t version;
+	uint32_t flags;
+	uint64_t deps;
+	uint32_t include_count;
+	bool valid = ofc_cache__get(buff, size, &pos, magic, 4)
+		&& (memcmp(magic, OFC_CACHE__MAGIC, 4) == 0)
+		&& ofc_cache__get(buff, size, &pos, &version, sizeof(version))
+		&& (version == OFC_CACHE__VERSION)
+		&& ofc_cache__get(buff, size, &pos, &flags, sizeof(flags))
+		&& ofc_cache__get(buff, size, &pos, &deps, sizeof(deps))
+		&& (((flags & OFC_CACHE__USES_MODULES) == 0)
+			|| (deps == file->deps))
+		&& ofc_cache__get(buff, size, &pos, &include_count, sizeof(include_count));
+
+	uint32_t i;
+	for (i = 0; valid && (i < include_count); i++)
+	{
+		uint32_t len;
+		uint64_t hash, current;
+		valid = ofc_cache__get(buff, size, &pos, &len, sizeof(len))
+			&& ((size - pos) > len) && (buff[pos + len] == '\0');
+		if (!valid) break;
+
+		const char* ipath = &buff[pos];
+		pos += (len + 1);
+
+		valid = ofc_cache__get(buff, size, &pos, &hash, sizeof(hash))
+			&& ofc_cache__hash_file(ipath, &current)
+			&& (current == hash);
+	}
+
+	uint64_t diag_size;
+	valid = valid
+		&& ofc_cache__get(buff, size, &pos, &diag_size, sizeof(diag_size))
+		&& ((size - pos) >= diag_size);
+	size_t diag = pos;
+	if (valid) pos += diag_size;
+
+	uint64_t summary_size;
+	valid = valid
+		&& ofc_cache__get(buff, size, &pos, &summary_size, sizeof(summary_size))
+		&& ((size - pos) == summary_size);
+
+	ofc_global_summary_t* summary = NULL;
+	if (valid && (flags & OFC_CACHE__HAS_SUMMARY))
+	{
+		summary = ofc_global_summary_read(
+			&buff[pos], summary_size);
+		valid = (summary != NULL);
+	}
+
+	if (!valid)
+	{
+		free(buff);
+		return false;
+	}
+
+	file->hit       = true;
+	file->flags     = flags;
+	file->buff      = buff;
+	file->diag      = diag;
+	file->diag_size = diag_size;
+	file->summary   = summary;
+	return true;
+}
+
+static void ofc_cache__miss(ofc_cache__file_t* file)
+{
+	ofc_global_summary_delete(file->summary);
+	free(file->buff);
+
+	file->hit     = false;
+	file->buff    = NULL;
+	file->summary = NULL;
+}
+
+
+ofc_cache_t* ofc_cache_create(
+	const char* dir, int argc, const char* argv[],
+	const ofc_file_list_t* file_list)
+{
+	if (!dir || !file_list)
+		return NULL;
+
+	/* Any rebuild of ofc changes its output, so the binary
+	   identifies the version. */
+	struct stat exe;
+	if (stat("/proc/self/exe", &exe) != 0)
+		return NULL;
+
+	char cwd[4096];
+	if (!getcwd(cwd, sizeof(cwd)))
+		return NULL;
+
+	uint64_t opts = OFC_CACHE__HASH_INIT;
+	opts = ofc_cache__hash(opts, OFC_CACHE__MAGIC, 4);
+	opts = ofc_cache__hash(opts, &exe.st_dev, sizeof(exe.st_dev));
+	opts = ofc_cache__hash(opts, &exe.st_ino, sizeof(exe.st_ino));
+	opts = ofc_cache__hash(opts, &exe.st_size, sizeof(exe.st_size));
+	opts = ofc_cache__hash(opts, &exe.st_mtim, sizeof(exe.st_mtim));
+	opts = ofc_cache__hash(opts, cwd, (strlen(cwd) + 1));
+
+	/* The command line holds all of the options, the source paths
+	   are left out so that a file's key doesn't depend on which
+	   other files it's analysed with. */
+	int i;
+	for (i = 1; i < argc; i++)
+	{
+		if (!ofc_cache__is_source(argv[i], file_list))
+			opts = ofc_cache__hash(opts, argv[i], (strlen(argv[i]) + 1));
+	}
+
+	if ((mkdir(dir, 0777) != 0)
+		&& (errno != EEXIST))
+		return NULL;
+
+	ofc_cache_t* cache
+		= (ofc_cache_t*)malloc(
+			sizeof(ofc_cache_t));
+	if (!cache) return NULL;
+
+	cache->dir  = strdup(dir);
+	cache->file = (ofc_cache__file_t*)calloc(
+		file_list->count, sizeof(ofc_cache__file_t));
+	if (!cache->dir || !cache->file)
+	{
+		free(cache->file);
+		free(cache->dir);
+		free(cache);
+		return NULL;
+	}
+
+	cache->file_count  = file_list->count;
+	cache->file_done   = 0;
+	cache->file_failed = false;
+
+	cache->diag      = NULL;
+	cache->stderr_fd = -1;
+
+	uint64_t deps = ofc_cache__hash(
+		OFC_CACHE__HASH_INIT, "deps", 4);
+
+	unsigned f;
+	for (f = 0; f < file_list->count; f++)
+	{
+		const ofc_file_t* file = file_list->file[f];
+		const char* path = ofc_file_get_path(file);
+		unsigned size = ofc_file_get_size(file);
+
+		uint64_t key = opts;
+		if (path) key = ofc_cache__hash(key, path, (strlen(path) + 1));
+		key = ofc_cache__hash(key, &size, sizeof(size));
+		key = ofc_cache__hash(key,
+			ofc_file_get_strz(file), size);
+
+		cache->file[f].key  = key;
+		cache->file[f].deps = deps;
+		deps = ofc_cache__hash(deps, &key, sizeof(key));
+
+		ofc_cache__load(cache, &cache->file[f]);
+	}
+
+	/* A file that's analysed sees the modules of those before it. */
+	bool later_miss = false;
+	for (f = cache->file_count; f-- > 0;)
+	{
+		ofc_cache__file_t* file = &cache->file[f];
+		if (file->hit && later_miss
+			&& (file->flags & OFC_CACHE__DEFINES_MODULES))
+			ofc_cache__miss(file);
+
+		if (!file->hit)
+			later_miss = true;
+	}
+
+	return cache;
+}
+
+static void ofc_cache__restore(ofc_cache_t* cache)
+{
+	if (cache->stderr_fd < 0)
+		return;
+
+	fflush(stderr);
+	dup2(cache->stderr_fd, STDERR_FILENO);
+	close(cache->stderr_fd);
+	cache->stderr_fd = -1;
+}
+
+void ofc_cache_delete(ofc_cache_t* cache)
+{
+	if (!cache)
+		return;
+
+	ofc_cache__restore(cache);
+	if (cache->diag)
+		fclose(cache->diag);
+
+	unsigned f;
+	for (f = 0; f < cache->file_count; f++)
+	{
+		ofc_cache__file_t* file = &cache->file[f];
+		ofc_cache__miss(file);
+
+		unsigned i;
+		for (i = 0; i < file->include_count; i++)
+			free(file->include[i].path);
+		free(file->include);
+		free(file->summary_buff);
+	}
+	free(cache->file);
+
+	free(cache->dir);
+	free(cache);
+}
+
+
+bool ofc_cache_file_hit(
+	const ofc_cache_t* cache, unsigned index)
+{
+	return (cache && (index < cache->file_count)
+		&& cache->file[index].hit);
+}
+
+
+bool ofc_cache_capture(ofc_cache_t* cache)
+{
+	if (!cache || cache->diag)
+		return false;
+
+	cache->diag = tmpfile();
+	if (!cache->diag) return false;
+
+	fflush(stderr);
+	cache->stderr_fd = dup(STDERR_FILENO);
+	if ((cache->stderr_fd < 0)
+		|| (dup2(fileno(cache->diag), STDERR_FILENO) < 0))
+	{
+		if (cache->stderr_fd >= 0)
+			close(cache->stderr_fd);
+		cache->stderr_fd = -1;
+		fclose(cache->diag);
+		cache->diag = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/* Diagnostics are written to the capture through stderr. */
+static ofc_cache__file_t* ofc_cache__file_end(ofc_cache_t* cache)
+{
+	if (cache->file_done >= cache->file_count)
+	{
+		cache->file_failed = true;
+		return NULL;
+	}
+
+	ofc_cache__file_t* file
+		= &cache->file[cache->file_done++];
+
+	fflush(stderr);
+	file->diag_end = lseek(STDERR_FILENO, 0, SEEK_CUR);
+	if (file->diag_end < 0)
+		cache->file_failed = true;
+	return file;
+}
+
+bool ofc_cache_file_replay(
+	ofc_cache_t* cache, ofc_global_summary_t** summary)
+{
+	if (!cache || !cache->diag
+		|| cache->file_failed
+		|| (cache->file_done >= cache->file_count)
+		|| !cache->file[cache->file_done].hit)
+		return false;
+
+	const ofc_cache__file_t* hit
+		= &cache->file[cache->file_done];
+	fwrite(&hit->buff[hit->diag], 1, hit->diag_size, stderr);
+
+	ofc_cache__file_t* file = ofc_cache__file_end(cache);
+	if (!file) return false;
+
+	if (summary) *summary = file->summary;
+	file->summary = NULL;
+	return true;
+}
+
+static bool ofc_cache__include_add(
+	const ofc_file_t* include, ofc_cache__file_t* file)
+{
+	const char* path = ofc_file_get_path(include);
+	if (!path) return false;
+
+	if (!ofc_cache__include_vector_reserve(
+		&file->include, file->include_count,
+		&file->include_size, 1))
+		return false;
+
+	/* The text the run read, so a file changed since then misses. */
+	ofc_cache__include_t* entry
+		= &file->include[file->include_count];
+	entry->hash = ofc_cache__hash(OFC_CACHE__HASH_INIT,
+		ofc_file_get_strz(include), ofc_file_get_size(include));
+	entry->path = strdup(path);
+	if (!entry->path) return false;
+
+	file->include_count++;
+	return true;
+}
+
+void ofc_cache_file_done(
+	ofc_cache_t* cache, const ofc_parse_file_t* program,
+	const ofc_global_summary_t* summary)
+{
+	if (!cache || !cache->diag
+		|| cache->file_failed)
+		return;
+
+	ofc_cache__file_t* file = ofc_cache__file_end(cache);
+	if (!file || cache->file_failed)
+		return;
+
+	const ofc_parse_stmt_list_t* list
+		= (program ? program->stmt : NULL);
+	if (ofc_parse_stmt_list_contains_use(list))
+		file->flags |= OFC_CACHE__USES_MODULES;
+
+	unsigned i;
+	for (i = 0; list && (i < list->count); i++)
+	{
+		if (list->stmt[i]
+			&& (list->stmt[i]->type == OFC_PARSE_STMT_MODULE))
+			file->flags |= OFC_CACHE__DEFINES_MODULES;
+
+		if (!ofc_parse_stmt_include_foreach(list->stmt[i],
+			file, (void*)ofc_cache__include_add))
+			return;
+	}
+
+	/* The summary's locations are rendered now, while the
+	   file they point into is still loaded. */
+	if (summary)
+	{
+		file->summary_buff = ofc_global_summary_write(
+			summary, &file->summary_size);
+		if (!file->summary_buff) return;
+		file->flags |= OFC_CACHE__HAS_SUMMARY;
+	}
+
+	file->done = true;
+}
+
+static bool ofc_cache__put(
+	const char* path, const ofc_cache__file_t* file,
+	const char* diag, uint64_t diag_size)
+{
+	FILE* fp = fopen(path, "wb");
+	if (!fp) return false;
+
+	uint32_t version = OFC_CACHE__VERSION;
+	uint32_t include_count = file->include_count;
+	uint64_t summary_size = file->summary_size;
+	bool success = (fwrite(OFC_CACHE__MAGIC, 1, 4, fp) == 4)
+		&& (fwrite(&version, sizeof(version), 1, fp) == 1)
+		&& (fwrite(&file->flags, sizeof(file->flags), 1, fp) == 1)
+		&& (fwrite(&file->deps, sizeof(file->deps), 1, fp) == 1)
+		&& (fwrite(&include_count, sizeof(include_count), 1, fp) == 1);
+
+	uint32_t i;
+	for (i = 0; success && (i < include_count); i++)
+	{
+		const ofc_cache__include_t* include = &file->include[i];
+		uint32_t len = strlen(include->path);
+		success = (fwrite(&len, sizeof(len), 1, fp) == 1)
+			&& (fwrite(include->path, 1, (len + 1), fp) == (len + 1))
+			&& (fwrite(&include->hash, sizeof(include->hash), 1, fp) == 1);
+	}
+
+	success = success
+		&& (fwrite(&diag_size, sizeof(diag_size), 1, fp) == 1)
+		&& (fwrite(diag, 1, diag_size, fp) == diag_size)
+		&& (fwrite(&summary_size, sizeof(summary_size), 1, fp) == 1)
+		&& (fwrite(file->summary_buff, 1, summary_size, fp) == summary_size);
+
+	return ((fclose(fp) == 0) && success);
+}
+
+/* Written aside and renamed, so that concurrent runs
+   never see a partial entry. */
+static void ofc_cache__store(
+	const ofc_cache_t* cache, const ofc_cache__file_t* file,
+	const char* diag, uint64_t diag_size)
+{
+	char* path = ofc_cache__path(cache, file->key);
+	if (!path) return;
+
+	char tmp[strlen(path) + 32];
+	sprintf(tmp, "%s.%ld.tmp", path, (long)getpid());
+
+	if (!ofc_cache__put(tmp, file, diag, diag_size)
+		|| (rename(tmp, path) != 0))
+		remove(tmp);
+
+	free(path);
+}
+
+void ofc_cache_store(ofc_cache_t* cache, bool success)
+{
+	if (!cache || !cache->diag)
+		return;
+
+	ofc_cache__restore(cache);
+
+	char* diag = NULL;
+	long size = 0;
+	if ((fseek(cache->diag, 0, SEEK_END) == 0)
+		&& ((size = ftell(cache->diag)) >= 0))
+		diag = (char*)malloc(size + 1);
+
+	if (!diag || (fseek(cache->diag, 0, SEEK_SET) != 0)
+		|| (fread(diag, 1, size, cache->diag) != (size_t)size))
+	{
+		free(diag);
+		return;
+	}
+
+	fclose(cache->diag);
+	cache->diag = NULL;
+
+	fwrite(diag, 1, size, stderr);
+	fflush(stderr);
+
+	/* Failed runs aren't stored, since they may be caused by
+	   a missing include file which is later created. The global
+	   passes are run again from the summaries each time, so their
+	   diagnostics aren't stored. */
+	if (success && !cache->file_failed
+		&& (cache->file_done == cache->file_count))
+	{
+		off_t start = 0;
+		unsigned f;
+		for (f = 0; f < cache->file_count; f++)
+		{
+			const ofc_cache__file_t* file = &cache->file[f];
+			if ((file->diag_end < start)
+				|| (file->diag_end > size))
+				break;
+
+			if (file->done)
+			{
+				ofc_cache__store(cache, file,
+					&diag[start], (file->diag_end - start));
+			}
+			start = file->diag_end;
+		}
+	}
+
+	free(diag);
+}
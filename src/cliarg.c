@@ -75,6 +75,62 @@ static bool ofc_cliarg_global_opts__set_flag(
 		case OFC_CLIARG_COMMON_USAGE:
 			global->common_usage_print = true;
 			break;
+		case OFC_CLIARG_STATS:
+			global->stats_print = true;
+			break;
+		case OFC_CLIARG_PARSE_MEMO:
+			global->parse_memo = true;
+			break;
+		case OFC_CLIARG_WATCH:
+			global->watch = true;
+			break;
+
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_cliarg_global_opts__set_num(
+	ofc_global_opts_t* global,
+	int arg_type, unsigned value)
+{
+	if (!global)
+		return false;
+
+	switch (arg_type)
+	{
+		case OFC_CLIARG_JOBS:
+			global->jobs = value;
+			break;
+		case OFC_CLIARG_UNIT_JOBS:
+			global->unit_jobs = value;
+			break;
+
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_cliarg_global_opts__set_str(
+	ofc_global_opts_t* global,
+	int arg_type, char* str)
+{
+	if (!global)
+		return false;
+
+	switch (arg_type)
+	{
+		case OFC_CLIARG_CACHE_DIR:
+			global->cache_dir = str;
+			break;
+
+		case OFC_CLIARG_SEMA_SERIAL:
+			global->sema_serial = str;
+			break;
 
 		default:
 			return false;
@@ -104,6 +160,9 @@ static bool ofc_cliarg_print_opts__set_flag(
 		case OFC_CLIARG_LOWERCASE_KEYWORD:
 			print_opts->lowercase_keyword = true;
 			break;
+		case OFC_CLIARG_PRINT_SELECT_DENSITY:
+			print_opts->select_density = true;
+			break;
 
 		default:
 			return false;
@@ -274,6 +333,7 @@ static const ofc_cliarg_body_t cliargs[] =
 	{ OFC_CLIARG_PRINT_AUTOMATIC,       "print-automatic",       '\0', "Print AUTOMATIC attribute in output",        OFC_CLIARG_PARAM_PRIN_NONE, 0, true  },
 	{ OFC_CLIARG_INIT_LOCAL_ZERO,       "init-local-zero",       '\0', "Initialize undefined variables to zero",     OFC_CLIARG_PARAM_PRIN_NONE, 0, true  },
 	{ OFC_CLIARG_LOWERCASE_KEYWORD,     "lowercase-keyword",     '\0', "Print lower case fortran keywords",          OFC_CLIARG_PARAM_PRIN_NONE, 0, true  },
+	{ OFC_CLIARG_PRINT_SELECT_DENSITY,  "print-select-density",  '\0', "Print CASE value density of SELECT CASE",    OFC_CLIARG_PARAM_PRIN_NONE, 0, true  },
 	{ OFC_CLIARG_INCLUDE,               "include",               'I',  "Add include path (--include <s> or -I<s>)",  OFC_CLIARG_PARAM_FILE_STR,  1, false },
 	{ OFC_CLIARG_SEMA_STRUCT_TYPE,      "no-sema-struct-type",   '\0', "Disable struct to type semantic pass",       OFC_CLIARG_PARAM_SEMA_PASS, 0, true  },
 	{ OFC_CLIARG_SEMA_CHAR_TRANSFER,    "no-sema-char-transfer", '\0', "Disable char to transfer semantic pass",     OFC_CLIARG_PARAM_SEMA_PASS, 0, true  },
@@ -284,6 +344,13 @@ static const ofc_cliarg_body_t cliargs[] =
 	{ OFC_CLIARG_SEMA_UNUSED_DECL,      "sema-unused-decl",      '\0', "Enable unused declarations semantic pass",   OFC_CLIARG_PARAM_SEMA_PASS, 0, true  },
 	{ OFC_CLIARG_NO_ESCAPE,             "no-escape",             '\0', "Treat backslash as an ordinary character",   OFC_CLIARG_PARAM_GLOB_NONE, 0, true  },
 	{ OFC_CLIARG_COMMON_USAGE,          "common-usage",          '\0', "Print COMMON block usage for a file list",   OFC_CLIARG_PARAM_GLOB_NONE, 0, true  },
+	{ OFC_CLIARG_JOBS,                  "jobs",                  '\0', "Process <n> files in parallel",              OFC_CLIARG_PARAM_GLOB_INT,  1, true  },
+	{ OFC_CLIARG_STATS,                 "stats",                 '\0', "Print memory usage per phase to stderr",     OFC_CLIARG_PARAM_GLOB_NONE, 0, true  },
+	{ OFC_CLIARG_PARSE_MEMO,            "parse-memo",            '\0', "Memoize sub-parses within a statement",      OFC_CLIARG_PARAM_GLOB_NONE, 0, true  },
+	{ OFC_CLIARG_WATCH,                 "watch",                 '\0', "Re-analyse files when they change",          OFC_CLIARG_PARAM_GLOB_NONE, 0, true  },
+	{ OFC_CLIARG_CACHE_DIR,             "cache-dir",             '\0', "Reuse results stored in directory <s>",      OFC_CLIARG_PARAM_GLOB_STR,  1, true  },
+	{ OFC_CLIARG_SEMA_SERIAL,           "sema-serial",           '\0', "Write the semantic tree to file <s>",        OFC_CLIARG_PARAM_GLOB_STR,  1, true  },
+	{ OFC_CLIARG_UNIT_JOBS,             "unit-jobs",             '\0', "Analyse <n> program units in parallel",      OFC_CLIARG_PARAM_GLOB_INT,  1, true  },
 };
 
 static const char* ofc_cliarg_file_ext__get(
@@ -375,6 +442,10 @@ static bool ofc_cliarg__apply(
 	{
 		case OFC_CLIARG_PARAM_GLOB_NONE:
 			return ofc_cliarg_global_opts__set_flag(global_opts, arg_type);
+		case OFC_CLIARG_PARAM_GLOB_INT:
+			return ofc_cliarg_global_opts__set_num(global_opts, arg_type, arg->value);
+		case OFC_CLIARG_PARAM_GLOB_STR:
+			return ofc_cliarg_global_opts__set_str(global_opts, arg_type, arg->str);
 		case OFC_CLIARG_PARAM_LANG_NONE:
 			return ofc_cliarg_lang_opts__set_flag(lang_opts, arg_type);
 		case OFC_CLIARG_PARAM_LANG_INT:
@@ -508,6 +579,7 @@ bool ofc_cliarg_parse(
 						resolved_arg = ofc_cliarg_create(arg_body, NULL);
 						break;
 
+					case OFC_CLIARG_PARAM_GLOB_INT:
 					case OFC_CLIARG_PARAM_LANG_INT:
 					case OFC_CLIARG_PARAM_PRIN_INT:
 					{
@@ -522,6 +594,7 @@ bool ofc_cliarg_parse(
 						break;
 					}
 
+					case OFC_CLIARG_PARAM_GLOB_STR:
 					case OFC_CLIARG_PARAM_FILE_STR:
 					{
 						if (ofc_cliarg_param__resolve_str(argv[i]))
@@ -619,7 +692,15 @@ bool ofc_cliarg_parse(
 		}
 	}
 
+	/* Global options are applied along with each file's options, but
+	   --watch decides how files are read so it's needed first. */
 	unsigned j;
+	for (j = 0; j < args_list->count; j++)
+	{
+		if (args_list->arg[j]->body->type == OFC_CLIARG_WATCH)
+			global_opts->watch = true;
+	}
+
 	for (j = 0; j < path_list->count; j++)
 	{
 		char* path = path_list->path[j];
@@ -696,10 +777,12 @@ void ofc_cliarg_print_usage(const char* name)
 
 		switch (cliargs[i].param_type)
 		{
+			case OFC_CLIARG_PARAM_GLOB_INT:
 			case OFC_CLIARG_PARAM_LANG_INT:
 				line_len = printf("  --%s <n>", cliargs[i].name);
 				break;
 
+			case OFC_CLIARG_PARAM_GLOB_STR:
 			case OFC_CLIARG_PARAM_FILE_STR:
 				line_len = printf("  --%s <s>", cliargs[i].name);
 				break;
@@ -736,6 +819,7 @@ ofc_cliarg_t* ofc_cliarg_create(
 	{
 		switch (arg_body->param_type)
 		{
+			case OFC_CLIARG_PARAM_GLOB_INT:
 			case OFC_CLIARG_PARAM_LANG_INT:
 			case OFC_CLIARG_PARAM_PRIN_INT:
 				arg->value = *((int*)param);
@@ -745,6 +829,11 @@ ofc_cliarg_t* ofc_cliarg_create(
 				arg->str = strdup((char*)param);
 				break;
 
+			/* Global options outlive the argument list, so they point into argv. */
+			case OFC_CLIARG_PARAM_GLOB_STR:
+				arg->str = (char*)param;
+				break;
+
 			default:
 				free(arg);
 				return NULL;
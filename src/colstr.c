@@ -17,11 +17,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
 
 #include "ofc/colstr.h"
 #include "ofc/util/dprintf.h"
 
 
+/* A streaming colstr passes on completed lines once this much is buffered. */
+#define OFC_COLSTR__STREAM_SIZE 65536
+
 struct ofc_colstr_s
 {
 	ofc_print_opts_t print_opts;
@@ -31,6 +36,12 @@ struct ofc_colstr_s
 	unsigned col, col_max, col_ext;
 	bool oversize;
 	unsigned oversize_off;
+
+	bool stream;
+	int  fd;
+	bool (*func)(const char* base, unsigned size, void* param);
+	void* param;
+	bool  flushed;
 };
 
 
@@ -59,6 +70,47 @@ ofc_colstr_t* ofc_colstr_create(
 	cstr->col_ext    = ext;
 	cstr->oversize   = false;
 
+	cstr->stream  = false;
+	cstr->fd      = -1;
+	cstr->func    = NULL;
+	cstr->param   = NULL;
+	cstr->flushed = false;
+
+	return cstr;
+}
+
+ofc_colstr_t* ofc_colstr_create_fd(
+	const ofc_print_opts_t print_opts,
+	unsigned cols, unsigned ext, int fd)
+{
+	if (fd < 0)
+		return NULL;
+
+	ofc_colstr_t* cstr = ofc_colstr_create(
+		print_opts, cols, ext);
+	if (!cstr) return NULL;
+
+	cstr->stream = true;
+	cstr->fd     = fd;
+	return cstr;
+}
+
+ofc_colstr_t* ofc_colstr_create_stream(
+	const ofc_print_opts_t print_opts,
+	unsigned cols, unsigned ext,
+	bool (*func)(const char* base, unsigned size, void* param),
+	void* param)
+{
+	if (!func)
+		return NULL;
+
+	ofc_colstr_t* cstr = ofc_colstr_create(
+		print_opts, cols, ext);
+	if (!cstr) return NULL;
+
+	cstr->stream = true;
+	cstr->func   = func;
+	cstr->param  = param;
 	return cstr;
 }
 
@@ -100,11 +152,55 @@ static bool ofc_colstr__enlarge(
 }
 
 
+static bool ofc_colstr__emit(
+	ofc_colstr_t* cstr, const char* base, unsigned size)
+{
+	if (cstr->func)
+		return cstr->func(base, size, cstr->param);
+
+	while (size > 0)
+	{
+		ssize_t len = write(cstr->fd, base, size);
+		if (len < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		base += len;
+		size -= len;
+	}
+
+	return true;
+}
+
+/* Only whole lines are passed on, since a write may be rolled back
+   or an oversized write may still need its continuation marker. */
+static bool ofc_colstr__flush(ofc_colstr_t* cstr)
+{
+	if (!cstr->stream || cstr->oversize
+		|| (cstr->size == 0))
+		return true;
+
+	if (!ofc_colstr__emit(cstr, cstr->base, cstr->size))
+		return false;
+
+	cstr->size    = 0;
+	cstr->flushed = true;
+	return true;
+}
+
+
 bool ofc_colstr_newline(
 	ofc_colstr_t* cstr, unsigned indent,
 	const unsigned* label)
 {
-	bool first = (cstr->size == 0);
+	if ((cstr->size >= OFC_COLSTR__STREAM_SIZE)
+		&& !ofc_colstr__flush(cstr))
+		return false;
+
+	bool first = ((cstr->size == 0) && !cstr->flushed);
 
 	if (!ofc_colstr__enlarge(cstr, (first ? 6 : 7)))
 		return false;
@@ -646,13 +742,26 @@ bool ofc_colstr_keyword_atomic_writef(
 
 bool ofc_colstr_fdprint(ofc_colstr_t* cstr, int fd)
 {
-	if (!cstr || !cstr->base)
+	if (!cstr || !cstr->base || cstr->stream)
 		return false;
 
 	return (dprintf(fd, "%.*s\n",
 		cstr->size, cstr->base) > 0);
 }
 
+bool ofc_colstr_flush(ofc_colstr_t* cstr)
+{
+	if (!cstr || !cstr->stream
+		|| (!cstr->base && !cstr->flushed))
+		return false;
+
+	if (!ofc_colstr__enlarge(cstr, 1))
+		return false;
+	cstr->base[cstr->size++] = '\n';
+	cstr->oversize = false;
+
+	return ofc_colstr__flush(cstr);
+}
 
 
 const ofc_print_opts_t* ofc_colstr_print_opts_get(const ofc_colstr_t* cstr)
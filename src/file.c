@@ -18,14 +18,28 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include "ofc/fctype.h"
 #include "ofc/file.h"
 #include "ofc/global_opts.h"
+#include "ofc/util/lines.h"
 
 
+/* Source text is shared between the files created for each inclusion
+   of the same include file, so it's reference counted separately. */
+typedef struct
+{
+	char*           strz;
+	unsigned        size;
+	size_t          map_size;
+	struct timespec mtime;
+	ofc_lines_t*    lines;
+	unsigned        ref;
+} ofc_file__text_t;
+
 struct ofc_file_s
 {
 	const ofc_file_t*      parent;
@@ -34,14 +48,76 @@ struct ofc_file_s
 
 	char*                    path;
 	ofc_file_include_list_t* include;
-	char*                    strz;
+	ofc_file__text_t*        text;
+	const char*              strz;
 	ofc_lang_opts_t          opts;
 	unsigned                 size;
 	unsigned                 ref;
 };
 
 
-static char* ofc_file__read(const char* path, unsigned* size)
+static void ofc_file__text_delete(ofc_file__text_t* text)
+{
+	if (!text)
+		return;
+
+	if (__atomic_fetch_sub(&text->ref, 1, __ATOMIC_ACQ_REL) > 0)
+		return;
+
+	if (text->map_size > 0)
+		munmap(text->strz, text->map_size);
+	else
+		free(text->strz);
+	ofc_lines_delete(text->lines);
+	free(text);
+}
+
+/* Files smaller than this are read, as a copy costs no more than
+   setting up the mapping. */
+#define OFC_FILE__MAP_MIN 65536
+
+/* Maps a regular file so that it's followed by a NUL sentinel, bytes
+   past the end of file in the last page of a mapping read as zero.
+   When the file fills its last page, an extra zero page is reserved
+   after it by mapping the file over a larger anonymous mapping. */
+static char* ofc_file__map(int fd, size_t size, size_t* map_size)
+{
+	long page = sysconf(_SC_PAGESIZE);
+	if ((size == 0) || (page <= 0))
+		return NULL;
+
+	if ((size % page) != 0)
+	{
+		void* map = mmap(NULL, size,
+			PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map == MAP_FAILED)
+			return NULL;
+
+		*map_size = size;
+		return (char*)map;
+	}
+
+	void* map = mmap(NULL, (size + page),
+		PROT_READ, (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	if (mmap(map, size, PROT_READ,
+		(MAP_PRIVATE | MAP_FIXED), fd, 0) == MAP_FAILED)
+	{
+		munmap(map, (size + page));
+		return NULL;
+	}
+
+	*map_size = (size + page);
+	return (char*)map;
+}
+
+/* A mapping faults if the file is truncated while it's in use, so
+   only files which won't be read again once they're changed are
+   mapped. Other files, and empty or special files, are read into a
+   buffer. */
+static ofc_file__text_t* ofc_file__read(const char* path, bool map)
 {
 	int fd = open(path, O_RDONLY);
 	if (fd < 0 ) return NULL;
@@ -53,10 +129,36 @@ static char* ofc_file__read(const char* path, unsigned* size)
 		return NULL;
 	}
 
+	ofc_file__text_t* text
+		= (ofc_file__text_t*)malloc(
+			sizeof(ofc_file__text_t));
+	if (!text)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	text->size     = fs.st_size;
+	text->mtime    = fs.st_mtim;
+	text->map_size = 0;
+	text->lines    = NULL;
+	text->ref      = 0;
+
+	text->strz = ((map && S_ISREG(fs.st_mode)
+			&& (fs.st_size >= OFC_FILE__MAP_MIN))
+		? ofc_file__map(fd, fs.st_size, &text->map_size)
+		: NULL);
+	if (text->strz)
+	{
+		close(fd);
+		return text;
+	}
+
 	char* buff = (char*)malloc(fs.st_size + 1);
 	if (!buff)
 	{
 		close(fd);
+		free(text);
 		return NULL;
 	}
 
@@ -66,22 +168,26 @@ static char* ofc_file__read(const char* path, unsigned* size)
 	if (rsize != fs.st_size)
 	{
 		free(buff);
+		free(text);
 		return NULL;
 	}
 
 	buff[fs.st_size] = '\0';
 
-	if (size) *size = fs.st_size;
-	return buff;
+	text->strz = buff;
+	return text;
 }
 
-ofc_file_t* ofc_file_create(const char* path, ofc_lang_opts_t opts)
+static ofc_file_t* ofc_file__create(
+	const char* path, ofc_lang_opts_t opts, bool map)
 {
 	ofc_file_t* file = (ofc_file_t*)malloc(sizeof(ofc_file_t));
 	if (!file) return NULL;
 
 	file->path = strdup(path);
-	file->strz = ofc_file__read(path, &file->size);
+	file->text = ofc_file__read(path, map);
+	file->strz = (file->text ? file->text->strz : NULL);
+	file->size = (file->text ? file->text->size : 0);
 	file->opts = opts;
 
 	file->parent = NULL;
@@ -98,6 +204,13 @@ ofc_file_t* ofc_file_create(const char* path, ofc_lang_opts_t opts)
 	return file;
 }
 
+/* Files are re-read when they change in watch mode. */
+ofc_file_t* ofc_file_create(const char* path, ofc_lang_opts_t opts)
+{
+	return ofc_file__create(
+		path, opts, !global_opts.watch);
+}
+
 static char* ofc_file__include_path_search(
 	const char* path, const char* file)
 {
@@ -165,12 +278,17 @@ static char* ofc_file__base_parent_path(
 	return file->path;
 }
 
-ofc_file_t* ofc_file_create_include(
-	const char* path, ofc_lang_opts_t opts,
-	const ofc_file_t* parent_file, ofc_sparse_ref_t include_stmt)
+static bool ofc_file__readable(const char* path)
 {
-	ofc_file_t* file = NULL;
+	struct stat fs;
+	return (path && (access(path, R_OK) == 0)
+		&& (stat(path, &fs) == 0)
+		&& !S_ISDIR(fs.st_mode));
+}
 
+char* ofc_file_include_resolve(
+	const char* path, const ofc_file_t* parent_file)
+{
 	if (parent_file && parent_file->include)
 	{
 		ofc_file_include_list_t* include = parent_file->include;
@@ -179,24 +297,27 @@ ofc_file_t* ofc_file_create_include(
 		{
 			char* rpath = ofc_file__include_path_search(
 				include->path[i], path);
-			file = ofc_file_create(rpath, opts);
-
-			if (file)
-			{
-				file->parent = parent_file;
-				file->include_stmt = include_stmt;
-				file->include = parent_file->include;
-
-				free(rpath);
-				return file;
-			}
+			if (ofc_file__readable(rpath))
+				return rpath;
 			free(rpath);
 		}
 	}
 
 	char* bpath = ofc_file__base_parent_path(parent_file);
-	char* rpath = ofc_file__include_path_relative(bpath, path);
-	file = ofc_file_create(rpath, opts);
+	return ofc_file__include_path_relative(bpath, path);
+}
+
+ofc_file_t* ofc_file_create_include(
+	const char* path, ofc_lang_opts_t opts,
+	const ofc_file_t* parent_file, ofc_sparse_ref_t include_stmt)
+{
+	char* rpath = ofc_file_include_resolve(
+		path, parent_file);
+	if (!rpath) return NULL;
+
+	/* Include files are cached until they change, so they're never
+	   mapped. */
+	ofc_file_t* file = ofc_file__create(rpath, opts, false);
 	free(rpath);
 	if (file && parent_file)
 	{
@@ -208,6 +329,78 @@ ofc_file_t* ofc_file_create_include(
 	return file;
 }
 
+ofc_file_t* ofc_file_create_include_shared(
+	const ofc_file_t* source,
+	const ofc_file_t* parent_file, ofc_sparse_ref_t include_stmt)
+{
+	if (!source || !source->text)
+		return NULL;
+
+	ofc_file_t* file = (ofc_file_t*)malloc(sizeof(ofc_file_t));
+	if (!file) return NULL;
+
+	file->path = strdup(source->path);
+	if (!file->path)
+	{
+		free(file);
+		return NULL;
+	}
+
+	/* Files sharing text may be released on different threads. */
+	__atomic_add_fetch(&source->text->ref, 1, __ATOMIC_RELAXED);
+	file->text = source->text;
+	file->strz = source->strz;
+	file->size = source->size;
+	file->opts = source->opts;
+
+	file->parent       = parent_file;
+	file->include_stmt = include_stmt;
+	file->include      = (parent_file ? parent_file->include : NULL);
+
+	file->ref = 0;
+	return file;
+}
+
+bool ofc_file_changed(const ofc_file_t* file)
+{
+	if (!file || !file->text)
+		return true;
+
+	struct stat fs;
+	if (stat(file->path, &fs) != 0)
+		return true;
+
+	return ((fs.st_size != (off_t)file->text->size)
+		|| (fs.st_mtim.tv_sec  != file->text->mtime.tv_sec)
+		|| (fs.st_mtim.tv_nsec != file->text->mtime.tv_nsec));
+}
+
+ofc_file_t* ofc_file_reload(const ofc_file_t* file)
+{
+	if (!file || file->parent)
+		return NULL;
+
+	ofc_file_t* reload
+		= ofc_file_create(file->path, file->opts);
+	if (!reload) return NULL;
+
+	if (file->include)
+	{
+		unsigned i;
+		for (i = 0; i < file->include->count; i++)
+		{
+			if (!ofc_file_include_list_add_create(
+				reload, file->include->path[i]))
+			{
+				ofc_file_delete(reload);
+				return NULL;
+			}
+		}
+	}
+
+	return reload;
+}
+
 bool ofc_file_reference(ofc_file_t* file)
 {
 	if (!file)
@@ -231,7 +424,7 @@ void ofc_file_delete(ofc_file_t* file)
 		return;
 	}
 
-	free(file->strz);
+	ofc_file__text_delete(file->text);
 	free(file->path);
 
 	/* The root file is responsible for cleaning up */
@@ -253,6 +446,11 @@ const char* ofc_file_get_strz(const ofc_file_t* file)
 	return (file ? file->strz : NULL);
 }
 
+unsigned ofc_file_get_size(const ofc_file_t* file)
+{
+	return (file ? file->size : 0);
+}
+
 const ofc_lang_opts_t* ofc_file_get_lang_opts(const ofc_file_t* file)
 {
 	if (!file) return NULL;
@@ -266,6 +464,15 @@ ofc_lang_opts_t* ofc_file_modify_lang_opts(ofc_file_t* file)
 }
 
 
+/* Support Windows line endings when running on cygwin,
+   "\r\n" only starts one row. */
+static const ofc_lines_t* ofc_file__lines(
+	const ofc_file_t* file)
+{
+	return ofc_lines_get(&file->text->lines,
+		file->strz, file->size, true);
+}
+
 bool ofc_file_get_position(
 	const ofc_file_t* file, const char* ptr,
 	unsigned* row, unsigned* col)
@@ -277,24 +484,19 @@ bool ofc_file_get_position(
 	if (pos >= file->size)
 		return false;
 
-	/* TODO - Use binary tree of line positions to find faster. */
-	unsigned i, r, c;
-	for (i = 0, r = 0, c = 0; i < pos; i++)
+	const ofc_lines_t* lines = ofc_file__lines(file);
+	if (!lines) return false;
+
+	unsigned start;
+	unsigned r = ofc_lines_find(lines, pos, &start);
+	unsigned c = (pos - start);
+
+	/* The '\n' of "\r\n" belongs to the row that follows. */
+	if ((pos > 0) && (file->strz[pos] == '\n')
+		&& (file->strz[pos - 1] == '\r'))
 	{
-		switch (file->strz[i])
-		{
-			case '\r':
-				/* Support Windows line endings when running on cygwin. */
-				if (file->strz[i + 1] == '\n') i++;
-				__attribute__ ((fallthrough));
-			case '\n':
-				r += 1;
-				c = 0;
-				break;
-			default:
-				c++;
-				break;
-		}
+		r += 1;
+		c = 0;
 	}
 
 	if (row) *row = r;
@@ -302,6 +504,33 @@ bool ofc_file_get_position(
 	return true;
 }
 
+/* Returns the start of the line containing ptr,
+   which follows the last vspace character before it. */
+static const char* ofc_file__line_start(
+	const ofc_file_t* file, const char* ptr)
+{
+	if ((ptr > file->strz) && ofc_is_vspace(ptr[-1]))
+		return ptr;
+
+	const ofc_lines_t* lines = ofc_file__lines(file);
+	if (!lines)
+	{
+		const char* s = file->strz;
+		const char* p;
+		for (p = file->strz; p < ptr; p++)
+		{
+			if (ofc_is_vspace(*p))
+				s = &p[1];
+		}
+		return s;
+	}
+
+	unsigned start;
+	ofc_lines_find(lines,
+		((uintptr_t)ptr - (uintptr_t)file->strz), &start);
+	return &file->strz[start];
+}
+
 
 ofc_file_list_t* ofc_file_list_create(void)
 {
@@ -389,6 +618,97 @@ void ofc_file_include_list_delete(
 }
 
 
+/* Diagnostics go to stderr unless the calling thread is capturing them,
+   this lets a file processed on a worker thread be reported in order. */
+static __thread FILE*    ofc_file__diag_capture = NULL;
+static __thread unsigned ofc_file__error_count  = 0;
+static __thread unsigned ofc_file__warning_count = 0;
+
+static FILE* ofc_file__diag_stream(void)
+{
+	return (ofc_file__diag_capture
+		? ofc_file__diag_capture : stderr);
+}
+
+void ofc_file_diag_capture(FILE* stream)
+{
+	ofc_file__diag_capture  = stream;
+	ofc_file__error_count   = 0;
+	ofc_file__warning_count = 0;
+}
+
+void ofc_file_diag_hold(ofc_file_diag_t* diag)
+{
+	if (!diag)
+		return;
+
+	diag->buff     = NULL;
+	diag->size     = 0;
+	diag->errors   = 0;
+	diag->warnings = 0;
+
+	diag->prev          = ofc_file__diag_capture;
+	diag->prev_errors   = ofc_file__error_count;
+	diag->prev_warnings = ofc_file__warning_count;
+
+	/* Without a buffer diagnostics pass straight through. */
+	diag->stream = open_memstream(
+		&diag->buff, &diag->size);
+	if (diag->stream)
+		ofc_file__diag_capture = diag->stream;
+
+	ofc_file__error_count   = 0;
+	ofc_file__warning_count = 0;
+}
+
+void ofc_file_diag_release(ofc_file_diag_t* diag)
+{
+	if (!diag)
+		return;
+
+	if (diag->stream)
+		fclose(diag->stream);
+	diag->stream = NULL;
+
+	diag->errors   = ofc_file__error_count;
+	diag->warnings = ofc_file__warning_count;
+
+	ofc_file__diag_capture  = diag->prev;
+	ofc_file__error_count   = diag->prev_errors;
+	ofc_file__warning_count = diag->prev_warnings;
+}
+
+void ofc_file_diag_replay(ofc_file_diag_t* diag)
+{
+	if (!diag)
+		return;
+
+	if (diag->buff)
+	{
+		fwrite(diag->buff, 1, diag->size,
+			ofc_file__diag_stream());
+		free(diag->buff);
+		diag->buff = NULL;
+		diag->size = 0;
+	}
+
+	ofc_file__error_count   += diag->errors;
+	ofc_file__warning_count += diag->warnings;
+	diag->errors   = 0;
+	diag->warnings = 0;
+}
+
+void ofc_file_diag_discard(ofc_file_diag_t* diag)
+{
+	if (!diag)
+		return;
+
+	free(diag->buff);
+	diag->buff = NULL;
+	diag->size = 0;
+}
+
+
 static bool line_empty(const char* ptr, unsigned len)
 {
 	if (!ptr || (len == 0))
@@ -408,6 +728,7 @@ static bool line_empty(const char* ptr, unsigned len)
 }
 
 static void ofc_file__print_include_loc(
+	FILE* stream,
 	const ofc_file_t* include_file,
 	const ofc_file_t* parent_file)
 {
@@ -415,7 +736,8 @@ static void ofc_file__print_include_loc(
 		return;
 
 	if (parent_file->parent)
-		ofc_file__print_include_loc(parent_file, parent_file->parent);
+		ofc_file__print_include_loc(stream,
+			parent_file, parent_file->parent);
 
 	unsigned incl_row, incl_col;
 	bool incl_pos = ofc_file_get_position(
@@ -424,38 +746,45 @@ static void ofc_file__print_include_loc(
 			include_file->include_stmt.string.base),
 		&incl_row, &incl_col);
 
-	fprintf(stderr, "%s:", parent_file->path);
+	fprintf(stream, "%s:", parent_file->path);
 	if (incl_pos)
-		fprintf(stderr, "%u,%u:", (incl_row + 1), incl_col);
-	fprintf(stderr, "\n  ");
+		fprintf(stream, "%u,%u:", (incl_row + 1), incl_col);
+	fprintf(stream, "\n  ");
 }
 
-static void ofc_file__debug_va(
-	const ofc_file_t* file,
-	const char* sol, const char* ptr,
-	const char* type, const char* format, va_list args)
+/* A diagnostic is its type, then a head giving the location,
+   the indented message, and a tail quoting the source line. */
+static void ofc_file__debug_head(
+	FILE* stream, const ofc_file_t* file,
+	bool positional, unsigned row, unsigned col)
 {
-	unsigned row, col;
-	bool positional = ofc_file_get_position(
-		file, ptr, &row, &col);
-
-	fprintf(stderr, "%s:", type);
+	if (!file)
+		return;
 
-	if (file)
-	{
-		const ofc_file_t* include_file = file;
-		const ofc_file_t* parent_file = file->parent;
+	ofc_file__print_include_loc(
+		stream, file, file->parent);
 
-		ofc_file__print_include_loc(include_file, parent_file);
+	if (file->path)
+		fprintf(stream, "%s:", file->path);
+	if (positional)
+		fprintf(stream, "%u,%u:", (row + 1), col);
 
-		if (file->path)
-			fprintf(stderr, "%s:", file->path);
-		if (positional)
-			fprintf(stderr, "%u,%u:", (row + 1), col);
+	fprintf(stream, "\n");
+}
 
-		fprintf(stderr, "\n");
-	}
+static unsigned ofc_file__debug_indent(
+	const ofc_file_t* file)
+{
+	unsigned indent = 0;
+	if (file) indent += 2;
+	if (!file || !file->parent) indent += 1;
+	return indent;
+}
 
+static void ofc_file__debug_message(
+	FILE* stream, unsigned indent,
+	const char* format, va_list args)
+{
 	va_list nargs;
 	va_copy(nargs, args);
 	int fmt_len = vsnprintf(NULL, 0, format, nargs);
@@ -463,10 +792,6 @@ static void ofc_file__debug_va(
 	vsprintf(fmt_str, format, args);
 	va_end(nargs);
 
-	int indent = 0;
-	if (file) indent += 2;
-	if (!file || !file->parent) indent += 1;
-
 	const char* base = fmt_str;
 	unsigned i, len;
 	for (i = 0, len = 0; i <= strlen(fmt_str); i++)
@@ -474,8 +799,8 @@ static void ofc_file__debug_va(
 		if ((fmt_str[i] == '\n')
 			|| (fmt_str[i] == '\0'))
 		{
-			fprintf(stderr, "%*s", indent, "");
-			fprintf(stderr, "%.*s\n", len, base);
+			fprintf(stream, "%*s", indent, "");
+			fprintf(stream, "%.*s\n", len, base);
 			base = &fmt_str[i + 1];
 			len = 0;
 		}
@@ -484,53 +809,74 @@ static void ofc_file__debug_va(
 			len++;
 		}
 	}
+}
 
-	if (positional)
-	{
-		if (!sol)
-			sol = ptr;
-
-		const char* s = file->strz;
-		const char* p;
-		for (p = file->strz; p < sol; p++)
-		{
-			if (ofc_is_vspace(*p))
-				s = &p[1];
-		}
+static void ofc_file__debug_tail(
+	FILE* stream, const ofc_file_t* file,
+	const char* sol, const char* ptr,
+	bool positional, unsigned col)
+{
+	if (!positional)
+		return;
 
-		unsigned len = ((uintptr_t)ptr - (uintptr_t)s);
-		for (; !ofc_is_vspace(s[len]) && (s[len] != '\0'); len++);
+	if (!sol)
+		sol = ptr;
 
-		/* Print line(s) above if line is empty. */
-		while (line_empty(s, len)
-			&& (s != file->strz))
-		{
-			const char* ns = file->strz;
-			for (p = file->strz; p < s; p++)
-			{
-				if (ofc_is_vspace(*p))
-					ns = &p[1];
-			}
-			len += ((uintptr_t)s - (uintptr_t)ns);
-			s = ns;
-		}
+	const char* s = ofc_file__line_start(file, sol);
 
-		fprintf(stderr, "%.*s\n", len, s);
+	unsigned len = ((uintptr_t)ptr - (uintptr_t)s);
+	for (; !ofc_is_vspace(s[len]) && (s[len] != '\0'); len++);
 
-		unsigned i;
-		for (i = 0; i < col; i++)
-			fprintf(stderr, " ");
-		fprintf(stderr, "^\n");
+	/* Print line(s) above if line is empty. */
+	while (line_empty(s, len)
+		&& (s != file->strz))
+	{
+		const char* ns = ofc_file__line_start(file, &s[-1]);
+		len += ((uintptr_t)s - (uintptr_t)ns);
+		s = ns;
 	}
+
+	fprintf(stream, "%.*s\n", len, s);
+
+	unsigned i;
+	for (i = 0; i < col; i++)
+		fprintf(stream, " ");
+	fprintf(stream, "^\n");
 }
 
-static unsigned ofc_file__error_count = 0;
+static void ofc_file__debug_va(
+	const ofc_file_t* file,
+	const char* sol, const char* ptr,
+	const char* type, const char* format, va_list args)
+{
+	FILE* stream = ofc_file__diag_stream();
+
+	unsigned row, col;
+	bool positional = ofc_file_get_position(
+		file, ptr, &row, &col);
+
+	fprintf(stream, "%s:", type);
+	ofc_file__debug_head(stream, file, positional, row, col);
+	ofc_file__debug_message(stream,
+		ofc_file__debug_indent(file), format, args);
+	ofc_file__debug_tail(stream, file, sol, ptr, positional, col);
+}
 
 bool ofc_file_no_errors(void)
 {
 	return (ofc_file__error_count == 0);
 }
 
+unsigned ofc_file_error_count(void)
+{
+	return ofc_file__error_count;
+}
+
+unsigned ofc_file_warning_count(void)
+{
+	return ofc_file__warning_count;
+}
+
 void ofc_file_error_va(
 	const ofc_file_t* file,
 	const char* sol, const char* ptr,
@@ -550,6 +896,7 @@ void ofc_file_warning_va(
 	{
 		ofc_file__debug_va(
 			file, sol, ptr, "Warning", format, args);
+		ofc_file__warning_count++;
 	}
 }
 
@@ -574,3 +921,79 @@ void ofc_file_warning(
 	ofc_file_warning_va(file, NULL, ptr, format, args);
 	va_end(args);
 }
+
+
+bool ofc_file_loc(
+	const ofc_file_t* file,
+	const char* sol, const char* ptr,
+	ofc_file_loc_t* loc)
+{
+	if (!loc)
+		return false;
+
+	unsigned row, col;
+	bool positional = ofc_file_get_position(
+		file, ptr, &row, &col);
+
+	loc->head   = NULL;
+	loc->tail   = NULL;
+	loc->indent = ofc_file__debug_indent(file);
+
+	size_t size;
+	FILE* head = open_memstream(&loc->head, &size);
+	if (head)
+	{
+		ofc_file__debug_head(head, file, positional, row, col);
+		fclose(head);
+	}
+
+	FILE* tail = open_memstream(&loc->tail, &size);
+	if (tail)
+	{
+		ofc_file__debug_tail(tail, file, sol, ptr, positional, col);
+		fclose(tail);
+	}
+
+	if (!loc->head || !loc->tail)
+	{
+		ofc_file_loc_cleanup(loc);
+		return false;
+	}
+
+	return true;
+}
+
+void ofc_file_loc_cleanup(ofc_file_loc_t* loc)
+{
+	if (!loc)
+		return;
+
+	free(loc->head);
+	free(loc->tail);
+	loc->head = NULL;
+	loc->tail = NULL;
+}
+
+void ofc_file_loc_warning_va(
+	const ofc_file_loc_t* loc,
+	const char* format, va_list args)
+{
+	if (!loc || global_opts.no_warn)
+		return;
+
+	FILE* stream = ofc_file__diag_stream();
+	fprintf(stream, "Warning:%s", (loc->head ? loc->head : ""));
+	ofc_file__debug_message(stream, loc->indent, format, args);
+	if (loc->tail) fputs(loc->tail, stream);
+	ofc_file__warning_count++;
+}
+
+void ofc_file_loc_warning(
+	const ofc_file_loc_t* loc,
+	const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	ofc_file_loc_warning_va(loc, format, args);
+	va_end(args);
+}
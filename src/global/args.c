@@ -14,40 +14,27 @@
  */
 
  #include <ofc/global.h>
+#include <ofc/vector.h>
 
 typedef struct
 {
-	const ofc_sema_decl_t*     subr;
-	ofc_sema_dummy_arg_list_t* args;
-	ofc_sema_expr_t*       ret;
-} ofc_call_t;
-
-typedef struct
-{
-	ofc_str_ref_t name;
-	unsigned      count;
-	ofc_call_t**  call;
+	ofc_symbol_t              symbol;
+	unsigned                  count, size;
+	const ofc_global_call_t** call;
 } ofc_subroutine_list_t;
 
-ofc_call_t* ofc_call_create(
-	const ofc_sema_decl_t*     subr,
-	ofc_sema_dummy_arg_list_t* args,
-	ofc_sema_expr_t*           ret)
-{
-	ofc_call_t* call
-		= (ofc_call_t*)malloc(
-			sizeof(ofc_call_t));
-	if (!call) return NULL;
-
-	call->subr = subr;
-	call->args = args;
-	call->ret  = ret;
+OFC_VECTOR_DEFINE(ofc_subroutine__call_vector, const ofc_global_call_t*)
 
-	return call;
-}
+/* Procedures are called across files, so their names are
+   interned into a table of the pass's own to compare them. */
+typedef struct
+{
+	ofc_symbol_table_t* symbols;
+	ofc_hashmap_t*      map;
+} ofc_args_table_t;
 
 static ofc_subroutine_list_t* ofc_subroutine_list_create(
-	ofc_str_ref_t name, ofc_call_t* call)
+	ofc_symbol_t symbol, const ofc_global_call_t* call)
 {
 	if (!call) return NULL;
 
@@ -57,16 +44,17 @@ static ofc_subroutine_list_t* ofc_subroutine_list_create(
 	if (!list) return NULL;
 
 	list->call
-		= (ofc_call_t**)malloc(
-			sizeof(ofc_call_t*));
+		= (const ofc_global_call_t**)malloc(
+			sizeof(const ofc_global_call_t*));
 	if (!list->call)
 	{
 		free(list);
 		return NULL;
 	}
 
-	list->name = name;
+	list->symbol = symbol;
 	list->count = 1;
+	list->size  = 1;
 	list->call[0] = call;
 	return list;
 }
@@ -76,145 +64,69 @@ static void ofc_subroutine_list_delete(
 {
 	if (!list) return;
 
-	unsigned i;
-	for (i = 0; i < list->count; i++)
-		free(list->call[i]);
 	free(list->call);
 	free(list);
 }
 
-static ofc_str_ref_t* ofc_subroutine_list_name(
+static ofc_symbol_t* ofc_subroutine_list_symbol(
 	ofc_subroutine_list_t* list)
 {
-	return (list ? &list->name : NULL);
+	return (list ? &list->symbol : NULL);
 }
 
 static bool ofc_subroutine_list_add(
-	ofc_subroutine_list_t* list, const ofc_sema_decl_t* subr,
-	ofc_sema_dummy_arg_list_t* args, ofc_sema_expr_t* ret)
-{
-	if (!list || !subr)
-		return false;
-
-	unsigned i;
-	for (i = 0; i < list->count; i++)
-	{
-		if (list->call[i]->args == args)
-			return true;
-	}
-
-	ofc_call_t* call
-		= ofc_call_create(subr, args, ret);
-	if (!call) return false;
-
-	ofc_call_t** ncall
-		= (ofc_call_t**)realloc(list->call,
-			(sizeof(ofc_call_t*) * (list->count + 1)));
-	if (!ncall) return false;
-	list->call = ncall;
-
-	list->call[list->count++] = call;
-	return true;
-}
-
-static bool ofc_global_pass_args__stmt(
-	ofc_sema_stmt_t* stmt,
-	ofc_hashmap_t* args_table)
+	ofc_subroutine_list_t* list, const ofc_global_call_t* call)
 {
-	if (!stmt || !args_table)
+	if (!list || !call)
 		return false;
 
-	switch (stmt->type)
-	{
-		case OFC_SEMA_STMT_CALL:
-			break;
-		default:
-			return true;
-	}
-
-	ofc_subroutine_list_t* list
-		= ofc_hashmap_find_modify(
-			args_table, &stmt->call.subroutine->name.string);
-	if (list)
-	{
-		if (!ofc_subroutine_list_add(
-			list, stmt->call.subroutine, stmt->call.args, NULL))
-			return false;
-	}
-	else
+	/* Calls without an argument list are only checked once,
+	   summaries have already dropped repeats of the others. */
+	if (!call->args)
 	{
-		ofc_call_t* call = ofc_call_create(
-			stmt->call.subroutine, stmt->call.args, NULL);
-		if (!call) return false;
-
-		list = ofc_subroutine_list_create(
-			stmt->call.subroutine->name.string, call);
-		if (!list)
+		unsigned i;
+		for (i = 0; i < list->count; i++)
 		{
-			free(call);
-			return false;
-		}
-
-		if (!ofc_hashmap_add(args_table, list))
-		{
-			ofc_subroutine_list_delete(list);
-			return false;
+			if (!list->call[i]->args)
+				return true;
 		}
 	}
 
-	return true;
-}
-
-static bool ofc_global_pass_args__scope_call(
-	ofc_sema_scope_t* scope,
-	ofc_hashmap_t* args_table)
-{
-	if (!scope || !args_table)
-		return false;
-
-	if (!ofc_sema_scope_foreach_stmt(
-		scope, args_table, (void*)ofc_global_pass_args__stmt))
-	{
+	if (!ofc_subroutine__call_vector_reserve(
+		&list->call, list->count, &list->size, 1))
 		return false;
-	}
 
+	list->call[list->count++] = call;
 	return true;
 }
 
-static bool ofc_global_pass_args__expr(
-	ofc_sema_expr_t* expr,
-	ofc_hashmap_t* args_table)
+static bool ofc_global_pass_args__call(
+	const ofc_global_call_t* call,
+	ofc_args_table_t* args_table)
 {
-	if (!expr || !args_table)
+	if (!call || !args_table)
 		return false;
 
-	if (expr->type != OFC_SEMA_EXPR_FUNCTION)
-		return true;
+	ofc_symbol_t symbol = ofc_symbol(
+		args_table->symbols, call->name);
+	if (symbol == OFC_SYMBOL_NONE)
+		return false;
 
 	ofc_subroutine_list_t* list
 		= ofc_hashmap_find_modify(
-			args_table, &expr->function->name.string);
+			args_table->map, &symbol);
 	if (list)
 	{
-		if (!ofc_subroutine_list_add(
-			list, expr->function, expr->args, expr))
+		if (!ofc_subroutine_list_add(list, call))
 			return false;
 	}
 	else
 	{
-		ofc_call_t* call = ofc_call_create(
-			expr->function, expr->args, expr);
-		if (!call) return false;
-
 		list = ofc_subroutine_list_create(
-			expr->function->name.string, call);
-		if (!list)
-		{
-			free(call);
-			return false;
-		}
+			symbol, call);
+		if (!list) return false;
 
-		if (!ofc_hashmap_add(args_table, list))
+		if (!ofc_hashmap_add(args_table->map, list))
 		{
 			ofc_subroutine_list_delete(list);
 			return false;
@@ -224,156 +136,128 @@ static bool ofc_global_pass_args__expr(
 	return true;
 }
 
-static bool ofc_global_pass_args__scope_func(
-	ofc_sema_scope_t* scope,
-	ofc_hashmap_t* args_table)
-{
-	if (!scope || !args_table)
-		return false;
-
-	if (!ofc_sema_scope_foreach_expr(
-		scope, args_table, (void*)ofc_global_pass_args__expr))
-	{
-		return false;
-	}
-
-	return true;
-}
-
 static bool ofc_global_pass_args__check(
-	ofc_subroutine_list_t* list, ofc_sema_scope_t* scope)
+	ofc_subroutine_list_t* list, const ofc_global_proc_t* proc)
 {
-	if (!list || !scope)
+	if (!list || !proc)
 		return false;
 
-	if ((scope->type != OFC_SEMA_SCOPE_SUBROUTINE)
-		&& (scope->type != OFC_SEMA_SCOPE_FUNCTION))
+	if ((proc->type != OFC_SEMA_SCOPE_SUBROUTINE)
+		&& (proc->type != OFC_SEMA_SCOPE_FUNCTION))
 		return false;
 
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 	{
-		if (scope->args)
+		const ofc_global_call_t* call = list->call[i];
+
+		if (proc->args)
 		{
-			if (scope->args->count != list->call[i]->args->count)
+			if (proc->count != call->count)
 			{
-				ofc_sparse_ref_warning(list->call[i]->subr->name,
+				ofc_global_loc_warning(&call->src,
 					"Wrong number of arguments in %s call",
-					ofc_sema_type_str_rep(list->call[i]->subr->type));
+					ofc_sema_type_str_rep(call->type));
 				continue;
 			}
 
 			unsigned l;
-			for (l = 0; l < scope->args->count; l++)
+			for (l = 0; l < proc->count; l++)
 			{
-				ofc_sema_arg_t dummy_arg
-					= scope->args->arg[l];
-				ofc_sema_dummy_arg_t* actual_arg
-					= list->call[i]->args->dummy_arg[l];
+				const ofc_global_dummy_t* dummy_arg
+					= &proc->arg[l];
+				const ofc_global_actual_t* actual_arg
+					= &call->arg[l];
 
-				if (dummy_arg.alt_return
-					&& ofc_sema_dummy_arg_is_alt_return(actual_arg))
+				if (dummy_arg->alt_return
+					&& actual_arg->alt_return)
 					continue;
 
-				if (dummy_arg.alt_return
-					&& !ofc_sema_dummy_arg_is_alt_return(actual_arg))
+				if (dummy_arg->alt_return
+					&& !actual_arg->alt_return)
 				{
-					ofc_sparse_ref_warning(actual_arg->src,
+					ofc_global_loc_warning(&actual_arg->src,
 						"Incompatible argument in %s call, expected label for alternate return.",
-						ofc_sema_type_str_rep(list->call[i]->subr->type));
+						ofc_sema_type_str_rep(call->type));
 					continue;
 				}
-				else if (!dummy_arg.alt_return
-					&& ofc_sema_dummy_arg_is_alt_return(actual_arg))
+				else if (!dummy_arg->alt_return
+					&& actual_arg->alt_return)
 				{
-					const ofc_sema_decl_t* dummy_arg_decl
-						= ofc_sema_scope_decl_find(
-							scope, dummy_arg.name.string, true);
-					const ofc_sema_type_t* dummy_arg_type
-						= ofc_sema_decl_type(dummy_arg_decl);
-
-					ofc_sparse_ref_warning(actual_arg->src,
+					ofc_global_loc_warning(&actual_arg->src,
 						"Incompatible alternate return argument in %s call, expected %s.",
-						ofc_sema_type_str_rep(list->call[i]->subr->type),
-						ofc_sema_type_str_rep(dummy_arg_type));
+						ofc_sema_type_str_rep(call->type),
+						ofc_sema_type_str_rep(dummy_arg->type));
 					continue;
 				}
 
-				/* Find the declaration of the argument in the function scope */
-				const ofc_sema_decl_t* dummy_arg_decl
-					= ofc_sema_scope_decl_find(
-						scope, dummy_arg.name.string, true);
 				/* Not all arguments are declared */
-				if (!dummy_arg_decl) continue;
+				if (!dummy_arg->declared) continue;
 
 				const ofc_sema_type_t* dummy_arg_type
-					= ofc_sema_decl_type(dummy_arg_decl);
+					= dummy_arg->type;
 
 
-				if (ofc_sema_dummy_arg_is_external(actual_arg))
+				if (actual_arg->external)
 				{
 					if (!ofc_sema_type_is_function(dummy_arg_type)
 						&& !ofc_sema_type_is_subroutine(dummy_arg_type))
 					{
-						ofc_sparse_ref_warning(actual_arg->src,
+						ofc_global_loc_warning(&actual_arg->src,
 							"Incompatible argument type (EXTERNAL) in %s call, expected %s.",
-							ofc_sema_type_str_rep(list->call[i]->subr->type),
+							ofc_sema_type_str_rep(call->type),
 							ofc_sema_type_str_rep(dummy_arg_type));
 					}
 					continue;
 				}
 
 				const ofc_sema_type_t* actual_arg_type
-					= ofc_sema_expr_type(actual_arg->expr);
+					= actual_arg->type;
 				if (!ofc_sema_type_compatible(actual_arg_type, dummy_arg_type))
 				{
 					if (!ofc_sema_type_cast_valid(
 						actual_arg_type, dummy_arg_type))
 					{
-						ofc_sparse_ref_warning(actual_arg->src,
+						ofc_global_loc_warning(&actual_arg->src,
 							"Incompatible argument type (%s) in %s call, expected %s.",
 							ofc_sema_type_str_rep(actual_arg_type),
-							ofc_sema_type_str_rep(list->call[i]->subr->type),
+							ofc_sema_type_str_rep(call->type),
 							ofc_sema_type_str_rep(dummy_arg_type));
 					}
 					else if (!ofc_sema_type_cast_is_lossless(
 						actual_arg_type, dummy_arg_type))
 					{
-						ofc_sparse_ref_warning(actual_arg->src,
+						ofc_global_loc_warning(&actual_arg->src,
 							"Argument cast from %s to %s may be lossy in %s call",
 							ofc_sema_type_str_rep(actual_arg_type),
 							ofc_sema_type_str_rep(dummy_arg_type),
-							ofc_sema_type_str_rep(list->call[i]->subr->type));
+							ofc_sema_type_str_rep(call->type));
 					}
 				}
 
-				if ((actual_arg->type == OFC_SEMA_DUMMY_ARG_EXPR)
-					&& ofc_sema_expr_is_constant(actual_arg->expr)
-					&& dummy_arg_decl->was_written)
+				if (actual_arg->constant
+					&& dummy_arg->written)
 				{
-					ofc_sparse_ref_warning(actual_arg->src,
+					ofc_global_loc_warning(&actual_arg->src,
 						"Constant reference may be written to in %s call",
-						ofc_sema_type_str_rep(list->call[i]->subr->type));
+						ofc_sema_type_str_rep(call->type));
 				}
 			}
 		}
 
-		if (scope->type == OFC_SEMA_SCOPE_FUNCTION)
+		if (proc->type == OFC_SEMA_SCOPE_FUNCTION)
 		{
-			const ofc_sema_decl_t* func_decl
-				= ofc_sema_scope_decl_find(
-					scope, scope->name, true);
 			const ofc_sema_type_t* func_type
-				= ofc_sema_decl_type(func_decl);
+				= proc->ret_type;
 			const ofc_sema_type_t* ret_type
-				= ofc_sema_expr_type(list->call[i]->ret);
+				= call->ret_type;
 
 			if (!ofc_sema_type_compatible(func_type, ret_type))
 			{
 				if (!ofc_sema_type_cast_valid(
 					func_type, ret_type))
 				{
-					ofc_sparse_ref_warning(list->call[i]->ret->src,
+					ofc_global_loc_warning(&call->ret_src,
 						"Function return type is %s, expected %s.",
 						ofc_sema_type_str_rep(func_type),
 						ofc_sema_type_str_rep(ret_type));
@@ -381,7 +265,7 @@ static bool ofc_global_pass_args__check(
 				else if (!ofc_sema_type_cast_is_lossless(
 					func_type, ret_type))
 				{
-					ofc_sparse_ref_warning(list->call[i]->ret->src,
+					ofc_global_loc_warning(&call->ret_src,
 						"Cast of function from %s to %s may be lossy.",
 						ofc_sema_type_str_rep(func_type),
 						ofc_sema_type_str_rep(ret_type));
@@ -393,26 +277,25 @@ static bool ofc_global_pass_args__check(
 	return true;
 }
 
-static bool ofc_global_pass_args__scope_decl(
-	ofc_sema_scope_t* scope,
-	ofc_hashmap_t* args_table)
+static bool ofc_global_pass_args__proc(
+	const ofc_global_proc_t* proc,
+	ofc_args_table_t* args_table)
 {
-	if ((scope->type != OFC_SEMA_SCOPE_SUBROUTINE)
-		&& (scope->type != OFC_SEMA_SCOPE_FUNCTION))
-		return true;
-
-	ofc_subroutine_list_t* list
-		= ofc_hashmap_find_modify(
-			args_table, &scope->name);
+	/* A procedure name that was never interned can't have been called. */
+	ofc_symbol_t symbol = ofc_symbol_find(
+		args_table->symbols, proc->name, false);
+	ofc_subroutine_list_t* list = NULL;
+	if (symbol != OFC_SYMBOL_NONE)
+		list = ofc_hashmap_find_modify(args_table->map, &symbol);
 	if (list)
 	{
-		ofc_global_pass_args__check(list, scope);
+		ofc_global_pass_args__check(list, proc);
 	}
 	else if (global_opts.warn_unused_procedure)
 	{
 		ofc_file_warning(NULL, NULL, "Unused %s '%.*s'",
-			((scope->type == OFC_SEMA_SCOPE_SUBROUTINE) ? "SUBROUTINE" : "FUNCTION"),
-			scope->name.size, scope->name.base);
+			((proc->type == OFC_SEMA_SCOPE_SUBROUTINE) ? "SUBROUTINE" : "FUNCTION"),
+			proc->name.size, proc->name.base);
 	}
 
 	/* What about the calls that don't have a function declaration? */
@@ -420,34 +303,59 @@ static bool ofc_global_pass_args__scope_decl(
 }
 
 
-bool ofc_global_pass_args(
-	ofc_sema_scope_t* scope)
+bool ofc_global_pass_args_summary(
+	const ofc_global_summary_list_t* list)
 {
-	if (!scope)
+	if (!list)
 		return false;
 
-	ofc_hashmap_t* args_table
-		= ofc_hashmap_create(
-			(void*)ofc_str_ref_ptr_hash,
-			(void*)ofc_str_ref_ptr_equal_ci,
-			(void*)ofc_subroutine_list_name,
-			(void*)ofc_subroutine_list_delete);
-	if (!args_table) return false;
-
-	/* Find all the subroutines */
-	if (!ofc_sema_scope_foreach_scope(
-		scope, args_table,
-		(void*)ofc_global_pass_args__scope_call))
-		return false;
+	ofc_args_table_t args_table;
+	args_table.symbols = ofc_symbol_table_create();
+	args_table.map = ofc_hashmap_create(
+		(void*)ofc_symbol_ptr_hash_ci,
+		(void*)ofc_symbol_ptr_equal_ci,
+		(void*)ofc_subroutine_list_symbol,
+		(void*)ofc_subroutine_list_delete);
 
-	/* Find all the functions */
-	if (!ofc_sema_scope_foreach_scope(
-		scope, args_table,
-		(void*)ofc_global_pass_args__scope_func))
-		return false;
+	bool success = (args_table.symbols && args_table.map);
+
+	/* Find all the subroutines, then all the functions */
+	unsigned i, j;
+	for (i = 0; success && (i < list->count); i++)
+	{
+		const ofc_global_summary_t* summary = list->summary[i];
+		for (j = 0; success && (j < summary->call_count); j++)
+			success = ofc_global_pass_args__call(&summary->call[j], &args_table);
+	}
+	for (i = 0; success && (i < list->count); i++)
+	{
+		const ofc_global_summary_t* summary = list->summary[i];
+		for (j = 0; success && (j < summary->func_count); j++)
+			success = ofc_global_pass_args__call(&summary->func[j], &args_table);
+	}
+	for (i = 0; success && (i < list->count); i++)
+	{
+		const ofc_global_summary_t* summary = list->summary[i];
+		for (j = 0; success && (j < summary->proc_count); j++)
+			success = ofc_global_pass_args__proc(&summary->proc[j], &args_table);
+	}
+
+	ofc_hashmap_delete(args_table.map);
+	ofc_symbol_table_delete(args_table.symbols);
+	return success;
+}
+
+bool ofc_global_pass_args(
+	ofc_sema_scope_t* scope)
+{
+	ofc_global_summary_t* summary
+		= ofc_global_summary_create(scope);
+	if (!summary) return false;
+
+	ofc_global_summary_list_t list =
+		{ .count = 1, .size = 1, .summary = &summary };
+	bool success = ofc_global_pass_args_summary(&list);
 
-	bool success = ofc_sema_scope_foreach_scope(
-		scope, args_table, (void*)ofc_global_pass_args__scope_decl);
-	ofc_hashmap_delete(args_table);
+	ofc_global_summary_delete(summary);
 	return success;
 }
@@ -14,18 +14,28 @@
  */
 
 #include <ofc/global.h>
+#include <ofc/vector.h>
 
 
+OFC_VECTOR_DEFINE(ofc_common__block_vector, const ofc_global_common_t*)
 
+/* Blocks are shared across files, so their names are
+   interned in a table of the pass's own to compare them. */
 typedef struct
 {
-	ofc_str_ref_t       name;
-	unsigned            count;
-	ofc_sema_common_t** block;
+	ofc_symbol_table_t* symbols;
+	ofc_hashmap_t*      map;
+} ofc_common_table_t;
+
+typedef struct
+{
+	ofc_symbol_t                symbol;
+	unsigned                    count, size;
+	const ofc_global_common_t** block;
 } ofc_common_list_t;
 
 static ofc_common_list_t* ofc_common_list_create(
-	ofc_str_ref_t name, ofc_sema_common_t* common)
+	ofc_symbol_t symbol, const ofc_global_common_t* common)
 {
 	ofc_common_list_t* list
 		= (ofc_common_list_t*)malloc(
@@ -33,16 +43,17 @@ static ofc_common_list_t* ofc_common_list_create(
 	if (!list) return NULL;
 
 	list->block
-		= (ofc_sema_common_t**)malloc(
-			sizeof(ofc_sema_common_t*));
+		= (const ofc_global_common_t**)malloc(
+			sizeof(const ofc_global_common_t*));
 	if (!list->block)
 	{
 		free(list);
 		return NULL;
 	}
 
-	list->name = name;
+	list->symbol = symbol;
 	list->count = 1;
+	list->size  = 1;
 	list->block[0] = common;
 	return list;
 }
@@ -55,30 +66,21 @@ static void ofc_common_list_delete(
 	free(list);
 }
 
-static ofc_str_ref_t* ofc_common_list_name(
+static ofc_symbol_t* ofc_common_list_symbol(
 	ofc_common_list_t* list)
 {
-	return (list ? &list->name : NULL);
+	return (list ? &list->symbol : NULL);
 }
 
 static bool ofc_common_list_add(
-	ofc_common_list_t* list, ofc_sema_common_t* block)
+	ofc_common_list_t* list, const ofc_global_common_t* block)
 {
 	if (!list || !block)
 		return false;
 
-	unsigned i;
-	for (i = 0; i < list->count; i++)
-	{
-		if (list->block[i] == block)
-			return true;
-	}
-
-	ofc_sema_common_t** nblock
-		= (ofc_sema_common_t**)realloc(list->block,
-			(sizeof(ofc_sema_common_t*) * (list->count + 1)));
-	if (!nblock) return false;
-	list->block = nblock;
+	if (!ofc_common__block_vector_reserve(
+		&list->block, list->count, &list->size, 1))
+		return false;
 
 	list->block[list->count++] = block;
 	return true;
@@ -86,39 +88,38 @@ static bool ofc_common_list_add(
 
 
 
-static bool ofc_global_pass_common__scope(
-	ofc_sema_scope_t* scope,
-	ofc_hashmap_t* common_table)
+static bool ofc_global_pass_common__summary(
+	const ofc_global_summary_t* summary,
+	ofc_common_table_t* common_table)
 {
-	if (!scope || !common_table)
+	if (!summary || !common_table)
 		return false;
 
-	if (!scope->common)
-		return true;
-
 	unsigned i;
-	for (i = 0; i < scope->common->count; i++)
+	for (i = 0; i < summary->common_count; i++)
 	{
-		if (!scope->common->common[i])
-			continue;
+		const ofc_global_common_t* common
+			= &summary->common[i];
+
+		ofc_symbol_t symbol = ofc_symbol(
+			common_table->symbols, common->name);
+		if (symbol == OFC_SYMBOL_NONE)
+			return false;
 
 		ofc_common_list_t* list
 			= ofc_hashmap_find_modify(
-				common_table, &scope->common->common[i]->name);
+				common_table->map, &symbol);
 		if (list)
 		{
-			if (!ofc_common_list_add(
-				list, scope->common->common[i]))
+			if (!ofc_common_list_add(list, common))
 				return false;
 		}
 		else
 		{
-			list = ofc_common_list_create(
-				scope->common->common[i]->name,
-				scope->common->common[i]);
+			list = ofc_common_list_create(symbol, common);
 			if (!list) return false;
 
-			if (!ofc_hashmap_add(common_table, list))
+			if (!ofc_hashmap_add(common_table->map, list))
 			{
 				ofc_common_list_delete(list);
 				return false;
@@ -130,6 +131,26 @@ static bool ofc_global_pass_common__scope(
 }
 
 
+/* As ofc_sema_common_compatible. */
+static bool ofc_global_pass_common__compatible(
+	const ofc_global_common_t* a,
+	const ofc_global_common_t* b)
+{
+	if (a->count != b->count)
+		return false;
+
+	unsigned i;
+	for (i = 0; i < a->count; i++)
+	{
+		if (!ofc_sema_type_compatible(
+			a->member[i].type, b->member[i].type)
+			|| !a->member[i].sized)
+			return false;
+	}
+
+	return true;
+}
+
 static bool ofc_global_pass_common__check(
 	ofc_common_list_t* list, void* param)
 {
@@ -143,7 +164,7 @@ static bool ofc_global_pass_common__check(
 	unsigned i;
 	for (i = 1; i < list->count; i++)
 	{
-		if (!ofc_sema_common_compatible(
+		if (!ofc_global_pass_common__compatible(
 			list->block[0], list->block[i]))
 			conflict = true;
 	}
@@ -158,27 +179,49 @@ static bool ofc_global_pass_common__check(
 	return true;
 }
 
+bool ofc_global_pass_common_summary(
+	const ofc_global_summary_list_t* list)
+{
+	if (!list)
+		return false;
+
+	ofc_common_table_t common_table;
+	common_table.symbols = ofc_symbol_table_create();
+	common_table.map = ofc_hashmap_create(
+		(void*)ofc_symbol_ptr_hash_ci,
+		(void*)ofc_symbol_ptr_equal_ci,
+		(void*)ofc_common_list_symbol,
+		(void*)ofc_common_list_delete);
+
+	bool success = (common_table.symbols && common_table.map);
+
+	unsigned i;
+	for (i = 0; success && (i < list->count); i++)
+	{
+		success = ofc_global_pass_common__summary(
+			list->summary[i], &common_table);
+	}
+
+	success = success && ofc_hashmap_foreach(
+		common_table.map, NULL,
+		(void*)ofc_global_pass_common__check);
+
+	ofc_hashmap_delete(common_table.map);
+	ofc_symbol_table_delete(common_table.symbols);
+	return success;
+}
+
 bool ofc_global_pass_common(
 	ofc_sema_scope_t* scope)
 {
-	if (!scope)
-		return false;
+	ofc_global_summary_t* summary
+		= ofc_global_summary_create(scope);
+	if (!summary) return false;
 
-	ofc_hashmap_t* common_table
-		= ofc_hashmap_create(
-			(void*)ofc_str_ref_ptr_hash,
-			(void*)ofc_str_ref_ptr_equal_ci,
-			(void*)ofc_common_list_name,
-			(void*)ofc_common_list_delete);
-	if (!common_table) return false;
-
-	if (!ofc_sema_scope_foreach_scope(
-		scope, common_table,
-		(void*)ofc_global_pass_common__scope))
-		return false;
+	ofc_global_summary_list_t list =
+		{ .count = 1, .size = 1, .summary = &summary };
+	bool success = ofc_global_pass_common_summary(&list);
 
-	bool success = ofc_hashmap_foreach(
-		common_table, NULL, (void*)ofc_global_pass_common__check);
-	ofc_hashmap_delete(common_table);
+	ofc_global_summary_delete(summary);
 	return success;
 }
@@ -0,0 +1,960 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <ofc/global.h>
+#include <ofc/vector.h>
+
+
+OFC_VECTOR_DEFINE(ofc_global__common_vector, ofc_global_common_t)
+OFC_VECTOR_DEFINE(ofc_global__call_vector, ofc_global_call_t)
+OFC_VECTOR_DEFINE(ofc_global__proc_vector, ofc_global_proc_t)
+OFC_VECTOR_DEFINE(ofc_global__summary_vector, ofc_global_summary_t*)
+OFC_VECTOR_DEFINE(ofc_global__byte_vector, uint8_t)
+
+#define OFC_GLOBAL__TYPE_NONE  0xFFFFFFFFU
+#define OFC_GLOBAL__TYPE_DEPTH 16
+
+
+void ofc_global_loc_warning(
+	const ofc_global_loc_t* loc,
+	const char* format, ...)
+{
+	if (!loc)
+		return;
+
+	va_list args;
+	va_start(args, format);
+	if (loc->loc.head)
+		ofc_file_loc_warning_va(&loc->loc, format, args);
+	else
+		ofc_sparse_warning_va(loc->ref.sparse, loc->ref.string, format, args);
+	va_end(args);
+}
+
+
+static ofc_global_summary_t* ofc_global_summary__create(void)
+{
+	ofc_global_summary_t* summary
+		= (ofc_global_summary_t*)calloc(
+			1, sizeof(ofc_global_summary_t));
+	return summary;
+}
+
+static void ofc_global_summary__call_cleanup(
+	ofc_global_call_t* call, unsigned count)
+{
+	unsigned i;
+	for (i = 0; i < count; i++)
+		free(call[i].arg);
+	free(call);
+}
+
+void ofc_global_summary_delete(
+	ofc_global_summary_t* summary)
+{
+	if (!summary)
+		return;
+
+	unsigned i;
+	for (i = 0; i < summary->common_count; i++)
+		free(summary->common[i].member);
+	free(summary->common);
+
+	ofc_global_summary__call_cleanup(
+		summary->call, summary->call_count);
+	ofc_global_summary__call_cleanup(
+		summary->func, summary->func_count);
+
+	for (i = 0; i < summary->proc_count; i++)
+		free(summary->proc[i].arg);
+	free(summary->proc);
+
+	free(summary->buff);
+	free(summary);
+}
+
+
+/* A block or argument list may be reached more than once,
+   the passes only count it the first time. */
+typedef struct
+{
+	ofc_global_summary_t* summary;
+	ofc_hashmap_t*        seen;
+} ofc_global_summary__builder_t;
+
+static const void* ofc_global_summary__ptr_key(const void* ptr)
+{
+	return ptr;
+}
+
+static bool ofc_global_summary__ptr_equal(
+	const void* a, const void* b)
+{
+	return (a == b);
+}
+
+static bool ofc_global_summary__first(
+	ofc_global_summary__builder_t* builder, const void* ptr)
+{
+	if (!ptr) return true;
+
+	if (ofc_hashmap_find(builder->seen, ptr))
+		return false;
+	return ofc_hashmap_add(builder->seen, (void*)ptr);
+}
+
+static bool ofc_global_summary__scope_common(
+	ofc_sema_scope_t* scope,
+	ofc_global_summary__builder_t* builder)
+{
+	if (!scope || !builder)
+		return false;
+
+	if (!scope->common)
+		return true;
+
+	ofc_global_summary_t* summary = builder->summary;
+
+	unsigned i;
+	for (i = 0; i < scope->common->count; i++)
+	{
+		const ofc_sema_common_t* block
+			= scope->common->common[i];
+		if (!block || !ofc_global_summary__first(builder, block))
+			continue;
+
+		if (!ofc_global__common_vector_reserve(
+			&summary->common, summary->common_count,
+			&summary->common_size, 1))
+			return false;
+
+		ofc_global_common_t* common
+			= &summary->common[summary->common_count];
+		common->name   = block->name;
+		common->count  = block->count;
+		common->member = NULL;
+
+		if (block->count > 0)
+		{
+			common->member = (ofc_global_member_t*)malloc(
+				sizeof(ofc_global_member_t) * block->count);
+			if (!common->member) return false;
+		}
+		summary->common_count++;
+
+		unsigned m;
+		for (m = 0; m < block->count; m++)
+		{
+			unsigned size;
+			common->member[m].type  = ofc_sema_decl_type(block->decl[m]);
+			common->member[m].sized = ofc_sema_decl_size(block->decl[m], &size);
+		}
+	}
+
+	return true;
+}
+
+static bool ofc_global_summary__call_add(
+	ofc_global_summary__builder_t* builder,
+	bool function, const ofc_sema_decl_t* subr,
+	const ofc_sema_dummy_arg_list_t* args,
+	const ofc_sema_expr_t* ret)
+{
+	if (!subr)
+		return false;
+
+	if (!ofc_global_summary__first(builder, args))
+		return true;
+
+	ofc_global_summary_t* summary = builder->summary;
+
+	ofc_global_call_t** call  = (function ? &summary->func       : &summary->call      );
+	unsigned*           count = (function ? &summary->func_count : &summary->call_count);
+	unsigned*           size  = (function ? &summary->func_size  : &summary->call_size );
+
+	if (!ofc_global__call_vector_reserve(
+		call, *count, size, 1))
+		return false;
+
+	ofc_global_call_t* c = &(*call)[*count];
+	memset(c, 0x00, sizeof(ofc_global_call_t));
+
+	c->name    = ofc_symbol_name(subr->symbol);
+	c->type    = subr->type;
+	c->src.ref = subr->name;
+	c->args    = (args != NULL);
+
+	c->function = function;
+	if (ret)
+	{
+		c->ret_type    = ofc_sema_expr_type(ret);
+		c->ret_src.ref = ret->src;
+	}
+
+	if (args && (args->count > 0))
+	{
+		c->arg = (ofc_global_actual_t*)calloc(
+			args->count, sizeof(ofc_global_actual_t));
+		if (!c->arg) return false;
+	}
+	c->count = (args ? args->count : 0);
+	(*count)++;
+
+	unsigned i;
+	for (i = 0; i < c->count; i++)
+	{
+		const ofc_sema_dummy_arg_t* actual
+			= args->dummy_arg[i];
+		if (!actual) continue;
+
+		ofc_global_actual_t* a = &c->arg[i];
+		a->alt_return = ofc_sema_dummy_arg_is_alt_return(actual);
+		a->external   = ofc_sema_dummy_arg_is_external(actual);
+		a->src.ref    = actual->src;
+
+		if (!a->alt_return && !a->external)
+		{
+			a->type = ofc_sema_expr_type(actual->expr);
+			a->constant = (actual->type == OFC_SEMA_DUMMY_ARG_EXPR)
+				&& ofc_sema_expr_is_constant(actual->expr);
+		}
+	}
+
+	return true;
+}
+
+static bool ofc_global_summary__stmt(
+	ofc_sema_stmt_t* stmt,
+	ofc_global_summary__builder_t* builder)
+{
+	if (!stmt || !builder)
+		return false;
+
+	if (stmt->type != OFC_SEMA_STMT_CALL)
+		return true;
+
+	return ofc_global_summary__call_add(builder, false,
+		stmt->call.subroutine, stmt->call.args, NULL);
+}
+
+static bool ofc_global_summary__scope_call(
+	ofc_sema_scope_t* scope,
+	ofc_global_summary__builder_t* builder)
+{
+	if (!scope || !builder)
+		return false;
+
+	return ofc_sema_scope_foreach_stmt(
+		scope, builder, (void*)ofc_global_summary__stmt);
+}
+
+static bool ofc_global_summary__expr(
+	ofc_sema_expr_t* expr,
+	ofc_global_summary__builder_t* builder)
+{
+	if (!expr || !builder)
+		return false;
+
+	if (expr->type != OFC_SEMA_EXPR_FUNCTION)
+		return true;
+
+	return ofc_global_summary__call_add(builder, true,
+		expr->function, expr->args, expr);
+}
+
+static bool ofc_global_summary__scope_func(
+	ofc_sema_scope_t* scope,
+	ofc_global_summary__builder_t* builder)
+{
+	if (!scope || !builder)
+		return false;
+
+	return ofc_sema_scope_foreach_expr(
+		scope, builder, (void*)ofc_global_summary__expr);
+}
+
+static bool ofc_global_summary__scope_proc(
+	ofc_sema_scope_t* scope,
+	ofc_global_summary__builder_t* builder)
+{
+	if (!scope || !builder)
+		return false;
+
+	if ((scope->type != OFC_SEMA_SCOPE_SUBROUTINE)
+		&& (scope->type != OFC_SEMA_SCOPE_FUNCTION))
+		return true;
+
+	ofc_global_summary_t* summary = builder->summary;
+	if (!ofc_global__proc_vector_reserve(
+		&summary->proc, summary->proc_count,
+		&summary->proc_size, 1))
+		return false;
+
+	ofc_global_proc_t* proc
+		= &summary->proc[summary->proc_count];
+	memset(proc, 0x00, sizeof(ofc_global_proc_t));
+
+	proc->type = scope->type;
+	proc->name = scope->name;
+	if (scope->type == OFC_SEMA_SCOPE_FUNCTION)
+	{
+		proc->ret_type = ofc_sema_decl_type(
+			ofc_sema_scope_decl_find(
+				scope, scope->name, true));
+	}
+
+	proc->args = (scope->args != NULL);
+	if (scope->args && (scope->args->count > 0))
+	{
+		proc->arg = (ofc_global_dummy_t*)calloc(
+			scope->args->count, sizeof(ofc_global_dummy_t));
+		if (!proc->arg) return false;
+	}
+	proc->count = (scope->args ? scope->args->count : 0);
+	summary->proc_count++;
+
+	unsigned i;
+	for (i = 0; i < proc->count; i++)
+	{
+		const ofc_sema_arg_t* arg = &scope->args->arg[i];
+		const ofc_sema_decl_t* decl
+			= ofc_sema_scope_decl_find(
+				scope, arg->name.string, true);
+
+		proc->arg[i].alt_return = arg->alt_return;
+		proc->arg[i].declared   = (decl != NULL);
+		proc->arg[i].written    = (decl && decl->was_written);
+		proc->arg[i].type       = ofc_sema_decl_type(decl);
+	}
+
+	return true;
+}
+
+ofc_global_summary_t* ofc_global_summary_create(
+	ofc_sema_scope_t* scope)
+{
+	if (!scope)
+		return NULL;
+
+	ofc_global_summary__builder_t builder;
+	builder.summary = ofc_global_summary__create();
+	builder.seen = ofc_hashmap_create(
+		(void*)ofc_hashmap_hash_ptr,
+		(void*)ofc_global_summary__ptr_equal,
+		(void*)ofc_global_summary__ptr_key, NULL);
+
+	/* Walked as the passes walk the tree, so that a summary of each
+	   file in turn finds everything in the same order. */
+	bool success = (builder.summary && builder.seen
+		&& ofc_sema_scope_foreach_scope(scope, &builder,
+			(void*)ofc_global_summary__scope_common)
+		&& ofc_sema_scope_foreach_scope(scope, &builder,
+			(void*)ofc_global_summary__scope_call)
+		&& ofc_sema_scope_foreach_scope(scope, &builder,
+			(void*)ofc_global_summary__scope_func)
+		&& ofc_sema_scope_foreach_scope(scope, &builder,
+			(void*)ofc_global_summary__scope_proc));
+
+	ofc_hashmap_delete(builder.seen);
+	if (!success)
+	{
+		ofc_global_summary_delete(builder.summary);
+		return NULL;
+	}
+
+	return builder.summary;
+}
+
+
+typedef struct
+{
+	uint8_t* buff;
+	unsigned size, used;
+	bool     failed;
+} ofc_global_summary__writer_t;
+
+static void ofc_global_summary__put(
+	ofc_global_summary__writer_t* writer,
+	const void* data, unsigned size)
+{
+	if (writer->failed)
+		return;
+
+	if (!ofc_global__byte_vector_reserve(
+		&writer->buff, writer->used, &writer->size, size))
+	{
+		writer->failed = true;
+		return;
+	}
+
+	memcpy(&writer->buff[writer->used], data, size);
+	writer->used += size;
+}
+
+static void ofc_global_summary__put_u32(
+	ofc_global_summary__writer_t* writer, uint32_t value)
+{
+	ofc_global_summary__put(writer, &value, sizeof(value));
+}
+
+static void ofc_global_summary__put_bool(
+	ofc_global_summary__writer_t* writer, bool value)
+{
+	uint8_t b = (value ? 1 : 0);
+	ofc_global_summary__put(writer, &b, 1);
+}
+
+/* Strings are written with a length and a terminating NUL. */
+static void ofc_global_summary__put_string(
+	ofc_global_summary__writer_t* writer,
+	const char* base, unsigned size)
+{
+	ofc_global_summary__put_u32(writer, size);
+	if (size > 0)
+		ofc_global_summary__put(writer, base, size);
+	ofc_global_summary__put(writer, "", 1);
+}
+
+static void ofc_global_summary__put_type(
+	ofc_global_summary__writer_t* writer,
+	const ofc_sema_type_t* type)
+{
+	if (!type)
+	{
+		ofc_global_summary__put_u32(
+			writer, OFC_GLOBAL__TYPE_NONE);
+		return;
+	}
+
+	ofc_global_summary__put_u32(writer, type->type);
+	switch (type->type)
+	{
+		case OFC_SEMA_TYPE_POINTER:
+		case OFC_SEMA_TYPE_FUNCTION:
+			ofc_global_summary__put_type(writer, type->subtype);
+			break;
+
+		case OFC_SEMA_TYPE_SUBROUTINE:
+		case OFC_SEMA_TYPE_TYPE:
+		case OFC_SEMA_TYPE_RECORD:
+			break;
+
+		default:
+			ofc_global_summary__put_u32(writer, type->kind);
+			ofc_global_summary__put_u32(writer, type->len);
+			ofc_global_summary__put_bool(writer, type->len_var);
+			break;
+	}
+}
+
+static void ofc_global_summary__put_loc(
+	ofc_global_summary__writer_t* writer,
+	const ofc_global_loc_t* loc)
+{
+	ofc_file_loc_t rendered;
+	const ofc_file_loc_t* l = &loc->loc;
+	if (!l->head)
+	{
+		if (!ofc_sparse_ref_loc(loc->ref, &rendered))
+		{
+			writer->failed = true;
+			return;
+		}
+		l = &rendered;
+	}
+
+	ofc_global_summary__put_u32(writer, l->indent);
+	ofc_global_summary__put_string(writer, l->head, strlen(l->head));
+	ofc_global_summary__put_string(writer, l->tail, strlen(l->tail));
+
+	if (l == &rendered)
+		ofc_file_loc_cleanup(&rendered);
+}
+
+static void ofc_global_summary__put_call(
+	ofc_global_summary__writer_t* writer,
+	const ofc_global_call_t* call)
+{
+	ofc_global_summary__put_string(writer,
+		call->name.base, call->name.size);
+	ofc_global_summary__put_type(writer, call->type);
+	ofc_global_summary__put_loc(writer, &call->src);
+
+	ofc_global_summary__put_bool(writer, call->args);
+	ofc_global_summary__put_u32(writer, call->count);
+
+	unsigned i;
+	for (i = 0; i < call->count; i++)
+	{
+		const ofc_global_actual_t* arg = &call->arg[i];
+		ofc_global_summary__put_bool(writer, arg->alt_return);
+		ofc_global_summary__put_bool(writer, arg->external);
+		ofc_global_summary__put_bool(writer, arg->constant);
+		ofc_global_summary__put_type(writer, arg->type);
+		ofc_global_summary__put_loc(writer, &arg->src);
+	}
+
+	ofc_global_summary__put_bool(writer, call->function);
+	if (call->function)
+	{
+		ofc_global_summary__put_type(writer, call->ret_type);
+		ofc_global_summary__put_loc(writer, &call->ret_src);
+	}
+}
+
+void* ofc_global_summary_write(
+	const ofc_global_summary_t* summary, size_t* size)
+{
+	if (!summary || !size)
+		return NULL;
+
+	ofc_global_summary__writer_t writer =
+		{ .buff = NULL, .size = 0, .used = 0, .failed = false };
+
+	unsigned i;
+	ofc_global_summary__put_u32(&writer, summary->common_count);
+	for (i = 0; i < summary->common_count; i++)
+	{
+		const ofc_global_common_t* common = &summary->common[i];
+		ofc_global_summary__put_string(&writer,
+			common->name.base, common->name.size);
+		ofc_global_summary__put_u32(&writer, common->count);
+
+		unsigned m;
+		for (m = 0; m < common->count; m++)
+		{
+			ofc_global_summary__put_type(&writer, common->member[m].type);
+			ofc_global_summary__put_bool(&writer, common->member[m].sized);
+		}
+	}
+
+	ofc_global_summary__put_u32(&writer, summary->call_count);
+	for (i = 0; i < summary->call_count; i++)
+		ofc_global_summary__put_call(&writer, &summary->call[i]);
+
+	ofc_global_summary__put_u32(&writer, summary->func_count);
+	for (i = 0; i < summary->func_count; i++)
+		ofc_global_summary__put_call(&writer, &summary->func[i]);
+
+	ofc_global_summary__put_u32(&writer, summary->proc_count);
+	for (i = 0; i < summary->proc_count; i++)
+	{
+		const ofc_global_proc_t* proc = &summary->proc[i];
+		ofc_global_summary__put_u32(&writer, proc->type);
+		ofc_global_summary__put_string(&writer,
+			proc->name.base, proc->name.size);
+		ofc_global_summary__put_type(&writer, proc->ret_type);
+		ofc_global_summary__put_bool(&writer, proc->args);
+		ofc_global_summary__put_u32(&writer, proc->count);
+
+		unsigned a;
+		for (a = 0; a < proc->count; a++)
+		{
+			const ofc_global_dummy_t* arg = &proc->arg[a];
+			ofc_global_summary__put_bool(&writer, arg->alt_return);
+			ofc_global_summary__put_bool(&writer, arg->declared);
+			ofc_global_summary__put_bool(&writer, arg->written);
+			ofc_global_summary__put_type(&writer, arg->type);
+		}
+	}
+
+	if (writer.failed)
+	{
+		free(writer.buff);
+		return NULL;
+	}
+
+	*size = writer.used;
+	return writer.buff;
+}
+
+
+/* Strings and locations point into the reader's copy of the buffer,
+   which the summary takes. */
+typedef struct
+{
+	char*  buff;
+	size_t size, pos;
+	bool   failed;
+} ofc_global_summary__reader_t;
+
+static bool ofc_global_summary__get(
+	ofc_global_summary__reader_t* reader,
+	void* data, size_t size)
+{
+	if (reader->failed
+		|| ((reader->size - reader->pos) < size))
+	{
+		reader->failed = true;
+		return false;
+	}
+
+	memcpy(data, &reader->buff[reader->pos], size);
+	reader->pos += size;
+	return true;
+}
+
+static uint32_t ofc_global_summary__get_u32(
+	ofc_global_summary__reader_t* reader)
+{
+	uint32_t value = 0;
+	ofc_global_summary__get(reader, &value, sizeof(value));
+	return value;
+}
+
+static bool ofc_global_summary__get_bool(
+	ofc_global_summary__reader_t* reader)
+{
+	uint8_t b = 0;
+	ofc_global_summary__get(reader, &b, 1);
+	return (b != 0);
+}
+
+/* Counts are checked against what's left, so that a corrupt
+   entry can't make us allocate more than it could hold. */
+static unsigned ofc_global_summary__get_count(
+	ofc_global_summary__reader_t* reader)
+{
+	uint32_t count = ofc_global_summary__get_u32(reader);
+	if (count > (reader->size - reader->pos))
+	{
+		reader->failed = true;
+		return 0;
+	}
+	return count;
+}
+
+static char* ofc_global_summary__get_string(
+	ofc_global_summary__reader_t* reader, unsigned* size)
+{
+	uint32_t len = ofc_global_summary__get_u32(reader);
+	if (reader->failed
+		|| ((reader->size - reader->pos) <= len)
+		|| (reader->buff[reader->pos + len] != '\0'))
+	{
+		reader->failed = true;
+		return NULL;
+	}
+
+	char* base = &reader->buff[reader->pos];
+	reader->pos += (len + 1);
+	if (size) *size = len;
+	return base;
+}
+
+static ofc_str_ref_t ofc_global_summary__get_str_ref(
+	ofc_global_summary__reader_t* reader)
+{
+	unsigned size = 0;
+	char* base = ofc_global_summary__get_string(reader, &size);
+	return (base ? ofc_str_ref(base, size) : OFC_STR_REF_EMPTY);
+}
+
+static const ofc_sema_type_t* ofc_global_summary__get_type(
+	ofc_global_summary__reader_t* reader, unsigned depth)
+{
+	uint32_t type = ofc_global_summary__get_u32(reader);
+	if (reader->failed || (type == OFC_GLOBAL__TYPE_NONE))
+		return NULL;
+
+	if (depth >= OFC_GLOBAL__TYPE_DEPTH)
+	{
+		reader->failed = true;
+		return NULL;
+	}
+
+	const ofc_sema_type_t* stype = NULL;
+	switch (type)
+	{
+		case OFC_SEMA_TYPE_POINTER:
+		case OFC_SEMA_TYPE_FUNCTION:
+		{
+			const ofc_sema_type_t* subtype
+				= ofc_global_summary__get_type(reader, (depth + 1));
+			if (!subtype) break;
+
+			stype = (type == OFC_SEMA_TYPE_POINTER
+				? ofc_sema_type_create_pointer((ofc_sema_type_t*)subtype)
+				: ofc_sema_type_create_function(subtype));
+			break;
+		}
+
+		case OFC_SEMA_TYPE_SUBROUTINE:
+			stype = ofc_sema_type_subroutine();
+			break;
+		case OFC_SEMA_TYPE_TYPE:
+			stype = ofc_sema_type_type();
+			break;
+		case OFC_SEMA_TYPE_RECORD:
+			stype = ofc_sema_type_record();
+			break;
+
+		default:
+		{
+			ofc_sema_kind_e kind = ofc_global_summary__get_u32(reader);
+			unsigned len         = ofc_global_summary__get_u32(reader);
+			bool     len_var     = ofc_global_summary__get_bool(reader);
+			if (reader->failed) break;
+
+			stype = (type == OFC_SEMA_TYPE_CHARACTER
+				? ofc_sema_type_create_character(kind, len, len_var)
+				: ofc_sema_type_create_primitive(type, kind));
+			break;
+		}
+	}
+
+	if (!stype)
+		reader->failed = true;
+	return stype;
+}
+
+static void ofc_global_summary__get_loc(
+	ofc_global_summary__reader_t* reader,
+	ofc_global_loc_t* loc)
+{
+	loc->ref        = OFC_SPARSE_REF_EMPTY;
+	loc->loc.indent = ofc_global_summary__get_u32(reader);
+	loc->loc.head   = ofc_global_summary__get_string(reader, NULL);
+	loc->loc.tail   = ofc_global_summary__get_string(reader, NULL);
+}
+
+static bool ofc_global_summary__get_call(
+	ofc_global_summary__reader_t* reader,
+	ofc_global_call_t* call)
+{
+	memset(call, 0x00, sizeof(ofc_global_call_t));
+
+	call->name = ofc_global_summary__get_str_ref(reader);
+	call->type = ofc_global_summary__get_type(reader, 0);
+	ofc_global_summary__get_loc(reader, &call->src);
+
+	call->args  = ofc_global_summary__get_bool(reader);
+	call->count = ofc_global_summary__get_count(reader);
+	if (reader->failed)
+		return false;
+
+	if (call->count > 0)
+	{
+		call->arg = (ofc_global_actual_t*)calloc(
+			call->count, sizeof(ofc_global_actual_t));
+		if (!call->arg) return false;
+	}
+
+	unsigned i;
+	for (i = 0; i < call->count; i++)
+	{
+		ofc_global_actual_t* arg = &call->arg[i];
+		arg->alt_return = ofc_global_summary__get_bool(reader);
+		arg->external   = ofc_global_summary__get_bool(reader);
+		arg->constant   = ofc_global_summary__get_bool(reader);
+		arg->type       = ofc_global_summary__get_type(reader, 0);
+		ofc_global_summary__get_loc(reader, &arg->src);
+	}
+
+	call->function = ofc_global_summary__get_bool(reader);
+	if (call->function)
+	{
+		call->ret_type = ofc_global_summary__get_type(reader, 0);
+		ofc_global_summary__get_loc(reader, &call->ret_src);
+	}
+
+	return !reader->failed;
+}
+
+static bool ofc_global_summary__get_call_list(
+	ofc_global_summary__reader_t* reader,
+	ofc_global_call_t** call, unsigned* count, unsigned* size)
+{
+	unsigned n = ofc_global_summary__get_count(reader);
+	if (reader->failed)
+		return false;
+
+	if (!ofc_global__call_vector_reserve(call, 0, size, n))
+		return false;
+
+	for (*count = 0; *count < n; (*count)++)
+	{
+		if (!ofc_global_summary__get_call(reader, &(*call)[*count]))
+		{
+			/* Its arguments are freed with the rest. */
+			(*count)++;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+ofc_global_summary_t* ofc_global_summary_read(
+	const void* buff, size_t size)
+{
+	if (!buff)
+		return NULL;
+
+	ofc_global_summary_t* summary
+		= ofc_global_summary__create();
+	if (!summary) return NULL;
+
+	summary->buff = (char*)malloc(size + 1);
+	if (!summary->buff)
+	{
+		ofc_global_summary_delete(summary);
+		return NULL;
+	}
+	memcpy(summary->buff, buff, size);
+
+	ofc_global_summary__reader_t reader =
+		{ .buff = summary->buff, .size = size, .pos = 0, .failed = false };
+
+	unsigned n = ofc_global_summary__get_count(&reader);
+	bool success = !reader.failed
+		&& ofc_global__common_vector_reserve(
+			&summary->common, 0, &summary->common_size, n);
+
+	unsigned i;
+	for (i = 0; success && (i < n); i++)
+	{
+		ofc_global_common_t* common
+			= &summary->common[summary->common_count++];
+		common->name   = ofc_global_summary__get_str_ref(&reader);
+		common->count  = ofc_global_summary__get_count(&reader);
+		common->member = NULL;
+
+		if (!reader.failed && (common->count > 0))
+		{
+			common->member = (ofc_global_member_t*)malloc(
+				sizeof(ofc_global_member_t) * common->count);
+			if (!common->member)
+			{
+				common->count = 0;
+				success = false;
+				break;
+			}
+		}
+
+		unsigned m;
+		for (m = 0; !reader.failed && (m < common->count); m++)
+		{
+			common->member[m].type  = ofc_global_summary__get_type(&reader, 0);
+			common->member[m].sized = ofc_global_summary__get_bool(&reader);
+		}
+		if (reader.failed)
+			common->count = m;
+		success = !reader.failed;
+	}
+
+	success = success
+		&& ofc_global_summary__get_call_list(&reader,
+			&summary->call, &summary->call_count, &summary->call_size)
+		&& ofc_global_summary__get_call_list(&reader,
+			&summary->func, &summary->func_count, &summary->func_size);
+
+	n = (success ? ofc_global_summary__get_count(&reader) : 0);
+	success = success && !reader.failed
+		&& ofc_global__proc_vector_reserve(
+			&summary->proc, 0, &summary->proc_size, n);
+
+	for (i = 0; success && (i < n); i++)
+	{
+		ofc_global_proc_t* proc
+			= &summary->proc[summary->proc_count++];
+		memset(proc, 0x00, sizeof(ofc_global_proc_t));
+
+		proc->type     = ofc_global_summary__get_u32(&reader);
+		proc->name     = ofc_global_summary__get_str_ref(&reader);
+		proc->ret_type = ofc_global_summary__get_type(&reader, 0);
+		proc->args     = ofc_global_summary__get_bool(&reader);
+		proc->count    = ofc_global_summary__get_count(&reader);
+
+		if (!reader.failed && (proc->count > 0))
+		{
+			proc->arg = (ofc_global_dummy_t*)calloc(
+				proc->count, sizeof(ofc_global_dummy_t));
+			if (!proc->arg)
+			{
+				success = false;
+				break;
+			}
+		}
+
+		unsigned a;
+		for (a = 0; !reader.failed && (a < proc->count); a++)
+		{
+			ofc_global_dummy_t* arg = &proc->arg[a];
+			arg->alt_return = ofc_global_summary__get_bool(&reader);
+			arg->declared   = ofc_global_summary__get_bool(&reader);
+			arg->written    = ofc_global_summary__get_bool(&reader);
+			arg->type       = ofc_global_summary__get_type(&reader, 0);
+		}
+
+		success = !reader.failed
+			&& ((proc->type == OFC_SEMA_SCOPE_SUBROUTINE)
+				|| (proc->type == OFC_SEMA_SCOPE_FUNCTION));
+	}
+
+	if (!success || reader.failed
+		|| (reader.pos != reader.size))
+	{
+		ofc_global_summary_delete(summary);
+		return NULL;
+	}
+
+	return summary;
+}
+
+
+ofc_global_summary_list_t* ofc_global_summary_list_create(void)
+{
+	ofc_global_summary_list_t* list
+		= (ofc_global_summary_list_t*)malloc(
+			sizeof(ofc_global_summary_list_t));
+	if (!list) return NULL;
+
+	list->count   = 0;
+	list->size    = 0;
+	list->summary = NULL;
+	return list;
+}
+
+bool ofc_global_summary_list_add(
+	ofc_global_summary_list_t* list,
+	ofc_global_summary_t* summary)
+{
+	if (!list || !summary)
+		return false;
+
+	if (!ofc_global__summary_vector_reserve(
+		&list->summary, list->count, &list->size, 1))
+		return false;
+
+	list->summary[list->count++] = summary;
+	return true;
+}
+
+void ofc_global_summary_list_delete(
+	ofc_global_summary_list_t* list)
+{
+	if (!list)
+		return;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+		ofc_global_summary_delete(list->summary[i]);
+	free(list->summary);
+	free(list);
+}
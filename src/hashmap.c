@@ -18,13 +18,18 @@
 
 #include "ofc/hashmap.h"
 
-typedef struct ofc_hashmap__entry_s ofc_hashmap__entry_t;
+/* Open addressing with linear probing, deletion is done by backward
+   shifting so we never need tombstones. The full hash is kept in each
+   slot so that probing rarely has to call key_compare and growing the
+   table never has to call hash again. */
 
-struct ofc_hashmap__entry_s
+#define OFC_HASHMAP__SIZE_MIN 16
+
+typedef struct
 {
-	void             *item;
-	ofc_hashmap__entry_t *next;
-};
+	void*    item;
+	uint32_t hash;
+} ofc_hashmap__slot_t;
 
 struct ofc_hashmap_s
 {
@@ -33,19 +38,67 @@ struct ofc_hashmap_s
 	ofc_hashmap_item_key_f    item_key;
 	ofc_hashmap_item_delete_f item_delete;
 
-	ofc_hashmap__entry_t* base[256];
+	unsigned             count;
+	unsigned             size;
+	ofc_hashmap__slot_t* slot;
 };
 
 
-static uint8_t ofc_hashmap__hash(const char* key)
+uint32_t ofc_hashmap_hash_bytes(const void* data, unsigned size)
 {
-	uint8_t h = 0;
+	const uint8_t* b = (const uint8_t*)data;
+
+	/* FNV-1a */
+	uint32_t h = 2166136261U;
 	unsigned i;
-	for (i = 0; key[i] != '\0'; i++)
-		h += key[i];
+	for (i = 0; i < size; i++)
+	{
+		h ^= b[i];
+		h *= 16777619U;
+	}
 	return h;
 }
 
+uint32_t ofc_hashmap_hash_bytes_ci(const void* data, unsigned size)
+{
+	const uint8_t* b = (const uint8_t*)data;
+
+	uint32_t h = 2166136261U;
+	unsigned i;
+	for (i = 0; i < size; i++)
+	{
+		uint8_t c = b[i];
+		if ((c >= 'a') && (c <= 'z'))
+			c -= ('a' - 'A');
+		h ^= c;
+		h *= 16777619U;
+	}
+	return h;
+}
+
+uint32_t ofc_hashmap_hash_uint(uintmax_t value)
+{
+	/* Finalizer from MurmurHash3, folded to 32 bits. */
+	uint64_t h = (uint64_t)value;
+	h ^= (h >> 33);
+	h *= 0xFF51AFD7ED558CCDULL;
+	h ^= (h >> 33);
+	h *= 0xC4CEB9FE1A85EC53ULL;
+	h ^= (h >> 33);
+	return (uint32_t)h;
+}
+
+uint32_t ofc_hashmap_hash_ptr(const void* ptr)
+{
+	return ofc_hashmap_hash_uint((uintptr_t)ptr);
+}
+
+
+static uint32_t ofc_hashmap__hash(const char* key)
+{
+	return ofc_hashmap_hash_bytes(key, strlen(key));
+}
+
 static bool ofc_hashmap__key_compare(const char* a, const char* b)
 {
 	return (strcmp(a, b) == 0);
@@ -76,41 +129,75 @@ ofc_hashmap_t* ofc_hashmap_create(
 		: (ofc_hashmap_item_key_f)ofc_hashmap__item_key);
 	map->item_delete = item_delete;
 
-	unsigned i;
-	for (i = 0; i < 256; i++)
-		map->base[i] = NULL;
+	/* The slot array is allocated lazily on first add,
+	   since many maps (e.g. label maps) are never used. */
+	map->count = 0;
+	map->size  = 0;
+	map->slot  = NULL;
 
 	return map;
 }
 
-static void ofc_hashmap__entry_delete(
-	ofc_hashmap__entry_t* entry,
-	ofc_hashmap_item_delete_f item_delete)
+void ofc_hashmap_delete(ofc_hashmap_t* map)
 {
-	if (!entry)
+	if (!map)
 		return;
 
-	ofc_hashmap__entry_delete(
-		entry->next, item_delete);
+	if (map->item_delete)
+	{
+		unsigned i;
+		for (i = 0; i < map->size; i++)
+		{
+			if (map->slot[i].item)
+				map->item_delete(map->slot[i].item);
+		}
+	}
 
-	if (item_delete)
-		item_delete(entry->item);
-	free(entry);
+	free(map->slot);
+	free(map);
 }
 
-void ofc_hashmap_delete(ofc_hashmap_t* map)
+
+static bool ofc_hashmap__resize(
+	ofc_hashmap_t* map, unsigned size)
 {
-	if (!map)
-		return;
+	ofc_hashmap__slot_t* nslot
+		= (ofc_hashmap__slot_t*)calloc(
+			size, sizeof(ofc_hashmap__slot_t));
+	if (!nslot) return false;
+
+	unsigned mask = (size - 1);
 
+	/* Start re-inserting just after an empty slot so that runs
+	   which wrap around the end keep their probe order, this is what
+	   makes the most recently added duplicate key win on find. */
+	unsigned start = 0;
 	unsigned i;
-	for (i = 0; i < 256; i++)
-		ofc_hashmap__entry_delete(
-			map->base[i], map->item_delete);
-	free(map);
-}
+	for (i = 0; i < map->size; i++)
+	{
+		if (!map->slot[i].item)
+		{
+			start = i;
+			break;
+		}
+	}
 
+	for (i = 0; i < map->size; i++)
+	{
+		ofc_hashmap__slot_t* s
+			= &map->slot[(start + i) & (map->size - 1)];
+		if (!s->item) continue;
+
+		unsigned j;
+		for (j = (s->hash & mask); nslot[j].item; j = ((j + 1) & mask));
+		nslot[j] = *s;
+	}
 
+	free(map->slot);
+	map->slot = nslot;
+	map->size = size;
+	return true;
+}
 
 bool ofc_hashmap_add(ofc_hashmap_t* map, void* item)
 {
@@ -122,17 +209,41 @@ bool ofc_hashmap_add(ofc_hashmap_t* map, void* item)
 	const void* key = map->item_key(item);
 	if (!key) return false;
 
-	uint8_t hash = map->hash(key);
+	/* Keep the load factor at or below 3/4. */
+	if (((map->count + 1) * 4) > (map->size * 3))
+	{
+		unsigned nsize = (map->size > 0
+			? (map->size * 2) : OFC_HASHMAP__SIZE_MIN);
+		if (!ofc_hashmap__resize(map, nsize))
+			return false;
+	}
 
-	ofc_hashmap__entry_t* entry
-		= (ofc_hashmap__entry_t*)malloc(
-			sizeof(ofc_hashmap__entry_t));
-	if (!entry) return false;
+	ofc_hashmap__slot_t entry =
+	{
+		.item = item,
+		.hash = map->hash(key),
+	};
 
-	entry->item = item;
-	entry->next = map->base[hash];
-	map->base[hash] = entry;
+	unsigned mask = (map->size - 1);
+	unsigned i;
+	for (i = (entry.hash & mask); map->slot[i].item; i = ((i + 1) & mask))
+	{
+		/* Newer items with an equal key shadow older ones,
+		   so we place the new item first in the probe run. */
+		if ((map->slot[i].hash == entry.hash)
+			&& map->key_compare
+			&& map->key_compare(key,
+				map->item_key(map->slot[i].item)))
+		{
+			ofc_hashmap__slot_t prev = map->slot[i];
+			map->slot[i] = entry;
+			entry = prev;
+			key = map->item_key(entry.item);
+		}
+	}
 
+	map->slot[i] = entry;
+	map->count++;
 	return true;
 }
 
@@ -141,49 +252,64 @@ void ofc_hashmap_remove(
 {
 	if (!map || !item
 		|| !map->item_key
-		|| !map->hash)
+		|| !map->hash
+		|| (map->count == 0))
 		return;
 
 	const void* key = map->item_key(item);
 	if (!key) return;
 
-	uint8_t hash = map->hash(key);
+	uint32_t hash = map->hash(key);
 
-	ofc_hashmap__entry_t* prev;
-	ofc_hashmap__entry_t* node;
-	for (prev = NULL, node = map->base[hash];
-		node && (node->item != item);
-		prev = node, node = node->next);
-	if (!node) return;
+	unsigned mask = (map->size - 1);
+	unsigned i;
+	for (i = (hash & mask); map->slot[i].item
+		&& (map->slot[i].item != item); i = ((i + 1) & mask));
+	if (!map->slot[i].item) return;
+
+	/* Shift following entries back into the hole
+	   unless they're already at or before their home slot. */
+	unsigned j;
+	for (j = ((i + 1) & mask); map->slot[j].item; j = ((j + 1) & mask))
+	{
+		unsigned home = (map->slot[j].hash & mask);
+		if (((j - home) & mask) < ((j - i) & mask))
+			continue;
 
-	if (!prev)
-		map->base[hash] = node->next;
-	else
-		prev->next = node->next;
+		map->slot[i] = map->slot[j];
+		i = j;
+	}
 
-	free(node);
+	map->slot[i].item = NULL;
+	map->slot[i].hash = 0;
+	map->count--;
 }
 
 
 void* ofc_hashmap_find_modify(ofc_hashmap_t* map, const void* key)
 {
 	if (!map || !key
-		|| !map->item_key)
+		|| !map->item_key
+		|| (map->count == 0))
 		return NULL;
 
-	uint8_t hash = map->hash(key);
+	uint32_t hash = map->hash(key);
 
-	ofc_hashmap__entry_t* entry;
-	for (entry = map->base[hash]; entry; entry = entry->next)
+	unsigned mask = (map->size - 1);
+	unsigned i;
+	for (i = (hash & mask); map->slot[i].item; i = ((i + 1) & mask))
 	{
-		const void* ikey = map->item_key(entry->item);
+		if (map->slot[i].hash != hash)
+			continue;
+
+		const void* ikey = map->item_key(map->slot[i].item);
 
 		if (key == ikey)
-			return entry->item;
+			return map->slot[i].item;
 
 		if (map->key_compare
 			&& map->key_compare(key, ikey))
-			return entry->item;
+			return map->slot[i].item;
 	}
 
 	return NULL;
@@ -196,6 +322,11 @@ const void* ofc_hashmap_find(const ofc_hashmap_t* map, const void* key)
 }
 
 
+unsigned ofc_hashmap_count(const ofc_hashmap_t* map)
+{
+	return (map ? map->count : 0);
+}
+
 bool ofc_hashmap_foreach(
 	ofc_hashmap_t* map, void* param,
 	bool (*func)(void* item, void* param))
@@ -204,14 +335,11 @@ bool ofc_hashmap_foreach(
 		return false;
 
 	unsigned i;
-	for (i = 0; i < 256; i++)
+	for (i = 0; i < map->size; i++)
 	{
-		ofc_hashmap__entry_t* entry;
-		for (entry = map->base[i]; entry; entry = entry->next)
-		{
-			if (!func(entry->item, param))
-				return false;
-		}
+		if (map->slot[i].item
+			&& !func(map->slot[i].item, param))
+			return false;
 	}
 
 	return true;
@@ -15,24 +15,32 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ofc/label_table.h"
+#include "ofc/vector.h"
 
-typedef struct label_s label_t;
-
-struct label_s
+typedef struct
 {
 	unsigned offset;
 	unsigned number;
+} label_t;
 
-	label_t* next;
-};
-
+/* Labels are kept sorted by offset, they're nearly always added in order. */
 struct ofc_label_table_s
 {
-	label_t* base[256];
+	unsigned count, size;
+	label_t* label;
 };
 
+OFC_VECTOR_DEFINE(ofc_label_table__vector, label_t)
+
+
+/* Statements are parsed in order, so each lookup is usually at
+   or just after the last one made on the same thread. */
+static __thread const ofc_label_table_t* ofc_label_table__cursor_table = NULL;
+static __thread unsigned                 ofc_label_table__cursor       = 0;
+
 
 ofc_label_table_t* ofc_label_table_create(void)
 {
@@ -41,38 +49,41 @@ ofc_label_table_t* ofc_label_table_create(void)
 			sizeof(ofc_label_table_t));
 	if (!table) return NULL;
 
-	unsigned i;
-	for (i = 0; i < 256; i++)
-		table->base[i] = NULL;
+	table->count     = 0;
+	table->size      = 0;
+	table->label     = NULL;
 	return table;
 }
 
-static void label__delete(label_t* label)
-{
-	if (!label)
-		return;
-	label__delete(label->next);
-	free(label);
-}
-
 void ofc_label_table_delete(ofc_label_table_t* table)
 {
 	if (!table)
 		return;
 
-	unsigned i;
-	for (i = 0; i < 256; i++)
-		label__delete(table->base[i]);
+	if (ofc_label_table__cursor_table == table)
+		ofc_label_table__cursor_table = NULL;
+
+	free(table->label);
 	free(table);
 }
 
 
-static uint8_t ofc_label_table__offset_hash(unsigned offset)
+unsigned ofc_label_table_lower_bound(
+	const ofc_label_table_t* table, unsigned offset)
 {
-	uint32_t h = (offset & 0xFFFFFFFFU);
-	h = (h & 0x0000FFFF) ^ (h >> 16U);
-	h = (h & 0x000000FF) ^ (h >>  8U);
-	return h;
+	if (!table)
+		return 0;
+
+	unsigned lo = 0, hi = table->count;
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) / 2);
+		if (table->label[mid].offset < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
 }
 
 bool ofc_label_table_add(
@@ -81,20 +92,25 @@ bool ofc_label_table_add(
 	if (!table)
 		return false;
 
-	/* Don't allow duplicate labels at the same position. */
-	if (ofc_label_table_find(table, offset, NULL))
-		return false;
-
-	uint8_t hash = ofc_label_table__offset_hash(offset);
+	unsigned i = table->count;
+	if ((i > 0) && (table->label[i - 1].offset >= offset))
+	{
+		i = ofc_label_table_lower_bound(table, offset);
 
-	label_t* label = (label_t*)malloc(sizeof(label_t));
-	if (!label) return false;
+		/* Don't allow duplicate labels at the same position. */
+		if (table->label[i].offset == offset)
+			return false;
+	}
 
-	label->offset = offset;
-	label->number = number;
-	label->next   = table->base[hash];
+	if (!ofc_label_table__vector_reserve(
+		&table->label, table->count, &table->size, 1))
+		return false;
 
-	table->base[hash] = label;
+	memmove(&table->label[i + 1], &table->label[i],
+		(sizeof(label_t) * (table->count - i)));
+	table->label[i].offset = offset;
+	table->label[i].number = number;
+	table->count++;
 
 	return true;
 }
@@ -102,20 +118,45 @@ bool ofc_label_table_add(
 bool ofc_label_table_find(
 	const ofc_label_table_t* table, unsigned offset, unsigned* number)
 {
-	if (!table)
+	if (!table || (table->count == 0))
 		return false;
 
-	uint8_t hash = ofc_label_table__offset_hash(offset);
+	unsigned i = ofc_label_table__cursor;
+	if ((ofc_label_table__cursor_table != table)
+		|| (i >= table->count)
+		|| (table->label[i].offset > offset)
+		|| (((i + 1) < table->count)
+			&& (table->label[i + 1].offset < offset)))
+		i = ofc_label_table_lower_bound(table, offset);
+	else if (table->label[i].offset < offset)
+		i++;
+
+	ofc_label_table__cursor_table = table;
+	ofc_label_table__cursor       = i;
+
+	if ((i >= table->count)
+		|| (table->label[i].offset != offset))
+		return false;
 
-	label_t* label;
-	for (label = table->base[hash]; label; label = label->next)
-	{
-		if (label->offset == offset)
-		{
-			if (number) *number = label->number;
-			return true;
-		}
-	}
+	if (number) *number = table->label[i].number;
+	return true;
+}
+
+
+unsigned ofc_label_table_count(
+	const ofc_label_table_t* table)
+{
+	return (table ? table->count : 0);
+}
 
-	return false;
+bool ofc_label_table_get(
+	const ofc_label_table_t* table, unsigned index,
+	unsigned* offset, unsigned* number)
+{
+	if (!table || (index >= table->count))
+		return false;
+
+	if (offset) *offset = table->label[index].offset;
+	if (number) *number = table->label[index].number;
+	return true;
 }
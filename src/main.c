@@ -13,10 +13,13 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <stdint.h>
+#include <sys/stat.h>
 
 #include "ofc/file.h"
 #include "ofc/parse/file.h"
@@ -24,46 +27,944 @@
 #include "ofc/sema.h"
 #include "ofc/global.h"
 #include "ofc/cliarg.h"
+#include "ofc/thread_pool.h"
+#include "ofc/cache.h"
+#include "ofc/vector.h"
 
 ofc_global_opts_t global_opts;
 
-int main(int argc, const char* argv[])
+
+typedef struct ofc__batch_s ofc__batch_t;
+
+typedef struct
 {
-	global_opts = OFC_GLOBAL_OPTS_DEFAULT;
+	ofc__batch_t* batch;
+	unsigned      index;
 
-	ofc_print_opts_t print_opts         = OFC_PRINT_OPTS_DEFAULT;
-	ofc_sema_pass_opts_t sema_pass_opts = OFC_SEMA_PASS_OPTS_DEFAULT;
+	ofc_file_t*       file;
+	ofc_parse_file_t* program;
+	ofc_sema_scope_t* sema;
 
-	ofc_file_list_t* file_list = ofc_file_list_create();
+	ofc_sema_pass_stats_t pass_stats;
+	ofc_global_summary_t* summary;
 
-	if (!ofc_cliarg_parse(argc, argv, &file_list,
-		&print_opts, &global_opts, &sema_pass_opts))
+	/* Diagnostics are captured until the job is committed, those
+	   before diag_parse_size are reported before the parse tree. */
+	FILE*  diag_stream;
+	char*  diag;
+	size_t diag_size;
+	size_t diag_parse_size;
+
+	bool done;
+	bool failed;
+	/* Replayed from the cache rather than processed. */
+	bool cached;
+} ofc__job_t;
+
+struct ofc__batch_s
+{
+	ofc_sema_scope_t*     super;
+	ofc_sema_pass_opts_t* sema_pass_opts;
+	ofc_cache_t*          cache;
+
+	/* Summaries are added for the global passes as jobs commit. */
+	ofc_global_summary_list_t* summaries;
+
+	pthread_mutex_t lock;
+	pthread_cond_t  cond;
+
+	/* Jobs before this index have been reported and attached to super. */
+	unsigned committed;
+	bool     abort;
+
+	unsigned    count;
+	ofc__job_t* job;
+};
+
+
+static void ofc__stats_print_arena(
+	const char* path, const char* phase,
+	ofc_arena_stats_t stats)
+{
+	fprintf(stderr, "%s: %s: %zu bytes used, %zu live, %zu reserved"
+		" (%u nodes, %u chunks)\n", path, phase,
+		stats.used, stats.live, stats.reserved,
+		stats.nodes, stats.chunks);
+}
+
+static bool ofc__stats_sum_arena(
+	const ofc_sema_scope_t* scope,
+	ofc_arena_stats_t* total)
+{
+	ofc_arena_stats_t stats;
+	if (!ofc_arena_stats(scope->arena, &stats))
+		return true;
+
+	total->reserved += stats.reserved;
+	total->used     += stats.used;
+	total->live     += stats.live;
+	total->nodes    += stats.nodes;
+	total->chunks   += stats.chunks;
+	return true;
+}
+
+static void ofc__stats_print(
+	const ofc_file_t* file,
+	const ofc_parse_file_t* program,
+	const ofc_sema_scope_t* sema,
+	const ofc_sema_pass_stats_t* pass_stats)
+{
+	const char* path = ofc_file_get_path(file);
+	if (!path) path = "<unknown>";
+
+	if (!program && sema)
+		program = sema->file;
+
+	if (program)
 	{
-		ofc_file_list_delete(file_list);
-		return EXIT_FAILURE;
+		fprintf(stderr, "%s: parse: %u statement parser attempts,"
+			" %u rewinds\n", path, program->attempts, program->rewinds);
+		fprintf(stderr, "%s: parse: %u sub-parser calls,"
+			" %u memo hits\n", path, program->memo_calls, program->memo_hits);
+		ofc_arena_stats_t stats;
+		if (ofc_arena_stats(program->arena, &stats))
+			ofc__stats_print_arena(path, "parse", stats);
+	}
+	if (sema)
+	{
+		/* Units analysed with --unit-jobs have arenas of their own. */
+		ofc_arena_stats_t stats = { 0 };
+		ofc_sema_scope_foreach_scope(
+			(ofc_sema_scope_t*)sema, &stats,
+			(void*)ofc__stats_sum_arena);
+		if (sema->arena)
+			ofc__stats_print_arena(path, "sema", stats);
+	}
+
+	if (pass_stats)
+	{
+		unsigned i;
+		for (i = 0; i < OFC_SEMA_PASS_COUNT; i++)
+		{
+			if (!pass_stats->pass[i].run)
+				continue;
+
+			fprintf(stderr, "%s: pass: %s: %u nodes, %.3f ms\n",
+				path, pass_stats->pass[i].desc,
+				pass_stats->pass[i].nodes,
+				(pass_stats->pass[i].time * 1000.0));
+		}
+	}
+}
+
+
+static bool ofc__job_wait_turn(ofc__job_t* job)
+{
+	ofc__batch_t* batch = job->batch;
+
+	pthread_mutex_lock(&batch->lock);
+	while ((batch->committed < job->index)
+		&& !batch->abort)
+		pthread_cond_wait(&batch->cond, &batch->lock);
+	bool abort = batch->abort;
+	pthread_mutex_unlock(&batch->lock);
+
+	return !abort;
+}
+
+static bool ofc__job_process(ofc__job_t* job)
+{
+	ofc_sparse_t* condense = ofc_prep(job->file);
+	if (!condense)
+	{
+		if (ofc_file_no_errors())
+			ofc_file_error(job->file, NULL, "Failed to preprocess source file");
+		return false;
+	}
+
+	job->program = ofc_parse_file(condense);
+	if (!job->program)
+	{
+		if (ofc_file_no_errors())
+			ofc_file_error(job->file, NULL, "Failed to parse program");
+		ofc_sparse_delete(condense);
+		return false;
+	}
+
+	if (job->diag_stream)
+	{
+		fflush(job->diag_stream);
+		job->diag_parse_size = job->diag_size;
+	}
+
+	/* USE looks for modules in the files attached to super,
+	   so to see the same modules as a serial run we must wait
+	   for every earlier file to be attached. */
+	if (ofc_parse_stmt_list_contains_use(job->program->stmt)
+		&& !ofc__job_wait_turn(job))
+		return false;
+
+	if (!global_opts.parse_only)
+	{
+		job->sema = ofc_sema_scope_global_detached(
+			job->batch->super, job->program);
+		if (!job->sema)
+		{
+			if (ofc_file_no_errors())
+				ofc_file_error(job->file, NULL, "Program failed semantic analysis");
+			return false;
+		}
+	}
+
+	if (!ofc_sema_run_passes(
+		job->file, job->batch->sema_pass_opts, job->sema,
+		(global_opts.stats_print ? &job->pass_stats : NULL)))
+		return false;
+
+	if (job->sema)
+	{
+		job->summary = ofc_global_summary_create(job->sema);
+		if (!job->summary) return false;
+	}
+
+	return true;
+}
+
+static void ofc__job_run(ofc__job_t* job)
+{
+	ofc__batch_t* batch = job->batch;
+
+	pthread_mutex_lock(&batch->lock);
+	bool abort = batch->abort;
+	pthread_mutex_unlock(&batch->lock);
+
+	if (abort)
+	{
+		job->failed = true;
+	}
+	else
+	{
+		job->diag_stream = open_memstream(
+			&job->diag, &job->diag_size);
+		ofc_file_diag_capture(job->diag_stream);
+		job->failed = !ofc__job_process(job);
+		ofc_file_diag_capture(NULL);
+		if (job->diag_stream)
+			fclose(job->diag_stream);
+		job->diag_stream = NULL;
+	}
+
+	pthread_mutex_lock(&batch->lock);
+	job->done = true;
+	pthread_cond_broadcast(&batch->cond);
+	pthread_mutex_unlock(&batch->lock);
+}
+
+static bool ofc__job_commit(
+	ofc__job_t* job, ofc_print_opts_t print_opts)
+{
+	ofc__batch_t* batch = job->batch;
+
+	pthread_mutex_lock(&batch->lock);
+	while (!job->done)
+		pthread_cond_wait(&batch->cond, &batch->lock);
+	pthread_mutex_unlock(&batch->lock);
+
+	if (job->cached)
+	{
+		ofc_global_summary_t* summary = NULL;
+		if (!ofc_cache_file_replay(batch->cache, &summary))
+			return false;
+
+		if (summary && !ofc_global_summary_list_add(
+			batch->summaries, summary))
+		{
+			ofc_global_summary_delete(summary);
+			return false;
+		}
+		return true;
+	}
+
+	/* Report in the order a serial run would, the diagnostics from
+	   preprocessing and parsing come before the parse tree and those
+	   from semantic analysis after it. */
+	size_t parse_size = job->diag_size;
+	if (global_opts.parse_print && job->program
+		&& (job->diag_parse_size < parse_size))
+		parse_size = job->diag_parse_size;
+
+	if (job->diag && (parse_size > 0))
+		fwrite(job->diag, 1, parse_size, stderr);
+
+	if (global_opts.parse_print && job->program)
+	{
+		ofc_colstr_t* cs = ofc_colstr_create_fd(print_opts, 72, 0, STDOUT_FILENO);
+		if (!ofc_parse_file_print(cs, job->program))
+		{
+			ofc_file_error(job->file, NULL, "Failed to print parse tree");
+			ofc_colstr_delete(cs);
+			free(job->diag);
+			job->diag = NULL;
+			return false;
+		}
+		ofc_colstr_flush(cs);
+		ofc_colstr_delete(cs);
+	}
+
+	if (job->diag)
+	{
+		if (job->diag_size > parse_size)
+			fwrite(&job->diag[parse_size], 1,
+				(job->diag_size - parse_size), stderr);
+		free(job->diag);
+		job->diag = NULL;
+	}
+
+	if (job->failed)
+		return false;
+
+	ofc_cache_file_done(batch->cache,
+		job->program, job->summary);
+
+	if (job->sema)
+	{
+		if (!ofc_sema_scope_global_attach(
+			batch->super, job->sema, job->program))
+			return false;
+		job->program = NULL;
+	}
+
+	if (job->summary)
+	{
+		if (!ofc_global_summary_list_add(
+			batch->summaries, job->summary))
+			return false;
+		job->summary = NULL;
+	}
+
+	if (global_opts.sema_print)
+	{
+		ofc_colstr_t* cs = ofc_colstr_create_fd(print_opts, 72, 0, STDOUT_FILENO);
+		if (!ofc_sema_scope_print(cs, 0, job->sema))
+		{
+			ofc_file_error(job->file, NULL, "Failed to print semantic tree");
+			ofc_colstr_delete(cs);
+			return false;
+		}
+		ofc_colstr_flush(cs);
+		ofc_colstr_delete(cs);
+	}
+
+	if (global_opts.common_usage_print)
+	{
+		const char* path = ofc_file_get_path(job->file);
+		if (path) printf("%s:\n", path);
+		ofc_sema_scope_common_usage_print(job->sema);
+	}
+
+	if (global_opts.stats_print)
+		ofc__stats_print(job->file, job->program,
+			job->sema, &job->pass_stats);
+
+	return true;
+}
+
+/* Runs the per-file front-end on a thread pool, results are reported
+   and attached to super strictly in file order so that output is the
+   same as a serial run. */
+static bool ofc__process_parallel(
+	ofc_file_list_t* file_list,
+	ofc_sema_scope_t* super,
+	ofc_print_opts_t print_opts,
+	ofc_sema_pass_opts_t* sema_pass_opts,
+	ofc_cache_t* cache,
+	ofc_global_summary_list_t* summaries)
+{
+	ofc__batch_t batch =
+	{
+		.super          = super,
+		.sema_pass_opts = sema_pass_opts,
+		.cache          = cache,
+		.summaries      = summaries,
+		.committed      = 0,
+		.abort          = false,
+		.count          = file_list->count,
+	};
+
+	batch.job = (ofc__job_t*)calloc(
+		batch.count, sizeof(ofc__job_t));
+	if (!batch.job) return false;
+
+	pthread_mutex_init(&batch.lock, NULL);
+	pthread_cond_init(&batch.cond, NULL);
+
+	/* Freeze shared tables before any worker can race to build them. */
+	ofc_sema_intrinsic_init();
+
+	unsigned threads = global_opts.jobs;
+	if (threads > batch.count)
+		threads = batch.count;
+
+	ofc_thread_pool_t* pool
+		= ofc_thread_pool_create(threads);
+	bool success = (pool != NULL);
+
+	unsigned queued;
+	for (queued = 0; success && (queued < batch.count); queued++)
+	{
+		ofc__job_t* job = &batch.job[queued];
+		job->batch = &batch;
+		job->index = queued;
+		job->file  = file_list->file[queued];
+
+		if (ofc_cache_file_hit(cache, queued))
+		{
+			job->cached = true;
+			job->done   = true;
+			continue;
+		}
+
+		success = ofc_thread_pool_add(pool,
+			(ofc_thread_pool_job_f)ofc__job_run, job);
+		if (!success) break;
+	}
+
+	unsigned i;
+	for (i = 0; success && (i < queued); i++)
+	{
+		success = ofc__job_commit(
+			&batch.job[i], print_opts);
+
+		pthread_mutex_lock(&batch.lock);
+		if (success)
+			batch.committed = (i + 1);
+		else
+			batch.abort = true;
+		pthread_cond_broadcast(&batch.cond);
+		pthread_mutex_unlock(&batch.lock);
+	}
+
+	if (!success)
+	{
+		pthread_mutex_lock(&batch.lock);
+		batch.abort = true;
+		pthread_cond_broadcast(&batch.cond);
+		pthread_mutex_unlock(&batch.lock);
+	}
+
+	ofc_thread_pool_delete(pool);
+
+	/* Anything left wasn't attached to super. */
+	for (i = 0; i < queued; i++)
+	{
+		ofc__job_t* job = &batch.job[i];
+		if (i >= batch.committed)
+			ofc_sema_scope_delete(job->sema);
+		ofc_parse_file_delete(job->program);
+		ofc_global_summary_delete(job->summary);
+		free(job->diag);
+	}
+
+	pthread_cond_destroy(&batch.cond);
+	pthread_mutex_destroy(&batch.lock);
+	free(batch.job);
+	return success;
+}
+
+/* State kept by --watch for each file, a file is analysed again
+   when the file or one of its include files changes on disk. */
+typedef struct
+{
+	ofc_sema_scope_t* sema;
+
+	/* The file and the include files it read, referenced so that
+	   their text can be compared with the text read next time. */
+	char**       path;
+	ofc_file_t** file;
+	unsigned     path_count, path_size, file_size;
+	uint64_t     stamp;
+
+	/* Set when a module this file USEs changed. */
+	bool dirty;
+	/* Set when the file last failed to analyse. */
+	bool failed;
+} ofc__watch_file_t;
+
+OFC_VECTOR_DEFINE(ofc__watch_path_vector, char*)
+OFC_VECTOR_DEFINE(ofc__watch_file_vector, ofc_file_t*)
+
+static void ofc__watch_file_clear(ofc__watch_file_t* wfile)
+{
+	unsigned i;
+	for (i = 0; i < wfile->path_count; i++)
+	{
+		free(wfile->path[i]);
+		ofc_file_delete(wfile->file[i]);
+	}
+	free(wfile->path);
+	free(wfile->file);
+
+	wfile->path       = NULL;
+	wfile->file       = NULL;
+	wfile->path_count = 0;
+	wfile->path_size  = 0;
+	wfile->file_size  = 0;
+}
+
+static bool ofc__watch_path_add(
+	ofc_file_t* file, ofc__watch_file_t* wfile)
+{
+	const char* path = ofc_file_get_path(file);
+	if (!path)
+		return false;
+
+	if (!ofc__watch_path_vector_reserve(
+			&wfile->path, wfile->path_count, &wfile->path_size, 1)
+		|| !ofc__watch_file_vector_reserve(
+			&wfile->file, wfile->path_count, &wfile->file_size, 1))
+		return false;
+
+	wfile->path[wfile->path_count] = strdup(path);
+	if (!wfile->path[wfile->path_count])
+		return false;
+
+	if (!ofc_file_reference(file))
+	{
+		free(wfile->path[wfile->path_count]);
+		return false;
+	}
+	wfile->file[wfile->path_count] = file;
+	wfile->path_count++;
+	return true;
+}
+
+static bool ofc__watch_file_set(
+	ofc__watch_file_t* wfile,
+	ofc_file_t* file,
+	const ofc_parse_file_t* program)
+{
+	ofc__watch_file_clear(wfile);
+
+	if (!ofc__watch_path_add(file, wfile))
+		return false;
+
+	const ofc_parse_stmt_list_t* list = program->stmt;
+	unsigned i;
+	for (i = 0; list && (i < list->count); i++)
+	{
+		if (!ofc_parse_stmt_include_foreach(list->stmt[i],
+			wfile, (void*)ofc__watch_path_add))
+			return false;
+	}
+
+	return true;
+}
+
+static uint64_t ofc__watch_stamp(const ofc__watch_file_t* wfile)
+{
+	/* FNV-1a over the size and modification time of each path. */
+	uint64_t stamp = 14695981039346656037ULL;
+
+	unsigned i;
+	for (i = 0; i < wfile->path_count; i++)
+	{
+		struct stat fs;
+		uint64_t v[3] = { 0, 0, 0 };
+		if (stat(wfile->path[i], &fs) == 0)
+		{
+			v[0] = fs.st_size;
+			v[1] = fs.st_mtim.tv_sec;
+			v[2] = fs.st_mtim.tv_nsec;
+		}
+
+		unsigned j;
+		for (j = 0; j < 3; j++)
+		{
+			stamp ^= v[j];
+			stamp *= 1099511628211ULL;
+		}
+	}
+
+	return stamp;
+}
+
+/* True when the file and its include files read the same as before,
+   so the existing analysis and its source positions still hold. */
+static bool ofc__watch_text_equal(
+	const ofc__watch_file_t* prev,
+	const ofc__watch_file_t* wfile)
+{
+	if (prev->path_count != wfile->path_count)
+		return false;
+
+	unsigned i;
+	for (i = 0; i < wfile->path_count; i++)
+	{
+		unsigned size = ofc_file_get_size(wfile->file[i]);
+		if ((strcmp(prev->path[i], wfile->path[i]) != 0)
+			|| (ofc_file_get_size(prev->file[i]) != size)
+			|| (memcmp(ofc_file_get_strz(prev->file[i]),
+				ofc_file_get_strz(wfile->file[i]), size) != 0))
+			return false;
 	}
 
+	return true;
+}
+
+static unsigned ofc__watch_units_changed(
+	const ofc_parse_file_t* prev,
+	const ofc_parse_file_t* program,
+	bool* module_changed)
+{
+	unsigned changed = 0;
+	*module_changed = false;
+
+	const ofc_parse_stmt_list_t* plist
+		= (prev ? prev->stmt : NULL);
+	const ofc_parse_stmt_list_t* list
+		= program->stmt;
+	unsigned pcount = (plist ? plist->count : 0);
+	unsigned count  = (list ? list->count : 0);
+
+	unsigned i;
+	for (i = 0; (i < count) || (i < pcount); i++)
+	{
+		const ofc_parse_stmt_t* pstmt
+			= (i < pcount ? plist->stmt[i] : NULL);
+		const ofc_parse_stmt_t* stmt
+			= (i < count ? list->stmt[i] : NULL);
+		if (pstmt && stmt
+			&& ofc_parse_stmt_text_equal(pstmt, stmt))
+			continue;
+
+		changed++;
+		if ((stmt && (stmt->type == OFC_PARSE_STMT_MODULE))
+			|| (pstmt && (pstmt->type == OFC_PARSE_STMT_MODULE)))
+			*module_changed = true;
+	}
+
+	return changed;
+}
+
+/* A retired scope is released once neither a watched file nor another
+   retired scope USEs its modules, along with its symbol table, so that
+   editing files over a long session doesn't keep every old analysis. */
+static void ofc__watch_retired_release(
+	const ofc__watch_file_t* watch, unsigned count,
+	ofc_sema_scope_list_t* retired)
+{
+	bool released = true;
+	while (released)
+	{
+		released = false;
+
+		unsigned i;
+		for (i = 0; i < retired->count; i++)
+		{
+			ofc_sema_scope_t* old = retired->scope[i];
+
+			bool in_use = false;
+			unsigned j;
+			for (j = 0; !in_use && (j < count); j++)
+				in_use = ofc_sema_scope_uses_module_of(watch[j].sema, old);
+			for (j = 0; !in_use && (j < retired->count); j++)
+			{
+				in_use = ((j != i) && ofc_sema_scope_uses_module_of(
+					retired->scope[j], old));
+			}
+			if (in_use) continue;
+
+			ofc_sema_scope_delete(old);
+			retired->scope[i] = retired->scope[--retired->count];
+			released = true;
+			break;
+		}
+	}
+}
+
+/* Analyses a file again, replacing its global scope in super.
+   Returns false only when out of memory, a file which fails to
+   analyse keeps its previous scope until it changes again. */
+static bool ofc__watch_update(
+	ofc__watch_file_t* watch, unsigned count, unsigned index,
+	ofc_file_list_t* file_list, ofc_sema_scope_t* super,
+	ofc_sema_scope_list_t* retired,
+	ofc_print_opts_t print_opts,
+	ofc_sema_pass_opts_t* sema_pass_opts)
+{
+	ofc__watch_file_t* wfile = &watch[index];
+
+	bool force = (wfile->dirty || wfile->failed);
+	wfile->dirty  = false;
+	wfile->failed = true;
+	wfile->stamp  = ofc__watch_stamp(wfile);
+
+	ofc_file_t* file = ofc_file_reload(
+		file_list->file[index]);
+	if (!file) return true;
+
+	ofc_sparse_t* condense = ofc_prep(file);
+	if (!condense)
+	{
+		if (ofc_file_no_errors())
+			ofc_file_error(file, NULL, "Failed to preprocess source file");
+		ofc_file_delete(file);
+		return true;
+	}
+
+	ofc_parse_file_t* program
+		= ofc_parse_file(condense);
+	if (!program)
+	{
+		if (ofc_file_no_errors())
+			ofc_file_error(file, NULL, "Failed to parse program");
+		ofc_sparse_delete(condense);
+		ofc_file_delete(file);
+		return true;
+	}
+
+	ofc__watch_file_t next = { 0 };
+	if (!ofc__watch_file_set(&next, file, program))
+	{
+		ofc__watch_file_clear(&next);
+		ofc_parse_file_delete(program);
+		ofc_file_delete(file);
+		return false;
+	}
+
+	/* Only the modification times changed. */
+	if (!force && ofc__watch_text_equal(wfile, &next))
+	{
+		wfile->failed = false;
+		ofc__watch_file_clear(&next);
+		ofc_parse_file_delete(program);
+		ofc_file_delete(file);
+		return true;
+	}
+
+	ofc__watch_file_clear(wfile);
+	wfile->path       = next.path;
+	wfile->file       = next.file;
+	wfile->path_count = next.path_count;
+	wfile->path_size  = next.path_size;
+	wfile->file_size  = next.file_size;
+	wfile->stamp      = ofc__watch_stamp(wfile);
+
+	/* Program units whose text and position are unchanged are shared
+	   with the last analysis, when the file is made of units which can
+	   be analysed apart. Otherwise the whole file is analysed again so
+	   that source positions follow the new text. Files which USE its
+	   modules are only analysed again if one changed. */
+	bool module_changed;
+	unsigned changed = ofc__watch_units_changed(
+		wfile->sema->file, program, &module_changed);
+
+	if (global_opts.stats_print)
+	{
+		const char* path = ofc_file_get_path(file);
+		fprintf(stderr, "%s: watch: %u of %u program units changed\n",
+			(path ? path : "<unknown>"), changed,
+			(program->stmt ? program->stmt->count : 0));
+	}
+
+	unsigned shared = 0;
+	ofc_sema_scope_t* sema
+		= ofc_sema_scope_global_update(
+			super, program, wfile->sema, &shared);
+	if (!sema)
+	{
+		if (ofc_file_no_errors())
+			ofc_file_error(file, NULL, "Program failed semantic analysis");
+		ofc_parse_file_delete(program);
+		ofc_file_delete(file);
+		return true;
+	}
+
+	if (global_opts.stats_print)
+	{
+		const char* path = ofc_file_get_path(file);
+		fprintf(stderr, "%s: watch: %u program units reused\n",
+			(path ? path : "<unknown>"), shared);
+	}
+
+	if (!ofc_sema_run_passes(file, sema_pass_opts, sema, NULL)
+		|| !ofc_sema_scope_global_replace(
+			super, wfile->sema, sema, program))
+	{
+		ofc_sema_scope_delete(sema);
+		ofc_parse_file_delete(program);
+		ofc_file_delete(file);
+		return true;
+	}
+
+	ofc_file_delete(file_list->file[index]);
+	file_list->file[index] = file;
+	wfile->failed = false;
+
+	/* Files which USE a module from the old scope still refer to it,
+	   so it's retired until none do. */
+	ofc_sema_scope_t* old = wfile->sema;
+	wfile->sema = sema;
+
+	unsigned i;
+	for (i = 0; module_changed && (i < count); i++)
+	{
+		if ((i != index)
+			&& ofc_sema_scope_uses_module_of(watch[i].sema, old))
+			watch[i].dirty = true;
+	}
+
+	if (!ofc_sema_scope_list_add(retired, old))
+		return false;
+
+	if (global_opts.sema_print)
+	{
+		ofc_colstr_t* cs = ofc_colstr_create_fd(print_opts, 72, 0, STDOUT_FILENO);
+		if (ofc_sema_scope_print(cs, 0, sema))
+			ofc_colstr_flush(cs);
+		ofc_colstr_delete(cs);
+	}
+
+	if (global_opts.common_usage_print)
+	{
+		const char* path = ofc_file_get_path(file);
+		if (path) printf("%s:\n", path);
+		ofc_sema_scope_common_usage_print(sema);
+	}
+
+	if (global_opts.stats_print)
+		ofc__stats_print(file, NULL, sema, NULL);
+
+	return true;
+}
+
+/* Runs until killed, unless out of memory. */
+static bool ofc__watch(
+	ofc_file_list_t* file_list,
+	ofc_sema_scope_t* super,
+	ofc_print_opts_t print_opts,
+	ofc_sema_pass_opts_t* sema_pass_opts)
+{
+	/* Each file's global scope is attached to super in file order. */
+	unsigned count = file_list->count;
+	if (!super->child || (super->child->count != count))
+		return false;
+
+	ofc_sema_scope_list_t* retired
+		= ofc_sema_scope_list_create();
+	ofc__watch_file_t* watch = (ofc__watch_file_t*)calloc(
+		count, sizeof(ofc__watch_file_t));
+	if (!retired || !watch)
+	{
+		ofc_sema_scope_list_delete(retired);
+		free(watch);
+		return false;
+	}
+
+	bool success = true;
+	unsigned i;
+	for (i = 0; success && (i < count); i++)
+	{
+		watch[i].sema = super->child->scope[i];
+		success = ofc__watch_file_set(&watch[i],
+			file_list->file[i], watch[i].sema->file);
+		watch[i].stamp = ofc__watch_stamp(&watch[i]);
+	}
+
+	while (success)
+	{
+		sleep(1);
+
+		bool updated = false;
+		bool dirty = true;
+		while (success && dirty)
+		{
+			dirty = false;
+			for (i = 0; success && (i < count); i++)
+			{
+				uint64_t stamp = ofc__watch_stamp(&watch[i]);
+				if ((stamp == watch[i].stamp)
+					&& !watch[i].dirty)
+					continue;
+
+				success = ofc__watch_update(
+					watch, count, i, file_list, super, retired,
+					print_opts, sema_pass_opts);
+				updated = true;
+			}
+
+			for (i = 0; i < count; i++)
+				dirty = (dirty || watch[i].dirty);
+		}
+
+		if (success && updated)
+		{
+			ofc__watch_retired_release(watch, count, retired);
+			success = ofc_global_pass_common(super)
+				&& ofc_global_pass_args(super);
+		}
+	}
+
+	for (i = 0; i < count; i++)
+		ofc__watch_file_clear(&watch[i]);
+	free(watch);
+	ofc_sema_scope_list_delete(retired);
+	return false;
+}
+
+static bool ofc__run(
+	ofc_file_list_t* file_list,
+	ofc_print_opts_t print_opts,
+	ofc_sema_pass_opts_t* sema_pass_opts,
+	ofc_cache_t* cache,
+	ofc_global_summary_list_t* summaries)
+{
 	ofc_sema_scope_t* super
 		= ofc_sema_scope_super();
 	if (!super)
 	{
-		ofc_file_list_delete(file_list);
-		return EXIT_FAILURE;
+		return false;
+	}
+
+	unsigned serial_count = file_list->count;
+	if ((global_opts.jobs > 1)
+		&& (file_list->count > 1))
+	{
+		if (!ofc__process_parallel(file_list, super,
+			print_opts, sema_pass_opts, cache, summaries))
+		{
+			ofc_sema_scope_delete(super);
+			return false;
+		}
+		serial_count = 0;
 	}
 
 	unsigned i;
-	for (i = 0; i < file_list->count; i++)
+	for (i = 0; i < serial_count; i++)
 	{
 		ofc_file_t* file = file_list->file[i];
 
+		ofc_global_summary_t* summary = NULL;
+		if (ofc_cache_file_hit(cache, i))
+		{
+			if (!ofc_cache_file_replay(cache, &summary)
+				|| (summary && !ofc_global_summary_list_add(
+					summaries, summary)))
+			{
+				ofc_global_summary_delete(summary);
+				ofc_sema_scope_delete(super);
+				return false;
+			}
+			continue;
+		}
+
 		ofc_sparse_t* condense = ofc_prep(file);
 		if (!condense)
 		{
 			if (ofc_file_no_errors())
 				ofc_file_error(file, NULL, "Failed to preprocess source file");
 			ofc_sema_scope_delete(super);
-			ofc_file_list_delete(file_list);
-			return EXIT_FAILURE;
+			return false;
 		}
 
 		ofc_parse_file_t* program
@@ -74,22 +975,20 @@ int main(int argc, const char* argv[])
 				ofc_file_error(file, NULL, "Failed to parse program");
 			ofc_sparse_delete(condense);
 			ofc_sema_scope_delete(super);
-			ofc_file_list_delete(file_list);
-			return EXIT_FAILURE;
+			return false;
 		}
 
 		if (global_opts.parse_print)
 		{
-			ofc_colstr_t* cs = ofc_colstr_create(print_opts, 72, 0);
+			ofc_colstr_t* cs = ofc_colstr_create_fd(print_opts, 72, 0, STDOUT_FILENO);
 			if (!ofc_parse_file_print(cs, program))
 			{
 				ofc_file_error(file, NULL, "Failed to print parse tree");
 				ofc_parse_file_delete(program);
 				ofc_sema_scope_delete(super);
-				ofc_file_list_delete(file_list);
-				return EXIT_FAILURE;
+				return false;
 			}
-			ofc_colstr_fdprint(cs, STDOUT_FILENO);
+			ofc_colstr_flush(cs);
 			ofc_colstr_delete(cs);
 		}
 
@@ -103,30 +1002,41 @@ int main(int argc, const char* argv[])
 					ofc_file_error(file, NULL, "Program failed semantic analysis");
 				ofc_parse_file_delete(program);
 				ofc_sema_scope_delete(super);
-				ofc_file_list_delete(file_list);
-				return EXIT_FAILURE;
+				return false;
 			}
 		}
 
-		if (!ofc_sema_run_passes(file, &sema_pass_opts, sema))
+		ofc_sema_pass_stats_t pass_stats;
+		if (!ofc_sema_run_passes(file, sema_pass_opts, sema,
+			(global_opts.stats_print ? &pass_stats : NULL)))
 		{
 			ofc_sema_scope_delete(super);
-			ofc_file_list_delete(file_list);
-			return EXIT_FAILURE;
+			return false;
+		}
+
+		if (sema)
+		{
+			summary = ofc_global_summary_create(sema);
+			if (!summary || !ofc_global_summary_list_add(
+				summaries, summary))
+			{
+				ofc_global_summary_delete(summary);
+				ofc_sema_scope_delete(super);
+				return false;
+			}
 		}
 
 		if (global_opts.sema_print)
 		{
-			ofc_colstr_t* cs = ofc_colstr_create(print_opts, 72, 0);
+			ofc_colstr_t* cs = ofc_colstr_create_fd(print_opts, 72, 0, STDOUT_FILENO);
 			if (!ofc_sema_scope_print(cs, 0, sema))
 			{
 				ofc_file_error(file, NULL, "Failed to print semantic tree");
 				ofc_colstr_delete(cs);
 				ofc_sema_scope_delete(super);
-				ofc_file_list_delete(file_list);
-				return EXIT_FAILURE;
+				return false;
 			}
-			ofc_colstr_fdprint(cs, STDOUT_FILENO);
+			ofc_colstr_flush(cs);
 			ofc_colstr_delete(cs);
 		}
 
@@ -136,23 +1046,89 @@ int main(int argc, const char* argv[])
 			if (path) printf("%s:\n", path);
 			ofc_sema_scope_common_usage_print(sema);
 		}
+
+		if (global_opts.stats_print)
+			ofc__stats_print(file, program, sema, &pass_stats);
+
+		ofc_cache_file_done(cache, program, summary);
 	}
 
-	if (!ofc_global_pass_common(super))
+	if (!ofc_global_pass_common_summary(summaries))
 	{
 		ofc_sema_scope_delete(super);
-		ofc_file_list_delete(file_list);
-		return EXIT_FAILURE;
+		return false;
 	}
 
-	if (!ofc_global_pass_args(super))
+	if (!ofc_global_pass_args_summary(summaries))
 	{
 		ofc_sema_scope_delete(super);
+		return false;
+	}
+
+	if (global_opts.sema_serial && !global_opts.parse_only
+		&& !ofc_sema_serial_write_file(super, global_opts.sema_serial))
+	{
+		fprintf(stderr, "Error: Failed to write semantic tree to '%s'\n",
+			global_opts.sema_serial);
+		ofc_sema_scope_delete(super);
+		return false;
+	}
+
+	if (global_opts.watch && !global_opts.parse_only
+		&& !ofc__watch(file_list, super, print_opts, sema_pass_opts))
+	{
+		ofc_sema_scope_delete(super);
+		return false;
+	}
+
+	ofc_sema_scope_delete(super);
+	return true;
+}
+
+int main(int argc, const char* argv[])
+{
+	global_opts = OFC_GLOBAL_OPTS_DEFAULT;
+
+	ofc_print_opts_t print_opts         = OFC_PRINT_OPTS_DEFAULT;
+	ofc_sema_pass_opts_t sema_pass_opts = OFC_SEMA_PASS_OPTS_DEFAULT;
+
+	ofc_file_list_t* file_list = ofc_file_list_create();
+
+	if (!ofc_cliarg_parse(argc, argv, &file_list,
+		&print_opts, &global_opts, &sema_pass_opts))
+	{
 		ofc_file_list_delete(file_list);
 		return EXIT_FAILURE;
 	}
 
-	ofc_sema_scope_delete(super);
+	/* Printing to stdout or a file can't be replayed,
+	   and watching never ends. */
+	ofc_cache_t* cache = NULL;
+	if (global_opts.cache_dir
+		&& !global_opts.parse_print
+		&& !global_opts.sema_print
+		&& !global_opts.common_usage_print
+		&& !global_opts.stats_print
+		&& !global_opts.sema_serial
+		&& !global_opts.watch)
+	{
+		cache = ofc_cache_create(
+			global_opts.cache_dir, argc, argv, file_list);
+		if (!ofc_cache_capture(cache))
+		{
+			ofc_cache_delete(cache);
+			cache = NULL;
+		}
+	}
+
+	ofc_global_summary_list_t* summaries
+		= ofc_global_summary_list_create();
+	bool success = (summaries && ofc__run(file_list,
+		print_opts, &sema_pass_opts, cache, summaries));
+
+	ofc_cache_store(cache, success);
+	ofc_cache_delete(cache);
+	ofc_global_summary_list_delete(summaries);
 	ofc_file_list_delete(file_list);
-	return EXIT_SUCCESS;
+	return (success ? EXIT_SUCCESS : EXIT_FAILURE);
 }
@@ -112,6 +112,28 @@ ofc_parse_call_arg_t* ofc_parse_call_arg(
 		false, false, len);
 }
 
+ofc_parse_call_arg_t* ofc_parse_call_arg_copy(
+	const ofc_parse_call_arg_t* call_arg)
+{
+	if (!call_arg)
+		return NULL;
+
+	ofc_parse_call_arg_t* copy
+		= (ofc_parse_call_arg_t*)malloc(
+			sizeof(ofc_parse_call_arg_t));
+	if (!copy) return NULL;
+
+	*copy = *call_arg;
+	copy->expr = ofc_parse_expr_copy(call_arg->expr);
+	if (call_arg->expr && !copy->expr)
+	{
+		free(copy);
+		return NULL;
+	}
+
+	return copy;
+}
+
 void ofc_parse_call_arg_delete(
 	ofc_parse_call_arg_t* call_arg)
 {
@@ -163,7 +185,7 @@ bool ofc_parse_call_arg_print(
 
 
 
-static ofc_parse_call_arg_list_t* ofc_parse_call_arg__list(
+static ofc_parse_call_arg_list_t* ofc_parse_call_arg__list_parse(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	bool named, bool force, unsigned* len)
@@ -192,22 +214,57 @@ static ofc_parse_call_arg_list_t* ofc_parse_call_arg__list(
 	return list;
 }
 
-ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_force_named(
+static ofc_parse_call_arg_list_t* ofc_parse_call_arg__list(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len)
 {
-	return ofc_parse_call_arg__list(
+	return ofc_parse_call_arg__list_parse(
+		src, ptr, debug, false, false, len);
+}
+
+static ofc_parse_call_arg_list_t* ofc_parse_call_arg__list_named(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse_call_arg__list_parse(
+		src, ptr, debug, true, false, len);
+}
+
+static ofc_parse_call_arg_list_t* ofc_parse_call_arg__list_force_named(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse_call_arg__list_parse(
 		src, ptr, debug, true, true, len);
 }
 
+ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_force_named(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_CALL_ARG_LIST_FORCE_NAMED,
+		src, ptr, len,
+		(void*)ofc_parse_call_arg__list_force_named,
+		(void*)ofc_parse_call_arg_list_copy,
+		(void*)ofc_parse_call_arg_list_delete);
+}
+
 ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_named(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len)
 {
-	return ofc_parse_call_arg__list(
-		src, ptr, debug, true, false, len);
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_CALL_ARG_LIST_NAMED,
+		src, ptr, len,
+		(void*)ofc_parse_call_arg__list_named,
+		(void*)ofc_parse_call_arg_list_copy,
+		(void*)ofc_parse_call_arg_list_delete);
 }
 
 ofc_parse_call_arg_list_t* ofc_parse_call_arg_list(
@@ -215,8 +272,12 @@ ofc_parse_call_arg_list_t* ofc_parse_call_arg_list(
 	ofc_parse_debug_t* debug,
 	unsigned* len)
 {
-	return ofc_parse_call_arg__list(
-		src, ptr, debug, false, false, len);
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_CALL_ARG_LIST,
+		src, ptr, len,
+		(void*)ofc_parse_call_arg__list,
+		(void*)ofc_parse_call_arg_list_copy,
+		(void*)ofc_parse_call_arg_list_delete);
 }
 
 ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_wrap(
@@ -244,6 +305,33 @@ ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_wrap(
 	return list;
 }
 
+ofc_parse_call_arg_list_t* ofc_parse_call_arg_list_copy(
+	const ofc_parse_call_arg_list_t* list)
+{
+	if (!list)
+		return NULL;
+
+	ofc_parse_call_arg_list_t* copy
+		= (ofc_parse_call_arg_list_t*)malloc(
+			sizeof(ofc_parse_call_arg_list_t));
+	if (!copy) return NULL;
+
+	copy->count = 0;
+	copy->call_arg = NULL;
+
+	if (!ofc_parse_list_copy(
+		&copy->count, (void***)&copy->call_arg,
+		list->count, (const void**)list->call_arg,
+		(void*)ofc_parse_call_arg_copy,
+		(void*)ofc_parse_call_arg_delete))
+	{
+		free(copy);
+		return NULL;
+	}
+
+	return copy;
+}
+
 void ofc_parse_call_arg_list_delete(
 	ofc_parse_call_arg_list_t* list)
 {
@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -24,10 +25,28 @@ typedef struct
 	char*            message;
 } ofc_parse_debug_msg_t;
 
+#define OFC_PARSE_DEBUG__MEMO_SIZE 256
+
+typedef struct
+{
+	unsigned         generation;
+	ofc_parse_memo_e rule;
+	const char*      ptr;
+	unsigned         len;
+	void*            result;
+	void           (*delete)(void*);
+} ofc_parse_debug__memo_t;
+
 struct ofc_parse_debug_s
 {
 	unsigned                count, max;
 	ofc_parse_debug_msg_t** message;
+
+	unsigned attempts, rewinds;
+
+	ofc_parse_debug__memo_t* memo;
+	unsigned                 memo_generation;
+	unsigned                 memo_calls, memo_hits;
 };
 
 
@@ -43,6 +62,14 @@ ofc_parse_debug_t* ofc_parse_debug_create(void)
 	stack->max     = 0;
 	stack->message = NULL;
 
+	stack->attempts = 0;
+	stack->rewinds  = 0;
+
+	stack->memo            = NULL;
+	stack->memo_generation = 1;
+	stack->memo_calls      = 0;
+	stack->memo_hits       = 0;
+
 	return stack;
 }
 
@@ -60,6 +87,17 @@ void ofc_parse_debug_delete(ofc_parse_debug_t* stack)
 		free(stack->message[i]);
 	}
 	free(stack->message);
+
+	if (stack->memo)
+	{
+		for (i = 0; i < OFC_PARSE_DEBUG__MEMO_SIZE; i++)
+		{
+			if (stack->memo[i].result)
+				stack->memo[i].delete(stack->memo[i].result);
+		}
+		free(stack->memo);
+	}
+
 	free(stack);
 }
 
@@ -75,6 +113,8 @@ void ofc_parse_debug_rewind(
 	if (!stack)
 		return;
 
+	stack->rewinds++;
+
 	unsigned i;
 	for (i = position; i < stack->count; i++)
 	{
@@ -89,6 +129,119 @@ void ofc_parse_debug_rewind(
 	stack->count = position;
 }
 
+void ofc_parse_debug_attempt(ofc_parse_debug_t* stack)
+{
+	if (stack) stack->attempts++;
+}
+
+void ofc_parse_debug_counters(
+	const ofc_parse_debug_t* stack,
+	unsigned* attempts, unsigned* rewinds)
+{
+	if (attempts) *attempts = (stack ? stack->attempts : 0);
+	if (rewinds ) *rewinds  = (stack ? stack->rewinds  : 0);
+}
+
+
+void ofc_parse_debug_memo_enable(ofc_parse_debug_t* stack)
+{
+	if (!stack || stack->memo)
+		return;
+
+	/* Entries are never valid with a generation of zero. */
+	stack->memo = (ofc_parse_debug__memo_t*)calloc(
+		OFC_PARSE_DEBUG__MEMO_SIZE, sizeof(ofc_parse_debug__memo_t));
+}
+
+void ofc_parse_debug_memo_reset(ofc_parse_debug_t* stack)
+{
+	if (!stack)
+		return;
+
+	/* Stale entries are released as their slots are reused. */
+	if (++stack->memo_generation == 0)
+		stack->memo_generation = 1;
+}
+
+void* ofc_parse_debug_memo(
+	ofc_parse_debug_t* stack, ofc_parse_memo_e rule,
+	const ofc_sparse_t* src, const char* ptr, unsigned* len,
+	void* parse, void* copy, void* delete)
+{
+	void* (*parse_func)(const ofc_sparse_t*, const char*,
+		ofc_parse_debug_t*, unsigned*) = parse;
+	void* (*copy_func)(const void*) = copy;
+
+	if (!stack)
+		return parse_func(src, ptr, stack, len);
+
+	stack->memo_calls++;
+	if (!stack->memo)
+		return parse_func(src, ptr, stack, len);
+
+	uintptr_t key = ((uintptr_t)ptr * OFC_PARSE_MEMO_COUNT) + rule;
+	ofc_parse_debug__memo_t* entry
+		= &stack->memo[(key ^ (key >> 8)) % OFC_PARSE_DEBUG__MEMO_SIZE];
+
+	if ((entry->generation == stack->memo_generation)
+		&& (entry->rule == rule) && (entry->ptr == ptr))
+	{
+		if (!entry->result)
+		{
+			stack->memo_hits++;
+			return NULL;
+		}
+
+		void* result = copy_func(entry->result);
+		if (result)
+		{
+			stack->memo_hits++;
+			if (len) *len = entry->len;
+			return result;
+		}
+	}
+
+	/* Results which raised diagnostics aren't stored,
+	   since a hit wouldn't reproduce them. */
+	unsigned dpos   = stack->count;
+	unsigned errors = ofc_file_error_count();
+
+	unsigned l = 0;
+	void* result = parse_func(src, ptr, stack, &l);
+	if (result && len) *len = l;
+
+	if ((stack->count != dpos)
+		|| (ofc_file_error_count() != errors))
+		return result;
+
+	void* stored = NULL;
+	if (result)
+	{
+		stored = copy_func(result);
+		if (!stored) return result;
+	}
+
+	if (entry->result)
+		entry->delete(entry->result);
+
+	entry->generation = stack->memo_generation;
+	entry->rule       = rule;
+	entry->ptr        = ptr;
+	entry->len        = l;
+	entry->result     = stored;
+	entry->delete     = delete;
+
+	return result;
+}
+
+void ofc_parse_debug_memo_counters(
+	const ofc_parse_debug_t* stack,
+	unsigned* calls, unsigned* hits)
+{
+	if (calls) *calls = (stack ? stack->memo_calls : 0);
+	if (hits ) *hits  = (stack ? stack->memo_hits  : 0);
+}
+
 void ofc_parse_debug_print(const ofc_parse_debug_t* stack)
 {
 	if (!stack)
@@ -52,7 +52,7 @@ static ofc_parse_expr_t* ofc_parse_expr__literal(
 	}
 
 	ofc_parse_expr_t* expr
-		= (ofc_parse_expr_t*)malloc(
+		= (ofc_parse_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_expr_t));
 	if (!expr)
 	{
@@ -98,7 +98,7 @@ static ofc_parse_expr_t* ofc_parse_expr__array(
 	i += 2;
 
 	ofc_parse_expr_t* expr
-		= (ofc_parse_expr_t*)malloc(
+		= (ofc_parse_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_expr_t));
 	if (!expr)
 	{
@@ -202,7 +202,7 @@ static ofc_parse_expr_t* ofc_parse_expr__reshape(
 	}
 
 	ofc_parse_expr_t* expr
-		= (ofc_parse_expr_t*)malloc(
+		= (ofc_parse_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_expr_t));
 	if (!expr)
 	{
@@ -242,7 +242,7 @@ ofc_parse_expr_t* ofc_parse_expr_integer(
 	}
 
 	ofc_parse_expr_t* expr
-		= (ofc_parse_expr_t*)malloc(
+		= (ofc_parse_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_expr_t));
 	if (!expr)
 	{
@@ -275,7 +275,7 @@ ofc_parse_expr_t* ofc_parse_expr_integer_variable(
 		= ofc_parse_lhs_variable(src, ptr, debug, &l);
 	if (!variable) return NULL;
 
-	expr = (ofc_parse_expr_t*)malloc(
+	expr = (ofc_parse_expr_t*)ofc_arena_node_alloc(
 		sizeof(ofc_parse_expr_t));
 	if (!expr)
 	{
@@ -312,7 +312,7 @@ static ofc_parse_expr_t* ofc_parse_expr__primary(
 		= ofc_parse_lhs(src, ptr, debug, &l);
 	if (variable)
 	{
-		expr = (ofc_parse_expr_t*)malloc(
+		expr = (ofc_parse_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_expr_t));
 		if (!expr)
 		{
@@ -350,7 +350,7 @@ static ofc_parse_expr_t* ofc_parse_expr__primary(
 
 		l += 2;
 
-		expr = (ofc_parse_expr_t*)malloc(
+		expr = (ofc_parse_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_expr_t));
 		if (!expr)
 		{
@@ -398,7 +398,7 @@ static ofc_parse_expr_t* ofc_parse_expr__unary(
 	l += op_len;
 
 	ofc_parse_expr_t* expr
-		= (ofc_parse_expr_t*)malloc(
+		= (ofc_parse_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_expr_t));
 	if (!expr)
 	{
@@ -485,7 +485,7 @@ static ofc_parse_expr_t* ofc_parse_expr__binary_insert(
 	if (a_prec <= op_prec)
 	{
 		ofc_parse_expr_t* expr
-			= (ofc_parse_expr_t*)malloc(
+			= (ofc_parse_expr_t*)ofc_arena_node_alloc(
 				sizeof(ofc_parse_expr_t));
 		if (!expr) return NULL;
 
@@ -622,7 +622,7 @@ static ofc_parse_expr_t* ofc_parse__expr(
 	return a;
 }
 
-ofc_parse_expr_t* ofc_parse_expr(
+static ofc_parse_expr_t* ofc_parse__expr_default(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len)
@@ -631,6 +631,28 @@ ofc_parse_expr_t* ofc_parse_expr(
 		src, ptr, debug, len, false);
 }
 
+static ofc_parse_expr_t* ofc_parse__expr_no_slash(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse__expr(
+		src, ptr, debug, len, true);
+}
+
+ofc_parse_expr_t* ofc_parse_expr(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_EXPR,
+		src, ptr, len,
+		(void*)ofc_parse__expr_default,
+		(void*)ofc_parse_expr_copy,
+		(void*)ofc_parse_expr_delete);
+}
+
 ofc_parse_expr_t* ofc_parse_expr_id(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
@@ -645,7 +667,7 @@ ofc_parse_expr_t* ofc_parse_expr_id(
 	if (id)
 	{
 		ofc_parse_expr_t* expr
-			= (ofc_parse_expr_t*)malloc(
+			= (ofc_parse_expr_t*)ofc_arena_node_alloc(
 				sizeof(ofc_parse_expr_t));
 		if (!expr)
 		{
@@ -662,8 +684,8 @@ ofc_parse_expr_t* ofc_parse_expr_id(
 		return expr;
 	}
 
-	return ofc_parse__expr(
-		src, ptr, debug, len, false);
+	return ofc_parse_expr(
+		src, ptr, debug, len);
 }
 
 ofc_parse_expr_t* ofc_parse_expr_no_slash(
@@ -671,8 +693,12 @@ ofc_parse_expr_t* ofc_parse_expr_no_slash(
 	ofc_parse_debug_t* debug,
 	unsigned* len)
 {
-	return ofc_parse__expr(
-		src, ptr, debug, len, true);
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_EXPR_NO_SLASH,
+		src, ptr, len,
+		(void*)ofc_parse__expr_no_slash,
+		(void*)ofc_parse_expr_copy,
+		(void*)ofc_parse_expr_delete);
 }
 
 void ofc_parse_expr_delete(
@@ -723,7 +749,7 @@ void ofc_parse_expr_delete(
 			break;
 	}
 
-	free(expr);
+	ofc_arena_node_free(expr);
 }
 
 bool ofc_parse_expr_print(
@@ -816,7 +842,7 @@ ofc_parse_expr_t* ofc_parse_expr_copy(
 		return NULL;
 
 	ofc_parse_expr_t* copy
-		= (ofc_parse_expr_t*)malloc(
+		= (ofc_parse_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_expr_t));
 	if (!copy) return NULL;
 	*copy = *expr;
@@ -14,6 +14,7 @@
  */
 
 #include "ofc/parse.h"
+#include "ofc/global_opts.h"
 
 
 unsigned ofc_parse_stmt_program_end(
@@ -72,25 +73,49 @@ ofc_parse_file_t* ofc_parse_file(ofc_sparse_t* src)
 		= ofc_parse_debug_create();
 	if (!debug) return NULL;
 
-	ofc_parse_stmt_list_t* list
-		= ofc_parse_stmt_list_create();
-	if (!list) return NULL;
+	if (global_opts.parse_memo)
+		ofc_parse_debug_memo_enable(debug);
 
-	if (!ofc_parse_file_include(
-		src, list, debug))
+	ofc_arena_t* arena = ofc_arena_create();
+	if (!arena)
 	{
-		ofc_parse_debug_print(debug);
 		ofc_parse_debug_delete(debug);
+		return NULL;
+	}
 
-		ofc_parse_stmt_list_delete(list);
+	/* Parse tree nodes are allocated from the file's arena. */
+	ofc_arena_t* prev = ofc_arena_current_set(arena);
+
+	ofc_parse_stmt_list_t* list
+		= ofc_parse_stmt_list_create();
+	if (!list)
+	{
+		ofc_arena_current_set(prev);
+		ofc_arena_delete(arena);
+		ofc_parse_debug_delete(debug);
 		return NULL;
 	}
 
+	bool success = ofc_parse_file_include(
+		src, list, debug);
+
+	ofc_arena_current_set(prev);
 	ofc_parse_debug_print(debug);
-	ofc_parse_debug_delete(debug);
 
-	if (!list) return NULL;
+	unsigned attempts, rewinds;
+	ofc_parse_debug_counters(
+		debug, &attempts, &rewinds);
+	unsigned memo_calls, memo_hits;
+	ofc_parse_debug_memo_counters(
+		debug, &memo_calls, &memo_hits);
+	ofc_parse_debug_delete(debug);
 
+	if (!success)
+	{
+		ofc_parse_stmt_list_delete(list);
+		ofc_arena_delete(arena);
+		return NULL;
+	}
 
 	ofc_parse_file_t* file
 		= (ofc_parse_file_t*)malloc(
@@ -98,20 +123,46 @@ ofc_parse_file_t* ofc_parse_file(ofc_sparse_t* src)
 	if (!file)
 	{
 		ofc_parse_stmt_list_delete(list);
+		ofc_arena_delete(arena);
 		return NULL;
 	}
 
 	file->source = src;
 	file->stmt   = list;
+	file->arena  = arena;
+
+	file->attempts = attempts;
+	file->rewinds  = rewinds;
+
+	file->memo_calls = memo_calls;
+	file->memo_hits  = memo_hits;
+
+	file->refcnt = 0;
 	return file;
 }
 
+bool ofc_parse_file_reference(ofc_parse_file_t* file)
+{
+	if (!file)
+		return false;
+
+	file->refcnt++;
+	return true;
+}
+
 void ofc_parse_file_delete(ofc_parse_file_t* file)
 {
 	if (!file)
 		return;
 
+	if (file->refcnt > 0)
+	{
+		file->refcnt--;
+		return;
+	}
+
 	ofc_parse_stmt_list_delete(file->stmt);
+	ofc_arena_delete(file->arena);
 	ofc_sparse_delete(file->source);
 	free(file);
 }
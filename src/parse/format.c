@@ -18,6 +18,10 @@
 #include <string.h>
 
 #include "ofc/parse.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_parse_format__desc_vector, ofc_parse_format_desc_t*)
 
 
 typedef struct
@@ -579,6 +583,7 @@ ofc_parse_format_desc_list_t* ofc_parse_format_desc_list_copy(
 	if (!copy) return NULL;
 
 	copy->count = 0;
+	copy->size  = 0;
 	copy->desc = NULL;
 
 	if (!ofc_parse_list_copy(
@@ -605,6 +610,7 @@ ofc_parse_format_desc_list_t* ofc_parse_format_desc_list(
 	if (!list) return NULL;
 
 	list->count = 0;
+	list->size  = 0;
 	list->desc  = NULL;
 
 	unsigned i = ofc_parse_list_seperator_optional(
@@ -656,6 +662,7 @@ ofc_parse_format_desc_list_t* ofc_parse_format_desc_list_create(void)
 	if (!list) return NULL;
 
 	list->count = 0;
+	list->size  = 0;
 	list->desc  = NULL;
 	return list;
 }
@@ -667,12 +674,10 @@ bool ofc_parse_format_desc_list_add(
 	if (!list || !desc)
 		return false;
 
-	ofc_parse_format_desc_t** ndesc
-		= (ofc_parse_format_desc_t**)realloc(list->desc,
-			(sizeof(ofc_parse_format_desc_t*) * (list->count + 1)));
-	if (!ndesc) return NULL;
+	if (!ofc_parse_format__desc_vector_reserve(
+		&list->desc, list->count, &list->size, 1))
+		return false;
 
-	list->desc = ndesc;
 	list->desc[list->count++] = desc;
 	return true;
 }
@@ -14,6 +14,8 @@
  */
 
 #include <ctype.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "ofc/parse.h"
@@ -124,6 +126,97 @@ static const char* ofc_parse_keyword__name[] =
 
 
 
+/* Keywords are matched against condensed source, so the trie holds
+   each keyword with its spaces removed. */
+#define OFC_PARSE_KEYWORD__TRIE_MAX 512
+
+typedef struct
+{
+	uint16_t child[26];
+	uint8_t  keyword;
+} ofc_parse_keyword__trie_t;
+
+static ofc_parse_keyword__trie_t
+	ofc_parse_keyword__trie[OFC_PARSE_KEYWORD__TRIE_MAX];
+static unsigned ofc_parse_keyword__trie_count = 0;
+static pthread_once_t ofc_parse_keyword__trie_once = PTHREAD_ONCE_INIT;
+
+static unsigned ofc_parse_keyword__trie_node(void)
+{
+	if (ofc_parse_keyword__trie_count
+		>= OFC_PARSE_KEYWORD__TRIE_MAX)
+		return 0;
+
+	unsigned n = ofc_parse_keyword__trie_count++;
+	memset(ofc_parse_keyword__trie[n].child, 0,
+		sizeof(ofc_parse_keyword__trie[n].child));
+	ofc_parse_keyword__trie[n].keyword = OFC_PARSE_KEYWORD_COUNT;
+	return n;
+}
+
+static void ofc_parse_keyword__trie_init(void)
+{
+	ofc_parse_keyword__trie_node();
+
+	unsigned k;
+	for (k = 0; k < OFC_PARSE_KEYWORD_COUNT; k++)
+	{
+		const char* name = ofc_parse_keyword__name[k];
+
+		unsigned n = 0, i;
+		for (i = 0; name[i] != '\0'; i++)
+		{
+			if (name[i] == ' ')
+				continue;
+
+			unsigned c = (name[i] - 'A');
+			if (ofc_parse_keyword__trie[n].child[c] == 0)
+			{
+				unsigned m = ofc_parse_keyword__trie_node();
+				/* Overflow just leaves the keyword out. */
+				if (m == 0) break;
+				ofc_parse_keyword__trie[n].child[c] = m;
+			}
+			n = ofc_parse_keyword__trie[n].child[c];
+		}
+
+		if (name[i] == '\0')
+			ofc_parse_keyword__trie[n].keyword = k;
+	}
+}
+
+unsigned ofc_parse_keyword_prefix(
+	const char* ptr,
+	ofc_parse_keyword_e* keyword, unsigned max)
+{
+	if (!ptr)
+		return 0;
+
+	pthread_once(&ofc_parse_keyword__trie_once,
+		ofc_parse_keyword__trie_init);
+
+	unsigned count = 0;
+	unsigned n = 0, i;
+	for (i = 0; (count < max) && isalpha(ptr[i]); i++)
+	{
+		unsigned c = (toupper(ptr[i]) - 'A');
+		if (c >= 26) break;
+
+		n = ofc_parse_keyword__trie[n].child[c];
+		if (n == 0) break;
+
+		if (ofc_parse_keyword__trie[n].keyword
+			!= OFC_PARSE_KEYWORD_COUNT)
+		{
+			keyword[count++] = (ofc_parse_keyword_e)
+				ofc_parse_keyword__trie[n].keyword;
+		}
+	}
+
+	return count;
+}
+
+
 bool ofc_sparse_ref_begins_with_keyword(
 	ofc_sparse_ref_t ref, bool* space, bool* is)
 {
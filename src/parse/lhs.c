@@ -51,7 +51,7 @@ static ofc_parse_lhs_t* ofc_parse_lhs__alloc(
 	ofc_parse_lhs_t lhs)
 {
 	ofc_parse_lhs_t* alhs
-		= (ofc_parse_lhs_t*)malloc(
+		= (ofc_parse_lhs_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_lhs_t));
 	if (!alhs) return NULL;
 
@@ -371,16 +371,16 @@ static ofc_parse_lhs_t* ofc_parse__lhs(
 	return alhs;
 }
 
-ofc_parse_lhs_t* ofc_parse_lhs_star_len(
+static ofc_parse_lhs_t* ofc_parse__lhs_default(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len)
 {
 	return ofc_parse__lhs(
-		src, ptr, debug, true , true, len);
+		src, ptr, debug, true, false ,len);
 }
 
-ofc_parse_lhs_t* ofc_parse_lhs_variable(
+static ofc_parse_lhs_t* ofc_parse__lhs_variable(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len)
@@ -389,6 +389,41 @@ ofc_parse_lhs_t* ofc_parse_lhs_variable(
 		src, ptr, debug, false, false ,len);
 }
 
+static ofc_parse_lhs_t* ofc_parse__lhs_star_len(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse__lhs(
+		src, ptr, debug, true , true, len);
+}
+
+ofc_parse_lhs_t* ofc_parse_lhs_star_len(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_LHS_STAR_LEN,
+		src, ptr, len,
+		(void*)ofc_parse__lhs_star_len,
+		(void*)ofc_parse_lhs_copy,
+		(void*)ofc_parse_lhs_delete);
+}
+
+ofc_parse_lhs_t* ofc_parse_lhs_variable(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_LHS_VARIABLE,
+		src, ptr, len,
+		(void*)ofc_parse__lhs_variable,
+		(void*)ofc_parse_lhs_copy,
+		(void*)ofc_parse_lhs_delete);
+}
+
 ofc_parse_lhs_t* ofc_parse_lhs_alias(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
@@ -429,8 +464,12 @@ ofc_parse_lhs_t* ofc_parse_lhs(
 	ofc_parse_debug_t* debug,
 	unsigned* len)
 {
-	return ofc_parse__lhs(
-		src, ptr, debug, true, false ,len);
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_LHS,
+		src, ptr, len,
+		(void*)ofc_parse__lhs_default,
+		(void*)ofc_parse_lhs_copy,
+		(void*)ofc_parse_lhs_delete);
 }
 
 ofc_parse_lhs_t* ofc_parse_lhs_id(
@@ -447,7 +486,7 @@ ofc_parse_lhs_t* ofc_parse_lhs_id(
 	if (id)
 	{
 		ofc_parse_lhs_t* lhs
-			= (ofc_parse_lhs_t*)malloc(
+			= (ofc_parse_lhs_t*)ofc_arena_node_alloc(
 				sizeof(ofc_parse_lhs_t));
 		if (!lhs)
 		{
@@ -464,8 +503,8 @@ ofc_parse_lhs_t* ofc_parse_lhs_id(
 		return lhs;
 	}
 
-	return ofc_parse__lhs(
-		src, ptr, debug, true, false, len);
+	return ofc_parse_lhs(
+		src, ptr, debug, len);
 }
 
 
@@ -497,7 +536,7 @@ void ofc_parse_lhs_delete(
 		return;
 
 	ofc_parse_lhs__cleanup(*lhs);
-	free(lhs);
+	ofc_arena_node_free(lhs);
 }
 
 bool ofc_parse_lhs_print(
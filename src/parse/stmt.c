@@ -13,7 +13,14 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
+#include <stdint.h>
+
 #include "ofc/parse.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_parse_stmt__file_vector, const ofc_file_t*)
 
 unsigned ofc_parse_stmt_include(
 	const ofc_sparse_t* src, const char* ptr,
@@ -438,7 +445,7 @@ static ofc_parse_stmt_t* ofc_parse_stmt__alloc(
 	ofc_parse_stmt_t stmt)
 {
 	ofc_parse_stmt_t* astmt
-		= (ofc_parse_stmt_t*)malloc(
+		= (ofc_parse_stmt_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_stmt_t));
 	if (!astmt) return NULL;
 
@@ -448,6 +455,202 @@ static ofc_parse_stmt_t* ofc_parse_stmt__alloc(
 
 
 
+typedef unsigned (*ofc_parse_stmt__parse_f)(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	ofc_parse_stmt_t* stmt);
+
+typedef struct
+{
+	ofc_parse_keyword_e     keyword;
+	ofc_parse_stmt__parse_f parse;
+} ofc_parse_stmt__dispatch_t;
+
+/* Statement parsers in the order they're tried, each is only tried when
+   the statement begins with its keyword. There must be no more than 64
+   entries so that the candidates fit in a mask. INCLUDE needs the
+   statement list so it's special cased. */
+static const ofc_parse_stmt__dispatch_t ofc_parse_stmt__dispatch[] =
+{
+	{ OFC_PARSE_KEYWORD_ASSIGN     , ofc_parse_stmt_assign               },
+	{ OFC_PARSE_KEYWORD_AUTOMATIC  , ofc_parse_stmt_decl_attr_automatic  },
+	{ OFC_PARSE_KEYWORD_ACCEPT     , ofc_parse_stmt_io_accept            },
+
+	{ OFC_PARSE_KEYWORD_BACKSPACE  , ofc_parse_stmt_io_backspace         },
+	{ OFC_PARSE_KEYWORD_BLOCK_DATA , ofc_parse_stmt_block_data           },
+
+	{ OFC_PARSE_KEYWORD_CONTINUE   , ofc_parse_stmt_continue             },
+	{ OFC_PARSE_KEYWORD_CONTAINS   , ofc_parse_stmt_contains             },
+	{ OFC_PARSE_KEYWORD_CYCLE      , ofc_parse_stmt_cycle_exit           },
+	{ OFC_PARSE_KEYWORD_CALL       , ofc_parse_stmt_call                 },
+	{ OFC_PARSE_KEYWORD_COMMON     , ofc_parse_stmt_common               },
+	{ OFC_PARSE_KEYWORD_CLOSE      , ofc_parse_stmt_io_close             },
+
+	{ OFC_PARSE_KEYWORD_DO         , ofc_parse_stmt_do                   },
+	{ OFC_PARSE_KEYWORD_DATA       , ofc_parse_stmt_data                 },
+	{ OFC_PARSE_KEYWORD_DIMENSION  , ofc_parse_stmt_dimension            },
+	{ OFC_PARSE_KEYWORD_DECODE     , ofc_parse_stmt_io_decode            },
+	{ OFC_PARSE_KEYWORD_DEFINE_FILE, ofc_parse_stmt_io_define_file       },
+
+	{ OFC_PARSE_KEYWORD_EQUIVALENCE, ofc_parse_stmt_equivalence          },
+	{ OFC_PARSE_KEYWORD_EXIT       , ofc_parse_stmt_cycle_exit           },
+	{ OFC_PARSE_KEYWORD_END_FILE   , ofc_parse_stmt_io_end_file          },
+	{ OFC_PARSE_KEYWORD_EXTERNAL   , ofc_parse_stmt_decl_attr_external   },
+	{ OFC_PARSE_KEYWORD_ENTRY      , ofc_parse_stmt_entry                },
+	{ OFC_PARSE_KEYWORD_ENCODE     , ofc_parse_stmt_io_encode            },
+
+	{ OFC_PARSE_KEYWORD_FORMAT     , ofc_parse_stmt_format               },
+
+	{ OFC_PARSE_KEYWORD_GO_TO      , ofc_parse_stmt_go_to                },
+
+	{ OFC_PARSE_KEYWORD_IMPLICIT   , ofc_parse_stmt_implicit             },
+	{ OFC_PARSE_KEYWORD_IF         , ofc_parse_stmt_if                   },
+	{ OFC_PARSE_KEYWORD_INTRINSIC  , ofc_parse_stmt_decl_attr_intrinsic  },
+	{ OFC_PARSE_KEYWORD_INQUIRE    , ofc_parse_stmt_io_inquire           },
+	{ OFC_PARSE_KEYWORD_INCLUDE    , NULL                                },
+
+	{ OFC_PARSE_KEYWORD_MAP        , ofc_parse_stmt_map                  },
+	{ OFC_PARSE_KEYWORD_MODULE     , ofc_parse_stmt_module               },
+
+	{ OFC_PARSE_KEYWORD_NAMELIST   , ofc_parse_stmt_namelist             },
+
+	{ OFC_PARSE_KEYWORD_OPEN       , ofc_parse_stmt_io_open              },
+
+	{ OFC_PARSE_KEYWORD_PARAMETER  , ofc_parse_stmt_parameter            },
+	{ OFC_PARSE_KEYWORD_PROGRAM    , ofc_parse_stmt_program              },
+	{ OFC_PARSE_KEYWORD_PAUSE      , ofc_parse_stmt_pause                },
+	{ OFC_PARSE_KEYWORD_PRINT      , ofc_parse_stmt_io_print_type        },
+	{ OFC_PARSE_KEYWORD_POINTER    , ofc_parse_stmt_pointer              },
+	{ OFC_PARSE_KEYWORD_PUBLIC     , ofc_parse_stmt_public               },
+	{ OFC_PARSE_KEYWORD_PRIVATE    , ofc_parse_stmt_private              },
+
+	{ OFC_PARSE_KEYWORD_RETURN     , ofc_parse_stmt_return               },
+	{ OFC_PARSE_KEYWORD_READ       , ofc_parse_stmt_io_read              },
+	{ OFC_PARSE_KEYWORD_REWIND     , ofc_parse_stmt_io_rewind            },
+
+	{ OFC_PARSE_KEYWORD_SUBROUTINE , ofc_parse_stmt_subroutine           },
+	{ OFC_PARSE_KEYWORD_STOP       , ofc_parse_stmt_stop                 },
+	{ OFC_PARSE_KEYWORD_SAVE       , ofc_parse_stmt_save                 },
+	{ OFC_PARSE_KEYWORD_STATIC     , ofc_parse_stmt_decl_attr_static     },
+	{ OFC_PARSE_KEYWORD_STRUCTURE  , ofc_parse_stmt_structure            },
+	{ OFC_PARSE_KEYWORD_SEQUENCE   , ofc_parse_stmt_sequence             },
+	{ OFC_PARSE_KEYWORD_SELECT     , ofc_parse_stmt_select_case          },
+
+	{ OFC_PARSE_KEYWORD_TYPE       , ofc_parse_stmt_type                 },
+	{ OFC_PARSE_KEYWORD_TYPE       , ofc_parse_stmt_io_print_type        },
+
+	{ OFC_PARSE_KEYWORD_UNION      , ofc_parse_stmt_union                },
+	{ OFC_PARSE_KEYWORD_USE        , ofc_parse_stmt_use                  },
+
+	{ OFC_PARSE_KEYWORD_VIRTUAL    , ofc_parse_stmt_virtual              },
+	{ OFC_PARSE_KEYWORD_VOLATILE   , ofc_parse_stmt_decl_attr_volatile   },
+
+	{ OFC_PARSE_KEYWORD_WRITE      , ofc_parse_stmt_io_write             },
+	{ OFC_PARSE_KEYWORD_WHILE      , ofc_parse_stmt_while_do_block       },
+};
+
+#define OFC_PARSE_STMT__DISPATCH_COUNT \
+	(sizeof(ofc_parse_stmt__dispatch) / sizeof(ofc_parse_stmt__dispatch[0]))
+
+static uint64_t ofc_parse_stmt__dispatch_mask[OFC_PARSE_KEYWORD_COUNT];
+static pthread_once_t ofc_parse_stmt__dispatch_once = PTHREAD_ONCE_INIT;
+
+static void ofc_parse_stmt__dispatch_init(void)
+{
+	unsigned i;
+	for (i = 0; (i < OFC_PARSE_STMT__DISPATCH_COUNT) && (i < 64); i++)
+	{
+		ofc_parse_stmt__dispatch_mask[
+			ofc_parse_stmt__dispatch[i].keyword] |= (1ULL << i);
+	}
+}
+
+static bool ofc_parse_stmt__is_type_keyword(
+	ofc_parse_keyword_e keyword)
+{
+	switch (keyword)
+	{
+		case OFC_PARSE_KEYWORD_LOGICAL:
+		case OFC_PARSE_KEYWORD_CHARACTER:
+		case OFC_PARSE_KEYWORD_INTEGER:
+		case OFC_PARSE_KEYWORD_REAL:
+		case OFC_PARSE_KEYWORD_COMPLEX:
+		case OFC_PARSE_KEYWORD_BYTE:
+		case OFC_PARSE_KEYWORD_DOUBLE_PRECISION:
+		case OFC_PARSE_KEYWORD_DOUBLE_COMPLEX:
+		case OFC_PARSE_KEYWORD_TYPE:
+		case OFC_PARSE_KEYWORD_RECORD:
+			return true;
+		default:
+			break;
+	}
+	return false;
+}
+
+/* Checks whether a statement looks like 'name[(...)][%name...] = expr'
+   where expr has no top level comma, which would make it a DO loop.
+   This only decides whether to try parsing an assignment first. */
+static bool ofc_parse_stmt__is_assignment(const char* ptr)
+{
+	if (!isalpha(ptr[0]))
+		return false;
+
+	unsigned i;
+	for (i = 1; ofc_is_ident(ptr[i]); i++);
+
+	unsigned depth = 0;
+	bool rhs = false;
+	for (; !ofc_is_end_statement(&ptr[i], NULL); i++)
+	{
+		char c = ptr[i];
+		if ((c == '\'') || (c == '\"'))
+		{
+			for (i++; (ptr[i] != c)
+				&& !ofc_is_end_statement(&ptr[i], NULL); i++);
+			if (ptr[i] != c)
+				return false;
+		}
+		else if (c == '(')
+		{
+			depth++;
+		}
+		else if (c == ')')
+		{
+			if (depth == 0)
+				return false;
+			depth--;
+		}
+		else if (depth > 0)
+		{
+			/* Subscripts and substrings are skipped. */
+		}
+		else if (rhs)
+		{
+			if (c == ',')
+				return false;
+		}
+		else if (c == '=')
+		{
+			if ((ptr[i + 1] == '=')
+				|| (ptr[i + 1] == '>'))
+				return false;
+			rhs = true;
+		}
+		else if (c == '%')
+		{
+			if (!isalpha(ptr[i + 1]))
+				return false;
+			for (i++; ofc_is_ident(ptr[i + 1]); i++);
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return rhs;
+}
+
 ofc_parse_stmt_t* ofc_parse_stmt(
 	ofc_parse_stmt_list_t* list,
 	const ofc_sparse_t* src, const char* ptr,
@@ -466,10 +669,65 @@ ofc_parse_stmt_t* ofc_parse_stmt(
 
 	unsigned dpos = ofc_parse_debug_position(debug);
 
+	/* Memoized sub-parses are only reused within a statement. */
+	ofc_parse_debug_memo_reset(debug);
+
+	pthread_once(&ofc_parse_stmt__dispatch_once,
+		ofc_parse_stmt__dispatch_init);
+
+	/* Find every parser whose keyword the statement begins with. */
+	ofc_parse_keyword_e keyword[8];
+	unsigned keyword_count = ofc_parse_keyword_prefix(
+		ptr, keyword, 8);
+
+	uint64_t mask = 0;
+	bool is_type = false;
+	bool is_function = false;
+	unsigned k;
+	for (k = 0; k < keyword_count; k++)
+	{
+		mask |= ofc_parse_stmt__dispatch_mask[keyword[k]];
+
+		if (ofc_parse_stmt__is_type_keyword(keyword[k]))
+			is_type = true;
+		else if (keyword[k] == OFC_PARSE_KEYWORD_FUNCTION)
+			is_function = true;
+	}
+
 	unsigned i = 0;
 
-	if (i == 0) i = ofc_parse_stmt_function(src, ptr, debug, &stmt);
-	if (i == 0) i = ofc_parse_stmt_decl(src, ptr, debug, &stmt);
+	/* Assignments are the most common statement, so when one looks
+	   likely we try it first. PARAMETER is excluded since it may be
+	   written without brackets, which looks just like an assignment. */
+	bool is_parameter = ((mask & ofc_parse_stmt__dispatch_mask[
+		OFC_PARSE_KEYWORD_PARAMETER]) != 0);
+	if (!is_parameter && ofc_parse_stmt__is_assignment(ptr))
+	{
+		ofc_parse_debug_attempt(debug);
+		stmt.assignment = ofc_parse_assign(src, ptr, debug, &i);
+		if (stmt.assignment && stmt.assignment->init
+			&& ofc_is_end_statement(&ptr[i], NULL))
+		{
+			stmt.type = OFC_PARSE_STMT_ASSIGNMENT;
+		}
+		else
+		{
+			ofc_parse_assign_delete(stmt.assignment);
+			ofc_parse_debug_rewind(debug, dpos);
+			i = 0;
+		}
+	}
+
+	if ((i == 0) && (is_type || is_function))
+	{
+		ofc_parse_debug_attempt(debug);
+		i = ofc_parse_stmt_function(src, ptr, debug, &stmt);
+	}
+	if ((i == 0) && is_type)
+	{
+		ofc_parse_debug_attempt(debug);
+		i = ofc_parse_stmt_decl(src, ptr, debug, &stmt);
+	}
 
 	/* Drop incomplete statements. */
 	if ((i > 0) && (stmt.type != OFC_PARSE_STMT_ERROR)
@@ -480,122 +738,18 @@ ofc_parse_stmt_t* ofc_parse_stmt(
 		ofc_parse_debug_rewind(debug, dpos);
 	}
 
-	switch (toupper(ptr[0]))
+	unsigned d;
+	for (d = 0; (i == 0) && (mask != 0); d++, mask >>= 1)
 	{
-		case 'A':
-			if (i == 0) i = ofc_parse_stmt_assign(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_decl_attr_automatic(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_accept(src, ptr, debug, &stmt);
-			break;
-
-		case 'B':
-			if (i == 0) i = ofc_parse_stmt_io_backspace(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_block_data(src, ptr, debug, &stmt);
-			break;
-
-		case 'C':
-			if (i == 0) i = ofc_parse_stmt_continue(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_contains(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_cycle_exit(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_call(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_common(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_close(src, ptr, debug, &stmt);
-			break;
-
-		case 'D':
-			if (i == 0) i = ofc_parse_stmt_do(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_data(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_dimension(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_decode(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_define_file(src, ptr, debug, &stmt);
-			break;
-
-		case 'E':
-			if (i == 0) i = ofc_parse_stmt_equivalence(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_cycle_exit(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_end_file(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_decl_attr_external(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_entry(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_encode(src, ptr, debug, &stmt);
-			break;
-
-		case 'F':
-			if (i == 0) i = ofc_parse_stmt_format(src, ptr, debug, &stmt);
-			break;
-
-		case 'G':
-			if (i == 0) i = ofc_parse_stmt_go_to(src, ptr, debug, &stmt);
-			break;
-
-		case 'I':
-			if (i == 0) i = ofc_parse_stmt_implicit(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_if(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_decl_attr_intrinsic(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_inquire(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_include(src, ptr, debug, &stmt, list);
-			break;
-
-		case 'M':
-			if (i == 0) i = ofc_parse_stmt_map(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_module(src, ptr, debug, &stmt);
-			break;
-
-		case 'N':
-			if (i == 0) i = ofc_parse_stmt_namelist(src, ptr, debug, &stmt);
-			break;
-
-		case 'O':
-			if (i == 0) i = ofc_parse_stmt_io_open(src, ptr, debug, &stmt);
-			break;
-
-		case 'P':
-			if (i == 0) i = ofc_parse_stmt_parameter(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_program(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_pause(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_print_type(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_pointer(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_public(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_private(src, ptr, debug, &stmt);
-			break;
-
-		case 'R':
-			if (i == 0) i = ofc_parse_stmt_return(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_read(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_rewind(src, ptr, debug, &stmt);
-			break;
-
-		case 'S':
-			if (i == 0) i = ofc_parse_stmt_subroutine(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_stop(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_save(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_decl_attr_static(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_structure(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_sequence(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_select_case(src, ptr, debug, &stmt);
-			break;
-
-		case 'T':
-			if (i == 0) i = ofc_parse_stmt_type(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_io_print_type(src, ptr, debug, &stmt);
-			break;
-
-		case 'U':
-			if (i == 0) i = ofc_parse_stmt_union(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_use(src, ptr, debug, &stmt);
-			break;
-
-		case 'V':
-			if (i == 0) i = ofc_parse_stmt_virtual(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_decl_attr_volatile(src, ptr, debug, &stmt);
-			break;
-
-		case 'W':
-			if (i == 0) i = ofc_parse_stmt_io_write(src, ptr, debug, &stmt);
-			if (i == 0) i = ofc_parse_stmt_while_do_block(src, ptr, debug, &stmt);
-			break;
+		if ((mask & 1) == 0)
+			continue;
 
-		default:
-			break;
+		ofc_parse_debug_attempt(debug);
+		if (ofc_parse_stmt__dispatch[d].keyword
+			== OFC_PARSE_KEYWORD_INCLUDE)
+			i = ofc_parse_stmt_include(src, ptr, debug, &stmt, list);
+		else
+			i = ofc_parse_stmt__dispatch[d].parse(src, ptr, debug, &stmt);
 	}
 
 	/* Drop incomplete statements, they may be an assignment. */
@@ -609,6 +763,7 @@ ofc_parse_stmt_t* ofc_parse_stmt(
 
 	if (i == 0)
 	{
+		ofc_parse_debug_attempt(debug);
 		stmt.assignment = ofc_parse_assign(src, ptr, debug, &i);
 		if (stmt.assignment)
 		{
@@ -663,7 +818,7 @@ void ofc_parse_stmt_delete(
 		return;
 
 	ofc_parse_stmt__cleanup(*stmt);
-	free(stmt);
+	ofc_arena_node_free(stmt);
 }
 
 
@@ -1119,6 +1274,212 @@ bool ofc_parse_stmt_list_print(
 }
 
 
+bool ofc_parse_stmt_list_contains_use(
+	const ofc_parse_stmt_list_t* list)
+{
+	if (!list)
+		return false;
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		const ofc_parse_stmt_t* stmt = list->stmt[i];
+		if (!stmt) continue;
+
+		switch (stmt->type)
+		{
+			case OFC_PARSE_STMT_USE:
+				return true;
+
+			case OFC_PARSE_STMT_PROGRAM:
+			case OFC_PARSE_STMT_SUBROUTINE:
+			case OFC_PARSE_STMT_FUNCTION:
+			case OFC_PARSE_STMT_MODULE:
+			case OFC_PARSE_STMT_BLOCK_DATA:
+				if (ofc_parse_stmt_list_contains_use(
+					stmt->program.body))
+					return true;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+
+typedef struct
+{
+	void* param;
+	bool (*func)(ofc_file_t* file, void* param);
+} ofc_parse_stmt__include_foreach_t;
+
+static bool ofc_parse_stmt__include_foreach(
+	const ofc_parse_stmt_t* stmt,
+	ofc_parse_stmt__include_foreach_t* foreach)
+{
+	if (!stmt)
+		return true;
+
+	switch (stmt->type)
+	{
+		case OFC_PARSE_STMT_INCLUDE:
+			return foreach->func(
+				stmt->include.file, foreach->param);
+
+		case OFC_PARSE_STMT_PROGRAM:
+		case OFC_PARSE_STMT_SUBROUTINE:
+		case OFC_PARSE_STMT_FUNCTION:
+		case OFC_PARSE_STMT_MODULE:
+		case OFC_PARSE_STMT_BLOCK_DATA:
+			if (stmt->program.body)
+				return ofc_parse_stmt_list_foreach(
+					stmt->program.body, foreach,
+					(void*)ofc_parse_stmt__include_foreach);
+			break;
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
+bool ofc_parse_stmt_include_foreach(
+	const ofc_parse_stmt_t* stmt, void* param,
+	bool (*func)(ofc_file_t* file, void* param))
+{
+	if (!func)
+		return false;
+
+	ofc_parse_stmt__include_foreach_t foreach
+		= { param, func };
+	return ofc_parse_stmt__include_foreach(
+		stmt, &foreach);
+}
+
+
+typedef struct
+{
+	const ofc_file_t** file;
+	unsigned           count;
+	unsigned           size;
+} ofc_parse_stmt__include_list_t;
+
+static bool ofc_parse_stmt__include_list_add(
+	const ofc_file_t* file,
+	ofc_parse_stmt__include_list_t* list)
+{
+	if (!ofc_parse_stmt__file_vector_reserve(
+		&list->file, list->count, &list->size, 1))
+		return false;
+
+	list->file[list->count++] = file;
+	return true;
+}
+
+/* The condensed text drops spaces within strings and labels,
+   so the text of the file a statement spans is used instead. */
+static bool ofc_parse_stmt__file_text(
+	const ofc_parse_stmt_t* stmt,
+	const char** text, unsigned* size)
+{
+	*text = NULL;
+	*size = 0;
+
+	const ofc_sparse_t* src = stmt->src.sparse;
+	const char*   base = stmt->src.string.base;
+	unsigned      len  = stmt->src.string.size;
+	if (!src || !base || (len == 0))
+		return true;
+
+	const char* first
+		= ofc_sparse_file_pointer(src, base);
+	const char* last
+		= ofc_sparse_file_pointer(src, &base[len - 1]);
+	if (!first || !last || (last < first))
+		return false;
+
+	*text = first;
+	*size = ((last - first) + 1);
+	return true;
+}
+
+static bool ofc_parse_stmt__file_equal(
+	const ofc_file_t* a, const ofc_file_t* b)
+{
+	if (!a || !b)
+		return (a == b);
+
+	unsigned size = ofc_file_get_size(a);
+	return ((ofc_file_get_size(b) == size)
+		&& (memcmp(ofc_file_get_strz(a),
+			ofc_file_get_strz(b), size) == 0));
+}
+
+bool ofc_parse_stmt_text_equal(
+	const ofc_parse_stmt_t* a,
+	const ofc_parse_stmt_t* b)
+{
+	if (!a || !b)
+		return (a == b);
+
+	if (a->type != b->type)
+		return false;
+
+	const char* atext, * btext;
+	unsigned    asize, bsize;
+	if (!ofc_parse_stmt__file_text(a, &atext, &asize)
+		|| !ofc_parse_stmt__file_text(b, &btext, &bsize)
+		|| (asize != bsize)
+		|| ((asize > 0) && (memcmp(atext, btext, asize) != 0)))
+		return false;
+
+	ofc_parse_stmt__include_list_t ainclude = { NULL, 0, 0 };
+	ofc_parse_stmt__include_list_t binclude = { NULL, 0, 0 };
+
+	bool equal = (ofc_parse_stmt_include_foreach(a, &ainclude,
+			(void*)ofc_parse_stmt__include_list_add)
+		&& ofc_parse_stmt_include_foreach(b, &binclude,
+			(void*)ofc_parse_stmt__include_list_add)
+		&& (ainclude.count == binclude.count));
+
+	unsigned i;
+	for (i = 0; equal && (i < ainclude.count); i++)
+	{
+		equal = ofc_parse_stmt__file_equal(
+			ainclude.file[i], binclude.file[i]);
+	}
+
+	free(ainclude.file);
+	free(binclude.file);
+	return equal;
+}
+
+bool ofc_parse_stmt_position_equal(
+	const ofc_parse_stmt_t* a,
+	const ofc_parse_stmt_t* b)
+{
+	if (!a || !b)
+		return false;
+
+	const char* atext, * btext;
+	unsigned    asize, bsize;
+	if (!ofc_parse_stmt__file_text(a, &atext, &asize)
+		|| !ofc_parse_stmt__file_text(b, &btext, &bsize)
+		|| !atext || !btext)
+		return false;
+
+	unsigned arow, acol, brow, bcol;
+	return (ofc_file_get_position(
+			ofc_sparse_file(a->src.sparse), atext, &arow, &acol)
+		&& ofc_file_get_position(
+			ofc_sparse_file(b->src.sparse), btext, &brow, &bcol)
+		&& (arow == brow) && (acol == bcol));
+}
+
 bool ofc_parse_stmt_list_contains_error(
 	const ofc_parse_stmt_list_t* list)
 {
@@ -95,6 +95,7 @@ static unsigned ofc_parse_stmt_if__then(
 	bool expect_end = true;
 
 	stmt->if_then.block_else = NULL;
+	stmt->if_then.end_if_has_label = false;
 	len = ofc_parse_keyword(
 		src, &ptr[i], debug,
 		OFC_PARSE_KEYWORD_ELSE);
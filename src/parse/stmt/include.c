@@ -65,18 +65,15 @@ unsigned ofc_parse_stmt_include(
 		= ofc_sparse_lang_opts(src);
 	if (!lang_opts) return 0;
 
-	stmt->include.file = ofc_file_create_include(
-		path, *lang_opts, ofc_sparse_file(src), include_stmt);
-
-	if (!stmt->include.file)
+	if (!ofc_prep_include(
+		path, *lang_opts, ofc_sparse_file(src), include_stmt,
+		&stmt->include.file, &stmt->include.src))
 	{
 		ofc_sparse_error(src, ofc_str_ref(ptr, i),
 			"Can't open include file '%s'", path);
 		return 0;
 	}
 
-	stmt->include.src = ofc_prep(stmt->include.file);
-
 	if (!ofc_parse_file_include(
 		stmt->include.src, list, debug))
 	{
@@ -173,8 +173,16 @@ bool ofc_parse_stmt_io_print(
 		|| !ofc_colstr_atomic_writef(cs, " "))
 		return false;
 
-	if (stmt->io.iolist)
+	/* READ stores its iolist as a list of LHS. */
+	if (stmt->type == OFC_PARSE_STMT_IO_READ)
+	{
+		if (stmt->io_read.iolist)
+			ofc_parse_lhs_list_print(cs, stmt->io_read.iolist, false);
+	}
+	else if (stmt->io.iolist)
+	{
 		ofc_parse_expr_list_print(cs, stmt->io.iolist);
+	}
 	return true;
 }
 
@@ -121,7 +121,7 @@ unsigned ofc_parse_stmt_program_end(
 	if (i == 0) return 0;
 
 	ofc_parse_stmt_t* stmt
-		= (ofc_parse_stmt_t*)malloc(
+		= (ofc_parse_stmt_t*)ofc_arena_node_alloc(
 			sizeof(ofc_parse_stmt_t));
 	if(!stmt) return 0;
 
@@ -129,7 +129,7 @@ unsigned ofc_parse_stmt_program_end(
 		= ofc_parse_stmt_list_create();
 	if (!body)
 	{
-		free(stmt);
+		ofc_arena_node_free(stmt);
 		return 0;
 	}
 
@@ -153,7 +153,7 @@ unsigned ofc_parse_stmt_program_end(
 
 	if (!ofc_parse_stmt_list_add(body, stmt))
 	{
-		free(stmt);
+		ofc_arena_node_free(stmt);
 		ofc_parse_stmt_list_delete(body);
 		return 0;
 	}
@@ -83,7 +83,7 @@ static const ofc_parse_type__keyword_t ofc_parse_type__keyword_map[] =
 	{ OFC_PARSE_TYPE_NONE            , 0 },
 };
 
-ofc_parse_type_t* ofc_parse_type(
+static ofc_parse_type_t* ofc_parse_type__parse(
 	const ofc_sparse_t* src, const char* ptr,
 	ofc_parse_debug_t* debug,
 	unsigned* len)
@@ -258,6 +258,49 @@ ofc_parse_type_t* ofc_parse_type(
 
 
 
+ofc_parse_type_t* ofc_parse_type(
+	const ofc_sparse_t* src, const char* ptr,
+	ofc_parse_debug_t* debug,
+	unsigned* len)
+{
+	return ofc_parse_debug_memo(
+		debug, OFC_PARSE_MEMO_TYPE,
+		src, ptr, len,
+		(void*)ofc_parse_type__parse,
+		(void*)ofc_parse_type_copy,
+		(void*)ofc_parse_type_delete);
+}
+
+ofc_parse_type_t* ofc_parse_type_copy(
+	const ofc_parse_type_t* type)
+{
+	if (!type)
+		return NULL;
+
+	ofc_parse_type_t copy = *type;
+
+	copy.count_expr = ofc_parse_expr_copy(type->count_expr);
+	if (type->count_expr && !copy.count_expr)
+		return NULL;
+
+	copy.params = ofc_parse_call_arg_list_copy(type->params);
+	if (type->params && !copy.params)
+	{
+		ofc_parse_expr_delete(copy.count_expr);
+		return NULL;
+	}
+
+	ofc_parse_type_t* acopy
+		= ofc_parse_type__alloc(copy);
+	if (!acopy)
+	{
+		ofc_parse_type__cleanup(copy);
+		return NULL;
+	}
+
+	return acopy;
+}
+
 void ofc_parse_type_delete(ofc_parse_type_t* type)
 {
 	if (!type)
@@ -15,32 +15,33 @@
 
 #include <stdlib.h>
 
-#include "ofc/fctype.h"
 #include "ofc/prep.h"
+#include "ofc/util/scan.h"
 
 
 ofc_sparse_t* ofc_prep_condense(ofc_sparse_t* unformat)
 {
 	const char* src = ofc_sparse_strz(unformat);
 	if (!src) return NULL;
+	unsigned len = ofc_sparse_len(unformat);
 
 	ofc_sparse_t* condense
 		= ofc_sparse_create_child(unformat);
 	if (!condense) return NULL;
 
 	unsigned i = 0;
-	while (src[i] != '\0')
+	while (i < len)
 	{
 		/* Skip whitespace. */
-		for (; (src[i] != '\0') && ofc_is_hspace(src[i]); i++);
+		i += ofc_scan_hspace(&src[i], (len - i));
 
-		if (src[i] == '\0')
+		if (i >= len)
 			break;
 
 		/* Parse non-whitespace. */
 		const char* base = &src[i];
-		unsigned size;
-		for(size = 0; (src[i] != '\0') && !ofc_is_hspace(src[i]); size++, i++);
+		unsigned size = ofc_scan_non_hspace(&src[i], (len - i));
+		i += size;
 
 		/* Append non-whitespace to condense sparse. */
 		if (!ofc_sparse_append_strn(condense, base, size))
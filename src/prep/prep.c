@@ -13,19 +13,162 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ofc/prep.h"
+#include "ofc/vector.h"
 
 
 ofc_sparse_t* ofc_prep(ofc_file_t* file)
 {
-	ofc_sparse_t* unformat
-		= ofc_prep_unformat(file);
-	if (!unformat) return NULL;
-
-	ofc_sparse_t* condense
-		= ofc_prep_condense(unformat);
-	ofc_sparse_delete(unformat);
-	return condense;
+	return ofc_prep_unformat_condense(file);
+}
+
+
+/* Include files are commonly included by every routine in a file, and by
+   every file in a build, so they're preprocessed once per process. Only
+   include files which preprocess without diagnostics are cached, so that
+   every inclusion reports the same diagnostics as it would otherwise. */
+typedef struct
+{
+	ofc_lang_opts_t opts;
+	ofc_sparse_t*   sparse;
+} ofc_prep__include_t;
+
+OFC_VECTOR_DEFINE(ofc_prep__include_vector, ofc_prep__include_t)
+
+static pthread_mutex_t      ofc_prep__include_lock  = PTHREAD_MUTEX_INITIALIZER;
+static ofc_prep__include_t* ofc_prep__include       = NULL;
+static unsigned             ofc_prep__include_count = 0;
+static unsigned             ofc_prep__include_size  = 0;
+
+static bool ofc_prep__lang_opts_equal(
+	ofc_lang_opts_t a, ofc_lang_opts_t b)
+{
+	return ((a.form == b.form)
+		&& (a.tab_width == b.tab_width)
+		&& (a.debug == b.debug)
+		&& (a.columns == b.columns));
+}
+
+/* Must be called with the include lock held. */
+static ofc_prep__include_t* ofc_prep__include_find(
+	const char* path, ofc_lang_opts_t opts)
+{
+	unsigned i;
+	for (i = 0; i < ofc_prep__include_count; i++)
+	{
+		ofc_prep__include_t* include = &ofc_prep__include[i];
+		const char* ipath = ofc_file_get_path(
+			ofc_sparse_file(include->sparse));
+		if (ipath && (strcmp(ipath, path) == 0)
+			&& ofc_prep__lang_opts_equal(include->opts, opts))
+			return include;
+	}
+
+	return NULL;
+}
+
+static ofc_sparse_t* ofc_prep__include_get(
+	const char* path, ofc_lang_opts_t opts)
+{
+	pthread_mutex_lock(&ofc_prep__include_lock);
+
+	ofc_sparse_t* sparse = NULL;
+	ofc_prep__include_t* include
+		= ofc_prep__include_find(path, opts);
+	if (include)
+	{
+		if (ofc_file_changed(ofc_sparse_file(include->sparse)))
+		{
+			ofc_sparse_delete(include->sparse);
+			*include = ofc_prep__include[--ofc_prep__include_count];
+		}
+		else if (ofc_sparse_reference(include->sparse))
+		{
+			sparse = include->sparse;
+		}
+	}
+
+	pthread_mutex_unlock(&ofc_prep__include_lock);
+	return sparse;
+}
+
+static void ofc_prep__include_add(
+	ofc_sparse_t* sparse, ofc_lang_opts_t opts)
+{
+	const char* path = ofc_file_get_path(
+		ofc_sparse_file(sparse));
+	if (!path) return;
+
+	pthread_mutex_lock(&ofc_prep__include_lock);
+
+	/* Another thread may have cached it first. */
+	if (!ofc_prep__include_find(path, opts))
+	{
+		if (ofc_prep__include_vector_reserve(&ofc_prep__include,
+				ofc_prep__include_count, &ofc_prep__include_size, 1)
+			&& ofc_sparse_reference(sparse))
+		{
+			ofc_prep__include[ofc_prep__include_count].opts   = opts;
+			ofc_prep__include[ofc_prep__include_count].sparse = sparse;
+			ofc_prep__include_count++;
+		}
+	}
+
+	pthread_mutex_unlock(&ofc_prep__include_lock);
+}
+
+bool ofc_prep_include(
+	const char* path, ofc_lang_opts_t opts,
+	const ofc_file_t* parent_file, ofc_sparse_ref_t include_stmt,
+	ofc_file_t** file, ofc_sparse_t** src)
+{
+	if (!file || !src)
+		return false;
+
+	char* rpath = ofc_file_include_resolve(
+		path, parent_file);
+	if (!rpath) return false;
+
+	ofc_sparse_t* cached
+		= ofc_prep__include_get(rpath, opts);
+	free(rpath);
+
+	if (cached)
+	{
+		ofc_file_t* ifile = ofc_file_create_include_shared(
+			ofc_sparse_file(cached), parent_file, include_stmt);
+		ofc_sparse_t* sparse
+			= ofc_sparse_create_alias(cached, ifile);
+		ofc_sparse_delete(cached);
+
+		if (sparse)
+		{
+			*file = ifile;
+			*src  = sparse;
+			return true;
+		}
+
+		ofc_file_delete(ifile);
+	}
+
+	ofc_file_t* ifile = ofc_file_create_include(
+		path, opts, parent_file, include_stmt);
+	if (!ifile) return false;
+
+	unsigned errors   = ofc_file_error_count();
+	unsigned warnings = ofc_file_warning_count();
+
+	ofc_sparse_t* sparse = ofc_prep(ifile);
+	if (sparse
+		&& (ofc_file_error_count() == errors)
+		&& (ofc_file_warning_count() == warnings))
+		ofc_prep__include_add(sparse, opts);
+
+	*file = ifile;
+	*src  = sparse;
+	return true;
 }
@@ -19,10 +19,81 @@
 
 #include "ofc/fctype.h"
 #include "ofc/prep.h"
+#include "ofc/util/scan.h"
+#include "ofc/vector.h"
+
+
+typedef struct
+{
+	unsigned off, len;
+} ofc_prep_unformat__run_t;
+
+OFC_VECTOR_DEFINE(ofc_prep_unformat__run_vector, ofc_prep_unformat__run_t)
+
+typedef struct
+{
+	ofc_sparse_t* sparse;
+
+	/* Non-space runs of the unformat text, recorded as it's built
+	   when the condensed form is wanted too. */
+	bool condense;
+	unsigned run_count, run_size;
+	ofc_prep_unformat__run_t* run;
+} ofc_prep_unformat__out_t;
+
+static bool ofc_prep_unformat__run_add(
+	ofc_prep_unformat__out_t* out, unsigned off, unsigned len)
+{
+	/* Runs which meet in the unformat text are a single run. */
+	if (out->run_count > 0)
+	{
+		ofc_prep_unformat__run_t* last
+			= &out->run[out->run_count - 1];
+		if ((last->off + last->len) == off)
+		{
+			last->len += len;
+			return true;
+		}
+	}
+
+	if (!ofc_prep_unformat__run_vector_reserve(
+		&out->run, out->run_count, &out->run_size, 1))
+		return false;
+
+	out->run[out->run_count].off = off;
+	out->run[out->run_count].len = len;
+	out->run_count++;
+	return true;
+}
+
+static bool ofc_prep_unformat__append(
+	ofc_prep_unformat__out_t* out, const char* src, unsigned len)
+{
+	unsigned base = ofc_sparse_len(out->sparse);
+	if (!ofc_sparse_append_strn(out->sparse, src, len))
+		return false;
+
+	if (!out->condense)
+		return true;
+
+	unsigned i = 0;
+	while (i < len)
+	{
+		i += ofc_scan_hspace(&src[i], (len - i));
+		if (i >= len) break;
+
+		unsigned size = ofc_scan_non_hspace(&src[i], (len - i));
+		if (!ofc_prep_unformat__run_add(out, (base + i), size))
+			return false;
+		i += size;
+	}
+
+	return true;
+}
 
 
 static unsigned ofc_prep_unformat__blank_or_comment(
-	const ofc_file_t* file, const char* src,
+	const ofc_file_t* file, const char* src, unsigned size,
 	const ofc_lang_opts_t* opts)
 {
 	if (!src || !opts)
@@ -84,7 +155,7 @@ static unsigned ofc_prep_unformat__blank_or_comment(
 			" may clash with the preprocessor");
 	}
 
-	for (; (src[i] != '\0') && !ofc_is_vspace(src[i]); i++);
+	i += ofc_scan_line(&src[i], (size - i));
 	return (ofc_is_vspace(src[i]) ? (i + 1) : i);
 }
 
@@ -227,7 +298,7 @@ static unsigned ofc_prep_unformat__fixed_form_code(
 	unsigned* col, pre_state_t* state,
 	const ofc_file_t* file, const char* src,
 	const ofc_lang_opts_t* opts, bool extend,
-	ofc_sparse_t* sparse)
+	ofc_prep_unformat__out_t* out)
 {
 	if (!src || !opts)
 		return 0;
@@ -324,8 +395,8 @@ static unsigned ofc_prep_unformat__fixed_form_code(
 		(*col)++;
 	}
 
-	if (sparse && !ofc_sparse_append_strn(
-		sparse, src, i))
+	if (out && !ofc_prep_unformat__append(
+		out, src, i))
 		return 0;
 
 	return i;
@@ -335,7 +406,7 @@ static unsigned ofc_prep_unformat__free_form_code(
 	unsigned* col, pre_state_t* state,
 	const ofc_file_t* file, const char* src,
 	const ofc_lang_opts_t* opts,
-	ofc_sparse_t* sparse, bool* continuation)
+	ofc_prep_unformat__out_t* out, bool* continuation)
 {
 	if (!src)
 		return 0;
@@ -464,17 +535,18 @@ static unsigned ofc_prep_unformat__free_form_code(
 	if (valid_ampersand)
 		code_len = last_ampersand;
 
-	if (sparse && !ofc_sparse_append_strn(
-		sparse, src, code_len))
+	if (out && !ofc_prep_unformat__append(
+		out, src, code_len))
 		return 0;
 
 	return i;
 }
 
 static bool ofc_prep_unformat__fixed_form(
-	const ofc_file_t* file, ofc_sparse_t* sparse)
+	const ofc_file_t* file, ofc_prep_unformat__out_t* out)
 {
 	const char*     src   = ofc_file_get_strz(file);
+	unsigned        size  = ofc_file_get_size(file);
 	pre_state_t     state = PRE_STATE_DEFAULT;
 
 	const ofc_lang_opts_t* opts
@@ -498,7 +570,7 @@ static bool ofc_prep_unformat__fixed_form(
 		unsigned len, col;
 
 		len = ofc_prep_unformat__blank_or_comment(
-			file, &src[pos], opts);
+			file, &src[pos], (size - pos), opts);
 		pos += len;
 		if (len > 0) continue;
 
@@ -562,7 +634,7 @@ static bool ofc_prep_unformat__fixed_form(
 		/* Insert single newline character at the end of each line of output. */
 		if ((has_code || has_label)
 			&& !first_code_line && !continuation
-			&& !ofc_sparse_append_strn(sparse, newline, 1))
+			&& !ofc_prep_unformat__append(out, newline, 1))
 			return false;
 
 		if (has_code)
@@ -570,13 +642,13 @@ static bool ofc_prep_unformat__fixed_form(
 			if (has_label)
 			{
 				/* Mark current position in unformat stream as label. */
-				if (!ofc_sparse_label_add(sparse, label))
+				if (!ofc_sparse_label_add(out->sparse, label))
 					return false;
 			}
 
 			/* Append non-empty line to output. */
 			len = ofc_prep_unformat__fixed_form_code(
-				&col, &state, file, &src[pos], opts, extend, sparse);
+				&col, &state, file, &src[pos], opts, extend, out);
 			pos += len;
 			if (len == 0) return false;
 
@@ -591,7 +663,7 @@ static bool ofc_prep_unformat__fixed_form(
 		}
 
 		/* Skip to the actual end of the line, including all ignored characters. */
-		for (; (src[pos] != '\0') && !ofc_is_vspace(src[pos]); pos++);
+		pos += ofc_scan_line(&src[pos], (size - pos));
 
 		if (has_code)
 			newline = &src[pos];
@@ -604,9 +676,10 @@ static bool ofc_prep_unformat__fixed_form(
 }
 
 static bool ofc_prep_unformat__free_form(
-	const ofc_file_t* file, ofc_sparse_t* sparse)
+	const ofc_file_t* file, ofc_prep_unformat__out_t* out)
 {
 	const char*     src   = ofc_file_get_strz(file);
+	unsigned        size  = ofc_file_get_size(file);
 	pre_state_t     state = PRE_STATE_DEFAULT;
 
 	const ofc_lang_opts_t* opts
@@ -631,7 +704,7 @@ static bool ofc_prep_unformat__free_form(
 		unsigned len, col;
 
 		len = ofc_prep_unformat__blank_or_comment(
-			file, &src[pos], opts);
+			file, &src[pos], (size - pos), opts);
 		pos += len;
 		if (len > 0) {
 			continue;
@@ -682,17 +755,17 @@ static bool ofc_prep_unformat__free_form(
 			if (has_label)
 			{
 				/* Mark current position in unformat stream as label. */
-				if (!ofc_sparse_label_add(sparse, label))
+				if (!ofc_sparse_label_add(out->sparse, label))
 					return false;
 			}
 
 			if (!first_code_line && !continuation
-				&& !ofc_sparse_append_strn(sparse, newline, 1))
+				&& !ofc_prep_unformat__append(out, newline, 1))
 				return false;
 
 			len = ofc_prep_unformat__free_form_code(
 				&col, &state, file, &src[pos], opts,
-				sparse, &continuation);
+				out, &continuation);
 			pos += len;
 			if (len == 0) return false;
 
@@ -710,7 +783,7 @@ static bool ofc_prep_unformat__free_form(
 		}
 
 		/* Skip to the actual end of the line, including all ignored characters. */
-		for (; (src[pos] != '\0') && !ofc_is_vspace(src[pos]); pos++);
+		pos += ofc_scan_line(&src[pos], (size - pos));
 
 		if (has_code)
 			newline = &src[pos];
@@ -722,24 +795,24 @@ static bool ofc_prep_unformat__free_form(
 	return true;
 }
 
-ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file)
+static bool ofc_prep_unformat__out(
+	ofc_file_t* file, ofc_prep_unformat__out_t* out)
 {
 	const ofc_lang_opts_t* lang_opts
 		= ofc_file_get_lang_opts(file);
-	if (!lang_opts) return NULL;
+	if (!lang_opts) return false;
 
-	ofc_sparse_t* unformat
-		= ofc_sparse_create_file(file);
-	if (!unformat) return NULL;
+	out->sparse = ofc_sparse_create_file(file);
+	if (!out->sparse) return false;
 
 	bool success = false;
 	switch (lang_opts->form)
 	{
 		case OFC_LANG_FORM_FIXED:
-			success = ofc_prep_unformat__fixed_form(file, unformat);
+			success = ofc_prep_unformat__fixed_form(file, out);
 			break;
 		case OFC_LANG_FORM_FREE:
-			success = ofc_prep_unformat__free_form(file, unformat);
+			success = ofc_prep_unformat__free_form(file, out);
 			break;
 		default:
 			break;
@@ -747,10 +820,74 @@ ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file)
 
 	if (!success)
 	{
-		ofc_sparse_delete(unformat);
+		ofc_sparse_delete(out->sparse);
+		out->sparse = NULL;
+		return false;
+	}
+
+	ofc_sparse_lock(out->sparse);
+	return true;
+}
+
+ofc_sparse_t* ofc_prep_unformat(ofc_file_t* file)
+{
+	ofc_prep_unformat__out_t out =
+	{
+		.sparse    = NULL,
+		.condense  = false,
+		.run_count = 0,
+		.run_size  = 0,
+		.run       = NULL,
+	};
+
+	if (!ofc_prep_unformat__out(file, &out))
+		return NULL;
+	return out.sparse;
+}
+
+ofc_sparse_t* ofc_prep_unformat_condense(ofc_file_t* file)
+{
+	ofc_prep_unformat__out_t out =
+	{
+		.sparse    = NULL,
+		.condense  = true,
+		.run_count = 0,
+		.run_size  = 0,
+		.run       = NULL,
+	};
+
+	if (!ofc_prep_unformat__out(file, &out))
+	{
+		free(out.run);
 		return NULL;
 	}
 
-	ofc_sparse_lock(unformat);
-	return unformat;
+	/* The runs were found while unformatting, so the
+	   unformat text doesn't need to be scanned again. */
+	const char* src = ofc_sparse_strz(out.sparse);
+
+	ofc_sparse_t* condense
+		= ofc_sparse_create_child(out.sparse);
+	ofc_sparse_delete(out.sparse);
+	if (!condense)
+	{
+		free(out.run);
+		return NULL;
+	}
+
+	unsigned i;
+	for (i = 0; i < out.run_count; i++)
+	{
+		if (!ofc_sparse_append_strn(condense,
+			&src[out.run[i].off], out.run[i].len))
+		{
+			ofc_sparse_delete(condense);
+			free(out.run);
+			return NULL;
+		}
+	}
+	free(out.run);
+
+	ofc_sparse_lock(condense);
+	return condense;
 }
@@ -664,18 +664,12 @@ void ofc_sema_array_index_delete(
 }
 
 
-ofc_sema_array_index_t* ofc_sema_array_index_from_offset(
-	const ofc_sema_decl_t* decl, unsigned offset)
+bool ofc_sema_array_bounds(
+	const ofc_sema_array_t* array,
+	int* first, unsigned* count)
 {
-	if (!ofc_sema_decl_is_array(decl))
-		return NULL;
-
-	ofc_sema_array_t* array
-		= decl->array;
-	if (!array) return NULL;
-
-	int      first[array->dimensions];
-	unsigned count[array->dimensions];
+	if (!array || !first || !count)
+		return false;
 
 	unsigned i;
 	for (i = 0; i < array->dimensions; i++)
@@ -684,58 +678,28 @@ ofc_sema_array_index_t* ofc_sema_array_index_from_offset(
 		if (array->segment[i].first
 			&& !ofc_sema_expr_resolve_int(
 				array->segment[i].first, &first[i]))
-			return NULL;
+			return false;
 
 		int last;
 		if (!ofc_sema_expr_resolve_int(
 			array->segment[i].last, &last))
-			return NULL;
+			return false;
 
 		if (last < first[i])
-			return NULL;
+			return false;
 
 		count[i] = ((last + 1) - first[i]);
 	}
 
-	int idx[array->dimensions];
-	for (i = 0; i < array->dimensions; i++)
-	{
-		idx[i] = first[i] + (offset % count[i]);
-		offset /= count[i];
-	}
-
-	ofc_sema_array_index_t* index
-		= (ofc_sema_array_index_t*)malloc(sizeof(ofc_sema_array_index_t)
-				+ (array->dimensions * sizeof(ofc_sema_expr_t*)));
-	if (!index) return NULL;
-
-	bool success = true;
-	index->dimensions = array->dimensions;
-	for (i = 0; i < array->dimensions; i++)
-	{
-		index->index[i] = ofc_sema_expr_integer(
-			idx[i], OFC_SEMA_KIND_DEFAULT);
-
-		if (!index->index[i])
-			success = false;
-	}
-
-	if (!success)
-	{
-		ofc_sema_array_index_delete(index);
-		return NULL;
-	}
-
-	return index;
+	return true;
 }
 
-ofc_sema_array_index_t* ofc_sema_array_slice_index_from_offset(
-	const ofc_sema_array_slice_t* slice, unsigned offset)
+bool ofc_sema_array_slice_bounds(
+	const ofc_sema_array_slice_t* slice,
+	int* first, unsigned* count)
 {
-	if (!slice) return NULL;
-
-	int      first[slice->dimensions];
-	unsigned count[slice->dimensions];
+	if (!slice || !first || !count)
+		return false;
 
 	unsigned i;
 	for (i = 0; i < slice->dimensions; i++)
@@ -744,7 +708,7 @@ ofc_sema_array_index_t* ofc_sema_array_slice_index_from_offset(
 		if (slice->segment[i].first
 			&& !ofc_sema_expr_resolve_int(
 				slice->segment[i].first, &first[i]))
-			return NULL;
+			return false;
 
 		if(slice->segment[i].is_index)
 		{
@@ -755,39 +719,36 @@ ofc_sema_array_index_t* ofc_sema_array_slice_index_from_offset(
 		int last;
 		if (!ofc_sema_expr_resolve_int(
 			slice->segment[i].last, &last))
-			return NULL;
+			return false;
 
 		if (last < first[i])
-			return NULL;
+			return false;
 
 		count[i] = ((last + 1) - first[i]);
 	}
 
-	int idx[slice->dimensions];
-	for (i = 0; i < slice->dimensions; i++)
-	{
-		if (count[i] == 0)
-		{
-			idx[i] = first[i];
-			continue;
-		}
-
-		idx[i] = first[i] + (offset % count[i]);
-		offset /= count[i];
+	return true;
+}
 
-	}
+ofc_sema_array_index_t* ofc_sema_array_index_create(
+	unsigned dimensions, const int* idx)
+{
+	if (!idx)
+		return NULL;
 
 	ofc_sema_array_index_t* index
 		= (ofc_sema_array_index_t*)malloc(sizeof(ofc_sema_array_index_t)
-				+ (slice->dimensions * sizeof(ofc_sema_expr_t*)));
+				+ (dimensions * sizeof(ofc_sema_expr_t*)));
 	if (!index) return NULL;
 
 	bool success = true;
-	index->dimensions = slice->dimensions;
-	for (i = 0; i < slice->dimensions; i++)
+	index->dimensions = dimensions;
+	unsigned i;
+	for (i = 0; i < dimensions; i++)
 	{
 		index->index[i] = ofc_sema_expr_integer(
 			idx[i], OFC_SEMA_KIND_DEFAULT);
+
 		if (!index->index[i])
 			success = false;
 	}
@@ -801,7 +762,64 @@ ofc_sema_array_index_t* ofc_sema_array_slice_index_from_offset(
 	return index;
 }
 
+ofc_sema_array_index_t* ofc_sema_array_index_from_offset(
+	const ofc_sema_decl_t* decl, unsigned offset)
+{
+	if (!ofc_sema_decl_is_array(decl))
+		return NULL;
+
+	ofc_sema_array_t* array
+		= decl->array;
+	if (!array) return NULL;
+
+	int      first[array->dimensions];
+	unsigned count[array->dimensions];
+	if (!ofc_sema_array_bounds(array, first, count))
+		return NULL;
+
+	int idx[array->dimensions];
+	unsigned i;
+	for (i = 0; i < array->dimensions; i++)
+	{
+		idx[i] = first[i] + (offset % count[i]);
+		offset /= count[i];
+	}
+
+	return ofc_sema_array_index_create(
+		array->dimensions, idx);
+}
+
+ofc_sema_array_index_t* ofc_sema_array_slice_index_from_offset(
+	const ofc_sema_array_slice_t* slice, unsigned offset)
+{
+	if (!slice) return NULL;
+
+	int      first[slice->dimensions];
+	unsigned count[slice->dimensions];
+	if (!ofc_sema_array_slice_bounds(slice, first, count))
+		return NULL;
+
+	int idx[slice->dimensions];
+	unsigned i;
+	for (i = 0; i < slice->dimensions; i++)
+	{
+		if (count[i] == 0)
+		{
+			idx[i] = first[i];
+			continue;
+		}
+
+		idx[i] = first[i] + (offset % count[i]);
+		offset /= count[i];
+
+	}
+
+	return ofc_sema_array_index_create(
+		slice->dimensions, idx);
+}
+
 bool ofc_sema_array_index_offset(
+	ofc_sparse_ref_t              src,
 	const ofc_sema_decl_t*        decl,
 	const ofc_sema_array_index_t* index,
 	unsigned* offset)
@@ -811,8 +829,7 @@ bool ofc_sema_array_index_offset(
 
 	if (!ofc_sema_decl_is_array(decl))
 	{
-		/* TODO - Positional error. */
-		ofc_sparse_ref_error(OFC_SPARSE_REF_EMPTY,
+		ofc_sparse_ref_error(src,
 			"Can't index non-array type");
 		return false;
 	}
@@ -824,8 +841,7 @@ bool ofc_sema_array_index_offset(
 	if (index->dimensions
 		!= array->dimensions)
 	{
-		/* TODO - Positional error. */
-		ofc_sparse_ref_error(OFC_SPARSE_REF_EMPTY,
+		ofc_sparse_ref_error(src,
 			"Index dimensions don't match array");
 		return false;
 	}
@@ -14,6 +14,11 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_common__decl_vector, const ofc_sema_decl_t*)
+OFC_VECTOR_DEFINE(ofc_sema_common__vector, ofc_sema_common_t*)
 
 
 ofc_sema_common_t* ofc_sema_common_create(
@@ -25,6 +30,7 @@ ofc_sema_common_t* ofc_sema_common_create(
 	if (!common) return NULL;
 
 	common->count = 0;
+	common->size  = 0;
 	common->decl  = NULL;
 	common->save  = false;
 
@@ -49,11 +55,9 @@ bool ofc_sema_common_add(
 	if (!common || !decl)
 		return false;
 
-	const ofc_sema_decl_t** ndecl
-		= (const ofc_sema_decl_t**)realloc(common->decl,
-			sizeof(const ofc_sema_decl_t*) * (common->count + 1));
-	if (!ndecl) return false;
-	common->decl = ndecl;
+	if (!ofc_sema_common__decl_vector_reserve(
+		&common->decl, common->count, &common->size, 1))
+		return false;
 
 	common->decl[common->count] = decl;
 	common->count++;
@@ -170,6 +174,7 @@ ofc_sema_common_map_t* ofc_sema_common_map_create(
 	}
 
 	map->count  = 0;
+	map->size   = 0;
 	map->common = NULL;
 
 	return map;
@@ -219,11 +224,9 @@ bool ofc_sema_common_map_add(
 		map->map, &common->name))
 		return false;
 
-	ofc_sema_common_t** ncommon
-		= (ofc_sema_common_t**)realloc(map->common,
-			(sizeof(ofc_sema_common_t*) * (map->count + 1)));
-	if (!ncommon) return false;
-	map->common = ncommon;
+	if (!ofc_sema_common__vector_reserve(
+		&map->common, map->count, &map->size, 1))
+		return false;
 
 	if (!ofc_hashmap_add(
 		map->map, common))
@@ -15,6 +15,14 @@
 
 #include "ofc/sema.h"
 #include "ofc/global.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_decl__alias_vector, ofc_sema_decl_alias_t*)
+OFC_VECTOR_DEFINE(ofc_sema_decl_list__vector, ofc_sema_decl_t*)
+OFC_VECTOR_DEFINE(ofc_sema_decl_list__hole_vector, unsigned)
+OFC_VECTOR_DEFINE(ofc_sema_decl_init_array__run_vector, ofc_sema_decl_init_run_t)
+OFC_VECTOR_DEFINE(ofc_sema_decl_init_array__substring_vector, ofc_sema_decl_init_substring_t)
 
 
 static void ofc_sema_decl_init__delete(
@@ -31,6 +39,534 @@ static void ofc_sema_decl_init__delete(
 	}
 }
 
+static ofc_sema_decl_init_array_t* ofc_sema_decl_init_array__create(void)
+{
+	ofc_sema_decl_init_array_t* array
+		= (ofc_sema_decl_init_array_t*)malloc(
+			sizeof(ofc_sema_decl_init_array_t));
+	if (!array) return NULL;
+
+	array->run_count  = 0;
+	array->run_size   = 0;
+	array->run_sorted = 0;
+	array->run        = NULL;
+
+	array->merge = true;
+
+	array->set_size = 0;
+	array->set      = NULL;
+
+	array->substring_count = 0;
+	array->substring_size  = 0;
+	array->substring       = NULL;
+	return array;
+}
+
+static void ofc_sema_decl_init_array__delete(
+	ofc_sema_decl_init_array_t* array)
+{
+	if (!array)
+		return;
+
+	unsigned i;
+	for (i = 0; i < array->run_count; i++)
+		ofc_sema_expr_delete(array->run[i].expr);
+	free(array->run);
+	free(array->set);
+
+	for (i = 0; i < array->substring_count; i++)
+	{
+		free(array->substring[i].string);
+		free(array->substring[i].mask);
+	}
+	free(array->substring);
+
+	free(array);
+}
+
+/* Returns the index of the first sorted run which ends after offset,
+   this is the run containing offset or the insertion point. */
+static unsigned ofc_sema_decl_init_array__run_find(
+	const ofc_sema_decl_init_array_t* array, unsigned offset)
+{
+	unsigned lo = 0, hi = array->run_sorted;
+
+	/* Sequential initialization almost always hits the last run. */
+	if ((hi > 0) && (array->run[hi - 1].first <= offset))
+	{
+		const ofc_sema_decl_init_run_t* last = &array->run[hi - 1];
+		return ((offset - last->first) < last->count ? (hi - 1) : hi);
+	}
+
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) / 2);
+		const ofc_sema_decl_init_run_t* run = &array->run[mid];
+		if ((offset >= run->first)
+			&& ((offset - run->first) < run->count))
+			return mid;
+
+		if (run->first > offset)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+static unsigned ofc_sema_decl_init_array__substring_find(
+	const ofc_sema_decl_init_array_t* array, unsigned offset)
+{
+	unsigned lo = 0, hi = array->substring_count;
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) / 2);
+		if (array->substring[mid].offset < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static int ofc_sema_decl_init_run__compare(
+	const ofc_sema_decl_init_run_t* a,
+	const ofc_sema_decl_init_run_t* b)
+{
+	if (a->first != b->first)
+		return (a->first < b->first ? -1 : 1);
+	return 0;
+}
+
+/* Only initializers copied from the same source expression are merged,
+   so that every element of a run would print identically. */
+static bool ofc_sema_decl_init__run_match(
+	const ofc_sema_expr_t* a,
+	const ofc_sema_expr_t* b)
+{
+	if ((a->src.string.base == NULL)
+		|| (a->src.string.base != b->src.string.base)
+		|| (a->src.string.size != b->src.string.size))
+		return false;
+
+	return ofc_sema_expr_compare(a, b);
+}
+
+/* Sorts the runs set out of order into place, joining them with their
+   neighbours as they'd have been if they were set in order. */
+static bool ofc_sema_decl_init_array__sort(
+	ofc_sema_decl_init_array_t* array)
+{
+	if (!array)
+		return false;
+
+	if (array->run_sorted >= array->run_count)
+		return true;
+
+	ofc_sema_decl_init_run_t* run
+		= (ofc_sema_decl_init_run_t*)malloc(
+			sizeof(ofc_sema_decl_init_run_t) * array->run_count);
+	if (!run) return false;
+
+	ofc_sema_decl_init_run_t* tail
+		= &array->run[array->run_sorted];
+	unsigned tail_count
+		= (array->run_count - array->run_sorted);
+	qsort(tail, tail_count, sizeof(ofc_sema_decl_init_run_t),
+		(void*)ofc_sema_decl_init_run__compare);
+
+	unsigned i = 0, j = 0, count = 0;
+	while ((i < array->run_sorted) || (j < tail_count))
+	{
+		ofc_sema_decl_init_run_t next;
+		if ((j >= tail_count)
+			|| ((i < array->run_sorted)
+				&& (array->run[i].first < tail[j].first)))
+			next = array->run[i++];
+		else
+			next = tail[j++];
+
+		ofc_sema_decl_init_run_t* prev
+			= (count > 0 ? &run[count - 1] : NULL);
+		if (array->merge && prev
+			&& ((prev->first + prev->count) == next.first)
+			&& ofc_sema_decl_init__run_match(prev->expr, next.expr))
+		{
+			prev->count += next.count;
+			ofc_sema_expr_delete(next.expr);
+			continue;
+		}
+
+		run[count++] = next;
+	}
+
+	free(array->run);
+	array->run        = run;
+	array->run_count  = count;
+	array->run_size   = array->run_count;
+	array->run_sorted = array->run_count;
+
+	free(array->set);
+	array->set      = NULL;
+	array->set_size = 0;
+	return true;
+}
+
+/* Reports whether an element is held by any run, without sorting. */
+static bool ofc_sema_decl_init_array__run_set(
+	const ofc_sema_decl_init_array_t* array, unsigned offset)
+{
+	if ((offset >> 3) < array->set_size)
+	{
+		if (array->set[offset >> 3] & (1U << (offset & 7)))
+			return true;
+	}
+
+	unsigned r = ofc_sema_decl_init_array__run_find(array, offset);
+	return ((r < array->run_sorted)
+		&& (array->run[r].first <= offset));
+}
+
+static const ofc_sema_decl_init_run_t* ofc_sema_decl_init_array__run(
+	ofc_sema_decl_init_array_t* array, unsigned offset)
+{
+	if (!ofc_sema_decl_init_array__sort(array))
+		return NULL;
+
+	unsigned r = ofc_sema_decl_init_array__run_find(array, offset);
+	if ((r >= array->run_count)
+		|| (array->run[r].first > offset))
+		return NULL;
+	return &array->run[r];
+}
+
+static ofc_sema_decl_init_substring_t* ofc_sema_decl_init_array__substring(
+	const ofc_sema_decl_init_array_t* array, unsigned offset)
+{
+	if (!array)
+		return NULL;
+
+	unsigned s = ofc_sema_decl_init_array__substring_find(array, offset);
+	if ((s >= array->substring_count)
+		|| (array->substring[s].offset != offset))
+		return NULL;
+	return &array->substring[s];
+}
+
+/* The returned initializer is borrowed from the array. */
+static ofc_sema_decl_init_t ofc_sema_decl_init_array__get(
+	ofc_sema_decl_init_array_t* array, unsigned offset)
+{
+	ofc_sema_decl_init_t init;
+	init.is_substring = false;
+	init.expr = NULL;
+
+	const ofc_sema_decl_init_run_t* run
+		= ofc_sema_decl_init_array__run(array, offset);
+	if (run)
+	{
+		init.expr = run->expr;
+		return init;
+	}
+
+	const ofc_sema_decl_init_substring_t* substring
+		= ofc_sema_decl_init_array__substring(array, offset);
+	if (substring)
+	{
+		init.is_substring     = true;
+		init.substring.string = substring->string;
+		init.substring.mask   = substring->mask;
+	}
+
+	return init;
+}
+
+/* Sequential variant of ofc_sema_decl_init_array__get, the hints must
+   start at zero and offsets must be visited in increasing order. */
+static ofc_sema_decl_init_t ofc_sema_decl_init_array__next(
+	ofc_sema_decl_init_array_t* array, unsigned offset,
+	unsigned* run_hint, unsigned* substring_hint)
+{
+	ofc_sema_decl_init_t init;
+	init.is_substring = false;
+	init.expr = NULL;
+
+	if (!ofc_sema_decl_init_array__sort(array))
+		return init;
+
+	unsigned r = *run_hint;
+	while ((r < array->run_count)
+		&& ((array->run[r].first + array->run[r].count) <= offset))
+		r++;
+	*run_hint = r;
+
+	if ((r < array->run_count)
+		&& (array->run[r].first <= offset))
+	{
+		init.expr = array->run[r].expr;
+		return init;
+	}
+
+	unsigned s = *substring_hint;
+	while ((s < array->substring_count)
+		&& (array->substring[s].offset < offset))
+		s++;
+	*substring_hint = s;
+
+	if ((s < array->substring_count)
+		&& (array->substring[s].offset == offset))
+	{
+		init.is_substring     = true;
+		init.substring.string = array->substring[s].string;
+		init.substring.mask   = array->substring[s].mask;
+	}
+
+	return init;
+}
+
+static bool ofc_sema_decl_init_array__mark(
+	ofc_sema_decl_init_array_t* array, unsigned offset)
+{
+	if ((offset >> 3) >= array->set_size)
+	{
+		unsigned nsize = ofc_vector_size(
+			array->set_size, ((offset >> 3) + 1));
+		unsigned char* nset
+			= (unsigned char*)realloc(array->set, nsize);
+		if (!nset) return false;
+		memset(&nset[array->set_size], 0x00,
+			(nsize - array->set_size));
+		array->set      = nset;
+		array->set_size = nsize;
+	}
+
+	array->set[offset >> 3] |= (1U << (offset & 7));
+	return true;
+}
+
+/* Appends a run that's out of order, it stays unsorted until the
+   initializer is finalized so that no runs need to be moved. */
+static bool ofc_sema_decl_init_array__append(
+	ofc_sema_decl_init_array_t* array,
+	unsigned offset, ofc_sema_expr_t* expr)
+{
+	if (!ofc_sema_decl_init_array__run_vector_reserve(
+			&array->run, array->run_count, &array->run_size, 1)
+		|| !ofc_sema_decl_init_array__mark(array, offset))
+		return false;
+
+	array->run[array->run_count].first = offset;
+	array->run[array->run_count].count = 1;
+	array->run[array->run_count].expr  = expr;
+	array->run_count++;
+	return true;
+}
+
+/* Takes ownership of expr, offset must not already be initialized. */
+static bool ofc_sema_decl_init_array__set(
+	ofc_sema_decl_init_array_t* array,
+	unsigned offset, ofc_sema_expr_t* expr,
+	bool merge)
+{
+	if (!merge)
+		array->merge = false;
+
+	if (array->run_sorted < array->run_count)
+	{
+		/* Joining ascending elements keeps the unsorted runs few. */
+		ofc_sema_decl_init_run_t* last
+			= &array->run[array->run_count - 1];
+		if (merge
+			&& ((last->first + last->count) == offset)
+			&& ofc_sema_decl_init__run_match(last->expr, expr))
+		{
+			if (!ofc_sema_decl_init_array__mark(array, offset))
+				return false;
+			ofc_sema_expr_delete(expr);
+			last->count++;
+			return true;
+		}
+
+		return ofc_sema_decl_init_array__append(
+			array, offset, expr);
+	}
+
+	unsigned r = ofc_sema_decl_init_array__run_find(array, offset);
+
+	ofc_sema_decl_init_run_t* prev
+		= ((r > 0) ? &array->run[r - 1] : NULL);
+	if (prev && ((prev->first + prev->count) != offset))
+		prev = NULL;
+
+	ofc_sema_decl_init_run_t* next
+		= ((r < array->run_count) ? &array->run[r] : NULL);
+	if (next && (next->first != (offset + 1)))
+		next = NULL;
+
+	/* Filling the gap between two runs would join them, that's left
+	   to the sort so that the runs after them aren't moved. */
+	if (merge && prev
+		&& ofc_sema_decl_init__run_match(prev->expr, expr)
+		&& (!next || !ofc_sema_decl_init__run_match(next->expr, expr)))
+	{
+		ofc_sema_expr_delete(expr);
+		prev->count++;
+		return true;
+	}
+
+	if (merge && next
+		&& ofc_sema_decl_init__run_match(next->expr, expr)
+		&& (!prev || !ofc_sema_decl_init__run_match(prev->expr, expr)))
+	{
+		ofc_sema_expr_delete(expr);
+		next->first--;
+		next->count++;
+		return true;
+	}
+
+	if (r < array->run_count)
+	{
+		return ofc_sema_decl_init_array__append(
+			array, offset, expr);
+	}
+
+	if (!ofc_sema_decl_init_array__run_vector_reserve(
+		&array->run, array->run_count, &array->run_size, 1))
+		return false;
+
+	array->run[r].first = offset;
+	array->run[r].count = 1;
+	array->run[r].expr  = expr;
+	array->run_count++;
+	array->run_sorted = array->run_count;
+	return true;
+}
+
+static ofc_sema_decl_init_substring_t* ofc_sema_decl_init_array__substring_add(
+	ofc_sema_decl_init_array_t* array,
+	unsigned offset, unsigned size, unsigned len)
+{
+	char* string = (char*)malloc(size);
+	if (!string) return NULL;
+
+	bool* mask = (bool*)malloc(
+		sizeof(bool) * len);
+	if (!mask)
+	{
+		free(string);
+		return NULL;
+	}
+
+	unsigned i;
+	for (i = 0; i < len; i++)
+		mask[i] = false;
+
+	if (!ofc_sema_decl_init_array__substring_vector_reserve(
+		&array->substring, array->substring_count, &array->substring_size, 1))
+	{
+		free(mask);
+		free(string);
+		return NULL;
+	}
+
+	unsigned s = ofc_sema_decl_init_array__substring_find(array, offset);
+	memmove(&array->substring[s + 1], &array->substring[s],
+		(array->substring_count - s) * sizeof(ofc_sema_decl_init_substring_t));
+	array->substring[s].offset = offset;
+	array->substring[s].string = string;
+	array->substring[s].mask   = mask;
+	array->substring_count++;
+
+	return &array->substring[s];
+}
+
+/* Writes a constant expression initializer to one element,
+   reporting conflicts with any existing initializer. */
+static bool ofc_sema_decl_init_array__elem(
+	ofc_sema_decl_init_array_t* array,
+	unsigned offset,
+	const ofc_sema_expr_t* init,
+	const ofc_sema_type_t* type,
+	bool merge)
+{
+	/* Extending the last run with the same uncast value is the common
+	   case for repeated initializers, so handle it without a copy. */
+	unsigned r = array->run_count;
+	if (merge && (r > 0)
+		&& (array->run_sorted == r)
+		&& ((array->run[r - 1].first + array->run[r - 1].count) == offset))
+	{
+		const ofc_sema_expr_t* prev = array->run[r - 1].expr;
+		if (ofc_sema_type_compatible(
+				ofc_sema_expr_type(init), type)
+			&& ofc_sema_decl_init__run_match(prev, init))
+		{
+			array->run[r - 1].count++;
+			return true;
+		}
+	}
+
+	ofc_sema_expr_t* expr
+		= ofc_sema_expr_copy(init);
+	if (!expr) return false;
+
+	if (!ofc_sema_type_compatible(
+		ofc_sema_expr_type(expr), type))
+	{
+		ofc_sema_expr_t* cast
+			= ofc_sema_expr_cast(
+				expr, type);
+		if (!cast)
+		{
+			ofc_sparse_ref_error(init->src,
+				"Incompatible types in initializer");
+			ofc_sema_expr_delete(expr);
+			return false;
+		}
+		expr = cast;
+	}
+
+	/* Only a conflict needs the runs to be sorted. */
+	const ofc_sema_decl_init_run_t* run = NULL;
+	if (ofc_sema_decl_init_array__run_set(array, offset))
+		run = ofc_sema_decl_init_array__run(array, offset);
+	if (run)
+	{
+		bool equal = ofc_sema_expr_compare(
+			run->expr, expr);
+		ofc_sema_expr_delete(expr);
+
+		if (!equal)
+		{
+			ofc_sparse_ref_error(init->src,
+				"Re-initialization of array element"
+				" with different value");
+			return false;
+		}
+
+		ofc_sparse_ref_warning(init->src,
+			"Re-initialization of array element");
+		return true;
+	}
+
+	if (ofc_sema_decl_init_array__substring(array, offset))
+	{
+		ofc_sparse_ref_error(init->src,
+			"Conflicting initializer types for array element");
+		ofc_sema_expr_delete(expr);
+		return false;
+	}
+
+	if (!ofc_sema_decl_init_array__set(
+		array, offset, expr, merge))
+	{
+		ofc_sema_expr_delete(expr);
+		return false;
+	}
+
+	return true;
+}
+
 
 bool ofc_sema_decl_is_final(
 	const ofc_sema_decl_t* decl)
@@ -39,6 +575,7 @@ bool ofc_sema_decl_is_final(
 }
 
 ofc_sema_decl_t* ofc_sema_decl_create(
+	ofc_symbol_table_t* symbols,
 	const ofc_sema_implicit_t* implicit,
 	ofc_sparse_ref_t name)
 {
@@ -49,6 +586,14 @@ ofc_sema_decl_t* ofc_sema_decl_create(
 
 	decl->name = name;
 
+	decl->symbol = ofc_symbol(symbols, name.string);
+	if (symbols && name.string.base
+		&& (decl->symbol == OFC_SYMBOL_NONE))
+	{
+		free(decl);
+		return NULL;
+	}
+
 	decl->type = NULL;
 	decl->type_implicit = true;
 	decl->type_final    = false;
@@ -104,6 +649,9 @@ ofc_sema_decl_t* ofc_sema_decl_create(
 	decl->was_written = false;
 	decl->is_stmt_func_arg = false;
 
+	decl->arena = ofc_arena_current();
+	ofc_arena_reference(decl->arena);
+
 	decl->refcnt = 0;
 	return decl;
 }
@@ -861,11 +1409,14 @@ ofc_sema_decl_t* ofc_sema_decl_copy(
 		return false;
 	}
 
+	/* The symbol is copied along with the rest of the decl. */
 	ofc_sema_decl_t* copy
-		= ofc_sema_decl_create(NULL, decl->name);
+		= ofc_sema_decl_create(NULL, NULL, decl->name);
 	if (!copy) return NULL;
 
+	ofc_arena_t* arena = copy->arena;
 	memcpy(copy, decl, sizeof(ofc_sema_decl_t));
+	copy->arena  = arena;
 	copy->refcnt = 0;
 
 	copy->array     = NULL;
@@ -931,17 +1482,8 @@ void ofc_sema_decl_delete(
 
 	if (ofc_sema_decl_is_composite(decl))
 	{
-		if (decl->init_array)
-		{
-			unsigned count = 0;
-			ofc_sema_decl_elem_count(decl, &count);
-
-			unsigned i;
-			for (i = 0; i < count; i++)
-				ofc_sema_decl_init__delete(decl->init_array[i]);
-
-			free(decl->init_array);
-		}
+		ofc_sema_decl_init_array__delete(
+			decl->init_array);
 	}
 	else
 	{
@@ -951,7 +1493,11 @@ void ofc_sema_decl_delete(
 	ofc_sema_array_delete(decl->array);
 	ofc_sema_structure_delete(decl->structure);
 	ofc_sema_scope_delete(decl->func);
+
+	/* Release the arena last, as it may hold our members. */
+	ofc_arena_t* arena = decl->arena;
 	free(decl);
+	ofc_arena_delete(arena);
 }
 
 static const ofc_str_ref_t* ofc_sema_decl_alias__key(
@@ -1000,6 +1546,7 @@ ofc_sema_decl_alias_map_t* ofc_sema_decl_alias_map_create(void)
 	if (!map) return NULL;
 
 	map->count = 0;
+	map->size  = 0;
 	map->list = NULL;
 
 	map->map = ofc_hashmap_create(
@@ -1024,11 +1571,9 @@ bool ofc_sema_decl_alias_map_add(
 	if (!map || !alias)
 		return false;
 
-	ofc_sema_decl_alias_t** nlist
-		= (ofc_sema_decl_alias_t**)realloc(map->list,
-			(sizeof(ofc_sema_decl_alias_t*) * (map->count + 1)));
-	if (!nlist) return false;
-	map->list = nlist;
+	if (!ofc_sema_decl__alias_vector_reserve(
+		&map->list, map->count, &map->size, 1))
+		return false;
 
 	if (!ofc_hashmap_add(
 		map->map, alias))
@@ -1235,16 +1780,8 @@ bool ofc_sema_decl_init_offset(
 
 	if (!decl->init_array)
 	{
-		decl->init_array = (ofc_sema_decl_init_t*)malloc(
-			sizeof(ofc_sema_decl_init_t) * elem_count);
+		decl->init_array = ofc_sema_decl_init_array__create();
 		if (!decl->init_array) return false;
-
-		unsigned i;
-		for (i = 0; i < elem_count; i++)
-		{
-			decl->init_array[i].is_substring = false;
-			decl->init_array[i].expr = NULL;
-		}
 	}
 
 	if (!ofc_sema_expr_is_constant(init))
@@ -1254,10 +1791,6 @@ bool ofc_sema_decl_init_offset(
 		return false;
 	}
 
-	ofc_sema_expr_t* expr
-		= ofc_sema_expr_copy(init);
-	if (!expr) return false;
-
 	const ofc_sema_type_t* dtype = decl->type;
 	if (decl->structure)
 	{
@@ -1279,52 +1812,9 @@ bool ofc_sema_decl_init_offset(
 		dtype = mdecl->type;
 	}
 
-	if (!ofc_sema_type_compatible(
-		ofc_sema_expr_type(expr), dtype))
-	{
-		ofc_sema_expr_t* cast
-			= ofc_sema_expr_cast(
-				expr, dtype);
-		if (!cast)
-		{
-			ofc_sparse_ref_error(init->src,
-				"Incompatible types in initializer");
-			ofc_sema_expr_delete(expr);
-			return false;
-		}
-		expr = cast;
-	}
-
-	if (decl->init_array[offset].is_substring)
-	{
-		ofc_sparse_ref_error(init->src,
-			"Conflicting initializer types for array element");
-		ofc_sema_expr_delete(expr);
-		return false;
-	}
-	else if (decl->init_array[offset].expr)
-	{
-		bool equal = ofc_sema_expr_compare(
-			decl->init_array[offset].expr, expr);
-		ofc_sema_expr_delete(expr);
-
-		if (!equal)
-		{
-			ofc_sparse_ref_error(init->src,
-				"Re-initialization of array element"
-				" with different value");
-			return false;
-		}
-
-		ofc_sparse_ref_warning(init->src,
-			"Re-initialization of array element");
-	}
-	else
-	{
-		decl->init_array[offset].expr = expr;
-	}
-
-	return true;
+	return ofc_sema_decl_init_array__elem(
+		decl->init_array, offset, init, dtype,
+		(decl->structure == NULL));
 }
 
 bool ofc_sema_decl_init_array(
@@ -1381,16 +1871,8 @@ bool ofc_sema_decl_init_array(
 
 	if (!decl->init_array)
 	{
-		decl->init_array = (ofc_sema_decl_init_t*)malloc(
-			sizeof(ofc_sema_decl_init_t) * elem_count);
+		decl->init_array = ofc_sema_decl_init_array__create();
 		if (!decl->init_array) return false;
-
-		unsigned i;
-		for (i = 0; i < elem_count; i++)
-		{
-			decl->init_array[i].is_substring = false;
-			decl->init_array[i].expr = NULL;
-		}
 	}
 
 	if (!array)
@@ -1412,54 +1894,9 @@ bool ofc_sema_decl_init_array(
 				return false;
 			}
 
-			ofc_sema_expr_t* expr
-				= ofc_sema_expr_copy(init[i]);
-			if (!expr) return false;
-
-			if (!ofc_sema_type_compatible(
-				ofc_sema_expr_type(expr), decl->type))
-			{
-				ofc_sema_expr_t* cast
-					= ofc_sema_expr_cast(
-						expr, decl->type);
-				if (!cast)
-				{
-					ofc_sparse_ref_error(init[i]->src,
-						"Incompatible types in initializer");
-					ofc_sema_expr_delete(expr);
-					return false;
-				}
-				expr = cast;
-			}
-
-			if (decl->init_array[i].is_substring)
-			{
-				ofc_sparse_ref_error(init[i]->src,
-					"Conflicting initializer types for array element");
-				ofc_sema_expr_delete(expr);
+			if (!ofc_sema_decl_init_array__elem(
+				decl->init_array, i, init[i], decl->type, true))
 				return false;
-			}
-			if (decl->init_array[i].expr)
-			{
-				bool equal = ofc_sema_expr_compare(
-					decl->init_array[i].expr, expr);
-				ofc_sema_expr_delete(expr);
-
-				if (!equal)
-				{
-					ofc_sparse_ref_error(init[i]->src,
-						"Re-initialization of array element"
-						" with different value");
-					return false;
-				}
-
-				ofc_sparse_ref_warning(init[i]->src,
-					"Re-initialization of array element");
-			}
-			else
-			{
-				decl->init_array[i].expr = expr;
-			}
 		}
 	}
 	else
@@ -1746,19 +2183,11 @@ bool ofc_sema_decl_init_substring_offset(
 
 	if (!decl->init_array)
 	{
-		decl->init_array = (ofc_sema_decl_init_t*)malloc(
-			sizeof(ofc_sema_decl_init_t) * elem_count);
+		decl->init_array = ofc_sema_decl_init_array__create();
 		if (!decl->init_array) return false;
-
-		unsigned i;
-		for (i = 0; i < elem_count; i++)
-		{
-			decl->init_array[i].is_substring = false;
-			decl->init_array[i].expr = NULL;
-		}
 	}
-	else if (!decl->init_array[offset].is_substring
-		&& (decl->init_array[offset].expr != NULL))
+	else if (ofc_sema_decl_init_array__run(
+		decl->init_array, offset))
 	{
 		/* TODO - Check if substring initializer is the same as
 		          existing initializer contents and just warn. */
@@ -1800,7 +2229,11 @@ bool ofc_sema_decl_init_substring_offset(
 		return false;
 	}
 
-	if (!decl->init.is_substring
+	ofc_sema_decl_init_substring_t* substring
+		= ofc_sema_decl_init_array__substring(
+			decl->init_array, offset);
+
+	if (!substring
 		&& (ufirst == 1)
 		&& (ulast == type->len))
 		return ofc_sema_decl_init_offset(decl, offset, init);
@@ -1881,31 +2314,15 @@ bool ofc_sema_decl_init_substring_offset(
 		return false;
 	}
 
-	if (!decl->init_array[offset].is_substring)
+	if (!substring)
 	{
-		char* string = (char*)malloc(tsize);
-		if (!string)
+		substring = ofc_sema_decl_init_array__substring_add(
+			decl->init_array, offset, tsize, type->len);
+		if (!substring)
 		{
 			ofc_sema_typeval_delete(ctv);
 			return false;
 		}
-
-		bool* mask = (bool*)malloc(
-			sizeof(bool) * type->len);
-		if (!mask)
-		{
-			free(string);
-			ofc_sema_typeval_delete(ctv);
-			return false;
-		}
-
-		unsigned i;
-		for (i = 0; i < type->len; i++)
-			mask[i] = false;
-
-		decl->init_array[offset].is_substring     = true;
-		decl->init_array[offset].substring.string = string;
-		decl->init_array[offset].substring.mask   = mask;
 	}
 
 	unsigned tcsize = tsize;
@@ -1915,9 +2332,9 @@ bool ofc_sema_decl_init_substring_offset(
 	unsigned i, j;
 	for (i = ss_offset, j = 0; j < len; i++, j++)
 	{
-		if (decl->init_array[offset].substring.mask[i])
+		if (substring->mask[i])
 		{
-			if (memcmp(&decl->init_array[offset].substring.string[i * tcsize],
+			if (memcmp(&substring->string[i * tcsize],
 				&ctv->character[j * tcsize], tcsize) != 0)
 			{
 				ofc_sparse_ref_error(init->src,
@@ -1931,9 +2348,9 @@ bool ofc_sema_decl_init_substring_offset(
 		}
 		else
 		{
-			memcpy(&decl->init_array[offset].substring.string[i * tcsize],
+			memcpy(&substring->string[i * tcsize],
 				&ctv->character[j * tcsize], tcsize);
-			decl->init_array[offset].substring.mask[i] = true;
+			substring->mask[i] = true;
 		}
 	}
 
@@ -1963,6 +2380,20 @@ bool ofc_sema_decl_init_func(
 	return true;
 }
 
+bool ofc_sema_decl_init_finalize(
+	ofc_sema_decl_t* decl)
+{
+	if (!decl)
+		return false;
+
+	if (!ofc_sema_decl_is_composite(decl)
+		|| !decl->init_array)
+		return true;
+
+	return ofc_sema_decl_init_array__sort(
+		decl->init_array);
+}
+
 
 bool ofc_sema_decl_size(
 	const ofc_sema_decl_t* decl,
@@ -2147,14 +2578,24 @@ bool ofc_sema_decl_has_initializer(
 			decl, &count))
 			return false;
 
+		const ofc_sema_decl_init_array_t* array
+			= decl->init_array;
+
 		bool partial = false;
 		unsigned i, s;
-		for (i = 0, s = 0; i < count; i++)
+		for (i = 0, s = 0; i < array->run_count; i++)
+			s += array->run[i].count;
+
+		for (i = 0; i < array->substring_count; i++)
 		{
+			ofc_sema_decl_init_t init;
+			init.is_substring     = true;
+			init.substring.string = array->substring[i].string;
+			init.substring.mask   = array->substring[i].mask;
+
 			bool elem_complete;
 			if (ofc_sema_decl_init__used(
-				decl->init_array[i], decl->type,
-				&elem_complete))
+				init, decl->type, &elem_complete))
 			{
 				if (!elem_complete)
 					partial = true;
@@ -2206,8 +2647,8 @@ bool ofc_sema_decl_is_initialized(
 		bool elem_complete = false;
 		if (decl->init_array
 			&& ofc_sema_decl_init__used(
-				decl->init_array[i], decl->type,
-				&elem_complete))
+				ofc_sema_decl_init_array__get(decl->init_array, i),
+				decl->type, &elem_complete))
 		{
 			if (elem_complete)
 				s++;
@@ -2217,7 +2658,7 @@ bool ofc_sema_decl_is_initialized(
 		{
 			ofc_sema_decl_t* member
 				= ofc_sema_structure_elem_get(
-					decl->structure, (count % modulo));
+					decl->structure, (i % modulo));
 			bool dc;
 			if (ofc_sema_decl_is_initialized(
 				member, &dc) && dc)
@@ -2263,19 +2704,15 @@ bool ofc_sema_decl_foreach_expr(
 	{
 		if (decl->init_array)
 		{
-			unsigned count;
-			if (!ofc_sema_decl_elem_count(
-				decl, &count))
+			if (!ofc_sema_decl_init_array__sort(
+				decl->init_array))
 				return false;
 
+			/* Each run shares one expression. */
 			unsigned i;
-			for (i = 0; i < count; i++)
+			for (i = 0; i < decl->init_array->run_count; i++)
 			{
-				if (decl->init_array[i].is_substring
-					|| !decl->init_array[i].expr)
-					continue;
-
-				if (!func(decl->init_array[i].expr, param))
+				if (!func(decl->init_array->run[i].expr, param))
 					return false;
 			}
 		}
@@ -2305,10 +2742,10 @@ bool ofc_sema_decl_foreach_scope(
 }
 
 
-static const ofc_str_ref_t* ofc_sema_decl__key(
+static const ofc_symbol_t* ofc_sema_decl__key(
 	const ofc_sema_decl_t* decl)
 {
-	return (decl ? &decl->name.string : NULL);
+	return (decl ? &decl->symbol : NULL);
 }
 
 bool ofc_sema_decl_list__remap(
@@ -2324,6 +2761,7 @@ bool ofc_sema_decl_list__remap(
 }
 
 static ofc_sema_decl_list_t* ofc_sema_decl_list__create(
+	const ofc_symbol_table_t* symbols,
 	bool case_sensitive, bool is_ref)
 {
 	ofc_sema_decl_list_t* list
@@ -2331,6 +2769,7 @@ static ofc_sema_decl_list_t* ofc_sema_decl_list__create(
 			sizeof(ofc_sema_decl_list_t));
 	if (!list) return NULL;
 
+	list->symbols        = symbols;
 	list->case_sensitive = case_sensitive;
 
 	list->count  = 0;
@@ -2338,13 +2777,17 @@ static ofc_sema_decl_list_t* ofc_sema_decl_list__create(
 	list->decl   = NULL;
 	list->is_ref = is_ref;
 
+	list->hole_count = 0;
+	list->hole_size  = 0;
+	list->hole       = NULL;
+
 	list->map = ofc_hashmap_create(
 		(void*)(list->case_sensitive
-			? ofc_str_ref_ptr_hash
-			: ofc_str_ref_ptr_hash_ci),
+			? ofc_symbol_ptr_hash
+			: ofc_symbol_ptr_hash_ci),
 		(void*)(list->case_sensitive
-			? ofc_str_ref_ptr_equal
-			: ofc_str_ref_ptr_equal_ci),
+			? ofc_symbol_ptr_equal
+			: ofc_symbol_ptr_equal_ci),
 		(void*)ofc_sema_decl__key, NULL);
 	if (!list->map)
 	{
@@ -2356,17 +2799,17 @@ static ofc_sema_decl_list_t* ofc_sema_decl_list__create(
 }
 
 ofc_sema_decl_list_t* ofc_sema_decl_list_create(
-	bool case_sensitive)
+	const ofc_symbol_table_t* symbols, bool case_sensitive)
 {
 	return ofc_sema_decl_list__create(
-		case_sensitive, false);
+		symbols, case_sensitive, false);
 }
 
 ofc_sema_decl_list_t* ofc_sema_decl_list_create_ref(
-	bool case_sensitive)
+	const ofc_symbol_table_t* symbols, bool case_sensitive)
 {
 	return ofc_sema_decl_list__create(
-		case_sensitive, true);
+		symbols, case_sensitive, true);
 }
 
 void ofc_sema_decl_list_delete(
@@ -2380,15 +2823,63 @@ void ofc_sema_decl_list_delete(
 	if (!list->is_ref)
 	{
 		unsigned i;
-		for (i = 0; i < list->size; i++)
+		for (i = 0; i < list->count; i++)
 			ofc_sema_decl_delete(list->decl[i]);
 	}
 
 	free(list->decl);
+	free(list->hole);
 
 	free(list);
 }
 
+/* The holes are a binary min-heap, so that the lowest emptied slot
+   is reused first and the declarations stay towards the front. */
+static void ofc_sema_decl_list__hole_push(
+	ofc_sema_decl_list_t* list, unsigned slot)
+{
+	/* If there's no room to record the slot it's lost. */
+	if (!ofc_sema_decl_list__hole_vector_reserve(
+		&list->hole, list->hole_count, &list->hole_size, 1))
+		return;
+
+	unsigned i = list->hole_count++;
+	while (i > 0)
+	{
+		unsigned parent = ((i - 1) / 2);
+		if (list->hole[parent] <= slot)
+			break;
+		list->hole[i] = list->hole[parent];
+		i = parent;
+	}
+	list->hole[i] = slot;
+}
+
+static unsigned ofc_sema_decl_list__hole_pop(
+	ofc_sema_decl_list_t* list)
+{
+	unsigned slot = list->hole[0];
+	unsigned last = list->hole[--list->hole_count];
+
+	unsigned i = 0;
+	while (true)
+	{
+		unsigned child = ((i * 2) + 1);
+		if (child >= list->hole_count)
+			break;
+		if (((child + 1) < list->hole_count)
+			&& (list->hole[child + 1] < list->hole[child]))
+			child++;
+		if (last <= list->hole[child])
+			break;
+		list->hole[i] = list->hole[child];
+		i = child;
+	}
+	list->hole[i] = last;
+
+	return slot;
+}
+
 bool ofc_sema_decl_list_add(
 	ofc_sema_decl_list_t* list,
 	ofc_sema_decl_t* decl)
@@ -2398,47 +2889,29 @@ bool ofc_sema_decl_list_add(
 		return false;
 
 	/* Check for duplicate definitions. */
-	if (ofc_sema_decl_list_find(
-		list, decl->name.string))
+	if (ofc_hashmap_find(
+		list->map, &decl->symbol))
 		return false;
 
-	unsigned slot;
-	if (list->count >= list->size)
+	/* Reuse the lowest emptied slot, live declarations never
+	   move so the order they're printed in is stable. */
+	if (list->hole_count == 0)
 	{
-		unsigned nsize = list->count + 1;
-		ofc_sema_decl_t** ndecl
-			= (ofc_sema_decl_t**)realloc(list->decl,
-				(sizeof(ofc_sema_decl_t*) * nsize));
-		if (!ndecl) return false;
-		list->decl = ndecl;
-
-		unsigned i;
-		for (i = list->size; i < nsize; i++)
-			list->decl[i] = NULL;
-
-		slot = list->size;
-		list->size = nsize;
-	}
-	else
-	{
-		unsigned i;
-		for (i = 0; i < list->size; i++)
-		{
-			if (list->decl[i] == NULL)
-			{
-				slot = i;
-				break;
-			}
-		}
-		if (i == list->size)
+		/* The slots can't be reserved in place as they're packed. */
+		ofc_sema_decl_t** slots = list->decl;
+		if (!ofc_sema_decl_list__vector_reserve(
+			&slots, list->count, &list->size, 1))
 			return false;
+		list->decl = slots;
 	}
 
 	if (!ofc_hashmap_add(list->map, decl))
 		return false;
 
+	unsigned slot = (list->hole_count > 0
+		? ofc_sema_decl_list__hole_pop(list)
+		: list->count++);
 	list->decl[slot] = decl;
-	list->count++;
 	return true;
 }
 
@@ -2451,15 +2924,15 @@ bool ofc_sema_decl_list_add_ref(
 		return false;
 
 	/* Check for duplicate definitions. */
-	if (ofc_sema_decl_list_find(
-		list, decl->name.string))
+	if (ofc_hashmap_find(
+		list->map, &decl->symbol))
 		return false;
 
-	const ofc_sema_decl_t** ndecl
-		= (const ofc_sema_decl_t**)realloc(list->decl_ref,
-			(sizeof(const ofc_sema_decl_t*) * (list->count + 1)));
-	if (!ndecl) return false;
-	list->decl_ref = ndecl;
+	ofc_sema_decl_t** slots = list->decl;
+	if (!ofc_sema_decl_list__vector_reserve(
+		&slots, list->count, &list->size, 1))
+		return false;
+	list->decl = slots;
 
 	if (!ofc_hashmap_add(
 		list->map, (void*)decl))
@@ -2475,8 +2948,8 @@ const ofc_sema_decl_t* ofc_sema_decl_list_find(
 	if (!list)
 		return NULL;
 
-	return ofc_hashmap_find(
-		list->map, &name);
+	return ofc_sema_decl_list_find_symbol(list,
+		ofc_symbol_find(list->symbols, name, list->case_sensitive));
 }
 
 ofc_sema_decl_t* ofc_sema_decl_list_find_modify(
@@ -2485,8 +2958,28 @@ ofc_sema_decl_t* ofc_sema_decl_list_find_modify(
 	if (!list)
 		return NULL;
 
+	return ofc_sema_decl_list_find_symbol_modify(list,
+		ofc_symbol_find(list->symbols, name, list->case_sensitive));
+}
+
+const ofc_sema_decl_t* ofc_sema_decl_list_find_symbol(
+	const ofc_sema_decl_list_t* list, ofc_symbol_t symbol)
+{
+	if (!list || (symbol == OFC_SYMBOL_NONE))
+		return NULL;
+
+	return ofc_hashmap_find(
+		list->map, &symbol);
+}
+
+ofc_sema_decl_t* ofc_sema_decl_list_find_symbol_modify(
+	ofc_sema_decl_list_t* list, ofc_symbol_t symbol)
+{
+	if (!list || (symbol == OFC_SYMBOL_NONE))
+		return NULL;
+
 	return ofc_hashmap_find_modify(
-		list->map, &name);
+		list->map, &symbol);
 }
 
 void ofc_sema_decl_list_remove(
@@ -2498,14 +2991,13 @@ void ofc_sema_decl_list_remove(
 	ofc_hashmap_remove(list->map, decl);
 
 	unsigned i;
-	for (i = 0; i < list->size; i++)
+	for (i = 0; i < list->count; i++)
 	{
-		if (list->decl[i] && ofc_str_ref_equal(
-			list->decl[i]->name.string,
-			decl->name.string))
+		if (list->decl[i]
+			&& (list->decl[i]->symbol == decl->symbol))
 		{
+			ofc_sema_decl_list__hole_push(list, i);
 			list->decl[i] = NULL;
-			list->count--;
 			break;
 		}
 	}
@@ -2713,6 +3205,12 @@ bool ofc_sema_decl_print(ofc_colstr_t* cs,
 	bool init_partial
 		= ofc_sema_decl_has_initializer(
 			decl, &init_complete);
+
+	/* Structures are always initialized by a DATA statement,
+	   since they'd need a structure constructor here. */
+	if (ofc_sema_decl_is_structure(decl))
+		init_complete = false;
+
 	if (init_complete || init_zero)
 		f90_style = true;
 
@@ -2765,8 +3263,8 @@ bool ofc_sema_decl_print(ofc_colstr_t* cs,
 			if (!ofc_sema_decl_elem_count(decl, &count))
 				return false;
 
-			unsigned i;
-			for (i = 0; i < count; i++)
+			unsigned i, r, s;
+			for (i = 0, r = 0, s = 0; i < count; i++)
 			{
 				if (i > 0)
 				{
@@ -2775,21 +3273,25 @@ bool ofc_sema_decl_print(ofc_colstr_t* cs,
 						return false;
 				}
 
-				if (decl->init_array[i].is_substring)
+				ofc_sema_decl_init_t init
+					= ofc_sema_decl_init_array__next(
+						decl->init_array, i, &r, &s);
+
+				if (init.is_substring)
 				{
 					unsigned len;
 					for (len = 0; len < type->len; len++)
 					{
-						if (!decl->init_array[i].substring.mask[len])
+						if (!init.substring.mask[len])
 							break;
 					}
 
 					if (!ofc_colstr_write_escaped(cs, '\"',
-						decl->init_array[i].substring.string, len))
+						init.substring.string, len))
 						return false;
 				}
 				else if (!ofc_sema_expr_print(
-					cs, decl->init_array[i].expr))
+					cs, init.expr))
 				{
 					return false;
 				}
@@ -2858,8 +3360,8 @@ bool ofc_sema_decl_print(ofc_colstr_t* cs,
 			if (!ofc_sema_decl_elem_count(decl, &count))
 				return false;
 
-			unsigned i;
-			for (i = 0; i < count; i++)
+			unsigned i, r, s;
+			for (i = 0, r = 0, s = 0; i < count; i++)
 			{
 				if (i > 0)
 				{
@@ -2868,10 +3370,14 @@ bool ofc_sema_decl_print(ofc_colstr_t* cs,
 						return false;
 				}
 
-				if (decl->init_array && ofc_sema_decl_init__used(
-					decl->init_array[i], decl->type, NULL))
+				ofc_sema_decl_init_t init
+					= ofc_sema_decl_init_array__next(
+						decl->init_array, i, &r, &s);
+
+				if (ofc_sema_decl_init__used(
+					init, decl->type, NULL))
 				{
-					if (decl->init_array[i].is_substring)
+					if (init.is_substring)
 					{
 						char s[type->len];
 						memset(s, ' ', type->len);
@@ -2879,9 +3385,9 @@ bool ofc_sema_decl_print(ofc_colstr_t* cs,
 						unsigned i, len = 0;
 						for (i = 0; i < type->len; i++)
 						{
-							if (decl->init_array[i].substring.mask[len])
+							if (init.substring.mask[len])
 							{
-								s[i] = decl->init_array[i].substring.string[i];
+								s[i] = init.substring.string[i];
 								len = (i + 1);
 							}
 						}
@@ -2890,7 +3396,7 @@ bool ofc_sema_decl_print(ofc_colstr_t* cs,
 							return false;
 					}
 					else if (!ofc_sema_expr_print(
-						cs, decl->init_array[i].expr))
+						cs, init.expr))
 					{
 						return false;
 					}
@@ -3011,7 +3517,7 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 		decl, &complete))
 		return true;
 
-	if (complete)
+	if (complete && !ofc_sema_decl_is_structure(decl))
 		return true;
 
 	const ofc_print_opts_t* opts
@@ -3047,27 +3553,28 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 		|| !ofc_colstr_atomic_writef(cs, " "))
 		return false;
 
-	if (ofc_sema_decl_is_array(decl))
+	if (ofc_sema_decl_is_array(decl)
+		&& !decl->structure)
 	{
-		if (decl->structure)
-		{
-			/* TODO - Support structure arrays. */
-			return false;
-		}
-
 		unsigned count;
 		if (!ofc_sema_decl_elem_count(
 			decl, &count))
 			return false;
 
+		ofc_sema_decl_init_array_t* array
+			= decl->init_array;
+
 		/* TODO - Group by nlist in slices for a cleaner print. */
 
 		bool first;
-		unsigned i;
-		for (i = 0, first = true; i < count; i++)
-		{
-			if (!decl->init_array[i].is_substring
-				&& !decl->init_array[i].expr
+		unsigned i, r, s;
+		for (i = 0, r = 0, s = 0, first = true; i < count; i++)
+		{
+			ofc_sema_decl_init_t init
+				= ofc_sema_decl_init_array__next(
+					array, i, &r, &s);
+			if (!init.is_substring
+				&& !init.expr
 				&& !init_zero)
 				continue;
 
@@ -3092,14 +3599,37 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 		if (!ofc_colstr_atomic_writef(cs, "/"))
 			return false;
 
-		/* TODO - Compress repetitions in clist for a cleaner print. */
-
-		for (i = 0, first = true; i < count; i++)
+		/* Runs of elements sharing an initializer are printed
+		   as a single N*value entry. */
+		for (i = 0, r = 0, s = 0, first = true; i < count; i++)
 		{
-			if (!decl->init_array[i].is_substring
-				&& !decl->init_array[i].expr
-				&& !init_zero)
-				continue;
+			ofc_sema_decl_init_t init
+				= ofc_sema_decl_init_array__next(
+					array, i, &r, &s);
+
+			unsigned repeat = 1;
+			if (!init.is_substring && init.expr)
+			{
+				repeat = (array->run[r].first
+					+ array->run[r].count) - i;
+			}
+			else if (!init.is_substring)
+			{
+				unsigned next = count;
+				if ((r < array->run_count)
+					&& (array->run[r].first < next))
+					next = array->run[r].first;
+				if ((s < array->substring_count)
+					&& (array->substring[s].offset < next))
+					next = array->substring[s].offset;
+				repeat = next - i;
+
+				if (!init_zero)
+				{
+					i += (repeat - 1);
+					continue;
+				}
+			}
 
 			if (!first)
 			{
@@ -3109,13 +3639,18 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 			}
 			first = false;
 
-			if (decl->init_array[i].is_substring)
+			if ((repeat > 1)
+				&& !ofc_colstr_atomic_writef(cs, "%u*", repeat))
+				return false;
+			i += (repeat - 1);
+
+			if (init.is_substring)
 			{
 				bool u = false;
 				unsigned j, l;
 				for (j = 0, l = 0; j < decl->type->len; j++)
 				{
-					if (decl->init_array[i].substring.mask[j])
+					if (init.substring.mask[j])
 					{
 						if (u)
 						{
@@ -3131,13 +3666,13 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 				}
 
 				if (!ofc_colstr_write_escaped(cs, '\"',
-						decl->init_array[i].substring.string, l))
+						init.substring.string, l))
 					return false;
 			}
-			else if (decl->init_array[i].expr)
+			else if (init.expr)
 			{
 				if (!ofc_sema_expr_print(
-					cs, decl->init_array[i].expr))
+					cs, init.expr))
 					return false;
 			}
 			else
@@ -3158,12 +3693,21 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 			decl, &count))
 			return false;
 
+		unsigned scount;
+		if (!ofc_sema_structure_elem_count(
+			decl->structure, &scount)
+			|| (scount == 0))
+			return false;
+
 		bool first;
 		unsigned i;
 		for (i = 0, first = true; i < count; i++)
 		{
-			if (!decl->init_array[i].is_substring
-				&& !decl->init_array[i].expr
+			ofc_sema_decl_init_t init
+				= ofc_sema_decl_init_array__get(
+					decl->init_array, i);
+			if (!init.is_substring
+				&& !init.expr
 				&& !init_zero)
 				continue;
 
@@ -3175,14 +3719,22 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 			}
 			first = false;
 
-			ofc_sema_decl_t* member
-				= ofc_sema_structure_elem_get(
-					decl->structure, i);
-			if (!member) return false;
+			if (!ofc_sema_decl_print_name(cs, decl))
+				return false;
+
+			if (ofc_sema_decl_is_array(decl))
+			{
+				ofc_sema_array_index_t* index
+					= ofc_sema_array_index_from_offset(
+						decl, (i / scount));
+				bool printed = (index
+					&& ofc_sema_array_index_print(cs, index));
+				ofc_sema_array_index_delete(index);
+				if (!printed) return false;
+			}
 
-			if (!ofc_sema_decl_print_name(cs, decl)
-				|| !ofc_sema_structure_elem_print(
-					cs, decl->structure, i))
+			if (!ofc_sema_structure_elem_print(
+				cs, decl->structure, (i % scount)))
 				return false;
 		}
 
@@ -3191,8 +3743,11 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 
 		for (i = 0, first = true; i < count; i++)
 		{
-			if (!decl->init_array[i].is_substring
-				&& !decl->init_array[i].expr
+			ofc_sema_decl_init_t init
+				= ofc_sema_decl_init_array__get(
+					decl->init_array, i);
+			if (!init.is_substring
+				&& !init.expr
 				&& !init_zero)
 				continue;
 
@@ -3204,13 +3759,13 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 			}
 			first = false;
 
-			if (decl->init_array[i].is_substring)
+			if (init.is_substring)
 			{
 				bool u = false;
 				unsigned j, l;
 				for (j = 0, l = 0; j < decl->type->len; j++)
 				{
-					if (decl->init_array[i].substring.mask[j])
+					if (init.substring.mask[j])
 					{
 						if (u)
 						{
@@ -3226,20 +3781,20 @@ bool ofc_sema_decl_print_data_init(ofc_colstr_t* cs,
 				}
 
 				if (!ofc_colstr_write_escaped(cs, '\"',
-						decl->init_array[i].substring.string, l))
+						init.substring.string, l))
 					return false;
 			}
-			else if (decl->init_array[i].expr)
+			else if (init.expr)
 			{
 				if (!ofc_sema_expr_print(
-					cs, decl->init_array[i].expr))
+					cs, init.expr))
 					return false;
 			}
 			else
 			{
 				ofc_sema_decl_t* member
 					= ofc_sema_structure_elem_get(
-						decl->structure, i);
+						decl->structure, (i % scount));
 				if (!member) return false;
 
 				if (!ofc_sema_decl_is_initialized(member, NULL))
@@ -3327,7 +3882,7 @@ bool ofc_sema_decl_list_stmt_func_print(
 		return false;
 
 	unsigned i;
-	for (i = 0; i < decl_list->size; i++)
+	for (i = 0; i < decl_list->count; i++)
 	{
 		ofc_sema_decl_t* decl = decl_list->decl[i];
 		if (ofc_sema_decl_is_stmt_func(decl))
@@ -3357,7 +3912,7 @@ bool ofc_sema_decl_list_procedure_print(
 		return false;
 
 	unsigned i;
-	for (i = 0; i < decl_list->size; i++)
+	for (i = 0; i < decl_list->count; i++)
 	{
 		ofc_sema_decl_t* decl = decl_list->decl[i];
 		if (decl && decl->func)
@@ -3391,7 +3946,7 @@ bool ofc_sema_decl_list_procedure_spec_print(
 		return false;
 
 	unsigned i;
-	for (i = 0; i < decl_list->size; i++)
+	for (i = 0; i < decl_list->count; i++)
 	{
 		ofc_sema_decl_t* decl = decl_list->decl[i];
 
@@ -3420,7 +3975,7 @@ bool ofc_sema_decl_list_print(
 	unsigned i;
 
 	/* Print PARAMETERs before other declarations. */
-	for (i = 0; i < decl_list->size; i++)
+	for (i = 0; i < decl_list->count; i++)
 	{
 		ofc_sema_decl_t* decl = decl_list->decl[i];
 
@@ -3433,7 +3988,7 @@ bool ofc_sema_decl_list_print(
 			return false;
 	}
 
-	for (i = 0; i < decl_list->size; i++)
+	for (i = 0; i < decl_list->count; i++)
 	{
 		ofc_sema_decl_t* decl = decl_list->decl[i];
 
@@ -3452,7 +4007,7 @@ bool ofc_sema_decl_list_print(
 			return false;
 	}
 
-	for (i = 0; i < decl_list->size; i++)
+	for (i = 0; i < decl_list->count; i++)
 	{
 		ofc_sema_decl_t* decl = decl_list->decl[i];
 
@@ -3480,6 +4035,9 @@ bool ofc_sema_decl_list_foreach(
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 	{
+		if (!list->decl[i])
+			continue;
+
 		if (!func(list->decl[i], param))
 			return false;
 	}
@@ -3497,6 +4055,9 @@ bool ofc_sema_decl_list_foreach_expr(
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 	{
+		if (!list->decl[i])
+			continue;
+
 		if (!ofc_sema_decl_foreach_expr(
 			list->decl[i], param, func))
 			return false;
@@ -3515,6 +4076,9 @@ bool ofc_sema_decl_list_foreach_scope(
 	unsigned i;
 	for (i = 0; i < list->count; i++)
 	{
+		if (!list->decl[i])
+			continue;
+
 		if (!ofc_sema_decl_foreach_scope(
 			list->decl[i], param, func))
 			return false;
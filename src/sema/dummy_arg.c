@@ -14,6 +14,10 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_dummy_arg__vector, ofc_sema_dummy_arg_t*)
 
 void ofc_sema_dummy_arg_delete(
 	ofc_sema_dummy_arg_t* arg)
@@ -41,6 +45,7 @@ ofc_sema_dummy_arg_list_t* ofc_sema_dummy_arg_list_create(void)
 	if (!list) return NULL;
 
 	list->count = 0;
+	list->size  = 0;
 	list->dummy_arg  = NULL;
 	return list;
 }
@@ -66,12 +71,10 @@ bool ofc_sema_dummy_arg_list_add(
 	if (!list || !dummy_arg)
 		return false;
 
-	ofc_sema_dummy_arg_t** ndummy_arg
-		= (ofc_sema_dummy_arg_t**)realloc(list->dummy_arg,
-			(sizeof(ofc_sema_dummy_arg_t*) * (list->count + 1)));
-	if (!ndummy_arg) return NULL;
+	if (!ofc_sema_dummy_arg__vector_reserve(
+		&list->dummy_arg, list->count, &list->size, 1))
+		return false;
 
-	list->dummy_arg = ndummy_arg;
 	list->dummy_arg[list->count++] = dummy_arg;
 	return true;
 }
@@ -417,6 +420,7 @@ ofc_sema_dummy_arg_list_t* ofc_sema_dummy_arg_list_copy_replace(
 	}
 
 	copy->count = list->count;
+	copy->size  = list->count;
 
 	bool fail = false;
 	unsigned i;
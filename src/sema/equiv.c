@@ -14,6 +14,11 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_equiv__lhs_vector, ofc_sema_lhs_t*)
+OFC_VECTOR_DEFINE(ofc_sema_equiv__vector, ofc_sema_equiv_t*)
 
 
 ofc_sema_equiv_t* ofc_sema_equiv_create(void)
@@ -24,6 +29,7 @@ ofc_sema_equiv_t* ofc_sema_equiv_create(void)
 	if (!equiv) return NULL;
 
 	equiv->count = 0;
+	equiv->size  = 0;
 	equiv->lhs   = NULL;
 	return equiv;
 }
@@ -48,11 +54,9 @@ bool ofc_sema_equiv_add(
 	if (!equiv || !lhs)
 		return false;
 
-	ofc_sema_lhs_t** nlhs
-		= (ofc_sema_lhs_t**)realloc(equiv->lhs,
-			(sizeof(ofc_sema_lhs_t*) * (equiv->count + 1)));
-	if (!nlhs) return false;
-	equiv->lhs = nlhs;
+	if (!ofc_sema_equiv__lhs_vector_reserve(
+		&equiv->lhs, equiv->count, &equiv->size, 1))
+		return false;
 
 	ofc_sema_decl_t* decl
 		= ofc_sema_lhs_decl(lhs);
@@ -102,6 +106,7 @@ ofc_sema_equiv_list_t* ofc_sema_equiv_list_create(void)
 	if (!list) return NULL;
 
 	list->count = 0;
+	list->size  = 0;
 	list->equiv = NULL;
 	return list;
 }
@@ -127,11 +132,9 @@ bool ofc_sema_equiv_list_add(
 	if (!list || !equiv)
 		return false;
 
-	ofc_sema_equiv_t** nequiv
-		= (ofc_sema_equiv_t**)realloc(list->equiv,
-			(sizeof(ofc_sema_equiv_t*) * (list->count + 1)));
-	if (!nequiv) return false;
-	list->equiv = nequiv;
+	if (!ofc_sema_equiv__vector_reserve(
+		&list->equiv, list->count, &list->size, 1))
+		return false;
 
 	list->equiv[list->count++] = equiv;
 	return true;
@@ -14,9 +14,13 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
 #include <math.h>
 
 
+OFC_VECTOR_DEFINE(ofc_sema_expr__vector, ofc_sema_expr_t*)
+
+
 const ofc_sema_typeval_t* ofc_sema_expr_constant(
 	const ofc_sema_expr_t* expr)
 {
@@ -196,7 +200,7 @@ static ofc_sema_expr_t* ofc_sema_expr__create(
 		return NULL;
 
 	ofc_sema_expr_t* expr
-		= (ofc_sema_expr_t*)malloc(
+		= (ofc_sema_expr_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_expr_t));
 	if (!expr) return NULL;
 
@@ -1832,7 +1836,7 @@ void ofc_sema_expr_delete(
 			break;
 	}
 
-	free(expr);
+	ofc_arena_node_free(expr);
 }
 
 
@@ -1951,6 +1955,51 @@ bool ofc_sema_expr_elem_count(
 	return true;
 }
 
+ofc_sema_expr_t* ofc_sema_expr_implicit_do_iter(
+	const ofc_sema_decl_t* iter,
+	const ofc_sema_expr_t* init,
+	const ofc_sema_expr_t* step,
+	unsigned offset)
+{
+	if (!iter || !init)
+		return NULL;
+
+	const ofc_sema_typeval_t* ctv[2];
+	ctv[0] = ofc_sema_expr_constant(init);
+	ctv[1] = ofc_sema_expr_constant(step);
+
+	long double dfirst, dstep = 1.0;
+	if (!ofc_sema_typeval_get_real(ctv[0], &dfirst))
+		return NULL;
+	if (ctv[1] && !ofc_sema_typeval_get_real(ctv[1], &dstep))
+		return NULL;
+
+	long double doffset
+		= dfirst + ((long double)offset * dstep);
+
+	ofc_sema_typeval_t* dinit
+		= ofc_sema_typeval_create_real(
+			doffset, OFC_SEMA_KIND_NONE,
+			OFC_SPARSE_REF_EMPTY);
+	if (!dinit) return NULL;
+
+	ofc_sema_typeval_t* tv
+		= ofc_sema_typeval_cast(
+			dinit, iter->type);
+	ofc_sema_typeval_delete(dinit);
+	if (!tv) return NULL;
+
+	ofc_sema_expr_t* iter_expr
+		= ofc_sema_expr_typeval(tv);
+	if (!iter_expr)
+	{
+		ofc_sema_typeval_delete(tv);
+		return NULL;
+	}
+
+	return iter_expr;
+}
+
 ofc_sema_expr_t* ofc_sema_expr_elem_get(
 	const ofc_sema_expr_t* expr, unsigned offset)
 {
@@ -2015,40 +2064,11 @@ ofc_sema_expr_t* ofc_sema_expr_elem_get(
 				= (offset % sub_elem_count);
 			offset /= sub_elem_count;
 
-			const ofc_sema_typeval_t* ctv[2];
-			ctv[0] = ofc_sema_expr_constant(
-					expr->implicit_do.init);
-			ctv[1] = ofc_sema_expr_constant(
-					expr->implicit_do.step);
-
-			long double first, step = 1.0;
-			if (!ofc_sema_typeval_get_real(ctv[0], &first))
-				return NULL;
-			if (ctv[1] && !ofc_sema_typeval_get_real(ctv[1], &step))
-				return NULL;
-
-			long double doffset
-				= first + ((long double)offset * step);
-
-			ofc_sema_typeval_t* dinit
-				= ofc_sema_typeval_create_real(
-					doffset, OFC_SEMA_KIND_NONE,
-					OFC_SPARSE_REF_EMPTY);
-			if (!dinit) return NULL;
-
-			ofc_sema_typeval_t* init
-				= ofc_sema_typeval_cast(
-					dinit, expr->implicit_do.iter->type);
-			ofc_sema_typeval_delete(dinit);
-			if (!init) return NULL;
-
 			ofc_sema_expr_t* iter_expr
-				= ofc_sema_expr_typeval(init);
-			if (!iter_expr)
-			{
-				ofc_sema_typeval_delete(init);
-				return NULL;
-			}
+				= ofc_sema_expr_implicit_do_iter(
+					expr->implicit_do.iter, expr->implicit_do.init,
+					expr->implicit_do.step, offset);
+			if (!iter_expr) return NULL;
 
 			ofc_sema_expr_t* rval = NULL;
 			unsigned e = sub_offset;
@@ -2484,6 +2504,7 @@ ofc_sema_expr_list_t* ofc_sema_expr_list_create(void)
 	if (!list) return NULL;
 
 	list->count = 0;
+	list->size  = 0;
 	list->expr  = NULL;
 	return list;
 }
@@ -2523,6 +2544,7 @@ ofc_sema_expr_list_t* ofc_sema_expr_list_copy_replace(
 	}
 
 	copy->count = list->count;
+	copy->size  = list->count;
 
 	bool fail = false;
 	unsigned i;
@@ -2558,12 +2580,10 @@ bool ofc_sema_expr_list_add(
 	if (!list || !expr)
 		return false;
 
-	ofc_sema_expr_t** nexpr
-		= (ofc_sema_expr_t**)realloc(list->expr,
-			(sizeof(ofc_sema_expr_t*) * (list->count + 1)));
-	if (!nexpr) return NULL;
+	if (!ofc_sema_expr__vector_reserve(
+		&list->expr, list->count, &list->size, 1))
+		return false;
 
-	list->expr = nexpr;
 	list->expr[list->count++] = expr;
 	return true;
 }
@@ -2640,6 +2660,184 @@ ofc_sema_expr_t* ofc_sema_expr_list_elem_get(
 	return NULL;
 }
 
+struct ofc_sema_expr_cursor_s
+{
+	const ofc_sema_expr_list_t* list;
+
+	unsigned index;
+	unsigned offset;
+	unsigned count;
+	unsigned total;
+	bool     started;
+
+	unsigned                iter;
+	ofc_sema_expr_list_t*   body;
+	ofc_sema_expr_cursor_t* sub;
+
+	ofc_sema_expr_t* current;
+	bool             error;
+};
+
+ofc_sema_expr_cursor_t* ofc_sema_expr_cursor_create(
+	const ofc_sema_expr_list_t* list)
+{
+	if (!list)
+		return NULL;
+
+	ofc_sema_expr_cursor_t* cursor
+		= (ofc_sema_expr_cursor_t*)malloc(
+			sizeof(ofc_sema_expr_cursor_t));
+	if (!cursor) return NULL;
+
+	cursor->list    = list;
+	cursor->index   = 0;
+	cursor->offset  = 0;
+	cursor->count   = 0;
+	cursor->total   = 0;
+	cursor->started = false;
+	cursor->iter    = 0;
+	cursor->body    = NULL;
+	cursor->sub     = NULL;
+	cursor->current = NULL;
+	cursor->error   = false;
+	return cursor;
+}
+
+static void ofc_sema_expr_cursor__sub_end(
+	ofc_sema_expr_cursor_t* cursor)
+{
+	ofc_sema_expr_cursor_delete(cursor->sub);
+	cursor->sub = NULL;
+	ofc_sema_expr_list_delete(cursor->body);
+	cursor->body = NULL;
+}
+
+void ofc_sema_expr_cursor_delete(
+	ofc_sema_expr_cursor_t* cursor)
+{
+	if (!cursor)
+		return;
+
+	ofc_sema_expr_cursor__sub_end(cursor);
+	ofc_sema_expr_delete(cursor->current);
+	free(cursor);
+}
+
+/* Repeated values (N*value) are returned N times without being copied,
+   elements returned are only valid until the next call. */
+const ofc_sema_expr_t* ofc_sema_expr_cursor_next(
+	ofc_sema_expr_cursor_t* cursor)
+{
+	if (!cursor || cursor->error)
+		return NULL;
+
+	ofc_sema_expr_delete(cursor->current);
+	cursor->current = NULL;
+
+	for (; cursor->index < cursor->list->count; cursor->index++)
+	{
+		const ofc_sema_expr_t* expr
+			= cursor->list->expr[cursor->index];
+
+		if (!cursor->started)
+		{
+			if (!ofc_sema_expr_elem_count(
+				expr, &cursor->count))
+				break;
+
+			cursor->total = cursor->count;
+			if (expr->repeat > 1)
+				cursor->total *= expr->repeat;
+
+			cursor->offset  = 0;
+			cursor->iter    = 0;
+			cursor->started = true;
+		}
+
+		bool is_implicit_do
+			= (expr->type == OFC_SEMA_EXPR_IMPLICIT_DO);
+		const ofc_sema_expr_list_t* nested = NULL;
+		if (expr->type == OFC_SEMA_EXPR_ARRAY)
+			nested = expr->array;
+		else if (expr->type == OFC_SEMA_EXPR_RESHAPE)
+			nested = expr->reshape.source;
+
+		if ((cursor->count == 1) && !is_implicit_do)
+		{
+			if (cursor->offset < cursor->total)
+			{
+				cursor->offset++;
+				return expr;
+			}
+		}
+		else if (is_implicit_do || nested)
+		{
+			unsigned iter_count = (expr->repeat > 1 ? expr->repeat : 1);
+			if (is_implicit_do)
+				iter_count *= expr->implicit_do.count;
+
+			while (true)
+			{
+				if (cursor->sub)
+				{
+					const ofc_sema_expr_t* elem
+						= ofc_sema_expr_cursor_next(cursor->sub);
+					if (elem) return elem;
+
+					if (cursor->sub->error)
+					{
+						cursor->error = true;
+						return NULL;
+					}
+
+					ofc_sema_expr_cursor__sub_end(cursor);
+					cursor->iter++;
+				}
+
+				if ((cursor->count == 0)
+					|| (cursor->iter >= iter_count))
+					break;
+
+				if (is_implicit_do)
+				{
+					ofc_sema_expr_t* iter_expr
+						= ofc_sema_expr_implicit_do_iter(
+							expr->implicit_do.iter, expr->implicit_do.init,
+							expr->implicit_do.step,
+							(cursor->iter % expr->implicit_do.count));
+					if (!iter_expr) break;
+
+					cursor->body = ofc_sema_expr_list_copy_replace(
+						expr->implicit_do.expr, expr->implicit_do.iter, iter_expr);
+					ofc_sema_expr_delete(iter_expr);
+					if (!cursor->body) break;
+					nested = cursor->body;
+				}
+
+				cursor->sub = ofc_sema_expr_cursor_create(nested);
+				if (!cursor->sub) break;
+			}
+
+			if ((cursor->count != 0)
+				&& (cursor->iter < iter_count))
+				break;
+		}
+		else if (cursor->offset < cursor->total)
+		{
+			cursor->current = ofc_sema_expr_elem_get(
+				expr, (cursor->offset++ % cursor->count));
+			if (!cursor->current) break;
+			return cursor->current;
+		}
+
+		cursor->started = false;
+	}
+
+	if (cursor->index < cursor->list->count)
+		cursor->error = true;
+	return NULL;
+}
+
 bool ofc_sema_expr_list_compare(
 	const ofc_sema_expr_list_t* a,
 	const ofc_sema_expr_list_t* b)
@@ -14,6 +14,11 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_external__vector, ofc_sema_external_t*)
+
 
 static const ofc_str_ref_t* ofc_sema_external__key(
 	const ofc_sema_external_t* external)
@@ -31,6 +36,7 @@ ofc_sema_external_list_t* ofc_sema_external_list_create(
 
 	list->case_sensitive = case_sensitive;
 	list->count    = 0;
+	list->size     = 0;
 	list->external = NULL;
 
 	list->map = ofc_hashmap_create(
@@ -80,15 +86,13 @@ bool ofc_sema_external_list_add(
 		list, external->name.string))
 		return false;
 
-	if (!ofc_hashmap_add(list->map, external))
+	if (!ofc_sema_external__vector_reserve(
+		&list->external, list->count, &list->size, 1))
 		return false;
 
-	ofc_sema_external_t** nexternal
-		= (ofc_sema_external_t**)realloc(list->external,
-			(sizeof(ofc_sema_external_t*) * (list->count + 1)));
-	if (!nexternal) return false;
+	if (!ofc_hashmap_add(list->map, external))
+		return false;
 
-	list->external = nexternal;
 	list->external[list->count++] = external;
 
 	return true;
@@ -206,9 +206,9 @@ bool ofc_sema_implicit(
 }
 
 
-bool ofc_sema_implicit_attr(
+bool ofc_sema_implicit_rule(
 	const ofc_sema_implicit_t* implicit,
-	ofc_sparse_ref_t name,
+	char letter,
 	const ofc_sema_type_t** type,
 	bool* is_static,
 	bool* is_automatic,
@@ -216,11 +216,9 @@ bool ofc_sema_implicit_attr(
 	bool* is_intrinsic,
 	bool* is_external)
 {
-	if (!implicit
-		|| ofc_sparse_ref_empty(name)
-		|| !isalpha(*name.string.base))
+	if (!implicit || !isalpha(letter))
 		return false;
-	unsigned i = (toupper(*name.string.base) - 'A');
+	unsigned i = (toupper(letter) - 'A');
 	if (type        ) *type         = implicit->rule[i].type;
 	if (is_static   ) *is_static    = implicit->rule[i].is_static;
 	if (is_automatic) *is_automatic = implicit->rule[i].is_automatic;
@@ -230,3 +228,21 @@ bool ofc_sema_implicit_attr(
 	return true;
 }
 
+bool ofc_sema_implicit_attr(
+	const ofc_sema_implicit_t* implicit,
+	ofc_sparse_ref_t name,
+	const ofc_sema_type_t** type,
+	bool* is_static,
+	bool* is_automatic,
+	bool* is_volatile,
+	bool* is_intrinsic,
+	bool* is_external)
+{
+	if (ofc_sparse_ref_empty(name))
+		return false;
+	return ofc_sema_implicit_rule(
+		implicit, *name.string.base, type,
+		is_static, is_automatic, is_volatile,
+		is_intrinsic, is_external);
+}
+
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
+
 #include "ofc/sema.h"
 
 static const char* ofc_sema_intrinsics__reserved_list[]=
@@ -1351,6 +1353,7 @@ struct ofc_sema_intrinsic_s
 	ofc_sema_intrinsic_e type;
 
 	ofc_str_ref_t name;
+	ofc_symbol_t  symbol;
 
 	union
 	{
@@ -1359,6 +1362,10 @@ struct ofc_sema_intrinsic_s
 	};
 };
 
+/* Intrinsic names are interned in a table of their own,
+   which like the maps isn't modified once they're built. */
+static ofc_symbol_table_t* ofc_sema_intrinsic__symbols = NULL;
+
 static ofc_sema_intrinsic_t* ofc_sema_intrinsic__create_op(
 	const ofc_sema_intrinsic_op_t* op)
 {
@@ -1374,6 +1381,14 @@ static ofc_sema_intrinsic_t* ofc_sema_intrinsic__create_op(
 	intrinsic->type = OFC_SEMA_INTRINSIC_OP;
 	intrinsic->op = op;
 
+	intrinsic->symbol = ofc_symbol(
+		ofc_sema_intrinsic__symbols, intrinsic->name);
+	if (intrinsic->symbol == OFC_SYMBOL_NONE)
+	{
+		free(intrinsic);
+		return NULL;
+	}
+
 	return intrinsic;
 }
 
@@ -1392,6 +1407,14 @@ static ofc_sema_intrinsic_t* ofc_sema_intrinsic__create_func(
 	intrinsic->type = OFC_SEMA_INTRINSIC_FUNC;
 	intrinsic->func = func;
 
+	intrinsic->symbol = ofc_symbol(
+		ofc_sema_intrinsic__symbols, intrinsic->name);
+	if (intrinsic->symbol == OFC_SYMBOL_NONE)
+	{
+		free(intrinsic);
+		return NULL;
+	}
+
 	return intrinsic;
 }
 
@@ -1404,12 +1427,12 @@ static void ofc_sema_intrinsic__delete(
 	free(intrinsic);
 }
 
-static const ofc_str_ref_t* ofc_sema_intrinsic__key(
+static const ofc_symbol_t* ofc_sema_intrinsic__key(
 	const ofc_sema_intrinsic_t* intrinsic)
 {
 	if (!intrinsic)
 		return NULL;
-	return &intrinsic->name;
+	return &intrinsic->symbol;
 }
 
 static ofc_hashmap_t* ofc_sema_intrinsic__op_map          = NULL;
@@ -1423,13 +1446,14 @@ static void ofc_sema_intrinsic__term(void)
 	ofc_hashmap_delete(ofc_sema_intrinsic__op_override_map);
 	ofc_hashmap_delete(ofc_sema_intrinsic__func_map);
 	ofc_hashmap_delete(ofc_sema_intrinsic__subr_map);
+	ofc_symbol_table_delete(ofc_sema_intrinsic__symbols);
 }
 
 static bool ofc_sema_intrinsic__op_map_init(void)
 {
 	ofc_sema_intrinsic__op_map = ofc_hashmap_create(
-		(void*)ofc_str_ref_ptr_hash_ci,
-		(void*)ofc_str_ref_ptr_equal_ci,
+		(void*)ofc_symbol_ptr_hash_ci,
+		(void*)ofc_symbol_ptr_equal_ci,
 		(void*)ofc_sema_intrinsic__key,
 		(void*)ofc_sema_intrinsic__delete);
 	if (!ofc_sema_intrinsic__op_map)
@@ -1467,8 +1491,8 @@ static bool ofc_sema_intrinsic__op_map_init(void)
 static bool ofc_sema_intrinsic__op_override_map_init(void)
 {
 	ofc_sema_intrinsic__op_override_map = ofc_hashmap_create(
-		(void*)ofc_str_ref_ptr_hash_ci,
-		(void*)ofc_str_ref_ptr_equal_ci,
+		(void*)ofc_symbol_ptr_hash_ci,
+		(void*)ofc_symbol_ptr_equal_ci,
 		(void*)ofc_sema_intrinsic__key,
 		(void*)ofc_sema_intrinsic__delete);
 	if (!ofc_sema_intrinsic__op_override_map)
@@ -1506,8 +1530,8 @@ static bool ofc_sema_intrinsic__op_override_map_init(void)
 static bool ofc_sema_intrinsic__func_map_init(void)
 {
 	ofc_sema_intrinsic__func_map = ofc_hashmap_create(
-		(void*)ofc_str_ref_ptr_hash_ci,
-		(void*)ofc_str_ref_ptr_equal_ci,
+		(void*)ofc_symbol_ptr_hash_ci,
+		(void*)ofc_symbol_ptr_equal_ci,
 		(void*)ofc_sema_intrinsic__key,
 		(void*)ofc_sema_intrinsic__delete);
 	if (!ofc_sema_intrinsic__func_map)
@@ -1545,8 +1569,8 @@ static bool ofc_sema_intrinsic__func_map_init(void)
 static bool ofc_sema_intrinsic__subr_map_init(void)
 {
 	ofc_sema_intrinsic__subr_map = ofc_hashmap_create(
-		(void*)ofc_str_ref_ptr_hash_ci,
-		(void*)ofc_str_ref_ptr_equal_ci,
+		(void*)ofc_symbol_ptr_hash_ci,
+		(void*)ofc_symbol_ptr_equal_ci,
 		(void*)ofc_sema_intrinsic__key,
 		(void*)ofc_sema_intrinsic__delete);
 	if (!ofc_sema_intrinsic__subr_map)
@@ -1581,23 +1605,41 @@ static bool ofc_sema_intrinsic__subr_map_init(void)
 	return true;
 }
 
-static bool ofc_sema_intrinsic__init(void)
+/* The tables are built once and never modified afterwards,
+   so they can be read from any thread without locking. */
+static pthread_once_t ofc_sema_intrinsic__once  = PTHREAD_ONCE_INIT;
+static bool           ofc_sema_intrinsic__ready = false;
+
+static void ofc_sema_intrinsic__build(void)
 {
-	if (ofc_sema_intrinsic__op_map
-		&& ofc_sema_intrinsic__op_override_map
-		&& ofc_sema_intrinsic__func_map
-		&& ofc_sema_intrinsic__subr_map)
-		return true;
+	ofc_sema_intrinsic__symbols = ofc_symbol_table_create();
+	if (!ofc_sema_intrinsic__symbols)
+		return;
 
 	/* TODO - Set case sensitivity based on lang_opts? */
 	if (!ofc_sema_intrinsic__op_map_init()
 		|| !ofc_sema_intrinsic__op_override_map_init()
 		|| !ofc_sema_intrinsic__func_map_init()
 		|| !ofc_sema_intrinsic__subr_map_init())
-		return false;
+	{
+		ofc_sema_intrinsic__term();
+		return;
+	}
 
 	atexit(ofc_sema_intrinsic__term);
-	return true;
+	ofc_sema_intrinsic__ready = true;
+}
+
+static bool ofc_sema_intrinsic__init(void)
+{
+	pthread_once(&ofc_sema_intrinsic__once,
+		ofc_sema_intrinsic__build);
+	return ofc_sema_intrinsic__ready;
+}
+
+bool ofc_sema_intrinsic_init(void)
+{
+	return ofc_sema_intrinsic__init();
 }
 
 
@@ -1607,12 +1649,18 @@ const ofc_sema_intrinsic_t* ofc_sema_intrinsic(
 	if (!ofc_sema_intrinsic__init())
 		return NULL;
 
+	/* Intrinsic names are interned, so a name that isn't can't match. */
+	ofc_symbol_t symbol = ofc_symbol_find(
+		ofc_sema_intrinsic__symbols, name, false);
+	if (symbol == OFC_SYMBOL_NONE)
+		return NULL;
+
 	const ofc_sema_intrinsic_t* func = ofc_hashmap_find(
-		ofc_sema_intrinsic__op_map, &name);
+		ofc_sema_intrinsic__op_map, &symbol);
 	if (!func)
 	{
 		func = ofc_hashmap_find(
-			ofc_sema_intrinsic__func_map, &name);
+			ofc_sema_intrinsic__func_map, &symbol);
 		if (!func) return NULL;
 	}
 
@@ -1654,19 +1702,21 @@ bool ofc_sema_stmt_intrinsic(
 	for (i = 0; i < stmt->decl_attr.count; i++)
 	{
 		ofc_sparse_ref_t decl_name = *stmt->decl_attr.name[i];
+		ofc_symbol_t symbol = ofc_symbol_find(
+			ofc_sema_intrinsic__symbols, decl_name.string, false);
 
 		const ofc_sema_intrinsic_t* func = ofc_hashmap_find(
-			ofc_sema_intrinsic__op_override_map, &decl_name.string);
+			ofc_sema_intrinsic__op_override_map, &symbol);
 		if (!func)
 		{
 			func = ofc_hashmap_find(
-				ofc_sema_intrinsic__op_map, &decl_name.string);
+				ofc_sema_intrinsic__op_map, &symbol);
 		}
 
 		if (!func)
 		{
 			func = ofc_hashmap_find(
-				ofc_sema_intrinsic__func_map, &decl_name.string);
+				ofc_sema_intrinsic__func_map, &symbol);
 		}
 
 		if (!func)
@@ -2123,6 +2173,15 @@ const ofc_sema_intrinsic_t* ofc_sema_intrinsic_cast_func(
 	return NULL;
 }
 
+ofc_str_ref_t ofc_sema_intrinsic_name(
+	const ofc_sema_intrinsic_t* intrinsic)
+{
+	if (!intrinsic)
+		return OFC_STR_REF_EMPTY;
+
+	return intrinsic->name;
+}
+
 bool ofc_sema_intrinsic_print(
 	ofc_colstr_t* cs,
 	const ofc_sema_intrinsic_t* intrinsic)
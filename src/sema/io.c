@@ -13,8 +13,106 @@
  * limitations under the License.
  */
 
+#include <strings.h>
+
 #include "ofc/sema.h"
 
+static int ofc_sema_io_spec__compare(
+	ofc_str_ref_t name, const char* spec)
+{
+	int diff = strncasecmp(name.base, spec, name.size);
+	if (diff != 0) return diff;
+	return (spec[name.size] == '\0' ? 0 : -1);
+}
+
+static int ofc_sema_io_spec__find(
+	ofc_str_ref_t name,
+	const char* const* spec, unsigned count)
+{
+	unsigned first = 0, last = count;
+	while (first < last)
+	{
+		unsigned mid = first + ((last - first) / 2);
+		int diff = ofc_sema_io_spec__compare(name, spec[mid]);
+		if (diff == 0)
+			return mid;
+
+		if (diff < 0)
+			last = mid;
+		else
+			first = mid + 1;
+	}
+
+	return -1;
+}
+
+bool ofc_sema_io_spec_resolve(
+	const ofc_parse_call_arg_list_t* params,
+	const char* stmt_name,
+	const char* const* spec, unsigned count,
+	const unsigned* positional, unsigned positional_count,
+	ofc_parse_call_arg_t** arg)
+{
+	if (!params || !stmt_name || !spec || !arg)
+		return false;
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+		arg[i] = NULL;
+
+	for (i = 0; i < params->count; i++)
+	{
+		ofc_parse_call_arg_t* param
+			= params->call_arg[i];
+		if (!param) continue;
+
+		if (ofc_sparse_ref_empty(param->name))
+		{
+			if (i >= positional_count)
+			{
+				ofc_sparse_ref_error(param->src,
+					"Un-named parameter %u has no meaning in %s.", i, stmt_name);
+				return false;
+			}
+
+			/* Only READ and WRITE take a second positional specifier,
+			   which is the format. */
+			if ((i > 0) && !arg[positional[0]])
+			{
+				ofc_sparse_ref_error(param->src,
+					"Un-named format parameter only valid after UNIT in %s.",
+					stmt_name);
+				return false;
+			}
+
+			arg[positional[i]] = param;
+			continue;
+		}
+
+		int s = ofc_sema_io_spec__find(
+			param->name.string, spec, count);
+		if (s < 0)
+		{
+			ofc_sparse_ref_error(param->src,
+				"Unrecognized paramater %u name '%.*s' in %s.",
+				i, param->name.string.size, param->name.string.base, stmt_name);
+			return false;
+		}
+
+		if (arg[s])
+		{
+			ofc_sparse_ref_error(param->src,
+				"Re-definition of %s in %s.", spec[s], stmt_name);
+			return false;
+		}
+
+		arg[s] = param;
+	}
+
+	return true;
+}
+
+
 /* Compare type to descriptor type at
  * offset position in format_list
  */
@@ -14,6 +14,10 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_label__vector, ofc_sema_label_t*)
 
 
 ofc_sparse_ref_t ofc_sema_label_src(
@@ -129,28 +133,12 @@ static bool ofc_sema_label__scope_ptr_compare(
 	return (a == b);
 }
 
-static uint8_t ofc_sema_label__hash(const unsigned* label)
+static uint32_t ofc_sema_label__hash(const unsigned* label)
 {
 	if (!label)
 		return 0;
 
-	unsigned h = *label;
-	h ^= (h >> (sizeof(h) * 4));
-	h ^= (h >> (sizeof(h) * 2));
-
-	return (h & 0xFF);
-}
-
-static uint8_t ofc_sema_label__ptr_hash(
-	const void* ptr)
-{
-	uintptr_t p = (uintptr_t)ptr;
-	uint8_t h = 0;
-
-	unsigned i;
-	for (i = 0; i < sizeof(p); i++)
-		h += ((p >> (i * 8)) & 0xFF);
-	return h;
+	return ofc_hashmap_hash_uint(*label);
 }
 
 ofc_sema_label_map_t* ofc_sema_label_map_create(void)
@@ -160,8 +148,9 @@ ofc_sema_label_map_t* ofc_sema_label_map_create(void)
 			sizeof(ofc_sema_label_map_t));
 	if (!map) return NULL;
 
-	map->count = 0;
-	map->size  = 0;
+	map->count      = 0;
+	map->size       = 0;
+	map->hole_count = 0;
 	map->label = NULL;
 
 	map->map = ofc_hashmap_create(
@@ -171,19 +160,19 @@ ofc_sema_label_map_t* ofc_sema_label_map_create(void)
 		NULL);
 
 	map->stmt = ofc_hashmap_create(
-		(void*)ofc_sema_label__ptr_hash,
+		(void*)ofc_hashmap_hash_ptr,
 		(void*)ofc_sema_label__stmt_ptr_compare,
 		(void*)ofc_sema_label__stmt_key,
 		(void*)ofc_sema_label__delete);
 
 	map->end_block = ofc_hashmap_create(
-		(void*)ofc_sema_label__ptr_hash,
+		(void*)ofc_hashmap_hash_ptr,
 		(void*)ofc_sema_label__stmt_ptr_compare,
 		(void*)ofc_sema_label__stmt_key,
 		(void*)ofc_sema_label__delete);
 
 	map->end_scope = ofc_hashmap_create(
-		(void*)ofc_sema_label__ptr_hash,
+		(void*)ofc_hashmap_hash_ptr,
 		(void*)ofc_sema_label__scope_ptr_compare,
 		(void*)ofc_sema_label__scope_key,
 		(void*)ofc_sema_label__delete);
@@ -234,43 +223,30 @@ static bool ofc_smea_label_map__add_stmt(
 			"Label zero isn't supported in standard Fortran");
 	}
 
-	unsigned slot;
-	if (map->count >= map->size)
+	/* Reuse the first emptied slot. */
+	unsigned slot = map->count;
+	if (map->hole_count > 0)
 	{
-		unsigned nsize = map->count + 1;
-		ofc_sema_label_t** nlabel
-			= (ofc_sema_label_t**)realloc(map->label,
-				(sizeof(ofc_sema_label_t*) * nsize));
-		if (!nlabel) return false;
-		map->label = nlabel;
-
-		unsigned i;
-		for (i = map->size; i < nsize; i++)
-			map->label[i] = NULL;
-
-		slot = map->size;
-		map->size = nsize;
-	}
-	else
-	{
-		unsigned i;
-		for (i = 0; i < map->size; i++)
+		for (slot = 0; slot < map->count; slot++)
 		{
-            if (map->label[i] == NULL)
-			{
-				slot = i;
+			if (!map->label[slot])
 				break;
-			}
 		}
-		if (i == map->size)
-			return false;
 	}
 
+	if ((slot >= map->count)
+		&& !ofc_sema_label__vector_reserve(
+			&map->label, map->count, &map->size, 1))
+		return false;
+
 	if (!ofc_hashmap_add(map->map, l))
 		return false;
 
 	map->label[slot] = l;
-	map->count++;
+	if (slot >= map->count)
+		map->count++;
+	else
+		map->hole_count--;
 	return true;
 }
 
@@ -420,13 +396,13 @@ void ofc_sema_label_map_remove(
 	ofc_hashmap_remove(map->map, label);
 
 	unsigned i;
-	for (i = 0; i < map->size; i++)
+	for (i = 0; i < map->count; i++)
 	{
 		if (map->label[i]
 			&& (map->label[i]->number == label->number))
 		{
 			map->label[i] = NULL;
-			map->count--;
+			map->hole_count++;
 			break;
 		}
 	}
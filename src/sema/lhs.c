@@ -14,9 +14,13 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
 #include <math.h>
 
 
+OFC_VECTOR_DEFINE(ofc_sema_lhs__vector, ofc_sema_lhs_t*)
+
+
 static ofc_sema_lhs_t* ofc_sema_lhs_index(
 	ofc_sema_lhs_t* lhs,
 	ofc_sema_array_index_t* index)
@@ -28,7 +32,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs_index(
 		return NULL;
 
 	ofc_sema_lhs_t* alhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_lhs_t));
 	if (!alhs)
 	{
@@ -68,7 +72,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs_slice(
 	}
 
 	ofc_sema_lhs_t* alhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_lhs_t));
 	if (!alhs)
 	{
@@ -214,7 +218,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs_substring(
 	}
 
 	ofc_sema_lhs_t* alhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_lhs_t));
 	if (!alhs)
 	{
@@ -257,7 +261,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs_member(
 	}
 
 	ofc_sema_lhs_t* alhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_lhs_t));
 	if (!alhs)
 	{
@@ -443,13 +447,13 @@ static ofc_sema_lhs_t* ofc_sema__lhs(
 	}
 
 	ofc_sema_lhs_t* slhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_lhs_t));
 	if (!slhs) return NULL;
 
 	if (!ofc_sema_decl_reference(decl))
 	{
-		free(slhs);
+		ofc_arena_node_free(slhs);
 		return NULL;
 	}
 
@@ -538,7 +542,7 @@ static ofc_sema_lhs_t* ofc_sema_lhs__implicit_do(
 		return NULL;
 
 	ofc_sema_lhs_t* lhs
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_lhs_t));
 	if (!lhs) return NULL;
 
@@ -770,6 +774,25 @@ static ofc_sema_lhs_t* ofc_sema_lhs__implicit_do(
 }
 
 
+/* The decl whose dimensions an array lhs takes, a member of an array
+   of structures has none of its own. */
+static const ofc_sema_decl_t* ofc_sema_lhs__array_decl(
+	const ofc_sema_lhs_t* lhs)
+{
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_DECL:
+			return lhs->decl;
+		case OFC_SEMA_LHS_STRUCTURE_MEMBER:
+			if (ofc_sema_lhs_is_array(lhs->parent))
+				return NULL;
+			return lhs->member;
+		default:
+			break;
+	}
+	return NULL;
+}
+
 ofc_sema_lhs_t* ofc_sema_lhs_elem_get(
 	ofc_sema_lhs_t* lhs, unsigned offset)
 {
@@ -811,7 +834,8 @@ ofc_sema_lhs_t* ofc_sema_lhs_elem_get(
 
 				ofc_sema_array_index_t* index
 					= ofc_sema_array_index_from_offset(
-						lhs->decl, (offset / base_count));
+						ofc_sema_lhs__array_decl(lhs),
+						(offset / base_count));
 				if (!index) return NULL;
 
 				ofc_sema_lhs_t* nlhs
@@ -830,21 +854,21 @@ ofc_sema_lhs_t* ofc_sema_lhs_elem_get(
 			}
 			else if (structure)
 			{
+				/* Offset is of an element of the structure, which
+				   may be within an array or structure member. */
+				unsigned moffset = offset;
 				ofc_sema_decl_t* member
-					= ofc_sema_structure_member_get_decl_offset(
-						structure, offset);
+					= ofc_sema_structure_elem_member(
+						structure, &moffset);
+				if (!member) return NULL;
 
 				ofc_sema_lhs_t* nlhs
 					= ofc_sema_lhs_member(lhs, member);
-				if (!nlhs)
-				{
-					ofc_sema_decl_delete(member);
-					return NULL;
-				}
+				if (!nlhs) return NULL;
 
 				ofc_sema_lhs_t* rlhs
 					= ofc_sema_lhs_elem_get(
-						nlhs, offset);
+						nlhs, moffset);
 				ofc_sema_lhs_delete(nlhs);
 				return rlhs;
 			}
@@ -928,40 +952,11 @@ ofc_sema_lhs_t* ofc_sema_lhs_elem_get(
 				= (offset % sub_elem_count);
 			offset /= sub_elem_count;
 
-			const ofc_sema_typeval_t* ctv[2];
-			ctv[0] = ofc_sema_expr_constant(
-					lhs->implicit_do.init);
-			ctv[1] = ofc_sema_expr_constant(
-					lhs->implicit_do.step);
-
-			long double first, step = 1.0;
-			if (!ofc_sema_typeval_get_real(ctv[0], &first))
-				return NULL;
-			if (ctv[1] && !ofc_sema_typeval_get_real(ctv[1], &step))
-				return NULL;
-
-			long double doffset
-				= first + ((long double)offset * step);
-
-			ofc_sema_typeval_t* dinit
-				= ofc_sema_typeval_create_real(
-					doffset, OFC_SEMA_KIND_NONE,
-					OFC_SPARSE_REF_EMPTY);
-			if (!dinit) return NULL;
-
-			ofc_sema_typeval_t* init
-				= ofc_sema_typeval_cast(
-					dinit, lhs->implicit_do.iter->type);
-			ofc_sema_typeval_delete(dinit);
-			if (!init) return NULL;
-
 			ofc_sema_expr_t* iter_expr
-				= ofc_sema_expr_typeval(init);
-			if (!iter_expr)
-			{
-				ofc_sema_typeval_delete(init);
-				return NULL;
-			}
+				= ofc_sema_expr_implicit_do_iter(
+					lhs->implicit_do.iter, lhs->implicit_do.init,
+					lhs->implicit_do.step, offset);
+			if (!iter_expr) return NULL;
 
 			ofc_sema_lhs_t* rval = NULL;
 			unsigned e = sub_offset;
@@ -1018,7 +1013,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 		return NULL;
 
 	ofc_sema_lhs_t* copy
-		= (ofc_sema_lhs_t*)malloc(
+		= (ofc_sema_lhs_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_lhs_t));
 	if (!copy) return NULL;
 
@@ -1028,7 +1023,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 	{
 		if (!ofc_sema_decl_reference(lhs->decl))
 		{
-			free(copy);
+			ofc_arena_node_free(copy);
 			return NULL;
 		}
 	}
@@ -1069,7 +1064,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 					lhs->index, replace, with);
 				if (!copy->index)
 				{
-					free(copy);
+					ofc_arena_node_free(copy);
 					return NULL;
 				}
 				break;
@@ -1087,7 +1082,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 				{
 					ofc_sema_array_slice_delete(copy->slice.slice);
 					ofc_sema_array_delete(copy->slice.dims);
-					free(copy);
+					ofc_arena_node_free(copy);
 					return NULL;
 				}
 				break;
@@ -1100,7 +1095,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 							lhs->substring.first, replace, with);
 					if (!copy->substring.first)
 					{
-						free(copy);
+						ofc_arena_node_free(copy);
 						return NULL;
 					}
 				}
@@ -1114,7 +1109,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 					{
 						ofc_sema_expr_delete(
 							copy->substring.first);
-						free(copy);
+						ofc_arena_node_free(copy);
 						return NULL;
 					}
 				}
@@ -1124,7 +1119,7 @@ ofc_sema_lhs_t* ofc_sema_lhs_copy_replace(
 				break;
 
 			default:
-				free(copy);
+				ofc_arena_node_free(copy);
 				return NULL;
 		}
 
@@ -1222,10 +1217,65 @@ void ofc_sema_lhs_delete(
 			break;
 	}
 
-	free(lhs);
+	ofc_arena_node_free(lhs);
 }
 
 
+/* Finds the element offset of lhs within the decl it's part of,
+   counting every element of array and structure members. */
+static bool ofc_sema_lhs__elem_offset(
+	const ofc_sema_lhs_t* lhs, unsigned* offset)
+{
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_DECL:
+			*offset = 0;
+			return true;
+
+		case OFC_SEMA_LHS_ARRAY_INDEX:
+		{
+			unsigned scount = 1;
+			ofc_sema_structure_t* structure
+				= ofc_sema_lhs_structure(lhs);
+			if (structure && !ofc_sema_structure_elem_count(
+				structure, &scount))
+				return false;
+
+			unsigned base, index;
+			if (!ofc_sema_lhs__elem_offset(lhs->parent, &base)
+				|| !ofc_sema_array_index_offset(lhs->src,
+					ofc_sema_lhs__array_decl(lhs->parent),
+					lhs->index, &index))
+				return false;
+
+			*offset = base + (index * scount);
+			return true;
+		}
+
+		case OFC_SEMA_LHS_STRUCTURE_MEMBER:
+		{
+			/* TODO - Initialize members of arrays of structures. */
+			if (ofc_sema_lhs_is_array(lhs->parent))
+				return false;
+
+			unsigned base, moffset;
+			if (!ofc_sema_lhs__elem_offset(lhs->parent, &base)
+				|| !ofc_sema_structure_member_elem_offset(
+					ofc_sema_lhs_structure(lhs->parent),
+					lhs->member, &moffset))
+				return false;
+
+			*offset = base + moffset;
+			return true;
+		}
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
 bool ofc_sema_lhs_init(
 	ofc_sema_lhs_t* lhs,
 	const ofc_sema_expr_t* init)
@@ -1252,25 +1302,11 @@ bool ofc_sema_lhs_init(
 				decl, init);
 
 		case OFC_SEMA_LHS_ARRAY_INDEX:
-		{
-			unsigned offset;
-			if (!ofc_sema_array_index_offset(
-				decl, lhs->index, &offset))
-				return false;
-
-			return ofc_sema_decl_init_offset(
-				decl, offset, init);
-		}
-
 		case OFC_SEMA_LHS_STRUCTURE_MEMBER:
 		{
-			ofc_sema_structure_t* structure
-				= ofc_sema_lhs_structure(lhs->parent);
-			if (!structure) return false;
-
 			unsigned offset;
-			if (!ofc_sema_structure_member_offset(
-				structure, lhs->member, &offset))
+			if (!ofc_sema_lhs__elem_offset(
+				lhs, &offset))
 				return false;
 
 			return ofc_sema_decl_init_offset(
@@ -1335,25 +1371,11 @@ bool ofc_sema_lhs_init_substring(
 				decl, init, first, last);
 
 		case OFC_SEMA_LHS_ARRAY_INDEX:
-		{
-			unsigned offset;
-			if (!ofc_sema_array_index_offset(
-				decl, lhs->index, &offset))
-				return false;
-
-			return ofc_sema_decl_init_substring_offset(
-				decl, offset, init, first, last);
-		}
-
 		case OFC_SEMA_LHS_STRUCTURE_MEMBER:
 		{
-			ofc_sema_structure_t* structure
-				= ofc_sema_lhs_structure(lhs->parent);
-			if (!structure) return false;
-
 			unsigned offset;
-			if (!ofc_sema_structure_member_offset(
-				structure, lhs->member, &offset))
+			if (!ofc_sema_lhs__elem_offset(
+				lhs, &offset))
 				return false;
 
 			return ofc_sema_decl_init_substring_offset(
@@ -1866,6 +1888,7 @@ static ofc_sema_lhs_list_t* ofc_sema_lhs__list(
 	if (!list) return NULL;
 
 	list->count = 0;
+	list->size  = plist->count;
 	list->lhs = (ofc_sema_lhs_t**)malloc(
 		plist->count * sizeof(ofc_sema_lhs_t*));
 	if (!list->lhs)
@@ -1932,6 +1955,7 @@ ofc_sema_lhs_list_t* ofc_sema_lhs_list_create(void)
 	if (!list) return NULL;
 
 	list->count = 0;
+	list->size  = 0;
 	list->lhs   = NULL;
 	return list;
 }
@@ -1970,6 +1994,7 @@ ofc_sema_lhs_list_t* ofc_sema_lhs_list_copy_replace(
 	}
 
 	copy->count = list->count;
+	copy->size  = list->count;
 
 	bool fail = false;
 	unsigned i;
@@ -1998,11 +2023,9 @@ bool ofc_sema_lhs_list_add(
 	if (!list || !lhs)
 		return false;
 
-	ofc_sema_lhs_t** nlhs
-		= (ofc_sema_lhs_t**)realloc(list->lhs,
-			((list->count + 1) * sizeof(ofc_sema_lhs_t*)));
-	if (!nlhs) return false;
-	list->lhs = nlhs;
+	if (!ofc_sema_lhs__vector_reserve(
+		&list->lhs, list->count, &list->size, 1))
+		return false;
 
 	list->lhs[list->count++] = lhs;
 	return true;
@@ -2053,6 +2076,312 @@ ofc_sema_lhs_t* ofc_sema_lhs_list_elem_get(
 }
 
 
+struct ofc_sema_lhs_cursor_s
+{
+	const ofc_sema_lhs_list_t* list;
+
+	unsigned index;
+	unsigned offset;
+	unsigned count;
+	bool     started;
+
+	unsigned               iter;
+	ofc_sema_lhs_list_t*   body;
+	ofc_sema_lhs_cursor_t* sub;
+
+	/* Arrays and slices are walked by advancing an index, the
+	   element it selects is kept while its members are returned. */
+	const ofc_sema_lhs_t* array;
+	unsigned              dimensions;
+	int*                  first;
+	int*                  extent;
+	int*                  idx;
+	unsigned              base_count;
+	unsigned              base_offset;
+	ofc_sema_lhs_t*       elem;
+
+	ofc_sema_lhs_t* current;
+	bool            error;
+};
+
+ofc_sema_lhs_cursor_t* ofc_sema_lhs_cursor_create(
+	const ofc_sema_lhs_list_t* list)
+{
+	if (!list)
+		return NULL;
+
+	ofc_sema_lhs_cursor_t* cursor
+		= (ofc_sema_lhs_cursor_t*)malloc(
+			sizeof(ofc_sema_lhs_cursor_t));
+	if (!cursor) return NULL;
+
+	cursor->list    = list;
+	cursor->index   = 0;
+	cursor->offset  = 0;
+	cursor->count   = 0;
+	cursor->started = false;
+	cursor->iter    = 0;
+	cursor->body    = NULL;
+	cursor->sub     = NULL;
+	cursor->array   = NULL;
+	cursor->first   = NULL;
+	cursor->elem    = NULL;
+	cursor->current = NULL;
+	cursor->error   = false;
+	return cursor;
+}
+
+static void ofc_sema_lhs_cursor__sub_end(
+	ofc_sema_lhs_cursor_t* cursor)
+{
+	ofc_sema_lhs_cursor_delete(cursor->sub);
+	cursor->sub = NULL;
+	ofc_sema_lhs_list_delete(cursor->body);
+	cursor->body = NULL;
+}
+
+static void ofc_sema_lhs_cursor__array_end(
+	ofc_sema_lhs_cursor_t* cursor)
+{
+	ofc_sema_lhs_delete(cursor->elem);
+	cursor->elem = NULL;
+	free(cursor->first);
+	cursor->first = NULL;
+	cursor->array = NULL;
+}
+
+/* Sets up the index state when lhs is an array or slice with constant
+   bounds, anything else is left to ofc_sema_lhs_elem_get. */
+static void ofc_sema_lhs_cursor__array_start(
+	ofc_sema_lhs_cursor_t* cursor,
+	const ofc_sema_lhs_t* lhs)
+{
+	const ofc_sema_array_t*       array = NULL;
+	const ofc_sema_array_slice_t* slice = NULL;
+	const ofc_sema_lhs_t*         base  = lhs;
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_DECL:
+		case OFC_SEMA_LHS_ARRAY_INDEX:
+		case OFC_SEMA_LHS_STRUCTURE_MEMBER:
+		{
+			if (!ofc_sema_lhs_is_array(lhs))
+				return;
+			const ofc_sema_decl_t* decl
+				= ofc_sema_lhs__array_decl(lhs);
+			if (!ofc_sema_decl_is_array(decl))
+				return;
+			array = decl->array;
+			if (!array) return;
+			break;
+		}
+		case OFC_SEMA_LHS_ARRAY_SLICE:
+			slice = lhs->slice.slice;
+			base  = lhs->parent;
+			if (!slice) return;
+			break;
+		default:
+			return;
+	}
+
+	const ofc_sema_type_t* data_type
+		= ofc_sema_lhs_type(lhs);
+	if (!data_type || ofc_sema_type_is_procedure(data_type))
+		return;
+
+	unsigned base_count = 1;
+	ofc_sema_structure_t* structure
+		= ofc_sema_lhs_structure(lhs);
+	if (structure)
+	{
+		if (!ofc_sema_structure_elem_count(
+			structure, &base_count)
+			|| (base_count == 0))
+			return;
+	}
+
+	unsigned dimensions = (array
+		? array->dimensions : slice->dimensions);
+	int* first = (int*)malloc(
+		sizeof(int) * dimensions * 3);
+	if (!first) return;
+
+	int*      extent = &first[dimensions];
+	unsigned  count[dimensions];
+	if (array ? !ofc_sema_array_bounds(array, first, count)
+		: !ofc_sema_array_slice_bounds(slice, first, count))
+	{
+		free(first);
+		return;
+	}
+
+	unsigned i;
+	for (i = 0; i < dimensions; i++)
+		extent[i] = count[i];
+
+	cursor->array       = base;
+	cursor->dimensions  = dimensions;
+	cursor->first       = first;
+	cursor->extent      = extent;
+	cursor->idx         = &first[dimensions * 2];
+	cursor->base_count  = base_count;
+	cursor->base_offset = 0;
+	cursor->elem        = NULL;
+
+	for (i = 0; i < dimensions; i++)
+		cursor->idx[i] = first[i];
+}
+
+static ofc_sema_lhs_t* ofc_sema_lhs_cursor__array_next(
+	ofc_sema_lhs_cursor_t* cursor)
+{
+	if (!cursor->elem)
+	{
+		ofc_sema_array_index_t* index
+			= ofc_sema_array_index_create(
+				cursor->dimensions, cursor->idx);
+		if (!index) return NULL;
+
+		cursor->elem = ofc_sema_lhs_index(
+			(ofc_sema_lhs_t*)cursor->array, index);
+		if (!cursor->elem)
+		{
+			ofc_sema_array_index_delete(index);
+			return NULL;
+		}
+	}
+
+	ofc_sema_lhs_t* elem = ofc_sema_lhs_elem_get(
+		cursor->elem, cursor->base_offset++);
+
+	if (cursor->base_offset >= cursor->base_count)
+	{
+		ofc_sema_lhs_delete(cursor->elem);
+		cursor->elem = NULL;
+		cursor->base_offset = 0;
+
+		/* Dimensions which a slice only indexes don't advance. */
+		unsigned i;
+		for (i = 0; i < cursor->dimensions; i++)
+		{
+			if (cursor->extent[i] == 0)
+				continue;
+
+			if (++cursor->idx[i] < (cursor->first[i] + cursor->extent[i]))
+				break;
+			cursor->idx[i] = cursor->first[i];
+		}
+	}
+
+	return elem;
+}
+
+void ofc_sema_lhs_cursor_delete(
+	ofc_sema_lhs_cursor_t* cursor)
+{
+	if (!cursor)
+		return;
+
+	ofc_sema_lhs_cursor__sub_end(cursor);
+	ofc_sema_lhs_cursor__array_end(cursor);
+	ofc_sema_lhs_delete(cursor->current);
+	free(cursor);
+}
+
+/* Elements returned are owned by the cursor and are only valid
+   until the next call to ofc_sema_lhs_cursor_next. */
+ofc_sema_lhs_t* ofc_sema_lhs_cursor_next(
+	ofc_sema_lhs_cursor_t* cursor)
+{
+	if (!cursor || cursor->error)
+		return NULL;
+
+	ofc_sema_lhs_delete(cursor->current);
+	cursor->current = NULL;
+
+	for (; cursor->index < cursor->list->count; cursor->index++)
+	{
+		ofc_sema_lhs_t* lhs
+			= cursor->list->lhs[cursor->index];
+
+		if (!cursor->started)
+		{
+			if (!ofc_sema_lhs_elem_count(
+				lhs, &cursor->count))
+				break;
+			cursor->offset  = 0;
+			cursor->iter    = 0;
+			cursor->started = true;
+
+			if (cursor->count > 0)
+				ofc_sema_lhs_cursor__array_start(cursor, lhs);
+		}
+
+		if (lhs->type == OFC_SEMA_LHS_IMPLICIT_DO)
+		{
+			/* Expand each iteration of the body once, rather than
+			   once per element. */
+			while (true)
+			{
+				if (cursor->sub)
+				{
+					ofc_sema_lhs_t* elem
+						= ofc_sema_lhs_cursor_next(cursor->sub);
+					if (elem) return elem;
+
+					if (cursor->sub->error)
+					{
+						cursor->error = true;
+						return NULL;
+					}
+
+					ofc_sema_lhs_cursor__sub_end(cursor);
+					cursor->iter++;
+				}
+
+				if ((cursor->count == 0)
+					|| (cursor->iter >= lhs->implicit_do.count))
+					break;
+
+				ofc_sema_expr_t* iter_expr
+					= ofc_sema_expr_implicit_do_iter(
+						lhs->implicit_do.iter, lhs->implicit_do.init,
+						lhs->implicit_do.step, cursor->iter);
+				if (!iter_expr) break;
+
+				cursor->body = ofc_sema_lhs_list_copy_replace(
+					lhs->implicit_do.lhs, lhs->implicit_do.iter, iter_expr);
+				ofc_sema_expr_delete(iter_expr);
+				if (!cursor->body) break;
+
+				cursor->sub = ofc_sema_lhs_cursor_create(cursor->body);
+				if (!cursor->sub) break;
+			}
+
+			if ((cursor->count != 0)
+				&& (cursor->iter < lhs->implicit_do.count))
+				break;
+		}
+		else if (cursor->offset < cursor->count)
+		{
+			cursor->current = (cursor->array
+				? ofc_sema_lhs_cursor__array_next(cursor)
+				: ofc_sema_lhs_elem_get(lhs, cursor->offset));
+			cursor->offset++;
+			if (!cursor->current) break;
+			return cursor->current;
+		}
+
+		ofc_sema_lhs_cursor__array_end(cursor);
+		cursor->started = false;
+	}
+
+	if (cursor->index < cursor->list->count)
+		cursor->error = true;
+	return NULL;
+}
+
+
 bool ofc_sema_lhs_list_init(
 	ofc_sema_lhs_list_t* lhs,
 	const ofc_sema_expr_list_t* init)
@@ -2065,38 +2394,39 @@ bool ofc_sema_lhs_list_init(
 
 	unsigned e = (lhs_count < init_count ? lhs_count : init_count);
 
+	ofc_sema_lhs_cursor_t* lhs_cursor
+		= ofc_sema_lhs_cursor_create(lhs);
+	ofc_sema_expr_cursor_t* init_cursor
+		= ofc_sema_expr_cursor_create(init);
+
+	bool success = (lhs_cursor && init_cursor);
+
 	unsigned i;
-	for (i = 0; i < e; i++)
+	for (i = 0; success && (i < e); i++)
 	{
 		ofc_sema_lhs_t* lhs_elem
-			= ofc_sema_lhs_list_elem_get(lhs, i);
-		if (!lhs_elem) return false;
-
-		ofc_sema_expr_t* init_elem
-			= ofc_sema_expr_list_elem_get(init, i);
-		if (!init_elem)
+			= ofc_sema_lhs_cursor_next(lhs_cursor);
+		const ofc_sema_expr_t* init_elem
+			= ofc_sema_expr_cursor_next(init_cursor);
+		if (!lhs_elem || !init_elem)
 		{
-			ofc_sema_lhs_delete(lhs_elem);
-			return false;
+			success = false;
+			break;
 		}
 
-		bool success = ofc_sema_lhs_init(
+		success = ofc_sema_lhs_init(
 			lhs_elem, init_elem);
-		ofc_sema_lhs_delete(lhs_elem);
-
 		if (!success)
 		{
 			/* TODO - Fail atomically? */
 			ofc_sparse_ref_error(init_elem->src,
 				"Invalid initializer");
-			ofc_sema_expr_delete(init_elem);
-			return false;
 		}
-
-		ofc_sema_expr_delete(init_elem);
 	}
 
-	return true;
+	ofc_sema_expr_cursor_delete(init_cursor);
+	ofc_sema_lhs_cursor_delete(lhs_cursor);
+	return success;
 }
 
 
@@ -14,6 +14,11 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_module__vector, ofc_sema_module_t*)
+
 
 ofc_sema_module_t* ofc_sema_module_create(
 	ofc_sema_scope_t* mscope,
@@ -130,6 +135,7 @@ ofc_sema_module_list_t* ofc_sema_module_list_create()
 	if (!list) return NULL;
 
 	list->count  = 0;
+	list->size   = 0;
 	list->module = NULL;
 
 	return list;
@@ -142,11 +148,9 @@ bool ofc_sema_module_list_add(
 	if (!list || !module)
 		return false;
 
-	ofc_sema_module_t** nmodule
-		= (ofc_sema_module_t**)realloc(list->module,
-			(sizeof(ofc_sema_module_t*) * (list->count + 1)));
-	if (!nmodule) return false;
-	list->module = nmodule;
+	if (!ofc_sema_module__vector_reserve(
+		&list->module, list->count, &list->size, 1))
+		return false;
 
     list->module[list->count++] = module;
 
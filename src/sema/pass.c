@@ -13,103 +13,502 @@
  * limitations under the License.
  */
 
-#include "ofc/sema.h"
+#include <stdlib.h>
+#include <time.h>
 
-typedef enum
-{
-	OFC_SEMA_PASS_STRUCT_TYPE = 0,
-	OFC_SEMA_PASS_CHAR_TRANSFER,
-	OFC_SEMA_PASS_UNREF_LABEL,
-	OFC_SEMA_PASS_UNLABELLED_FORMAT,
-	OFC_SEMA_PASS_UNLABELLED_CONTINUE,
-	OFC_SEMA_PASS_UNUSED_COMMON,
-	OFC_SEMA_PASS_UNUSED_DECL,
-	OFC_SEMA_PASS_INTEGER_LOGICAL,
+#include "ofc/sema.h"
+#include "ofc/global_opts.h"
+#include "ofc/thread_pool.h"
 
-	OFC_SEMA_PASS_COUNT
-} ofc_sema_pass_e;
+#define OFC_SEMA_PASS__BIT(x) (1U << OFC_SEMA_PASS_##x)
 
 typedef struct
 {
 	ofc_sema_pass_e type;
 	char*           desc;
 
-	bool (*pass_func)(ofc_sema_scope_t* scope);
+	/* Passes which must have visited a node before this one does,
+	   these are in earlier entries of the table. */
+	unsigned depend;
+
+	/* Only one of these is set. */
+	bool (*scope_func)(ofc_sema_scope_t* scope, void* param);
+	bool (*stmt_func)(ofc_sema_scope_t* scope, ofc_sema_stmt_t* stmt, void* param);
+	bool (*decl_func)(ofc_sema_scope_t* scope, ofc_sema_decl_t* decl, void* param);
+	bool (*expr_func)(ofc_sema_expr_t* expr, void* param);
 } ofc_sema_pass_t;
 
 static const ofc_sema_pass_t passes[] =
 {
-	{ OFC_SEMA_PASS_STRUCT_TYPE,         "STRUCTURE to TYPE",                     ofc_sema_pass_struct_type         },
-	{ OFC_SEMA_PASS_CHAR_TRANSFER,       "string cast TRANSFER",                  ofc_sema_pass_char_transfer       },
-	{ OFC_SEMA_PASS_UNREF_LABEL,         "remove unreferenced labels",            ofc_sema_pass_unref_label         },
-	{ OFC_SEMA_PASS_UNLABELLED_FORMAT,   "remove unlabelled format statements",   ofc_sema_pass_unlabelled_format   },
-	{ OFC_SEMA_PASS_UNLABELLED_CONTINUE, "remove unlabelled continue statements", ofc_sema_pass_unlabelled_continue },
-	{ OFC_SEMA_PASS_UNUSED_COMMON,       "warn about unused COMMON blocks",       ofc_sema_pass_unused_common       },
-	{ OFC_SEMA_PASS_UNUSED_DECL,         "remove unused declarations",            ofc_sema_pass_unused_decl         },
-	{ OFC_SEMA_PASS_INTEGER_LOGICAL,     "INTEGER to LOGICAL Expression",         ofc_sema_pass_integer_logical     },
+	{ OFC_SEMA_PASS_STRUCT_TYPE,         "STRUCTURE to TYPE",                     0,                                   ofc_sema_pass_struct_type_scope,   NULL,                                   NULL,                           NULL                               },
+	{ OFC_SEMA_PASS_CHAR_TRANSFER,       "string cast TRANSFER",                  0,                                   NULL,                              NULL,                                   NULL,                           ofc_sema_pass_char_transfer_expr   },
+	{ OFC_SEMA_PASS_UNREF_LABEL,         "remove unreferenced labels",            0,                                   ofc_sema_pass_unref_label_scope,   NULL,                                   NULL,                           NULL                               },
+	{ OFC_SEMA_PASS_UNLABELLED_FORMAT,   "remove unlabelled format statements",   OFC_SEMA_PASS__BIT(UNREF_LABEL),     NULL,                              ofc_sema_pass_unlabelled_format_stmt,   NULL,                           NULL                               },
+	{ OFC_SEMA_PASS_UNLABELLED_CONTINUE, "remove unlabelled continue statements", OFC_SEMA_PASS__BIT(UNREF_LABEL),     NULL,                              ofc_sema_pass_unlabelled_continue_stmt, NULL,                           NULL                               },
+	{ OFC_SEMA_PASS_UNUSED_COMMON,       "warn about unused COMMON blocks",       0,                                   ofc_sema_pass_unused_common_scope, NULL,                                   NULL,                           NULL                               },
+	{ OFC_SEMA_PASS_UNUSED_DECL,         "remove unused declarations",            0,                                   NULL,                              NULL,                                   ofc_sema_pass_unused_decl_decl, NULL                               },
+	{ OFC_SEMA_PASS_INTEGER_LOGICAL,     "INTEGER to LOGICAL Expression",         OFC_SEMA_PASS__BIT(CHAR_TRANSFER),   NULL,                              NULL,                                   NULL,                           ofc_sema_pass_integer_logical_expr },
 };
 
-bool ofc_sema_run_passes(
-	ofc_file_t* file,
-	ofc_sema_pass_opts_t* sema_pass_opts,
-	ofc_sema_scope_t* scope)
+
+typedef enum
 {
+	OFC_SEMA_PASS__SCOPE = 0,
+	OFC_SEMA_PASS__STMT,
+	OFC_SEMA_PASS__DECL,
+	OFC_SEMA_PASS__EXPR,
+
+	OFC_SEMA_PASS__KIND_COUNT
+} ofc_sema_pass__kind_e;
+
+/* A stage is a single scope pass, or statement, declaration or
+   expression passes which share one walk over those of a scope. */
+typedef struct
+{
+	unsigned              mask;
+	ofc_sema_pass__kind_e kind;
+} ofc_sema_pass__stage_t;
+
+typedef struct
+{
+	ofc_sema_pass__stage_t stage[OFC_SEMA_PASS_COUNT];
+	unsigned               stage_count;
+
+	/* The global scope being walked, if any. */
+	const ofc_sema_scope_t* global;
+
+	/* The expression passes of the stage being walked. */
+	unsigned expr_mask;
+
+	ofc_sema_pass_stats_t* stats;
+	ofc_sema_pass_e        failed;
+} ofc_sema_pass__walk_t;
+
+
+static double ofc_sema_pass__time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+static bool ofc_sema_pass__enabled(
+	const ofc_sema_pass_opts_t* opts, ofc_sema_pass_e type)
+{
+	switch (type)
+	{
+		case OFC_SEMA_PASS_STRUCT_TYPE:
+			return opts->struct_type;
+		case OFC_SEMA_PASS_CHAR_TRANSFER:
+			return opts->char_transfer;
+		case OFC_SEMA_PASS_UNREF_LABEL:
+			return opts->unref_label;
+		case OFC_SEMA_PASS_UNLABELLED_FORMAT:
+			return opts->unlabelled_format;
+		case OFC_SEMA_PASS_UNLABELLED_CONTINUE:
+			return opts->unlabelled_continue;
+		case OFC_SEMA_PASS_UNUSED_COMMON:
+			return opts->unused_common;
+		case OFC_SEMA_PASS_UNUSED_DECL:
+			return opts->unused_decl;
+		case OFC_SEMA_PASS_INTEGER_LOGICAL:
+			return opts->integer_logical;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+static ofc_sema_pass__kind_e ofc_sema_pass__kind(
+	const ofc_sema_pass_t* pass)
+{
+	if (pass->stmt_func)
+		return OFC_SEMA_PASS__STMT;
+	if (pass->decl_func)
+		return OFC_SEMA_PASS__DECL;
+	if (pass->expr_func)
+		return OFC_SEMA_PASS__EXPR;
+	return OFC_SEMA_PASS__SCOPE;
+}
+
+/* Statement, declaration and expression passes join the last stage
+   of their kind, unless a pass they depend on is in a later stage. */
+static void ofc_sema_pass__schedule(
+	ofc_sema_pass__walk_t* walk,
+	const ofc_sema_pass_opts_t* opts)
+{
+	walk->stage_count = 0;
+
+	unsigned last[OFC_SEMA_PASS__KIND_COUNT];
+	unsigned k;
+	for (k = 0; k < OFC_SEMA_PASS__KIND_COUNT; k++)
+		last[k] = OFC_SEMA_PASS_COUNT;
+
 	unsigned i;
-	for(i = 0; i < OFC_SEMA_PASS_COUNT; i++)
+	for (i = 0; i < OFC_SEMA_PASS_COUNT; i++)
 	{
-		switch (i)
+		if (!ofc_sema_pass__enabled(opts, passes[i].type))
+			continue;
+
+		ofc_sema_pass__kind_e kind
+			= ofc_sema_pass__kind(&passes[i]);
+		if ((kind != OFC_SEMA_PASS__SCOPE)
+			&& (last[kind] < walk->stage_count))
 		{
-			case OFC_SEMA_PASS_STRUCT_TYPE:
-				if(!sema_pass_opts->struct_type)
-					continue;
-				break;
+			unsigned later = 0;
+			unsigned s;
+			for (s = (last[kind] + 1); s < walk->stage_count; s++)
+				later |= walk->stage[s].mask;
 
-			case OFC_SEMA_PASS_UNREF_LABEL:
-				if(!sema_pass_opts->unref_label)
-					continue;
-				break;
+			if ((passes[i].depend & later) == 0)
+			{
+				walk->stage[last[kind]].mask |= (1U << i);
+				continue;
+			}
+		}
 
-			case OFC_SEMA_PASS_UNLABELLED_FORMAT:
-				if(!sema_pass_opts->unlabelled_format)
-					continue;
-				break;
+		last[kind] = walk->stage_count;
 
-			case OFC_SEMA_PASS_UNLABELLED_CONTINUE:
-				if(!sema_pass_opts->unlabelled_continue)
-					continue;
-				break;
+		walk->stage[walk->stage_count].mask = (1U << i);
+		walk->stage[walk->stage_count].kind = kind;
+		walk->stage_count++;
+	}
+}
 
-			case OFC_SEMA_PASS_CHAR_TRANSFER:
-				if(!sema_pass_opts->char_transfer)
-					continue;
-				break;
+static bool ofc_sema_pass__expr(
+	ofc_sema_expr_t* expr, void* param)
+{
+	ofc_sema_pass__walk_t* walk
+		= (ofc_sema_pass__walk_t*)param;
 
-			case OFC_SEMA_PASS_UNUSED_COMMON:
-				if(!sema_pass_opts->unused_common)
-					continue;
-				break;
+	unsigned i;
+	for (i = 0; i < OFC_SEMA_PASS_COUNT; i++)
+	{
+		if ((walk->expr_mask & (1U << i)) == 0)
+			continue;
+
+		double start = (walk->stats ? ofc_sema_pass__time() : 0.0);
+		bool success = passes[i].expr_func(expr, NULL);
+		if (walk->stats)
+		{
+			walk->stats->pass[i].time += (ofc_sema_pass__time() - start);
+			walk->stats->pass[i].nodes++;
+		}
+
+		if (!success)
+		{
+			walk->failed = passes[i].type;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Visitors may remove the statement or declaration from its list,
+   so later passes of the stage only visit it while it's still there. */
+static bool ofc_sema_pass__stmt(
+	ofc_sema_pass__walk_t* walk, unsigned mask,
+	ofc_sema_scope_t* scope)
+{
+	if (!scope->stmt
+		|| (scope->type == OFC_SEMA_SCOPE_STMT_FUNC))
+		return true;
+
+	ofc_sema_stmt_list_t* list = scope->stmt;
+
+	unsigned j;
+	for (j = 0; j < list->count; j++)
+	{
+		ofc_sema_stmt_t* stmt = list->stmt[j];
+
+		unsigned i;
+		for (i = 0; stmt && (i < OFC_SEMA_PASS_COUNT); i++)
+		{
+			if ((mask & (1U << i)) == 0)
+				continue;
+
+			double start = (walk->stats ? ofc_sema_pass__time() : 0.0);
+			bool success = passes[i].stmt_func(scope, stmt, NULL);
+			if (walk->stats)
+			{
+				walk->stats->pass[i].time += (ofc_sema_pass__time() - start);
+				walk->stats->pass[i].nodes++;
+			}
 
-			case OFC_SEMA_PASS_UNUSED_DECL:
-				if(!sema_pass_opts->unused_decl)
-					continue;
+			if (!success)
+			{
+				walk->failed = passes[i].type;
+				return false;
+			}
+
+			if (list->stmt[j] != stmt)
 				break;
+		}
+	}
+
+	return true;
+}
+
+static bool ofc_sema_pass__decl(
+	ofc_sema_pass__walk_t* walk, unsigned mask,
+	ofc_sema_scope_t* scope)
+{
+	if (!scope->decl)
+		return true;
 
-			case OFC_SEMA_PASS_INTEGER_LOGICAL:
-				if(!sema_pass_opts->integer_logical)
-					continue;
+	ofc_sema_decl_list_t* list = scope->decl;
+
+	unsigned j;
+	for (j = 0; j < list->count; j++)
+	{
+		ofc_sema_decl_t* decl = list->decl[j];
+
+		unsigned i;
+		for (i = 0; decl && (i < OFC_SEMA_PASS_COUNT); i++)
+		{
+			if ((mask & (1U << i)) == 0)
+				continue;
+
+			double start = (walk->stats ? ofc_sema_pass__time() : 0.0);
+			bool success = passes[i].decl_func(scope, decl, NULL);
+			if (walk->stats)
+			{
+				walk->stats->pass[i].time += (ofc_sema_pass__time() - start);
+				walk->stats->pass[i].nodes++;
+			}
+
+			if (!success)
+			{
+				walk->failed = passes[i].type;
+				return false;
+			}
+
+			if (list->decl[j] != decl)
 				break;
+		}
+	}
+
+	return true;
+}
+
+static bool ofc_sema_pass__scope(
+	ofc_sema_scope_t* scope, void* param)
+{
+	ofc_sema_pass__walk_t* walk
+		= (ofc_sema_pass__walk_t*)param;
+
+	/* Units --watch shares with the last analysis of the file
+	   were visited then, their parent is still that analysis. */
+	const ofc_sema_scope_t* global = scope;
+	while (global && (global->type != OFC_SEMA_SCOPE_GLOBAL))
+		global = global->parent;
+	if (walk->global && global && (global != walk->global))
+		return true;
+
+	unsigned s;
+	for (s = 0; s < walk->stage_count; s++)
+	{
+		const ofc_sema_pass__stage_t* stage = &walk->stage[s];
+
+		switch (stage->kind)
+		{
+			case OFC_SEMA_PASS__STMT:
+				if (!ofc_sema_pass__stmt(walk, stage->mask, scope))
+					return false;
+				continue;
+
+			case OFC_SEMA_PASS__DECL:
+				if (!ofc_sema_pass__decl(walk, stage->mask, scope))
+					return false;
+				continue;
+
+			case OFC_SEMA_PASS__EXPR:
+				walk->expr_mask = stage->mask;
+				if (!ofc_sema_scope_foreach_expr(
+					scope, walk, ofc_sema_pass__expr))
+					return false;
+				continue;
 
 			default:
-				return false;
+				break;
+		}
+
+		unsigned i;
+		for (i = 0; (stage->mask & (1U << i)) == 0; i++);
+
+		double start = (walk->stats ? ofc_sema_pass__time() : 0.0);
+		bool success = passes[i].scope_func(scope, NULL);
+		if (walk->stats)
+		{
+			walk->stats->pass[i].time += (ofc_sema_pass__time() - start);
+			walk->stats->pass[i].nodes++;
 		}
 
-        if (!passes[i].pass_func(scope))
+		if (!success)
 		{
-			ofc_file_error(file, NULL,
-				"Failed %s semantic pass",
-					passes[i].desc);
+			walk->failed = passes[i].type;
 			return false;
 		}
 	}
+
+	return true;
+}
+
+/* Program units analysed with --unit-jobs are walked on a pool of
+   threads, passes don't look outside of the scope they're visiting.
+   Diagnostics are replayed in the order of a serial walk, and the
+   walk stops at the same unit a serial walk would. */
+typedef struct
+{
+	ofc_sema_scope_t*      scope;
+	ofc_sema_pass__walk_t  walk;
+	ofc_sema_pass_stats_t  stats;
+	ofc_file_diag_t        diag;
+	bool                   failed;
+} ofc_sema_pass__unit_t;
+
+static void ofc_sema_pass__unit_run(
+	ofc_sema_pass__unit_t* unit)
+{
+	ofc_arena_t* prev = ofc_arena_current_set(
+		unit->scope->arena);
+
+	ofc_file_diag_hold(&unit->diag);
+	unit->failed = !ofc_sema_scope_foreach_scope(
+		unit->scope, &unit->walk, ofc_sema_pass__scope);
+	ofc_file_diag_release(&unit->diag);
+
+	ofc_arena_current_set(prev);
+}
+
+static bool ofc_sema_pass__units(
+	ofc_sema_pass__walk_t* walk,
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope_t** unit, unsigned count)
+{
+	ofc_sema_pass__unit_t* u
+		= (ofc_sema_pass__unit_t*)calloc(
+			count, sizeof(ofc_sema_pass__unit_t));
+	if (!u) return ofc_sema_scope_foreach_scope(
+		scope, walk, ofc_sema_pass__scope);
+
+	unsigned threads = global_opts.unit_jobs;
+	if (threads > count)
+		threads = count;
+
+	ofc_thread_pool_t* pool
+		= ofc_thread_pool_create(threads);
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		u[i].scope = unit[i];
+		u[i].walk  = *walk;
+		if (walk->stats)
+			u[i].walk.stats = &u[i].stats;
+
+		if (!pool || !ofc_thread_pool_add(pool,
+			(ofc_thread_pool_job_f)ofc_sema_pass__unit_run, &u[i]))
+			ofc_sema_pass__unit_run(&u[i]);
+	}
+
+	ofc_thread_pool_delete(pool);
+
+	bool success = true;
+	for (i = 0; i < count; i++)
+	{
+		if (success)
+		{
+			ofc_file_diag_replay(&u[i].diag);
+
+			if (walk->stats)
+			{
+				unsigned p;
+				for (p = 0; p < OFC_SEMA_PASS_COUNT; p++)
+				{
+					walk->stats->pass[p].nodes += u[i].stats.pass[p].nodes;
+					walk->stats->pass[p].time  += u[i].stats.pass[p].time;
+				}
+			}
+
+			if (u[i].failed)
+			{
+				walk->failed = u[i].walk.failed;
+				success = false;
+			}
+		}
+
+		ofc_file_diag_discard(&u[i].diag);
+	}
+	free(u);
+
+	/* Then the global scope itself, as a serial walk visits it last. */
+	return (success && ofc_sema_pass__scope(scope, walk));
+}
+
+bool ofc_sema_run_passes(
+	ofc_file_t* file,
+	ofc_sema_pass_opts_t* sema_pass_opts,
+	ofc_sema_scope_t* scope,
+	ofc_sema_pass_stats_t* stats)
+{
+	ofc_sema_pass__walk_t walk;
+	ofc_sema_pass__schedule(&walk, sema_pass_opts);
+	walk.global    = ((scope && (scope->type == OFC_SEMA_SCOPE_GLOBAL))
+		? scope : NULL);
+	walk.expr_mask = 0;
+	walk.stats     = stats;
+	walk.failed    = OFC_SEMA_PASS_COUNT;
+
+	if (stats)
+	{
+		unsigned i;
+		for (i = 0; i < OFC_SEMA_PASS_COUNT; i++)
+		{
+			stats->pass[i].desc  = passes[i].desc;
+			stats->pass[i].run   = false;
+			stats->pass[i].nodes = 0;
+			stats->pass[i].time  = 0.0;
+		}
+
+		unsigned s;
+		for (s = 0; s < walk.stage_count; s++)
+		{
+			for (i = 0; i < OFC_SEMA_PASS_COUNT; i++)
+			{
+				if (walk.stage[s].mask & (1U << i))
+					stats->pass[i].run = true;
+			}
+		}
+	}
+
+	if (walk.stage_count == 0)
+		return true;
+
+	/* Without a scope the first pass is what fails. */
+	unsigned first;
+	for (first = 0; (walk.stage[0].mask & (1U << first)) == 0; first++);
+	walk.failed = passes[first].type;
+
+	unsigned unit_count;
+	ofc_sema_scope_t** unit
+		= ofc_sema_scope_units(scope, &unit_count);
+
+	bool success = (unit
+		? ofc_sema_pass__units(&walk, scope, unit, unit_count)
+		: ofc_sema_scope_foreach_scope(
+			scope, &walk, ofc_sema_pass__scope));
+	free(unit);
+
+	if (!success)
+	{
+		ofc_file_error(file, NULL,
+			"Failed %s semantic pass",
+				passes[walk.failed].desc);
+		return false;
+	}
+
 	return true;
 }
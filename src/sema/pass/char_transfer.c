@@ -16,7 +16,7 @@
 #include "ofc/sema.h"
 
 
-static bool ofc_sema_pass_char_transfer__expr(
+bool ofc_sema_pass_char_transfer_expr(
 	ofc_sema_expr_t* expr, void* param)
 {
 	(void)param;
@@ -211,25 +211,3 @@ static bool ofc_sema_pass_char_transfer__expr(
 
 	return true;
 }
-
-static bool ofc_sema_pass_char_transfer__scope(
-	ofc_sema_scope_t* scope, void* param)
-{
-	(void)param;
-
-	if (!scope)
-		return false;
-
-	return ofc_sema_scope_foreach_expr(
-		scope, NULL, ofc_sema_pass_char_transfer__expr);
-}
-
-bool ofc_sema_pass_char_transfer(
-	ofc_sema_scope_t* scope)
-{
-	if (!scope)
-		return false;
-
-	return ofc_sema_scope_foreach_scope(
-		scope, NULL, ofc_sema_pass_char_transfer__scope);
-}
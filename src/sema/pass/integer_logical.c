@@ -39,7 +39,7 @@ static bool ofc_sema_pass_integer_logical__expand(
 	return true;
 }
 
-static bool ofc_sema_pass_integer_logical__expr(
+bool ofc_sema_pass_integer_logical_expr(
 	ofc_sema_expr_t* expr, void* param)
 {
 	(void)param;
@@ -70,23 +70,3 @@ static bool ofc_sema_pass_integer_logical__expr(
 
 	return true;
 }
-
-static bool ofc_sema_pass_integer_logical__scope(
-	ofc_sema_scope_t* scope, void* param)
-{
-	(void)param;
-
-	if (!scope) return false;
-
-	return ofc_sema_scope_foreach_expr(
-		scope, NULL, ofc_sema_pass_integer_logical__expr);
-}
-
-bool ofc_sema_pass_integer_logical(
-	ofc_sema_scope_t* scope)
-{
-	if (!scope) return false;
-
-	return ofc_sema_scope_foreach_scope(
-		scope, NULL, ofc_sema_pass_integer_logical__scope);
-}
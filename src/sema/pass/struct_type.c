@@ -45,7 +45,7 @@ static bool ofc_sema_pass_struct_type__struct(
 	return true;
 }
 
-static bool ofc_sema_pass_struct_type__scope(
+bool ofc_sema_pass_struct_type_scope(
 	ofc_sema_scope_t* scope, void* param)
 {
 	(void)param;
@@ -60,13 +60,3 @@ static bool ofc_sema_pass_struct_type__scope(
 		scope->structure, (void*)scope,
 		(void*)ofc_sema_pass_struct_type__struct);
 }
-
-bool ofc_sema_pass_struct_type(
-	ofc_sema_scope_t* scope)
-{
-	if (!scope)
-		return false;
-
-	return ofc_sema_scope_foreach_scope(
-		scope, NULL, ofc_sema_pass_struct_type__scope);
-}
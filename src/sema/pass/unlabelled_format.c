@@ -15,46 +15,22 @@
 
 #include "ofc/sema.h"
 
-static bool ofc_sema_pass_unlabelled_format__scope(
-	ofc_sema_scope_t* scope, void* param)
+bool ofc_sema_pass_unlabelled_format_stmt(
+	ofc_sema_scope_t* scope, ofc_sema_stmt_t* stmt, void* param)
 {
 	(void)param;
 
-	if (!scope)
+	if (!scope || !stmt)
 		return false;
 
-	if ((scope->type != OFC_SEMA_SCOPE_STMT_FUNC) && scope->stmt)
+	if ((stmt->type == OFC_SEMA_STMT_IO_FORMAT)
+		&& !ofc_sema_label_map_find_stmt(scope->label, stmt))
 	{
-		ofc_sema_stmt_list_t* list = scope->stmt;
+		if (!ofc_sema_stmt_list_remove(scope->stmt, stmt))
+			return false;
 
-		unsigned i;
-		for (i = 0; i < scope->stmt->count; i++)
-		{
-			if (list->stmt[i])
-			{
-				ofc_sema_stmt_t* stmt = list->stmt[i];
-
-				if ((stmt->type == OFC_SEMA_STMT_IO_FORMAT)
-					&& !ofc_sema_label_map_find_stmt(scope->label, stmt))
-				{
-					if (!ofc_sema_stmt_list_remove(scope->stmt, stmt))
-						return false;
-
-					ofc_sema_stmt_delete(stmt);
-				}
-			}
-		}
+		ofc_sema_stmt_delete(stmt);
 	}
 
 	return true;
 }
-
-bool ofc_sema_pass_unlabelled_format(
-	ofc_sema_scope_t* scope)
-{
-	if (!scope)
-		return false;
-
-	return ofc_sema_scope_foreach_scope(
-		scope, NULL, ofc_sema_pass_unlabelled_format__scope);
-}
@@ -15,7 +15,7 @@
 
 #include "ofc/sema.h"
 
-static bool ofc_sema_pass_unref_label__scope(
+bool ofc_sema_pass_unref_label_scope(
 	ofc_sema_scope_t* scope, void* param)
 {
 	(void)param;
@@ -26,7 +26,7 @@ static bool ofc_sema_pass_unref_label__scope(
 	if (scope->label)
 	{
 		unsigned i;
-		for (i = 0; i < scope->label->size; i++)
+		for (i = 0; i < scope->label->count; i++)
 		{
 			ofc_sema_label_t* label = scope->label->label[i];
 
@@ -36,13 +36,3 @@ static bool ofc_sema_pass_unref_label__scope(
 	}
 	return true;
 }
-
-bool ofc_sema_pass_unref_label(
-	ofc_sema_scope_t* scope)
-{
-	if (!scope)
-		return false;
-
-	return ofc_sema_scope_foreach_scope(
-		scope, NULL, ofc_sema_pass_unref_label__scope);
-}
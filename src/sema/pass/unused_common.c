@@ -16,7 +16,7 @@
 #include "ofc/sema.h"
 
 
-static bool ofc_sema_pass_unused_common__scope(
+bool ofc_sema_pass_unused_common_scope(
 	ofc_sema_scope_t* scope, void* param)
 {
 	(void)param;
@@ -58,13 +58,3 @@ static bool ofc_sema_pass_unused_common__scope(
 
 	return true;
 }
-
-bool ofc_sema_pass_unused_common(
-	ofc_sema_scope_t* scope)
-{
-	if (!scope)
-		return false;
-
-	return ofc_sema_scope_foreach_scope(
-		scope, NULL, ofc_sema_pass_unused_common__scope);
-}
@@ -16,45 +16,28 @@
 #include "ofc/sema.h"
 
 
-static bool ofc_sema_pass_unused_decl__scope(
-	ofc_sema_scope_t* scope, void* param)
+bool ofc_sema_pass_unused_decl_decl(
+	ofc_sema_scope_t* scope, ofc_sema_decl_t* decl, void* param)
 {
 	(void)param;
 
-	if (!scope)
+	if (!scope || !decl)
 		return false;
 
-	/* Skip module scopes and scopes without a decl list. */
-	if (!scope->decl || (scope->type == OFC_SEMA_SCOPE_MODULE))
+	/* Module declarations may be used elsewhere. */
+	if (scope->type == OFC_SEMA_SCOPE_MODULE)
 		return true;
 
-	unsigned i;
-	for (i = 0; i < scope->decl->size; i++)
+	if ((decl->type->type != OFC_SEMA_TYPE_FUNCTION)
+		&& (decl->type->type != OFC_SEMA_TYPE_SUBROUTINE)
+		&& !decl->is_stmt_func_arg
+		&& !decl->is_argument
+		&& !decl->was_written
+		&& !decl->was_read
+		&& !decl->common)
 	{
-		ofc_sema_decl_t* decl = scope->decl->decl[i];
-
-		if (decl
-			&& (decl->type->type != OFC_SEMA_TYPE_FUNCTION)
-			&& (decl->type->type != OFC_SEMA_TYPE_SUBROUTINE)
-			&& !decl->is_stmt_func_arg
-			&& !decl->is_argument
-			&& !decl->was_written
-			&& !decl->was_read
-			&& !decl->common)
-		{
-			ofc_sema_decl_list_remove(scope->decl, decl);
-		}
+		ofc_sema_decl_list_remove(scope->decl, decl);
 	}
 
 	return true;
 }
-
-bool ofc_sema_pass_unused_decl(
-	ofc_sema_scope_t* scope)
-{
-	if (!scope)
-		return false;
-
-	return ofc_sema_scope_foreach_scope(
-		scope, NULL, ofc_sema_pass_unused_decl__scope);
-}
@@ -14,6 +14,11 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_range__vector, ofc_sema_range_t*)
+
 
 void ofc_sema_range_delete(
 	ofc_sema_range_t* range)
@@ -91,6 +96,7 @@ ofc_sema_range_list_t* ofc_sema_range_list(
 			sizeof(ofc_sema_range_list_t));
 
 	list->count = 0;
+	list->size  = 0;
 	list->range = NULL;
 	list->src   = index->src;
 
@@ -117,12 +123,10 @@ bool ofc_sema_range_list_add(
 	if (!list || !range)
 		return false;
 
-	ofc_sema_range_t** nrange
-		= (ofc_sema_range_t**)realloc(list->range,
-			(sizeof(ofc_sema_range_t*) * (list->count + 1)));
-	if (!nrange) return NULL;
+	if (!ofc_sema_range__vector_reserve(
+		&list->range, list->count, &list->size, 1))
+		return false;
 
-	list->range = nrange;
 	list->range[list->count++] = range;
 	return true;
 }
@@ -136,6 +140,41 @@ bool ofc_sema_range_is_constant(
 		&& ofc_sema_expr_is_constant(range->last));
 }
 
+static bool ofc_sema_range__interval_bound(
+	const ofc_sema_expr_t* expr, int64_t* value)
+{
+	if (!ofc_sema_type_is_integer(
+		ofc_sema_expr_type(expr)))
+		return false;
+
+	return ofc_sema_typeval_get_integer(
+		ofc_sema_expr_constant(expr), value);
+}
+
+bool ofc_sema_range_interval(
+	const ofc_sema_range_t* range,
+	int64_t* first, int64_t* last)
+{
+	if (!range || (!range->first && !range->last))
+		return false;
+
+	int64_t f = INT64_MIN;
+	if (range->first && !ofc_sema_range__interval_bound(
+		range->first, &f))
+		return false;
+
+	int64_t l = INT64_MAX;
+	if (!range->is_range)
+		l = f;
+	else if (range->last && !ofc_sema_range__interval_bound(
+		range->last, &l))
+		return false;
+
+	if (first) *first = f;
+	if (last ) *last  = l;
+	return true;
+}
+
 bool ofc_sema_range_intersects(
 	ofc_sema_range_t* a,
 	ofc_sema_range_t* b)
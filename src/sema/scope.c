@@ -15,15 +15,56 @@
 
 #include "ofc/sema.h"
 #include "ofc/global_opts.h"
+#include "ofc/thread_pool.h"
+#include "ofc/vector.h"
 
 extern ofc_global_opts_t global_opts;
 
+
+OFC_VECTOR_DEFINE(ofc_sema_scope__vector, ofc_sema_scope_t*)
+OFC_VECTOR_DEFINE(ofc_sema_scope__stmt_vector, ofc_sema_stmt_t*)
+
+
+/* A global scope only owns the program units whose parent it is,
+   --watch may share others with an earlier analysis of the file. */
+static void ofc_sema_scope__units_disown(
+	ofc_sema_scope_t* scope)
+{
+	unsigned i;
+	if (scope->child)
+	{
+		unsigned j = 0;
+		for (i = 0; i < scope->child->count; i++)
+		{
+			ofc_sema_scope_t* child
+				= scope->child->scope[i];
+			if (child->parent == scope)
+				scope->child->scope[j++] = child;
+		}
+		scope->child->count = j;
+	}
+
+	if (scope->decl)
+	{
+		for (i = 0; i < scope->decl->count; i++)
+		{
+			ofc_sema_decl_t* decl = scope->decl->decl[i];
+			if (decl && decl->func
+				&& (decl->func->parent != scope))
+				decl->func = NULL;
+		}
+	}
+}
+
 void ofc_sema_scope_delete(
 	ofc_sema_scope_t* scope)
 {
 	if (!scope)
 		return;
 
+	if (scope->type == OFC_SEMA_SCOPE_GLOBAL)
+		ofc_sema_scope__units_disown(scope);
+
 	ofc_sema_scope_list_delete(
 		scope->child);
 
@@ -49,6 +90,12 @@ void ofc_sema_scope_delete(
 
 	ofc_parse_file_delete(scope->file);
 
+	if (scope->type == OFC_SEMA_SCOPE_GLOBAL)
+		ofc_symbol_table_delete(scope->symbols);
+
+	/* Decls which outlive the scope hold their own arena reference. */
+	ofc_arena_delete(scope->arena);
+
 	free(scope);
 }
 
@@ -74,17 +121,23 @@ static bool ofc_sema_scope__add_child(
 }
 
 
-static ofc_sema_scope_t* ofc_sema_scope__create(
-	ofc_sema_scope_t* parent,
-	ofc_sema_scope_e  type)
+/* A global scope shares symbols when given them, otherwise
+   it creates a table of its own. */
+static ofc_sema_scope_t* ofc_sema_scope__create_symbols(
+	ofc_sema_scope_t*   parent,
+	ofc_sema_scope_e    type,
+	ofc_symbol_table_t* symbols)
 {
 	ofc_sema_scope_t* scope
 		= (ofc_sema_scope_t*)malloc(
 			sizeof(ofc_sema_scope_t));
 	if (!scope) return NULL;
 
-	scope->file = NULL;
-	scope->src  = OFC_SPARSE_REF_EMPTY;
+	scope->file  = NULL;
+	scope->src   = OFC_SPARSE_REF_EMPTY;
+	scope->arena = NULL;
+
+	scope->symbols = NULL;
 
 	scope->parent = parent;
 	scope->child  = NULL;
@@ -124,13 +177,21 @@ static ofc_sema_scope_t* ofc_sema_scope__create(
 	if (scope->type == OFC_SEMA_SCOPE_SUPER)
 		return scope;
 
+	if (scope->type == OFC_SEMA_SCOPE_GLOBAL)
+	{
+		scope->symbols = (ofc_symbol_table_reference(symbols)
+			? symbols : ofc_symbol_table_create());
+	}
+	else if (parent)
+		scope->symbols = parent->symbols;
+
 	scope->decl = ofc_sema_decl_list_create(
-		global_opts.case_sensitive);
+		scope->symbols, global_opts.case_sensitive);
 
 	scope->external = ofc_sema_external_list_create(
 		global_opts.case_sensitive);
 
-	bool alloc_fail = !scope->decl;
+	bool alloc_fail = (!scope->symbols || !scope->decl);
 	if (scope->type != OFC_SEMA_SCOPE_STMT_FUNC)
 	{
 		scope->implicit = (parent
@@ -169,6 +230,14 @@ static ofc_sema_scope_t* ofc_sema_scope__create(
 	return scope;
 }
 
+static ofc_sema_scope_t* ofc_sema_scope__create(
+	ofc_sema_scope_t* parent,
+	ofc_sema_scope_e  type)
+{
+	return ofc_sema_scope__create_symbols(
+		parent, type, NULL);
+}
+
 
 
 static bool ofc_sema_scope__body_sema_equivalence(
@@ -246,43 +315,144 @@ static bool ofc_sema_scope__body_format_validate(
 	return true;
 }
 
-static bool ofc_sema_scope__body_format_validate_defaults_against(
-	ofc_sema_stmt_t* stmt,
-	ofc_sema_stmt_t* format_stmt)
+/* The READ, WRITE and PRINT statements which use a FORMAT statement,
+   in statement order, so that each FORMAT statement's defaults are only
+   validated against the statements which use it. */
+typedef struct
+{
+	const ofc_sema_stmt_t* format;
+
+	unsigned          count;
+	unsigned          size;
+	ofc_sema_stmt_t** stmt;
+} ofc_sema_scope__format_use_t;
+
+static const ofc_sema_stmt_t* ofc_sema_scope__format_use_key(
+	const ofc_sema_scope__format_use_t* use)
+{
+	return (use ? use->format : NULL);
+}
+
+static bool ofc_sema_scope__format_use_compare(
+	const ofc_sema_stmt_t* a,
+	const ofc_sema_stmt_t* b)
 {
-	(void)format_stmt;
+	if (!a || !b)
+		return false;
+	return (a == b);
+}
+
+static void ofc_sema_scope__format_use_delete(
+	ofc_sema_scope__format_use_t* use)
+{
+	if (!use)
+		return;
+
+	free(use->stmt);
+	free(use);
+}
 
+static bool ofc_sema_scope__format_use_add(
+	ofc_sema_stmt_t* stmt,
+	ofc_hashmap_t* map)
+{
 	if (!stmt) return false;
 
+	const ofc_sema_expr_t* format_expr;
 	switch (stmt->type)
 	{
 		case OFC_SEMA_STMT_IO_WRITE:
+			format_expr = stmt->io_write.format;
+			break;
 		case OFC_SEMA_STMT_IO_READ:
+			format_expr = stmt->io_read.format;
+			break;
 		case OFC_SEMA_STMT_IO_PRINT:
-			return ofc_sema_stmt_io_format_validate_defaults(stmt, format_stmt);
-		default:
+			format_expr = stmt->io_print.format;
 			break;
+		default:
+			return true;
 	}
 
+	if (!format_expr
+		|| !format_expr->is_label
+		|| !format_expr->label)
+		return true;
+
+	const ofc_sema_label_t* label = format_expr->label;
+	if ((label->type != OFC_SEMA_LABEL_STMT)
+		|| !label->stmt
+		|| (label->stmt->type != OFC_SEMA_STMT_IO_FORMAT))
+		return true;
+
+	ofc_sema_scope__format_use_t* use
+		= ofc_hashmap_find_modify(map, label->stmt);
+	if (!use)
+	{
+		use = (ofc_sema_scope__format_use_t*)malloc(
+			sizeof(ofc_sema_scope__format_use_t));
+		if (!use) return false;
+
+		use->format = label->stmt;
+		use->count  = 0;
+		use->size   = 0;
+		use->stmt   = NULL;
+
+		if (!ofc_hashmap_add(map, use))
+		{
+			ofc_sema_scope__format_use_delete(use);
+			return false;
+		}
+	}
+
+	if (!ofc_sema_scope__stmt_vector_reserve(
+		&use->stmt, use->count, &use->size, 1))
+		return false;
+
+	use->stmt[use->count++] = stmt;
 	return true;
 }
 
+static ofc_hashmap_t* ofc_sema_scope__format_use(
+	ofc_sema_stmt_list_t* list)
+{
+	ofc_hashmap_t* map = ofc_hashmap_create(
+		(void*)ofc_hashmap_hash_ptr,
+		(void*)ofc_sema_scope__format_use_compare,
+		(void*)ofc_sema_scope__format_use_key,
+		(void*)ofc_sema_scope__format_use_delete);
+	if (!map) return NULL;
+
+	if (!ofc_sema_stmt_list_foreach(list, map,
+		(void*)ofc_sema_scope__format_use_add))
+	{
+		ofc_hashmap_delete(map);
+		return NULL;
+	}
+
+	return map;
+}
+
 static bool ofc_sema_scope__body_format_validate_defaults(
 	ofc_sema_stmt_t* stmt,
-	ofc_sema_scope_t* scope)
+	const ofc_hashmap_t* format_use)
 {
-	(void)scope;
-
 	if (!stmt) return false;
 
-	switch (stmt->type)
+	if (stmt->type != OFC_SEMA_STMT_IO_FORMAT)
+		return true;
+
+	const ofc_sema_scope__format_use_t* use
+		= ofc_hashmap_find(format_use, stmt);
+	if (!use) return true;
+
+	/* Validate FORMAT descriptors defaults. */
+	unsigned i;
+	for (i = 0; i < use->count; i++)
 	{
-		case OFC_SEMA_STMT_IO_FORMAT:
-			/* Validate FORMAT descriptors defaults. */
-			return ofc_sema_stmt_list_foreach(scope->stmt, stmt,
-				(void*)ofc_sema_scope__body_format_validate_defaults_against);
-		default:
-			break;
+		if (!ofc_sema_stmt_io_format_validate_defaults(
+			use->stmt[i], stmt))
+			return false;
 	}
 
 	return true;
@@ -385,26 +555,17 @@ bool ofc_sema_scope__body_decl_finalize(
 		return true;
 	}
 
+	/* Initializers set out of order are sorted once they're complete. */
+	if (!ofc_sema_decl_init_finalize(decl))
+		return false;
+
 	return ofc_sema_decl_type_finalize(decl);
 }
 
-static bool ofc_sema_scope__body(
+static bool ofc_sema_scope__body_resolve(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_list_t* body)
 {
-	if (scope->type == OFC_SEMA_SCOPE_STMT_FUNC)
-		return false;
-
-	if (!body)
-		return true;
-
-	if (scope->stmt)
-		return false;
-
-	scope->stmt = ofc_sema_stmt_list(scope, NULL, body);
-	if (!scope->stmt)
-		return false;
-
 	/* Finalize declarations. */
 	if (!ofc_sema_scope_foreach_decl(scope, NULL,
 		(void*)ofc_sema_scope__body_decl_finalize))
@@ -440,9 +601,15 @@ static bool ofc_sema_scope__body(
 		return false;
 
 	/* Validate FORMAT descriptors defaults. */
-	if (!ofc_sema_stmt_list_foreach(scope->stmt, scope,
-		(void*)ofc_sema_scope__body_format_validate_defaults))
-		return false;
+	ofc_hashmap_t* format_use
+		= ofc_sema_scope__format_use(scope->stmt);
+	if (!format_use) return false;
+
+	bool success = ofc_sema_stmt_list_foreach(
+		scope->stmt, format_use,
+		(void*)ofc_sema_scope__body_format_validate_defaults);
+	ofc_hashmap_delete(format_use);
+	if (!success) return false;
 
 	/* Handle EQUIVALENCE statements */
 	if (!ofc_parse_stmt_list_foreach(body, scope,
@@ -452,6 +619,26 @@ static bool ofc_sema_scope__body(
 	return ofc_sema_scope__body_validate(scope);
 }
 
+static bool ofc_sema_scope__body(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_list_t* body)
+{
+	if (scope->type == OFC_SEMA_SCOPE_STMT_FUNC)
+		return false;
+
+	if (!body)
+		return true;
+
+	if (scope->stmt)
+		return false;
+
+	scope->stmt = ofc_sema_stmt_list(scope, NULL, body);
+	if (!scope->stmt)
+		return false;
+
+	return ofc_sema_scope__body_resolve(scope, body);
+}
+
 bool ofc_sema_scope__check_namespace_collision(
 	ofc_sema_scope_t* scope,
 	const char* name_space, ofc_sparse_ref_t ref)
@@ -545,34 +732,44 @@ bool ofc_sema_scope__check_namespace_collision(
 	return collision;
 }
 
-bool ofc_sema_scope_subroutine(
+/* Program units are analysed in four steps, the unit is registered
+   with its parent, the head creates the unit scope, then the body is
+   analysed and the tail attaches the unit to its parent. Only the
+   register and tail steps modify the parent. */
+
+static bool ofc_sema_scope__subroutine_register(
 	ofc_sema_scope_t* scope,
-	const ofc_parse_stmt_t* stmt)
+	const ofc_parse_stmt_t* stmt,
+	ofc_sema_decl_t** decl)
 {
-	if (!scope || !stmt
-		|| (stmt->type != OFC_PARSE_STMT_SUBROUTINE))
-		return false;
-
 	ofc_sparse_ref_t name = stmt->program.name;
 	if (ofc_sparse_ref_empty(name))
 		return false;
 
-	ofc_sema_decl_t* decl
-		= ofc_sema_scope_decl_find_create_ns(
-			scope, name, true, "Subroutine");
-	if (!decl) return false;
+	*decl = ofc_sema_scope_decl_find_create_ns(
+		scope, name, true, "Subroutine");
+	if (!*decl) return false;
 
-	if (!ofc_sema_decl_subroutine(decl))
+	if (!ofc_sema_decl_subroutine(*decl))
 	{
 		ofc_sparse_ref_error(stmt->src,
 			"Can't redefine declaration as SUBROUTINE");
 		return false;
 	}
 
+	return true;
+}
+
+static ofc_sema_scope_t* ofc_sema_scope__subroutine_head(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt)
+{
+	ofc_sparse_ref_t name = stmt->program.name;
+
 	ofc_sema_scope_t* sub_scope
 		= ofc_sema_scope__create(scope,
 			OFC_SEMA_SCOPE_SUBROUTINE);
-	if (!sub_scope) return false;
+	if (!sub_scope) return NULL;
 	sub_scope->src  = stmt->src;
 	sub_scope->name = name.string;
 
@@ -583,7 +780,7 @@ bool ofc_sema_scope_subroutine(
 		if (!sub_scope->args)
 		{
 			ofc_sema_scope_delete(sub_scope);
-			return false;
+			return NULL;
 		}
 	}
 
@@ -592,16 +789,16 @@ bool ofc_sema_scope_subroutine(
 			sub_scope->label, stmt->program.end_label, sub_scope))
 	{
 		ofc_sema_scope_delete(sub_scope);
-		return false;
+		return NULL;
 	}
 
-	if (!ofc_sema_scope__body(
-		sub_scope, stmt->program.body))
-	{
-		ofc_sema_scope_delete(sub_scope);
-		return false;
-	}
+	return sub_scope;
+}
 
+static bool ofc_sema_scope__subroutine_tail(
+	ofc_sema_decl_t* decl,
+	ofc_sema_scope_t* sub_scope)
+{
 	if (!ofc_sema_decl_init_func(
 		decl, sub_scope))
 	{
@@ -612,114 +809,652 @@ bool ofc_sema_scope_subroutine(
 	return true;
 }
 
-bool ofc_sema_scope_function(
+static ofc_sema_scope_t* ofc_sema_scope__function_head(
 	ofc_sema_scope_t* scope,
-	const ofc_parse_stmt_t* stmt)
+	const ofc_parse_stmt_t* stmt,
+	ofc_sema_decl_t** rdecl)
 {
-	if (!scope || !stmt
-		|| (stmt->type != OFC_PARSE_STMT_FUNCTION))
-		return false;
-
 	ofc_sparse_ref_t name = stmt->program.name;
 	if (ofc_sparse_ref_empty(name))
-		return false;
+		return NULL;
 
 	const ofc_sema_type_t* type = NULL;
 	if (stmt->program.type)
 	{
 		type = ofc_sema_type(
 			scope, stmt->program.type, NULL);
-		if (!type) return false;
+		if (!type) return NULL;
 	}
 
 	ofc_sema_scope_t* func_scope
 		= ofc_sema_scope__create(scope,
 			OFC_SEMA_SCOPE_FUNCTION);
-	if (!func_scope) return false;
+	if (!func_scope) return NULL;
 	func_scope->src  = stmt->src;
 	func_scope->name = name.string;
 
-	ofc_sema_decl_t* rdecl
+	*rdecl = ofc_sema_scope_decl_find_create_ns(
+		func_scope, name, true, NULL);
+	if (!*rdecl)
+	{
+		ofc_sema_scope_delete(func_scope);
+		return NULL;
+	}
+
+	if (type) (*rdecl)->type = type;
+
+	(*rdecl)->is_return = true;
+
+	if (stmt->program.args)
+	{
+		func_scope->args = ofc_sema_arg_list(
+			stmt->program.args);
+		if (!func_scope->args)
+		{
+			ofc_sema_scope_delete(func_scope);
+			return NULL;
+		}
+	}
+
+	if (stmt->program.end_has_label
+		&& !ofc_sema_label_map_add_end_scope(
+			func_scope->label, stmt->program.end_label, func_scope))
+	{
+		ofc_sema_scope_delete(func_scope);
+		return NULL;
+	}
+
+	return func_scope;
+}
+
+static bool ofc_sema_scope__function_tail(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt,
+	ofc_sema_decl_t* rdecl,
+	ofc_sema_scope_t* func_scope)
+{
+	ofc_sparse_ref_t name = stmt->program.name;
+
+	if (!ofc_sema_decl_type_finalize(rdecl))
+	{
+		ofc_sparse_ref_error(stmt->src,
+			"No IMPLICIT type matches FUNCTION name");
+		ofc_sema_scope_delete(func_scope);
+		return false;
+	}
+
+	ofc_sema_decl_t* fdecl
 		= ofc_sema_scope_decl_find_create_ns(
-			func_scope, name, true, NULL);
-	if (!rdecl)
+			scope, name, true, "Function");
+	if (!fdecl)
+	{
+		ofc_sema_scope_delete(func_scope);
+		return false;
+	}
+
+	if (!ofc_sema_decl_type_set(
+		fdecl, rdecl->type, name))
+	{
+		ofc_sparse_ref_error(stmt->src,
+			"Conflicting definitions of FUNCTION return type");
+		ofc_sema_scope_delete(func_scope);
+		return false;
+	}
+
+	if (!ofc_sema_decl_function(fdecl))
+	{
+		ofc_sparse_ref_error(stmt->src,
+			"Can't redeclare used variable as FUNCTION");
+		ofc_sema_scope_delete(func_scope);
+		return false;
+	}
+
+	if (!ofc_sema_decl_init_func(
+		fdecl, func_scope))
+	{
+		ofc_sema_scope_delete(func_scope);
+		return false;
+	}
+
+	return true;
+}
+
+static ofc_sema_scope_t* ofc_sema_scope__program_head(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt)
+{
+	ofc_sema_scope_t* program
+		= ofc_sema_scope__create(
+			scope, OFC_SEMA_SCOPE_PROGRAM);
+	if (!program) return NULL;
+
+	program->src  = stmt->src;
+	program->name = stmt->program.name.string;
+
+	if (stmt->program.end_has_label
+		&& !ofc_sema_label_map_add_end_scope(
+			program->label, stmt->program.end_label, program))
+	{
+		ofc_sema_scope_delete(program);
+		return NULL;
+	}
+
+	return program;
+}
+
+static bool ofc_sema_scope__program_tail(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope_t* program)
+{
+	if (!ofc_sema_scope__add_child(scope, program))
+	{
+		ofc_sema_scope_delete(program);
+		return false;
+	}
+
+	return true;
+}
+
+
+typedef struct
+{
+	const ofc_parse_stmt_t* stmt;
+	ofc_sema_scope_t*       scope;
+	ofc_sema_decl_t*        decl;
+
+	/* Set when the scope is shared with an earlier analysis. */
+	bool shared;
+
+	/* Set when the unit is analysed on the unit pool. */
+	ofc_file_diag_t head;
+	ofc_file_diag_t body;
+	bool            failed;
+} ofc_sema_scope__unit_t;
+
+static bool ofc_sema_scope__unit_register(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope__unit_t* unit)
+{
+	switch (unit->stmt->type)
+	{
+		case OFC_PARSE_STMT_SUBROUTINE:
+			return ofc_sema_scope__subroutine_register(
+				scope, unit->stmt, &unit->decl);
+		default:
+			break;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_scope__unit_head(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope__unit_t* unit)
+{
+	switch (unit->stmt->type)
+	{
+		case OFC_PARSE_STMT_SUBROUTINE:
+			unit->scope = ofc_sema_scope__subroutine_head(
+				scope, unit->stmt);
+			break;
+		case OFC_PARSE_STMT_FUNCTION:
+			unit->scope = ofc_sema_scope__function_head(
+				scope, unit->stmt, &unit->decl);
+			break;
+		case OFC_PARSE_STMT_PROGRAM:
+			unit->scope = ofc_sema_scope__program_head(
+				scope, unit->stmt);
+			break;
+		default:
+			unit->scope = NULL;
+			break;
+	}
+
+	return (unit->scope != NULL);
+}
+
+/* The unit scope is deleted if this fails. */
+static bool ofc_sema_scope__unit_tail(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope__unit_t* unit)
+{
+	switch (unit->stmt->type)
+	{
+		case OFC_PARSE_STMT_SUBROUTINE:
+			return ofc_sema_scope__subroutine_tail(
+				unit->decl, unit->scope);
+		case OFC_PARSE_STMT_FUNCTION:
+			return ofc_sema_scope__function_tail(
+				scope, unit->stmt, unit->decl, unit->scope);
+		case OFC_PARSE_STMT_PROGRAM:
+			return ofc_sema_scope__program_tail(
+				scope, unit->scope);
+		default:
+			break;
+	}
+
+	ofc_sema_scope_delete(unit->scope);
+	return false;
+}
+
+static ofc_sema_scope_t* ofc_sema_scope__unit(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt)
+{
+	ofc_sema_scope__unit_t unit =
+	{
+		.stmt  = stmt,
+		.scope = NULL,
+		.decl  = NULL,
+	};
+
+	if (!ofc_sema_scope__unit_register(scope, &unit)
+		|| !ofc_sema_scope__unit_head(scope, &unit))
+		return NULL;
+
+	if (!ofc_sema_scope__body(
+		unit.scope, stmt->program.body))
+	{
+		ofc_sema_scope_delete(unit.scope);
+		return NULL;
+	}
+
+	if (!ofc_sema_scope__unit_tail(scope, &unit))
+		return NULL;
+
+	return unit.scope;
+}
+
+bool ofc_sema_scope_subroutine(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!scope || !stmt
+		|| (stmt->type != OFC_PARSE_STMT_SUBROUTINE))
+		return false;
+
+	return (ofc_sema_scope__unit(scope, stmt) != NULL);
+}
+
+bool ofc_sema_scope_function(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!scope || !stmt
+		|| (stmt->type != OFC_PARSE_STMT_FUNCTION))
+		return false;
+
+	return (ofc_sema_scope__unit(scope, stmt) != NULL);
+}
+
+ofc_sema_scope_t* ofc_sema_scope_program(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!stmt || !scope
+		|| (stmt->type != OFC_PARSE_STMT_PROGRAM))
+		return NULL;
+
+	return ofc_sema_scope__unit(scope, stmt);
+}
+
+
+/* Files made up of nothing but independent program units may have their
+   unit bodies analysed on a pool of threads. Heads and bodies only look
+   at the unit scope, so once every head has run in source order the
+   bodies can run in any order. Each unit allocates from its own arena
+   and its diagnostics are held back, then units are registered and
+   attached in source order while their diagnostics are replayed, so the
+   result is the same as a serial run.
+
+   --watch analyses such files this way too, since a unit with an arena
+   of its own can be shared with the next analysis of the file if its
+   text and position haven't changed. */
+
+static const ofc_str_ref_t* ofc_sema_scope__unit_key(
+	const ofc_sema_scope__unit_t* unit)
+{
+	return &unit->stmt->program.name.string;
+}
+
+static bool ofc_sema_scope__units_gather(
+	const ofc_parse_stmt_list_t* body,
+	ofc_sema_scope__unit_t** unit, unsigned* count)
+{
+	if (((global_opts.unit_jobs < 2) && !global_opts.watch)
+		|| !body || (body->count < 2))
+		return false;
+
+	/* A USE depends on modules being analysed in source order. */
+	if (ofc_parse_stmt_list_contains_use(body))
+		return false;
+
+	unsigned units = 0;
+	unsigned i;
+	for (i = 0; i < body->count; i++)
+	{
+		const ofc_parse_stmt_t* stmt = body->stmt[i];
+		if (!stmt) return false;
+
+		switch (stmt->type)
+		{
+			case OFC_PARSE_STMT_EMPTY:
+			case OFC_PARSE_STMT_INCLUDE:
+				continue;
+			case OFC_PARSE_STMT_SUBROUTINE:
+			case OFC_PARSE_STMT_FUNCTION:
+			case OFC_PARSE_STMT_PROGRAM:
+				break;
+			default:
+				return false;
+		}
+
+		if (stmt->label != 0)
+			return false;
+		units++;
+	}
+
+	if (units < 2)
+		return false;
+
+	*unit = (ofc_sema_scope__unit_t*)calloc(
+		units, sizeof(ofc_sema_scope__unit_t));
+	if (!*unit) return false;
+
+	ofc_hashmap_t* map = ofc_hashmap_create(
+		(void*)(global_opts.case_sensitive
+			? ofc_str_ref_ptr_hash
+			: ofc_str_ref_ptr_hash_ci),
+		(void*)(global_opts.case_sensitive
+			? ofc_str_ref_ptr_equal
+			: ofc_str_ref_ptr_equal_ci),
+		(void*)ofc_sema_scope__unit_key, NULL);
+	bool unique = (map != NULL);
+
+	*count = 0;
+	for (i = 0; unique && (i < body->count); i++)
+	{
+		const ofc_parse_stmt_t* stmt = body->stmt[i];
+		if ((stmt->type == OFC_PARSE_STMT_EMPTY)
+			|| (stmt->type == OFC_PARSE_STMT_INCLUDE))
+			continue;
+
+		ofc_sema_scope__unit_t* u = &(*unit)[(*count)++];
+		u->stmt = stmt;
+
+		/* Heads would see a unit of the same name at a different
+		   point than a serial run does, so analyse those serially. */
+		const ofc_str_ref_t* name = ofc_sema_scope__unit_key(u);
+		if (ofc_str_ref_empty(*name))
+			continue;
+		unique = !ofc_hashmap_find(map, name)
+			&& ofc_hashmap_add(map, u);
+	}
+
+	ofc_hashmap_delete(map);
+
+	if (!unique)
+	{
+		free(*unit);
+		*unit = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+static void ofc_sema_scope__unit_run(
+	ofc_sema_scope__unit_t* unit)
+{
+	ofc_arena_t* prev = ofc_arena_current_set(
+		unit->scope->arena);
+
+	ofc_file_diag_hold(&unit->body);
+	unit->failed = !ofc_sema_scope__body(
+		unit->scope, unit->stmt->program.body);
+	ofc_file_diag_release(&unit->body);
+
+	ofc_arena_current_set(prev);
+}
+
+/* Longer bodies are started first so that no thread is left
+   analysing a large unit on its own at the end. */
+static int ofc_sema_scope__unit_order(
+	const void* a, const void* b)
+{
+	const ofc_sema_scope__unit_t* ua
+		= *((const ofc_sema_scope__unit_t**)a);
+	const ofc_sema_scope__unit_t* ub
+		= *((const ofc_sema_scope__unit_t**)b);
+
+	const ofc_parse_stmt_list_t* ba = ua->stmt->program.body;
+	const ofc_parse_stmt_list_t* bb = ub->stmt->program.body;
+	unsigned ca = (ba ? ba->count : 0);
+	unsigned cb = (bb ? bb->count : 0);
+
+	if (ca != cb)
+		return (ca > cb ? -1 : 1);
+	return (ua < ub ? -1 : (ua > ub));
+}
+
+/* The unit of prev with the same name as stmt, when it can be shared
+   because its text and position are the same and it has an arena of
+   its own so that it can outlive prev. */
+static ofc_sema_scope_t* ofc_sema_scope__unit_prev(
+	ofc_sema_scope_t* prev,
+	const ofc_parse_stmt_t* stmt)
+{
+	if (!prev || !prev->file || !prev->file->stmt)
+		return NULL;
+
+	ofc_str_ref_t name = stmt->program.name.string;
+	bool (*equal)(const ofc_str_ref_t, const ofc_str_ref_t)
+		= (global_opts.case_sensitive
+			? ofc_str_ref_equal : ofc_str_ref_equal_ci);
+
+	const ofc_parse_stmt_list_t* list = prev->file->stmt;
+	const ofc_parse_stmt_t* pstmt = NULL;
+	unsigned i;
+	for (i = 0; !pstmt && (i < list->count); i++)
+	{
+		const ofc_parse_stmt_t* s = list->stmt[i];
+		if (s && (s->type == stmt->type)
+			&& equal(s->program.name.string, name))
+			pstmt = s;
+	}
+
+	if (!ofc_parse_stmt_text_equal(pstmt, stmt)
+		|| !ofc_parse_stmt_position_equal(pstmt, stmt))
+		return NULL;
+
+	ofc_sema_scope_t* unit = NULL;
+	if (stmt->type == OFC_PARSE_STMT_PROGRAM)
+	{
+		for (i = 0; !unit && prev->child
+			&& (i < prev->child->count); i++)
+		{
+			ofc_sema_scope_t* child = prev->child->scope[i];
+			if ((child->type == OFC_SEMA_SCOPE_PROGRAM)
+				&& equal(child->name, name))
+				unit = child;
+		}
+	}
+	else
+	{
+		const ofc_sema_decl_t* decl
+			= ofc_sema_scope_decl_find(prev, name, true);
+		if (decl) unit = decl->func;
+	}
+
+	if (!unit || !unit->arena
+		|| (unit->parent != prev))
+		return NULL;
+	return unit;
+}
+
+/* Attaches a shared unit the way its tail would, it's left for prev
+   to delete until ofc_sema_scope_global_replace moves it to scope. */
+static bool ofc_sema_scope__unit_tail_shared(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope__unit_t* unit)
+{
+	ofc_sparse_ref_t name = unit->stmt->program.name;
+
+	switch (unit->stmt->type)
+	{
+		case OFC_PARSE_STMT_SUBROUTINE:
+			return ofc_sema_decl_init_func(
+				unit->decl, unit->scope);
+
+		case OFC_PARSE_STMT_FUNCTION:
+		{
+			ofc_sema_decl_t* fdecl
+				= ofc_sema_scope_decl_find_create_ns(
+					scope, name, true, "Function");
+			return (fdecl
+				&& ofc_sema_decl_type_set(
+					fdecl, unit->decl->type, name)
+				&& ofc_sema_decl_function(fdecl)
+				&& ofc_sema_decl_init_func(
+					fdecl, unit->scope));
+		}
+
+		case OFC_PARSE_STMT_PROGRAM:
+			if (!scope->child)
+			{
+				scope->child = ofc_sema_scope_list_create();
+				if (!scope->child) return false;
+			}
+			return ofc_sema_scope_list_add(
+				scope->child, unit->scope);
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+static ofc_sema_stmt_list_t* ofc_sema_scope__units(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope__unit_t* unit, unsigned count,
+	ofc_sema_scope_t* prev, unsigned* shared)
+{
+	/* A unit whose head fails stops the file, as in a serial run. */
+	unsigned heads;
+	for (heads = 0; heads < count; heads++)
 	{
-		ofc_sema_scope_delete(func_scope);
-		return false;
-	}
+		ofc_sema_scope__unit_t* u = &unit[heads];
 
-	if (type) rdecl->type = type;
+		u->scope = ofc_sema_scope__unit_prev(prev, u->stmt);
+		if (u->scope && (u->stmt->type == OFC_PARSE_STMT_FUNCTION))
+		{
+			u->decl = ofc_sema_scope_decl_find_modify(
+				u->scope, u->stmt->program.name.string, true);
+			if (!u->decl) u->scope = NULL;
+		}
+		if (u->scope)
+		{
+			u->shared = true;
+			continue;
+		}
 
-	rdecl->is_return = true;
+		/* The head allocates from the unit's arena too, so that
+		   nothing the unit holds is in the arena of this scope. */
+		ofc_arena_t* arena = ofc_arena_create();
+		if (!arena) break;
+		ofc_arena_t* prev_arena = ofc_arena_current_set(arena);
 
-	if (stmt->program.args)
-	{
-		func_scope->args = ofc_sema_arg_list(
-			stmt->program.args);
-		if (!func_scope->args)
+		ofc_file_diag_hold(&u->head);
+		bool success = ofc_sema_scope__unit_head(scope, u);
+		ofc_file_diag_release(&u->head);
+
+		ofc_arena_current_set(prev_arena);
+		if (!success)
 		{
-			ofc_sema_scope_delete(func_scope);
-			return false;
+			ofc_arena_delete(arena);
+			break;
 		}
-	}
 
-	if (stmt->program.end_has_label
-		&& !ofc_sema_label_map_add_end_scope(
-			func_scope->label, stmt->program.end_label, func_scope))
-	{
-		ofc_sema_scope_delete(func_scope);
-		return false;
+		u->scope->arena = arena;
 	}
 
-	if (!ofc_sema_scope__body(
-		func_scope, stmt->program.body))
-	{
-		ofc_sema_scope_delete(func_scope);
-		return false;
-	}
+	ofc_sema_scope__unit_t** order
+		= (ofc_sema_scope__unit_t**)malloc(
+			sizeof(ofc_sema_scope__unit_t*) * (heads + 1));
 
-	if (!ofc_sema_decl_type_finalize(rdecl))
-	{
-		ofc_sparse_ref_error(stmt->src,
-			"No IMPLICIT type matches FUNCTION name");
-		ofc_sema_scope_delete(func_scope);
-		return false;
-	}
+	/* Shared tables must be built before any worker races to. */
+	ofc_sema_intrinsic_init();
 
-	ofc_sema_decl_t* fdecl
-		= ofc_sema_scope_decl_find_create_ns(
-			scope, name, true, "Function");
-	if (!fdecl)
-	{
-		ofc_sema_scope_delete(func_scope);
-		return false;
-	}
+	unsigned threads = global_opts.unit_jobs;
+	if (threads > heads)
+		threads = heads;
 
-	if (!ofc_sema_decl_type_set(
-		fdecl, rdecl->type, name))
+	ofc_thread_pool_t* pool = (order && (threads > 1)
+		? ofc_thread_pool_create(threads) : NULL);
+
+	unsigned i;
+	if (order)
 	{
-		ofc_sparse_ref_error(stmt->src,
-			"Conflicting definitions of FUNCTION return type");
-		ofc_sema_scope_delete(func_scope);
-		return false;
+		for (i = 0; i < heads; i++)
+			order[i] = &unit[i];
+		qsort(order, heads, sizeof(ofc_sema_scope__unit_t*),
+			ofc_sema_scope__unit_order);
 	}
 
-	if (!ofc_sema_decl_function(fdecl))
+	for (i = 0; i < heads; i++)
 	{
-		ofc_sparse_ref_error(stmt->src,
-			"Can't redeclare used variable as FUNCTION");
-		ofc_sema_scope_delete(func_scope);
-		return false;
+		ofc_sema_scope__unit_t* u = (order ? order[i] : &unit[i]);
+		if (u->shared) continue;
+
+		if (!pool || !ofc_thread_pool_add(pool,
+			(ofc_thread_pool_job_f)ofc_sema_scope__unit_run, u))
+			ofc_sema_scope__unit_run(u);
 	}
 
-	if (!ofc_sema_decl_init_func(
-		fdecl, func_scope))
+	ofc_thread_pool_delete(pool);
+	free(order);
+
+	bool success = true;
+	for (i = 0; i < count; i++)
 	{
-		ofc_sema_scope_delete(func_scope);
-		return false;
+		ofc_sema_scope__unit_t* u = &unit[i];
+
+		if (success)
+			success = ofc_sema_scope__unit_register(scope, u);
+
+		if (success && (i <= heads))
+		{
+			ofc_file_diag_replay(&u->head);
+			success = (i < heads);
+		}
+
+		if (success)
+		{
+			ofc_file_diag_replay(&u->body);
+			success = !u->failed;
+		}
+
+		if (success)
+		{
+			success = (u->shared
+				? ofc_sema_scope__unit_tail_shared(scope, u)
+				: ofc_sema_scope__unit_tail(scope, u));
+			if (success && u->shared)
+				(*shared)++;
+			u->scope = NULL;
+		}
+
+		if (!u->shared)
+			ofc_sema_scope_delete(u->scope);
+		ofc_file_diag_discard(&u->head);
+		ofc_file_diag_discard(&u->body);
 	}
 
-	return true;
+	if (!success)
+		return NULL;
+
+	return ofc_sema_stmt_list_create();
 }
 
 ofc_sema_scope_t* ofc_sema_scope_super(void)
@@ -728,26 +1463,57 @@ ofc_sema_scope_t* ofc_sema_scope_super(void)
 		NULL, OFC_SEMA_SCOPE_SUPER);
 }
 
-ofc_sema_scope_t* ofc_sema_scope_global(
+static ofc_sema_scope_t* ofc_sema_scope__global(
 	ofc_sema_scope_t* super,
-	ofc_parse_file_t* file)
+	ofc_parse_file_t* file,
+	ofc_sema_scope_t* prev_scope,
+	unsigned* shared)
 {
 	if (!file)
 		return NULL;
 
+	ofc_arena_t* arena = ofc_arena_create();
+	if (!arena) return NULL;
+
+	/* The sema tree for each file is allocated from its own arena,
+	   which is owned by the global scope. */
+	ofc_arena_t* prev = ofc_arena_current_set(arena);
+
+	/* Units shared with prev_scope hold symbols from its table. */
 	ofc_sema_scope_t* scope
-		= ofc_sema_scope__create(
-			super, OFC_SEMA_SCOPE_GLOBAL);
-	if (!scope) return NULL;
+		= ofc_sema_scope__create_symbols(
+			super, OFC_SEMA_SCOPE_GLOBAL,
+			(prev_scope ? prev_scope->symbols : NULL));
+	if (!scope)
+	{
+		ofc_arena_current_set(prev);
+		ofc_arena_delete(arena);
+		return NULL;
+	}
+	scope->arena = arena;
 
 	const ofc_parse_stmt_list_t* list = file->stmt;
-	if (!ofc_sema_scope__body(scope, list))
+
+	bool success;
+	ofc_sema_scope__unit_t* unit;
+	unsigned unit_count;
+	if (ofc_sema_scope__units_gather(
+		list, &unit, &unit_count))
 	{
-		ofc_sema_scope_delete(scope);
-		return NULL;
+		scope->stmt = ofc_sema_scope__units(
+			scope, unit, unit_count, prev_scope, shared);
+		free(unit);
+
+		success = (scope->stmt
+			&& ofc_sema_scope__body_resolve(scope, list));
+	}
+	else
+	{
+		success = ofc_sema_scope__body(scope, list);
 	}
+	ofc_arena_current_set(prev);
 
-	if (super && !ofc_sema_scope__add_child(super, scope))
+	if (!success)
 	{
 		ofc_sema_scope_delete(scope);
 		return NULL;
@@ -769,48 +1535,264 @@ ofc_sema_scope_t* ofc_sema_scope_global(
 		}
 	}
 
-	scope->file = file;
 	return scope;
 }
 
-ofc_sema_scope_t* ofc_sema_scope_program(
+ofc_sema_scope_t* ofc_sema_scope_global_detached(
+	ofc_sema_scope_t* super,
+	ofc_parse_file_t* file)
+{
+	unsigned shared = 0;
+	return ofc_sema_scope__global(
+		super, file, NULL, &shared);
+}
+
+ofc_sema_scope_t* ofc_sema_scope_global_update(
+	ofc_sema_scope_t* super,
+	ofc_parse_file_t* file,
+	ofc_sema_scope_t* prev,
+	unsigned* shared)
+{
+	unsigned count = 0;
+	ofc_sema_scope_t* scope
+		= ofc_sema_scope__global(
+			super, file, prev, &count);
+	if (scope && shared)
+		*shared = count;
+	return scope;
+}
+
+bool ofc_sema_scope_global_attach(
+	ofc_sema_scope_t* super,
 	ofc_sema_scope_t* scope,
-	const ofc_parse_stmt_t* stmt)
+	ofc_parse_file_t* file)
 {
-	if (!stmt || !scope
-		|| (stmt->type != OFC_PARSE_STMT_PROGRAM))
-		return NULL;
+	if (!scope || !file)
+		return false;
 
-	ofc_sema_scope_t* program
-		= ofc_sema_scope__create(
-			scope, OFC_SEMA_SCOPE_PROGRAM);
-	if (!program) return NULL;
+	if (super && !ofc_sema_scope__add_child(super, scope))
+		return false;
 
-	program->src  = stmt->src;
-	program->name = stmt->program.name.string;
+	scope->file = file;
+	return true;
+}
 
-	if (stmt->program.end_has_label
-		&& !ofc_sema_label_map_add_end_scope(
-			program->label, stmt->program.end_label, program))
+/* A unit moved from old keeps the parse tree it was analysed from. */
+static void ofc_sema_scope__unit_adopt(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope_t* old,
+	ofc_sema_scope_t* unit)
+{
+	if (!unit || (unit->parent != old))
+		return;
+
+	if (!unit->file && ofc_parse_file_reference(old->file))
+		unit->file = old->file;
+	unit->parent = scope;
+}
+
+static void ofc_sema_scope__units_adopt(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope_t* old)
+{
+	unsigned i;
+	for (i = 0; scope->child && (i < scope->child->count); i++)
 	{
-		ofc_sema_scope_delete(program);
+		ofc_sema_scope__unit_adopt(
+			scope, old, scope->child->scope[i]);
+	}
+
+	for (i = 0; scope->decl && (i < scope->decl->count); i++)
+	{
+		ofc_sema_decl_t* decl = scope->decl->decl[i];
+		if (decl) ofc_sema_scope__unit_adopt(
+			scope, old, decl->func);
+	}
+
+	ofc_sema_scope__units_disown(old);
+}
+
+bool ofc_sema_scope_global_replace(
+	ofc_sema_scope_t* super,
+	ofc_sema_scope_t* old,
+	ofc_sema_scope_t* scope,
+	ofc_parse_file_t* file)
+{
+	if (!super || !super->child
+		|| !old || !scope || !file
+		|| (scope->parent != super))
 		return false;
+
+	unsigned i;
+	for (i = 0; i < super->child->count; i++)
+	{
+		if (super->child->scope[i] == old)
+		{
+			super->child->scope[i] = scope;
+			scope->file = file;
+			ofc_sema_scope__units_adopt(scope, old);
+			return true;
+		}
 	}
 
-	if (!ofc_sema_scope__body(
-		program, stmt->program.body))
+	return false;
+}
+
+typedef struct
+{
+	const ofc_sema_scope_t* other;
+	bool                    found;
+} ofc_sema_scope__uses_module_t;
+
+static bool ofc_sema_scope__uses_module(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope__uses_module_t* param)
+{
+	if (!scope->module)
+		return true;
+
+	unsigned i;
+	for (i = 0; i < scope->module->count; i++)
 	{
-		ofc_sema_scope_delete(program);
+		const ofc_sema_module_t* module
+			= scope->module->module[i];
+		if (!module) continue;
+
+		const ofc_sema_scope_t* s;
+		for (s = module->scope; s; s = s->parent)
+		{
+			if (s == param->other)
+			{
+				param->found = true;
+				/* Returning false stops the walk early. */
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool ofc_sema_scope_uses_module_of(
+	const ofc_sema_scope_t* scope,
+	const ofc_sema_scope_t* other)
+{
+	if (!scope || !other)
+		return false;
+
+	ofc_sema_scope__uses_module_t param =
+	{
+		.other = other,
+		.found = false,
+	};
+
+	ofc_sema_scope_foreach_scope(
+		(ofc_sema_scope_t*)scope, &param,
+		(void*)ofc_sema_scope__uses_module);
+	return param.found;
+}
+
+typedef struct
+{
+	ofc_sema_scope_t** scope;
+	unsigned           count;
+	bool               owned;
+} ofc_sema_scope__units_t;
+
+static bool ofc_sema_scope__units_add(
+	ofc_sema_scope_t* scope,
+	ofc_sema_scope__units_t* units)
+{
+	/* Units which share their parent's arena can't be walked
+	   alongside each other. */
+	if (!scope->arena)
+	{
+		units->owned = false;
+		return false;
+	}
+
+	units->scope[units->count++] = scope;
+	return true;
+}
+
+static bool ofc_sema_scope__units_add_decl(
+	ofc_sema_decl_t* decl,
+	ofc_sema_scope__units_t* units)
+{
+	if (!decl->func)
+		return true;
+	return ofc_sema_scope__units_add(
+		decl->func, units);
+}
+
+ofc_sema_scope_t** ofc_sema_scope_units(
+	ofc_sema_scope_t* scope, unsigned* count)
+{
+	if (!scope || !count
+		|| (scope->type != OFC_SEMA_SCOPE_GLOBAL)
+		|| (global_opts.unit_jobs < 2))
+		return NULL;
+
+	unsigned size = 0;
+	if (scope->child)
+		size += scope->child->count;
+	if (scope->decl)
+		size += scope->decl->count;
+	if (size < 2)
+		return NULL;
+
+	ofc_sema_scope__units_t units =
+	{
+		.scope = (ofc_sema_scope_t**)malloc(
+			sizeof(ofc_sema_scope_t*) * size),
+		.count = 0,
+		.owned = true,
+	};
+	if (!units.scope)
 		return NULL;
+
+	if (scope->child)
+	{
+		unsigned i;
+		for (i = 0; units.owned && (i < scope->child->count); i++)
+		{
+			ofc_sema_scope__units_add(
+				scope->child->scope[i], &units);
+		}
 	}
 
-	if (!ofc_sema_scope__add_child(scope, program))
+	if (units.owned && scope->decl)
 	{
-		ofc_sema_scope_delete(program);
+		ofc_sema_decl_list_foreach(scope->decl, &units,
+			(void*)ofc_sema_scope__units_add_decl);
+	}
+
+	if (!units.owned || (units.count < 2))
+	{
+		free(units.scope);
 		return NULL;
 	}
 
-	return program;
+	*count = units.count;
+	return units.scope;
+}
+
+ofc_sema_scope_t* ofc_sema_scope_global(
+	ofc_sema_scope_t* super,
+	ofc_parse_file_t* file)
+{
+	ofc_sema_scope_t* scope
+		= ofc_sema_scope_global_detached(super, file);
+	if (!scope) return NULL;
+
+	if (!ofc_sema_scope_global_attach(
+		super, scope, file))
+	{
+		ofc_sema_scope_delete(scope);
+		return NULL;
+	}
+
+	return scope;
 }
 
 ofc_sema_scope_t* ofc_sema_scope_stmt_func(
@@ -1173,8 +2155,10 @@ bool ofc_sema_scope_equiv_add(
 }
 
 
-const ofc_sema_decl_t* ofc_sema_scope_decl_find(
-	const ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
+/* Names are looked up as symbols so that walking out through
+   statement function scopes doesn't hash the name at every level. */
+static const ofc_sema_decl_t* ofc_sema_scope__decl_find_symbol(
+	const ofc_sema_scope_t* scope, ofc_symbol_t symbol, bool local)
 {
 	if (!scope)
 		return NULL;
@@ -1189,19 +2173,19 @@ const ofc_sema_decl_t* ofc_sema_scope_decl_find(
 	}
 
 	const ofc_sema_decl_t* decl
-		= ofc_sema_decl_list_find(
-			scope->decl, name);
+		= ofc_sema_decl_list_find_symbol(
+			scope->decl, symbol);
 	if (decl) return decl;
 
 	if (local)
 		return NULL;
 
-	return ofc_sema_scope_decl_find(
-		scope->parent, name, false);
+	return ofc_sema_scope__decl_find_symbol(
+		scope->parent, symbol, false);
 }
 
-ofc_sema_decl_t* ofc_sema_scope_decl_find_modify(
-	ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
+static ofc_sema_decl_t* ofc_sema_scope__decl_find_symbol_modify(
+	ofc_sema_scope_t* scope, ofc_symbol_t symbol, bool local)
 {
 	if (!scope)
 		return NULL;
@@ -1216,15 +2200,37 @@ ofc_sema_decl_t* ofc_sema_scope_decl_find_modify(
 	}
 
 	ofc_sema_decl_t* decl
-		= ofc_sema_decl_list_find_modify(
-			scope->decl, name);
+		= ofc_sema_decl_list_find_symbol_modify(
+			scope->decl, symbol);
 	if (decl) return decl;
 
 	if (local)
 		return NULL;
 
-	return ofc_sema_scope_decl_find_modify(
-		scope->parent, name, false);
+	return ofc_sema_scope__decl_find_symbol_modify(
+		scope->parent, symbol, false);
+}
+
+const ofc_sema_decl_t* ofc_sema_scope_decl_find(
+	const ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
+{
+	if (!scope)
+		return NULL;
+
+	return ofc_sema_scope__decl_find_symbol(scope,
+		ofc_symbol_find(scope->symbols, name,
+			global_opts.case_sensitive), local);
+}
+
+ofc_sema_decl_t* ofc_sema_scope_decl_find_modify(
+	ofc_sema_scope_t* scope, ofc_str_ref_t name, bool local)
+{
+	if (!scope)
+		return NULL;
+
+	return ofc_sema_scope__decl_find_symbol_modify(scope,
+		ofc_symbol_find(scope->symbols, name,
+			global_opts.case_sensitive), local);
 }
 
 ofc_sema_decl_t* ofc_sema_scope_decl_find__create(
@@ -1234,9 +2240,12 @@ ofc_sema_decl_t* ofc_sema_scope_decl_find__create(
 	if (!scope)
 		return NULL;
 
+	ofc_symbol_t symbol = ofc_symbol_find(scope->symbols,
+		name.string, global_opts.case_sensitive);
+
 	ofc_sema_decl_t* decl
-		= ofc_sema_decl_list_find_modify(
-			scope->decl, name.string);
+		= ofc_sema_decl_list_find_symbol_modify(
+			scope->decl, symbol);
 	if (decl) return decl;
 
 	switch (scope->type)
@@ -1250,14 +2259,14 @@ ofc_sema_decl_t* ofc_sema_scope_decl_find__create(
 
 	if (!local)
 	{
-		decl = ofc_sema_scope_decl_find__create(
-			scope->parent, name, false, false, name_space);
+		decl = ofc_sema_scope__decl_find_symbol_modify(
+			scope->parent, symbol, false);
 		if (decl) return decl;
 	}
 
 	if (create)
 	{
-		decl = ofc_sema_decl_create(
+		decl = ofc_sema_decl_create(scope->symbols,
 			ofc_sema_scope_implicit(scope), name);
 		if (!decl) return NULL;
 		decl->is_static = scope->attr_save;
@@ -1838,6 +2847,7 @@ ofc_sema_scope_list_t* ofc_sema_scope_list_create(void)
 
 	list->scope = NULL;
 	list->count = 0;
+	list->size  = 0;
 
 	return list;
 }
@@ -1848,11 +2858,9 @@ bool ofc_sema_scope_list_add(
 {
 	if (!list || !scope) return false;
 
-	ofc_sema_scope_t** nscope
-		= (ofc_sema_scope_t**)realloc(list->scope,
-			(sizeof(ofc_sema_scope_t*) * (list->count + 1)));
-	if (!nscope) return false;
-	list->scope = nscope;
+	if (!ofc_sema_scope__vector_reserve(
+		&list->scope, list->count, &list->size, 1))
+		return false;
 
 	list->scope[list->count++] = scope;
 	return true;
@@ -0,0 +1,2551 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+typedef enum
+{
+	OFC_SEMA_SERIAL__HEADER_MAGIC = 0,
+	OFC_SEMA_SERIAL__HEADER_VERSION,
+	OFC_SEMA_SERIAL__HEADER_SIZE,
+	OFC_SEMA_SERIAL__HEADER_ROOT,
+	OFC_SEMA_SERIAL__HEADER_TYPE_COUNT,
+	OFC_SEMA_SERIAL__HEADER_TYPE_TABLE,
+	OFC_SEMA_SERIAL__HEADER_EXTERN_COUNT,
+	OFC_SEMA_SERIAL__HEADER_EXTERN_TABLE,
+	OFC_SEMA_SERIAL__HEADER_STRING_COUNT,
+	OFC_SEMA_SERIAL__HEADER_STRING_TABLE,
+
+	OFC_SEMA_SERIAL__HEADER_COUNT
+} ofc_sema_serial__header_e;
+
+#define OFC_SEMA_SERIAL__MAGIC "OFCS"
+
+/* Words before the attributes of a node. */
+#define OFC_SEMA_SERIAL__NODE_HEADER 6
+
+
+typedef struct
+{
+	const void* ptr;
+	uint32_t    value;
+} ofc_sema_serial__entry_t;
+
+typedef struct
+{
+	unsigned    word;
+	const void*       ptr;
+	ofc_sema_serial_e tag;
+} ofc_sema_serial__fixup_t;
+
+typedef struct
+{
+	ofc_str_ref_t ref;
+	uint32_t      id;
+	char          data[];
+} ofc_sema_serial__string_t;
+
+typedef struct
+{
+	uint32_t key;
+	uint32_t value;
+
+	/* Node references are resolved once everything is written. */
+	const void* ref;
+} ofc_sema_serial__attr_t;
+
+typedef struct
+{
+	uint32_t* word;
+	unsigned  count, size;
+
+	/* Maps objects which can be referenced to their node. */
+	ofc_hashmap_t* node;
+
+	ofc_hashmap_t*          type_map;
+	const ofc_sema_type_t** type;
+	unsigned                type_count, type_size;
+
+	ofc_sema_serial__fixup_t* fixup;
+	unsigned                  fixup_count, fixup_size;
+
+	ofc_hashmap_t*              string_map;
+	ofc_sema_serial__string_t** string;
+	unsigned                    string_count, string_size;
+
+	const ofc_sparse_t* src_sparse;
+	const ofc_file_t*   src_file;
+	uint32_t            src_file_id;
+
+	bool failed;
+} ofc_sema_serial__writer_t;
+
+OFC_VECTOR_DEFINE(ofc_sema_serial__word_vector, uint32_t)
+OFC_VECTOR_DEFINE(ofc_sema_serial__type_vector, const ofc_sema_type_t*)
+OFC_VECTOR_DEFINE(ofc_sema_serial__fixup_vector, ofc_sema_serial__fixup_t)
+OFC_VECTOR_DEFINE(ofc_sema_serial__string_vector, ofc_sema_serial__string_t*)
+
+
+static const void* ofc_sema_serial__entry_key(
+	const ofc_sema_serial__entry_t* entry)
+{
+	return (entry ? entry->ptr : NULL);
+}
+
+static bool ofc_sema_serial__ptr_equal(
+	const void* a, const void* b)
+{
+	return (a == b);
+}
+
+static const ofc_str_ref_t* ofc_sema_serial__string_key(
+	const ofc_sema_serial__string_t* string)
+{
+	return (string ? &string->ref : NULL);
+}
+
+static ofc_hashmap_t* ofc_sema_serial__ptr_map(void)
+{
+	return ofc_hashmap_create(
+		(void*)ofc_hashmap_hash_ptr,
+		(void*)ofc_sema_serial__ptr_equal,
+		(void*)ofc_sema_serial__entry_key,
+		(void*)free);
+}
+
+static bool ofc_sema_serial__ptr_map_add(
+	ofc_hashmap_t* map, const void* ptr, uint32_t value)
+{
+	ofc_sema_serial__entry_t* entry
+		= (ofc_sema_serial__entry_t*)malloc(
+			sizeof(ofc_sema_serial__entry_t));
+	if (!entry) return false;
+
+	entry->ptr   = ptr;
+	entry->value = value;
+
+	if (!ofc_hashmap_add(map, entry))
+	{
+		free(entry);
+		return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__ptr_map_find(
+	const ofc_hashmap_t* map, const void* ptr, uint32_t* value)
+{
+	const ofc_sema_serial__entry_t* entry
+		= ofc_hashmap_find(map, ptr);
+	if (!entry) return false;
+
+	if (value) *value = entry->value;
+	return true;
+}
+
+
+static bool ofc_sema_serial__reserve(
+	ofc_sema_serial__writer_t* writer, unsigned count)
+{
+	if (!ofc_sema_serial__word_vector_reserve(
+		&writer->word, writer->count, &writer->size, count))
+	{
+		writer->failed = true;
+		return false;
+	}
+	return true;
+}
+
+static uint32_t ofc_sema_serial__string(
+	ofc_sema_serial__writer_t* writer,
+	const char* data, unsigned len)
+{
+	if (!data) return OFC_SEMA_SERIAL_NONE;
+
+	ofc_str_ref_t ref = { .base = data, .size = len };
+	const ofc_sema_serial__string_t* string
+		= ofc_hashmap_find(writer->string_map, &ref);
+	if (string) return string->id;
+
+	if (!ofc_sema_serial__string_vector_reserve(
+		&writer->string, writer->string_count, &writer->string_size, 1))
+	{
+		writer->failed = true;
+		return OFC_SEMA_SERIAL_NONE;
+	}
+
+	ofc_sema_serial__string_t* add
+		= (ofc_sema_serial__string_t*)malloc(
+			sizeof(ofc_sema_serial__string_t) + len + 1);
+	if (!add)
+	{
+		writer->failed = true;
+		return OFC_SEMA_SERIAL_NONE;
+	}
+
+	memcpy(add->data, data, len);
+	add->data[len] = '\0';
+	add->ref = (ofc_str_ref_t){ .base = add->data, .size = len };
+	add->id  = writer->string_count;
+
+	if (!ofc_hashmap_add(writer->string_map, add))
+	{
+		free(add);
+		writer->failed = true;
+		return OFC_SEMA_SERIAL_NONE;
+	}
+
+	writer->string[writer->string_count++] = add;
+	return add->id;
+}
+
+static uint32_t ofc_sema_serial__string_ref(
+	ofc_sema_serial__writer_t* writer, ofc_str_ref_t ref)
+{
+	if (ofc_str_ref_empty(ref))
+		return OFC_SEMA_SERIAL_NONE;
+	return ofc_sema_serial__string(
+		writer, ref.base, ref.size);
+}
+
+static uint32_t ofc_sema_serial__type(
+	ofc_sema_serial__writer_t* writer,
+	const ofc_sema_type_t* type)
+{
+	if (!type) return OFC_SEMA_SERIAL_NONE;
+
+	uint32_t id;
+	if (ofc_sema_serial__ptr_map_find(
+		writer->type_map, type, &id))
+		return id;
+
+	if (!ofc_sema_serial__type_vector_reserve(
+		&writer->type, writer->type_count, &writer->type_size, 1))
+	{
+		writer->failed = true;
+		return OFC_SEMA_SERIAL_NONE;
+	}
+
+	id = writer->type_count;
+	if (!ofc_sema_serial__ptr_map_add(
+		writer->type_map, type, id))
+	{
+		writer->failed = true;
+		return OFC_SEMA_SERIAL_NONE;
+	}
+
+	writer->type[writer->type_count++] = type;
+	return id;
+}
+
+static void ofc_sema_serial__ref(
+	ofc_sema_serial__writer_t* writer,
+	unsigned word, const void* ptr, ofc_sema_serial_e tag)
+{
+	if (!ptr || (word == 0))
+		return;
+
+	if (!ofc_sema_serial__fixup_vector_reserve(
+		&writer->fixup, writer->fixup_count, &writer->fixup_size, 1))
+	{
+		writer->failed = true;
+		return;
+	}
+
+	ofc_sema_serial__fixup_t* fixup
+		= &writer->fixup[writer->fixup_count++];
+	fixup->word    = word;
+	fixup->ptr     = ptr;
+	fixup->tag     = tag;
+}
+
+static void ofc_sema_serial__src(
+	ofc_sema_serial__writer_t* writer, ofc_sparse_ref_t src,
+	uint32_t* file, uint32_t* offset, uint32_t* length)
+{
+	*file   = OFC_SEMA_SERIAL_NONE;
+	*offset = 0;
+	*length = 0;
+
+	if (ofc_sparse_ref_empty(src))
+		return;
+
+	if (src.sparse != writer->src_sparse)
+	{
+		writer->src_sparse  = src.sparse;
+		writer->src_file    = ofc_sparse_file(src.sparse);
+		writer->src_file_id = OFC_SEMA_SERIAL_NONE;
+
+		const char* path = ofc_file_get_path(writer->src_file);
+		if (path)
+		{
+			writer->src_file_id = ofc_sema_serial__string(
+				writer, path, strlen(path));
+		}
+	}
+
+	const char* strz = ofc_file_get_strz(writer->src_file);
+	unsigned    size = ofc_file_get_size(writer->src_file);
+
+	const char* first = ofc_sparse_file_pointer(
+		src.sparse, src.string.base);
+	const char* last = ofc_sparse_file_pointer(
+		src.sparse, &src.string.base[src.string.size - 1]);
+	if (!strz || !first || !last
+		|| (first < strz) || (last < first)
+		|| (last >= &strz[size]))
+		return;
+
+	*file   = writer->src_file_id;
+	*offset = (first - strz);
+	*length = ((last - first) + 1);
+}
+
+static ofc_sema_serial_e ofc_sema_serial__attr_tag(uint32_t key)
+{
+	switch (key)
+	{
+		case OFC_SEMA_SERIAL_ATTR_DECL:
+			return OFC_SEMA_SERIAL_DECL;
+		case OFC_SEMA_SERIAL_ATTR_SCOPE:
+			return OFC_SEMA_SERIAL_SCOPE;
+		case OFC_SEMA_SERIAL_ATTR_STMT:
+			return OFC_SEMA_SERIAL_STMT;
+		case OFC_SEMA_SERIAL_ATTR_STRUCTURE:
+			return OFC_SEMA_SERIAL_STRUCTURE;
+		default:
+			break;
+	}
+
+	return OFC_SEMA_SERIAL_COUNT;
+}
+
+/* Appends a node, the children are zero until linked. */
+static unsigned ofc_sema_serial__node(
+	ofc_sema_serial__writer_t* writer,
+	ofc_sema_serial_e tag, unsigned kind,
+	ofc_sparse_ref_t src, const void* ptr,
+	unsigned attr_count, const ofc_sema_serial__attr_t* attr,
+	unsigned child_count)
+{
+	unsigned words = OFC_SEMA_SERIAL__NODE_HEADER
+		+ (attr_count * 2) + child_count;
+	if (!ofc_sema_serial__reserve(writer, words))
+		return 0;
+
+	unsigned node = writer->count;
+	if (ptr && !ofc_sema_serial__ptr_map_add(
+		writer->node, ptr, (node * sizeof(uint32_t))))
+	{
+		writer->failed = true;
+		return 0;
+	}
+
+	uint32_t* word = &writer->word[node];
+	word[0] = tag | (kind << 16);
+	word[1] = attr_count;
+	word[2] = child_count;
+	ofc_sema_serial__src(writer, src,
+		&word[3], &word[4], &word[5]);
+	writer->count += words;
+
+	unsigned i;
+	for (i = 0; i < attr_count; i++)
+	{
+		unsigned a = node + OFC_SEMA_SERIAL__NODE_HEADER + (i * 2);
+		writer->word[a + 0] = attr[i].key;
+		writer->word[a + 1] = (attr[i].ref ? 0 : attr[i].value);
+		ofc_sema_serial__ref(writer, (a + 1), attr[i].ref,
+			ofc_sema_serial__attr_tag(attr[i].key));
+	}
+
+	unsigned c = node + OFC_SEMA_SERIAL__NODE_HEADER + (attr_count * 2);
+	for (i = 0; i < child_count; i++)
+		writer->word[c + i] = 0;
+
+	return node;
+}
+
+/* Returns the word holding a node's child. */
+static unsigned ofc_sema_serial__slot(
+	const ofc_sema_serial__writer_t* writer,
+	unsigned node, unsigned child)
+{
+	return node + OFC_SEMA_SERIAL__NODE_HEADER
+		+ (writer->word[node + 1] * 2) + child;
+}
+
+static void ofc_sema_serial__link(
+	ofc_sema_serial__writer_t* writer,
+	unsigned slot, unsigned node)
+{
+	if (slot != 0)
+		writer->word[slot] = (node * sizeof(uint32_t));
+}
+
+static ofc_sema_serial__attr_t ofc_sema_serial__attr(
+	uint32_t key, uint32_t value)
+{
+	return (ofc_sema_serial__attr_t){
+		.key = key, .value = value, .ref = NULL };
+}
+
+static ofc_sema_serial__attr_t ofc_sema_serial__attr_ref(
+	uint32_t key, const void* ref)
+{
+	return (ofc_sema_serial__attr_t){
+		.key = key, .value = 0, .ref = ref };
+}
+
+
+typedef bool (*ofc_sema_serial__write_f)(
+	ofc_sema_serial__writer_t* writer,
+	unsigned slot, const void* elem);
+
+static bool ofc_sema_serial__list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	ofc_sema_serial_e tag, unsigned count, const void* const* elem,
+	ofc_sema_serial__write_f func)
+{
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_LIST, tag,
+		OFC_SPARSE_REF_EMPTY, NULL, 0, NULL, count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		if (elem[i] && !func(writer,
+			ofc_sema_serial__slot(writer, node, i), elem[i]))
+			return false;
+	}
+
+	return true;
+}
+
+/* A list of references to nodes owned elsewhere. */
+static bool ofc_sema_serial__list_ref(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	ofc_sema_serial_e tag, unsigned count, const void* const* elem)
+{
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_LIST, tag,
+		OFC_SPARSE_REF_EMPTY, NULL, 0, NULL, count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
+		ofc_sema_serial__ref(writer,
+			ofc_sema_serial__slot(writer, node, i), elem[i], tag);
+	}
+
+	return true;
+}
+
+
+static bool ofc_sema_serial__expr(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_expr_t* expr);
+static bool ofc_sema_serial__lhs(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_lhs_t* lhs);
+static bool ofc_sema_serial__stmt(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_stmt_t* stmt);
+static bool ofc_sema_serial__decl(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_decl_t* decl);
+static bool ofc_sema_serial__scope(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_scope_t* scope);
+
+static bool ofc_sema_serial__expr_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_expr_list_t* list)
+{
+	if (!list) return true;
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_EXPR, list->count,
+		(const void* const*)list->expr,
+		(void*)ofc_sema_serial__expr);
+}
+
+static bool ofc_sema_serial__lhs_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_lhs_list_t* list)
+{
+	if (!list) return true;
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_LHS, list->count,
+		(const void* const*)list->lhs,
+		(void*)ofc_sema_serial__lhs);
+}
+
+static bool ofc_sema_serial__stmt_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_stmt_list_t* list)
+{
+	if (!list) return true;
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_STMT, list->count,
+		(const void* const*)list->stmt,
+		(void*)ofc_sema_serial__stmt);
+}
+
+
+static bool ofc_sema_serial__array(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_array_t* array)
+{
+	if (!array) return true;
+
+	ofc_sema_serial__attr_t attr
+		= ofc_sema_serial__attr(OFC_SEMA_SERIAL_ATTR_FLAGS, array->scan);
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_ARRAY, 0,
+		OFC_SPARSE_REF_EMPTY, NULL, 1, &attr,
+		(array->dimensions * 2));
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < array->dimensions; i++)
+	{
+		if (!ofc_sema_serial__expr(writer,
+				ofc_sema_serial__slot(writer, node, ((i * 2) + 0)),
+				array->segment[i].first)
+			|| !ofc_sema_serial__expr(writer,
+				ofc_sema_serial__slot(writer, node, ((i * 2) + 1)),
+				array->segment[i].last))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__array_index(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_array_index_t* index)
+{
+	if (!index) return true;
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_ARRAY_INDEX, 0,
+		OFC_SPARSE_REF_EMPTY, NULL, 0, NULL,
+		index->dimensions);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < index->dimensions; i++)
+	{
+		if (!ofc_sema_serial__expr(writer,
+			ofc_sema_serial__slot(writer, node, i),
+			index->index[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__array_slice(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_array_slice_t* slice)
+{
+	if (!slice) return true;
+
+	uint32_t is_index = 0;
+	unsigned i;
+	for (i = 0; i < slice->dimensions; i++)
+	{
+		if (slice->segment[i].is_index)
+			is_index |= (1U << i);
+	}
+
+	ofc_sema_serial__attr_t attr
+		= ofc_sema_serial__attr(OFC_SEMA_SERIAL_ATTR_FLAGS, is_index);
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_ARRAY_SLICE, 0,
+		OFC_SPARSE_REF_EMPTY, NULL, 1, &attr,
+		(slice->dimensions * 3));
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	for (i = 0; i < slice->dimensions; i++)
+	{
+		const ofc_sema_array_segment_t* segment
+			= &slice->segment[i];
+		if (!ofc_sema_serial__expr(writer,
+				ofc_sema_serial__slot(writer, node, ((i * 3) + 0)),
+				segment->first)
+			|| !ofc_sema_serial__expr(writer,
+				ofc_sema_serial__slot(writer, node, ((i * 3) + 1)),
+				segment->last)
+			|| !ofc_sema_serial__expr(writer,
+				ofc_sema_serial__slot(writer, node, ((i * 3) + 2)),
+				segment->stride))
+			return false;
+	}
+
+	return true;
+}
+
+
+/* Appends the attributes describing a constant's value. */
+static unsigned ofc_sema_serial__typeval(
+	ofc_sema_serial__writer_t* writer,
+	const ofc_sema_typeval_t* typeval,
+	ofc_sema_serial__attr_t* attr)
+{
+	if (!typeval || !typeval->type)
+		return 0;
+
+	char real[64];
+	switch (typeval->type->type)
+	{
+		case OFC_SEMA_TYPE_LOGICAL:
+			attr[0] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_VALUE, typeval->logical);
+			return 1;
+
+		case OFC_SEMA_TYPE_INTEGER:
+		case OFC_SEMA_TYPE_BYTE:
+			attr[0] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_VALUE,
+				(uint32_t)((uint64_t)typeval->integer));
+			attr[1] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_VALUE_HIGH,
+				(uint32_t)((uint64_t)typeval->integer >> 32));
+			return 2;
+
+		case OFC_SEMA_TYPE_REAL:
+			snprintf(real, sizeof(real), "%La", typeval->real);
+			attr[0] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_STRING,
+				ofc_sema_serial__string(writer, real, strlen(real)));
+			return 1;
+
+		case OFC_SEMA_TYPE_COMPLEX:
+			snprintf(real, sizeof(real), "%La", typeval->complex.real);
+			attr[0] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_STRING,
+				ofc_sema_serial__string(writer, real, strlen(real)));
+			snprintf(real, sizeof(real), "%La", typeval->complex.imaginary);
+			attr[1] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_IMAGINARY,
+				ofc_sema_serial__string(writer, real, strlen(real)));
+			return 2;
+
+		case OFC_SEMA_TYPE_CHARACTER:
+		{
+			unsigned size;
+			if (!typeval->character
+				|| !ofc_sema_type_size(typeval->type, &size))
+				return 0;
+			attr[0] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_STRING,
+				ofc_sema_serial__string(writer,
+					typeval->character, size));
+			return 1;
+		}
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+static bool ofc_sema_serial__dummy_arg(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_dummy_arg_t* dummy_arg)
+{
+	ofc_sema_serial__attr_t attr[2];
+	unsigned attr_count = 0;
+	unsigned child_count = 0;
+
+	if (dummy_arg->type == OFC_SEMA_DUMMY_ARG_EXTERNAL)
+	{
+		if (dummy_arg->external)
+		{
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_NAME,
+				ofc_sema_serial__string_ref(writer,
+					dummy_arg->external->name.string));
+			if (dummy_arg->external->decl)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr_ref(
+					OFC_SEMA_SERIAL_ATTR_DECL,
+					dummy_arg->external->decl);
+			}
+		}
+	}
+	else
+	{
+		child_count = 1;
+	}
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_DUMMY_ARG, dummy_arg->type,
+		dummy_arg->src, NULL, attr_count, attr, child_count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	return ((child_count == 0)
+		|| ofc_sema_serial__expr(writer,
+			ofc_sema_serial__slot(writer, node, 0),
+			dummy_arg->expr));
+}
+
+static bool ofc_sema_serial__dummy_arg_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_dummy_arg_list_t* list)
+{
+	if (!list) return true;
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_DUMMY_ARG, list->count,
+		(const void* const*)list->dummy_arg,
+		(void*)ofc_sema_serial__dummy_arg);
+}
+
+static bool ofc_sema_serial__expr(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_expr_t* expr)
+{
+	if (!expr) return true;
+
+	ofc_sema_serial__attr_t attr[10];
+	unsigned attr_count = 0;
+
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_TYPE,
+		ofc_sema_serial__type(writer,
+			ofc_sema_expr_type(expr)));
+
+	bool count_var = ((expr->type == OFC_SEMA_EXPR_IMPLICIT_DO)
+		&& expr->implicit_do.count_var);
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_FLAGS,
+		(expr->brackets << 0)
+		| (expr->is_alt_return << 1)
+		| (expr->is_label << 2)
+		| (expr->is_format << 3)
+		| (count_var << 4));
+
+	if (expr->repeat > 0)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_REPEAT, expr->repeat);
+	}
+
+	if (expr->label)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_LABEL, expr->label->number);
+	}
+
+	attr_count += ofc_sema_serial__typeval(
+		writer, expr->constant, &attr[attr_count]);
+
+	unsigned child_count;
+	switch (expr->type)
+	{
+		case OFC_SEMA_EXPR_CONSTANT:
+			child_count = 0;
+			break;
+
+		case OFC_SEMA_EXPR_LHS:
+		case OFC_SEMA_EXPR_CAST:
+		case OFC_SEMA_EXPR_ARRAY:
+		case OFC_SEMA_EXPR_NEGATE:
+		case OFC_SEMA_EXPR_NOT:
+			child_count = 1;
+			break;
+
+		case OFC_SEMA_EXPR_INTRINSIC:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_INTRINSIC,
+				ofc_sema_serial__string_ref(writer,
+					ofc_sema_intrinsic_name(expr->intrinsic)));
+			child_count = 1;
+			break;
+
+		case OFC_SEMA_EXPR_FUNCTION:
+			if (expr->function)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr_ref(
+					OFC_SEMA_SERIAL_ATTR_DECL, expr->function);
+			}
+			child_count = 1;
+			break;
+
+		case OFC_SEMA_EXPR_IMPLICIT_DO:
+			if (expr->implicit_do.iter)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr_ref(
+					OFC_SEMA_SERIAL_ATTR_DECL, expr->implicit_do.iter);
+			}
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_ITERATIONS,
+				expr->implicit_do.count);
+			child_count = 4;
+			break;
+
+		case OFC_SEMA_EXPR_RESHAPE:
+			child_count = 2;
+			break;
+
+		default:
+			child_count = 2;
+			break;
+	}
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_EXPR, expr->type,
+		expr->src, NULL, attr_count, attr, child_count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned c[4];
+	unsigned i;
+	for (i = 0; i < child_count; i++)
+		c[i] = ofc_sema_serial__slot(writer, node, i);
+
+	switch (expr->type)
+	{
+		case OFC_SEMA_EXPR_CONSTANT:
+			return true;
+
+		case OFC_SEMA_EXPR_LHS:
+			return ofc_sema_serial__lhs(writer, c[0], expr->lhs);
+
+		case OFC_SEMA_EXPR_CAST:
+			return ofc_sema_serial__expr(writer, c[0], expr->cast.expr);
+
+		case OFC_SEMA_EXPR_INTRINSIC:
+		case OFC_SEMA_EXPR_FUNCTION:
+			return ofc_sema_serial__dummy_arg_list(
+				writer, c[0], expr->args);
+
+		case OFC_SEMA_EXPR_IMPLICIT_DO:
+			return ofc_sema_serial__expr_list(
+					writer, c[0], expr->implicit_do.expr)
+				&& ofc_sema_serial__expr(
+					writer, c[1], expr->implicit_do.init)
+				&& ofc_sema_serial__expr(
+					writer, c[2], expr->implicit_do.last)
+				&& ofc_sema_serial__expr(
+					writer, c[3], expr->implicit_do.step);
+
+		case OFC_SEMA_EXPR_ARRAY:
+			return ofc_sema_serial__expr_list(
+				writer, c[0], expr->array);
+
+		case OFC_SEMA_EXPR_RESHAPE:
+			return ofc_sema_serial__expr_list(
+					writer, c[0], expr->reshape.source)
+				&& ofc_sema_serial__array(
+					writer, c[1], expr->reshape.shape);
+
+		case OFC_SEMA_EXPR_NEGATE:
+		case OFC_SEMA_EXPR_NOT:
+			return ofc_sema_serial__expr(writer, c[0], expr->a);
+
+		default:
+			break;
+	}
+
+	return ofc_sema_serial__expr(writer, c[0], expr->a)
+		&& ofc_sema_serial__expr(writer, c[1], expr->b);
+}
+
+static bool ofc_sema_serial__lhs(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_lhs_t* lhs)
+{
+	if (!lhs) return true;
+
+	ofc_sema_serial__attr_t attr[4];
+	unsigned attr_count = 0;
+
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_TYPE,
+		ofc_sema_serial__type(writer,
+			ofc_sema_lhs_type(lhs)));
+
+	unsigned child_count = 0;
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_DECL:
+			if (lhs->decl)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr_ref(
+					OFC_SEMA_SERIAL_ATTR_DECL, lhs->decl);
+			}
+			break;
+
+		case OFC_SEMA_LHS_ARRAY_INDEX:
+			child_count = 2;
+			break;
+
+		case OFC_SEMA_LHS_ARRAY_SLICE:
+		case OFC_SEMA_LHS_SUBSTRING:
+			child_count = 3;
+			break;
+
+		case OFC_SEMA_LHS_STRUCTURE_MEMBER:
+			if (lhs->member)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr_ref(
+					OFC_SEMA_SERIAL_ATTR_DECL, lhs->member);
+			}
+			child_count = 1;
+			break;
+
+		case OFC_SEMA_LHS_IMPLICIT_DO:
+			if (lhs->implicit_do.iter)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr_ref(
+					OFC_SEMA_SERIAL_ATTR_DECL, lhs->implicit_do.iter);
+			}
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_FLAGS,
+				lhs->implicit_do.count_var);
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_ITERATIONS,
+				lhs->implicit_do.count);
+			child_count = 4;
+			break;
+
+		default:
+			return false;
+	}
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_LHS, lhs->type,
+		lhs->src, NULL, attr_count, attr, child_count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned c[4];
+	unsigned i;
+	for (i = 0; i < child_count; i++)
+		c[i] = ofc_sema_serial__slot(writer, node, i);
+
+	switch (lhs->type)
+	{
+		case OFC_SEMA_LHS_ARRAY_INDEX:
+			return ofc_sema_serial__lhs(writer, c[0], lhs->parent)
+				&& ofc_sema_serial__array_index(writer, c[1], lhs->index);
+
+		case OFC_SEMA_LHS_ARRAY_SLICE:
+			return ofc_sema_serial__lhs(writer, c[0], lhs->parent)
+				&& ofc_sema_serial__array_slice(writer, c[1], lhs->slice.slice)
+				&& ofc_sema_serial__array(writer, c[2], lhs->slice.dims);
+
+		case OFC_SEMA_LHS_SUBSTRING:
+			return ofc_sema_serial__lhs(writer, c[0], lhs->parent)
+				&& ofc_sema_serial__expr(writer, c[1], lhs->substring.first)
+				&& ofc_sema_serial__expr(writer, c[2], lhs->substring.last);
+
+		case OFC_SEMA_LHS_STRUCTURE_MEMBER:
+			return ofc_sema_serial__lhs(writer, c[0], lhs->parent);
+
+		case OFC_SEMA_LHS_IMPLICIT_DO:
+			return ofc_sema_serial__lhs_list(
+					writer, c[0], lhs->implicit_do.lhs)
+				&& ofc_sema_serial__expr(
+					writer, c[1], lhs->implicit_do.init)
+				&& ofc_sema_serial__expr(
+					writer, c[2], lhs->implicit_do.last)
+				&& ofc_sema_serial__expr(
+					writer, c[3], lhs->implicit_do.step);
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
+
+static bool ofc_sema_serial__arg(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_arg_t* arg)
+{
+	ofc_sema_serial__attr_t attr[2];
+	attr[0] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_NAME,
+		ofc_sema_serial__string_ref(writer, arg->name.string));
+	attr[1] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_FLAGS, arg->alt_return);
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_ARG, 0,
+		arg->name, NULL, 2, attr, 0);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+	return true;
+}
+
+static bool ofc_sema_serial__arg_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_arg_list_t* list)
+{
+	if (!list) return true;
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_LIST, OFC_SEMA_SERIAL_ARG,
+		OFC_SPARSE_REF_EMPTY, NULL, 0, NULL, list->count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < list->count; i++)
+	{
+		if (!ofc_sema_serial__arg(writer,
+			ofc_sema_serial__slot(writer, node, i),
+			&list->arg[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__range(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_range_t* range)
+{
+	ofc_sema_serial__attr_t attr
+		= ofc_sema_serial__attr(OFC_SEMA_SERIAL_ATTR_FLAGS, range->is_range);
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_RANGE, 0,
+		range->src, NULL, 1, &attr, 2);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	return ofc_sema_serial__expr(writer,
+			ofc_sema_serial__slot(writer, node, 0), range->first)
+		&& ofc_sema_serial__expr(writer,
+			ofc_sema_serial__slot(writer, node, 1), range->last);
+}
+
+static bool ofc_sema_serial__range_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_range_list_t* list)
+{
+	if (!list) return true;
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_RANGE, list->count,
+		(const void* const*)list->range,
+		(void*)ofc_sema_serial__range);
+}
+
+static bool ofc_sema_serial__format_desc(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_parse_format_desc_t* desc)
+{
+	ofc_sema_serial__attr_t attr[5];
+	unsigned attr_count = 0;
+
+	uint32_t flags = (desc->neg << 0) | (desc->n_set << 1);
+	if (desc->n_set)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_REPEAT, desc->n);
+	}
+
+	unsigned child_count = 0;
+	switch (desc->type)
+	{
+		case OFC_PARSE_FORMAT_DESC_HOLLERITH:
+		case OFC_PARSE_FORMAT_DESC_STRING:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_STRING,
+				(desc->string ? ofc_sema_serial__string(writer,
+					ofc_string_strz(desc->string),
+					ofc_string_length(desc->string))
+				: OFC_SEMA_SERIAL_NONE));
+			break;
+
+		case OFC_PARSE_FORMAT_DESC_REPEAT:
+			child_count = (desc->repeat ? desc->repeat->count : 0);
+			break;
+
+		default:
+			flags |= (desc->w_set << 2)
+				| (desc->d_set << 3)
+				| (desc->e_set << 4);
+			if (desc->w_set)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr(
+					OFC_SEMA_SERIAL_ATTR_WIDTH, desc->w);
+			}
+			if (desc->d_set)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr(
+					OFC_SEMA_SERIAL_ATTR_DIGITS, desc->d);
+			}
+			if (desc->e_set)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr(
+					OFC_SEMA_SERIAL_ATTR_EXPONENT, desc->e);
+			}
+			break;
+	}
+
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_FLAGS, flags);
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_FORMAT, desc->type,
+		desc->src, NULL, attr_count, attr, child_count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < child_count; i++)
+	{
+		if (desc->repeat->desc[i]
+			&& !ofc_sema_serial__format_desc(writer,
+				ofc_sema_serial__slot(writer, node, i),
+				desc->repeat->desc[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__format_desc_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_parse_format_desc_list_t* list)
+{
+	if (!list) return true;
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_FORMAT, list->count,
+		(const void* const*)list->desc,
+		(void*)ofc_sema_serial__format_desc);
+}
+
+
+typedef enum
+{
+	OFC_SEMA_SERIAL__CHILD_EXPR,
+	OFC_SEMA_SERIAL__CHILD_EXPR_LIST,
+	OFC_SEMA_SERIAL__CHILD_LHS,
+	OFC_SEMA_SERIAL__CHILD_LHS_LIST,
+	OFC_SEMA_SERIAL__CHILD_STMT,
+	OFC_SEMA_SERIAL__CHILD_STMT_LIST,
+	OFC_SEMA_SERIAL__CHILD_RANGE_LIST,
+	OFC_SEMA_SERIAL__CHILD_DUMMY_ARG_LIST,
+	OFC_SEMA_SERIAL__CHILD_ARG_LIST,
+	OFC_SEMA_SERIAL__CHILD_FORMAT_LIST,
+} ofc_sema_serial__child_e;
+
+typedef struct
+{
+	ofc_sema_serial__child_e type;
+	const void*              ptr;
+} ofc_sema_serial__child_t;
+
+#define OFC_SEMA_SERIAL__CHILD(t, p) \
+	(ofc_sema_serial__child_t){ \
+		.type = OFC_SEMA_SERIAL__CHILD_##t, .ptr = (p) }
+
+static bool ofc_sema_serial__child(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	ofc_sema_serial__child_t child)
+{
+	switch (child.type)
+	{
+		case OFC_SEMA_SERIAL__CHILD_EXPR:
+			return ofc_sema_serial__expr(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_EXPR_LIST:
+			return ofc_sema_serial__expr_list(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_LHS:
+			return ofc_sema_serial__lhs(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_LHS_LIST:
+			return ofc_sema_serial__lhs_list(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_STMT:
+			return ofc_sema_serial__stmt(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_STMT_LIST:
+			return ofc_sema_serial__stmt_list(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_RANGE_LIST:
+			return ofc_sema_serial__range_list(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_DUMMY_ARG_LIST:
+			return ofc_sema_serial__dummy_arg_list(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_ARG_LIST:
+			return ofc_sema_serial__arg_list(writer, slot, child.ptr);
+		case OFC_SEMA_SERIAL__CHILD_FORMAT_LIST:
+			return ofc_sema_serial__format_desc_list(writer, slot, child.ptr);
+		default:
+			break;
+	}
+
+	return false;
+}
+
+static bool ofc_sema_serial__stmt(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_stmt_t* stmt)
+{
+	if (!stmt) return true;
+
+	ofc_sema_serial__attr_t attr[2] = { { 0 } };
+	unsigned attr_count = 0;
+
+	ofc_sema_serial__child_t  cbuff[26];
+	ofc_sema_serial__child_t* child = cbuff;
+	unsigned child_count = 0;
+
+	#define CHILD(t, p) cbuff[child_count++] = OFC_SEMA_SERIAL__CHILD(t, p)
+
+	switch (stmt->type)
+	{
+		case OFC_SEMA_STMT_ASSIGNMENT:
+			CHILD(LHS,  stmt->assignment.dest);
+			CHILD(EXPR, stmt->assignment.expr);
+			break;
+
+		case OFC_SEMA_STMT_ASSIGN:
+			if (stmt->assign.dest)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr_ref(
+					OFC_SEMA_SERIAL_ATTR_DECL, stmt->assign.dest);
+			}
+			CHILD(EXPR, stmt->assign.label);
+			break;
+
+		case OFC_SEMA_STMT_IO_FORMAT:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_FLAGS,
+				stmt->io_format.is_default_possible);
+			CHILD(FORMAT_LIST, (stmt->io_format.format
+				? stmt->io_format.format : stmt->io_format.src));
+			break;
+
+		case OFC_SEMA_STMT_IO_WRITE:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_FLAGS,
+				(stmt->io_write.stdout << 0)
+				| (stmt->io_write.format_ldio << 1)
+				| (stmt->io_write.formatted << 2));
+			CHILD(EXPR, stmt->io_write.unit);
+			CHILD(EXPR, stmt->io_write.format);
+			CHILD(EXPR, stmt->io_write.iostat);
+			CHILD(EXPR, stmt->io_write.rec);
+			CHILD(EXPR, stmt->io_write.err);
+			CHILD(EXPR, stmt->io_write.advance);
+			CHILD(EXPR_LIST, stmt->io_write.iolist);
+			break;
+
+		case OFC_SEMA_STMT_IO_READ:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_FLAGS,
+				(stmt->io_read.stdin << 0)
+				| (stmt->io_read.format_ldio << 1)
+				| (stmt->io_read.formatted << 2));
+			CHILD(EXPR, stmt->io_read.unit);
+			CHILD(EXPR, stmt->io_read.format);
+			CHILD(EXPR, stmt->io_read.iostat);
+			CHILD(EXPR, stmt->io_read.rec);
+			CHILD(EXPR, stmt->io_read.err);
+			CHILD(EXPR, stmt->io_read.advance);
+			CHILD(EXPR, stmt->io_read.end);
+			CHILD(EXPR, stmt->io_read.eor);
+			CHILD(EXPR, stmt->io_read.size);
+			CHILD(LHS_LIST, stmt->io_read.iolist);
+			break;
+
+		case OFC_SEMA_STMT_IO_PRINT:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_FLAGS,
+				stmt->io_print.format_asterisk);
+			CHILD(EXPR, stmt->io_print.format);
+			CHILD(EXPR_LIST, stmt->io_print.iolist);
+			break;
+
+		case OFC_SEMA_STMT_IO_REWIND:
+		case OFC_SEMA_STMT_IO_END_FILE:
+		case OFC_SEMA_STMT_IO_BACKSPACE:
+			CHILD(EXPR, stmt->io_position.unit);
+			CHILD(EXPR, stmt->io_position.iostat);
+			CHILD(EXPR, stmt->io_position.err);
+			break;
+
+		case OFC_SEMA_STMT_IO_OPEN:
+			CHILD(EXPR, stmt->io_open.unit);
+			CHILD(EXPR, stmt->io_open.iostat);
+			CHILD(EXPR, stmt->io_open.err);
+			CHILD(EXPR, stmt->io_open.recl);
+			CHILD(EXPR, stmt->io_open.access);
+			CHILD(EXPR, stmt->io_open.action);
+			CHILD(EXPR, stmt->io_open.blank);
+			CHILD(EXPR, stmt->io_open.delim);
+			CHILD(EXPR, stmt->io_open.file);
+			CHILD(EXPR, stmt->io_open.form);
+			CHILD(EXPR, stmt->io_open.pad);
+			CHILD(EXPR, stmt->io_open.position);
+			CHILD(EXPR, stmt->io_open.status);
+			break;
+
+		case OFC_SEMA_STMT_IO_CLOSE:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_VALUE,
+				stmt->io_close.status_type);
+			CHILD(EXPR, stmt->io_close.unit);
+			CHILD(EXPR, stmt->io_close.iostat);
+			CHILD(EXPR, stmt->io_close.err);
+			CHILD(EXPR, stmt->io_close.status);
+			break;
+
+		case OFC_SEMA_STMT_IO_INQUIRE:
+			CHILD(EXPR, stmt->io_inquire.unit);
+			CHILD(EXPR, stmt->io_inquire.file);
+			CHILD(EXPR, stmt->io_inquire.err);
+			CHILD(LHS, stmt->io_inquire.access);
+			CHILD(LHS, stmt->io_inquire.action);
+			CHILD(LHS, stmt->io_inquire.blank);
+			CHILD(LHS, stmt->io_inquire.delim);
+			CHILD(LHS, stmt->io_inquire.direct);
+			CHILD(LHS, stmt->io_inquire.exist);
+			CHILD(LHS, stmt->io_inquire.form);
+			CHILD(LHS, stmt->io_inquire.formatted);
+			CHILD(LHS, stmt->io_inquire.iostat);
+			CHILD(LHS, stmt->io_inquire.name);
+			CHILD(LHS, stmt->io_inquire.named);
+			CHILD(LHS, stmt->io_inquire.nextrec);
+			CHILD(LHS, stmt->io_inquire.number);
+			CHILD(LHS, stmt->io_inquire.opened);
+			CHILD(LHS, stmt->io_inquire.pad);
+			CHILD(LHS, stmt->io_inquire.position);
+			CHILD(LHS, stmt->io_inquire.read);
+			CHILD(LHS, stmt->io_inquire.readwrite);
+			CHILD(LHS, stmt->io_inquire.recl);
+			CHILD(LHS, stmt->io_inquire.sequential);
+			CHILD(LHS, stmt->io_inquire.unformatted);
+			CHILD(LHS, stmt->io_inquire.write);
+			break;
+
+		case OFC_SEMA_STMT_CONTINUE:
+		case OFC_SEMA_STMT_CONTAINS:
+		case OFC_SEMA_STMT_CYCLE:
+		case OFC_SEMA_STMT_EXIT:
+			break;
+
+		case OFC_SEMA_STMT_IF_COMPUTED:
+			CHILD(EXPR, stmt->if_comp.cond);
+			CHILD(EXPR_LIST, stmt->if_comp.label);
+			break;
+
+		case OFC_SEMA_STMT_IF_STATEMENT:
+			CHILD(EXPR, stmt->if_stmt.cond);
+			CHILD(STMT, stmt->if_stmt.stmt);
+			break;
+
+		case OFC_SEMA_STMT_IF_THEN:
+			CHILD(EXPR, stmt->if_then.cond);
+			CHILD(STMT_LIST, stmt->if_then.block_then);
+			CHILD(STMT_LIST, stmt->if_then.block_else);
+			break;
+
+		case OFC_SEMA_STMT_SELECT_CASE:
+		{
+			unsigned count = 1 + (stmt->select_case.count * 2);
+			if (count > 26)
+			{
+				child = (ofc_sema_serial__child_t*)malloc(
+					sizeof(ofc_sema_serial__child_t) * count);
+				if (!child) return false;
+			}
+
+			child[child_count++] = OFC_SEMA_SERIAL__CHILD(
+				EXPR, stmt->select_case.case_expr);
+
+			unsigned i;
+			for (i = 0; i < stmt->select_case.count; i++)
+			{
+				child[child_count++] = OFC_SEMA_SERIAL__CHILD(
+					RANGE_LIST, stmt->select_case.case_value[i]);
+				child[child_count++] = OFC_SEMA_SERIAL__CHILD(
+					STMT_LIST, stmt->select_case.case_block[i]);
+			}
+			break;
+		}
+
+		case OFC_SEMA_STMT_STOP:
+		case OFC_SEMA_STMT_PAUSE:
+			CHILD(EXPR, stmt->stop_pause.str);
+			break;
+
+		case OFC_SEMA_STMT_GO_TO:
+			CHILD(EXPR, stmt->go_to.label);
+			CHILD(EXPR_LIST, stmt->go_to.allow);
+			break;
+
+		case OFC_SEMA_STMT_GO_TO_COMPUTED:
+			CHILD(EXPR, stmt->go_to_comp.cond);
+			CHILD(EXPR_LIST, stmt->go_to_comp.label);
+			break;
+
+		case OFC_SEMA_STMT_DO_LABEL:
+			CHILD(EXPR, stmt->do_label.end_label);
+			CHILD(LHS,  stmt->do_label.iter);
+			CHILD(EXPR, stmt->do_label.init);
+			CHILD(EXPR, stmt->do_label.last);
+			CHILD(EXPR, stmt->do_label.step);
+			break;
+
+		case OFC_SEMA_STMT_DO_BLOCK:
+			CHILD(LHS,  stmt->do_block.iter);
+			CHILD(EXPR, stmt->do_block.init);
+			CHILD(EXPR, stmt->do_block.last);
+			CHILD(EXPR, stmt->do_block.step);
+			CHILD(STMT_LIST, stmt->do_block.block);
+			break;
+
+		case OFC_SEMA_STMT_DO_WHILE:
+			CHILD(EXPR, stmt->do_while.end_label);
+			CHILD(EXPR, stmt->do_while.cond);
+			break;
+
+		case OFC_SEMA_STMT_DO_WHILE_BLOCK:
+			CHILD(EXPR, stmt->do_while_block.cond);
+			CHILD(STMT_LIST, stmt->do_while_block.block);
+			break;
+
+		case OFC_SEMA_STMT_CALL:
+			if (stmt->call.subroutine)
+			{
+				attr[attr_count++] = ofc_sema_serial__attr_ref(
+					OFC_SEMA_SERIAL_ATTR_DECL, stmt->call.subroutine);
+			}
+			CHILD(DUMMY_ARG_LIST, stmt->call.args);
+			break;
+
+		case OFC_SEMA_STMT_RETURN:
+			CHILD(EXPR, stmt->alt_return);
+			break;
+
+		case OFC_SEMA_STMT_ENTRY:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_NAME,
+				ofc_sema_serial__string_ref(writer, stmt->entry.name));
+			CHILD(ARG_LIST, stmt->entry.args);
+			break;
+
+		default:
+			return false;
+	}
+
+	#undef CHILD
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_STMT, stmt->type,
+		stmt->src, stmt, attr_count, attr, child_count);
+	bool success = (node != 0);
+	if (success)
+		ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; success && (i < child_count); i++)
+	{
+		success = ofc_sema_serial__child(writer,
+			ofc_sema_serial__slot(writer, node, i), child[i]);
+	}
+
+	if (child != cbuff)
+		free(child);
+	return success;
+}
+
+
+static bool ofc_sema_serial__init_substring(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_type_t* type, unsigned offset,
+	const char* string, const bool* mask)
+{
+	unsigned size;
+	if (!type || !ofc_sema_type_size(type, &size))
+		return false;
+
+	char* bmask = (char*)malloc(type->len + 1);
+	if (!bmask) return false;
+
+	unsigned i;
+	for (i = 0; i < type->len; i++)
+		bmask[i] = (mask[i] ? 1 : 0);
+
+	ofc_sema_serial__attr_t attr[3];
+	attr[0] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_NUMBER, offset);
+	attr[1] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_STRING,
+		ofc_sema_serial__string(writer, string, size));
+	attr[2] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_MASK,
+		ofc_sema_serial__string(writer, bmask, type->len));
+	free(bmask);
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_INIT, OFC_SEMA_SERIAL_INIT_SUBSTRING,
+		OFC_SPARSE_REF_EMPTY, NULL, 3, attr, 0);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+	return true;
+}
+
+static bool ofc_sema_serial__init(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_decl_t* decl)
+{
+	if (!ofc_sema_decl_is_composite(decl))
+	{
+		if (decl->init.is_substring)
+		{
+			return ofc_sema_serial__init_substring(
+				writer, slot, decl->type, 0,
+				decl->init.substring.string,
+				decl->init.substring.mask);
+		}
+
+		if (!decl->init.expr)
+			return true;
+
+		unsigned node = ofc_sema_serial__node(
+			writer, OFC_SEMA_SERIAL_INIT, OFC_SEMA_SERIAL_INIT_SCALAR,
+			OFC_SPARSE_REF_EMPTY, NULL, 0, NULL, 1);
+		if (node == 0) return false;
+		ofc_sema_serial__link(writer, slot, node);
+
+		return ofc_sema_serial__expr(writer,
+			ofc_sema_serial__slot(writer, node, 0),
+			decl->init.expr);
+	}
+
+	const ofc_sema_decl_init_array_t* array = decl->init_array;
+	if (!array) return true;
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_INIT, OFC_SEMA_SERIAL_INIT_ARRAY,
+		OFC_SPARSE_REF_EMPTY, NULL, 0, NULL,
+		(array->run_count + array->substring_count));
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < array->run_count; i++)
+	{
+		ofc_sema_serial__attr_t attr[2];
+		attr[0] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_NUMBER, array->run[i].first);
+		attr[1] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_LEN, array->run[i].count);
+
+		unsigned run = ofc_sema_serial__node(
+			writer, OFC_SEMA_SERIAL_INIT, OFC_SEMA_SERIAL_INIT_RUN,
+			OFC_SPARSE_REF_EMPTY, NULL, 2, attr, 1);
+		if (run == 0) return false;
+		ofc_sema_serial__link(writer,
+			ofc_sema_serial__slot(writer, node, i), run);
+
+		if (!ofc_sema_serial__expr(writer,
+			ofc_sema_serial__slot(writer, run, 0),
+			array->run[i].expr))
+			return false;
+	}
+
+	for (i = 0; i < array->substring_count; i++)
+	{
+		if (!ofc_sema_serial__init_substring(writer,
+			ofc_sema_serial__slot(writer, node, (array->run_count + i)),
+			decl->type, array->substring[i].offset,
+			array->substring[i].string, array->substring[i].mask))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__decl(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_decl_t* decl)
+{
+	if (!decl) return true;
+
+	/* Declarations may be listed more than once, e.g. as
+	   structure members which are shared. */
+	uint32_t offset;
+	if (ofc_sema_serial__ptr_map_find(
+		writer->node, decl, &offset))
+	{
+		if (slot != 0)
+			writer->word[slot] = offset;
+		return true;
+	}
+
+	ofc_sema_serial__attr_t attr[7];
+	unsigned attr_count = 0;
+
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_NAME,
+		ofc_sema_serial__string_ref(writer, decl->name.string));
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_TYPE,
+		ofc_sema_serial__type(writer, decl->type));
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_ACCESS, decl->access);
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_FLAGS,
+		(decl->type_final       <<  0)
+		| (decl->type_implicit    <<  1)
+		| (decl->is_static        <<  2)
+		| (decl->is_automatic     <<  3)
+		| (decl->is_volatile      <<  4)
+		| (decl->is_intrinsic     <<  5)
+		| (decl->is_external      <<  6)
+		| (decl->is_parameter     <<  7)
+		| (decl->is_target        <<  8)
+		| (decl->is_equiv         <<  9)
+		| (decl->is_argument      << 10)
+		| (decl->is_return        << 11)
+		| (decl->was_read         << 12)
+		| (decl->was_written      << 13)
+		| (decl->is_stmt_func_arg << 14));
+
+	if (decl->structure)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr_ref(
+			OFC_SEMA_SERIAL_ATTR_STRUCTURE, decl->structure);
+	}
+
+	if (decl->intrinsic)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_INTRINSIC,
+			ofc_sema_serial__string_ref(writer,
+				ofc_sema_intrinsic_name(decl->intrinsic)));
+	}
+
+	/* A procedure's scope is owned by its declaration,
+	   it isn't listed as a child of the enclosing scope. */
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_DECL, 0,
+		decl->name, decl, attr_count, attr, 3);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	return ofc_sema_serial__array(writer,
+			ofc_sema_serial__slot(writer, node, 0), decl->array)
+		&& ofc_sema_serial__init(writer,
+			ofc_sema_serial__slot(writer, node, 1), decl)
+		&& ofc_sema_serial__scope(writer,
+			ofc_sema_serial__slot(writer, node, 2), decl->func);
+}
+
+/* Removing from a declaration, structure or label list leaves
+   an empty slot, which is written as a zero offset. */
+static bool ofc_sema_serial__decl_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_decl_list_t* list)
+{
+	if (!list) return true;
+
+	if (list->is_ref)
+	{
+		return ofc_sema_serial__list_ref(writer, slot,
+			OFC_SEMA_SERIAL_DECL, list->count,
+			(const void* const*)list->decl_ref);
+	}
+
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_DECL, list->count,
+		(const void* const*)list->decl,
+		(void*)ofc_sema_serial__decl);
+}
+
+
+static bool ofc_sema_serial__implicit(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_implicit_t* implicit)
+{
+	if (!implicit) return true;
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_IMPLICIT, 0,
+		OFC_SPARSE_REF_EMPTY, NULL, 0, NULL, 26);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < 26; i++)
+	{
+		char letter = ('A' + i);
+		const ofc_sema_type_t* type = NULL;
+		bool is_static = false, is_automatic = false;
+		bool is_volatile = false, is_intrinsic = false;
+		bool is_external = false;
+		if (!ofc_sema_implicit_rule(implicit, letter, &type,
+			&is_static, &is_automatic, &is_volatile,
+			&is_intrinsic, &is_external))
+			return false;
+
+		ofc_sema_serial__attr_t attr[2];
+		attr[0] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_TYPE,
+			ofc_sema_serial__type(writer, type));
+		attr[1] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_FLAGS,
+			(is_static << 0) | (is_automatic << 1)
+			| (is_volatile << 2) | (is_intrinsic << 3)
+			| (is_external << 4));
+
+		unsigned rule = ofc_sema_serial__node(
+			writer, OFC_SEMA_SERIAL_RULE, i,
+			OFC_SPARSE_REF_EMPTY, NULL, 2, attr, 0);
+		if (rule == 0) return false;
+		ofc_sema_serial__link(writer,
+			ofc_sema_serial__slot(writer, node, i), rule);
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__structure(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_structure_t* structure)
+{
+	if (!structure) return true;
+
+	uint32_t offset;
+	if (ofc_sema_serial__ptr_map_find(
+		writer->node, structure, &offset))
+	{
+		if (slot != 0)
+			writer->word[slot] = offset;
+		return true;
+	}
+
+	ofc_sema_serial__attr_t attr
+		= ofc_sema_serial__attr(OFC_SEMA_SERIAL_ATTR_NAME,
+			ofc_sema_serial__string_ref(writer, structure->name.string));
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_STRUCTURE, structure->type,
+		structure->name, structure, 1, &attr,
+		(1 + structure->count));
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	if (!ofc_sema_serial__implicit(writer,
+		ofc_sema_serial__slot(writer, node, 0),
+		structure->implicit))
+		return false;
+
+	unsigned i;
+	for (i = 0; i < structure->count; i++)
+	{
+		const ofc_sema_structure_member_t* member
+			= structure->member[i];
+		if (!member) continue;
+
+		unsigned mslot = ofc_sema_serial__slot(writer, node, (1 + i));
+		if (member->is_structure
+			? !ofc_sema_serial__structure(writer, mslot, member->structure)
+			: !ofc_sema_serial__decl(writer, mslot, member->decl))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__structure_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_structure_list_t* list)
+{
+	if (!list) return true;
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_STRUCTURE, list->count,
+		(const void* const*)list->structure,
+		(void*)ofc_sema_serial__structure);
+}
+
+
+static bool ofc_sema_serial__label(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_label_t* label)
+{
+	ofc_sema_serial__attr_t attr[3];
+	unsigned attr_count = 0;
+
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_NUMBER, label->number);
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_FLAGS, label->used);
+
+	if (label->type == OFC_SEMA_LABEL_END_SCOPE)
+	{
+		if (label->scope)
+		{
+			attr[attr_count++] = ofc_sema_serial__attr_ref(
+				OFC_SEMA_SERIAL_ATTR_SCOPE, label->scope);
+		}
+	}
+	else if (label->stmt)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr_ref(
+			OFC_SEMA_SERIAL_ATTR_STMT, label->stmt);
+	}
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_LABEL, label->type,
+		ofc_sema_label_src(label), NULL, attr_count, attr, 0);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+	return true;
+}
+
+static bool ofc_sema_serial__common(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_common_t* common)
+{
+	ofc_sema_serial__attr_t attr[2];
+	attr[0] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_NAME,
+		ofc_sema_serial__string_ref(writer, common->name));
+	attr[1] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_FLAGS, common->save);
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_COMMON, 0,
+		OFC_SPARSE_REF_EMPTY, NULL, 2, attr, common->count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < common->count; i++)
+	{
+		ofc_sema_serial__ref(writer,
+			ofc_sema_serial__slot(writer, node, i),
+			common->decl[i], OFC_SEMA_SERIAL_DECL);
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__equiv(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_equiv_t* equiv)
+{
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_EQUIV, 0,
+		OFC_SPARSE_REF_EMPTY, NULL, 0, NULL, equiv->count);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned i;
+	for (i = 0; i < equiv->count; i++)
+	{
+		if (!ofc_sema_serial__lhs(writer,
+			ofc_sema_serial__slot(writer, node, i),
+			equiv->lhs[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ofc_sema_serial__external(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_external_t* external)
+{
+	ofc_sema_serial__attr_t attr[2];
+	unsigned attr_count = 0;
+
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_NAME,
+		ofc_sema_serial__string_ref(writer, external->name.string));
+	if (external->decl)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr_ref(
+			OFC_SEMA_SERIAL_ATTR_DECL, external->decl);
+	}
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_EXTERNAL, 0,
+		external->name, NULL, attr_count, attr, 0);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+	return true;
+}
+
+static bool ofc_sema_serial__alias(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_decl_alias_t* alias)
+{
+	ofc_sema_serial__attr_t attr[2];
+	unsigned attr_count = 0;
+
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_NAME,
+		ofc_sema_serial__string_ref(writer, alias->name));
+	if (alias->decl)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr_ref(
+			OFC_SEMA_SERIAL_ATTR_DECL, alias->decl);
+	}
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_ALIAS, 0,
+		OFC_SPARSE_REF_EMPTY, NULL, attr_count, attr, 0);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+	return true;
+}
+
+static bool ofc_sema_serial__module(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_module_t* module)
+{
+	ofc_sema_serial__attr_t attr[2];
+	unsigned attr_count = 0;
+
+	if (module->scope)
+	{
+		attr[attr_count++] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_NAME,
+			ofc_sema_serial__string_ref(writer, module->scope->name));
+		attr[attr_count++] = ofc_sema_serial__attr_ref(
+			OFC_SEMA_SERIAL_ATTR_SCOPE, module->scope);
+	}
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_MODULE, 0,
+		OFC_SPARSE_REF_EMPTY, NULL, attr_count, attr, 2);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	if (module->rename && !ofc_sema_serial__list(writer,
+		ofc_sema_serial__slot(writer, node, 0),
+		OFC_SEMA_SERIAL_ALIAS, module->rename->count,
+		(const void* const*)module->rename->list,
+		(void*)ofc_sema_serial__alias))
+		return false;
+
+	return ofc_sema_serial__decl_list(writer,
+		ofc_sema_serial__slot(writer, node, 1),
+		module->only);
+}
+
+
+static bool ofc_sema_serial__scope_list(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_scope_list_t* list)
+{
+	if (!list) return true;
+	return ofc_sema_serial__list(writer, slot,
+		OFC_SEMA_SERIAL_SCOPE, list->count,
+		(const void* const*)list->scope,
+		(void*)ofc_sema_serial__scope);
+}
+
+static bool ofc_sema_serial__scope(
+	ofc_sema_serial__writer_t* writer, unsigned slot,
+	const ofc_sema_scope_t* scope)
+{
+	if (!scope) return true;
+
+	ofc_sema_serial__attr_t attr[3];
+	unsigned attr_count = 0;
+
+	if (!ofc_str_ref_empty(scope->name))
+	{
+		attr[attr_count++] = ofc_sema_serial__attr(
+			OFC_SEMA_SERIAL_ATTR_NAME,
+			ofc_sema_serial__string_ref(writer, scope->name));
+	}
+
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_ACCESS, scope->access);
+	attr[attr_count++] = ofc_sema_serial__attr(
+		OFC_SEMA_SERIAL_ATTR_FLAGS,
+		(scope->attr_external << 0)
+		| (scope->attr_intrinsic << 1)
+		| (scope->attr_save << 2)
+		| (scope->attr_recursive << 3)
+		| (scope->contains_automatic << 4));
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_SCOPE, scope->type,
+		scope->src, scope, attr_count, attr, 13);
+	if (node == 0) return false;
+	ofc_sema_serial__link(writer, slot, node);
+
+	unsigned c[13];
+	unsigned i;
+	for (i = 0; i < 13; i++)
+		c[i] = ofc_sema_serial__slot(writer, node, i);
+
+	if (!ofc_sema_serial__arg_list(writer, c[0], scope->args)
+		|| !ofc_sema_serial__implicit(writer, c[1], scope->implicit))
+		return false;
+
+	if (scope->common && !ofc_sema_serial__list(writer, c[2],
+		OFC_SEMA_SERIAL_COMMON, scope->common->count,
+		(const void* const*)scope->common->common,
+		(void*)ofc_sema_serial__common))
+		return false;
+
+	if (!ofc_sema_serial__decl_list(writer, c[3], scope->decl))
+		return false;
+
+	if (scope->equiv && !ofc_sema_serial__list(writer, c[4],
+		OFC_SEMA_SERIAL_EQUIV, scope->equiv->count,
+		(const void* const*)scope->equiv->equiv,
+		(void*)ofc_sema_serial__equiv))
+		return false;
+
+	if (scope->module && !ofc_sema_serial__list(writer, c[5],
+		OFC_SEMA_SERIAL_MODULE, scope->module->count,
+		(const void* const*)scope->module->module,
+		(void*)ofc_sema_serial__module))
+		return false;
+
+	if (scope->label && !ofc_sema_serial__list(writer, c[6],
+		OFC_SEMA_SERIAL_LABEL, scope->label->count,
+		(const void* const*)scope->label->label,
+		(void*)ofc_sema_serial__label))
+		return false;
+
+	if (scope->external && !ofc_sema_serial__list(writer, c[7],
+		OFC_SEMA_SERIAL_EXTERNAL, scope->external->count,
+		(const void* const*)scope->external->external,
+		(void*)ofc_sema_serial__external))
+		return false;
+
+	return ofc_sema_serial__structure_list(writer, c[8], scope->structure)
+		&& ofc_sema_serial__structure_list(writer, c[9], scope->derived_type)
+		&& ofc_sema_serial__stmt_list(writer, c[10], scope->stmt)
+		&& ofc_sema_serial__expr(writer, c[11], scope->expr)
+		&& ofc_sema_serial__scope_list(writer, c[12], scope->child);
+}
+
+
+static bool ofc_sema_serial__type_node(
+	ofc_sema_serial__writer_t* writer,
+	const ofc_sema_type_t* type, uint32_t* offset)
+{
+	ofc_sema_serial__attr_t attr[3];
+	unsigned attr_count = 0;
+
+	switch (type->type)
+	{
+		case OFC_SEMA_TYPE_POINTER:
+		case OFC_SEMA_TYPE_FUNCTION:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_TYPE,
+				ofc_sema_serial__type(writer, type->subtype));
+			break;
+
+		default:
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_KIND, type->kind);
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_LEN, type->len);
+			attr[attr_count++] = ofc_sema_serial__attr(
+				OFC_SEMA_SERIAL_ATTR_FLAGS, type->len_var);
+			break;
+	}
+
+	unsigned node = ofc_sema_serial__node(
+		writer, OFC_SEMA_SERIAL_TYPE, type->type,
+		OFC_SPARSE_REF_EMPTY, NULL, attr_count, attr, 0);
+	if (node == 0) return false;
+
+	*offset = (node * sizeof(uint32_t));
+	return true;
+}
+
+static void ofc_sema_serial__writer_cleanup(
+	ofc_sema_serial__writer_t* writer)
+{
+	ofc_hashmap_delete(writer->node);
+	ofc_hashmap_delete(writer->type_map);
+	ofc_hashmap_delete(writer->string_map);
+
+	free(writer->type);
+	free(writer->fixup);
+	free(writer->string);
+}
+
+void* ofc_sema_serial_write(
+	const ofc_sema_scope_t* scope, size_t* size)
+{
+	if (!scope) return NULL;
+
+	ofc_sema_serial__writer_t writer;
+	writer.word  = NULL;
+	writer.count = 0;
+	writer.size  = 0;
+
+	writer.node       = ofc_sema_serial__ptr_map();
+	writer.type_map   = ofc_sema_serial__ptr_map();
+	writer.type       = NULL;
+	writer.type_count = 0;
+	writer.type_size  = 0;
+
+	writer.fixup       = NULL;
+	writer.fixup_count = 0;
+	writer.fixup_size  = 0;
+
+	/* The strings own their data, so the map frees them. */
+	writer.string_map = ofc_hashmap_create(
+		(void*)ofc_str_ref_ptr_hash,
+		(void*)ofc_str_ref_ptr_equal,
+		(void*)ofc_sema_serial__string_key,
+		(void*)free);
+	writer.string       = NULL;
+	writer.string_count = 0;
+	writer.string_size  = 0;
+
+	writer.src_sparse  = NULL;
+	writer.src_file    = NULL;
+	writer.src_file_id = OFC_SEMA_SERIAL_NONE;
+
+	writer.failed = false;
+
+	uint32_t* extern_table = NULL;
+	unsigned  extern_count = 0;
+	unsigned  extern_size  = 0;
+
+	if (!writer.node || !writer.type_map || !writer.string_map
+		|| !ofc_sema_serial__reserve(&writer, OFC_SEMA_SERIAL__HEADER_COUNT))
+		goto fail;
+	writer.count = OFC_SEMA_SERIAL__HEADER_COUNT;
+
+	if (!ofc_sema_serial__scope(&writer,
+		OFC_SEMA_SERIAL__HEADER_ROOT, scope))
+		goto fail;
+
+	/* Declarations and structures which are referenced but not owned
+	   by the tree are written after it, these may reference more. */
+	unsigned i;
+	for (i = 0; i < writer.fixup_count; i++)
+	{
+		ofc_sema_serial__fixup_t fixup = writer.fixup[i];
+		if (((fixup.tag != OFC_SEMA_SERIAL_DECL)
+				&& (fixup.tag != OFC_SEMA_SERIAL_STRUCTURE))
+			|| ofc_sema_serial__ptr_map_find(
+				writer.node, fixup.ptr, NULL))
+			continue;
+
+		unsigned start = writer.count;
+		if ((fixup.tag == OFC_SEMA_SERIAL_DECL)
+			? !ofc_sema_serial__decl(&writer, 0, fixup.ptr)
+			: !ofc_sema_serial__structure(&writer, 0, fixup.ptr))
+			goto fail;
+
+		if (!ofc_sema_serial__word_vector_reserve(
+			&extern_table, extern_count, &extern_size, 1))
+			goto fail;
+		extern_table[extern_count++] = (start * sizeof(uint32_t));
+	}
+
+	/* Writing a type may add its subtype. */
+	uint32_t* type_table = NULL;
+	unsigned  type_size  = 0;
+	for (i = 0; i < writer.type_count; i++)
+	{
+		if (!ofc_sema_serial__word_vector_reserve(
+			&type_table, i, &type_size, 1))
+		{
+			free(type_table);
+			goto fail;
+		}
+
+		if (!ofc_sema_serial__type_node(
+			&writer, writer.type[i], &type_table[i]))
+		{
+			free(type_table);
+			goto fail;
+		}
+	}
+
+	for (i = 0; i < writer.fixup_count; i++)
+	{
+		uint32_t offset = 0;
+		ofc_sema_serial__ptr_map_find(
+			writer.node, writer.fixup[i].ptr, &offset);
+		writer.word[writer.fixup[i].word] = offset;
+	}
+
+	unsigned tables = writer.type_count + extern_count
+		+ (writer.string_count * 2);
+	if (!ofc_sema_serial__reserve(&writer, tables))
+	{
+		free(type_table);
+		goto fail;
+	}
+
+	writer.word[OFC_SEMA_SERIAL__HEADER_TYPE_COUNT] = writer.type_count;
+	writer.word[OFC_SEMA_SERIAL__HEADER_TYPE_TABLE]
+		= (writer.count * sizeof(uint32_t));
+	if (writer.type_count > 0)
+		memcpy(&writer.word[writer.count], type_table,
+			(writer.type_count * sizeof(uint32_t)));
+	writer.count += writer.type_count;
+	free(type_table);
+
+	writer.word[OFC_SEMA_SERIAL__HEADER_EXTERN_COUNT] = extern_count;
+	writer.word[OFC_SEMA_SERIAL__HEADER_EXTERN_TABLE]
+		= (writer.count * sizeof(uint32_t));
+	if (extern_count > 0)
+		memcpy(&writer.word[writer.count], extern_table,
+			(extern_count * sizeof(uint32_t)));
+	writer.count += extern_count;
+
+	writer.word[OFC_SEMA_SERIAL__HEADER_STRING_COUNT] = writer.string_count;
+	writer.word[OFC_SEMA_SERIAL__HEADER_STRING_TABLE]
+		= (writer.count * sizeof(uint32_t));
+	unsigned string_table = writer.count;
+	writer.count += (writer.string_count * 2);
+
+	size_t data = (writer.count * sizeof(uint32_t));
+	for (i = 0; i < writer.string_count; i++)
+	{
+		writer.word[string_table + (i * 2) + 0] = data;
+		writer.word[string_table + (i * 2) + 1] = writer.string[i]->ref.size;
+		data += writer.string[i]->ref.size + 1;
+	}
+
+	unsigned words = ((data + (sizeof(uint32_t) - 1)) / sizeof(uint32_t));
+	if (!ofc_sema_serial__reserve(&writer, (words - writer.count)))
+		goto fail;
+
+	/* Zero the padding. */
+	writer.word[words - 1] = 0;
+
+	char* base = (char*)&writer.word[writer.count];
+	for (i = 0; i < writer.string_count; i++)
+	{
+		unsigned len = writer.string[i]->ref.size + 1;
+		memcpy(base, writer.string[i]->data, len);
+		base += len;
+	}
+	writer.count = words;
+
+	if (writer.failed)
+		goto fail;
+
+	memcpy(&writer.word[OFC_SEMA_SERIAL__HEADER_MAGIC],
+		OFC_SEMA_SERIAL__MAGIC, sizeof(uint32_t));
+	writer.word[OFC_SEMA_SERIAL__HEADER_VERSION] = OFC_SEMA_SERIAL_VERSION;
+	writer.word[OFC_SEMA_SERIAL__HEADER_SIZE]
+		= (writer.count * sizeof(uint32_t));
+
+	free(extern_table);
+	ofc_sema_serial__writer_cleanup(&writer);
+
+	if (size) *size = (writer.count * sizeof(uint32_t));
+	return writer.word;
+
+fail:
+	free(extern_table);
+	ofc_sema_serial__writer_cleanup(&writer);
+	free(writer.word);
+	return NULL;
+}
+
+bool ofc_sema_serial_write_file(
+	const ofc_sema_scope_t* scope, const char* path)
+{
+	if (!path) return false;
+
+	size_t size;
+	void* data = ofc_sema_serial_write(scope, &size);
+	if (!data) return false;
+
+	FILE* fp = fopen(path, "wb");
+	if (!fp)
+	{
+		free(data);
+		return false;
+	}
+
+	bool success = (fwrite(data, 1, size, fp) == size);
+	free(data);
+
+	if (fclose(fp) != 0)
+		success = false;
+	return success;
+}
+
+
+
+struct ofc_sema_serial_s
+{
+	const uint32_t* word;
+	size_t          count;
+
+	void*  map;
+	size_t map_size;
+};
+
+/* Returns a pointer to a table of count * stride words, if it's in bounds. */
+static const uint32_t* ofc_sema_serial__table(
+	const ofc_sema_serial_t* serial,
+	uint32_t offset, uint32_t count, unsigned stride)
+{
+	if ((offset % sizeof(uint32_t)) != 0)
+		return NULL;
+
+	uint64_t first = (offset / sizeof(uint32_t));
+	uint64_t last  = first + ((uint64_t)count * stride);
+	if ((first < OFC_SEMA_SERIAL__HEADER_COUNT)
+		|| (last > serial->count))
+		return NULL;
+
+	return &serial->word[first];
+}
+
+ofc_sema_serial_t* ofc_sema_serial_create(
+	const void* data, size_t size)
+{
+	if (!data || (((uintptr_t)data % sizeof(uint32_t)) != 0)
+		|| ((size % sizeof(uint32_t)) != 0)
+		|| (size < (OFC_SEMA_SERIAL__HEADER_COUNT * sizeof(uint32_t))))
+		return NULL;
+
+	const uint32_t* word = (const uint32_t*)data;
+	if ((memcmp(&word[OFC_SEMA_SERIAL__HEADER_MAGIC],
+			OFC_SEMA_SERIAL__MAGIC, sizeof(uint32_t)) != 0)
+		|| (word[OFC_SEMA_SERIAL__HEADER_VERSION] != OFC_SEMA_SERIAL_VERSION)
+		|| (word[OFC_SEMA_SERIAL__HEADER_SIZE] != size))
+		return NULL;
+
+	ofc_sema_serial_t* serial
+		= (ofc_sema_serial_t*)malloc(
+			sizeof(ofc_sema_serial_t));
+	if (!serial) return NULL;
+
+	serial->word     = word;
+	serial->count    = (size / sizeof(uint32_t));
+	serial->map      = NULL;
+	serial->map_size = 0;
+
+	if (!ofc_sema_serial__table(serial,
+			word[OFC_SEMA_SERIAL__HEADER_TYPE_TABLE],
+			word[OFC_SEMA_SERIAL__HEADER_TYPE_COUNT], 1)
+		|| !ofc_sema_serial__table(serial,
+			word[OFC_SEMA_SERIAL__HEADER_EXTERN_TABLE],
+			word[OFC_SEMA_SERIAL__HEADER_EXTERN_COUNT], 1)
+		|| !ofc_sema_serial__table(serial,
+			word[OFC_SEMA_SERIAL__HEADER_STRING_TABLE],
+			word[OFC_SEMA_SERIAL__HEADER_STRING_COUNT], 2))
+	{
+		free(serial);
+		return NULL;
+	}
+
+	return serial;
+}
+
+ofc_sema_serial_t* ofc_sema_serial_map(const char* path)
+{
+	if (!path) return NULL;
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return NULL;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size <= 0))
+	{
+		close(fd);
+		return NULL;
+	}
+
+	size_t size = st.st_size;
+	void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	ofc_sema_serial_t* serial
+		= ofc_sema_serial_create(map, size);
+	if (!serial)
+	{
+		munmap(map, size);
+		return NULL;
+	}
+
+	serial->map      = map;
+	serial->map_size = size;
+	return serial;
+}
+
+void ofc_sema_serial_delete(ofc_sema_serial_t* serial)
+{
+	if (!serial)
+		return;
+
+	if (serial->map)
+		munmap(serial->map, serial->map_size);
+	free(serial);
+}
+
+
+uint32_t ofc_sema_serial_root(
+	const ofc_sema_serial_t* serial)
+{
+	if (!serial) return 0;
+	return serial->word[OFC_SEMA_SERIAL__HEADER_ROOT];
+}
+
+unsigned ofc_sema_serial_type_count(
+	const ofc_sema_serial_t* serial)
+{
+	if (!serial) return 0;
+	return serial->word[OFC_SEMA_SERIAL__HEADER_TYPE_COUNT];
+}
+
+uint32_t ofc_sema_serial_type(
+	const ofc_sema_serial_t* serial, uint32_t id)
+{
+	if (!serial
+		|| (id >= serial->word[OFC_SEMA_SERIAL__HEADER_TYPE_COUNT]))
+		return 0;
+
+	const uint32_t* table = &serial->word[
+		serial->word[OFC_SEMA_SERIAL__HEADER_TYPE_TABLE]
+			/ sizeof(uint32_t)];
+	return table[id];
+}
+
+unsigned ofc_sema_serial_extern_count(
+	const ofc_sema_serial_t* serial)
+{
+	if (!serial) return 0;
+	return serial->word[OFC_SEMA_SERIAL__HEADER_EXTERN_COUNT];
+}
+
+uint32_t ofc_sema_serial_extern(
+	const ofc_sema_serial_t* serial, unsigned index)
+{
+	if (!serial
+		|| (index >= serial->word[OFC_SEMA_SERIAL__HEADER_EXTERN_COUNT]))
+		return 0;
+
+	const uint32_t* table = &serial->word[
+		serial->word[OFC_SEMA_SERIAL__HEADER_EXTERN_TABLE]
+			/ sizeof(uint32_t)];
+	return table[index];
+}
+
+unsigned ofc_sema_serial_string_count(
+	const ofc_sema_serial_t* serial)
+{
+	if (!serial) return 0;
+	return serial->word[OFC_SEMA_SERIAL__HEADER_STRING_COUNT];
+}
+
+const char* ofc_sema_serial_string(
+	const ofc_sema_serial_t* serial, uint32_t id, unsigned* len)
+{
+	if (!serial
+		|| (id >= serial->word[OFC_SEMA_SERIAL__HEADER_STRING_COUNT]))
+		return NULL;
+
+	const uint32_t* table = &serial->word[
+		serial->word[OFC_SEMA_SERIAL__HEADER_STRING_TABLE]
+			/ sizeof(uint32_t)];
+
+	uint64_t offset = table[(id * 2) + 0];
+	uint64_t length = table[(id * 2) + 1];
+	uint64_t size   = (serial->count * sizeof(uint32_t));
+	if ((offset + length) >= size)
+		return NULL;
+
+	const char* base = (const char*)serial->word;
+	if (base[offset + length] != '\0')
+		return NULL;
+
+	if (len) *len = length;
+	return &base[offset];
+}
+
+bool ofc_sema_serial_node(
+	const ofc_sema_serial_t* serial, uint32_t offset,
+	ofc_sema_serial_node_t* node)
+{
+	if (!serial || !node)
+		return false;
+
+	const uint32_t* word = ofc_sema_serial__table(
+		serial, offset, OFC_SEMA_SERIAL__NODE_HEADER, 1);
+	if (!word) return false;
+
+	uint32_t attr_count  = word[1];
+	uint32_t child_count = word[2];
+
+	uint64_t size = OFC_SEMA_SERIAL__NODE_HEADER
+		+ ((uint64_t)attr_count * 2) + child_count;
+	if (size > (serial->count - (offset / sizeof(uint32_t))))
+		return false;
+
+	node->tag    = (word[0] & 0xFFFF);
+	node->kind   = (word[0] >> 16);
+	node->file   = word[3];
+	node->offset = word[4];
+	node->length = word[5];
+
+	node->attr_count  = attr_count;
+	node->attr        = &word[OFC_SEMA_SERIAL__NODE_HEADER];
+	node->child_count = child_count;
+	node->child       = &node->attr[attr_count * 2];
+	return true;
+}
+
+bool ofc_sema_serial_node_attr(
+	const ofc_sema_serial_node_t* node,
+	ofc_sema_serial_attr_e key, uint32_t* value)
+{
+	if (!node) return false;
+
+	unsigned i;
+	for (i = 0; i < node->attr_count; i++)
+	{
+		if (node->attr[i * 2] == key)
+		{
+			if (value) *value = node->attr[(i * 2) + 1];
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -14,6 +14,11 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_stmt__vector, ofc_sema_stmt_t*)
+
 
 bool ofc_sema_stmt_assignment_print(ofc_colstr_t* cs,
 	const ofc_sema_stmt_t* stmt);
@@ -428,6 +433,7 @@ void ofc_sema_stmt_delete(
 				}
 				free(stmt->select_case.case_value);
 				free(stmt->select_case.case_block);
+				free(stmt->select_case.interval);
 			}
 			break;
 		case OFC_SEMA_STMT_STOP:
@@ -511,6 +517,7 @@ ofc_sema_stmt_list_t* ofc_sema_stmt_list_create(void)
 	if (!list) return NULL;
 
 	list->count = 0;
+	list->size  = 0;
 	list->stmt  = NULL;
 	return list;
 }
@@ -844,11 +851,9 @@ bool ofc_sema_stmt_list_add(
 	if (!list || !stmt)
 		return false;
 
-	ofc_sema_stmt_t** nstmt
-		= (ofc_sema_stmt_t**)realloc(list->stmt,
-			(sizeof(ofc_sema_stmt_t*) * (list->count + 1)));
-	if (!nstmt) return NULL;
-	list->stmt = nstmt;
+	if (!ofc_sema_stmt__vector_reserve(
+		&list->stmt, list->count, &list->size, 1))
+		return false;
 
 	list->stmt[list->count++] = stmt;
 
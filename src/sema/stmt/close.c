@@ -15,6 +15,35 @@
 
 #include "ofc/sema.h"
 
+typedef enum
+{
+	OFC_SEMA_STMT_IO_CLOSE__ERR = 0,
+	OFC_SEMA_STMT_IO_CLOSE__IOSTAT,
+	OFC_SEMA_STMT_IO_CLOSE__STATUS,
+	OFC_SEMA_STMT_IO_CLOSE__UNIT,
+
+	OFC_SEMA_STMT_IO_CLOSE__COUNT
+} ofc_sema_stmt_io_close__spec_e;
+
+/* Sorted by name for ofc_sema_io_spec_resolve. */
+static const char* const ofc_sema_stmt_io_close__spec[] =
+{
+	[OFC_SEMA_STMT_IO_CLOSE__ERR]    = "ERR",
+	[OFC_SEMA_STMT_IO_CLOSE__IOSTAT] = "IOSTAT",
+	[OFC_SEMA_STMT_IO_CLOSE__STATUS] = "STATUS",
+	[OFC_SEMA_STMT_IO_CLOSE__UNIT]   = "UNIT",
+};
+
+static const unsigned ofc_sema_stmt_io_close__positional[] =
+{
+	OFC_SEMA_STMT_IO_CLOSE__UNIT,
+};
+
+#define OFC_SEMA_STMT_IO_CLOSE__POSITIONAL_COUNT \
+	(sizeof(ofc_sema_stmt_io_close__positional) \
+		/ sizeof(ofc_sema_stmt_io_close__positional[0]))
+
+
 void ofc_sema_stmt_io_close__cleanup(
 	ofc_sema_stmt_t s)
 {
@@ -40,84 +69,19 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_close(
 	s.io_close.err    = NULL;
 	s.io_close.status = NULL;
 
-	ofc_parse_call_arg_t* ca_unit   = NULL;
-	ofc_parse_call_arg_t* ca_iostat = NULL;
-	ofc_parse_call_arg_t* ca_err    = NULL;
-	ofc_parse_call_arg_t* ca_status = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
-
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 1)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in CLOSE.", i);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in CLOSE.");
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in CLOSE.");
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in CLOSE.");
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "STATUS"))
-		{
-			if (ca_status)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of STATUS in CLOSE.");
-				return NULL;
-			}
+	ofc_parse_call_arg_t* ca[OFC_SEMA_STMT_IO_CLOSE__COUNT];
+	if (!ofc_sema_io_spec_resolve(
+		stmt->io.params, "CLOSE",
+		ofc_sema_stmt_io_close__spec,
+		OFC_SEMA_STMT_IO_CLOSE__COUNT,
+		ofc_sema_stmt_io_close__positional,
+		OFC_SEMA_STMT_IO_CLOSE__POSITIONAL_COUNT, ca))
+		return NULL;
 
-			ca_status = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in CLOSE.",
-				i, param->name.string.size, param->name.string.base);
-			return NULL;
-		}
-	}
+	ofc_parse_call_arg_t* ca_unit   = ca[OFC_SEMA_STMT_IO_CLOSE__UNIT];
+	ofc_parse_call_arg_t* ca_iostat = ca[OFC_SEMA_STMT_IO_CLOSE__IOSTAT];
+	ofc_parse_call_arg_t* ca_err    = ca[OFC_SEMA_STMT_IO_CLOSE__ERR];
+	ofc_parse_call_arg_t* ca_status = ca[OFC_SEMA_STMT_IO_CLOSE__STATUS];
 
 	if (!ca_unit)
 	{
@@ -15,6 +15,107 @@
 
 #include "ofc/sema.h"
 
+typedef enum
+{
+	OFC_SEMA_STMT_IO_INQUIRE__ACCESS = 0,
+	OFC_SEMA_STMT_IO_INQUIRE__ACTION,
+	OFC_SEMA_STMT_IO_INQUIRE__BLANK,
+	OFC_SEMA_STMT_IO_INQUIRE__DELIM,
+	OFC_SEMA_STMT_IO_INQUIRE__DIRECT,
+	OFC_SEMA_STMT_IO_INQUIRE__ERR,
+	OFC_SEMA_STMT_IO_INQUIRE__EXIST,
+	OFC_SEMA_STMT_IO_INQUIRE__FILE,
+	OFC_SEMA_STMT_IO_INQUIRE__FORM,
+	OFC_SEMA_STMT_IO_INQUIRE__FORMATTED,
+	OFC_SEMA_STMT_IO_INQUIRE__IOSTAT,
+	OFC_SEMA_STMT_IO_INQUIRE__NAME,
+	OFC_SEMA_STMT_IO_INQUIRE__NAMED,
+	OFC_SEMA_STMT_IO_INQUIRE__NEXTREC,
+	OFC_SEMA_STMT_IO_INQUIRE__NUMBER,
+	OFC_SEMA_STMT_IO_INQUIRE__OPENED,
+	OFC_SEMA_STMT_IO_INQUIRE__PAD,
+	OFC_SEMA_STMT_IO_INQUIRE__POSITION,
+	OFC_SEMA_STMT_IO_INQUIRE__READ,
+	OFC_SEMA_STMT_IO_INQUIRE__READWRITE,
+	OFC_SEMA_STMT_IO_INQUIRE__RECL,
+	OFC_SEMA_STMT_IO_INQUIRE__SEQUENTIAL,
+	OFC_SEMA_STMT_IO_INQUIRE__UNFORMATTED,
+	OFC_SEMA_STMT_IO_INQUIRE__UNIT,
+	OFC_SEMA_STMT_IO_INQUIRE__WRITE,
+
+	OFC_SEMA_STMT_IO_INQUIRE__COUNT
+} ofc_sema_stmt_io_inquire__spec_e;
+
+/* Sorted by name for ofc_sema_io_spec_resolve. */
+static const char* const ofc_sema_stmt_io_inquire__spec[] =
+{
+	[OFC_SEMA_STMT_IO_INQUIRE__ACCESS]      = "ACCESS",
+	[OFC_SEMA_STMT_IO_INQUIRE__ACTION]      = "ACTION",
+	[OFC_SEMA_STMT_IO_INQUIRE__BLANK]       = "BLANK",
+	[OFC_SEMA_STMT_IO_INQUIRE__DELIM]       = "DELIM",
+	[OFC_SEMA_STMT_IO_INQUIRE__DIRECT]      = "DIRECT",
+	[OFC_SEMA_STMT_IO_INQUIRE__ERR]         = "ERR",
+	[OFC_SEMA_STMT_IO_INQUIRE__EXIST]       = "EXIST",
+	[OFC_SEMA_STMT_IO_INQUIRE__FILE]        = "FILE",
+	[OFC_SEMA_STMT_IO_INQUIRE__FORM]        = "FORM",
+	[OFC_SEMA_STMT_IO_INQUIRE__FORMATTED]   = "FORMATTED",
+	[OFC_SEMA_STMT_IO_INQUIRE__IOSTAT]      = "IOSTAT",
+	[OFC_SEMA_STMT_IO_INQUIRE__NAME]        = "NAME",
+	[OFC_SEMA_STMT_IO_INQUIRE__NAMED]       = "NAMED",
+	[OFC_SEMA_STMT_IO_INQUIRE__NEXTREC]     = "NEXTREC",
+	[OFC_SEMA_STMT_IO_INQUIRE__NUMBER]      = "NUMBER",
+	[OFC_SEMA_STMT_IO_INQUIRE__OPENED]      = "OPENED",
+	[OFC_SEMA_STMT_IO_INQUIRE__PAD]         = "PAD",
+	[OFC_SEMA_STMT_IO_INQUIRE__POSITION]    = "POSITION",
+	[OFC_SEMA_STMT_IO_INQUIRE__READ]        = "READ",
+	[OFC_SEMA_STMT_IO_INQUIRE__READWRITE]   = "READWRITE",
+	[OFC_SEMA_STMT_IO_INQUIRE__RECL]        = "RECL",
+	[OFC_SEMA_STMT_IO_INQUIRE__SEQUENTIAL]  = "SEQUENTIAL",
+	[OFC_SEMA_STMT_IO_INQUIRE__UNFORMATTED] = "UNFORMATTED",
+	[OFC_SEMA_STMT_IO_INQUIRE__UNIT]        = "UNIT",
+	[OFC_SEMA_STMT_IO_INQUIRE__WRITE]       = "WRITE",
+};
+
+static const unsigned ofc_sema_stmt_io_inquire__positional[] =
+{
+	OFC_SEMA_STMT_IO_INQUIRE__UNIT,
+};
+
+#define OFC_SEMA_STMT_IO_INQUIRE__POSITIONAL_COUNT \
+	(sizeof(ofc_sema_stmt_io_inquire__positional) \
+		/ sizeof(ofc_sema_stmt_io_inquire__positional[0]))
+
+/* Specifiers which return their result through a variable. */
+static const struct
+{
+	bool (*is_type)(const ofc_sema_type_t* type);
+	const char* expect;
+} ofc_sema_stmt_io_inquire__var[OFC_SEMA_STMT_IO_INQUIRE__COUNT] =
+{
+	[OFC_SEMA_STMT_IO_INQUIRE__ACCESS]      = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__ACTION]      = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__BLANK]       = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__DELIM]       = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__DIRECT]      = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__EXIST]       = { ofc_sema_type_is_logical,   "a LOGICAL variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__FORM]        = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__FORMATTED]   = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__IOSTAT]      = { ofc_sema_type_is_integer,   "of type INTEGER" },
+	[OFC_SEMA_STMT_IO_INQUIRE__NAME]        = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__NAMED]       = { ofc_sema_type_is_logical,   "a LOGICAL variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__NEXTREC]     = { ofc_sema_type_is_integer,   "of type INTEGER" },
+	[OFC_SEMA_STMT_IO_INQUIRE__NUMBER]      = { ofc_sema_type_is_integer,   "an INTEGER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__OPENED]      = { ofc_sema_type_is_logical,   "a LOGICAL variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__PAD]         = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__POSITION]    = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__READ]        = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__READWRITE]   = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__RECL]        = { ofc_sema_type_is_integer,   "an INTEGER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__SEQUENTIAL]  = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__UNFORMATTED] = { ofc_sema_type_is_character, "a CHARACTER variable" },
+	[OFC_SEMA_STMT_IO_INQUIRE__WRITE]       = { ofc_sema_type_is_character, "a CHARACTER variable" },
+};
+
 void ofc_sema_stmt_io_inquire__cleanup(
 	ofc_sema_stmt_t s)
 {
@@ -83,336 +184,17 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_inquire(
 	s.io_inquire.unformatted   = NULL;
 	s.io_inquire.write         = NULL;
 
-	ofc_parse_call_arg_t* ca_unit        = NULL;
-	ofc_parse_call_arg_t* ca_access      = NULL;
-	ofc_parse_call_arg_t* ca_action      = NULL;
-	ofc_parse_call_arg_t* ca_blank       = NULL;
-	ofc_parse_call_arg_t* ca_delim       = NULL;
-	ofc_parse_call_arg_t* ca_direct      = NULL;
-	ofc_parse_call_arg_t* ca_err         = NULL;
-	ofc_parse_call_arg_t* ca_exist       = NULL;
-	ofc_parse_call_arg_t* ca_file        = NULL;
-	ofc_parse_call_arg_t* ca_form        = NULL;
-	ofc_parse_call_arg_t* ca_formatted   = NULL;
-	ofc_parse_call_arg_t* ca_iostat      = NULL;
-	ofc_parse_call_arg_t* ca_name        = NULL;
-	ofc_parse_call_arg_t* ca_named       = NULL;
-	ofc_parse_call_arg_t* ca_nextrec     = NULL;
-	ofc_parse_call_arg_t* ca_number      = NULL;
-	ofc_parse_call_arg_t* ca_opened      = NULL;
-	ofc_parse_call_arg_t* ca_pad         = NULL;
-	ofc_parse_call_arg_t* ca_position    = NULL;
-	ofc_parse_call_arg_t* ca_read        = NULL;
-	ofc_parse_call_arg_t* ca_readwrite   = NULL;
-	ofc_parse_call_arg_t* ca_recl        = NULL;
-	ofc_parse_call_arg_t* ca_sequential  = NULL;
-	ofc_parse_call_arg_t* ca_unformatted = NULL;
-	ofc_parse_call_arg_t* ca_write       = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
-
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 1)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in INQUIRE.", i);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in INQUIRE.");
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ACCESS"))
-		{
-			if (ca_access)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ACCESS in INQUIRE.");
-				return NULL;
-			}
-
-			ca_access = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ACTION"))
-		{
-			if (ca_action)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ACTION in INQUIRE.");
-				return NULL;
-			}
-
-			ca_action = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "BLANK"))
-		{
-			if (ca_blank)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of BLANK in INQUIRE.");
-				return NULL;
-			}
-
-			ca_blank = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "DELIM"))
-		{
-			if (ca_delim)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of DELIM in INQUIRE.");
-				return NULL;
-			}
-
-			ca_delim = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "DIRECT"))
-		{
-			if (ca_direct)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of DIRECT in INQUIRE.");
-				return NULL;
-			}
-
-			ca_direct = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in INQUIRE.");
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "EXIST"))
-		{
-			if (ca_exist)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of EXIST in INQUIRE.");
-				return NULL;
-			}
-
-			ca_exist = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FILE"))
-		{
-			if (ca_file)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FILE in INQUIRE.");
-				return NULL;
-			}
-
-			ca_file = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FORM"))
-		{
-			if (ca_form)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FORM in INQUIRE.");
-				return NULL;
-			}
-
-			ca_form = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FORMATTED"))
-		{
-			if (ca_formatted)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FORMATTED in INQUIRE.");
-				return NULL;
-			}
-
-			ca_formatted = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in INQUIRE.");
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "NAME"))
-		{
-			if (ca_name)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of NAME in INQUIRE.");
-				return NULL;
-			}
-
-			ca_name = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "NAMED"))
-		{
-			if (ca_named)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of NAMED in INQUIRE.");
-				return NULL;
-			}
-
-			ca_named = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "NEXTREC"))
-		{
-			if (ca_nextrec)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of NEXTREC in INQUIRE.");
-				return NULL;
-			}
-
-			ca_nextrec = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "NUMBER"))
-		{
-			if (ca_number)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of NUMBER in INQUIRE.");
-				return NULL;
-			}
-
-			ca_number = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "OPENED"))
-		{
-			if (ca_opened)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of OPENED in INQUIRE.");
-				return NULL;
-			}
-
-			ca_opened = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "PAD"))
-		{
-			if (ca_pad)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of PAD in INQUIRE.");
-				return NULL;
-			}
-
-			ca_pad = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "POSITION"))
-		{
-			if (ca_position)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of POSITION in INQUIRE.");
-				return NULL;
-			}
-
-			ca_position = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "READ"))
-		{
-			if (ca_read)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of READ in INQUIRE.");
-				return NULL;
-			}
-
-			ca_read = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "READWRITE"))
-		{
-			if (ca_readwrite)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of READWRITE in INQUIRE.");
-				return NULL;
-			}
-
-			ca_readwrite = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "RECL"))
-		{
-			if (ca_recl)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of RECL in INQUIRE.");
-				return NULL;
-			}
-
-			ca_recl = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "SEQUENTIAL"))
-		{
-			if (ca_sequential)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of SEQUENTIAL in INQUIRE.");
-				return NULL;
-			}
-
-			ca_sequential = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNFORMATTED"))
-		{
-			if (ca_unformatted)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNFORMATTED in INQUIRE.");
-				return NULL;
-			}
-
-			ca_unformatted = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "WRITE"))
-		{
-			if (ca_write)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of WRITE in INQUIRE.");
-				return NULL;
-			}
+	ofc_parse_call_arg_t* ca[OFC_SEMA_STMT_IO_INQUIRE__COUNT];
+	if (!ofc_sema_io_spec_resolve(
+		stmt->io.params, "INQUIRE",
+		ofc_sema_stmt_io_inquire__spec,
+		OFC_SEMA_STMT_IO_INQUIRE__COUNT,
+		ofc_sema_stmt_io_inquire__positional,
+		OFC_SEMA_STMT_IO_INQUIRE__POSITIONAL_COUNT, ca))
+		return NULL;
 
-			ca_write = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in INQUIRE.",
-				i, param->name.string.size, param->name.string.base);
-			return NULL;
-		}
-	}
+	ofc_parse_call_arg_t* ca_unit = ca[OFC_SEMA_STMT_IO_INQUIRE__UNIT];
+	ofc_parse_call_arg_t* ca_file = ca[OFC_SEMA_STMT_IO_INQUIRE__FILE];
 
 	if (!ca_unit && !ca_file)
 	{
@@ -464,634 +246,109 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_inquire(
 		return NULL;
 	}
 
-	if (ca_access)
-	{
-		s.io_inquire.access = ofc_sema_lhs_from_expr(
-			scope, ca_access->expr);
-		if (!s.io_inquire.access)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.access);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"ACCESS must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_action)
-	{
-		s.io_inquire.action = ofc_sema_lhs_from_expr(
-			scope, ca_action->expr);
-		if (!s.io_inquire.action)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.action);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"ACTION must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_blank)
-	{
-		s.io_inquire.blank = ofc_sema_lhs_from_expr(
-			scope, ca_blank->expr);
-		if (!s.io_inquire.blank)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.blank);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"BLANK must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_delim)
+	ofc_sema_lhs_t** var[OFC_SEMA_STMT_IO_INQUIRE__COUNT] =
 	{
-		s.io_inquire.delim = ofc_sema_lhs_from_expr(
-			scope, ca_delim->expr);
-		if (!s.io_inquire.delim)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.delim);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"DELIM must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
+		[OFC_SEMA_STMT_IO_INQUIRE__ACCESS]      = &s.io_inquire.access,
+		[OFC_SEMA_STMT_IO_INQUIRE__ACTION]      = &s.io_inquire.action,
+		[OFC_SEMA_STMT_IO_INQUIRE__BLANK]       = &s.io_inquire.blank,
+		[OFC_SEMA_STMT_IO_INQUIRE__DELIM]       = &s.io_inquire.delim,
+		[OFC_SEMA_STMT_IO_INQUIRE__DIRECT]      = &s.io_inquire.direct,
+		[OFC_SEMA_STMT_IO_INQUIRE__EXIST]       = &s.io_inquire.exist,
+		[OFC_SEMA_STMT_IO_INQUIRE__FORM]        = &s.io_inquire.form,
+		[OFC_SEMA_STMT_IO_INQUIRE__FORMATTED]   = &s.io_inquire.formatted,
+		[OFC_SEMA_STMT_IO_INQUIRE__IOSTAT]      = &s.io_inquire.iostat,
+		[OFC_SEMA_STMT_IO_INQUIRE__NAME]        = &s.io_inquire.name,
+		[OFC_SEMA_STMT_IO_INQUIRE__NAMED]       = &s.io_inquire.named,
+		[OFC_SEMA_STMT_IO_INQUIRE__NEXTREC]     = &s.io_inquire.nextrec,
+		[OFC_SEMA_STMT_IO_INQUIRE__NUMBER]      = &s.io_inquire.number,
+		[OFC_SEMA_STMT_IO_INQUIRE__OPENED]      = &s.io_inquire.opened,
+		[OFC_SEMA_STMT_IO_INQUIRE__PAD]         = &s.io_inquire.pad,
+		[OFC_SEMA_STMT_IO_INQUIRE__POSITION]    = &s.io_inquire.position,
+		[OFC_SEMA_STMT_IO_INQUIRE__READ]        = &s.io_inquire.read,
+		[OFC_SEMA_STMT_IO_INQUIRE__READWRITE]   = &s.io_inquire.readwrite,
+		[OFC_SEMA_STMT_IO_INQUIRE__RECL]        = &s.io_inquire.recl,
+		[OFC_SEMA_STMT_IO_INQUIRE__SEQUENTIAL]  = &s.io_inquire.sequential,
+		[OFC_SEMA_STMT_IO_INQUIRE__UNFORMATTED] = &s.io_inquire.unformatted,
+		[OFC_SEMA_STMT_IO_INQUIRE__WRITE]       = &s.io_inquire.write,
+	};
 
-	if (ca_direct)
+	unsigned i;
+	for (i = 0; i < OFC_SEMA_STMT_IO_INQUIRE__COUNT; i++)
 	{
-		s.io_inquire.direct = ofc_sema_lhs_from_expr(
-			scope, ca_direct->expr);
-		if (!s.io_inquire.direct)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.direct);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
+		if (!ca[i]) continue;
 
-		if (!ofc_sema_type_is_character(etype))
+		switch (i)
 		{
-			ofc_sparse_ref_error(stmt->src,
-				"DIRECT must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
+			case OFC_SEMA_STMT_IO_INQUIRE__UNIT:
+				break;
 
-	if (ca_err)
-	{
-		s.io_inquire.err = ofc_sema_expr_label(
-			scope, ca_err->expr);
-		if (!s.io_inquire.err)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
+			case OFC_SEMA_STMT_IO_INQUIRE__ERR:
+				s.io_inquire.err = ofc_sema_expr_label(
+					scope, ca[i]->expr);
+				if (!s.io_inquire.err)
+				{
+					ofc_sema_stmt_io_inquire__cleanup(s);
+					return NULL;
+				}
+				break;
 
-	if (ca_exist)
-	{
-		s.io_inquire.exist = ofc_sema_lhs_from_expr(
-			scope, ca_exist->expr);
-		if (!s.io_inquire.exist)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
+			case OFC_SEMA_STMT_IO_INQUIRE__FILE:
+			{
+				s.io_inquire.file = ofc_sema_expr(
+					scope, ca[i]->expr);
+				if (!s.io_inquire.file)
+				{
+					ofc_sema_stmt_io_inquire__cleanup(s);
+					return NULL;
+				}
+
+				const ofc_sema_type_t* etype
+					= ofc_sema_expr_type(s.io_inquire.file);
+				if (!etype)
+				{
+					ofc_sema_stmt_io_inquire__cleanup(s);
+					return NULL;
+				}
+
+				if (!ofc_sema_type_is_character(etype))
+				{
+					ofc_sparse_ref_error(stmt->src,
+						"FILE must be a CHARACTER expression in INQUIRE");
+					ofc_sema_stmt_io_inquire__cleanup(s);
+					return NULL;
+				}
+				break;
+			}
 
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.exist);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-		if (!ofc_sema_type_is_logical(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"EXIST must be a LOGICAL variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_file)
-	{
-		s.io_inquire.file = ofc_sema_expr(
-			scope, ca_file->expr);
-		if (!s.io_inquire.file)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_inquire.file);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"FILE must be a CHARACTER expression in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_form)
-	{
-		s.io_inquire.form = ofc_sema_lhs_from_expr(
-			scope, ca_form->expr);
-		if (!s.io_inquire.form)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.form);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"FORM must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_formatted)
-	{
-		s.io_inquire.formatted = ofc_sema_lhs_from_expr(
-			scope, ca_formatted->expr);
-		if (!s.io_inquire.formatted)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.formatted);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"FORMATTED must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_iostat)
-	{
-		s.io_inquire.iostat = ofc_sema_lhs_from_expr(
-			scope, ca_iostat->expr);
-		if (!s.io_inquire.iostat)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.iostat);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"IOSTAT must be of type INTEGER in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_name)
-	{
-		s.io_inquire.name = ofc_sema_lhs_from_expr(
-			scope, ca_name->expr);
-		if (!s.io_inquire.name)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.name);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"NAME must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_named)
-	{
-		s.io_inquire.named = ofc_sema_lhs_from_expr(
-			scope, ca_named->expr);
-		if (!s.io_inquire.named)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.named);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_logical(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"NAMED must be a LOGICAL variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_nextrec)
-	{
-		s.io_inquire.nextrec = ofc_sema_lhs_from_expr(
-			scope, ca_nextrec->expr);
-		if (!s.io_inquire.nextrec)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.nextrec);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"NEXTREC must be of type INTEGER in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_number)
-	{
-		s.io_inquire.number = ofc_sema_lhs_from_expr(
-			scope, ca_number->expr);
-		if (!s.io_inquire.number)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.number);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"NUMBER must be an INTEGER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_opened)
-	{
-		s.io_inquire.opened = ofc_sema_lhs_from_expr(
-			scope, ca_opened->expr);
-		if (!s.io_inquire.opened)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.opened);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_logical(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"OPENED must be a LOGICAL variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_pad)
-	{
-		s.io_inquire.pad = ofc_sema_lhs_from_expr(
-			scope, ca_pad->expr);
-		if (!s.io_inquire.pad)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.pad);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"PAD must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_position)
-	{
-		s.io_inquire.position = ofc_sema_lhs_from_expr(
-			scope, ca_position->expr);
-		if (!s.io_inquire.position)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.position);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"POSITION must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_read)
-	{
-		s.io_inquire.read = ofc_sema_lhs_from_expr(
-			scope, ca_read->expr);
-		if (!s.io_inquire.read)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.read);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"READ must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_readwrite)
-	{
-		s.io_inquire.readwrite = ofc_sema_lhs_from_expr(
-			scope, ca_readwrite->expr);
-		if (!s.io_inquire.readwrite)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.readwrite);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"READWRITE must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_recl)
-	{
-		s.io_inquire.recl = ofc_sema_lhs_from_expr(
-			scope, ca_recl->expr);
-		if (!s.io_inquire.recl)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.recl);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_integer(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"RECL must be an INTEGER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_sequential)
-	{
-		s.io_inquire.sequential = ofc_sema_lhs_from_expr(
-			scope, ca_sequential->expr);
-		if (!s.io_inquire.sequential)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.sequential);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"SEQUENTIAL must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_unformatted)
-	{
-		s.io_inquire.unformatted = ofc_sema_lhs_from_expr(
-			scope, ca_unformatted->expr);
-		if (!s.io_inquire.unformatted)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.unformatted);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"UNFORMATTED must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-	}
-
-	if (ca_write)
-	{
-		s.io_inquire.write = ofc_sema_lhs_from_expr(
-			scope, ca_write->expr);
-		if (!s.io_inquire.write)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_lhs_type(s.io_inquire.write);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
-		}
-
-		if (!ofc_sema_type_is_character(etype))
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"WRITE must be a CHARACTER variable in INQUIRE");
-			ofc_sema_stmt_io_inquire__cleanup(s);
-			return NULL;
+			default:
+			{
+				*var[i] = ofc_sema_lhs_from_expr(
+					scope, ca[i]->expr);
+				if (!*var[i])
+				{
+					ofc_sema_stmt_io_inquire__cleanup(s);
+					return NULL;
+				}
+
+				const ofc_sema_type_t* etype
+					= ofc_sema_lhs_type(*var[i]);
+				if (!etype)
+				{
+					ofc_sema_stmt_io_inquire__cleanup(s);
+					return NULL;
+				}
+
+				if (!ofc_sema_stmt_io_inquire__var[i].is_type(etype))
+				{
+					ofc_sparse_ref_error(stmt->src,
+						"%s must be %s in INQUIRE",
+						ofc_sema_stmt_io_inquire__spec[i],
+						ofc_sema_stmt_io_inquire__var[i].expect);
+					ofc_sema_stmt_io_inquire__cleanup(s);
+					return NULL;
+				}
+				break;
+			}
 		}
 	}
 
@@ -15,6 +15,33 @@
 
 #include "ofc/sema.h"
 
+typedef enum
+{
+	OFC_SEMA_STMT_IO_POSITION__ERR = 0,
+	OFC_SEMA_STMT_IO_POSITION__IOSTAT,
+	OFC_SEMA_STMT_IO_POSITION__UNIT,
+
+	OFC_SEMA_STMT_IO_POSITION__COUNT
+} ofc_sema_stmt_io_position__spec_e;
+
+/* Sorted by name for ofc_sema_io_spec_resolve. */
+static const char* const ofc_sema_stmt_io_position__spec[] =
+{
+	[OFC_SEMA_STMT_IO_POSITION__ERR]    = "ERR",
+	[OFC_SEMA_STMT_IO_POSITION__IOSTAT] = "IOSTAT",
+	[OFC_SEMA_STMT_IO_POSITION__UNIT]   = "UNIT",
+};
+
+static const unsigned ofc_sema_stmt_io_position__positional[] =
+{
+	OFC_SEMA_STMT_IO_POSITION__UNIT,
+};
+
+#define OFC_SEMA_STMT_IO_POSITION__POSITIONAL_COUNT \
+	(sizeof(ofc_sema_stmt_io_position__positional) \
+		/ sizeof(ofc_sema_stmt_io_position__positional[0]))
+
+
 ofc_sema_stmt_t* ofc_sema_stmt_io_position(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -48,72 +75,18 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_position(
 	s.io_position.iostat      = NULL;
 	s.io_position.err         = NULL;
 
-	ofc_parse_call_arg_t* ca_unit   = NULL;
-	ofc_parse_call_arg_t* ca_iostat = NULL;
-	ofc_parse_call_arg_t* ca_err    = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
+	ofc_parse_call_arg_t* ca[OFC_SEMA_STMT_IO_POSITION__COUNT];
+	if (!ofc_sema_io_spec_resolve(
+		stmt->io.params, name,
+		ofc_sema_stmt_io_position__spec,
+		OFC_SEMA_STMT_IO_POSITION__COUNT,
+		ofc_sema_stmt_io_position__positional,
+		OFC_SEMA_STMT_IO_POSITION__POSITIONAL_COUNT, ca))
+		return NULL;
 
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 1)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in %s.", i, name);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in %s.", name);
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in %s.", name);
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in %s.", name);
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in %s.",
-				i, param->name.string.size, param->name.string.base, name);
-			return NULL;
-		}
-	}
+	ofc_parse_call_arg_t* ca_unit   = ca[OFC_SEMA_STMT_IO_POSITION__UNIT];
+	ofc_parse_call_arg_t* ca_iostat = ca[OFC_SEMA_STMT_IO_POSITION__IOSTAT];
+	ofc_parse_call_arg_t* ca_err    = ca[OFC_SEMA_STMT_IO_POSITION__ERR];
 
 	if (!ca_unit)
 	{
@@ -15,6 +15,79 @@
 
 #include "ofc/sema.h"
 
+typedef enum
+{
+	OFC_SEMA_STMT_IO_OPEN__ACCESS = 0,
+	OFC_SEMA_STMT_IO_OPEN__ACTION,
+	OFC_SEMA_STMT_IO_OPEN__BLANK,
+	OFC_SEMA_STMT_IO_OPEN__DELIM,
+	OFC_SEMA_STMT_IO_OPEN__ERR,
+	OFC_SEMA_STMT_IO_OPEN__FILE,
+	OFC_SEMA_STMT_IO_OPEN__FORM,
+	OFC_SEMA_STMT_IO_OPEN__IOSTAT,
+	OFC_SEMA_STMT_IO_OPEN__PAD,
+	OFC_SEMA_STMT_IO_OPEN__POSITION,
+	OFC_SEMA_STMT_IO_OPEN__RECL,
+	OFC_SEMA_STMT_IO_OPEN__STATUS,
+	OFC_SEMA_STMT_IO_OPEN__UNIT,
+
+	OFC_SEMA_STMT_IO_OPEN__COUNT
+} ofc_sema_stmt_io_open__spec_e;
+
+/* Sorted by name for ofc_sema_io_spec_resolve. */
+static const char* const ofc_sema_stmt_io_open__spec[] =
+{
+	[OFC_SEMA_STMT_IO_OPEN__ACCESS]   = "ACCESS",
+	[OFC_SEMA_STMT_IO_OPEN__ACTION]   = "ACTION",
+	[OFC_SEMA_STMT_IO_OPEN__BLANK]    = "BLANK",
+	[OFC_SEMA_STMT_IO_OPEN__DELIM]    = "DELIM",
+	[OFC_SEMA_STMT_IO_OPEN__ERR]      = "ERR",
+	[OFC_SEMA_STMT_IO_OPEN__FILE]     = "FILE",
+	[OFC_SEMA_STMT_IO_OPEN__FORM]     = "FORM",
+	[OFC_SEMA_STMT_IO_OPEN__IOSTAT]   = "IOSTAT",
+	[OFC_SEMA_STMT_IO_OPEN__PAD]      = "PAD",
+	[OFC_SEMA_STMT_IO_OPEN__POSITION] = "POSITION",
+	[OFC_SEMA_STMT_IO_OPEN__RECL]     = "RECL",
+	[OFC_SEMA_STMT_IO_OPEN__STATUS]   = "STATUS",
+	[OFC_SEMA_STMT_IO_OPEN__UNIT]     = "UNIT",
+};
+
+static const unsigned ofc_sema_stmt_io_open__positional[] =
+{
+	OFC_SEMA_STMT_IO_OPEN__UNIT,
+};
+
+#define OFC_SEMA_STMT_IO_OPEN__POSITIONAL_COUNT \
+	(sizeof(ofc_sema_stmt_io_open__positional) \
+		/ sizeof(ofc_sema_stmt_io_open__positional[0]))
+
+/* Specifiers which take a keyword, when constant it must be one
+   of the allowed values. */
+static const struct
+{
+	const char* allowed[6];
+	const char* expect;
+} ofc_sema_stmt_io_open__keyword_spec[OFC_SEMA_STMT_IO_OPEN__COUNT] =
+{
+	[OFC_SEMA_STMT_IO_OPEN__ACCESS]
+		= { { "SEQUENTIAL", "DIRECT" }, "SEQUENTIAL/DIRECT" },
+	[OFC_SEMA_STMT_IO_OPEN__ACTION]
+		= { { "READ", "WRITE", "READWRITE" }, "'READ', 'WRITE' or 'READWRITE'" },
+	[OFC_SEMA_STMT_IO_OPEN__BLANK]
+		= { { "NULL", "ZERO" }, "NULL/ZERO" },
+	[OFC_SEMA_STMT_IO_OPEN__DELIM]
+		= { { "APOSTROPHE", "QUOTE", "NONE" }, "APOSTROPHE/QUOTE/NONE" },
+	[OFC_SEMA_STMT_IO_OPEN__FORM]
+		= { { "FORMATTED", "UNFORMATTED" }, "FORMATTED/UNFORMATTED" },
+	[OFC_SEMA_STMT_IO_OPEN__PAD]
+		= { { "YES", "NO" }, "YES/NO" },
+	[OFC_SEMA_STMT_IO_OPEN__POSITION]
+		= { { "REWIND", "APPEND", "ASIS" }, "REWIND/APPEND/ASIS" },
+	[OFC_SEMA_STMT_IO_OPEN__STATUS]
+		= { { "UNKNOWN", "REPLACE", "OLD", "NEW", "SCRATCH" },
+			"UNKNOWN/REPLACE/OLD/NEW/SCRATCH" },
+};
+
 static void ofc_sema_stmt_io_open__cleanup(
 	ofc_sema_stmt_t s)
 {
@@ -33,6 +106,49 @@ static void ofc_sema_stmt_io_open__cleanup(
 	ofc_sema_expr_delete(s.io_open.status);
 }
 
+static bool ofc_sema_stmt_io_open__keyword(
+	ofc_sema_scope_t* scope,
+	const ofc_parse_stmt_t* stmt,
+	const ofc_parse_call_arg_t* ca,
+	ofc_sema_stmt_io_open__spec_e spec,
+	ofc_sema_expr_t** expr,
+	const ofc_sema_typeval_t** value)
+{
+	*expr = ofc_sema_expr(scope, ca->expr);
+	if (!*expr) return false;
+
+	const ofc_sema_type_t* etype
+		= ofc_sema_expr_type(*expr);
+	if (!etype) return false;
+
+	if (etype->type != OFC_SEMA_TYPE_CHARACTER)
+	{
+		ofc_sparse_ref_error(stmt->src,
+			"%s must be a CHARACTER expression in OPEN",
+			ofc_sema_stmt_io_open__spec[spec]);
+		return false;
+	}
+
+	const ofc_sema_typeval_t* constant
+		= ofc_sema_expr_constant(*expr);
+	if (value) *value = constant;
+	if (!constant) return true;
+
+	unsigned i;
+	for (i = 0; ofc_sema_stmt_io_open__keyword_spec[spec].allowed[i]; i++)
+	{
+		if (ofc_typeval_character_equal_strz_ci(constant,
+			ofc_sema_stmt_io_open__keyword_spec[spec].allowed[i]))
+			return true;
+	}
+
+	ofc_sparse_ref_error(stmt->src,
+		"%s must be %s in OPEN",
+		ofc_sema_stmt_io_open__spec[spec],
+		ofc_sema_stmt_io_open__keyword_spec[spec].expect);
+	return false;
+}
+
 ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -58,192 +174,28 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	s.io_open.recl          = NULL;
 	s.io_open.status        = NULL;
 
-	ofc_parse_call_arg_t* ca_unit     = NULL;
-	ofc_parse_call_arg_t* ca_access   = NULL;
-	ofc_parse_call_arg_t* ca_action   = NULL;
-	ofc_parse_call_arg_t* ca_blank    = NULL;
-	ofc_parse_call_arg_t* ca_delim    = NULL;
-	ofc_parse_call_arg_t* ca_err      = NULL;
-	ofc_parse_call_arg_t* ca_file     = NULL;
-	ofc_parse_call_arg_t* ca_form     = NULL;
-	ofc_parse_call_arg_t* ca_iostat   = NULL;
-	ofc_parse_call_arg_t* ca_pad      = NULL;
-	ofc_parse_call_arg_t* ca_position = NULL;
-	ofc_parse_call_arg_t* ca_recl     = NULL;
-	ofc_parse_call_arg_t* ca_status   = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
-
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 1)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in OPEN.", i);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in OPEN.");
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ACCESS"))
-		{
-			if (ca_access)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ACCESS in OPEN.");
-				return NULL;
-			}
-
-			ca_access = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ACTION"))
-		{
-			if (ca_action)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ACTION in OPEN.");
-				return NULL;
-			}
-
-			ca_action = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "BLANK"))
-		{
-			if (ca_blank)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of BLANK in OPEN.");
-				return NULL;
-			}
-
-			ca_blank = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "DELIM"))
-		{
-			if (ca_delim)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of DELIM in OPEN.");
-				return NULL;
-			}
-
-			ca_delim = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in OPEN.");
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FILE"))
-		{
-			if (ca_file)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FILE in OPEN.");
-				return NULL;
-			}
-
-			ca_file = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FORM"))
-		{
-			if (ca_form)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FORM in OPEN.");
-				return NULL;
-			}
-
-			ca_form = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in OPEN.");
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "PAD"))
-		{
-			if (ca_pad)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of PAD in OPEN.");
-				return NULL;
-			}
-
-			ca_pad = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "POSITION"))
-		{
-			if (ca_position)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of POSITION in OPEN.");
-				return NULL;
-			}
-
-			ca_position = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "RECL"))
-		{
-			if (ca_recl)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of RECL in OPEN.");
-				return NULL;
-			}
-
-			ca_recl = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "STATUS"))
-		{
-			if (ca_status)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of STATUS in OPEN.");
-				return NULL;
-			}
+	ofc_parse_call_arg_t* ca[OFC_SEMA_STMT_IO_OPEN__COUNT];
+	if (!ofc_sema_io_spec_resolve(
+		stmt->io.params, "OPEN",
+		ofc_sema_stmt_io_open__spec,
+		OFC_SEMA_STMT_IO_OPEN__COUNT,
+		ofc_sema_stmt_io_open__positional,
+		OFC_SEMA_STMT_IO_OPEN__POSITIONAL_COUNT, ca))
+		return NULL;
 
-			ca_status = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in OPEN.",
-				i, param->name.string.size, param->name.string.base);
-			return NULL;
-		}
-	}
+	ofc_parse_call_arg_t* ca_unit     = ca[OFC_SEMA_STMT_IO_OPEN__UNIT];
+	ofc_parse_call_arg_t* ca_access   = ca[OFC_SEMA_STMT_IO_OPEN__ACCESS];
+	ofc_parse_call_arg_t* ca_action   = ca[OFC_SEMA_STMT_IO_OPEN__ACTION];
+	ofc_parse_call_arg_t* ca_blank    = ca[OFC_SEMA_STMT_IO_OPEN__BLANK];
+	ofc_parse_call_arg_t* ca_delim    = ca[OFC_SEMA_STMT_IO_OPEN__DELIM];
+	ofc_parse_call_arg_t* ca_err      = ca[OFC_SEMA_STMT_IO_OPEN__ERR];
+	ofc_parse_call_arg_t* ca_file     = ca[OFC_SEMA_STMT_IO_OPEN__FILE];
+	ofc_parse_call_arg_t* ca_form     = ca[OFC_SEMA_STMT_IO_OPEN__FORM];
+	ofc_parse_call_arg_t* ca_iostat   = ca[OFC_SEMA_STMT_IO_OPEN__IOSTAT];
+	ofc_parse_call_arg_t* ca_pad      = ca[OFC_SEMA_STMT_IO_OPEN__PAD];
+	ofc_parse_call_arg_t* ca_position = ca[OFC_SEMA_STMT_IO_OPEN__POSITION];
+	ofc_parse_call_arg_t* ca_recl     = ca[OFC_SEMA_STMT_IO_OPEN__RECL];
+	ofc_parse_call_arg_t* ca_status   = ca[OFC_SEMA_STMT_IO_OPEN__STATUS];
 
 	if (!ca_unit)
 	{
@@ -293,144 +245,59 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	bool format_type_unformatted  = false;
 	if (ca_access)
 	{
-		s.io_open.access = ofc_sema_expr(
-			scope, ca_access->expr);
-		if (!s.io_open.access)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.access);
-		if (!etype)
+		const ofc_sema_typeval_t* constant;
+		if (!ofc_sema_stmt_io_open__keyword(
+			scope, stmt, ca_access,
+			OFC_SEMA_STMT_IO_OPEN__ACCESS,
+			&s.io_open.access, &constant))
 		{
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
 
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"ACCESS must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
+		access_type_direct = (constant
+			&& ofc_typeval_character_equal_strz_ci(constant, "DIRECT"));
+		if (access_type_direct)
 		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.access);
+			/* Change default format */
+			format_type_unformatted = true;
 
-			access_type_direct = (constant
-				&& ofc_typeval_character_equal_strz_ci(constant, "DIRECT"));
-			if (constant && !access_type_direct
-				&& !ofc_typeval_character_equal_strz_ci(constant, "SEQUENTIAL"))
+			if (!ca_recl)
 			{
 				ofc_sparse_ref_error(stmt->src,
-					"ACCESS must be SEQUENTIAL/DIRECT in OPEN");
+					"Direct ACCESS must have a RECL specifier in OPEN");
 				ofc_sema_stmt_io_open__cleanup(s);
 				return NULL;
 			}
-			else if (access_type_direct)
-			{
-				/* Change default format */
-				format_type_unformatted = true;
-
-				if (!ca_recl)
-				{
-					ofc_sparse_ref_error(stmt->src,
-						"Direct ACCESS must have a RECL specifier in OPEN");
-					ofc_sema_stmt_io_open__cleanup(s);
-					return NULL;
-				}
-			}
 		}
 	}
 
 	if (ca_action)
 	{
-		s.io_open.action = ofc_sema_expr(
-			scope, ca_action->expr);
-		if (!s.io_open.action)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.action);
-		if (!etype)
+		if (!ofc_sema_stmt_io_open__keyword(
+			scope, stmt, ca_action,
+			OFC_SEMA_STMT_IO_OPEN__ACTION,
+			&s.io_open.action, NULL))
 		{
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"ACTION must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.action);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "READWRITE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "WRITE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "READ"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"ACTION must be 'READ', 'WRITE' or 'READWRITE' in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
 	}
 
 	if (ca_form)
 	{
-		s.io_open.form = ofc_sema_expr(
-			scope, ca_form->expr);
-		if (!s.io_open.form)
+		const ofc_sema_typeval_t* constant;
+		if (!ofc_sema_stmt_io_open__keyword(
+			scope, stmt, ca_form,
+			OFC_SEMA_STMT_IO_OPEN__FORM,
+			&s.io_open.form, &constant))
 		{
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
 
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.form);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"FORM must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.form);
-
-			format_type_unformatted = (constant
-				&& ofc_typeval_character_equal_strz_ci(constant, "UNFORMATTED"));
-			if (constant && !format_type_unformatted
-				&& !ofc_typeval_character_equal_strz_ci(constant, "FORMATTED"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"FORM must be FORMATTED/UNFORMATTED in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
+		format_type_unformatted = (constant
+			&& ofc_typeval_character_equal_strz_ci(constant, "UNFORMATTED"));
 	}
 
 	if (ca_blank && format_type_unformatted)
@@ -442,44 +309,14 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	}
 	else if (ca_blank)
 	{
-		s.io_open.blank = ofc_sema_expr(
-			scope, ca_blank->expr);
-		if (!s.io_open.blank)
+		if (!ofc_sema_stmt_io_open__keyword(
+			scope, stmt, ca_blank,
+			OFC_SEMA_STMT_IO_OPEN__BLANK,
+			&s.io_open.blank, NULL))
 		{
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.blank);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"BLANK must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.blank);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "ZERO")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "NULL"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"BLANK must be NULL/ZERO in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
 	}
 
 	if (ca_delim && format_type_unformatted)
@@ -491,45 +328,14 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	}
 	else if (ca_delim)
 	{
-		s.io_open.delim = ofc_sema_expr(
-			scope, ca_delim->expr);
-		if (!s.io_open.delim)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.delim);
-		if (!etype)
+		if (!ofc_sema_stmt_io_open__keyword(
+			scope, stmt, ca_delim,
+			OFC_SEMA_STMT_IO_OPEN__DELIM,
+			&s.io_open.delim, NULL))
 		{
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"DELIM must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.delim);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "APOSTROPHE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "QUOTE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "NONE"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"DELIM must be APOSTROPHE/QUOTE/NONE in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
 	}
 
 	if (ca_err)
@@ -543,50 +349,22 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 		}
 	}
 
+
 	bool is_scratch = false;
 	if (ca_status)
 	{
-		s.io_open.status = ofc_sema_expr(
-			scope, ca_status->expr);
-		if (!s.io_open.status)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.status);
-		if (!etype)
+		const ofc_sema_typeval_t* constant;
+		if (!ofc_sema_stmt_io_open__keyword(
+			scope, stmt, ca_status,
+			OFC_SEMA_STMT_IO_OPEN__STATUS,
+			&s.io_open.status, &constant))
 		{
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
 
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
-		{
-			ofc_sparse_ref_error(stmt->src,
-				"STATUS must be a CHARACTER expression in OPEN");
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.status);
-			is_scratch = (constant &&
-				ofc_typeval_character_equal_strz_ci(constant, "SCRATCH"));
-			if (constant && !is_scratch
-				&& !ofc_typeval_character_equal_strz_ci(constant, "UNKNOWN")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "REPLACE")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "OLD")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "NEW"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"STATUS must be UNKNOWN/REPLACE/OLD/NEW/SCRATCH in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
+		is_scratch = (constant &&
+			ofc_typeval_character_equal_strz_ci(constant, "SCRATCH"));
 	}
 
 	if (ca_file && is_scratch)
@@ -667,44 +445,14 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	}
 	else if (ca_pad)
 	{
-		s.io_open.pad = ofc_sema_expr(
-			scope, ca_pad->expr);
-		if (!s.io_open.pad)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.pad);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
+		if (!ofc_sema_stmt_io_open__keyword(
+			scope, stmt, ca_pad,
+			OFC_SEMA_STMT_IO_OPEN__PAD,
+			&s.io_open.pad, NULL))
 		{
-			ofc_sparse_ref_error(stmt->src,
-				"PAD must be a CHARACTER expression in OPEN");
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.pad);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "NO")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "YES"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"PAD must be YES/NO in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
 	}
 
 	if (ca_position && access_type_direct)
@@ -716,45 +464,14 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_open(
 	}
 	else if (ca_position)
 	{
-		s.io_open.position = ofc_sema_expr(
-			scope, ca_position->expr);
-		if (!s.io_open.position)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		const ofc_sema_type_t* etype
-			= ofc_sema_expr_type(s.io_open.position);
-		if (!etype)
-		{
-			ofc_sema_stmt_io_open__cleanup(s);
-			return NULL;
-		}
-
-		if (etype->type != OFC_SEMA_TYPE_CHARACTER)
+		if (!ofc_sema_stmt_io_open__keyword(
+			scope, stmt, ca_position,
+			OFC_SEMA_STMT_IO_OPEN__POSITION,
+			&s.io_open.position, NULL))
 		{
-			ofc_sparse_ref_error(stmt->src,
-				"POSITION must be a CHARACTER expression in OPEN");
 			ofc_sema_stmt_io_open__cleanup(s);
 			return NULL;
 		}
-		else
-		{
-			const ofc_sema_typeval_t* constant
-				= ofc_sema_expr_constant(s.io_open.position);
-
-			if (constant
-				&& !ofc_typeval_character_equal_strz_ci(constant, "REWIND")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "APPEND")
-				&& !ofc_typeval_character_equal_strz_ci(constant, "ASIS"))
-			{
-				ofc_sparse_ref_error(stmt->src,
-					"POSITION must be REWIND/APPEND/ASIS in OPEN");
-				ofc_sema_stmt_io_open__cleanup(s);
-				return NULL;
-			}
-		}
 	}
 
 	if (ca_recl)
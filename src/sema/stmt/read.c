@@ -17,6 +17,44 @@
 
 #include "ofc/sema.h"
 
+typedef enum
+{
+	OFC_SEMA_STMT_IO_READ__ADVANCE = 0,
+	OFC_SEMA_STMT_IO_READ__END,
+	OFC_SEMA_STMT_IO_READ__ERR,
+	OFC_SEMA_STMT_IO_READ__FMT,
+	OFC_SEMA_STMT_IO_READ__IOSTAT,
+	OFC_SEMA_STMT_IO_READ__REC,
+	OFC_SEMA_STMT_IO_READ__SIZE,
+	OFC_SEMA_STMT_IO_READ__UNIT,
+
+	OFC_SEMA_STMT_IO_READ__COUNT
+} ofc_sema_stmt_io_read__spec_e;
+
+/* Sorted by name for ofc_sema_io_spec_resolve. */
+static const char* const ofc_sema_stmt_io_read__spec[] =
+{
+	[OFC_SEMA_STMT_IO_READ__ADVANCE] = "ADVANCE",
+	[OFC_SEMA_STMT_IO_READ__END]     = "END",
+	[OFC_SEMA_STMT_IO_READ__ERR]     = "ERR",
+	[OFC_SEMA_STMT_IO_READ__FMT]     = "FMT",
+	[OFC_SEMA_STMT_IO_READ__IOSTAT]  = "IOSTAT",
+	[OFC_SEMA_STMT_IO_READ__REC]     = "REC",
+	[OFC_SEMA_STMT_IO_READ__SIZE]    = "SIZE",
+	[OFC_SEMA_STMT_IO_READ__UNIT]    = "UNIT",
+};
+
+static const unsigned ofc_sema_stmt_io_read__positional[] =
+{
+	OFC_SEMA_STMT_IO_READ__UNIT,
+	OFC_SEMA_STMT_IO_READ__FMT,
+};
+
+#define OFC_SEMA_STMT_IO_READ__POSITIONAL_COUNT \
+	(sizeof(ofc_sema_stmt_io_read__positional) \
+		/ sizeof(ofc_sema_stmt_io_read__positional[0]))
+
+
 void ofc_sema_stmt_io_read__cleanup(
 	ofc_sema_stmt_t s)
 {
@@ -56,148 +94,18 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_read(
 	s.io_read.eor          = NULL;
 	s.io_read.size         = NULL;
 
-	ofc_parse_call_arg_t* ca_unit    = NULL;
-	ofc_parse_call_arg_t* ca_format  = NULL;
-	ofc_parse_call_arg_t* ca_iostat  = NULL;
-	ofc_parse_call_arg_t* ca_rec     = NULL;
-	ofc_parse_call_arg_t* ca_err     = NULL;
-	ofc_parse_call_arg_t* ca_advance = NULL;
-	ofc_parse_call_arg_t* ca_end     = NULL;
-	ofc_parse_call_arg_t* ca_eor     = NULL;
-	ofc_parse_call_arg_t* ca_size    = NULL;
-
+	ofc_parse_call_arg_t* ca[OFC_SEMA_STMT_IO_READ__COUNT] = { NULL };
 	if (stmt->io_read.has_brakets)
 	{
-		unsigned i;
-		for (i = 0; i < stmt->io_read.params->count; i++)
-		{
-			ofc_parse_call_arg_t* param
-				= stmt->io_read.params->call_arg[i];
-			if (!param) continue;
-
-			if (ofc_sparse_ref_empty(param->name))
-			{
-				if (i >= 2)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Un-named parameter %u has no meaning in READ.", i);
-					return NULL;
-				}
-
-				if (i == 0)
-				{
-					ca_unit = param;
-				}
-				else
-				{
-					if (!ca_unit)
-					{
-						ofc_sparse_ref_error(param->src,
-							"Un-named format parameter only valid after UNIT in READ.");
-						return NULL;
-					}
-
-					ca_format = param;
-				}
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-			{
-				if (ca_unit)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of UNIT in READ.");
-					return NULL;
-				}
-
-				ca_unit = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "FMT"))
-			{
-				if (ca_format)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of FMT in READ.");
-					return NULL;
-				}
-
-				ca_format = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-			{
-				if (ca_iostat)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of IOSTAT in READ.");
-					return NULL;
-				}
-
-				ca_iostat = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "REC"))
-			{
-				if (ca_rec)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of REC in READ.");
-					return NULL;
-				}
-
-				ca_rec = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-			{
-				if (ca_err)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of ERR in READ.");
-					return NULL;
-				}
-
-				ca_err = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "ADVANCE"))
-			{
-				if (ca_advance)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of ADVANCE in READ.");
-					return NULL;
-				}
-
-				ca_advance = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "END"))
-			{
-				if (ca_end)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of END in READ.");
-					return NULL;
-				}
-
-				ca_end = param;
-			}
-			else if (ofc_str_ref_equal_strz_ci(param->name.string, "SIZE"))
-			{
-				if (ca_size)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Re-definition of SIZE in READ.");
-					return NULL;
-				}
-
-				ca_size = param;
-			}
-			else
-			{
-				ofc_sparse_ref_error(param->src,
-					"Unrecognized paramater %u name '%.*s' in READ.",
-					i, param->name.string.size, param->name.string.base);
-				return NULL;
-			}
-		}
+		if (!ofc_sema_io_spec_resolve(
+			stmt->io_read.params, "READ",
+			ofc_sema_stmt_io_read__spec,
+			OFC_SEMA_STMT_IO_READ__COUNT,
+			ofc_sema_stmt_io_read__positional,
+			OFC_SEMA_STMT_IO_READ__POSITIONAL_COUNT, ca))
+			return NULL;
 
-		if (!ca_unit)
+		if (!ca[OFC_SEMA_STMT_IO_READ__UNIT])
 		{
 			ofc_sparse_ref_error(stmt->src,
 				"No UNIT defined in READ.");
@@ -206,9 +114,20 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_read(
 	}
 	else
 	{
-		ca_format = stmt->io_read.params->call_arg[0];
+		ca[OFC_SEMA_STMT_IO_READ__FMT]
+			= stmt->io_read.params->call_arg[0];
 	}
 
+	ofc_parse_call_arg_t* ca_unit    = ca[OFC_SEMA_STMT_IO_READ__UNIT];
+	ofc_parse_call_arg_t* ca_format  = ca[OFC_SEMA_STMT_IO_READ__FMT];
+	ofc_parse_call_arg_t* ca_iostat  = ca[OFC_SEMA_STMT_IO_READ__IOSTAT];
+	ofc_parse_call_arg_t* ca_rec     = ca[OFC_SEMA_STMT_IO_READ__REC];
+	ofc_parse_call_arg_t* ca_err     = ca[OFC_SEMA_STMT_IO_READ__ERR];
+	ofc_parse_call_arg_t* ca_advance = ca[OFC_SEMA_STMT_IO_READ__ADVANCE];
+	ofc_parse_call_arg_t* ca_end     = ca[OFC_SEMA_STMT_IO_READ__END];
+	ofc_parse_call_arg_t* ca_eor     = NULL;
+	ofc_parse_call_arg_t* ca_size    = ca[OFC_SEMA_STMT_IO_READ__SIZE];
+
 	if (ca_unit && (ca_unit->type == OFC_PARSE_CALL_ARG_ASTERISK))
 	{
 		s.io_read.stdin = true;
@@ -13,8 +13,127 @@
  * limitations under the License.
  */
 
+#include <inttypes.h>
+
 #include "ofc/sema.h"
 
+
+static int ofc_sema_stmt_select_case__interval_compare(
+	const void* a, const void* b)
+{
+	const ofc_sema_range_interval_t* ia
+		= (const ofc_sema_range_interval_t*)a;
+	const ofc_sema_range_interval_t* ib
+		= (const ofc_sema_range_interval_t*)b;
+
+	if (ia->first != ib->first)
+		return (ia->first < ib->first ? -1 : 1);
+	if (ia->last != ib->last)
+		return (ia->last < ib->last ? -1 : 1);
+	if (ia->index != ib->index)
+		return (ia->index < ib->index ? -1 : 1);
+	return 0;
+}
+
+/* Collects the CASE values as sorted intervals, this leaves them
+   empty if any value isn't a known integer or a range is empty
+   since those have to be compared one by one. */
+static bool ofc_sema_stmt_select_case__interval(
+	ofc_sema_stmt_t* stmt)
+{
+	unsigned count = 0;
+	unsigned i;
+	for (i = 0; i < stmt->select_case.count; i++)
+	{
+		if (stmt->select_case.case_value[i])
+			count += stmt->select_case.case_value[i]->count;
+	}
+	if (count == 0)
+		return true;
+
+	ofc_sema_range_interval_t* interval
+		= (ofc_sema_range_interval_t*)malloc(
+			sizeof(ofc_sema_range_interval_t) * count);
+	if (!interval) return false;
+
+	unsigned n = 0;
+	for (i = 0; i < stmt->select_case.count; i++)
+	{
+		const ofc_sema_range_list_t* list
+			= stmt->select_case.case_value[i];
+		if (!list) continue;
+
+		unsigned j;
+		for (j = 0; j < list->count; j++, n++)
+		{
+			if (!ofc_sema_range_interval(list->range[j],
+					&interval[n].first, &interval[n].last)
+				|| (interval[n].first > interval[n].last))
+			{
+				free(interval);
+				return true;
+			}
+			interval[n].index = i;
+		}
+	}
+
+	qsort(interval, count, sizeof(ofc_sema_range_interval_t),
+		ofc_sema_stmt_select_case__interval_compare);
+
+	stmt->select_case.interval_count = count;
+	stmt->select_case.interval       = interval;
+	return true;
+}
+
+/* Sweeps the intervals of the CASEs up to limit in order of their
+   first value, keeping the two furthest reaching CASEs so far so that
+   ranges within the same CASE aren't seen as overlapping. */
+static bool ofc_sema_stmt_select_case__overlaps(
+	const ofc_sema_stmt_t* stmt, unsigned limit)
+{
+	bool     seen[2] = { false, false };
+	int64_t  last[2] = { 0, 0 };
+	unsigned index[2] = { 0, 0 };
+
+	unsigned i;
+	for (i = 0; i < stmt->select_case.interval_count; i++)
+	{
+		const ofc_sema_range_interval_t* interval
+			= &stmt->select_case.interval[i];
+		if (interval->index > limit)
+			continue;
+
+		bool same = (seen[0] && (index[0] == interval->index));
+		unsigned o = (same ? 1 : 0);
+		if (seen[o] && (last[o] >= interval->first))
+			return true;
+
+		if (same)
+		{
+			if (interval->last > last[0])
+				last[0] = interval->last;
+		}
+		else if (!seen[0] || (interval->last > last[0]))
+		{
+			seen[1]  = seen[0];
+			last[1]  = last[0];
+			index[1] = index[0];
+
+			seen[0]  = true;
+			last[0]  = interval->last;
+			index[0] = interval->index;
+		}
+		else if (!seen[1] || (interval->last > last[1]))
+		{
+			seen[1]  = true;
+			last[1]  = interval->last;
+			index[1] = interval->index;
+		}
+	}
+
+	return false;
+}
+
 ofc_sema_stmt_t* ofc_sema_stmt_select_case(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -31,6 +150,9 @@ ofc_sema_stmt_t* ofc_sema_stmt_select_case(
 	s.select_case.case_value = NULL;
 	s.select_case.case_block = NULL;
 
+	s.select_case.interval_count = 0;
+	s.select_case.interval       = NULL;
+
 	s.select_case.case_expr = ofc_sema_expr(
 		scope, stmt->select_case.case_expr);
 	if (!s.select_case.case_expr)
@@ -75,34 +197,39 @@ ofc_sema_stmt_t* ofc_sema_stmt_select_case(
 		return NULL;
 	}
 
-	bool has_default = false;
-	unsigned i;
-	for (i = 0; i < stmt->select_case.count; i++)
+	unsigned count = stmt->select_case.count;
+	if (count > 0)
 	{
-		ofc_sema_range_list_t** nrange
-			= (ofc_sema_range_list_t**)realloc(as->select_case.case_value,
-				(sizeof(ofc_sema_range_list_t*) * (as->select_case.count + 1)));
-		if (!nrange)
+		as->select_case.case_value
+			= (ofc_sema_range_list_t**)malloc(
+				sizeof(ofc_sema_range_list_t*) * count);
+		as->select_case.case_block
+			= (ofc_sema_stmt_list_t**)malloc(
+				sizeof(ofc_sema_stmt_list_t*) * count);
+		if (!as->select_case.case_value
+			|| !as->select_case.case_block)
 		{
+			free(as->select_case.case_value);
+			free(as->select_case.case_block);
+			as->select_case.case_value = NULL;
+			as->select_case.case_block = NULL;
 			ofc_sema_stmt_delete(as);
 			return NULL;
 		}
-		as->select_case.case_value = nrange;
 
-		ofc_sema_stmt_list_t** nblock
-			= (ofc_sema_stmt_list_t**)realloc(as->select_case.case_block,
-				(sizeof(ofc_sema_stmt_list_t*) * (as->select_case.count + 1)));
-		if (!nblock)
+		unsigned i;
+		for (i = 0; i < count; i++)
 		{
-			ofc_sema_stmt_delete(as);
-			return NULL;
+			as->select_case.case_value[i] = NULL;
+			as->select_case.case_block[i] = NULL;
 		}
-		as->select_case.case_block = nblock;
-
-		as->select_case.count++;
+		as->select_case.count = count;
+	}
 
-		as->select_case.case_value[i] = NULL;
-		as->select_case.case_block[i] = NULL;
+	bool has_default = false;
+	unsigned i;
+	for (i = 0; i < count; i++)
+	{
 		bool is_default = true;
 
 		if (stmt->select_case.case_value[i])
@@ -129,80 +256,111 @@ ofc_sema_stmt_t* ofc_sema_stmt_select_case(
 
 		has_default = is_default;
 
-		if (!is_default)
+		if (is_default)
+			continue;
+
+		/* Check that range values are known at compile time. */
+		unsigned j;
+		for (j = 0; j < as->select_case.case_value[i]->count; j++)
 		{
-			/* Check that range values are known at compile time. */
-			unsigned j;
-			for (j = 0; j < as->select_case.case_value[i]->count; j++)
+			if (as->select_case.case_value[i]->range[j]->first
+				&& !ofc_sema_expr_is_constant(
+					as->select_case.case_value[i]->range[j]->first))
+			{
+				ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->first->src,
+					"Range must be constant");
+				ofc_sema_stmt_delete(as);
+				return NULL;
+			}
+			if (as->select_case.case_value[i]->range[j]->last
+				&& !ofc_sema_expr_is_constant(
+					as->select_case.case_value[i]->range[j]->last))
+			{
+				ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->last->src,
+					"Range must be constant");
+				ofc_sema_stmt_delete(as);
+				return NULL;
+			}
+
+			if (!as->select_case.case_value[i]->range[j]->first
+				&& !as->select_case.case_value[i]->range[j]->last)
 			{
-				if (as->select_case.case_value[i]->range[j]->first
-					&& !ofc_sema_expr_is_constant(
-						as->select_case.case_value[i]->range[j]->first))
+				ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->src,
+					"Range can't be empty");
+				ofc_sema_stmt_delete(as);
+				return NULL;
+			}
+
+			/* Check that types are compatible. */
+			const ofc_sema_type_t* type_first = ofc_sema_expr_type(
+					as->select_case.case_value[i]->range[j]->first);
+			const ofc_sema_type_t* type_last  = ofc_sema_expr_type(
+					as->select_case.case_value[i]->range[j]->last);
+
+			if (type_first && !ofc_sema_type_compatible(type, type_first))
+			{
+				ofc_sema_expr_t* cast = ofc_sema_expr_cast(
+					as->select_case.case_value[i]->range[j]->first, type);
+
+				if (!cast)
 				{
 					ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->first->src,
-						"Range must be constant");
-					ofc_sema_stmt_delete(as);
-					return NULL;
-				}
-				if (as->select_case.case_value[i]->range[j]->last
-					&& !ofc_sema_expr_is_constant(
-						as->select_case.case_value[i]->range[j]->last))
-				{
-					ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->last->src,
-						"Range must be constant");
+						"Type of CASE selector value not compatible with case index value");
 					ofc_sema_stmt_delete(as);
 					return NULL;
 				}
 
-				if (!as->select_case.case_value[i]->range[j]->first
-					&& !as->select_case.case_value[i]->range[j]->last)
+				as->select_case.case_value[i]->range[j]->first = cast;
+			}
+
+			if (type_last && !ofc_sema_type_compatible(type, type_last))
+			{
+				ofc_sema_expr_t* cast = ofc_sema_expr_cast(
+					as->select_case.case_value[i]->range[j]->last, type);
+
+				if (!cast)
 				{
-					ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->src,
-						"Range can't be empty");
+					ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->last->src,
+						"Type of CASE selector value not compatible with case index value");
 					ofc_sema_stmt_delete(as);
 					return NULL;
 				}
 
-				/* Check that types are compatible. */
-				const ofc_sema_type_t* type_first = ofc_sema_expr_type(
-						as->select_case.case_value[i]->range[j]->first);
-				const ofc_sema_type_t* type_last  = ofc_sema_expr_type(
-						as->select_case.case_value[i]->range[j]->last);
+				as->select_case.case_value[i]->range[j]->last = cast;
+			}
+		}
+	}
 
-				if (type_first && !ofc_sema_type_compatible(type, type_first))
-				{
-					ofc_sema_expr_t* cast = ofc_sema_expr_cast(
-						as->select_case.case_value[i]->range[j]->first, type);
-
-					if (!cast)
-					{
-						ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->first->src,
-							"Type of CASE selector value not compatible with case index value");
-						ofc_sema_stmt_delete(as);
-						return NULL;
-					}
-
-					as->select_case.case_value[i]->range[j]->first = cast;
-				}
+	if (ofc_sema_type_is_integer(type)
+		&& !ofc_sema_stmt_select_case__interval(as))
+	{
+		ofc_sema_stmt_delete(as);
+		return NULL;
+	}
 
-				if (type_last && !ofc_sema_type_compatible(type, type_last))
-				{
-					ofc_sema_expr_t* cast = ofc_sema_expr_cast(
-						as->select_case.case_value[i]->range[j]->last, type);
-
-					if (!cast)
-					{
-						ofc_sparse_ref_error(as->select_case.case_value[i]->range[j]->last->src,
-							"Type of CASE selector value not compatible with case index value");
-						ofc_sema_stmt_delete(as);
-						return NULL;
-					}
-
-					as->select_case.case_value[i]->range[j]->last = cast;
-				}
+	/* Check that ranges don't overlap, the first CASE which overlaps
+	   a previous one is the first prefix of the CASEs to overlap. */
+	unsigned overlap = count;
+	if (as->select_case.interval_count > 0)
+	{
+		if (ofc_sema_stmt_select_case__overlaps(as, (count - 1)))
+		{
+			unsigned lo = 0, hi = (count - 1);
+			while (lo < hi)
+			{
+				unsigned mid = lo + ((hi - lo) / 2);
+				if (ofc_sema_stmt_select_case__overlaps(as, mid))
+					hi = mid;
+				else
+					lo = mid + 1;
 			}
-
-			/* Check that ranges don't overlap. */
+			overlap = lo;
+		}
+	}
+	else
+	{
+		for (i = 1; (i < count) && (overlap >= count); i++)
+		{
 			unsigned l;
 			for (l = 0; l < i; l++)
 			{
@@ -210,14 +368,17 @@ ofc_sema_stmt_t* ofc_sema_stmt_select_case(
 					as->select_case.case_value[l],
 					as->select_case.case_value[i]))
 				{
-					ofc_sparse_ref_error(as->select_case.case_value[i]->src,
-						"CASE range overlaps previous range");
-					ofc_sema_stmt_delete(as);
-					return NULL;
+					overlap = i;
+					break;
 				}
 			}
 		}
+	}
 
+	/* The CASE blocks before an overlap are analysed first, so that
+	   diagnostics are reported in source order. */
+	for (i = 0; i < overlap; i++)
+	{
 		if (stmt->select_case.case_block[i])
 		{
 			as->select_case.case_block[i]
@@ -231,6 +392,14 @@ ofc_sema_stmt_t* ofc_sema_stmt_select_case(
 		}
 	}
 
+	if (overlap < count)
+	{
+		ofc_sparse_ref_error(as->select_case.case_value[overlap]->src,
+			"CASE range overlaps previous range");
+		ofc_sema_stmt_delete(as);
+		return NULL;
+	}
+
 	if (stmt->select_case.end_select_case_has_label
 		&& !ofc_sema_label_map_add_end_block(
 			scope->label, stmt->select_case.end_select_case_label, as))
@@ -244,6 +413,46 @@ ofc_sema_stmt_t* ofc_sema_stmt_select_case(
 }
 
 
+bool ofc_sema_stmt_select_case_density(
+	const ofc_sema_stmt_t* stmt,
+	uint64_t* values, uint64_t* span)
+{
+	if (!stmt || (stmt->type != OFC_SEMA_STMT_SELECT_CASE)
+		|| (stmt->select_case.interval_count == 0))
+		return false;
+
+	const ofc_sema_range_interval_t* interval
+		= stmt->select_case.interval;
+
+	int64_t first = interval[0].first;
+	int64_t last  = interval[0].last;
+	uint64_t v = 0;
+
+	unsigned i;
+	for (i = 1; i < stmt->select_case.interval_count; i++)
+	{
+		if (interval[i].first > last)
+		{
+			v += ((uint64_t)last - (uint64_t)first) + 1;
+			first = interval[i].first;
+			last  = interval[i].last;
+		}
+		else if (interval[i].last > last)
+		{
+			last = interval[i].last;
+		}
+	}
+	v += ((uint64_t)last - (uint64_t)first) + 1;
+
+	if ((interval[0].first == INT64_MIN)
+		|| (last == INT64_MAX))
+		return false;
+
+	if (values) *values = v;
+	if (span  ) *span   = ((uint64_t)last - (uint64_t)interval[0].first) + 1;
+	return true;
+}
+
 bool ofc_sema_stmt_select_case_print(
 	ofc_colstr_t* cs, unsigned indent,
 	ofc_sema_label_map_t* label_map,
@@ -265,6 +474,22 @@ bool ofc_sema_stmt_select_case_print(
 	if (!ofc_colstr_atomic_writef(cs, ")"))
 		return false;
 
+	const ofc_print_opts_t* print_opts
+		= ofc_colstr_print_opts_get(cs);
+	uint64_t values, span;
+	if (print_opts && print_opts->select_density
+		&& ofc_sema_stmt_select_case_density(stmt, &values, &span))
+	{
+		/* Sparse CASE values are better searched than tabled. */
+		unsigned density = (unsigned)((100.0 * values) / span);
+		if (!ofc_colstr_newline(cs, (indent + 1), NULL)
+			|| !ofc_colstr_atomic_writef(cs,
+				"! CASE values %" PRIu64 "/%" PRIu64 " (%u%%), %s",
+				values, span, density,
+				(density >= 40 ? "jump table" : "binary search")))
+			return false;
+	}
+
 	unsigned i;
 	for (i = 0; i < stmt->select_case.count; i++)
 	{
@@ -83,7 +83,8 @@ bool ofc_sema_stmt_use(
 
 	if (stmt->use.only)
 	{
-		olist = ofc_sema_decl_list_create(false);
+		olist = ofc_sema_decl_list_create(
+			mscope->symbols, false);
 
 		ofc_parse_decl_list_t* only
 			= stmt->use.only;
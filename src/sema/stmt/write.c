@@ -17,6 +17,40 @@
 
 #include "ofc/sema.h"
 
+typedef enum
+{
+	OFC_SEMA_STMT_IO_WRITE__ADVANCE = 0,
+	OFC_SEMA_STMT_IO_WRITE__ERR,
+	OFC_SEMA_STMT_IO_WRITE__FMT,
+	OFC_SEMA_STMT_IO_WRITE__IOSTAT,
+	OFC_SEMA_STMT_IO_WRITE__REC,
+	OFC_SEMA_STMT_IO_WRITE__UNIT,
+
+	OFC_SEMA_STMT_IO_WRITE__COUNT
+} ofc_sema_stmt_io_write__spec_e;
+
+/* Sorted by name for ofc_sema_io_spec_resolve. */
+static const char* const ofc_sema_stmt_io_write__spec[] =
+{
+	[OFC_SEMA_STMT_IO_WRITE__ADVANCE] = "ADVANCE",
+	[OFC_SEMA_STMT_IO_WRITE__ERR]     = "ERR",
+	[OFC_SEMA_STMT_IO_WRITE__FMT]     = "FMT",
+	[OFC_SEMA_STMT_IO_WRITE__IOSTAT]  = "IOSTAT",
+	[OFC_SEMA_STMT_IO_WRITE__REC]     = "REC",
+	[OFC_SEMA_STMT_IO_WRITE__UNIT]    = "UNIT",
+};
+
+static const unsigned ofc_sema_stmt_io_write__positional[] =
+{
+	OFC_SEMA_STMT_IO_WRITE__UNIT,
+	OFC_SEMA_STMT_IO_WRITE__FMT,
+};
+
+#define OFC_SEMA_STMT_IO_WRITE__POSITIONAL_COUNT \
+	(sizeof(ofc_sema_stmt_io_write__positional) \
+		/ sizeof(ofc_sema_stmt_io_write__positional[0]))
+
+
 static void ofc_sema_stmt_io_write__cleanup(
 	ofc_sema_stmt_t s)
 {
@@ -51,119 +85,21 @@ ofc_sema_stmt_t* ofc_sema_stmt_io_write(
 	s.io_write.rec          = NULL;
 	s.io_write.iolist       = NULL;
 
-	ofc_parse_call_arg_t* ca_unit    = NULL;
-	ofc_parse_call_arg_t* ca_format  = NULL;
-	ofc_parse_call_arg_t* ca_iostat  = NULL;
-	ofc_parse_call_arg_t* ca_rec     = NULL;
-	ofc_parse_call_arg_t* ca_err     = NULL;
-	ofc_parse_call_arg_t* ca_advance = NULL;
-
-	unsigned i;
-	for (i = 0; i < stmt->io.params->count; i++)
-	{
-		ofc_parse_call_arg_t* param
-			= stmt->io.params->call_arg[i];
-		if (!param) continue;
-
-		if (ofc_sparse_ref_empty(param->name))
-		{
-			if (i >= 2)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Un-named parameter %u has no meaning in WRITE.", i);
-				return NULL;
-			}
-
-			if (i == 0)
-			{
-				ca_unit = param;
-			}
-			else
-			{
-				if (!ca_unit)
-				{
-					ofc_sparse_ref_error(param->src,
-						"Un-named format parameter only valid after UNIT in WRITE.");
-					return NULL;
-				}
-
-				ca_format = param;
-			}
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "UNIT"))
-		{
-			if (ca_unit)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of UNIT in WRITE.");
-				return NULL;
-			}
-
-			ca_unit = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "FMT"))
-		{
-			if (ca_format)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of FMT in WRITE.");
-				return NULL;
-			}
-
-			ca_format = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "IOSTAT"))
-		{
-			if (ca_iostat)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of IOSTAT in WRITE.");
-				return NULL;
-			}
-
-			ca_iostat = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "REC"))
-		{
-			if (ca_rec)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of REC in WRITE.");
-				return NULL;
-			}
-
-			ca_rec = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ERR"))
-		{
-			if (ca_err)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ERR in WRITE.");
-				return NULL;
-			}
-
-			ca_err = param;
-		}
-		else if (ofc_str_ref_equal_strz_ci(param->name.string, "ADVANCE"))
-		{
-			if (ca_advance)
-			{
-				ofc_sparse_ref_error(param->src,
-					"Re-definition of ADVANCE in WRITE.");
-				return NULL;
-			}
+	ofc_parse_call_arg_t* ca[OFC_SEMA_STMT_IO_WRITE__COUNT];
+	if (!ofc_sema_io_spec_resolve(
+		stmt->io.params, "WRITE",
+		ofc_sema_stmt_io_write__spec,
+		OFC_SEMA_STMT_IO_WRITE__COUNT,
+		ofc_sema_stmt_io_write__positional,
+		OFC_SEMA_STMT_IO_WRITE__POSITIONAL_COUNT, ca))
+		return NULL;
 
-			ca_advance = param;
-		}
-		else
-		{
-			ofc_sparse_ref_error(param->src,
-				"Unrecognized paramater %u name '%.*s' in WRITE.",
-				i, param->name.string.size, param->name.string.base);
-			return NULL;
-		}
-	}
+	ofc_parse_call_arg_t* ca_unit    = ca[OFC_SEMA_STMT_IO_WRITE__UNIT];
+	ofc_parse_call_arg_t* ca_format  = ca[OFC_SEMA_STMT_IO_WRITE__FMT];
+	ofc_parse_call_arg_t* ca_iostat  = ca[OFC_SEMA_STMT_IO_WRITE__IOSTAT];
+	ofc_parse_call_arg_t* ca_rec     = ca[OFC_SEMA_STMT_IO_WRITE__REC];
+	ofc_parse_call_arg_t* ca_err     = ca[OFC_SEMA_STMT_IO_WRITE__ERR];
+	ofc_parse_call_arg_t* ca_advance = ca[OFC_SEMA_STMT_IO_WRITE__ADVANCE];
 
 	if (!ca_unit)
 	{
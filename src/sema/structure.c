@@ -14,6 +14,12 @@
  */
 
 #include "ofc/sema.h"
+#include "ofc/vector.h"
+
+
+OFC_VECTOR_DEFINE(ofc_sema_structure__member_vector, ofc_sema_structure_member_t*)
+OFC_VECTOR_DEFINE(ofc_sema_structure__decl_vector, ofc_sema_decl_t*)
+OFC_VECTOR_DEFINE(ofc_sema_structure_list__vector, ofc_sema_structure_t*)
 
 
 static const ofc_str_ref_t* ofc_structure__member_name(
@@ -27,6 +33,199 @@ static const ofc_str_ref_t* ofc_structure__member_name(
 }
 
 
+static bool ofc_sema_structure__member_anon(
+	ofc_sema_structure_member_t* member)
+{
+	if (!member || !member->is_structure)
+		return false;
+	return ofc_sparse_ref_empty(
+		member->structure->name);
+}
+
+
+typedef struct
+{
+	const ofc_sema_decl_t* decl;
+	unsigned               offset;
+} ofc_sema_structure__decl_offset_t;
+
+struct ofc_sema_structure_table_s
+{
+	/* Element offset just past each member as elem_get walks them,
+	   only up to the first member that can't be counted. The members
+	   of a union overlap, so for a union this is each member's count. */
+	unsigned  elem_members;
+	unsigned* elem_end;
+
+	bool      elem_count_valid;
+	unsigned  elem_count;
+
+	/* Members flattened through anonymous nested structures,
+	   a named nested structure takes a NULL slot. */
+	unsigned          member_count;
+	unsigned          member_size;
+	ofc_sema_decl_t** member;
+
+	/* Flattened member decls sorted by address. */
+	unsigned                           decl_count;
+	ofc_sema_structure__decl_offset_t* decl;
+};
+
+static void ofc_sema_structure__table_delete(
+	ofc_sema_structure_table_t* table)
+{
+	if (!table)
+		return;
+
+	free(table->elem_end);
+	free(table->member);
+	free(table->decl);
+	free(table);
+}
+
+static bool ofc_sema_structure__table_flatten(
+	ofc_sema_structure_table_t* table,
+	const ofc_sema_structure_t* structure)
+{
+	unsigned i;
+	for (i = 0; i < structure->count; i++)
+	{
+		ofc_sema_structure_member_t* member
+			= structure->member[i];
+
+		if (ofc_sema_structure__member_anon(member))
+		{
+			if (!ofc_sema_structure__table_flatten(
+				table, member->structure))
+				return false;
+			continue;
+		}
+
+		if (!ofc_sema_structure__decl_vector_reserve(
+			&table->member, table->member_count,
+			&table->member_size, 1))
+			return false;
+
+		table->member[table->member_count++]
+			= (member->is_structure ? NULL : member->decl);
+	}
+
+	return true;
+}
+
+static int ofc_sema_structure__decl_offset_compare(
+	const ofc_sema_structure__decl_offset_t* a,
+	const ofc_sema_structure__decl_offset_t* b)
+{
+	if (a->decl != b->decl)
+		return ((uintptr_t)a->decl < (uintptr_t)b->decl ? -1 : 1);
+	if (a->offset != b->offset)
+		return (a->offset < b->offset ? -1 : 1);
+	return 0;
+}
+
+static ofc_sema_structure_table_t* ofc_sema_structure__table(
+	const ofc_sema_structure_t* structure)
+{
+	ofc_sema_structure_table_t* table
+		= (ofc_sema_structure_table_t*)malloc(
+			sizeof(ofc_sema_structure_table_t));
+	if (!table) return NULL;
+
+	table->elem_members     = structure->count;
+	table->elem_end         = NULL;
+	table->elem_count_valid = true;
+	table->elem_count       = 0;
+
+	table->member_count = 0;
+	table->member_size  = 0;
+	table->member       = NULL;
+
+	table->decl_count = 0;
+	table->decl       = NULL;
+
+	if (structure->count > 0)
+	{
+		table->elem_end = (unsigned*)malloc(
+			sizeof(unsigned) * structure->count);
+		if (!table->elem_end)
+		{
+			ofc_sema_structure__table_delete(table);
+			return NULL;
+		}
+	}
+
+	bool is_union = ofc_sema_structure_is_union(structure);
+
+	unsigned ucount = 0;
+	unsigned scount = 0;
+	unsigned i, o;
+	for (i = 0, o = 0; i < structure->count; i++)
+	{
+		ofc_sema_structure_member_t* member
+			= structure->member[i];
+
+		unsigned mcount;
+		if (member->is_structure
+			? !ofc_sema_structure_elem_count(
+				member->structure, &mcount)
+			: !ofc_sema_decl_elem_count(
+				member->decl, &mcount))
+		{
+			table->elem_count_valid = false;
+			if (table->elem_members > i)
+				table->elem_members = i;
+			continue;
+		}
+
+		if (mcount > ucount)
+			ucount = mcount;
+		scount += mcount;
+
+		if (i < table->elem_members)
+		{
+			o += mcount;
+			table->elem_end[i] = (is_union ? mcount : o);
+		}
+	}
+
+	table->elem_count = (is_union ? ucount : scount);
+
+	if (!ofc_sema_structure__table_flatten(table, structure))
+	{
+		ofc_sema_structure__table_delete(table);
+		return NULL;
+	}
+
+	if (table->member_count > 0)
+	{
+		table->decl = (ofc_sema_structure__decl_offset_t*)malloc(
+			sizeof(ofc_sema_structure__decl_offset_t) * table->member_count);
+		if (!table->decl)
+		{
+			ofc_sema_structure__table_delete(table);
+			return NULL;
+		}
+
+		for (i = 0; i < table->member_count; i++)
+		{
+			if (!table->member[i])
+				continue;
+
+			table->decl[table->decl_count].decl   = table->member[i];
+			table->decl[table->decl_count].offset = i;
+			table->decl_count++;
+		}
+
+		qsort(table->decl, table->decl_count,
+			sizeof(ofc_sema_structure__decl_offset_t),
+			(void*)ofc_sema_structure__decl_offset_compare);
+	}
+
+	return table;
+}
+
+
 static ofc_sema_structure_t* ofc_sema__structure(
 	ofc_sema_scope_t* scope,
 	const ofc_parse_stmt_t* stmt)
@@ -96,8 +295,11 @@ static ofc_sema_structure_t* ofc_sema__structure(
 	}
 
 	structure->count  = 0;
+	structure->size   = 0;
 	structure->member = NULL;
 
+	structure->table = NULL;
+
 	structure->refcnt = 0;
 
 	if (stmt->structure.block)
@@ -168,6 +370,14 @@ static ofc_sema_structure_t* ofc_sema__structure(
 		}
 	}
 
+	structure->table
+		= ofc_sema_structure__table(structure);
+	if (!structure->table)
+	{
+		ofc_sema_structure_delete(structure);
+		return NULL;
+	}
+
 	return structure;
 }
 
@@ -251,6 +461,9 @@ void ofc_sema_structure_delete(
 
 	ofc_hashmap_delete(structure->map);
 
+	ofc_sema_structure__table_delete(
+		structure->table);
+
 	unsigned i;
 	for (i = 0; i < structure->count; i++)
 	{
@@ -263,15 +476,6 @@ void ofc_sema_structure_delete(
 }
 
 
-static bool ofc_sema_structure__member_anon(
-	ofc_sema_structure_member_t* member)
-{
-	if (!member || !member->is_structure)
-		return false;
-	return ofc_sparse_ref_empty(
-		member->structure->name);
-}
-
 static bool ofc_sema_structure__member_add(
 	ofc_sema_structure_t*        structure,
 	ofc_sema_structure_member_t* member)
@@ -296,11 +500,9 @@ static bool ofc_sema_structure__member_add(
 		}
 	}
 
-	ofc_sema_structure_member_t** nmember
-		= (ofc_sema_structure_member_t**)realloc(structure->member,
-			(sizeof(ofc_sema_structure_member_t*) * (structure->count + 1)));
-	if (!nmember) return false;
-	structure->member = nmember;
+	if (!ofc_sema_structure__member_vector_reserve(
+		&structure->member, structure->count, &structure->size, 1))
+		return false;
 
 	if (!anon && !ofc_hashmap_add(
 		structure->map, member))
@@ -347,8 +549,9 @@ ofc_sema_decl_t* ofc_sema_structure_decl_find_create(
 			structure, name.string);
 	if (decl) return decl;
 
+	/* Members are found by name within their structure. */
 	decl = ofc_sema_decl_create(
-		structure->implicit, name);
+		NULL, structure->implicit, name);
 	if (!decl) return NULL;
 
 	if (!ofc_sema_structure__member_add_decl(
@@ -391,24 +594,11 @@ bool ofc_sema_structure_member_count(
 	const ofc_sema_structure_t* structure,
 	unsigned* count)
 {
-	if (!structure)
+	if (!structure
+		|| !structure->table)
 		return false;
 
-	unsigned i, c;
-	for (i = 0, c = 0; i < structure->count; i++)
-	{
-		unsigned rc = 1;
-		if (ofc_sema_structure__member_anon(
-			structure->member[i]))
-		{
-			if (!ofc_sema_structure_member_count(
-				structure->member[i]->structure, &rc))
-				return false;
-		}
-		c += rc;
-	}
-
-	if (count) *count = c;
+	if (count) *count = structure->table->member_count;
 	return true;
 }
 
@@ -417,38 +607,12 @@ ofc_sema_decl_t* ofc_sema_structure_member_get_decl_offset(
 	unsigned offset)
 {
 	if (!structure
-		|| !structure->member)
+		|| !structure->table)
 		return NULL;
 
-	unsigned i, o;
-	for (i = 0, o = offset; i < structure->count; i++)
-	{
-		if (ofc_sema_structure__member_anon(
-			structure->member[i]))
-		{
-			unsigned count;
-			if (!ofc_sema_structure_member_count(
-				structure->member[i]->structure, &count))
-				return NULL;
-
-			if (o < count)
-				return ofc_sema_structure_member_get_decl_offset(
-					structure, o);
-			o -= count;
-		}
-		else
-		{
-			if (o == 0)
-			{
-				if (structure->member[i]->is_structure)
-					return NULL;
-				return structure->member[i]->decl;
-			}
-			o -= 1;
-		}
-	}
-
-	return NULL;
+	if (offset >= structure->table->member_count)
+		return NULL;
+	return structure->table->member[offset];
 }
 
 ofc_sema_decl_t* ofc_sema_structure_member_get_decl_name(
@@ -490,47 +654,31 @@ bool ofc_sema_structure_member_offset(
 	const ofc_sema_decl_t* member,
 	unsigned* offset)
 {
-	if (!structure || !member)
+	if (!structure || !member
+		|| !structure->table)
 		return false;
 
-	unsigned i, o;
-	for (i = 0, o = 0; i < structure->count; i++)
-	{
-		if (!structure->member[i]->is_structure)
-		{
-            if (structure->member[i]->decl == member)
-			{
-				if (offset) *offset = o;
-				return true;
-			}
-			o++;
-		}
-		else if (ofc_sema_structure__member_anon(
-			structure->member[i]))
-		{
-			unsigned ao;
-			if (ofc_sema_structure_member_offset(
-				structure->member[i]->structure, member, &ao))
-			{
-				if (offset) *offset = (o + ao);
-				return true;
-			}
+	const ofc_sema_structure_table_t* table
+		= structure->table;
 
-			unsigned ac;
-			if (!ofc_sema_structure_member_count(
-				structure->member[i]->structure, &ac))
-				return false;
-			o += ac;
-		}
+	/* Find the first entry for member, in case it appears twice. */
+	unsigned lo = 0, hi = table->decl_count;
+	while (lo < hi)
+	{
+		unsigned mid = lo + ((hi - lo) / 2);
+		if ((uintptr_t)table->decl[mid].decl < (uintptr_t)member)
+			lo = mid + 1;
 		else
-		{
-			o++;
-		}
+			hi = mid;
 	}
 
-	return false;
-}
+	if ((lo >= table->decl_count)
+		|| (table->decl[lo].decl != member))
+		return false;
 
+	if (offset) *offset = table->decl[lo].offset;
+	return true;
+}
 
 bool ofc_sema_structure_is_union(
 	const ofc_sema_structure_t* structure)
@@ -632,76 +780,120 @@ bool ofc_sema_structure_elem_count(
 	const ofc_sema_structure_t* structure,
 	unsigned* count)
 {
-	if (!structure)
+	if (!structure
+		|| !structure->table
+		|| !structure->table->elem_count_valid)
 		return false;
 
-	unsigned ucount = 0;
-	unsigned scount = 0;
-	unsigned i;
-	for (i = 0; i < structure->count; i++)
+	if (count) *count = structure->table->elem_count;
+	return true;
+}
+
+/* Finds the member holding the element at offset, and makes
+   offset relative to that member. */
+static ofc_sema_structure_member_t* ofc_sema_structure__elem_member(
+	const ofc_sema_structure_t* structure,
+	unsigned* offset)
+{
+	if (!structure
+		|| !structure->table)
+		return NULL;
+
+	const ofc_sema_structure_table_t* table
+		= structure->table;
+
+	/* Every member of a union starts at its first element,
+	   the first which is large enough holds the offset. */
+	if (ofc_sema_structure_is_union(structure))
 	{
-		unsigned mcount;
-		if (structure->member[i]->is_structure)
-		{
-			if (!ofc_sema_structure_elem_count(
-				structure->member[i]->structure, &mcount))
-				return false;
-		}
-		else
+		unsigned i;
+		for (i = 0; i < table->elem_members; i++)
 		{
-			if (!ofc_sema_decl_elem_count(
-				structure->member[i]->decl, &mcount))
-				return false;
+			if (table->elem_end[i] > *offset)
+				return structure->member[i];
 		}
-
-		if (mcount > ucount)
-			ucount = mcount;
-		scount += mcount;
+		return NULL;
 	}
 
-	if (count)
+	unsigned lo = 0, hi = table->elem_members;
+	while (lo < hi)
 	{
-		if (ofc_sema_structure_is_union(structure))
-			*count = ucount;
+		unsigned mid = lo + ((hi - lo) / 2);
+		if (table->elem_end[mid] > *offset)
+			hi = mid;
 		else
-			*count = scount;
+			lo = mid + 1;
 	}
 
-	return true;
+	if (lo >= table->elem_members)
+		return NULL;
+
+	if (lo > 0)
+		*offset -= table->elem_end[lo - 1];
+	return structure->member[lo];
+}
+
+ofc_sema_decl_t* ofc_sema_structure_elem_member(
+	ofc_sema_structure_t* structure,
+	unsigned* offset)
+{
+	if (!offset)
+		return NULL;
+
+	ofc_sema_structure_member_t* member
+		= ofc_sema_structure__elem_member(
+			structure, offset);
+	if (!member) return NULL;
+
+	if (member->is_structure)
+		return ofc_sema_structure_elem_member(
+			member->structure, offset);
+	return member->decl;
 }
 
 ofc_sema_decl_t* ofc_sema_structure_elem_get(
 	ofc_sema_structure_t* structure,
 	unsigned offset)
 {
-	if (!structure)
-		return NULL;
+	return ofc_sema_structure_elem_member(
+		structure, &offset);
+}
 
-	unsigned i, o;
-	for (i = 0, o = 0; i < structure->count; i++)
+bool ofc_sema_structure_member_elem_offset(
+	const ofc_sema_structure_t* structure,
+	const ofc_sema_decl_t* member,
+	unsigned* offset)
+{
+	if (!structure || !member
+		|| !structure->table)
+		return false;
+
+	const ofc_sema_structure_table_t* table
+		= structure->table;
+	bool is_union = ofc_sema_structure_is_union(structure);
+
+	unsigned i;
+	for (i = 0; i < table->elem_members; i++)
 	{
-		if (structure->member[i]->is_structure)
-		{
-			unsigned sc;
-			if (!ofc_sema_structure_elem_count(
-				structure->member[i]->structure, &sc))
-				return NULL;
+		ofc_sema_structure_member_t* m
+			= structure->member[i];
+
+		unsigned moffset = 0;
+		if (m->is_structure
+			? (!ofc_sema_structure__member_anon(m)
+				|| !ofc_sema_structure_member_elem_offset(
+					m->structure, member, &moffset))
+			: (m->decl != member))
+			continue;
 
-			if ((offset - o) < sc)
-				return ofc_sema_structure_elem_get(
-					structure->member[i]->structure, (offset - o));
+		if (!is_union && (i > 0))
+			moffset += table->elem_end[i - 1];
 
-			o += sc;
-		}
-		else
-		{
-			if (o == offset)
-				return structure->member[i]->decl;
-			o++;
-		}
+		if (offset) *offset = moffset;
+		return true;
 	}
 
-	return NULL;
+	return false;
 }
 
 bool ofc_sema_structure_elem_print(
@@ -712,6 +904,16 @@ bool ofc_sema_structure_elem_print(
 	if (!structure)
 		return false;
 
+	ofc_sema_structure_member_t* member
+		= ofc_sema_structure__elem_member(
+			structure, &offset);
+	if (!member) return false;
+
+	/* Anonymous members are printed as if they were flattened. */
+	if (ofc_sema_structure__member_anon(member))
+		return ofc_sema_structure_elem_print(
+			cs, member->structure, offset);
+
 	char msym = '%';
 
 	if (!ofc_sema_structure_is_derived_type(structure))
@@ -720,40 +922,42 @@ bool ofc_sema_structure_elem_print(
 	if (!ofc_colstr_atomic_writef(cs, "%c", msym))
 		return false;
 
-	unsigned i, o;
-	for (i = 0, o = 0; i < structure->count; i++)
+	if (member->is_structure)
 	{
-		if (structure->member[i]->is_structure)
-		{
-			unsigned sc;
-			if (!ofc_sema_structure_elem_count(
-				structure->member[i]->structure, &sc))
-				return NULL;
+		if (!ofc_sema_structure_print_name(
+			cs, member->structure))
+			return false;
+		return ofc_sema_structure_elem_print(
+			cs, member->structure, offset);
+	}
 
-			if ((offset - o) < sc)
-			{
-				if (!ofc_sema_structure_print_name(
-					cs, structure->member[i]->structure))
-					return false;
-				return ofc_sema_structure_elem_print(
-					cs, structure->member[i]->structure, (offset - o));
-			}
+	const ofc_sema_decl_t* decl = member->decl;
+	if (!ofc_sema_decl_print_name(cs, decl))
+		return false;
 
-			o += sc;
-		}
-		else
-		{
-			if (o == offset)
-				return ofc_sema_decl_print_name(
-					cs, structure->member[i]->decl);
-			o++;
-		}
+	unsigned scount = 1;
+	if (decl->structure
+		&& (!ofc_sema_structure_elem_count(
+			decl->structure, &scount)
+			|| (scount == 0)))
+		return false;
+
+	if (ofc_sema_decl_is_array(decl))
+	{
+		ofc_sema_array_index_t* index
+			= ofc_sema_array_index_from_offset(
+				decl, (offset / scount));
+		bool printed = (index && ofc_sema_array_index_print(cs, index));
+		ofc_sema_array_index_delete(index);
+		if (!printed) return false;
 	}
 
-	return false;
+	if (decl->structure)
+		return ofc_sema_structure_elem_print(
+			cs, decl->structure, (offset % scount));
+	return true;
 }
 
-
 bool ofc_sema_structure_print_name(
 	ofc_colstr_t* cs,
 	const ofc_sema_structure_t* structure)
@@ -916,9 +1120,10 @@ ofc_sema_structure_list_t* ofc_sema_structure_list_create(
 		return NULL;
 	}
 
-	list->count = 0;
-	list->size  = 0;
-	list->structure = NULL;
+	list->count      = 0;
+	list->size       = 0;
+	list->hole_count = 0;
+	list->structure  = NULL;
 
 	return list;
 }
@@ -932,7 +1137,7 @@ void ofc_sema_structure_list_delete(
 	ofc_hashmap_delete(list->map);
 
 	unsigned i;
-	for (i = 0; i < list->size; i++)
+	for (i = 0; i < list->count; i++)
 	{
 		ofc_sema_structure_delete(
 			list->structure[i]);
@@ -954,41 +1159,31 @@ bool ofc_sema_structure_list_add(
 		list, structure->name.string))
 		return false;
 
-	unsigned slot;
-	if (list->count >= list->size)
-	{
-		unsigned nsize = (list->count + 1);
-		ofc_sema_structure_t** nstructure
-			= (ofc_sema_structure_t**)realloc(list->structure,
-				(sizeof(ofc_sema_structure_t*) * nsize));
-		if (!nstructure) return false;
-		list->structure = nstructure;
-
-		slot = list->count;
-		list->structure[slot] = NULL;
-		list->size = nsize;
-	}
-	else
+	/* Reuse the first emptied slot. */
+	unsigned slot = list->count;
+	if (list->hole_count > 0)
 	{
-		unsigned i;
-		for (i = 0; i < list->size; i++)
+		for (slot = 0; slot < list->count; slot++)
 		{
-			if (!list->structure[i])
-			{
-				slot = i;
+			if (!list->structure[slot])
 				break;
-			}
 		}
-		if (i >= list->size)
-			return false;
 	}
 
+	if ((slot >= list->count)
+		&& !ofc_sema_structure_list__vector_reserve(
+			&list->structure, list->count, &list->size, 1))
+		return false;
+
 	if (!ofc_hashmap_add(
 		list->map, structure))
 		return false;
 
 	list->structure[slot] = structure;
-	list->count++;
+	if (slot >= list->count)
+		list->count++;
+	else
+		list->hole_count--;
 	return true;
 }
 
@@ -1003,12 +1198,12 @@ void ofc_sema_structure_list_remove(
 		list->map, structure);
 
 	unsigned i;
-	for (i = 0; i < list->size; i++)
+	for (i = 0; i < list->count; i++)
 	{
 		if (list->structure[i] == structure)
 		{
 			list->structure[i] = NULL;
-			list->count--;
+			list->hole_count++;
 		}
 	}
 }
@@ -1037,7 +1232,7 @@ bool ofc_sema_structure_list_print(
 		return false;
 
 	unsigned i;
-	for (i = 0; i < list->size; i++)
+	for (i = 0; i < list->count; i++)
 	{
 		if (list->structure[i]
 			&& !ofc_sema_structure_print(
@@ -1056,7 +1251,7 @@ bool ofc_sema_structure_list_foreach(
 		return false;
 
 	unsigned i;
-	for (i = 0; i < list->size; i++)
+	for (i = 0; i < list->count; i++)
 	{
 		if (list->structure[i]
 			&& !func(list->structure[i], param))
@@ -1074,7 +1269,7 @@ bool ofc_sema_structure_list_foreach_expr(
 		return false;
 
 	unsigned i;
-	for (i = 0; i < list->size; i++)
+	for (i = 0; i < list->count; i++)
 	{
 		if (list->structure[i]
 			&& !ofc_sema_structure_foreach_expr(
@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
 #include <string.h>
 
 #include "ofc/sema.h"
@@ -105,7 +106,12 @@ ofc_sema_kind_e ofc_sema_type_get_kind(
 }
 
 
-static ofc_hashmap_t* ofc_sema_type__map = NULL;
+/* Types are interned process wide and may be created by several
+   threads at once, lookups take a shared lock and only creating a
+   new type takes the exclusive lock. */
+static ofc_hashmap_t*   ofc_sema_type__map      = NULL;
+static pthread_once_t   ofc_sema_type__map_once = PTHREAD_ONCE_INIT;
+static pthread_rwlock_t ofc_sema_type__map_lock = PTHREAD_RWLOCK_INITIALIZER;
 
 static const char* ofc_sema_type__name[] =
 {
@@ -185,36 +191,37 @@ static void ofc_sema_type__delete(ofc_sema_type_t* type)
 	free(type);
 }
 
-uint8_t ofc_sema_type_hash(
+uint32_t ofc_sema_type_hash(
 	const ofc_sema_type_t* type)
 {
 	if (!type)
 		return 0;
 
-	uint8_t hash = type->type;
+	uintmax_t hash = type->type;
 
 	switch (type->type)
 	{
 		case OFC_SEMA_TYPE_POINTER:
-			hash += ofc_sema_type_hash(
+			hash = (hash << 32) | ofc_sema_type_hash(
 				type->subtype);
 			break;
 
 		case OFC_SEMA_TYPE_CHARACTER:
-			hash += type->kind + type->len;
+			hash = (hash << 8) | type->kind;
+			hash = (hash << 32) | type->len;
 			break;
 
 		case OFC_SEMA_TYPE_FUNCTION:
-			hash += ofc_sema_type_hash(
+			hash = (hash << 32) | ofc_sema_type_hash(
 				type->subtype);
 			break;
 
 		default:
-			hash += type->kind;
+			hash = (hash << 8) | type->kind;
 			break;
 	}
 
-	return hash;
+	return ofc_hashmap_hash_uint(hash);
 }
 
 static const ofc_sema_type_t* ofc_sema_type__key(
@@ -228,6 +235,17 @@ static void ofc_sema_type__map_cleanup(void)
 	ofc_hashmap_delete(ofc_sema_type__map);
 }
 
+static void ofc_sema_type__map_init(void)
+{
+	ofc_sema_type__map = ofc_hashmap_create(
+		(void*)ofc_sema_type_hash,
+		(void*)ofc_sema_type_compare,
+		(void*)ofc_sema_type__key,
+		(void*)ofc_sema_type__delete);
+	if (ofc_sema_type__map)
+		atexit(ofc_sema_type__map_cleanup);
+}
+
 static const ofc_sema_type_t* ofc_sema_type__create(
 	ofc_sema_type_e type,
 	ofc_sema_kind_e kind, unsigned len, bool len_var,
@@ -265,18 +283,10 @@ static const ofc_sema_type_t* ofc_sema_type__create(
 			break;
 	}
 
+	pthread_once(&ofc_sema_type__map_once,
+		ofc_sema_type__map_init);
 	if (!ofc_sema_type__map)
-	{
-		ofc_sema_type__map = ofc_hashmap_create(
-			(void*)ofc_sema_type_hash,
-			(void*)ofc_sema_type_compare,
-			(void*)ofc_sema_type__key,
-			(void*)ofc_sema_type__delete);
-		if (!ofc_sema_type__map)
-			return NULL;
-
-		atexit(ofc_sema_type__map_cleanup);
-	}
+		return NULL;
 
 	ofc_sema_type_t stype =
 		{
@@ -309,24 +319,39 @@ static const ofc_sema_type_t* ofc_sema_type__create(
 		}
 	}
 
+	pthread_rwlock_rdlock(&ofc_sema_type__map_lock);
 	const ofc_sema_type_t* gtype
 		= ofc_hashmap_find(
 			ofc_sema_type__map, &stype);
+	pthread_rwlock_unlock(&ofc_sema_type__map_lock);
 	if (gtype) return gtype;
 
+	pthread_rwlock_wrlock(&ofc_sema_type__map_lock);
+
+	/* Another thread may have created it while we weren't locked. */
+	gtype = ofc_hashmap_find(
+		ofc_sema_type__map, &stype);
+	if (gtype)
+	{
+		pthread_rwlock_unlock(&ofc_sema_type__map_lock);
+		return gtype;
+	}
+
 	ofc_sema_type_t* ntype
 		= (ofc_sema_type_t*)malloc(
 			sizeof(ofc_sema_type_t));
-	if (!ntype) return NULL;
-	*ntype = stype;
-
-	if (!ofc_hashmap_add(
-		ofc_sema_type__map, ntype))
+	if (ntype)
 	{
-		ofc_sema_type__delete(ntype);
-		return NULL;
+		*ntype = stype;
+		if (!ofc_hashmap_add(
+			ofc_sema_type__map, ntype))
+		{
+			ofc_sema_type__delete(ntype);
+			ntype = NULL;
+		}
 	}
 
+	pthread_rwlock_unlock(&ofc_sema_type__map_lock);
 	return ntype;
 }
 
@@ -728,145 +753,175 @@ const ofc_sema_type_t* ofc_sema_type_logical_default(void)
 {
 	static const ofc_sema_type_t* logical = NULL;
 
-	if (!logical)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&logical, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
-		logical = ofc_sema_type_create_primitive(
+		cached = ofc_sema_type_create_primitive(
 			OFC_SEMA_TYPE_LOGICAL,
 			OFC_SEMA_KIND_DEFAULT);
+		__atomic_store_n(&logical, cached, __ATOMIC_RELEASE);
 	}
 
-	return logical;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_integer_default(void)
 {
 	static const ofc_sema_type_t* integer = NULL;
 
-	if (!integer)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&integer, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
-		integer = ofc_sema_type_create_primitive(
+		cached = ofc_sema_type_create_primitive(
 			OFC_SEMA_TYPE_INTEGER,
 			OFC_SEMA_KIND_DEFAULT);
+		__atomic_store_n(&integer, cached, __ATOMIC_RELEASE);
 	}
 
-	return integer;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_real_default(void)
 {
 	static const ofc_sema_type_t* real = NULL;
 
-	if (!real)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&real, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
-		real = ofc_sema_type_create_primitive(
+		cached = ofc_sema_type_create_primitive(
 			OFC_SEMA_TYPE_REAL,
 			OFC_SEMA_KIND_DEFAULT);
+		__atomic_store_n(&real, cached, __ATOMIC_RELEASE);
 	}
 
-	return real;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_double_default(void)
 {
 	static const ofc_sema_type_t* dbl = NULL;
 
-	if (!dbl)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&dbl, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
 		const ofc_sema_type_t* real
 			= ofc_sema_type_real_default();
 		if (!real) return NULL;
 
-		dbl = ofc_sema_type_create_primitive(
+		cached = ofc_sema_type_create_primitive(
 			OFC_SEMA_TYPE_REAL,
 			OFC_SEMA_KIND_DOUBLE);
+		__atomic_store_n(&dbl, cached, __ATOMIC_RELEASE);
 	}
 
-	return dbl;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_complex_default(void)
 {
 	static const ofc_sema_type_t* complex = NULL;
 
-	if (!complex)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&complex, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
-		complex = ofc_sema_type_create_primitive(
+		cached = ofc_sema_type_create_primitive(
 			OFC_SEMA_TYPE_COMPLEX,
 			OFC_SEMA_KIND_DEFAULT);
+		__atomic_store_n(&complex, cached, __ATOMIC_RELEASE);
 	}
 
-	return complex;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_double_complex_default(void)
 {
 	static const ofc_sema_type_t* dbl_complex = NULL;
 
-	if (!dbl_complex)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&dbl_complex, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
 		const ofc_sema_type_t* real
 			= ofc_sema_type_real_default();
 		if (!real) return NULL;
 
-		dbl_complex = ofc_sema_type_create_primitive(
+		cached = ofc_sema_type_create_primitive(
 			OFC_SEMA_TYPE_COMPLEX,
 			OFC_SEMA_KIND_DOUBLE);
+		__atomic_store_n(&dbl_complex, cached, __ATOMIC_RELEASE);
 	}
 
-	return dbl_complex;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_byte_default(void)
 {
 	static const ofc_sema_type_t* byte = NULL;
 
-	if (!byte)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&byte, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
-		byte = ofc_sema_type_create_primitive(
+		cached = ofc_sema_type_create_primitive(
 			OFC_SEMA_TYPE_BYTE,
 			OFC_SEMA_KIND_DEFAULT);
+		__atomic_store_n(&byte, cached, __ATOMIC_RELEASE);
 	}
 
-	return byte;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_subroutine(void)
 {
 	static const ofc_sema_type_t* subroutine = NULL;
 
-	if (!subroutine)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&subroutine, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
-		subroutine = ofc_sema_type__create(
+		cached = ofc_sema_type__create(
 			OFC_SEMA_TYPE_SUBROUTINE, OFC_SEMA_KIND_NONE, 0, false, NULL);
+		__atomic_store_n(&subroutine, cached, __ATOMIC_RELEASE);
 	}
 
-	return subroutine;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_type(void)
 {
 	static const ofc_sema_type_t* type = NULL;
 
-	if (!type)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&type, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
-		type = ofc_sema_type__create(
+		cached = ofc_sema_type__create(
 			OFC_SEMA_TYPE_TYPE, OFC_SEMA_KIND_NONE, 0, false, NULL);
+		__atomic_store_n(&type, cached, __ATOMIC_RELEASE);
 	}
 
-	return type;
+	return cached;
 }
 
 const ofc_sema_type_t* ofc_sema_type_record(void)
 {
 	static const ofc_sema_type_t* type = NULL;
 
-	if (!type)
+	const ofc_sema_type_t* cached
+		= __atomic_load_n(&type, __ATOMIC_ACQUIRE);
+	if (!cached)
 	{
-		type = ofc_sema_type__create(
+		cached = ofc_sema_type__create(
 			OFC_SEMA_TYPE_RECORD, OFC_SEMA_KIND_NONE, 0, false, NULL);
+		__atomic_store_n(&type, cached, __ATOMIC_RELEASE);
 	}
 
-	return type;
+	return cached;
 }
 
 
@@ -33,7 +33,7 @@ static ofc_sema_typeval_t* NO_OPT ofc_sema_typeval__alloc(
 	const ofc_sema_typeval_t typeval)
 {
 	ofc_sema_typeval_t* alloc_typeval =
-		(ofc_sema_typeval_t*)malloc(sizeof(ofc_sema_typeval_t));
+		(ofc_sema_typeval_t*)ofc_arena_node_alloc(sizeof(ofc_sema_typeval_t));
 
 	if (!alloc_typeval) return NULL;
 
@@ -799,7 +799,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_integer(
 	if (!type) return NULL;
 
 	ofc_sema_typeval_t* typeval
-		= (ofc_sema_typeval_t*)malloc(
+		= (ofc_sema_typeval_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_typeval_t));
 	if (!typeval) return NULL;
 
@@ -829,7 +829,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_logical(
 	if (!type) return NULL;
 
 	ofc_sema_typeval_t* typeval
-		= (ofc_sema_typeval_t*)malloc(
+		= (ofc_sema_typeval_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_typeval_t));
 	if (!typeval) return NULL;
 
@@ -852,7 +852,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_real(
 	if (!type) return NULL;
 
 	ofc_sema_typeval_t* typeval
-		= (ofc_sema_typeval_t*)malloc(
+		= (ofc_sema_typeval_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_typeval_t));
 	if (!typeval) return NULL;
 
@@ -876,7 +876,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_complex(
 	if (!type) return NULL;
 
 	ofc_sema_typeval_t* typeval
-		= (ofc_sema_typeval_t*)malloc(
+		= (ofc_sema_typeval_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_typeval_t));
 	if (!typeval) return NULL;
 
@@ -906,7 +906,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_character(
 		return NULL;
 
 	ofc_sema_typeval_t* typeval
-		= (ofc_sema_typeval_t*)malloc(
+		= (ofc_sema_typeval_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_typeval_t));
 	if (!typeval) return NULL;
 
@@ -916,7 +916,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_create_character(
 
 	if (!typeval->character)
 	{
-		free(typeval);
+		ofc_arena_node_free(typeval);
 		return NULL;
 	}
 
@@ -985,7 +985,7 @@ void ofc_sema_typeval_delete(
 		&& (typeval->type->type == OFC_SEMA_TYPE_CHARACTER))
 		free(typeval->character);
 
-	free(typeval);
+	ofc_arena_node_free(typeval);
 }
 
 
@@ -1076,7 +1076,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_copy(
 		return NULL;
 
 	ofc_sema_typeval_t* copy
-		= (ofc_sema_typeval_t*)malloc(
+		= (ofc_sema_typeval_t*)ofc_arena_node_alloc(
 			sizeof(ofc_sema_typeval_t));
 	if (!copy) return NULL;
 
@@ -1092,7 +1092,7 @@ ofc_sema_typeval_t* ofc_sema_typeval_copy(
 			copy->character = malloc(size);
 			if (!copy->character)
 			{
-				free(copy);
+				ofc_arena_node_free(copy);
 				return NULL;
 			}
 
@@ -19,6 +19,7 @@
 
 #include "ofc/fctype.h"
 #include "ofc/file.h"
+#include "ofc/util/lines.h"
 
 
 typedef struct
@@ -33,10 +34,14 @@ struct ofc_sparse_s
 	ofc_file_t*   file;
 	ofc_sparse_t* parent;
 
+	/* An alias borrows everything but its file from source. */
+	ofc_sparse_t* source;
+
 	unsigned len, count, max_count;
 	ofc_sparse_entry_t* entry;
 
 	char* strz;
+	ofc_lines_t* lines;
 
 	ofc_label_table_t* labels;
 
@@ -63,13 +68,15 @@ static ofc_sparse_t* ofc_sparse__create(
 
 	sparse->file   = file;
 	sparse->parent = parent;
+	sparse->source = NULL;
 
 	sparse->len       = 0;
 	sparse->count     = 0;
 	sparse->max_count = 0;
 	sparse->entry     = NULL;
 
-	sparse->strz = NULL;
+	sparse->strz  = NULL;
+	sparse->lines = NULL;
 
 	sparse->ref = 0;
 
@@ -105,15 +112,55 @@ ofc_sparse_t* ofc_sparse_create_child(ofc_sparse_t* parent)
 	return sparse;
 }
 
+ofc_sparse_t* ofc_sparse_create_alias(
+	ofc_sparse_t* source, ofc_file_t* file)
+{
+	if (!source || !source->strz)
+		return NULL;
+
+	if (!ofc_file_reference(file))
+		return NULL;
+
+	ofc_sparse_t* sparse
+		= (ofc_sparse_t*)malloc(
+			sizeof(ofc_sparse_t));
+	if (!sparse)
+	{
+		ofc_file_delete(file);
+		return NULL;
+	}
+
+	if (!ofc_sparse_reference(source))
+	{
+		free(sparse);
+		ofc_file_delete(file);
+		return NULL;
+	}
+
+	sparse->file   = file;
+	sparse->parent = source->parent;
+	sparse->source = source;
+
+	sparse->len       = source->len;
+	sparse->count     = source->count;
+	sparse->max_count = 0;
+	sparse->entry     = source->entry;
+
+	sparse->strz   = source->strz;
+	sparse->lines  = NULL;
+	sparse->labels = source->labels;
+
+	sparse->ref = 0;
+	return sparse;
+}
+
 bool ofc_sparse_reference(ofc_sparse_t* sparse)
 {
 	if (!sparse)
 		return false;
 
-	unsigned nref = sparse->ref + 1;
-	if (nref == 0) return false;
-
-	sparse->ref += 1;
+	/* Cached include sparses are referenced from many threads. */
+	__atomic_add_fetch(&sparse->ref, 1, __ATOMIC_RELAXED);
 	return true;
 }
 
@@ -122,9 +169,14 @@ void ofc_sparse_delete(ofc_sparse_t* sparse)
 	if (!sparse)
 		return;
 
-	if (sparse->ref > 0)
+	if (__atomic_fetch_sub(&sparse->ref, 1, __ATOMIC_ACQ_REL) > 0)
+		return;
+
+	if (sparse->source)
 	{
-		sparse->ref -= 1;
+		ofc_file_delete(sparse->file);
+		ofc_sparse_delete(sparse->source);
+		free(sparse);
 		return;
 	}
 
@@ -134,6 +186,7 @@ void ofc_sparse_delete(ofc_sparse_t* sparse)
 	ofc_label_table_delete(sparse->labels);
 
 	free(sparse->strz);
+	ofc_lines_delete(sparse->lines);
 	free(sparse->entry);
 	free(sparse);
 }
@@ -183,11 +236,64 @@ bool ofc_sparse_append_strn(
 	return true;
 }
 
+/* Copies the labels of the parent into the label table of a child,
+   at the offsets they'd be found at through the entry map. A label at
+   the end of an entry is also found at the start of the next entry. */
+static bool ofc_sparse__labels_inherit(ofc_sparse_t* sparse)
+{
+	const ofc_sparse_t* parent = sparse->parent;
+	if (!parent || !parent->strz)
+		return true;
+
+	unsigned pcount = ofc_label_table_count(parent->labels);
+	if (pcount == 0)
+		return true;
+
+	unsigned i, j;
+	uintptr_t prev_start = 0;
+	for (i = 0, j = 0; i < sparse->count; i++)
+	{
+		const ofc_sparse_entry_t* entry = &sparse->entry[i];
+
+		uintptr_t start = ((uintptr_t)entry->ptr - (uintptr_t)parent->strz);
+		if ((entry->ptr < parent->strz)
+			|| ((start + entry->len) > parent->len))
+			continue;
+
+		if (start < prev_start)
+			j = ofc_label_table_lower_bound(parent->labels, start);
+		prev_start = start;
+
+		for (; j < pcount; j++)
+		{
+			unsigned offset, number;
+			if (!ofc_label_table_get(parent->labels, j, &offset, &number))
+				return false;
+
+			if (offset < start)
+				continue;
+			if (offset > (start + entry->len))
+				break;
+
+			/* Labels already at this offset take precedence. */
+			unsigned coff = entry->off + (offset - start);
+			if (!ofc_label_table_find(sparse->labels, coff, NULL)
+				&& !ofc_label_table_add(sparse->labels, coff, number))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 void ofc_sparse_lock(ofc_sparse_t* sparse)
 {
 	if (!sparse || sparse->strz)
 		return;
 
+	if (!ofc_sparse__labels_inherit(sparse))
+		return;
+
 	sparse->strz = (char*)malloc(sparse->len + 1);
 	if (!sparse->strz) return;
 
@@ -277,30 +383,10 @@ bool ofc_sparse_label_find(
 	if (!sparse || !sparse->strz)
 		return false;
 
+	/* Labels of the parent were copied into this table on lock. */
 	unsigned offset = ((uintptr_t)ptr - (uintptr_t)sparse->strz);
-
-	if (ofc_label_table_find(
-		sparse->labels, offset, number))
-		return true;
-
-	if (!sparse->parent)
-		return false;
-
-	ofc_sparse_entry_t entry;
-	ofc_sparse_entry_t* prev = NULL;
-
-	if (!ofc_sparse__ptr(sparse, ptr,
-		&entry, &offset, &prev))
-		return false;
-
-	/* If we're at an the start of an entry, ensure there's no label attached
-	   to the end of the previous entry. */
-	if (prev && ofc_sparse_label_find(
-		sparse->parent, &prev->ptr[prev->len], number))
-		return true;
-
-	return ofc_sparse_label_find(
-		sparse->parent, &entry.ptr[offset], number);
+	return ofc_label_table_find(
+		sparse->labels, offset, number);
 }
 
 
@@ -405,12 +491,29 @@ static const char* ofc_sparse__file_pointer(
 
 	if (sol)
 	{
+		/* Aliases share the line index of their source. */
+		const ofc_sparse_t* owner
+			= (sparse->source ? sparse->source : sparse);
+		const ofc_lines_t* lines = ofc_lines_get(
+			(ofc_lines_t**)&owner->lines,
+			sparse->strz, sparse->len, false);
+
 		const char* s = sparse->strz;
-		const char* p;
-		for (p = sparse->strz; p < ptr; p++)
+		if (lines)
 		{
-			if (ofc_is_vspace(*p))
-				s = &p[1];
+			unsigned start;
+			ofc_lines_find(lines,
+				((uintptr_t)ptr - (uintptr_t)sparse->strz), &start);
+			s = &sparse->strz[start];
+		}
+		else
+		{
+			const char* p;
+			for (p = sparse->strz; p < ptr; p++)
+			{
+				if (ofc_is_vspace(*p))
+					s = &p[1];
+			}
 		}
 
 		ofc_sparse_entry_t sol_entry;
@@ -454,6 +557,16 @@ void ofc_sparse_warning_va(
 	ofc_file_warning_va(file, fsol, fptr, format, args);
 }
 
+bool ofc_sparse_ref_loc(
+	ofc_sparse_ref_t ref, ofc_file_loc_t* loc)
+{
+	const ofc_file_t* file = ofc_sparse__file(ref.sparse);
+	const char*       fsol = NULL;
+	const char*       fptr = ofc_sparse__file_pointer(ref.sparse, ref.string.base, &fsol);
+
+	return ofc_file_loc(file, fsol, fptr, loc);
+}
+
 void ofc_sparse_error(
 	const ofc_sparse_t* sparse, ofc_str_ref_t ref,
 	const char* format, ...)
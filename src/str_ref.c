@@ -18,6 +18,7 @@
 #include <string.h>
 
 #include "ofc/str_ref.h"
+#include "ofc/hashmap.h"
 
 
 bool ofc_str_ref_empty(const ofc_str_ref_t ref)
@@ -25,28 +26,22 @@ bool ofc_str_ref_empty(const ofc_str_ref_t ref)
 	return (ref.size == 0);
 }
 
-uint8_t ofc_str_ref_hash(const ofc_str_ref_t ref)
+uint32_t ofc_str_ref_hash(const ofc_str_ref_t ref)
 {
 	if (!ref.base)
 		return 0;
 
-	uint8_t hash;
-	unsigned i;
-	for (i = 0, hash = 0; i < ref.size; i++)
-		hash += ref.base[i];
-	return hash;
+	return ofc_hashmap_hash_bytes(
+		ref.base, ref.size);
 }
 
-uint8_t ofc_str_ref_hash_ci(const ofc_str_ref_t ref)
+uint32_t ofc_str_ref_hash_ci(const ofc_str_ref_t ref)
 {
 	if (!ref.base)
 		return 0;
 
-	uint8_t hash;
-	unsigned i;
-	for (i = 0, hash = 0; i < ref.size; i++)
-		hash += toupper(ref.base[i]);
-	return hash;
+	return ofc_hashmap_hash_bytes_ci(
+		ref.base, ref.size);
 }
 
 ofc_str_ref_t ofc_str_ref_bridge(
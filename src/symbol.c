@@ -0,0 +1,350 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ofc/symbol.h"
+
+
+#define OFC_SYMBOL__CHUNK_SIZE 1024
+#define OFC_SYMBOL__TEXT_SIZE  16384
+#define OFC_SYMBOL__INDEX_MIN  256
+
+typedef struct ofc_symbol__chunk_s ofc_symbol__chunk_t;
+
+struct ofc_symbol__chunk_s
+{
+	ofc_symbol__chunk_t* next;
+	unsigned             used;
+	ofc_symbol_s         entry[OFC_SYMBOL__CHUNK_SIZE];
+};
+
+typedef struct ofc_symbol__text_s ofc_symbol__text_t;
+
+struct ofc_symbol__text_s
+{
+	ofc_symbol__text_t* next;
+	size_t              size;
+	size_t              used;
+};
+
+/* The index only holds folded symbols. When it grows the old index is
+   kept until the table is deleted, since a lookup may still be using it. */
+typedef struct ofc_symbol__index_s ofc_symbol__index_t;
+
+struct ofc_symbol__index_s
+{
+	ofc_symbol__index_t* retired;
+	unsigned             size;
+	ofc_symbol_t         slot[];
+};
+
+/* Entries live in chunks which never move, and are complete before they're
+   published in the index or a fold chain. So lookups only need to load the
+   index and the slots atomically, inserts are serialized by the lock. */
+struct ofc_symbol_table_s
+{
+	pthread_mutex_t lock;
+
+	ofc_symbol__index_t* index;
+	unsigned             count;
+	unsigned             fold_count;
+
+	ofc_symbol__chunk_t* chunk;
+	ofc_symbol__text_t*  text;
+
+	unsigned refcnt;
+};
+
+
+ofc_symbol_table_t* ofc_symbol_table_create(void)
+{
+	ofc_symbol_table_t* table
+		= (ofc_symbol_table_t*)malloc(
+			sizeof(ofc_symbol_table_t));
+	if (!table) return NULL;
+
+	if (pthread_mutex_init(&table->lock, NULL) != 0)
+	{
+		free(table);
+		return NULL;
+	}
+
+	table->index      = NULL;
+	table->count      = 0;
+	table->fold_count = 0;
+	table->chunk      = NULL;
+	table->text       = NULL;
+
+	table->refcnt = 0;
+	return table;
+}
+
+bool ofc_symbol_table_reference(ofc_symbol_table_t* table)
+{
+	if (!table)
+		return false;
+
+	__atomic_add_fetch(&table->refcnt, 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+void ofc_symbol_table_delete(ofc_symbol_table_t* table)
+{
+	if (!table)
+		return;
+
+	if (__atomic_fetch_sub(&table->refcnt, 1, __ATOMIC_ACQ_REL) > 0)
+		return;
+
+	while (table->index)
+	{
+		ofc_symbol__index_t* retired = table->index->retired;
+		free(table->index);
+		table->index = retired;
+	}
+
+	while (table->chunk)
+	{
+		ofc_symbol__chunk_t* next = table->chunk->next;
+		free(table->chunk);
+		table->chunk = next;
+	}
+
+	while (table->text)
+	{
+		ofc_symbol__text_t* next = table->text->next;
+		free(table->text);
+		table->text = next;
+	}
+
+	pthread_mutex_destroy(&table->lock);
+	free(table);
+}
+
+unsigned ofc_symbol_table_count(const ofc_symbol_table_t* table)
+{
+	return (table ? __atomic_load_n(&table->count, __ATOMIC_RELAXED) : 0);
+}
+
+
+static ofc_symbol_t ofc_symbol__find(
+	const ofc_symbol_table_t* table,
+	ofc_str_ref_t name, uint32_t hash_ci, bool case_sensitive)
+{
+	const ofc_symbol__index_t* index
+		= __atomic_load_n(&table->index, __ATOMIC_ACQUIRE);
+	if (!index) return OFC_SYMBOL_NONE;
+
+	unsigned mask = (index->size - 1);
+	unsigned i;
+	for (i = (hash_ci & mask); ; i = ((i + 1) & mask))
+	{
+		ofc_symbol_t fold = __atomic_load_n(
+			&index->slot[i], __ATOMIC_ACQUIRE);
+		if (fold == OFC_SYMBOL_NONE)
+			break;
+
+		if ((fold->hash_ci != hash_ci)
+			|| !ofc_str_ref_equal_ci(fold->name, name))
+			continue;
+
+		if (!case_sensitive)
+			return fold;
+
+		ofc_symbol_t s;
+		for (s = fold; s != OFC_SYMBOL_NONE;
+			s = __atomic_load_n(&s->next, __ATOMIC_ACQUIRE))
+		{
+			if (ofc_str_ref_equal(s->name, name))
+				return s;
+		}
+		break;
+	}
+
+	return OFC_SYMBOL_NONE;
+}
+
+static void ofc_symbol__index_place(
+	ofc_symbol__index_t* index, ofc_symbol_t symbol)
+{
+	unsigned mask = (index->size - 1);
+	unsigned i;
+	for (i = (symbol->hash_ci & mask); index->slot[i]; i = ((i + 1) & mask));
+	__atomic_store_n(&index->slot[i], symbol, __ATOMIC_RELEASE);
+}
+
+static bool ofc_symbol__index_insert(
+	ofc_symbol_table_t* table, ofc_symbol_t symbol)
+{
+	ofc_symbol__index_t* index = table->index;
+
+	/* Keep the load factor at or below 3/4. */
+	unsigned size = (index ? index->size : 0);
+	if (((table->fold_count + 1) * 4) > (size * 3))
+	{
+		unsigned nsize = (size > 0 ? (size * 2) : OFC_SYMBOL__INDEX_MIN);
+		ofc_symbol__index_t* nindex
+			= (ofc_symbol__index_t*)calloc(1,
+				sizeof(ofc_symbol__index_t)
+				+ (nsize * sizeof(ofc_symbol_t)));
+		if (!nindex) return false;
+		nindex->size    = nsize;
+		nindex->retired = index;
+
+		unsigned i;
+		for (i = 0; i < size; i++)
+		{
+			if (index->slot[i])
+				ofc_symbol__index_place(nindex, index->slot[i]);
+		}
+
+		__atomic_store_n(&table->index, nindex, __ATOMIC_RELEASE);
+		index = nindex;
+	}
+
+	ofc_symbol__index_place(index, symbol);
+	table->fold_count++;
+	return true;
+}
+
+static const char* ofc_symbol__text_copy(
+	ofc_symbol_table_t* table, ofc_str_ref_t name)
+{
+	ofc_symbol__text_t* text = table->text;
+	if (!text || ((text->size - text->used) < name.size))
+	{
+		size_t size = OFC_SYMBOL__TEXT_SIZE;
+		if ((name.size + sizeof(ofc_symbol__text_t)) > size)
+			size = name.size + sizeof(ofc_symbol__text_t);
+
+		text = (ofc_symbol__text_t*)malloc(size);
+		if (!text) return NULL;
+
+		text->size = size;
+		text->used = sizeof(ofc_symbol__text_t);
+
+		text->next = table->text;
+		table->text = text;
+	}
+
+	char* copy = ((char*)text + text->used);
+	memcpy(copy, name.base, name.size);
+	text->used += name.size;
+	return copy;
+}
+
+static ofc_symbol_t ofc_symbol__add(
+	ofc_symbol_table_t* table, ofc_str_ref_t name,
+	uint32_t hash, uint32_t hash_ci)
+{
+	ofc_symbol__chunk_t* chunk = table->chunk;
+	if (!chunk || (chunk->used >= OFC_SYMBOL__CHUNK_SIZE))
+	{
+		chunk = (ofc_symbol__chunk_t*)malloc(
+			sizeof(ofc_symbol__chunk_t));
+		if (!chunk) return OFC_SYMBOL_NONE;
+
+		chunk->used = 0;
+		chunk->next = table->chunk;
+		table->chunk = chunk;
+	}
+
+	const char* base = ofc_symbol__text_copy(table, name);
+	if (!base) return OFC_SYMBOL_NONE;
+
+	ofc_symbol_t fold = ofc_symbol__find(
+		table, name, hash_ci, false);
+
+	ofc_symbol_s* entry = &chunk->entry[chunk->used];
+	entry->name    = ofc_str_ref(base, name.size);
+	entry->hash    = hash;
+	entry->hash_ci = hash_ci;
+
+	if (fold == OFC_SYMBOL_NONE)
+	{
+		entry->fold = entry;
+		entry->next = OFC_SYMBOL_NONE;
+		if (!ofc_symbol__index_insert(table, entry))
+			return OFC_SYMBOL_NONE;
+	}
+	else
+	{
+		/* Link it in after the head, so the head never changes. */
+		ofc_symbol_s* head = (ofc_symbol_s*)fold;
+		entry->fold = fold;
+		entry->next = head->next;
+		__atomic_store_n(&head->next, entry, __ATOMIC_RELEASE);
+	}
+
+	chunk->used++;
+	__atomic_store_n(&table->count,
+		(table->count + 1), __ATOMIC_RELAXED);
+	return entry;
+}
+
+static ofc_symbol_t ofc_symbol__intern(
+	ofc_symbol_table_t* table, ofc_str_ref_t name,
+	uint32_t hash, uint32_t hash_ci)
+{
+	ofc_symbol_t symbol = ofc_symbol__find(
+		table, name, hash_ci, true);
+	if (symbol != OFC_SYMBOL_NONE)
+		return symbol;
+
+	/* Another thread may have added it since we looked. */
+	pthread_mutex_lock(&table->lock);
+	symbol = ofc_symbol__find(
+		table, name, hash_ci, true);
+	if (symbol == OFC_SYMBOL_NONE)
+		symbol = ofc_symbol__add(table, name, hash, hash_ci);
+	pthread_mutex_unlock(&table->lock);
+	return symbol;
+}
+
+
+ofc_symbol_t ofc_symbol(
+	ofc_symbol_table_t* table, ofc_str_ref_t name)
+{
+	if (!table || !name.base)
+		return OFC_SYMBOL_NONE;
+
+	return ofc_symbol__intern(table, name,
+		ofc_str_ref_hash(name), ofc_str_ref_hash_ci(name));
+}
+
+ofc_symbol_t ofc_symbol_find(
+	const ofc_symbol_table_t* table,
+	ofc_str_ref_t name, bool case_sensitive)
+{
+	if (!table || !name.base)
+		return OFC_SYMBOL_NONE;
+
+	return ofc_symbol__find(table, name,
+		ofc_str_ref_hash_ci(name), case_sensitive);
+}
+
+ofc_symbol_t ofc_symbol_import(
+	ofc_symbol_table_t* table, ofc_symbol_t symbol)
+{
+	if (!table || !symbol)
+		return OFC_SYMBOL_NONE;
+
+	return ofc_symbol__intern(table, symbol->name,
+		symbol->hash, symbol->hash_ci);
+}
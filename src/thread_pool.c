@@ -0,0 +1,210 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "ofc/thread_pool.h"
+
+
+typedef struct
+{
+	ofc_thread_pool_job_f func;
+	void*                 param;
+} ofc_thread_pool__job_t;
+
+struct ofc_thread_pool_s
+{
+	pthread_mutex_t lock;
+	pthread_cond_t  job_ready;
+	pthread_cond_t  job_done;
+
+	/* Circular queue of pending jobs. */
+	ofc_thread_pool__job_t* job;
+	unsigned                job_size;
+	unsigned                job_head;
+	unsigned                job_count;
+
+	unsigned active;
+	bool     stop;
+
+	unsigned   count;
+	pthread_t* thread;
+};
+
+
+static void* ofc_thread_pool__worker(void* param)
+{
+	ofc_thread_pool_t* pool
+		= (ofc_thread_pool_t*)param;
+
+	pthread_mutex_lock(&pool->lock);
+	while (true)
+	{
+		while ((pool->job_count == 0) && !pool->stop)
+			pthread_cond_wait(&pool->job_ready, &pool->lock);
+
+		if (pool->job_count == 0)
+			break;
+
+		ofc_thread_pool__job_t job
+			= pool->job[pool->job_head];
+		pool->job_head = ((pool->job_head + 1) % pool->job_size);
+		pool->job_count--;
+		pool->active++;
+
+		pthread_mutex_unlock(&pool->lock);
+		job.func(job.param);
+		pthread_mutex_lock(&pool->lock);
+
+		pool->active--;
+		if ((pool->active == 0)
+			&& (pool->job_count == 0))
+			pthread_cond_broadcast(&pool->job_done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	return NULL;
+}
+
+ofc_thread_pool_t* ofc_thread_pool_create(unsigned threads)
+{
+	if (threads == 0)
+		return NULL;
+
+	ofc_thread_pool_t* pool
+		= (ofc_thread_pool_t*)malloc(
+			sizeof(ofc_thread_pool_t));
+	if (!pool) return NULL;
+
+	pool->thread = (pthread_t*)malloc(
+		sizeof(pthread_t) * threads);
+	if (!pool->thread)
+	{
+		free(pool);
+		return NULL;
+	}
+
+	pool->job       = NULL;
+	pool->job_size  = 0;
+	pool->job_head  = 0;
+	pool->job_count = 0;
+
+	pool->active = 0;
+	pool->stop   = false;
+	pool->count  = 0;
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->job_ready, NULL);
+	pthread_cond_init(&pool->job_done, NULL);
+
+	for (pool->count = 0; pool->count < threads; pool->count++)
+	{
+		if (pthread_create(&pool->thread[pool->count], NULL,
+			ofc_thread_pool__worker, pool) != 0)
+		{
+			ofc_thread_pool_delete(pool);
+			return NULL;
+		}
+	}
+
+	return pool;
+}
+
+void ofc_thread_pool_delete(ofc_thread_pool_t* pool)
+{
+	if (!pool)
+		return;
+
+	/* Pending jobs are still run before the workers exit. */
+	pthread_mutex_lock(&pool->lock);
+	pool->stop = true;
+	pthread_cond_broadcast(&pool->job_ready);
+	pthread_mutex_unlock(&pool->lock);
+
+	unsigned i;
+	for (i = 0; i < pool->count; i++)
+		pthread_join(pool->thread[i], NULL);
+
+	pthread_cond_destroy(&pool->job_done);
+	pthread_cond_destroy(&pool->job_ready);
+	pthread_mutex_destroy(&pool->lock);
+
+	free(pool->job);
+	free(pool->thread);
+	free(pool);
+}
+
+
+bool ofc_thread_pool_add(
+	ofc_thread_pool_t* pool,
+	ofc_thread_pool_job_f func, void* param)
+{
+	if (!pool || !func)
+		return false;
+
+	pthread_mutex_lock(&pool->lock);
+
+	if (pool->job_count >= pool->job_size)
+	{
+		unsigned nsize = (pool->job_size > 0
+			? (pool->job_size * 2) : 16);
+		ofc_thread_pool__job_t* njob
+			= (ofc_thread_pool__job_t*)malloc(
+				sizeof(ofc_thread_pool__job_t) * nsize);
+		if (!njob)
+		{
+			pthread_mutex_unlock(&pool->lock);
+			return false;
+		}
+
+		unsigned i;
+		for (i = 0; i < pool->job_count; i++)
+		{
+			njob[i] = pool->job[
+				(pool->job_head + i) % pool->job_size];
+		}
+
+		free(pool->job);
+		pool->job      = njob;
+		pool->job_size = nsize;
+		pool->job_head = 0;
+	}
+
+	unsigned tail = ((pool->job_head + pool->job_count) % pool->job_size);
+	pool->job[tail].func  = func;
+	pool->job[tail].param = param;
+	pool->job_count++;
+
+	pthread_cond_signal(&pool->job_ready);
+	pthread_mutex_unlock(&pool->lock);
+	return true;
+}
+
+void ofc_thread_pool_wait(ofc_thread_pool_t* pool)
+{
+	if (!pool)
+		return;
+
+	pthread_mutex_lock(&pool->lock);
+	while ((pool->job_count > 0) || (pool->active > 0))
+		pthread_cond_wait(&pool->job_done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+unsigned ofc_thread_pool_threads(const ofc_thread_pool_t* pool)
+{
+	return (pool ? pool->count : 0);
+}
@@ -0,0 +1,109 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+
+#include "ofc/util/lines.h"
+
+
+struct ofc_lines_s
+{
+	unsigned count;
+	unsigned start[];
+};
+
+
+static unsigned ofc_lines__scan(
+	const char* strz, unsigned size, bool crlf,
+	unsigned* start)
+{
+	unsigned count = 1;
+	if (start) start[0] = 0;
+
+	unsigned i;
+	for (i = 0; i < size; i++)
+	{
+		if ((strz[i] != '\n') && (strz[i] != '\r'))
+			continue;
+
+		if (crlf && (strz[i] == '\r')
+			&& ((i + 1) < size) && (strz[i + 1] == '\n'))
+			continue;
+
+		if (start) start[count] = (i + 1);
+		count++;
+	}
+
+	return count;
+}
+
+const ofc_lines_t* ofc_lines_get(
+	ofc_lines_t** lines,
+	const char* strz, unsigned size, bool crlf)
+{
+	if (!lines || !strz)
+		return NULL;
+
+	ofc_lines_t* cached
+		= __atomic_load_n(lines, __ATOMIC_ACQUIRE);
+	if (cached) return cached;
+
+	unsigned count = ofc_lines__scan(
+		strz, size, crlf, NULL);
+
+	ofc_lines_t* index
+		= (ofc_lines_t*)malloc(sizeof(ofc_lines_t)
+			+ (sizeof(unsigned) * count));
+	if (!index) return NULL;
+
+	index->count = ofc_lines__scan(
+		strz, size, crlf, index->start);
+
+	if (!__atomic_compare_exchange_n(
+		lines, &cached, index, false,
+		__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+	{
+		free(index);
+		return cached;
+	}
+
+	return index;
+}
+
+void ofc_lines_delete(ofc_lines_t* lines)
+{
+	free(lines);
+}
+
+unsigned ofc_lines_find(
+	const ofc_lines_t* lines, unsigned offset, unsigned* start)
+{
+	if (!lines)
+		return 0;
+
+	unsigned lo = 0;
+	unsigned hi = lines->count;
+	while ((hi - lo) > 1)
+	{
+		unsigned mid = lo + ((hi - lo) / 2);
+		if (lines->start[mid] <= offset)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	if (start) *start = lines->start[lo];
+	return lo;
+}
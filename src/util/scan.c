@@ -0,0 +1,89 @@
+/* Copyright 2015 Codethink Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ofc/fctype.h"
+#include "ofc/util/scan.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+
+static inline unsigned ofc_scan__hspace_mask(const char* src)
+{
+	__m128i v = _mm_loadu_si128((const __m128i*)src);
+	__m128i m = _mm_or_si128(
+		_mm_or_si128(
+			_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+			_mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+		_mm_or_si128(
+			_mm_cmpeq_epi8(v, _mm_set1_epi8('\f')),
+			_mm_cmpeq_epi8(v, _mm_set1_epi8('\v'))));
+	return (unsigned)_mm_movemask_epi8(m);
+}
+
+static inline unsigned ofc_scan__line_mask(const char* src)
+{
+	__m128i v = _mm_loadu_si128((const __m128i*)src);
+	__m128i m = _mm_or_si128(
+		_mm_cmpeq_epi8(v, _mm_setzero_si128()),
+		_mm_or_si128(
+			_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+			_mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+	return (unsigned)_mm_movemask_epi8(m);
+}
+#endif
+
+
+unsigned ofc_scan_hspace(const char* src, unsigned len)
+{
+	unsigned i = 0;
+#ifdef __SSE2__
+	for (; (i + 16) <= len; i += 16)
+	{
+		unsigned m = ~ofc_scan__hspace_mask(&src[i]) & 0xFFFF;
+		if (m != 0) return (i + __builtin_ctz(m));
+	}
+#endif
+	for (; (i < len) && ofc_is_hspace(src[i]); i++);
+	return i;
+}
+
+unsigned ofc_scan_non_hspace(const char* src, unsigned len)
+{
+	unsigned i = 0;
+#ifdef __SSE2__
+	for (; (i + 16) <= len; i += 16)
+	{
+		unsigned m = ofc_scan__hspace_mask(&src[i]);
+		if (m != 0) return (i + __builtin_ctz(m));
+	}
+#endif
+	for (; (i < len) && !ofc_is_hspace(src[i]); i++);
+	return i;
+}
+
+unsigned ofc_scan_line(const char* src, unsigned len)
+{
+	unsigned i = 0;
+#ifdef __SSE2__
+	for (; (i + 16) <= len; i += 16)
+	{
+		unsigned m = ofc_scan__line_mask(&src[i]);
+		if (m != 0) return (i + __builtin_ctz(m));
+	}
+#endif
+	for (; (i < len) && (src[i] != '\0') && !ofc_is_vspace(src[i]); i++);
+	return i;
+}